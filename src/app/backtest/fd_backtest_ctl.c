@@ -17,8 +17,31 @@
    ./build/native/gcc/bin/fd_backtest_ctl \
       --blockstore-checkpt /data/chali/$SLOTS-blockstore.checkpt \
       --funk-checkpt /data/chali/$SLOTS-funk.checkpt
-   
-   */
+
+   Checkpts are written in the v4 style, compressed in parallel over
+   all the tiles (use --tile-cpus).  Given --blockstore-checkpt-base
+   and/or --funk-checkpt-base (a previous full v4 checkpt of the same
+   wksp), only the allocations that changed since that base are written.
+   Such incremental checkpts are restored with fd_wksp_restore_incr_tpool
+   (or fd_wksp_ctl restore-incr).
+
+   ./build/native/gcc/bin/fd_backtest_ctl --tile-cpus 1-16 \
+      --blockstore-checkpt /data/chali/$SLOTS-blockstore.checkpt \
+      --blockstore-checkpt-base /data/chali/blockstore.checkpt \
+      --funk-checkpt /data/chali/$SLOTS-funk.checkpt \
+      --funk-checkpt-base /data/chali/funk.checkpt */
+
+static uchar tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+
+static int
+checkpt( fd_tpool_t * tpool,
+         fd_wksp_t *  wksp,
+         char const * path,
+         char const * base ) {
+  ulong t1 = fd_tpool_worker_cnt( tpool );
+  if( base ) return fd_wksp_checkpt_incr_tpool( tpool, 0UL, t1, wksp, path, 0666UL, NULL, base );
+  return fd_wksp_checkpt_tpool( tpool, 0UL, t1, wksp, path, 0666UL, FD_WKSP_CHECKPT_STYLE_V4, NULL );
+}
 
 int
 main( int argc, char ** argv ) {
@@ -34,6 +57,23 @@ main( int argc, char ** argv ) {
                                                          "--funk-checkpt",
                                                          NULL,
                                                          NULL );
+  char const * blockstore_base    = fd_env_strip_cmdline_cstr( &argc,
+                                                               &argv,
+                                                               "--blockstore-checkpt-base",
+                                                               NULL,
+                                                               NULL );
+  char const * funk_base          = fd_env_strip_cmdline_cstr( &argc,
+                                                               &argv,
+                                                               "--funk-checkpt-base",
+                                                               NULL,
+                                                               NULL );
+
+  ulong tcnt = fd_tile_cnt();
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, tcnt );
+  if( FD_UNLIKELY( !tpool ) ) FD_LOG_ERR(( "failed to create thread pool" ));
+  for( ulong i=1UL; i<tcnt; i++ ) {
+    if( FD_UNLIKELY( !fd_tpool_worker_push( tpool, i, NULL, 0UL ) ) ) FD_LOG_ERR(( "failed to launch worker" ));
+  }
 
   fd_wksp_t * blockstore_wksp = fd_wksp_attach( "fd1_bstore.wksp" );
   FD_TEST( blockstore_wksp );
@@ -43,7 +83,7 @@ main( int argc, char ** argv ) {
   void * blockstore_mem        = fd_wksp_laddr_fast( blockstore_wksp, blockstore_info.gaddr_lo );
   fd_blockstore_t * blockstore = fd_blockstore_join( blockstore_mem );
   FD_TEST( blockstore );
-  FD_TEST( !fd_wksp_checkpt( blockstore_wksp, blockstore_checkpt, 0666, 0, NULL ) );
+  FD_TEST( !checkpt( tpool, blockstore_wksp, blockstore_checkpt, blockstore_base ) );
 
   fd_wksp_t * funk_wksp = fd_wksp_attach( "fd1_funk.wksp" );
   FD_TEST( funk_wksp );
@@ -53,8 +93,9 @@ main( int argc, char ** argv ) {
   void *      funk_mem = fd_wksp_laddr_fast( funk_wksp, funk_info.gaddr_lo );
   fd_funk_t * funk     = fd_funk_join( funk_mem );
   FD_TEST( funk );
-  FD_TEST( !fd_wksp_checkpt( funk_wksp, funk_checkpt, 0666, 0, NULL ) );
+  FD_TEST( !checkpt( tpool, funk_wksp, funk_checkpt, funk_base ) );
 
+  fd_tpool_fini( tpool );
   fd_halt();
   return 0;
 }
@@ -17,7 +17,7 @@ $(OBJDIR)/obj/app/fdctl/version.d: src/app/fdctl/version.h
 .PHONY: fdctl cargo-validator cargo-solana cargo-ledger-tool rust solana check-agave-hash frontend
 
 # fdctl core
-$(call add-objs,main1 config config_parse caps utility keys ready mem spy help version,fd_fdctl)
+$(call add-objs,main1 config config_parse caps utility keys ready mem spy plan help version,fd_fdctl)
 $(call add-objs,run/run run/run1 run/run_agave,fd_fdctl)
 $(call add-objs,monitor/monitor monitor/helper,fd_fdctl)
 $(call make-fuzz-test,fuzz_fdctl_config,fuzz_fdctl_config,fd_fdctl fd_ballet fd_util)
@@ -81,6 +81,12 @@ endif
 $(call make-unit-test,test_tiles_verify,run/tiles/test_verify,fd_ballet fd_tango fd_util)
 $(call run-unit-test,test_tiles_verify)
 $(call make-unit-test,test_config_parse,test_config_parse,fd_fdctl fd_ballet fd_util)
+ifdef FD_HAS_ZSTD
+ifdef FD_ARCH_SUPPORTS_SANDBOX
+$(call make-unit-test,test_batch_seccomp,run/tiles/test_batch_seccomp,fd_util)
+$(call run-unit-test,test_batch_seccomp)
+endif
+endif
 
 $(OBJDIR)/obj/app/fdctl/configure/xdp.o: src/waltz/xdp/fd_xdp_redirect_prog.o
 $(OBJDIR)/obj/app/fdctl/config_parse.o: src/app/fdctl/config/default.toml
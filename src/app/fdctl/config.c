@@ -9,6 +9,7 @@
 #include "../../disco/topo/fd_pod_format.h"
 #include "../../flamenco/runtime/fd_blockstore.h"
 #include "../../flamenco/runtime/fd_txncache.h"
+#include "../../flamenco/vm/fd_vm_base.h"
 #include "../../funk/fd_funk.h"
 #include "../../util/net/fd_eth.h"
 #include "../../util/net/fd_ip4.h"
@@ -223,6 +224,8 @@ fdctl_obj_align( fd_topo_t const *     topo,
     return fd_funk_align();
   } else if( FD_UNLIKELY( !strcmp( obj->name, "txncache" ) ) ) {
     return fd_txncache_align();
+  } else if( FD_UNLIKELY( !strcmp( obj->name, "vm_prof" ) ) ) {
+    return fd_vm_prof_align();
   } else {
     FD_LOG_ERR(( "unknown object `%s`", obj->name ));
     return 0UL;
@@ -264,6 +267,8 @@ fdctl_obj_footprint( fd_topo_t const *     topo,
     return fd_funk_footprint();
   } else if( FD_UNLIKELY( !strcmp( obj->name, "txncache" ) ) ) {
     return fd_txncache_footprint( VAL("max_rooted_slots"), VAL("max_live_slots"), VAL("max_txn_per_slot"), FD_TXNCACHE_DEFAULT_MAX_CONSTIPATED_SLOTS );
+  } else if( FD_UNLIKELY( !strcmp( obj->name, "vm_prof" ) ) ) {
+    return fd_vm_prof_footprint( VAL("prog_max") );
   } else {
     FD_LOG_ERR(( "unknown object `%s`", obj->name ));
     return 0UL;
@@ -300,6 +300,7 @@ typedef struct {
       int   in_wen_restart;
       char  tower_checkpt[ PATH_MAX ];
       char  wen_restart_coordinator[ FD_BASE58_ENCODED_32_SZ ];
+      int   account_stream;
     } replay;
 
     struct {
@@ -387,6 +387,7 @@ fdctl_pod_to_cfg( config_t * config,
   CFG_POP      ( bool,   tiles.replay.in_wen_restart                      );
   CFG_POP      ( cstr,   tiles.replay.tower_checkpt                       );
   CFG_POP      ( cstr,   tiles.replay.wen_restart_coordinator             );
+  CFG_POP      ( bool,   tiles.replay.account_stream                      );
 
   CFG_POP      ( cstr,   tiles.store_int.slots_pending                    );
   CFG_POP      ( cstr,   tiles.store_int.shred_cap_archive                );
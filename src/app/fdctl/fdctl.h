@@ -70,10 +70,38 @@ typedef union {
     char pcap_path[ 256UL ];
   } dump;
 
+  struct {
+    char  link_name[ 256UL ];
+    char  out_path[ 256UL ];
+    ulong duration;
+  } record;
+
+  struct {
+    char elf_dir[ 256UL ];
+    char out_path[ 256UL ];
+  } vmprof;
+
+  struct {
+    char  tile_name[ 7UL ];
+    ulong kind_id;
+    char  in_path[ 256UL ];
+    int   max_rate;
+    ulong loop_cnt;
+    ulong timeout;
+  } tilebench;
+
   struct {
     char name[ 13UL ];
   } flame;
 
+  struct {
+    char  cpus[ AFFINITY_SZ ];
+    char  out_path[ 256UL ];
+    ulong iter;
+    ulong bw_sz;
+    ulong search_max;
+  } plan;
+
   struct {
     char    affinity[ AFFINITY_SZ ];
     uint    tpu_ip;
@@ -123,7 +151,7 @@ fdctl_obj_loose( fd_topo_t const *     topo,
 fd_topo_run_tile_t
 fdctl_tile_run( fd_topo_tile_t * tile );
 
-#define ACTIONS_CNT (11UL)
+#define ACTIONS_CNT (12UL)
 extern action_t ACTIONS[ ACTIONS_CNT ];
 
 void fdctl_boot( int *        pargc,
@@ -207,6 +235,15 @@ void
 spy_cmd_fn( args_t *         args,
             config_t * const config );
 
+void
+plan_cmd_args( int *    pargc,
+               char *** pargv,
+               args_t * args );
+
+void
+plan_cmd_fn( args_t *         args,
+             config_t * const config );
+
 void
 help_cmd_fn( args_t *         args,
              config_t * const config );
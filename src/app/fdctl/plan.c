@@ -0,0 +1,369 @@
+#define _GNU_SOURCE
+#include "fdctl.h"
+
+#include "../../disco/topo/fd_topo_place.h"
+#include "../../util/shmem/fd_shmem_private.h"
+#include "../../util/tile/fd_tile_private.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <linux/mempolicy.h>
+
+/* `fdctl plan` measures the machine it runs on and solves for a tile to
+   CPU assignment of the configured topology (see fd_topo_place.h).  It
+   prints a configuration fragment with the planned [layout.affinity]
+   and any link depths that should grow because of links crossing slow
+   boundaries, to be merged into the configuration file.  Workspaces
+   follow the tiles, as `fdctl` places each one on the NUMA node of the
+   tile which uses its largest object.
+
+   By default the candidate CPUs are the first hyperthread of every
+   online core, as communicating tiles on two hyperthreads of the same
+   core would look attractively close to the solver while competing for
+   the core's execution resources. */
+
+static fd_topo_place_machine_t machine[1];
+static fd_topo_place_t         place[1];
+
+void
+plan_cmd_args( int *    pargc,
+               char *** pargv,
+               args_t * args ) {
+  char const * cpus     = fd_env_strip_cmdline_cstr ( pargc, pargv, "--cpus",       NULL, ""        );
+  char const * out_file = fd_env_strip_cmdline_cstr ( pargc, pargv, "--out-file",   NULL, ""        );
+  args->plan.iter       = fd_env_strip_cmdline_ulong( pargc, pargv, "--iter",       NULL, 1000UL    );
+  args->plan.bw_sz      = fd_env_strip_cmdline_ulong( pargc, pargv, "--bw-sz",      NULL, 1UL<<26   );
+  args->plan.search_max = fd_env_strip_cmdline_ulong( pargc, pargv, "--search-max", NULL, 1000UL    );
+
+  if( FD_UNLIKELY( !args->plan.iter ) ) FD_LOG_ERR(( "--iter must be positive" ));
+  if( FD_UNLIKELY( args->plan.bw_sz<(1UL<<20) ) ) FD_LOG_ERR(( "--bw-sz must be at least 1 MiB" ));
+
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->plan.cpus     ), cpus,     sizeof(args->plan.cpus    )-1UL ) );
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->plan.out_path ), out_file, sizeof(args->plan.out_path)-1UL ) );
+}
+
+/* first_sibling returns the lowest numbered hyperthread of the core of
+   the given CPU, or the CPU itself if that is not known. */
+
+static ulong
+first_sibling( ulong cpu_idx ) {
+  char path[ PATH_MAX ];
+  FD_TEST( fd_cstr_printf_check( path, PATH_MAX, NULL, "/sys/devices/system/cpu/cpu%lu/topology/thread_siblings_list", cpu_idx ) );
+  FILE * fp = fopen( path, "r" );
+  if( FD_UNLIKELY( !fp ) ) return cpu_idx;
+  ulong first = cpu_idx;
+  if( FD_UNLIKELY( 1!=fscanf( fp, "%lu", &first ) ) ) first = cpu_idx;
+  if( FD_UNLIKELY( fclose( fp ) ) ) FD_LOG_ERR(( "fclose(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+  return first;
+}
+
+static void
+machine_cpus( fd_topo_place_machine_t * machine,
+              char const *              cpus ) {
+  ulong cpu_cnt  = fd_numa_cpu_cnt();
+  ulong node_cnt = fd_numa_node_cnt();
+  if( FD_UNLIKELY( !cpu_cnt || !node_cnt ) ) FD_LOG_ERR(( "unable to determine the CPU topology of the system" ));
+  if( FD_UNLIKELY( node_cnt>FD_TOPO_PLACE_NODE_MAX ) ) FD_LOG_ERR(( "the system has %lu NUMA nodes, at most %lu are supported", node_cnt, FD_TOPO_PLACE_NODE_MAX ));
+
+  ushort candidate[ FD_TILE_MAX ];
+  ulong  candidate_cnt = 0UL;
+  if( FD_LIKELY( !strcmp( cpus, "" ) ) ) {
+    for( ulong i=0UL; i<cpu_cnt; i++ ) {
+      if( FD_LIKELY( first_sibling( i )==i ) ) candidate[ candidate_cnt++ ] = (ushort)i;
+    }
+  } else {
+    candidate_cnt = fd_tile_private_cpus_parse( cpus, candidate );
+  }
+
+  machine->cpu_cnt  = 0UL;
+  machine->node_cnt = node_cnt;
+  for( ulong i=0UL; i<candidate_cnt; i++ ) {
+    ulong cpu_idx = candidate[ i ];
+    if( FD_UNLIKELY( cpu_idx==USHORT_MAX ) ) FD_LOG_ERR(( "--cpus cannot contain floating CPUs" ));
+    if( FD_UNLIKELY( cpu_idx>=cpu_cnt ) ) FD_LOG_ERR(( "--cpus specifies CPU %lu but the system only has %lu CPUs", cpu_idx, cpu_cnt ));
+    if( FD_UNLIKELY( machine->cpu_cnt==FD_TOPO_PLACE_CPU_MAX ) ) FD_LOG_ERR(( "at most %lu candidate CPUs are supported, use --cpus to select a subset", FD_TOPO_PLACE_CPU_MAX ));
+    machine->cpu_idx [ machine->cpu_cnt ] = cpu_idx;
+    machine->cpu_node[ machine->cpu_cnt ] = fd_numa_node_idx( cpu_idx );
+    if( FD_UNLIKELY( machine->cpu_node[ machine->cpu_cnt ]>=node_cnt ) ) FD_LOG_ERR(( "unable to determine the NUMA node of CPU %lu", cpu_idx ));
+    machine->cpu_cnt++;
+  }
+}
+
+static void
+pin_self( ulong cpu_idx ) {
+  FD_CPUSET_DECL( cpu_set );
+  fd_cpuset_insert( cpu_set, cpu_idx );
+  if( FD_UNLIKELY( fd_cpuset_setaffinity( 0UL, cpu_set ) ) ) FD_LOG_ERR(( "fd_cpuset_setaffinity(%lu) failed (%i-%s)", cpu_idx, errno, fd_io_strerror( errno ) ));
+}
+
+/* Cache line ping pong.  The ping thread writes an odd value to a
+   shared line and waits for the pong thread to answer with the next
+   even one, so every round trip moves the line across twice. */
+
+#define PINGPONG_WARMUP (100UL)
+
+typedef struct {
+  ulong           cpu_idx;
+  ulong           iter;
+  ulong volatile * line;
+  long            ticks;
+} pingpong_t;
+
+static void *
+ping_main( void * _arg ) {
+  pingpong_t * arg = (pingpong_t *)_arg;
+  pin_self( arg->cpu_idx );
+  ulong volatile * line = arg->line;
+
+  long  t0 = 0L;
+  ulong n  = PINGPONG_WARMUP + arg->iter;
+  for( ulong i=0UL; i<n; i++ ) {
+    if( FD_UNLIKELY( i==PINGPONG_WARMUP ) ) t0 = fd_tickcount();
+    *line = 2UL*i+1UL;
+    while( *line!=2UL*i+2UL ) ;
+  }
+  arg->ticks = fd_tickcount() - t0;
+  return NULL;
+}
+
+static void *
+pong_main( void * _arg ) {
+  pingpong_t * arg = (pingpong_t *)_arg;
+  pin_self( arg->cpu_idx );
+  ulong volatile * line = arg->line;
+
+  ulong n = PINGPONG_WARMUP + arg->iter;
+  for( ulong i=0UL; i<n; i++ ) {
+    while( *line!=2UL*i+1UL ) ;
+    *line = 2UL*i+2UL;
+  }
+  return NULL;
+}
+
+static float
+measure_latency( ulong  cpu_a,
+                 ulong  cpu_b,
+                 ulong  iter,
+                 double tick_per_ns ) {
+  static ulong line[ 16 ] __attribute__((aligned(128)));
+  FD_VOLATILE( line[ 0 ] ) = 0UL;
+
+  pingpong_t ping = { .cpu_idx = cpu_a, .iter = iter, .line = line };
+  pingpong_t pong = { .cpu_idx = cpu_b, .iter = iter, .line = line };
+
+  pthread_t ping_thread, pong_thread;
+  if( FD_UNLIKELY( pthread_create( &pong_thread, NULL, pong_main, &pong ) ) ) FD_LOG_ERR(( "pthread_create() failed" ));
+  if( FD_UNLIKELY( pthread_create( &ping_thread, NULL, ping_main, &ping ) ) ) FD_LOG_ERR(( "pthread_create() failed" ));
+  if( FD_UNLIKELY( pthread_join( ping_thread, NULL ) ) ) FD_LOG_ERR(( "pthread_join() failed" ));
+  if( FD_UNLIKELY( pthread_join( pong_thread, NULL ) ) ) FD_LOG_ERR(( "pthread_join() failed" ));
+
+  return (float)( (double)ping.ticks / tick_per_ns / (double)( 2UL*iter ) );
+}
+
+/* Memory bandwidth.  A thread pinned to a CPU of one node streams over
+   a buffer bound to the memory of another. */
+
+typedef struct {
+  ulong         cpu_idx;
+  ulong const * buf;
+  ulong         sz;
+  long          ticks;
+  ulong         sum;
+} stream_t;
+
+static void *
+stream_main( void * _arg ) {
+  stream_t * arg = (stream_t *)_arg;
+  pin_self( arg->cpu_idx );
+
+  ulong cnt = ( arg->sz / (4UL*sizeof(ulong)) )*4UL;
+  ulong s0 = 0UL, s1 = 0UL, s2 = 0UL, s3 = 0UL;
+  for( ulong i=0UL; i<cnt; i+=4UL ) { s0 += arg->buf[ i ]; s1 += arg->buf[ i+1UL ]; s2 += arg->buf[ i+2UL ]; s3 += arg->buf[ i+3UL ]; } /* warm TLB */
+
+  long t0 = fd_tickcount();
+  for( ulong pass=0UL; pass<4UL; pass++ ) {
+    for( ulong i=0UL; i<cnt; i+=4UL ) { s0 += arg->buf[ i ]; s1 += arg->buf[ i+1UL ]; s2 += arg->buf[ i+2UL ]; s3 += arg->buf[ i+3UL ]; }
+  }
+  arg->ticks = fd_tickcount() - t0;
+  arg->sum   = s0 + s1 + s2 + s3;
+  return NULL;
+}
+
+static void
+measure_bandwidth( fd_topo_place_machine_t * machine,
+                   ulong                     sz,
+                   double                    tick_per_ns ) {
+  for( ulong mem_node=0UL; mem_node<machine->node_cnt; mem_node++ ) {
+    ulong * buf = mmap( NULL, sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0 );
+    if( FD_UNLIKELY( MAP_FAILED==buf ) ) FD_LOG_ERR(( "mmap(%lu) failed (%i-%s)", sz, errno, fd_io_strerror( errno ) ));
+
+    ulong nodemask[ (FD_SHMEM_NUMA_MAX+63UL)/64UL ];
+    fd_memset( nodemask, 0, sizeof(nodemask) );
+    nodemask[ mem_node>>6 ] = 1UL<<(mem_node & 63UL);
+    if( FD_UNLIKELY( fd_numa_mbind( buf, sz, MPOL_BIND, nodemask, FD_SHMEM_NUMA_MAX, 0U ) ) )
+      FD_LOG_WARNING(( "fd_numa_mbind(node %lu) failed (%i-%s), bandwidth to node %lu will be inaccurate", mem_node, errno, fd_io_strerror( errno ), mem_node ));
+    for( ulong i=0UL; i<sz/sizeof(ulong); i++ ) buf[ i ] = i;
+
+    for( ulong cpu_node=0UL; cpu_node<machine->node_cnt; cpu_node++ ) {
+      machine->bw[ cpu_node ][ mem_node ] = 0.0f;
+
+      ulong cpu_idx = ULONG_MAX;
+      for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+        if( machine->cpu_node[ a ]==cpu_node ) { cpu_idx = machine->cpu_idx[ a ]; break; }
+      }
+      if( FD_UNLIKELY( cpu_idx==ULONG_MAX ) ) continue; /* No candidate CPUs on the node, never read from */
+
+      stream_t arg = { .cpu_idx = cpu_idx, .buf = buf, .sz = sz };
+      pthread_t thread;
+      if( FD_UNLIKELY( pthread_create( &thread, NULL, stream_main, &arg ) ) ) FD_LOG_ERR(( "pthread_create() failed" ));
+      if( FD_UNLIKELY( pthread_join( thread, NULL ) ) ) FD_LOG_ERR(( "pthread_join() failed" ));
+      FD_COMPILER_FORGET( arg.sum );
+
+      machine->bw[ cpu_node ][ mem_node ] = (float)( (double)(4UL*fd_ulong_align_dn( sz, 32UL )) / ( (double)arg.ticks / tick_per_ns ) );
+      FD_LOG_NOTICE(( "node %lu reading node %lu memory: %.2f GB/s", cpu_node, mem_node, (double)machine->bw[ cpu_node ][ mem_node ] ));
+    }
+
+    if( FD_UNLIKELY( munmap( buf, sz ) ) ) FD_LOG_ERR(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+}
+
+/* Which configurable link depths a link draws from */
+
+static int
+link_is_net( char const * name ) {
+  ulong len = strlen( name );
+  return !strncmp( name, "net_", 4UL ) || ( len>4UL && !strcmp( name+len-4UL, "_net" ) );
+}
+
+static int
+link_is_verify( char const * name ) {
+  return !strcmp( name, "quic_verify" ) || !strcmp( name, "verify_dedup" );
+}
+
+void
+plan_cmd_fn( args_t *         args,
+             config_t * const config ) {
+  fd_topo_t * topo = &config->topo;
+  double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+
+  machine_cpus( machine, args->plan.cpus );
+  FD_LOG_NOTICE(( "measuring %lu candidate CPUs on %lu NUMA nodes", machine->cpu_cnt, machine->node_cnt ));
+
+  /* Measure */
+
+  for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+    machine->lat_ns[ a ][ a ] = 0.0f;
+    for( ulong b=a+1UL; b<machine->cpu_cnt; b++ ) {
+      float lat = measure_latency( machine->cpu_idx[ a ], machine->cpu_idx[ b ], args->plan.iter, tick_per_ns );
+      machine->lat_ns[ a ][ b ] = lat;
+      machine->lat_ns[ b ][ a ] = lat;
+    }
+    FD_LOG_INFO(( "measured cache line latencies from CPU %lu", machine->cpu_idx[ a ] ));
+  }
+
+  for( ulong n0=0UL; n0<machine->node_cnt; n0++ ) {
+    for( ulong n1=0UL; n1<machine->node_cnt; n1++ ) {
+      double sum = 0.0;
+      ulong  cnt = 0UL;
+      for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+        for( ulong b=0UL; b<machine->cpu_cnt; b++ ) {
+          if( a==b || machine->cpu_node[ a ]!=n0 || machine->cpu_node[ b ]!=n1 ) continue;
+          sum += (double)machine->lat_ns[ a ][ b ];
+          cnt++;
+        }
+      }
+      if( FD_LIKELY( cnt ) ) FD_LOG_NOTICE(( "node %lu to node %lu: mean cache line latency %.1f ns", n0, n1, sum/(double)cnt ));
+    }
+  }
+
+  measure_bandwidth( machine, args->plan.bw_sz, tick_per_ns );
+
+  /* Solve.  The current layout, if all of its pinned tiles are on
+     candidate CPUs, is reported for comparison. */
+
+  fd_topo_place_init( place, topo );
+
+  int baseline = 1;
+  for( ulong i=0UL; i<place->tile_cnt; i++ ) {
+    ulong cpu_idx = topo->tiles[ place->tile_id[ i ] ].cpu_idx;
+    place->slot[ i ] = ULONG_MAX;
+    for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+      if( machine->cpu_idx[ a ]==cpu_idx ) place->slot[ i ] = a;
+    }
+    baseline &= place->slot[ i ]!=ULONG_MAX;
+  }
+  if( FD_LIKELY( baseline ) ) FD_LOG_NOTICE(( "current layout cost %.1f", fd_topo_place_cost( place, machine ) ));
+
+  double cost = fd_topo_place_solve( place, machine, args->plan.search_max );
+  FD_LOG_NOTICE(( "planned layout cost %.1f", cost ));
+
+  fd_topo_place_apply( place, machine, topo );
+
+  /* Emit */
+
+  FILE * out = stdout;
+  if( FD_UNLIKELY( strcmp( args->plan.out_path, "" ) ) ) {
+    out = fopen( args->plan.out_path, "w" );
+    if( FD_UNLIKELY( !out ) ) FD_LOG_ERR(( "fopen(%s) failed (%i-%s)", args->plan.out_path, errno, fd_io_strerror( errno ) ));
+  }
+
+  char affinity[ AFFINITY_SZ ];
+  char * p = fd_cstr_init( affinity );
+  for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
+    fd_topo_tile_t const * tile = &topo->tiles[ i ];
+    char entry[ 24 ];
+    if( tile->cpu_idx==ULONG_MAX ) FD_TEST( fd_cstr_printf_check( entry, sizeof(entry), NULL, "%sf",  i ? "," : "" ) );
+    else                           FD_TEST( fd_cstr_printf_check( entry, sizeof(entry), NULL, "%s%lu", i ? "," : "", tile->cpu_idx ) );
+    if( FD_UNLIKELY( (ulong)(p-affinity)+strlen( entry )>=AFFINITY_SZ ) ) FD_LOG_ERR(( "planned affinity does not fit in %d characters", AFFINITY_SZ ));
+    p = fd_cstr_append_cstr( p, entry );
+  }
+  fd_cstr_fini( p );
+
+  fprintf( out, "# Generated by `fdctl plan` for a topology of %lu tiles on %lu candidate CPUs.\n", topo->tile_cnt, machine->cpu_cnt );
+  fprintf( out, "# Planned layout cost %.1f.\n", cost );
+  fprintf( out, "[layout]\n" );
+  fprintf( out, "    affinity = \"%s\"\n", affinity );
+
+#ifndef FD_HAS_NO_AGAVE
+  /* Agave gets the candidate CPUs no tile was placed on */
+  char agave[ AFFINITY_SZ ];
+  p = fd_cstr_init( agave );
+  int first = 1;
+  for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+    int used = 0;
+    for( ulong i=0UL; i<place->tile_cnt; i++ ) used |= place->slot[ i ]==a;
+    if( used ) continue;
+    char entry[ 24 ];
+    FD_TEST( fd_cstr_printf_check( entry, sizeof(entry), NULL, "%s%lu", first ? "" : ",", machine->cpu_idx[ a ] ) );
+    if( FD_UNLIKELY( (ulong)(p-agave)+strlen( entry )>=AFFINITY_SZ ) ) break;
+    p = fd_cstr_append_cstr( p, entry );
+    first = 0;
+  }
+  fd_cstr_fini( p );
+  if( FD_LIKELY( !first ) ) fprintf( out, "    agave_affinity = \"%s\"\n", agave );
+#endif
+
+  /* Link depths.  Only the net and verify buffers are configurable,
+     other links which would benefit from a deeper buffer are logged. */
+
+  ulong net_depth    = config->tiles.net.send_buffer_size;
+  ulong verify_depth = config->tiles.verify.receive_buffer_size;
+  for( ulong i=0UL; i<topo->link_cnt; i++ ) {
+    fd_topo_link_t const * link = &topo->links[ i ];
+    ulong depth = fd_topo_place_link_depth( topo, machine, i );
+    if( FD_LIKELY( depth==link->depth ) ) continue;
+
+    if(      link_is_net   ( link->name ) ) net_depth    = fd_ulong_max( net_depth,    depth );
+    else if( link_is_verify( link->name ) ) verify_depth = fd_ulong_max( verify_depth, depth );
+    else FD_LOG_NOTICE(( "link %s:%lu crosses a slow boundary and would benefit from a depth of %lu instead of %lu", link->name, link->kind_id, depth, link->depth ));
+  }
+  if( FD_UNLIKELY( net_depth!=config->tiles.net.send_buffer_size ) )
+    fprintf( out, "[tiles.net]\n    send_buffer_size = %lu\n", net_depth );
+  if( FD_UNLIKELY( verify_depth!=config->tiles.verify.receive_buffer_size ) )
+    fprintf( out, "[tiles.verify]\n    receive_buffer_size = %lu\n", verify_depth );
+
+  if( FD_UNLIKELY( out!=stdout && fclose( out ) ) ) FD_LOG_ERR(( "fclose(%s) failed (%i-%s)", args->plan.out_path, errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( out==stdout && fflush( out ) ) ) FD_LOG_ERR(( "fflush failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+}
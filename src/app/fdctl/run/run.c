@@ -13,6 +13,7 @@
 #include "../../../waltz/xdp/fd_xdp1.h"
 #include "../../../flamenco/runtime/fd_blockstore.h"
 #include "../../../flamenco/runtime/fd_txncache.h"
+#include "../../../flamenco/vm/fd_vm_base.h"
 #include "../../../funk/fd_funk_filemap.h"
 #include "../../../funk/fd_funk.h"
 #include "../configure/configure.h"
@@ -540,6 +541,8 @@ fdctl_obj_new( fd_topo_t const *     topo,
     FD_TEST( fd_funk_new( laddr, VAL("wksp_tag"), VAL("seed"), VAL("txn_max"), VAL("rec_max") ) );
   } else if( FD_UNLIKELY( !strcmp( obj->name, "txncache" ) ) ) {
     FD_TEST( fd_txncache_new( laddr, VAL("max_rooted_slots"), VAL("max_live_slots"), VAL("max_txn_per_slot"), FD_TXNCACHE_DEFAULT_MAX_CONSTIPATED_SLOTS ) );
+  } else if( FD_UNLIKELY( !strcmp( obj->name, "vm_prof" ) ) ) {
+    FD_TEST( fd_vm_prof_new( laddr, VAL("prog_max"), VAL("sample_period") ) );
   } else {
     FD_LOG_ERR(( "unknown object `%s`", obj->name ));
   }
@@ -112,6 +112,7 @@ during_frag( fd_dedup_ctx_t * ctx,
 
     fd_txn_m_t * txnm = (fd_txn_m_t *)dst;
     txnm->payload_sz = (ushort)sz;
+    txnm->flags      = 0U; /* not sigverified by us */
     fd_memcpy( fd_txn_m_payload( txnm ), src, sz );
   } else {
     fd_memcpy( dst, src, sz );
@@ -11,6 +11,8 @@
 
 #include "../../../../disco/keyguard/fd_keyload.h"
 #include "../../../../disco/metrics/fd_prometheus.h"
+#include "../../../../disco/topo/fd_pod_format.h"
+#include "../../../../flamenco/vm/fd_vm_base.h"
 #include "../../../../ballet/http/fd_http_server.h"
 #include "../../../../util/net/fd_ip4.h"
 
@@ -37,6 +39,8 @@ typedef struct {
   fd_topo_t * topo;
 
   fd_http_server_t * metrics_server;
+
+  fd_vm_prof_t const * vm_prof; /* NULL if the topology does not profile programs */
 } fd_metric_ctx_t;
 
 FD_FN_CONST static inline ulong
@@ -75,6 +79,7 @@ metrics_http_request( fd_http_server_request_t const * request ) {
 
   if( FD_LIKELY( !strcmp( request->path, "/metrics" ) ) ) {
     fd_prometheus_render_all( ctx->topo, ctx->metrics_server );
+    if( FD_LIKELY( ctx->vm_prof ) ) fd_prometheus_render_vm_prof( ctx->vm_prof, FD_PROMETHEUS_VM_PROF_TOP_MAX, ctx->metrics_server );
 
     fd_http_server_response_t response = {
       .status       = 200,
@@ -121,6 +126,13 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->topo = topo;
 
+  ctx->vm_prof = NULL;
+  ulong vm_prof_obj_id = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "vm_prof" );
+  if( FD_UNLIKELY( vm_prof_obj_id!=ULONG_MAX ) ) {
+    ctx->vm_prof = fd_vm_prof_join( fd_topo_obj_laddr( topo, vm_prof_obj_id ) );
+    if( FD_UNLIKELY( !ctx->vm_prof ) ) FD_LOG_ERR(( "fd_vm_prof_join failed" ));
+  }
+
   ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
   if( FD_UNLIKELY( scratch_top > (ulong)scratch + scratch_footprint( tile ) ) )
     FD_LOG_ERR(( "scratch overflow %lu %lu %lu", scratch_top - (ulong)scratch - scratch_footprint( tile ), scratch_top, (ulong)scratch + scratch_footprint( tile ) ));
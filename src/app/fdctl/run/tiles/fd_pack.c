@@ -687,6 +687,7 @@ during_frag( fd_pack_ctx_t * ctx,
     fd_memcpy( TXN(ctx->cur_spot->txnp),     txn,                     txnm->txn_t_sz                );
     fd_memcpy( ctx->cur_spot->alt_accts,     fd_txn_m_alut( txnm ),   32UL*txn->addr_table_adtl_cnt );
     ctx->cur_spot->txnp->payload_sz = txnm->payload_sz;
+    ctx->cur_spot->txnp->flags      = txnm->flags & FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED;
 
   #if DETAILED_LOGGING
     FD_LOG_NOTICE(( "Pack got a packet. Payload size: %lu, txn footprint: %lu", txnm->payload_sz, txnm->txn_t_sz ));
@@ -434,19 +434,19 @@ repair_get_shred( ulong  slot,
   if( FD_UNLIKELY( blockstore == NULL ) ) {
     return -1;
   }
-  fd_blockstore_start_read( blockstore );
+  fd_blockstore_slot_start_read( blockstore, slot );
 
   if( shred_idx == UINT_MAX ) {
     fd_block_map_t * meta = fd_blockstore_block_map_query( blockstore, slot );
     if( meta == NULL ) {
-      fd_blockstore_end_read( blockstore );
+      fd_blockstore_slot_end_read( blockstore, slot );
       return -1L;
     }
     shred_idx = (uint)meta->complete_idx;
   }
   long sz = fd_buf_shred_query_copy_data( blockstore, slot, shred_idx, buf, buf_max );
 
-  fd_blockstore_end_read( blockstore );
+  fd_blockstore_slot_end_read( blockstore, slot );
   return sz;
 }
 
@@ -639,6 +639,7 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->repair_config.serv_get_parent_fun = repair_get_parent;
   ctx->repair_config.sign_fun = repair_signer;
   ctx->repair_config.sign_arg = ctx;
+  ctx->repair_config.peer_inflight_max = FD_REPAIR_PEER_INFLIGHT_DEFAULT;
 
   if( fd_repair_set_config( ctx->repair, &ctx->repair_config ) ) {
     FD_LOG_ERR( ( "error setting repair config" ) );
@@ -18,6 +18,7 @@
 #include "../../../../flamenco/runtime/sysvar/fd_sysvar_epoch_schedule.h"
 #include "../../../../flamenco/runtime/sysvar/fd_sysvar_slot_history.h"
 #include "../../../../flamenco/runtime/sysvar/fd_sysvar_recent_hashes.h"
+#include "../../../../flamenco/vm/fd_vm_base.h"
 #include "../../../../flamenco/runtime/fd_runtime_init.h"
 #include "../../../../flamenco/snapshot/fd_snapshot.h"
 #include "../../../../flamenco/stakes/fd_stakes.h"
@@ -34,6 +35,7 @@
 #include "../../../../funk/fd_funk_filemap.h"
 #include "../../../../flamenco/snapshot/fd_snapshot_create.h"
 #include "../../../../disco/plugin/fd_plugin.h"
+#include "../../../../disco/geyser/fd_geyser_acct.h"
 
 #include <arpa/inet.h>
 #include <errno.h>
@@ -129,6 +131,10 @@ struct fd_replay_tile_ctx {
   ulong       notif_out_wmark;
   ulong       notif_out_chunk;
 
+  // Account stream output defs, only used if acct_stream
+  int                 acct_stream;
+  fd_geyser_acct_tx_t acct_out[1];
+
   // Sender output defs
   fd_frag_meta_t * sender_out_mcache;
   ulong *          sender_out_sync;
@@ -288,6 +294,7 @@ struct fd_replay_tile_ctx {
   fd_pubkey_t vote_acct_addr[ 1 ];
 
   fd_txncache_t * status_cache;
+  fd_vm_prof_t *  vm_prof; /* NULL if on-chain programs are not profiled */
   void * bmtree[ FD_PACK_MAX_BANK_TILES ];
 
   fd_epoch_forks_t epoch_forks[1];
@@ -1052,12 +1059,44 @@ suppress_notify( const fd_pubkey_t * prog ) {
   }
 }
 
+/* publish_account_delta publishes the value of the account written by
+   the transaction with signature sig on the replay_acct stream.  Returns
+   1 on success and 0 if the account does not exist (e.g. it was
+   closed). */
+
+static int
+publish_account_delta( fd_replay_tile_ctx_t *   ctx,
+                       fd_fork_t *              fork,
+                       ulong                    curr_slot,
+                       fd_ed25519_sig_t const * sig,
+                       fd_pubkey_t const *      address,
+                       ulong                    tsorig ) {
+  fd_account_meta_t const * meta = fd_acc_mgr_view_raw( ctx->acc_mgr, fork->slot_ctx.funk_txn, address, NULL, NULL, NULL );
+  if( FD_UNLIKELY( !meta || meta->dlen>FD_GEYSER_ACCT_DATA_MAX ) ) return 0;
+
+  fd_geyser_acct_hdr_t hdr[1];
+  hdr->slot    = curr_slot;
+  hdr->address = *address;
+  hdr->meta    = *meta;
+  fd_memcpy( hdr->txn_sig, sig, sizeof(fd_ed25519_sig_t) );
+  fd_geyser_acct_publish( ctx->acct_out, hdr, (uchar const *)meta + meta->hlen, tsorig );
+  return 1;
+}
+
+/* publish_account_notifications notifies the accounts referenced by
+   txns.  If stream is set, the transactions were executed synchronously
+   and the value of the accounts they wrote is also published on the
+   replay_acct stream.  As it is read after the whole batch executed, an
+   account written by several transactions of the batch is published
+   with its final value for each of them. */
+
 static void
 publish_account_notifications( fd_replay_tile_ctx_t * ctx,
                                fd_fork_t *            fork,
                                ulong                  curr_slot,
                                fd_txn_p_t const *     txns,
-                               ulong                  txn_cnt ) {
+                               ulong                  txn_cnt,
+                               int                    stream ) {
   long notify_time_ns = -fd_log_wallclock();
 #define NOTIFY_START msg = fd_chunk_to_laddr( ctx->notif_out_mem, ctx->notif_out_chunk )
 #define NOTIFY_END                                                      \
@@ -1086,6 +1125,7 @@ publish_account_notifications( fd_replay_tile_ctx_t * ctx,
           msg->type = FD_REPLAY_ACCTS_TYPE;
           msg->accts.funk_xid = fork->slot_ctx.funk_txn->xid;
           fd_memcpy( msg->accts.sig, sigs, sizeof(fd_ed25519_sig_t) );
+          msg->accts.acct_seq0 = msg->accts.acct_seq1 = ctx->acct_out->seq;
           msg->accts.accts_cnt = 0;
         }
         struct fd_replay_notif_acct * out = &msg->accts.accts[ msg->accts.accts_cnt++ ];
@@ -1093,6 +1133,10 @@ publish_account_notifications( fd_replay_tile_ctx_t * ctx,
         int writable = ((j < txn->signature_cnt - txn->readonly_signed_cnt) ||
                         ((j >= txn->signature_cnt) && (j < acct_cnt - txn->readonly_unsigned_cnt)));
         out->flags = (writable ? FD_REPLAY_NOTIF_ACCT_WRITTEN : FD_REPLAY_NOTIF_ACCT_NO_FLAGS );
+        if( stream && writable && publish_account_delta( ctx, fork, curr_slot, sigs, accts + j, tsorig ) ) {
+          out->flags |= FD_REPLAY_NOTIF_ACCT_STREAMED;
+          msg->accts.acct_seq1 = ctx->acct_out->seq;
+        }
 
         if( msg->accts.accts_cnt == FD_REPLAY_NOTIF_ACCT_MAX ) {
           NOTIFY_END;
@@ -1281,6 +1325,7 @@ prepare_new_block_execution( fd_replay_tile_ctx_t * ctx,
   }
 
   fork->slot_ctx.status_cache        = ctx->status_cache;
+  fork->slot_ctx.vm_prof             = ctx->vm_prof;
 
   fd_funk_txn_xid_t xid = { 0 };
 
@@ -1454,8 +1499,18 @@ after_frag( fd_replay_tile_ctx_t * ctx,
     FD_SCRATCH_SCOPE_BEGIN {
       if( flags & REPLAY_FLAG_PACKED_MICROBLOCK ) {
         // FD_LOG_WARNING(("MBLK4: %lu %lu %lu", ctx->curr_slot, seq, bank_idx+1));
+
         fd_tpool_wait( ctx->tpool, bank_idx+1 );
 
+        /* Page in the accounts of the microblock before handing it to
+           the bank.  This is only done once the bank is idle: funk
+           queries are not safe against the bank's own writes to the
+           same funk txn.  Other banks may still be executing, but pack
+           never schedules them on accounts that conflict with this
+           microblock. */
+
+        fd_runtime_prefetch_txns( &fork->slot_ctx, txns, txn_cnt );
+
         fd_tpool_exec( ctx->tpool, bank_idx+1, fd_exec_packed_txns_task, txns, txn_cnt, curr_slot, &fork->slot_ctx, ctx->capture_ctx, 0UL, flags, seq, (ulong)ctx->bank_busy[ bank_idx ], (ulong)&ctx->bank_out[ bank_idx ], (ulong)ctx->bmtree[ bank_idx ], (ulong)ctx->spads[ bank_idx ] );
       } else {
         for( ulong i = 0UL; i<ctx->bank_cnt; i++ ) {
@@ -1472,7 +1527,7 @@ after_frag( fd_replay_tile_ctx_t * ctx,
     } FD_SCRATCH_SCOPE_END;
 
     // Notify for all the updated accounts
-    publish_account_notifications( ctx, fork, curr_slot, txns, txn_cnt );
+    publish_account_notifications( ctx, fork, curr_slot, txns, txn_cnt, ctx->acct_stream && !( flags & REPLAY_FLAG_PACKED_MICROBLOCK ) );
 
     execute_time_ns += fd_log_wallclock();
     FD_LOG_DEBUG(("TIMING: execute_time - slot: %lu, elapsed: %6.6f ms", curr_slot, (double)execute_time_ns * 1e-6));
@@ -2004,6 +2059,7 @@ init_snapshot( fd_replay_tile_ctx_t * ctx,
   ctx->slot_ctx->blockstore   = ctx->blockstore;
   ctx->slot_ctx->epoch_ctx    = ctx->epoch_ctx;
   ctx->slot_ctx->status_cache = ctx->status_cache;
+  ctx->slot_ctx->vm_prof      = ctx->vm_prof;
 
   FD_SCRATCH_SCOPE_BEGIN {
     uchar is_snapshot = strlen( ctx->snapshot ) > 0;
@@ -2423,6 +2479,17 @@ unprivileged_init( fd_topo_t *      topo,
     }
   }
 
+  /**********************************************************************/
+  /* program profiler                                                   */
+  /**********************************************************************/
+
+  ulong vm_prof_obj_id = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "vm_prof" );
+  ctx->vm_prof = NULL;
+  if( FD_LIKELY( vm_prof_obj_id!=ULONG_MAX ) ) {
+    ctx->vm_prof = fd_vm_prof_join( fd_topo_obj_laddr( topo, vm_prof_obj_id ) );
+    if( FD_UNLIKELY( !ctx->vm_prof ) ) FD_LOG_ERR(( "failed to join program profiler" ));
+  }
+
   /**********************************************************************/
   /* epoch forks                                                        */
   /**********************************************************************/
@@ -2434,6 +2501,7 @@ unprivileged_init( fd_topo_t *      topo,
   /**********************************************************************/
 
   ctx->acc_mgr       = fd_acc_mgr_new( acc_mgr_shmem, ctx->funk );
+  ctx->acc_mgr->page_in = 1; /* funk is file backed */
   ctx->bank_hash_cmp = fd_bank_hash_cmp_join( fd_bank_hash_cmp_new( bank_hash_cmp_mem ) );
   ctx->epoch_ctx = fd_exec_epoch_ctx_join( fd_exec_epoch_ctx_new( epoch_ctx_mem, VOTE_ACC_MAX ) );
 
@@ -2600,6 +2668,16 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->notif_out_wmark       = fd_dcache_compact_wmark ( ctx->notif_out_mem, notif_out->dcache, notif_out->mtu );
   ctx->notif_out_chunk       = ctx->notif_out_chunk0;
 
+  ulong acct_out_idx = fd_topo_find_tile_out_link( topo, tile, "replay_acct", 0 );
+  ctx->acct_stream = acct_out_idx!=ULONG_MAX;
+  if( ctx->acct_stream ) {
+    fd_topo_link_t * acct_out = &topo->links[ tile->out_link_id[ acct_out_idx ] ];
+    fd_wksp_t *      acct_mem = topo->workspaces[ topo->objs[ acct_out->dcache_obj_id ].wksp_id ].wksp;
+    if( FD_UNLIKELY( !fd_geyser_acct_tx_init( ctx->acct_out, acct_out->mcache, acct_out->dcache, acct_mem ) ) ) {
+      FD_LOG_ERR(( "replay_acct link is misconfigured" ));
+    }
+  }
+
   fd_topo_link_t * sender_out = &topo->links[ tile->out_link_id[ SENDER_OUT_IDX ] ];
   ctx->sender_out_mcache      = sender_out->mcache;
   ctx->sender_out_sync        = fd_mcache_seq_laddr( ctx->sender_out_mcache );
@@ -14,9 +14,10 @@
 
 struct __attribute__((aligned(1))) fd_replay_notif_acct {
   uchar id [ 32U ]; /* Account id */
-  uchar flags;      /* 0=nothing 1=account written */
+  uchar flags;      /* 0=nothing 1=account written 2=value published on replay_acct */
 };
 #define FD_REPLAY_NOTIF_ACCT_WRITTEN  ((uchar)1)
+#define FD_REPLAY_NOTIF_ACCT_STREAMED ((uchar)2)
 #define FD_REPLAY_NOTIF_ACCT_NO_FLAGS ((uchar)0)
 
 struct __attribute__((aligned(64UL))) fd_replay_notif_msg {
@@ -24,6 +25,8 @@ struct __attribute__((aligned(64UL))) fd_replay_notif_msg {
     struct {
       fd_funk_txn_xid_t           funk_xid;
       uchar                       sig[64U];           /* Transaction signature */
+      ulong                       acct_seq0;          /* The values of the STREAMED accounts were published */
+      ulong                       acct_seq1;          /* on replay_acct as frags [acct_seq0,acct_seq1) */
       struct fd_replay_notif_acct accts[FD_REPLAY_NOTIF_ACCT_MAX];
       uint                        accts_cnt;
     } accts;
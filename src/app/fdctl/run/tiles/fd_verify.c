@@ -1,12 +1,20 @@
 #include "fd_verify.h"
 #include "../../../../disco/metrics/fd_metrics.h"
+#include "../../../../flamenco/runtime/program/fd_precompiles.h"
 #include "generated/verify_seccomp.h"
 
 #include <linux/unistd.h>
 
 /* The verify tile is a wrapper around the mux tile, that also verifies
    incoming transaction signatures match the data being signed.
-   Non-matching transactions are filtered out of the frag stream. */
+   Non-matching transactions are filtered out of the frag stream.
+
+   The signatures of precompile instructions (ed25519, secp256k1) are
+   also verified here, off the serial execution path.  Transactions with
+   invalid precompile signatures are not filtered, since that is an
+   execution error, but only the ones that fully verified are marked
+   with FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED so the bank does not verify
+   them again. */
 
 FD_FN_CONST static inline ulong
 scratch_align( void ) {
@@ -39,6 +47,7 @@ before_frag( fd_verify_ctx_t * ctx,
   (void)in_idx;
   (void)sig;
 
+  ctx->frag_seen = 1;
   return (seq % ctx->round_robin_cnt) != ctx->round_robin_idx;
 }
 
@@ -66,6 +75,59 @@ during_frag( fd_verify_ctx_t * ctx,
   fd_memcpy( fd_txn_m_payload( dst ), src, sz );
 }
 
+/* flush_batch parses, verifies and publishes all staged transactions,
+   in the order they arrived. */
+
+static void
+flush_batch( fd_verify_ctx_t *   ctx,
+             fd_stem_context_t * stem ) {
+  ulong cnt = ctx->batch_cnt;
+  if( FD_UNLIKELY( !cnt ) ) return;
+  ctx->batch_cnt = 0UL;
+
+  uchar const * payload   [ FD_VERIFY_PARSE_BATCH ];
+  ulong         payload_sz[ FD_VERIFY_PARSE_BATCH ];
+  void *        out_buf   [ FD_VERIFY_PARSE_BATCH ];
+  ulong         out_sz    [ FD_VERIFY_PARSE_BATCH ];
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_txn_m_t * txnm = (fd_txn_m_t *)fd_chunk_to_laddr( ctx->out_mem, ctx->batch_chunk[ i ] );
+    payload   [ i ] = fd_txn_m_payload( txnm );
+    payload_sz[ i ] = txnm->payload_sz;
+    out_buf   [ i ] = fd_txn_m_txn_t( txnm );
+  }
+  fd_txn_parse_batch( payload, payload_sz, cnt, out_buf, out_sz, NULL );
+
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_txn_m_t * txnm = (fd_txn_m_t *)fd_chunk_to_laddr( ctx->out_mem, ctx->batch_chunk[ i ] );
+    fd_txn_t *   txnt = fd_txn_m_txn_t( txnm );
+    txnm->txn_t_sz = (ushort)out_sz[ i ];
+
+    if( FD_UNLIKELY( !txnm->txn_t_sz ) ) {
+      ctx->metrics.parse_fail_cnt++;
+      continue;
+    }
+
+    ulong _txn_sig;
+    int res = fd_txn_verify( ctx, fd_txn_m_payload( txnm ), txnm->payload_sz, txnt, &_txn_sig );
+    if( FD_UNLIKELY( res!=FD_TXN_VERIFY_SUCCESS ) ) {
+      if( FD_LIKELY( res==FD_TXN_VERIFY_DEDUP ) ) ctx->metrics.dedup_fail_cnt++;
+      else                                        ctx->metrics.verify_fail_cnt++;
+
+      continue;
+    }
+
+    txnm->flags = fd_uint_if( fd_precompile_verify_txn( txnt, fd_txn_m_payload( txnm ) ), FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED, 0U );
+
+    ulong realized_sz = fd_txn_m_realized_footprint( txnm, 0 );
+    ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_stem_publish( stem, 0UL, 0UL, ctx->batch_chunk[ i ], realized_sz, 0UL, ctx->batch_tsorig[ i ], tspub );
+  }
+}
+
+/* after_frag stages the transaction copied in during_frag.  Staged
+   transactions are not yet visible downstream, so each one reserves a
+   full FD_TPU_PARSED_MTU of the out dcache until it is flushed. */
+
 static inline void
 after_frag( fd_verify_ctx_t *   ctx,
             ulong               in_idx,
@@ -79,28 +141,30 @@ after_frag( fd_verify_ctx_t *   ctx,
   (void)sig;
   (void)sz;
 
-  fd_txn_m_t * txnm = (fd_txn_m_t *)fd_chunk_to_laddr( ctx->out_mem, ctx->out_chunk );
-  fd_txn_t *  txnt = fd_txn_m_txn_t( txnm );
-  txnm->txn_t_sz = (ushort)fd_txn_parse( fd_txn_m_payload( txnm ), txnm->payload_sz, txnt, NULL );
+  ctx->batch_chunk [ ctx->batch_cnt ] = ctx->out_chunk;
+  ctx->batch_tsorig[ ctx->batch_cnt ] = tsorig;
+  ctx->batch_cnt++;
+  ctx->out_chunk = fd_dcache_compact_next( ctx->out_chunk, FD_TPU_PARSED_MTU, ctx->out_chunk0, ctx->out_wmark );
 
-  if( FD_UNLIKELY( !txnm->txn_t_sz ) ) {
-    ctx->metrics.parse_fail_cnt++;
-    return;
-  }
+  if( FD_UNLIKELY( ctx->batch_cnt==FD_VERIFY_PARSE_BATCH ) ) flush_batch( ctx, stem );
+}
 
-  ulong _txn_sig;
-  int res = fd_txn_verify( ctx, fd_txn_m_payload( txnm ), txnm->payload_sz, txnt, &_txn_sig );
-  if( FD_UNLIKELY( res!=FD_TXN_VERIFY_SUCCESS ) ) {
-    if( FD_LIKELY( res==FD_TXN_VERIFY_DEDUP ) ) ctx->metrics.dedup_fail_cnt++;
-    else                                        ctx->metrics.verify_fail_cnt++;
+/* after_credit flushes a partial batch once a full pass of the stem
+   loop found no new frag, so staging never adds latency when the tile
+   is not saturated. */
 
-    return;
+static inline void
+after_credit( fd_verify_ctx_t *   ctx,
+              fd_stem_context_t * stem,
+              int *               opt_poll_in,
+              int *               charge_busy ) {
+  (void)opt_poll_in;
+
+  if( FD_UNLIKELY( ctx->batch_cnt && !ctx->frag_seen ) ) {
+    *charge_busy = 1;
+    flush_batch( ctx, stem );
   }
-
-  ulong realized_sz = fd_txn_m_realized_footprint( txnm, 0 );
-  ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
-  fd_stem_publish( stem, 0UL, 0UL, ctx->out_chunk, realized_sz, 0UL, tsorig, tspub );
-  ctx->out_chunk = fd_dcache_compact_next( ctx->out_chunk, realized_sz, ctx->out_chunk0, ctx->out_wmark );
+  ctx->frag_seen = 0;
 }
 
 static void
@@ -152,6 +216,9 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->out_wmark  = fd_dcache_compact_wmark ( ctx->out_mem, topo->links[ tile->out_link_id[ 0 ] ].dcache, topo->links[ tile->out_link_id[ 0 ] ].mtu );
   ctx->out_chunk  = ctx->out_chunk0;
 
+  ctx->batch_cnt = 0UL;
+  ctx->frag_seen = 0;
+
   ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
   if( FD_UNLIKELY( scratch_top > (ulong)scratch + scratch_footprint( tile ) ) )
     FD_LOG_ERR(( "scratch overflow %lu %lu %lu", scratch_top - (ulong)scratch - scratch_footprint( tile ), scratch_top, (ulong)scratch + scratch_footprint( tile ) ));
@@ -186,12 +253,13 @@ populate_allowed_fds( fd_topo_t const *      topo,
   return out_cnt;
 }
 
-#define STEM_BURST (1UL)
+#define STEM_BURST FD_VERIFY_PARSE_BATCH
 
 #define STEM_CALLBACK_CONTEXT_TYPE  fd_verify_ctx_t
 #define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_verify_ctx_t)
 
 #define STEM_CALLBACK_METRICS_WRITE metrics_write
+#define STEM_CALLBACK_AFTER_CREDIT  after_credit
 #define STEM_CALLBACK_BEFORE_FRAG   before_frag
 #define STEM_CALLBACK_DURING_FRAG   during_frag
 #define STEM_CALLBACK_AFTER_FRAG    after_frag
@@ -7,6 +7,13 @@
 #define FD_TXN_VERIFY_FAILED  -1
 #define FD_TXN_VERIFY_DEDUP   -2
 
+/* FD_VERIFY_PARSE_BATCH is the maximum number of incoming transactions
+   the verify tile stages in its out dcache before parsing them together
+   with fd_txn_parse_batch.  The verify_dedup link burst must be at
+   least this. */
+
+#define FD_VERIFY_PARSE_BATCH (8UL)
+
 /* fd_verify_in_ctx_t is a context object for each in (producer) mcache
    connected to the verify tile. */
 
@@ -38,6 +45,16 @@ typedef struct {
 
   ulong       hashmap_seed;
 
+  /* Transactions copied into the out dcache but not yet parsed,
+     verified or published.  batch_chunk[ i ] is the chunk of the i-th
+     staged transaction, in arrival order.  frag_seen is set whenever a
+     frag was found on an in since the last after_credit, so a partial
+     batch is only flushed once the ins have gone idle. */
+  ulong       batch_cnt;
+  ulong       batch_chunk [ FD_VERIFY_PARSE_BATCH ];
+  ulong       batch_tsorig[ FD_VERIFY_PARSE_BATCH ];
+  int         frag_seen;
+
   struct {
     ulong parse_fail_cnt;
     ulong verify_fail_cnt;
@@ -0,0 +1,189 @@
+/* test_batch_seccomp runs the file operations that snapshot creation
+   performs in the batch tile under the tile's seccomp policy.  Any
+   syscall that the policy does not allow kills the child with SIGSYS
+   before it can report success. */
+
+#define _GNU_SOURCE
+#include "../../../../util/fd_util.h"
+#include "../../../../util/sandbox/fd_sandbox_private.h"
+#include "../../../../util/archive/fd_tar.h"
+#include "../../../../ballet/zstd/fd_zstd.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <zstd.h>
+
+#include "generated/batch_seccomp.h"
+
+#define DATA_SZ  (300000UL)
+#define FRAME_SZ (1UL<<16)
+
+static char  dir[] = "/tmp/test_batch_seccomp_XXXXXX";
+static uchar data[ DATA_SZ ];
+static uchar in_buf [ FRAME_SZ ];
+static uchar out_buf[ FRAME_SZ + (FRAME_SZ>>7) + 512UL ];
+static uchar writer_mem[ sizeof(fd_tar_writer_t) ] __attribute__((aligned(alignof(fd_tar_writer_t))));
+static uchar cstream_mem[ 1UL<<23 ] __attribute__((aligned(FD_ZSTD_CSTREAM_ALIGN)));
+
+/* create_snapshot mirrors the file operations of
+   fd_snapshot_create_new_snapshot: reset the files, write the tar
+   archive with a back filled manifest and a reserved append vec that is
+   filled in with positioned writes, compress the archive in frames read
+   with positioned reads and rename the result. */
+
+static void
+create_snapshot( int          tmp_fd,
+                 int          snapshot_fd,
+                 char const * snapshot_name ) {
+
+  FD_TEST( !ftruncate( tmp_fd,      0L ) );
+  FD_TEST( !ftruncate( snapshot_fd, 0L ) );
+  FD_TEST( !lseek( tmp_fd,      0L, SEEK_SET ) );
+  FD_TEST( !lseek( snapshot_fd, 0L, SEEK_SET ) );
+
+  fd_tar_writer_t * writer = fd_tar_writer_new( writer_mem, tmp_fd );
+  FD_TEST( writer );
+
+  FD_TEST( !fd_tar_writer_new_file       ( writer, "version" ) );
+  FD_TEST( !fd_tar_writer_write_file_data( writer, "1.2.0", 5UL ) );
+  FD_TEST( !fd_tar_writer_fini_file      ( writer ) );
+
+  FD_TEST( !fd_tar_writer_new_file  ( writer, "snapshots/1/1" ) );
+  FD_TEST( !fd_tar_writer_make_space( writer, 1000UL ) );
+  FD_TEST( !fd_tar_writer_fini_file ( writer ) );
+
+  ulong data_off;
+  FD_TEST( !fd_tar_writer_reserve_file( writer, "accounts/1.0", DATA_SZ, &data_off ) );
+  for( ulong off=0UL; off<DATA_SZ; off+=4096UL ) {
+    ulong sz = fd_ulong_min( 4096UL, DATA_SZ-off );
+    FD_TEST( pwrite( tmp_fd, data+off, sz, (long)(data_off+off) )==(long)sz );
+  }
+
+  FD_TEST( !fd_tar_writer_fill_space( writer, data, 1000UL ) );
+  FD_TEST( fd_tar_writer_delete( writer ) );
+
+  long tar_sz = lseek( tmp_fd, 0L, SEEK_END );
+  FD_TEST( tar_sz>0L );
+
+  fd_zstd_cstream_t * cstream = fd_zstd_cstream_new( cstream_mem, ZSTD_CLEVEL_DEFAULT );
+  FD_TEST( cstream );
+  for( ulong in_off=0UL; in_off<(ulong)tar_sz; in_off+=FRAME_SZ ) {
+    ulong in_sz = fd_ulong_min( FRAME_SZ, (ulong)tar_sz-in_off );
+    FD_TEST( pread( tmp_fd, in_buf, in_sz, (long)in_off )==(long)in_sz );
+    FD_TEST( !fd_zstd_cstream_reset( cstream, in_sz ) );
+    uchar const * in  = in_buf;
+    uchar *       out = out_buf;
+    FD_TEST( fd_zstd_cstream_write( cstream, &in, in_buf+in_sz, &out, out_buf+sizeof(out_buf), 1, NULL )==-1 );
+    ulong out_sz = 0UL;
+    FD_TEST( !fd_io_write( snapshot_fd, out_buf, (ulong)(out-out_buf), (ulong)(out-out_buf), &out_sz ) );
+  }
+  fd_zstd_cstream_delete( cstream );
+
+  char tmp_name[ PATH_MAX ]; FD_TEST( fd_cstr_printf_check( tmp_name, PATH_MAX, NULL, "%s/%s.tmp", dir, snapshot_name ) );
+  char name    [ PATH_MAX ]; FD_TEST( fd_cstr_printf_check( name,     PATH_MAX, NULL, "%s/%s",     dir, snapshot_name ) );
+  FD_TEST( !rename( tmp_name, name ) );
+}
+
+static int
+open_file( char const * name ) {
+  char path[ PATH_MAX ];
+  FD_TEST( fd_cstr_printf_check( path, PATH_MAX, NULL, "%s/%s", dir, name ) );
+  int fd = open( path, O_CREAT | O_RDWR | O_TRUNC, 0644 );
+  FD_TEST( fd>=0 );
+  return fd;
+}
+
+/* check_snapshot decompresses the snapshot and checks that the append
+   vec data landed in the archive. */
+
+static void
+check_snapshot( char const * snapshot_name ) {
+  char path[ PATH_MAX ];
+  FD_TEST( fd_cstr_printf_check( path, PATH_MAX, NULL, "%s/%s", dir, snapshot_name ) );
+  FILE * file = fopen( path, "rb" );
+  FD_TEST( file );
+  static uchar comp[ 1UL<<20 ];
+  static uchar tar [ 1UL<<20 ];
+  ulong comp_sz = fread( comp, 1UL, sizeof(comp), file );
+  FD_TEST( !fclose( file ) );
+
+  ulong tar_sz = ZSTD_decompress( tar, sizeof(tar), comp, comp_sz );
+  FD_TEST( !ZSTD_isError( tar_sz ) );
+  FD_TEST( tar_sz>DATA_SZ );
+
+  int found = 0;
+  for( ulong off=0UL; off+DATA_SZ<=tar_sz; off+=FD_TAR_BLOCK_SZ ) {
+    if( !memcmp( tar+off, data, DATA_SZ ) ) { found = 1; break; }
+  }
+  FD_TEST( found );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+  for( ulong i=0UL; i<DATA_SZ; i++ ) data[ i ] = (uchar)fd_rng_uint_roll( rng, 16U );
+
+  FD_TEST( fd_zstd_cstream_footprint( ZSTD_CLEVEL_DEFAULT )<=sizeof(cstream_mem) );
+
+  FD_TEST( mkdtemp( dir ) );
+  int tmp_fd                  = open_file( "tmp.tar" );
+  int tmp_inc_fd              = open_file( "tmp_inc.tar" );
+  int full_snapshot_fd        = open_file( "full.tar.zst.tmp" );
+  int incremental_snapshot_fd = open_file( "incr.tar.zst.tmp" );
+
+  /* The child reports success through the pipe, which is passed to the
+     policy as the log file.  The tile policy does not allow exit, so the
+     child is always killed by SIGSYS at the end. */
+
+  int pipe_fd[2];
+  FD_TEST( !pipe( pipe_fd ) );
+
+  struct sock_filter filter[ 128UL ];
+  populate_sock_filter_policy_batch( 128UL, filter, (uint)pipe_fd[1], (uint)tmp_fd, (uint)tmp_inc_fd,
+                                     (uint)full_snapshot_fd, (uint)incremental_snapshot_fd );
+
+  pid_t pid = fork();
+  FD_TEST( pid>=0 );
+  if( !pid ) {
+    FD_TEST( -1!=prctl( PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0 ) );
+    fd_sandbox_private_set_seccomp_filter( (ushort)sock_filter_policy_batch_instr_cnt, filter );
+    create_snapshot( tmp_fd,     full_snapshot_fd,        "full.tar.zst" );
+    create_snapshot( tmp_inc_fd, incremental_snapshot_fd, "incr.tar.zst" );
+    FD_TEST( write( pipe_fd[1], "ok", 2UL )==2L );
+    exit( EXIT_SUCCESS );
+  }
+
+  FD_TEST( !close( pipe_fd[1] ) );
+  char msg[ 2 ] = {0};
+  long sz = read( pipe_fd[0], msg, 2UL );
+
+  int wstatus;
+  FD_TEST( waitpid( pid, &wstatus, 0 )==pid );
+  FD_TEST( WIFSIGNALED( wstatus ) && WTERMSIG( wstatus )==SIGSYS );
+  FD_TEST( sz==2L && !memcmp( msg, "ok", 2UL ) );
+
+  check_snapshot( "full.tar.zst" );
+  check_snapshot( "incr.tar.zst" );
+
+  char const * names[] = { "tmp.tar", "tmp_inc.tar", "full.tar.zst", "incr.tar.zst" };
+  for( ulong i=0UL; i<4UL; i++ ) {
+    char path[ PATH_MAX ];
+    FD_TEST( fd_cstr_printf_check( path, PATH_MAX, NULL, "%s/%s", dir, names[ i ] ) );
+    FD_TEST( !unlink( path ) );
+  }
+  FD_TEST( !rmdir( dir ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -1,8 +1,10 @@
 /* Firedancer topology used for testing the full validator.
    Associated test script: test_firedancer.sh */
 #include "../../fdctl.h"
+#include "../tiles/fd_verify.h"
 
 #include "../tiles/fd_replay_notif.h"
+#include "../../../../disco/geyser/fd_geyser_acct.h"
 #include "../../../../choreo/fd_choreo_base.h"
 #include "../../../../disco/quic/fd_tpu.h"
 #include "../../../../disco/tiles.h"
@@ -11,6 +13,7 @@
 #include "../../../../flamenco/runtime/fd_blockstore.h"
 #include "../../../../flamenco/runtime/fd_runtime.h"
 #include "../../../../flamenco/runtime/fd_txncache.h"
+#include "../../../../flamenco/vm/fd_vm_base.h"
 #include "../../../../util/tile/fd_tile_private.h"
 #include "../../../../util/shmem/fd_shmem_private.h"
 #include "../../../../util/net/fd_net_headers.h"
@@ -146,6 +149,7 @@ fd_topo_initialize( config_t * config ) {
   fd_topob_wksp( topo, "bhole"      );
   fd_topob_wksp( topo, "bstore"     );
   fd_topob_wksp( topo, "tcache"     );
+  fd_topob_wksp( topo, "vm_prof"    );
   fd_topob_wksp( topo, "pohi"       );
   fd_topob_wksp( topo, "voter"      );
   fd_topob_wksp( topo, "poh_slot"   );
@@ -167,7 +171,7 @@ fd_topo_initialize( config_t * config ) {
   FOR(net_tile_cnt)    fd_topob_link( topo, "net_shred",    "net_shred",    config->tiles.net.send_buffer_size,       FD_NET_MTU,                    1UL );
   FOR(shred_tile_cnt)  fd_topob_link( topo, "shred_net",    "net_shred",    config->tiles.net.send_buffer_size,       FD_NET_MTU,                    1UL );
   FOR(quic_tile_cnt)   fd_topob_link( topo, "quic_verify",  "quic_verify",  config->tiles.verify.receive_buffer_size, FD_TPU_REASM_MTU,              config->tiles.quic.txn_reassembly_count );
-  FOR(verify_tile_cnt) fd_topob_link( topo, "verify_dedup", "verify_dedup", config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             1UL );
+  FOR(verify_tile_cnt) fd_topob_link( topo, "verify_dedup", "verify_dedup", config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             FD_VERIFY_PARSE_BATCH );
   /**/                 fd_topob_link( topo, "dedup_pack",   "dedup_pack",   config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             1UL );
 
   /**/                 fd_topob_link( topo, "stake_out",    "stake_out",    128UL,                                    40UL + 40200UL * 40UL,         1UL );
@@ -293,6 +297,16 @@ fd_topo_initialize( config_t * config ) {
 
   FD_TEST( fd_pod_insertf_ulong( topo->props, txncache_obj->id, "txncache" ) );
 
+  /* Create an on-chain program profiler sampled into by replay (and its
+     tpool threads) and exported by the metric tile. */
+  fd_topo_tile_t * metric_tile = &topo->tiles[ fd_topo_find_tile( topo, "metric", 0UL ) ];
+  fd_topo_obj_t * vm_prof_obj = fd_topob_obj( topo, "vm_prof", "vm_prof" );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, FD_VM_PROF_DEFAULT_PROG_MAX,      "obj.%lu.prog_max",      vm_prof_obj->id ) );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, FD_VM_PROF_DEFAULT_SAMPLE_PERIOD, "obj.%lu.sample_period", vm_prof_obj->id ) );
+  fd_topob_tile_uses( topo, replay_tile, vm_prof_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+  fd_topob_tile_uses( topo, metric_tile, vm_prof_obj, FD_SHMEM_JOIN_MODE_READ_ONLY  );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, vm_prof_obj->id, "vm_prof" ) );
+
   fd_topo_tile_t * pack_tile = &topo->tiles[ fd_topo_find_tile( topo, "pack", 0UL ) ];
   for( ulong i=0UL; i<bank_tile_cnt; i++ ) {
     fd_topo_obj_t * busy_obj = fd_topob_obj( topo, "fseq", "bank_busy" );
@@ -501,6 +515,15 @@ fd_topo_initialize( config_t * config ) {
     /**/                 fd_topob_tile_in(  topo, "gui",    0UL,        "metric_in",     "plugin_out",   0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   }
 
+  /* The account stream is read by external geyser consumers, which
+     attach to the workspace directly, so it has no reliable consumer. */
+  if( FD_UNLIKELY( config->tiles.replay.account_stream ) ) {
+    fd_topob_wksp( topo, "replay_acct" );
+    /**/                 fd_topob_link(     topo, "replay_acct", "replay_acct", FD_GEYSER_ACCT_DEPTH,           FD_GEYSER_ACCT_MTU,            1UL   );
+    /**/                 fd_topob_tile_out( topo, "replay", 0UL,                        "replay_acct",  0UL                                                  );
+    /**/                 fd_topob_tile_in(  topo, "bhole",  0UL,           "metric_in", "replay_acct",  0UL,          FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED );
+  }
+
   for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
     fd_topo_tile_t * tile = &topo->tiles[ i ];
 
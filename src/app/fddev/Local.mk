@@ -10,12 +10,14 @@ include src/app/fdctl/with-version.mk
 .PHONY: fddev run monitor
 
 # fddev core
-$(call add-objs,main1 dev dev1 txn bench load dump flame wksp,fd_fddev)
+$(call add-objs,main1 dev dev1 txn bench load dump flame wksp record tilebench vmprof,fd_fddev)
 
 # fddev tiles
 $(call add-objs,tiles/fd_bencho,fd_fddev)
 $(call add-objs,tiles/fd_benchg,fd_fddev)
 $(call add-objs,tiles/fd_benchs,fd_fddev)
+$(call add-objs,tiles/fd_tbplay,fd_fddev)
+$(call add-objs,tiles/fd_tbsink,fd_fddev)
 
 # fddev configure stages
 $(call add-objs,configure/netns,fd_fddev)
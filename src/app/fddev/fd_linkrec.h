@@ -0,0 +1,107 @@
+#ifndef HEADER_fd_src_app_fddev_fd_linkrec_h
+#define HEADER_fd_src_app_fddev_fd_linkrec_h
+
+/* fd_linkrec is a simple file format for recordings of the traffic on
+   one or more tango links, as written by `fddev record` and replayed by
+   `fddev tilebench`.
+
+   It is laid out like a stripped down pcapng: a file header describing
+   each recorded link (the equivalent of interface description blocks),
+   followed by one record per frag (the equivalent of enhanced packet
+   blocks).  Each frag record holds the time the frag was observed, the
+   index of the link it was observed on, the frag metadata as found in
+   the mcache and the frag payload as found in the dcache.  pcapng is
+   not used directly as frag payloads can be up to USHORT_MAX bytes,
+   beyond what fd_pcapng supports.
+
+   All fields are little endian (i.e. the host byte order on all
+   supported platforms) and records are 8 byte aligned in the file. */
+
+#include "../../tango/fd_tango_base.h"
+
+#define FD_LINKREC_MAGIC    (0xf17eda2c11c4ec00UL) /* fd linkrec 00 */
+#define FD_LINKREC_VERSION  (1UL)
+#define FD_LINKREC_LINK_MAX (32UL)
+
+struct fd_linkrec_link {
+  char  name[ 16 ]; /* link name, '\0' terminated */
+  ulong kind_id;    /* link kind_id in the recorded topology */
+  ulong depth;      /* depth of the recorded link */
+  ulong mtu;        /* mtu of the recorded link, 0 if it has no dcache */
+};
+typedef struct fd_linkrec_link fd_linkrec_link_t;
+
+struct fd_linkrec_hdr {
+  ulong             magic;    /* ==FD_LINKREC_MAGIC */
+  ulong             version;  /* ==FD_LINKREC_VERSION */
+  ulong             link_cnt; /* in [1,FD_LINKREC_LINK_MAX] */
+  long              ts0;      /* fd_log_wallclock() at start of recording */
+  fd_linkrec_link_t link[ FD_LINKREC_LINK_MAX ];
+};
+typedef struct fd_linkrec_hdr fd_linkrec_hdr_t;
+
+/* A fd_linkrec_frag_t is followed by sz bytes of payload, then zero
+   padding up to the next multiple of 8 bytes.  meta_sz is the size of
+   the frag as published while sz is the number of payload bytes that
+   were recorded (0 for links without a dcache, meta_sz otherwise). */
+
+struct fd_linkrec_frag {
+  long   ts;       /* fd_log_wallclock() when the frag was observed */
+  uint   link_idx; /* index into hdr->link */
+  uint   sz;       /* payload bytes following this header */
+  ulong  seq;      /* frag metadata as published */
+  ulong  sig;
+  uint   chunk;
+  ushort meta_sz;
+  ushort ctl;
+  uint   tsorig;
+  uint   tspub;
+};
+typedef struct fd_linkrec_frag fd_linkrec_frag_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_CONST static inline ulong
+fd_linkrec_frag_footprint( ulong sz ) {
+  return sizeof(fd_linkrec_frag_t) + fd_ulong_align_up( sz, 8UL );
+}
+
+/* fd_linkrec_hdr_check returns buf as a header if buf (of buf_sz
+   bytes) starts with a valid fd_linkrec header and NULL otherwise. */
+
+FD_FN_PURE static inline fd_linkrec_hdr_t const *
+fd_linkrec_hdr_check( void const * buf,
+                      ulong        buf_sz ) {
+  fd_linkrec_hdr_t const * hdr = (fd_linkrec_hdr_t const *)buf;
+  if( FD_UNLIKELY( buf_sz<sizeof(fd_linkrec_hdr_t)                                   ) ) return NULL;
+  if( FD_UNLIKELY( hdr->magic!=FD_LINKREC_MAGIC || hdr->version!=FD_LINKREC_VERSION ) ) return NULL;
+  if( FD_UNLIKELY( !hdr->link_cnt || hdr->link_cnt>FD_LINKREC_LINK_MAX              ) ) return NULL;
+  return hdr;
+}
+
+/* fd_linkrec_frag_next returns the frag record at byte offset *off of
+   the recording in buf (of buf_sz bytes) and advances *off past it.
+   Returns NULL at the end of the recording or if the record at *off is
+   truncated or corrupt. */
+
+static inline fd_linkrec_frag_t const *
+fd_linkrec_frag_next( void const * buf,
+                      ulong        buf_sz,
+                      ulong *      off ) {
+  fd_linkrec_hdr_t const * hdr = (fd_linkrec_hdr_t const *)buf;
+  if( FD_UNLIKELY( *off+sizeof(fd_linkrec_frag_t)>buf_sz ) ) return NULL;
+  fd_linkrec_frag_t const * frag = (fd_linkrec_frag_t const *)( (uchar const *)buf + *off );
+  ulong footprint = fd_linkrec_frag_footprint( frag->sz );
+  if( FD_UNLIKELY( *off+footprint>buf_sz || frag->link_idx>=hdr->link_cnt || frag->sz>USHORT_MAX ) ) return NULL;
+  *off += footprint;
+  return frag;
+}
+
+FD_FN_CONST static inline uchar const *
+fd_linkrec_frag_payload( fd_linkrec_frag_t const * frag ) {
+  return (uchar const *)( frag+1 );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_app_fddev_fd_linkrec_h */
@@ -131,4 +131,36 @@ void
 quic_trace_cmd_fn( args_t *         args,
                    config_t * const config );
 
+void
+record_cmd_args( int *    pargc,
+                 char *** pargv,
+                 args_t * args );
+
+void
+record_cmd_fn( args_t *         args,
+               config_t * const config );
+
+void
+vmprof_cmd_args( int *    pargc,
+                 char *** pargv,
+                 args_t * args );
+
+void
+vmprof_cmd_fn( args_t *         args,
+               config_t * const config );
+
+void
+tilebench_cmd_perm( args_t *         args,
+                    fd_caps_ctx_t *  caps,
+                    config_t * const config );
+
+void
+tilebench_cmd_args( int *    pargc,
+                    char *** pargv,
+                    args_t * args );
+
+void
+tilebench_cmd_fn( args_t *         args,
+                  config_t * const config );
+
 #endif /* HEADER_fd_src_app_fddev_fddev_h */
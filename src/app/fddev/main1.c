@@ -52,6 +52,8 @@ extern fd_topo_run_tile_t fd_tile_blackhole;
 extern fd_topo_run_tile_t fd_tile_bencho;
 extern fd_topo_run_tile_t fd_tile_benchg;
 extern fd_topo_run_tile_t fd_tile_benchs;
+extern fd_topo_run_tile_t fd_tile_tbplay;
+extern fd_topo_run_tile_t fd_tile_tbsink;
 
 #ifdef FD_HAS_NO_AGAVE
 extern fd_topo_run_tile_t fd_tile_gossip;
@@ -87,6 +89,8 @@ fd_topo_run_tile_t * TILES[] = {
   &fd_tile_bencho,
   &fd_tile_benchg,
   &fd_tile_benchs,
+  &fd_tile_tbplay,
+  &fd_tile_tbsink,
 #ifdef FD_HAS_NO_AGAVE
   &fd_tile_gossip,
   &fd_tile_repair,
@@ -113,6 +117,9 @@ static action_t DEV_ACTIONS[] = {
   { .name = "dump",    .args = dump_cmd_args,    .fn = dump_cmd_fn,    .perm = NULL,           .is_diagnostic=1 },
   { .name = "flame",   .args = flame_cmd_args,   .fn = flame_cmd_fn,   .perm = flame_cmd_perm, .is_diagnostic=1 },
   { .name = "quic-trace", .args = quic_trace_cmd_args, .fn = quic_trace_cmd_fn, .perm = NULL, .is_diagnostic=1 },
+  { .name = "record",    .args = record_cmd_args,    .fn = record_cmd_fn,    .perm = NULL,               .is_diagnostic=1 },
+  { .name = "tilebench", .args = tilebench_cmd_args, .fn = tilebench_cmd_fn, .perm = tilebench_cmd_perm },
+  { .name = "vmprof",    .args = vmprof_cmd_args,    .fn = vmprof_cmd_fn,    .perm = NULL,               .is_diagnostic=1 },
 };
 
 extern char fd_log_private_path[ 1024 ];
@@ -0,0 +1,193 @@
+#include "fddev.h"
+#include "fd_linkrec.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* `fddev record` follows one or more links of a running validator as
+   an unreliable consumer and writes every frag it observes, metadata
+   and payload, to an fd_linkrec file for later replay with `fddev
+   tilebench`.  As the recorder is not flow controlled, it can miss
+   frags if it falls more than a link depth behind the producer.  These
+   are counted and reported but not recorded. */
+
+void
+record_cmd_args( int *    pargc,
+                 char *** pargv,
+                 args_t * args ) {
+  char const * out_file = fd_env_strip_cmdline_cstr ( pargc, pargv, "--out-file", NULL, "record.linkrec" );
+  char const * link     = fd_env_strip_cmdline_cstr ( pargc, pargv, "--link",     NULL, NULL             );
+  args->record.duration = fd_env_strip_cmdline_ulong( pargc, pargv, "--duration", NULL, 10UL             );
+
+  if( FD_UNLIKELY( !link ) ) FD_LOG_ERR(( "usage: record --link <name[:kind_id]>,... [--out-file <path>] [--duration <seconds>]" ));
+
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->record.out_path  ), out_file, sizeof(args->record.out_path )-1UL ) );
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->record.link_name ), link,     sizeof(args->record.link_name)-1UL ) );
+}
+
+typedef struct {
+  fd_topo_link_t const * link;
+  fd_frag_meta_t const * mcache;
+  ulong                  depth;
+  void const *           base;
+  ulong                  seq;
+
+  ulong                  frag_cnt;
+  ulong                  frag_sz;
+  ulong                  ovrn_cnt;
+} record_link_t;
+
+/* record_link_poll records the next frag of link if it is available.
+   Returns 1 if a frag was recorded and 0 otherwise. */
+
+static int
+record_link_poll( record_link_t * rl,
+                  ulong           link_idx,
+                  FILE *          out ) {
+  fd_frag_meta_t const * mline = rl->mcache + fd_mcache_line_idx( rl->seq, rl->depth );
+
+  FD_COMPILER_MFENCE();
+  ulong seq_found = fd_frag_meta_seq_query( mline );
+  FD_COMPILER_MFENCE();
+
+  long diff = fd_seq_diff( seq_found, rl->seq );
+  if( FD_LIKELY( diff<0L ) ) return 0; /* Caught up */
+  if( FD_UNLIKELY( diff>0L ) ) { /* Overrun, resume from here */
+    rl->ovrn_cnt += (ulong)diff;
+    rl->seq       = seq_found;
+    return 0;
+  }
+
+  static uchar payload[ USHORT_MAX+1UL ] __attribute__((aligned(8)));
+
+  fd_linkrec_frag_t frag = {
+    .link_idx = (uint)link_idx,
+    .seq      = seq_found,
+    .sig      = mline->sig,
+    .chunk    = mline->chunk,
+    .meta_sz  = mline->sz,
+    .ctl      = mline->ctl,
+    .tsorig   = mline->tsorig,
+    .tspub    = mline->tspub,
+  };
+  ulong sz = fd_ulong_if( !!rl->link->mtu, fd_ulong_min( (ulong)frag.meta_sz, rl->link->mtu ), 0UL );
+  if( FD_LIKELY( sz ) ) fd_memcpy( payload, fd_chunk_to_laddr_const( rl->base, frag.chunk ), sz );
+
+  FD_COMPILER_MFENCE();
+  ulong seq_test = fd_frag_meta_seq_query( mline );
+  FD_COMPILER_MFENCE();
+  if( FD_UNLIKELY( seq_test!=seq_found ) ) { /* Overrun while reading */
+    rl->ovrn_cnt++;
+    rl->seq = seq_test;
+    return 0;
+  }
+
+  frag.ts = fd_log_wallclock();
+  frag.sz = (uint)sz;
+
+  ulong pad_sz = fd_ulong_align_up( sz, 8UL ) - sz;
+  fd_memset( payload+sz, 0, pad_sz );
+  if( FD_UNLIKELY( 1UL!=fwrite( &frag, sizeof(fd_linkrec_frag_t), 1UL, out ) ) ) FD_LOG_ERR(( "fwrite failed" ));
+  if( FD_UNLIKELY( sz+pad_sz && 1UL!=fwrite( payload, sz+pad_sz, 1UL, out ) ) ) FD_LOG_ERR(( "fwrite failed" ));
+
+  rl->frag_cnt++;
+  rl->frag_sz += sz;
+  rl->seq      = fd_seq_inc( rl->seq, 1UL );
+  return 1;
+}
+
+void
+record_cmd_fn( args_t *         args,
+               config_t * const config ) {
+  fd_topo_t * topo = &config->topo;
+
+  fd_topo_join_workspaces( topo, FD_SHMEM_JOIN_MODE_READ_ONLY );
+  fd_topo_fill( topo );
+
+  fd_linkrec_hdr_t hdr[1];
+  fd_memset( hdr, 0, sizeof(fd_linkrec_hdr_t) );
+  hdr->magic   = FD_LINKREC_MAGIC;
+  hdr->version = FD_LINKREC_VERSION;
+
+  record_link_t links[ FD_LINKREC_LINK_MAX ];
+
+  char * tokens[ FD_LINKREC_LINK_MAX ];
+  ulong token_cnt = fd_cstr_tokenize( tokens, FD_LINKREC_LINK_MAX, args->record.link_name, ',' );
+  if( FD_UNLIKELY( token_cnt>FD_LINKREC_LINK_MAX ) ) FD_LOG_ERR(( "at most %lu links can be recorded at once", FD_LINKREC_LINK_MAX ));
+
+  for( ulong k=0UL; k<token_cnt; k++ ) {
+    char * sep     = strchr( tokens[ k ], ':' );
+    ulong  kind_id = ULONG_MAX; /* all links with the name */
+    if( sep ) {
+      char * endptr;
+      *sep = '\0';
+      kind_id = strtoul( sep+1, &endptr, 10 );
+      if( FD_UNLIKELY( *endptr!='\0' || kind_id==ULONG_MAX ) ) FD_LOG_ERR(( "invalid link kind id provided `%s`", sep+1 ));
+    }
+
+    ulong found = 0UL;
+    for( ulong i=0UL; i<topo->link_cnt; i++ ) {
+      fd_topo_link_t const * link = &topo->links[ i ];
+      if( strcmp( link->name, tokens[ k ] ) || (kind_id!=ULONG_MAX && link->kind_id!=kind_id) ) continue;
+      found = 1UL;
+
+      if( FD_UNLIKELY( hdr->link_cnt==FD_LINKREC_LINK_MAX ) ) FD_LOG_ERR(( "at most %lu links can be recorded at once", FD_LINKREC_LINK_MAX ));
+
+      fd_linkrec_link_t * rec_link = &hdr->link[ hdr->link_cnt ];
+      fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( rec_link->name ), link->name, sizeof(rec_link->name)-1UL ) );
+      rec_link->kind_id = link->kind_id;
+      rec_link->depth   = link->depth;
+      rec_link->mtu     = link->mtu;
+
+      record_link_t * rl = &links[ hdr->link_cnt ];
+      rl->link     = link;
+      rl->mcache   = link->mcache;
+      rl->depth    = fd_mcache_depth( link->mcache );
+      rl->base     = link->mtu ? topo->workspaces[ topo->objs[ link->dcache_obj_id ].wksp_id ].wksp : NULL;
+      rl->seq      = fd_mcache_seq_query( fd_mcache_seq_laddr_const( link->mcache ) );
+      rl->frag_cnt = 0UL;
+      rl->frag_sz  = 0UL;
+      rl->ovrn_cnt = 0UL;
+
+      hdr->link_cnt++;
+    }
+    if( FD_UNLIKELY( !found ) ) FD_LOG_ERR(( "link `%s` not found", tokens[ k ] ));
+  }
+
+  FILE * out = fopen( args->record.out_path, "w" );
+  if( FD_UNLIKELY( !out ) ) FD_LOG_ERR(( "fopen(%s) failed (%i-%s)", args->record.out_path, errno, fd_io_strerror( errno ) ));
+  static char out_buf[ 1UL<<24 ];
+  if( FD_UNLIKELY( setvbuf( out, out_buf, _IOFBF, sizeof(out_buf) ) ) ) FD_LOG_ERR(( "setvbuf failed" ));
+
+  hdr->ts0 = fd_log_wallclock();
+  if( FD_UNLIKELY( 1UL!=fwrite( hdr, sizeof(fd_linkrec_hdr_t), 1UL, out ) ) ) FD_LOG_ERR(( "fwrite failed" ));
+
+  FD_LOG_NOTICE(( "recording %lu link(s) to %s for %lu s", hdr->link_cnt, args->record.out_path, args->record.duration ));
+
+  long deadline = hdr->ts0 + (long)args->record.duration*1000L*1000L*1000L;
+  long next_log = hdr->ts0 + 1000L*1000L*1000L;
+  for(;;) {
+    int did_work = 0;
+    for( ulong i=0UL; i<hdr->link_cnt; i++ ) did_work |= record_link_poll( &links[ i ], i, out );
+
+    long now = fd_log_wallclock();
+    if( FD_UNLIKELY( now>=deadline ) ) break;
+    if( FD_UNLIKELY( now>=next_log ) ) {
+      ulong frag_cnt = 0UL;
+      for( ulong i=0UL; i<hdr->link_cnt; i++ ) frag_cnt += links[ i ].frag_cnt;
+      FD_LOG_NOTICE(( "recorded %lu frags", frag_cnt ));
+      next_log += 1000L*1000L*1000L;
+    }
+    if( FD_UNLIKELY( !did_work ) ) FD_SPIN_PAUSE();
+  }
+
+  if( FD_UNLIKELY( fclose( out ) ) ) FD_LOG_ERR(( "fclose(%s) failed (%i-%s)", args->record.out_path, errno, fd_io_strerror( errno ) ));
+
+  for( ulong i=0UL; i<hdr->link_cnt; i++ ) {
+    record_link_t const * rl = &links[ i ];
+    FD_LOG_NOTICE(( "%s:%lu: recorded %lu frags (%lu bytes), missed %lu frags to overruns",
+                    rl->link->name, rl->link->kind_id, rl->frag_cnt, rl->frag_sz, rl->ovrn_cnt ));
+  }
+
+  fd_topo_leave_workspaces( topo );
+}
@@ -0,0 +1,241 @@
+#define _GNU_SOURCE
+#include "fddev.h"
+#include "fd_linkrec.h"
+#include "tiles/fd_tilebench.h"
+
+#include "../fdctl/configure/configure.h"
+#include "../fdctl/run/run.h"
+
+#include "../../disco/topo/fd_topob.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/* `fddev tilebench` benchmarks a single tile in isolation against
+   recorded traffic (see `fddev record`).  The full topology is created
+   as usual but only three tiles are started: the tile under test, a
+   tbplay tile which replays the recording into the in links of the
+   tile under test, and a tbsink tile which drains its out links.  See
+   tiles/fd_tilebench.h.
+
+   Once the recording has been replayed and the tile under test went
+   idle, the throughput, the per frag latency histogram and the time
+   spent backpressured are reported.
+
+   Tiles that shard an in link across multiple tiles of the same kind
+   (e.g. verify and shred) only process their share of the replayed
+   frags, so those are best benchmarked with a layout configured for a
+   single tile of the kind.  Tiles that depend on other tiles beyond
+   their in links (e.g. pack on bank and poh) will not make progress. */
+
+void
+tilebench_cmd_perm( args_t *         args,
+                    fd_caps_ctx_t *  caps,
+                    config_t * const config ) {
+  bench_cmd_perm( args, caps, config );
+}
+
+void
+tilebench_cmd_args( int *    pargc,
+                    char *** pargv,
+                    args_t * args ) {
+  char const * tile    = fd_env_strip_cmdline_cstr ( pargc, pargv, "--tile",    NULL, NULL          );
+  char const * in_file = fd_env_strip_cmdline_cstr ( pargc, pargv, "--in-file", NULL, NULL          );
+  char const * rate    = fd_env_strip_cmdline_cstr ( pargc, pargv, "--rate",    NULL, "recorded"    );
+  args->tilebench.loop_cnt = fd_env_strip_cmdline_ulong( pargc, pargv, "--loop",    NULL, 1UL   );
+  args->tilebench.timeout  = fd_env_strip_cmdline_ulong( pargc, pargv, "--timeout", NULL, 600UL );
+
+  if( FD_UNLIKELY( !tile || !in_file ) )
+    FD_LOG_ERR(( "usage: tilebench --tile <name[:kind_id]> --in-file <path> [--rate recorded|max] [--loop <cnt>] [--timeout <seconds>]" ));
+
+  if(      !strcmp( rate, "recorded" ) ) args->tilebench.max_rate = 0;
+  else if( !strcmp( rate, "max"      ) ) args->tilebench.max_rate = 1;
+  else FD_LOG_ERR(( "unknown --rate `%s`, should be `recorded` or `max`", rate ));
+
+  char name[ 32 ];
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( name ), tile, sizeof(name)-1UL ) );
+  args->tilebench.kind_id = 0UL;
+  char * sep = strchr( name, ':' );
+  if( sep ) {
+    char * endptr;
+    *sep = '\0';
+    args->tilebench.kind_id = strtoul( sep+1, &endptr, 10 );
+    if( FD_UNLIKELY( *endptr!='\0' || args->tilebench.kind_id==ULONG_MAX ) ) FD_LOG_ERR(( "invalid tile kind id provided `%s`", sep+1 ));
+  }
+  if( FD_UNLIKELY( strlen( name )>=sizeof(args->tilebench.tile_name) ) ) FD_LOG_ERR(( "unknown tile `%s`", name ));
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->tilebench.tile_name ), name,    sizeof(args->tilebench.tile_name)-1UL ) );
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->tilebench.in_path   ), in_file, sizeof(args->tilebench.in_path  )-1UL ) );
+}
+
+static void
+add_tilebench_topo( fd_topo_t *  topo,
+                    ulong        target_tile_id,
+                    char const * rec_path,
+                    ulong        rec_sz,
+                    int          max_rate,
+                    ulong        loop_cnt ) {
+  fd_topo_tile_t const * target = &topo->tiles[ target_tile_id ];
+
+  fd_topob_wksp( topo, "tilebench" );
+
+  fd_topo_tile_t * tbplay = fd_topob_tile( topo, "tbplay", "tilebench", "tilebench", ULONG_MAX, 0 );
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( tbplay->tbplay.rec_path ), rec_path, sizeof(tbplay->tbplay.rec_path)-1UL ) );
+  tbplay->tbplay.rec_sz         = rec_sz;
+  tbplay->tbplay.target_tile_id = target_tile_id;
+  tbplay->tbplay.max_rate       = max_rate;
+  tbplay->tbplay.loop_cnt       = loop_cnt;
+
+  /* tbplay publishes into the in links of the tile under test in place
+     of their producers, and reads their flow control credits */
+
+  for( ulong i=0UL; i<target->in_cnt; i++ ) {
+    fd_topo_link_t const * link = &topo->links[ target->in_link_id[ i ] ];
+    fd_topob_tile_uses( topo, tbplay, &topo->objs[ link->mcache_obj_id ], FD_SHMEM_JOIN_MODE_READ_WRITE );
+    if( link->mtu ) fd_topob_tile_uses( topo, tbplay, &topo->objs[ link->dcache_obj_id ], FD_SHMEM_JOIN_MODE_READ_WRITE );
+    fd_topob_tile_uses( topo, tbplay, &topo->objs[ target->in_link_fseq_obj_id[ i ] ], FD_SHMEM_JOIN_MODE_READ_ONLY );
+  }
+
+  /* tbsink consumes the out links of the tile under test and returns
+     credits on behalf of all of their reliable consumers */
+
+  fd_topo_tile_t * tbsink = fd_topob_tile( topo, "tbsink", "tilebench", "tilebench", ULONG_MAX, 0 );
+  tbsink->tbsink.target_tile_id = target_tile_id;
+
+  for( ulong i=0UL; i<target->out_cnt; i++ ) {
+    fd_topo_link_t const * link = &topo->links[ target->out_link_id[ i ] ];
+    for( ulong j=0UL; j<topo->tile_cnt; j++ ) {
+      fd_topo_tile_t const * consumer = &topo->tiles[ j ];
+      for( ulong k=0UL; k<consumer->in_cnt; k++ ) {
+        if( consumer->in_link_id[ k ]==link->id && consumer->in_link_reliable[ k ] )
+          fd_topob_tile_uses( topo, tbsink, &topo->objs[ consumer->in_link_fseq_obj_id[ k ] ], FD_SHMEM_JOIN_MODE_READ_WRITE );
+      }
+    }
+    fd_topob_tile_in( topo, "tbsink", 0UL, "tilebench", link->name, link->kind_id, FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED );
+  }
+
+  fd_topob_finish( topo, fdctl_obj_align, fdctl_obj_footprint, fdctl_obj_loose );
+}
+
+static void
+tilebench_report( fd_topo_tile_t const *    target,
+                  fd_tbplay_stats_t const * play,
+                  fd_tbsink_stats_t const * sink,
+                  double                    tick_per_ns ) {
+  double play_s = (double)( play->ts_end  - play->ts_start ) / 1e9;
+  double sink_s = (double)( sink->ts_last - sink->ts_first ) / 1e9;
+
+  FD_LOG_NOTICE(( "tilebench %s:%lu", target->name, target->kind_id ));
+  FD_LOG_NOTICE(( "  in:  %lu frags, %lu bytes in %.3f s (%.0f frag/s, %.3f MB/s), %lu frags skipped",
+                  play->pub_cnt, play->pub_sz, play_s,
+                  (double)play->pub_cnt / fmax( play_s, 1e-9 ),
+                  (double)play->pub_sz  / fmax( play_s, 1e-9 ) / 1e6,
+                  play->skip_cnt ));
+  FD_LOG_NOTICE(( "  out: %lu frags, %lu bytes in %.3f s (%.0f frag/s, %.3f MB/s)",
+                  sink->frag_cnt, sink->frag_sz, sink_s,
+                  (double)sink->frag_cnt / fmax( sink_s, 1e-9 ),
+                  (double)sink->frag_sz  / fmax( sink_s, 1e-9 ) / 1e6 ));
+  FD_LOG_NOTICE(( "  backpressure: %lu times, %.3f ms (%.1f%% of replay time)",
+                  play->backp_cnt,
+                  (double)play->backp_ticks / tick_per_ns / 1e6,
+                  100. * (double)play->backp_ticks / tick_per_ns / 1e9 / fmax( play_s, 1e-9 ) ));
+
+  if( FD_UNLIKELY( !sink->frag_cnt ) ) return;
+
+  FD_LOG_NOTICE(( "  latency: mean %.0f ns", (double)fd_histf_sum( sink->lat ) / (double)sink->frag_cnt ));
+  for( ulong b=0UL; b<FD_HISTF_BUCKET_CNT; b++ ) {
+    ulong cnt = fd_histf_cnt( sink->lat, b );
+    if( !cnt ) continue;
+    if( b==FD_HISTF_BUCKET_CNT-1UL ) {
+      FD_LOG_NOTICE(( "    [%8lu,      inf) ns: %10lu (%5.1f%%)", fd_histf_left( sink->lat, b ), cnt, 100.*(double)cnt/(double)sink->frag_cnt ));
+    } else {
+      FD_LOG_NOTICE(( "    [%8lu, %8lu) ns: %10lu (%5.1f%%)", fd_histf_left( sink->lat, b ), fd_histf_right( sink->lat, b ), cnt, 100.*(double)cnt/(double)sink->frag_cnt ));
+    }
+  }
+}
+
+extern int * fd_log_private_shared_lock;
+
+void
+tilebench_cmd_fn( args_t *         args,
+                  config_t * const config ) {
+  fd_topo_t * topo = &config->topo;
+
+  ulong target_tile_id = fd_topo_find_tile( topo, args->tilebench.tile_name, args->tilebench.kind_id );
+  if( FD_UNLIKELY( target_tile_id==ULONG_MAX ) ) FD_LOG_ERR(( "tile `%s:%lu` not found", args->tilebench.tile_name, args->tilebench.kind_id ));
+  if( FD_UNLIKELY( topo->tiles[ target_tile_id ].is_agave ) ) FD_LOG_ERR(( "tile `%s:%lu` runs in the Agave process and can't be benchmarked in isolation", args->tilebench.tile_name, args->tilebench.kind_id ));
+
+  /* Check the recording before setting anything up */
+
+  int fd = open( args->tilebench.in_path, O_RDONLY );
+  if( FD_UNLIKELY( -1==fd ) ) FD_LOG_ERR(( "open(%s) failed (%i-%s)", args->tilebench.in_path, errno, fd_io_strerror( errno ) ));
+  struct stat st;
+  if( FD_UNLIKELY( -1==fstat( fd, &st ) ) ) FD_LOG_ERR(( "fstat(%s) failed (%i-%s)", args->tilebench.in_path, errno, fd_io_strerror( errno ) ));
+  fd_linkrec_hdr_t hdr[1];
+  ulong rsz;
+  int err = fd_io_read( fd, hdr, 0UL, sizeof(fd_linkrec_hdr_t), &rsz );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "read(%s) failed (%i-%s)", args->tilebench.in_path, err, fd_io_strerror( err ) ));
+  if( FD_UNLIKELY( !fd_linkrec_hdr_check( hdr, rsz ) ) ) FD_LOG_ERR(( "%s is not a linkrec recording", args->tilebench.in_path ));
+  if( FD_UNLIKELY( -1==close( fd ) ) ) FD_LOG_ERR(( "close failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  add_tilebench_topo( topo, target_tile_id, args->tilebench.in_path, (ulong)st.st_size, args->tilebench.max_rate, args->tilebench.loop_cnt );
+
+  args_t configure_args = {
+    .configure.command = CONFIGURE_CMD_INIT,
+  };
+  for( ulong i=0; i<CONFIGURE_STAGE_COUNT; i++ )
+    configure_args.configure.stages[ i ] = STAGES[ i ];
+  configure_cmd_fn( &configure_args, config );
+
+  update_config_for_dev( config );
+
+  run_firedancer_init( config, 1 );
+
+  fd_log_private_shared_lock[ 1 ] = 0;
+  fd_topo_join_workspaces( topo, FD_SHMEM_JOIN_MODE_READ_WRITE );
+  fd_topo_fill( topo );
+
+  ulong tbplay_tile_id = fd_topo_find_tile( topo, "tbplay", 0UL );
+  ulong tbsink_tile_id = fd_topo_find_tile( topo, "tbsink", 0UL );
+  FD_TEST( tbplay_tile_id!=ULONG_MAX && tbsink_tile_id!=ULONG_MAX );
+
+  /* The tile under test and tbsink are started first, so tbplay can't
+     publish into links nobody is consuming yet. */
+
+  ulong tile_ids[ 3 ] = { target_tile_id, tbsink_tile_id, tbplay_tile_id };
+  fd_topo_run_single_process_tiles( topo, 3UL, tile_ids, config->uid, config->gid, fdctl_tile_run, NULL );
+
+  fd_tbplay_stats_t const * play = fd_topo_obj_laddr( topo, topo->tiles[ tbplay_tile_id ].tile_obj_id );
+  fd_tbsink_stats_t const * sink = fd_topo_obj_laddr( topo, topo->tiles[ tbsink_tile_id ].tile_obj_id );
+
+  /* Wait for the replay to finish and then for the tile under test to
+     go quiet for a while (no new out frags for 1 second) */
+
+  long deadline  = fd_log_wallclock() + (long)args->tilebench.timeout*1000L*1000L*1000L;
+  ulong last_cnt = ULONG_MAX;
+  for(;;) {
+    fd_log_sleep( 1000L*1000L*1000L );
+
+    ulong pub_cnt  = FD_VOLATILE_CONST( play->pub_cnt  );
+    ulong frag_cnt = FD_VOLATILE_CONST( sink->frag_cnt );
+    int   done     = !!FD_VOLATILE_CONST( play->done );
+    FD_LOG_NOTICE(( "replayed %lu frags, received %lu frags", pub_cnt, frag_cnt ));
+
+    if( FD_UNLIKELY( done && frag_cnt==last_cnt ) ) break;
+    if( FD_UNLIKELY( fd_log_wallclock()>=deadline ) ) {
+      FD_LOG_WARNING(( "timed out after %lu s, reporting partial results", args->tilebench.timeout ));
+      break;
+    }
+    last_cnt = frag_cnt;
+  }
+
+  FD_COMPILER_MFENCE();
+  tilebench_report( &topo->tiles[ target_tile_id ], play, sink, fd_tempo_tick_per_ns( NULL ) );
+
+  /* The tiles run forever, exit the whole process */
+  fd_log_flush();
+  exit( 0 );
+}
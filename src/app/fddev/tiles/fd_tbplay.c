@@ -0,0 +1,252 @@
+#include "fd_tilebench.h"
+#include "../fd_linkrec.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* The tbplay tile replays an fd_linkrec recording into the in links of
+   the tile under test (tile->tbplay.target_tile_id).  The tile under
+   test's real producers are not running, so tbplay publishes into
+   those links directly, honoring the flow control credits returned by
+   the tile under test through its in link fseqs.
+
+   Frags are published either at the pace they were recorded at or as
+   fast as the tile under test accepts them (tile->tbplay.max_rate), and
+   each frag is stamped with the tickcount at publication in tsorig and
+   tspub, so tbsink can measure the latency through the tile. */
+
+#define TBPLAY_BURST_MAX (64UL)
+
+typedef struct {
+  fd_frag_meta_t * mcache;
+  ulong *          sync;
+  ulong            depth;
+  ulong const *    fseq;
+  fd_wksp_t *      mem;
+  ulong            mtu;
+  ulong            chunk0;
+  ulong            wmark;
+  ulong            chunk;
+  ulong            seq;
+} fd_tbplay_out_t;
+
+typedef struct {
+  fd_tbplay_stats_t stats[1]; /* Must be first, see fd_tilebench.h */
+
+  uchar const * rec;
+  ulong         rec_sz;
+  ulong         off;
+  ulong         loop_rem;
+  int           max_rate;
+
+  long          rec_ts0;     /* ts of the first recorded frag */
+  long          play_ts0;    /* fd_log_wallclock() at the start of the current loop */
+  long          backp_start; /* tickcount when the next frag was first held back, 0 if not held back */
+
+  ulong           out_idx[ FD_LINKREC_LINK_MAX ]; /* recorded link -> out, ULONG_MAX if not consumed by the tile under test */
+  fd_tbplay_out_t out    [ FD_LINKREC_LINK_MAX ];
+} fd_tbplay_ctx_t;
+
+FD_FN_CONST static inline ulong
+scratch_align( void ) {
+  return alignof( fd_tbplay_ctx_t );
+}
+
+FD_FN_PURE static inline ulong
+scratch_footprint( fd_topo_tile_t const * tile ) {
+  (void)tile;
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof( fd_tbplay_ctx_t ), sizeof( fd_tbplay_ctx_t ) );
+  return FD_LAYOUT_FINI( l, scratch_align() );
+}
+
+FD_FN_PURE static inline ulong
+loose_footprint( fd_topo_tile_t const * tile ) {
+  /* The whole recording is loaded into the workspace up front */
+  return fd_ulong_align_up( tile->tbplay.rec_sz, FD_SHMEM_NORMAL_PAGE_SZ ) + FD_SHMEM_NORMAL_PAGE_SZ;
+}
+
+static inline void
+after_credit( fd_tbplay_ctx_t *   ctx,
+              fd_stem_context_t * stem,
+              int *               opt_poll_in,
+              int *               charge_busy ) {
+  (void)stem;
+  (void)opt_poll_in;
+
+  if( FD_UNLIKELY( ctx->stats->done ) ) return;
+
+  for( ulong i=0UL; i<TBPLAY_BURST_MAX; i++ ) {
+    ulong off = ctx->off;
+    fd_linkrec_frag_t const * frag = fd_linkrec_frag_next( ctx->rec, ctx->rec_sz, &off );
+    if( FD_UNLIKELY( !frag ) ) {
+      if( FD_UNLIKELY( off<ctx->rec_sz ) ) FD_LOG_WARNING(( "corrupt frag record at offset %lu, ignoring rest of recording", off ));
+      if( FD_LIKELY( --ctx->loop_rem ) ) {
+        ctx->off      = sizeof(fd_linkrec_hdr_t);
+        ctx->play_ts0 = fd_log_wallclock();
+        continue;
+      }
+      ctx->stats->ts_end = fd_log_wallclock();
+      FD_COMPILER_MFENCE();
+      ctx->stats->done   = 1UL;
+      FD_LOG_NOTICE(( "replay done, published %lu frags", ctx->stats->pub_cnt ));
+      return;
+    }
+
+    ulong out_idx = ctx->out_idx[ frag->link_idx ];
+    if( FD_UNLIKELY( out_idx==ULONG_MAX ) ) {
+      ctx->stats->skip_cnt++;
+      ctx->off = off;
+      continue;
+    }
+    fd_tbplay_out_t * out = &ctx->out[ out_idx ];
+
+    if( FD_UNLIKELY( frag->sz>out->mtu ) ) {
+      ctx->stats->skip_cnt++;
+      ctx->off = off;
+      continue;
+    }
+
+    if( FD_LIKELY( !ctx->max_rate ) ) {
+      if( FD_UNLIKELY( !ctx->play_ts0 ) ) ctx->play_ts0 = fd_log_wallclock();
+      if( fd_log_wallclock()<ctx->play_ts0+(frag->ts-ctx->rec_ts0) ) return;
+    }
+
+    if( FD_UNLIKELY( fd_seq_diff( out->seq, fd_fseq_query( out->fseq ) )>=(long)out->depth ) ) {
+      if( FD_UNLIKELY( !ctx->backp_start ) ) {
+        ctx->backp_start = fd_tickcount();
+        ctx->stats->backp_cnt++;
+      }
+      return;
+    }
+
+    long now = fd_tickcount();
+    if( FD_UNLIKELY( ctx->backp_start ) ) {
+      ctx->stats->backp_ticks += (ulong)(now - ctx->backp_start);
+      ctx->backp_start = 0L;
+    }
+    if( FD_UNLIKELY( !ctx->stats->ts_start ) ) ctx->stats->ts_start = fd_log_wallclock();
+
+    ulong chunk = frag->chunk;
+    if( FD_LIKELY( out->mtu ) ) {
+      chunk = out->chunk;
+      fd_memcpy( fd_chunk_to_laddr( out->mem, chunk ), fd_linkrec_frag_payload( frag ), frag->sz );
+      out->chunk = fd_dcache_compact_next( chunk, frag->sz, out->chunk0, out->wmark );
+    }
+
+    ulong ts = fd_frag_meta_ts_comp( now );
+    fd_mcache_publish( out->mcache, out->depth, out->seq, frag->sig, chunk, frag->meta_sz, frag->ctl, ts, ts );
+    out->seq = fd_seq_inc( out->seq, 1UL );
+    fd_mcache_seq_update( out->sync, out->seq );
+
+    ctx->stats->pub_cnt++;
+    ctx->stats->pub_sz += frag->sz;
+    ctx->off            = off;
+    *charge_busy        = 1;
+  }
+}
+
+static void
+privileged_init( fd_topo_t *      topo,
+                 fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_tbplay_ctx_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof( fd_tbplay_ctx_t ), sizeof( fd_tbplay_ctx_t ) );
+
+  fd_wksp_t * wksp = topo->workspaces[ topo->objs[ tile->tile_obj_id ].wksp_id ].wksp;
+  uchar * rec = fd_wksp_alloc_laddr( wksp, 8UL, fd_ulong_max( tile->tbplay.rec_sz, 1UL ), 1UL );
+  if( FD_UNLIKELY( !rec ) ) FD_LOG_ERR(( "fd_wksp_alloc_laddr failed for %lu byte recording", tile->tbplay.rec_sz ));
+
+  int fd = open( tile->tbplay.rec_path, O_RDONLY );
+  if( FD_UNLIKELY( -1==fd ) ) FD_LOG_ERR(( "open(%s) failed (%i-%s)", tile->tbplay.rec_path, errno, fd_io_strerror( errno ) ));
+  ulong rsz;
+  int err = fd_io_read( fd, rec, tile->tbplay.rec_sz, tile->tbplay.rec_sz, &rsz );
+  if( FD_UNLIKELY( err ) ) FD_LOG_ERR(( "read(%s) failed (%i-%s)", tile->tbplay.rec_path, err, fd_io_strerror( err ) ));
+  if( FD_UNLIKELY( -1==close( fd ) ) ) FD_LOG_ERR(( "close failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+
+  ctx->rec    = rec;
+  ctx->rec_sz = tile->tbplay.rec_sz;
+}
+
+static void
+unprivileged_init( fd_topo_t *      topo,
+                   fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_tbplay_ctx_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof( fd_tbplay_ctx_t ), sizeof( fd_tbplay_ctx_t ) );
+
+  fd_linkrec_hdr_t const * hdr = fd_linkrec_hdr_check( ctx->rec, ctx->rec_sz );
+  if( FD_UNLIKELY( !hdr ) ) FD_LOG_ERR(( "%s is not a linkrec recording", tile->tbplay.rec_path ));
+
+  fd_memset( ctx->stats, 0, sizeof(fd_tbplay_stats_t) );
+  ctx->off         = sizeof(fd_linkrec_hdr_t);
+  ctx->loop_rem    = fd_ulong_max( tile->tbplay.loop_cnt, 1UL );
+  ctx->max_rate    = tile->tbplay.max_rate;
+  ctx->play_ts0    = 0L;
+  ctx->backp_start = 0L;
+
+  ulong off = ctx->off;
+  fd_linkrec_frag_t const * frag0 = fd_linkrec_frag_next( ctx->rec, ctx->rec_sz, &off );
+  ctx->rec_ts0 = frag0 ? frag0->ts : hdr->ts0;
+
+  fd_topo_tile_t const * target = &topo->tiles[ tile->tbplay.target_tile_id ];
+
+  ulong out_cnt = 0UL;
+  for( ulong i=0UL; i<hdr->link_cnt; i++ ) {
+    fd_linkrec_link_t const * rec_link = &hdr->link[ i ];
+    ulong in_idx = fd_topo_find_tile_in_link( topo, target, rec_link->name, rec_link->kind_id );
+    if( FD_UNLIKELY( in_idx==ULONG_MAX ) ) {
+      FD_LOG_WARNING(( "recorded link %s:%lu is not an in link of %s:%lu, skipping its frags", rec_link->name, rec_link->kind_id, target->name, target->kind_id ));
+      ctx->out_idx[ i ] = ULONG_MAX;
+      continue;
+    }
+
+    fd_topo_link_t const * link = &topo->links[ target->in_link_id[ in_idx ] ];
+    fd_tbplay_out_t *      out  = &ctx->out[ out_cnt ];
+
+    out->mcache = link->mcache;
+    out->sync   = fd_mcache_seq_laddr( link->mcache );
+    out->depth  = fd_mcache_depth( link->mcache );
+    out->fseq   = fd_fseq_join( fd_topo_obj_laddr( topo, target->in_link_fseq_obj_id[ in_idx ] ) );
+    out->seq    = fd_mcache_seq_query( out->sync );
+    out->mtu    = link->mtu;
+    if( FD_LIKELY( link->mtu ) ) {
+      out->mem    = topo->workspaces[ topo->objs[ link->dcache_obj_id ].wksp_id ].wksp;
+      out->chunk0 = fd_dcache_compact_chunk0( out->mem, link->dcache );
+      out->wmark  = fd_dcache_compact_wmark ( out->mem, link->dcache, link->mtu );
+      out->chunk  = out->chunk0;
+    }
+    if( FD_UNLIKELY( !target->in_link_reliable[ in_idx ] ) ) {
+      FD_LOG_WARNING(( "%s:%lu consumes %s:%lu unreliably, frags may be overrun", target->name, target->kind_id, link->name, link->kind_id ));
+    }
+
+    ctx->out_idx[ i ] = out_cnt++;
+  }
+  if( FD_UNLIKELY( !out_cnt ) ) FD_LOG_ERR(( "none of the recorded links are in links of %s:%lu", target->name, target->kind_id ));
+
+  ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
+  if( FD_UNLIKELY( scratch_top > (ulong)scratch + scratch_footprint( tile ) ) )
+    FD_LOG_ERR(( "scratch overflow %lu %lu %lu", scratch_top - (ulong)scratch - scratch_footprint( tile ), scratch_top, (ulong)scratch + scratch_footprint( tile ) ));
+}
+
+#define STEM_BURST (1UL)
+
+#define STEM_CALLBACK_CONTEXT_TYPE  fd_tbplay_ctx_t
+#define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_tbplay_ctx_t)
+
+#define STEM_CALLBACK_AFTER_CREDIT after_credit
+
+#include "../../../disco/stem/fd_stem.c"
+
+fd_topo_run_tile_t fd_tile_tbplay = {
+  .name              = "tbplay",
+  .scratch_align     = scratch_align,
+  .scratch_footprint = scratch_footprint,
+  .loose_footprint   = loose_footprint,
+  .privileged_init   = privileged_init,
+  .unprivileged_init = unprivileged_init,
+  .run               = stem_run,
+};
@@ -0,0 +1,116 @@
+#include "fd_tilebench.h"
+
+/* The tbsink tile drains the out links of the tile under test
+   (tile->tbsink.target_tile_id).  It consumes them as an unreliable
+   consumer and measures, for each frag, the time since tbplay published
+   the frag that caused it (assuming the tile under test forwards
+   tsorig, as the stem based tiles do).
+
+   The real consumers of those links are not running, so their fseqs
+   would never advance and the tile under test would stall once it ran
+   out of credits.  tbsink advances the fseqs of all the reliable
+   consumers of each link as it consumes frags, standing in for them. */
+
+#define TBSINK_SHADOW_MAX (32UL)
+
+typedef struct {
+  ulong   cnt;
+  ulong * fseq[ TBSINK_SHADOW_MAX ];
+} fd_tbsink_shadow_t;
+
+typedef struct {
+  fd_tbsink_stats_t stats[1]; /* Must be first, see fd_tilebench.h */
+
+  double             ns_per_tick;
+  fd_tbsink_shadow_t shadow[ FD_TOPO_MAX_TILE_OUT_LINKS ];
+} fd_tbsink_ctx_t;
+
+FD_FN_CONST static inline ulong
+scratch_align( void ) {
+  return alignof( fd_tbsink_ctx_t );
+}
+
+FD_FN_PURE static inline ulong
+scratch_footprint( fd_topo_tile_t const * tile ) {
+  (void)tile;
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, alignof( fd_tbsink_ctx_t ), sizeof( fd_tbsink_ctx_t ) );
+  return FD_LAYOUT_FINI( l, scratch_align() );
+}
+
+static inline void
+after_frag( fd_tbsink_ctx_t *   ctx,
+            ulong               in_idx,
+            ulong               seq,
+            ulong               sig,
+            ulong               sz,
+            ulong               tsorig,
+            fd_stem_context_t * stem ) {
+  (void)sig;
+  (void)stem;
+
+  long now = fd_tickcount();
+  long lat = now - fd_frag_meta_ts_decomp( tsorig, now );
+  fd_histf_sample( ctx->stats->lat, (ulong)( (double)fd_long_max( lat, 0L ) * ctx->ns_per_tick ) );
+
+  long wallclock = fd_log_wallclock();
+  if( FD_UNLIKELY( !ctx->stats->frag_cnt ) ) ctx->stats->ts_first = wallclock;
+  ctx->stats->ts_last = wallclock;
+  ctx->stats->frag_cnt++;
+  ctx->stats->frag_sz += sz;
+
+  fd_tbsink_shadow_t * shadow = &ctx->shadow[ in_idx ];
+  for( ulong i=0UL; i<shadow->cnt; i++ ) fd_fseq_update( shadow->fseq[ i ], fd_seq_inc( seq, 1UL ) );
+}
+
+static void
+unprivileged_init( fd_topo_t *      topo,
+                   fd_topo_tile_t * tile ) {
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_tbsink_ctx_t * ctx = FD_SCRATCH_ALLOC_APPEND( l, alignof( fd_tbsink_ctx_t ), sizeof( fd_tbsink_ctx_t ) );
+
+  fd_memset( ctx->stats, 0, sizeof(fd_tbsink_stats_t) );
+  FD_TEST( fd_histf_join( fd_histf_new( ctx->stats->lat, FD_TBSINK_LAT_MIN, FD_TBSINK_LAT_MAX ) ) );
+  ctx->ns_per_tick = 1. / fd_tempo_tick_per_ns( NULL );
+
+  if( FD_UNLIKELY( tile->in_cnt>FD_TOPO_MAX_TILE_OUT_LINKS ) ) FD_LOG_ERR(( "too many in links" ));
+
+  for( ulong i=0UL; i<tile->in_cnt; i++ ) {
+    ulong                link_id = tile->in_link_id[ i ];
+    fd_tbsink_shadow_t * shadow  = &ctx->shadow[ i ];
+    shadow->cnt = 0UL;
+
+    for( ulong j=0UL; j<topo->tile_cnt; j++ ) {
+      fd_topo_tile_t const * consumer = &topo->tiles[ j ];
+      if( FD_UNLIKELY( consumer->id==tile->id ) ) continue;
+      for( ulong k=0UL; k<consumer->in_cnt; k++ ) {
+        if( FD_LIKELY( consumer->in_link_id[ k ]!=link_id || !consumer->in_link_reliable[ k ] ) ) continue;
+        if( FD_UNLIKELY( shadow->cnt==TBSINK_SHADOW_MAX ) ) FD_LOG_ERR(( "too many consumers of link %s:%lu", topo->links[ link_id ].name, topo->links[ link_id ].kind_id ));
+        shadow->fseq[ shadow->cnt++ ] = fd_fseq_join( fd_topo_obj_laddr( topo, consumer->in_link_fseq_obj_id[ k ] ) );
+      }
+    }
+  }
+
+  ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
+  if( FD_UNLIKELY( scratch_top > (ulong)scratch + scratch_footprint( tile ) ) )
+    FD_LOG_ERR(( "scratch overflow %lu %lu %lu", scratch_top - (ulong)scratch - scratch_footprint( tile ), scratch_top, (ulong)scratch + scratch_footprint( tile ) ));
+}
+
+#define STEM_BURST (1UL)
+
+#define STEM_CALLBACK_CONTEXT_TYPE  fd_tbsink_ctx_t
+#define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_tbsink_ctx_t)
+
+#define STEM_CALLBACK_AFTER_FRAG after_frag
+
+#include "../../../disco/stem/fd_stem.c"
+
+fd_topo_run_tile_t fd_tile_tbsink = {
+  .name              = "tbsink",
+  .scratch_align     = scratch_align,
+  .scratch_footprint = scratch_footprint,
+  .unprivileged_init = unprivileged_init,
+  .run               = stem_run,
+};
@@ -0,0 +1,43 @@
+#ifndef HEADER_fd_src_app_fddev_tiles_fd_tilebench_h
+#define HEADER_fd_src_app_fddev_tiles_fd_tilebench_h
+
+/* The tbplay and tbsink tiles are the synthetic producer and consumer
+   `fddev tilebench` wires around a tile under test.  tbplay replays an
+   fd_linkrec recording into the in links of the tile and tbsink drains
+   its out links, standing in for all of their consumers.
+
+   Both tiles keep their results at the start of their scratch region
+   (the tile object) so the tilebench command, which runs in the same
+   address space, can read them while the tiles run.  The counters are
+   only written by the owning tile. */
+
+#include "../../../disco/topo/fd_topo.h"
+#include "../../../util/hist/fd_histf.h"
+
+struct fd_tbplay_stats {
+  ulong done;        /* 1 once the recording was replayed loop_cnt times */
+  long  ts_start;    /* fd_log_wallclock() of the first publish */
+  long  ts_end;      /* fd_log_wallclock() once done */
+  ulong pub_cnt;     /* frags published into the tile's in links */
+  ulong pub_sz;      /* payload bytes published */
+  ulong skip_cnt;    /* recorded frags for links the tile doesn't consume */
+  ulong backp_cnt;   /* times a frag was held back for lack of credits */
+  ulong backp_ticks; /* ticks spent holding back frags */
+};
+typedef struct fd_tbplay_stats fd_tbplay_stats_t;
+
+struct fd_tbsink_stats {
+  fd_histf_t lat[1];   /* ns from tbplay publish (tsorig) to tbsink receive */
+  ulong      frag_cnt; /* frags received from the tile's out links */
+  ulong      frag_sz;  /* bytes received */
+  long       ts_first; /* fd_log_wallclock() of the first frag */
+  long       ts_last;  /* fd_log_wallclock() of the last frag */
+};
+typedef struct fd_tbsink_stats fd_tbsink_stats_t;
+
+/* Latency histogram range in ns */
+
+#define FD_TBSINK_LAT_MIN (100UL)
+#define FD_TBSINK_LAT_MAX (10000000UL)
+
+#endif /* HEADER_fd_src_app_fddev_tiles_fd_tilebench_h */
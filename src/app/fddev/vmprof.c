@@ -0,0 +1,257 @@
+#include "fddev.h"
+
+#include "../../ballet/base58/fd_base58.h"
+#include "../../ballet/elf/fd_elf.h"
+#include "../../ballet/sbpf/fd_sbpf_loader.h"
+#include "../../disco/topo/fd_pod_format.h"
+#include "../../flamenco/vm/fd_vm_base.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+/* `fddev vmprof` reads the on-chain program profiler of a running
+   validator and writes the sampled program counters as folded stacks
+   (one "program;function count" line per hot pc), ready to be rendered
+   with flamegraph.pl or any compatible tool.
+
+   Samples are attributed to functions using the program's ELF, found
+   at <elf-dir>/<program id>.so.  Function starts are the entrypoint
+   and the call destinations discovered by fd_sbpf_loader, named from
+   the ELF symbol table when it is not stripped.  Without an ELF,
+   samples are reported by raw pc. */
+
+#define VMPROF_NAME_MAX (128UL)
+
+typedef struct {
+  ulong pc;
+  char  name[ VMPROF_NAME_MAX ];
+} vmprof_func_t;
+
+void
+vmprof_cmd_args( int *    pargc,
+                 char *** pargv,
+                 args_t * args ) {
+  char const * elf_dir  = fd_env_strip_cmdline_cstr( pargc, pargv, "--elf-dir",  NULL, ""              );
+  char const * out_file = fd_env_strip_cmdline_cstr( pargc, pargv, "--out-file", NULL, "vmprof.folded" );
+
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->vmprof.elf_dir  ), elf_dir,  sizeof(args->vmprof.elf_dir )-1UL ) );
+  fd_cstr_fini( fd_cstr_append_cstr_safe( fd_cstr_init( args->vmprof.out_path ), out_file, sizeof(args->vmprof.out_path)-1UL ) );
+}
+
+static int
+vmprof_func_cmp( void const * a,
+                 void const * b ) {
+  ulong pa = ((vmprof_func_t const *)a)->pc;
+  ulong pb = ((vmprof_func_t const *)b)->pc;
+  return (pa>pb) - (pa<pb);
+}
+
+/* vmprof_func_name sets the name of the function starting at pc,
+   adding it to func if it is not there yet.  Characters that are
+   separators in the folded stack format are replaced. */
+
+static void
+vmprof_func_name( vmprof_func_t * func,
+                  ulong *         func_cnt,
+                  ulong           func_max,
+                  ulong           pc,
+                  char const *    name,
+                  ulong           name_max ) {
+  ulong i;
+  for( i=0UL; i<*func_cnt; i++ ) if( func[ i ].pc==pc ) break;
+  if( i==*func_cnt ) {
+    if( FD_UNLIKELY( i==func_max ) ) return;
+    func[ i ].pc = pc;
+    (*func_cnt)++;
+  }
+
+  ulong j;
+  for( j=0UL; j<fd_ulong_min( name_max, VMPROF_NAME_MAX-1UL ) && name[ j ]; j++ ) {
+    char c = name[ j ];
+    func[ i ].name[ j ] = (c==';' || c==' ' || c=='\n') ? '_' : c;
+  }
+  func[ i ].name[ j ] = '\0';
+}
+
+/* vmprof_funcs_load loads the ELF at path and returns a malloc'd table
+   of its functions sorted by starting pc, with the count in *func_cnt.
+   Returns NULL if there is no such file or it could not be loaded. */
+
+static vmprof_func_t *
+vmprof_funcs_load( char const * path,
+                   ulong *      func_cnt ) {
+  *func_cnt = 0UL;
+
+  FILE * bin_file = fopen( path, "r" );
+  if( FD_UNLIKELY( !bin_file ) ) {
+    if( FD_UNLIKELY( errno!=ENOENT ) ) FD_LOG_WARNING(( "fopen(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  struct stat bin_stat;
+  if( FD_UNLIKELY( 0!=fstat( fileno( bin_file ), &bin_stat ) ) )
+    FD_LOG_ERR(( "fstat(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+
+  ulong  bin_sz  = (ulong)bin_stat.st_size;
+  uchar * bin_buf = malloc( bin_sz+8UL );
+  if( FD_UNLIKELY( !bin_buf ) ) FD_LOG_ERR(( "malloc(%#lx) failed (%i-%s)", bin_sz, errno, fd_io_strerror( errno ) ));
+  if( FD_UNLIKELY( bin_sz && fread( bin_buf, bin_sz, 1UL, bin_file )!=1UL ) )
+    FD_LOG_ERR(( "fread(%s) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+  FD_TEST( 0==fclose( bin_file ) );
+
+  fd_sbpf_elf_info_t elf_info;
+  if( FD_UNLIKELY( !fd_sbpf_elf_peek( &elf_info, bin_buf, bin_sz, /* deploy checks */ 0, FD_SBPF_V0, FD_SBPF_V3 ) ) ) {
+    FD_LOG_WARNING(( "%s is not a valid sBPF program", path ));
+    free( bin_buf );
+    return NULL;
+  }
+
+  void * rodata = malloc( elf_info.rodata_footprint );
+  FD_TEST( rodata );
+  fd_sbpf_program_t * prog = fd_sbpf_program_new( aligned_alloc( fd_sbpf_program_align(), fd_sbpf_program_footprint( &elf_info ) ), &elf_info, rodata );
+  FD_TEST( prog );
+
+  /* Only the call destinations are needed here, so syscalls are left
+     unregistered (the loader only requires them when deploying). */
+
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_new( aligned_alloc( fd_sbpf_syscalls_align(), fd_sbpf_syscalls_footprint() ) );
+  FD_TEST( syscalls );
+
+  vmprof_func_t * func = NULL;
+  if( FD_UNLIKELY( fd_sbpf_program_load( prog, bin_buf, bin_sz, syscalls, 0 ) ) ) {
+    FD_LOG_WARNING(( "fd_sbpf_program_load(%s) failed: %s", path, fd_sbpf_strerror() ));
+    goto done;
+  }
+
+  /* Every function starts at a distinct pc in the text, plus the
+     entrypoint which might be out of bounds. */
+
+  ulong func_max = prog->text_cnt+1UL;
+  func = malloc( func_max*sizeof(vmprof_func_t) );
+  FD_TEST( func );
+
+  vmprof_func_name( func, func_cnt, func_max, prog->entry_pc, "entrypoint", ULONG_MAX );
+
+  char name[ VMPROF_NAME_MAX ];
+  for( ulong pc=fd_sbpf_calldests_const_iter_init( prog->calldests );
+       !fd_sbpf_calldests_const_iter_done( pc );
+       pc=fd_sbpf_calldests_const_iter_next( prog->calldests, pc ) ) {
+    if( FD_UNLIKELY( pc>=prog->text_cnt || pc==prog->entry_pc ) ) continue;
+    vmprof_func_name( func, func_cnt, func_max, pc, fd_cstr_printf( name, sizeof(name), NULL, "function_%lu", pc ), ULONG_MAX );
+  }
+
+  /* Symbol names, if the ELF has a symbol table.  The loader validated
+     the section headers when peeking. */
+
+  if( elf_info.shndx_symtab>=0 && elf_info.shndx_strtab>=0 && elf_info.shndx_text>=0 ) {
+    fd_elf64_ehdr const * ehdr   = (fd_elf64_ehdr const *)bin_buf;
+    fd_elf64_shdr const * shdr   = (fd_elf64_shdr const *)( bin_buf + ehdr->e_shoff );
+    fd_elf64_shdr const * text   = shdr + elf_info.shndx_text;
+    fd_elf64_shdr const * symtab = shdr + elf_info.shndx_symtab;
+    fd_elf64_shdr const * strtab = shdr + elf_info.shndx_strtab;
+
+    if( FD_LIKELY( symtab->sh_offset<=bin_sz && symtab->sh_size<=bin_sz-symtab->sh_offset &&
+                   strtab->sh_offset<=bin_sz && strtab->sh_size<=bin_sz-strtab->sh_offset ) ) {
+      fd_elf64_sym const * sym     = (fd_elf64_sym const *)( bin_buf + symtab->sh_offset );
+      ulong                sym_cnt = symtab->sh_size / sizeof(fd_elf64_sym);
+      char const *         str     = (char const *)( bin_buf + strtab->sh_offset );
+
+      for( ulong i=0UL; i<sym_cnt; i++ ) {
+        if( FD_ELF64_ST_TYPE( sym[ i ].st_info )!=FD_ELF_STT_FUNC ) continue;
+        if( sym[ i ].st_shndx!=(ushort)elf_info.shndx_text       ) continue;
+        if( sym[ i ].st_name>=strtab->sh_size                    ) continue;
+        if( sym[ i ].st_value<text->sh_addr                      ) continue;
+        ulong pc = ( sym[ i ].st_value - text->sh_addr ) / 8UL;
+        if( pc>=prog->text_cnt ) continue;
+        vmprof_func_name( func, func_cnt, func_max, pc, str + sym[ i ].st_name, strtab->sh_size - sym[ i ].st_name );
+      }
+    }
+  }
+
+  qsort( func, *func_cnt, sizeof(vmprof_func_t), vmprof_func_cmp );
+
+done:
+  free( fd_sbpf_syscalls_delete( syscalls ) );
+  free( fd_sbpf_program_delete( prog ) );
+  free( rodata );
+  free( bin_buf );
+  return func;
+}
+
+/* vmprof_func_find returns the function containing pc, i.e. the one
+   with the greatest start at or before pc, or NULL if none. */
+
+static vmprof_func_t const *
+vmprof_func_find( vmprof_func_t const * func,
+                  ulong                 func_cnt,
+                  ulong                 pc ) {
+  ulong lo = 0UL;
+  ulong hi = func_cnt;
+  while( lo<hi ) {
+    ulong mid = lo + (hi-lo)/2UL;
+    if( func[ mid ].pc<=pc ) lo = mid+1UL;
+    else                     hi = mid;
+  }
+  return lo ? func+lo-1UL : NULL;
+}
+
+void
+vmprof_cmd_fn( args_t *         args,
+               config_t * const config ) {
+  fd_topo_t * topo = &config->topo;
+
+  ulong vm_prof_obj_id = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "vm_prof" );
+  if( FD_UNLIKELY( vm_prof_obj_id==ULONG_MAX ) ) FD_LOG_ERR(( "the topology does not profile on-chain programs" ));
+
+  fd_topo_join_workspaces( topo, FD_SHMEM_JOIN_MODE_READ_ONLY );
+  fd_topo_fill( topo );
+
+  fd_vm_prof_t const * prof = fd_vm_prof_join( fd_topo_obj_laddr( topo, vm_prof_obj_id ) );
+  if( FD_UNLIKELY( !prof ) ) FD_LOG_ERR(( "fd_vm_prof_join failed" ));
+  fd_vm_prof_prog_t const * prog = fd_vm_prof_prog_const( prof );
+
+  FILE * out = fopen( args->vmprof.out_path, "w" );
+  if( FD_UNLIKELY( !out ) ) FD_LOG_ERR(( "fopen(%s) failed (%i-%s)", args->vmprof.out_path, errno, fd_io_strerror( errno ) ));
+
+  ulong prog_cnt   = 0UL;
+  ulong sample_cnt = 0UL;
+  ulong drop_cnt   = 0UL;
+  for( ulong i=0UL; i<prof->prog_max; i++ ) {
+    if( FD_VOLATILE_CONST( prog[ i ].state )!=FD_VM_PROF_PROG_STATE_VALID ) continue;
+    prog_cnt++;
+    sample_cnt += prog[ i ].sample_cnt;
+    drop_cnt   += prog[ i ].sample_drop_cnt;
+
+    char id[ FD_BASE58_ENCODED_32_SZ ];
+    fd_base58_encode_32( prog[ i ].id.uc, NULL, id );
+
+    ulong           func_cnt = 0UL;
+    vmprof_func_t * func     = NULL;
+    if( args->vmprof.elf_dir[ 0 ] ) {
+      char path[ PATH_MAX ];
+      FD_TEST( fd_cstr_printf_check( path, sizeof(path), NULL, "%s/%s.so", args->vmprof.elf_dir, id ) );
+      func = vmprof_funcs_load( path, &func_cnt );
+    }
+
+    for( ulong j=0UL; j<FD_VM_PROF_PC_MAX; j++ ) {
+      fd_vm_prof_pc_t const * ele = prog[ i ].pc + j;
+      ulong pc1 = FD_VOLATILE_CONST( ele->pc  );
+      ulong cnt = FD_VOLATILE_CONST( ele->cnt );
+      if( !pc1 || !cnt ) continue;
+
+      vmprof_func_t const * f = vmprof_func_find( func, func_cnt, pc1-1UL );
+      if( FD_LIKELY( f ) ) fprintf( out, "%s;%s %lu\n",    id, f->name, cnt );
+      else                 fprintf( out, "%s;pc_%lu %lu\n", id, pc1-1UL, cnt );
+    }
+
+    free( func );
+  }
+
+  if( FD_UNLIKELY( fclose( out ) ) ) FD_LOG_ERR(( "fclose(%s) failed (%i-%s)", args->vmprof.out_path, errno, fd_io_strerror( errno ) ));
+
+  FD_LOG_NOTICE(( "wrote %lu samples of %lu programs to %s (%lu samples and %lu invocations dropped, %lu programs evicted)",
+                  sample_cnt-drop_cnt, prog_cnt, args->vmprof.out_path, drop_cnt, prof->prog_drop_cnt, prof->prog_evict_cnt ));
+
+  fd_topo_leave_workspaces( topo );
+}
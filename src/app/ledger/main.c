@@ -74,6 +74,8 @@ struct fd_ledger_args {
   char const *          checkpt_path;            /* path to dump funk wksp checkpoints during execution*/
   ulong                 checkpt_freq;            /* how often funk wksp checkpoints will be dumped (defaults to never) */
   int                   checkpt_mismatch;        /* determine if a funk wksp checkpoint should be dumped on a mismatch*/
+  ulong                 prefetch_depth;          /* how many blocks are imported and verified ahead of execution (0 imports inline) */
+  ulong                 prefetch_tile_cnt;       /* how many tiles are reserved for importing and verifying blocks ahead */
 
   int                   dump_insn_to_pb;         /* instruction dumping: should insns be dumped */
   int                   dump_txn_to_pb;          /* txn dumping: should txns be dumped */
@@ -118,7 +120,8 @@ typedef struct fd_ledger_args fd_ledger_args_t;
 /* Runtime Replay *************************************************************/
 static int
 init_tpool( fd_ledger_args_t * ledger_args ) {
-  ulong tcnt = fd_tile_cnt();
+  /* The last prefetch_tile_cnt tiles are left to the block prefetcher */
+  ulong tcnt = fd_tile_cnt() - ( ledger_args->prefetch_depth ? ledger_args->prefetch_tile_cnt : 0UL );
   uchar * tpool_scr_mem = NULL;
   fd_tpool_t * tpool = NULL;
   if( tcnt>=1UL ) {
@@ -238,6 +241,271 @@ publish_account_state(fd_rmq_t* rmq, const fd_funk_rec_t* rec, ulong slot) {
   fd_rmq_publish(rmq, "firedancer", "account_states", message);
 }
 
+/* Block prefetch *************************************************************/
+
+/* With --prefetch-depth, runtime_replay does not import each block from
+   rocksdb right before executing it.  A prefetch tile walks the rooted
+   slots instead, imports up to prefetch_depth blocks ahead of execution
+   into the blockstore and verifies their PoH (using the other
+   prefetch_tile_cnt-1 reserved tiles as a thread pool), so execution
+   never waits on rocksdb I/O.  The PoH of a block only depends on the
+   last entry hash of its parent block, which is known once the parent
+   is imported, so verification does not depend on execution either.
+
+   Prefetched blocks are handed over in order through a single producer
+   single consumer ring of entries. */
+
+#define FD_LEDGER_PREFETCH_MAX        (1024UL)
+#define FD_LEDGER_PREFETCH_SCRATCH_SZ (256UL<<20)
+
+struct fd_ledger_prefetch_ent {
+  ulong     slot;
+  int       err;           /* non-zero if the block could not be imported */
+  int       poh_verified;  /* 1 if the PoH of the block is valid starting from in_poh */
+  fd_hash_t in_poh;
+};
+typedef struct fd_ledger_prefetch_ent fd_ledger_prefetch_ent_t;
+
+struct fd_ledger_prefetch {
+  fd_ledger_args_t * args;
+  ulong              start_slot;
+  fd_hash_t          start_poh;     /* PoH hash before the first block */
+  uchar *            scratch_smem;
+  fd_tpool_t *       tpool;         /* PoH verification thread pool, worker 0 is the prefetch tile */
+  uchar              tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned( FD_TPOOL_ALIGN )));
+  fd_tile_exec_t *   exec;
+
+  ulong              prod_cnt;      /* blocks prefetched, written by the prefetch tile */
+  ulong              cons_cnt;      /* blocks consumed, written by the replay tile */
+  int                done;          /* set by the prefetch tile once there are no more blocks */
+  int                halt;          /* set by the replay tile to stop the prefetch tile early */
+
+  long               import_ns;     /* stage timings, written by the prefetch tile */
+  long               verify_ns;
+  long               idle_ns;       /* time the prefetch tile waited for execution to consume blocks */
+
+  fd_ledger_prefetch_ent_t ent[ FD_LEDGER_PREFETCH_MAX ];
+};
+typedef struct fd_ledger_prefetch fd_ledger_prefetch_t;
+
+/* prefetch_next_meta reads the meta of the next rooted slot after slot
+   into *slot_meta, switching over to the next rocksdb when reaching its
+   start slot.  Returns 0 on success and -1 if there are no more rooted
+   slots. */
+
+static int
+prefetch_next_meta( fd_ledger_args_t *       ledger_args,
+                    fd_rocksdb_t *           rocks_db,
+                    fd_rocksdb_root_iter_t * iter,
+                    ulong *                  rocksdb_idx,
+                    ulong                    slot,
+                    fd_slot_meta_t *         slot_meta ) {
+  fd_valloc_t valloc = fd_scratch_virtual();
+
+  int ret = fd_rocksdb_root_iter_next( iter, slot_meta, valloc );
+  if( ret<0 ) ret = fd_rocksdb_get_meta( rocks_db, slot+1UL, slot_meta, valloc );
+
+  ulong idx = *rocksdb_idx;
+  if( ledger_args->rocksdb_list_cnt>1UL && idx+1UL<ledger_args->rocksdb_list_cnt &&
+      ( ret<0 || slot_meta->slot>=ledger_args->rocksdb_list_slot[ idx ] ) ) {
+    ulong next_start = ledger_args->rocksdb_list_slot[ idx ];
+    *rocksdb_idx = ++idx;
+    FD_LOG_WARNING(( "Switching to next rocksdb=%s", ledger_args->rocksdb_list[ idx ] ));
+    fd_rocksdb_root_iter_destroy( iter );
+    fd_rocksdb_destroy( rocks_db );
+    fd_memset( rocks_db, 0, sizeof(fd_rocksdb_t)           );
+    fd_memset( iter,     0, sizeof(fd_rocksdb_root_iter_t) );
+
+    char * err = fd_rocksdb_init( rocks_db, ledger_args->rocksdb_list[ idx ] );
+    if( FD_UNLIKELY( err!=NULL ) ) {
+      FD_LOG_ERR(( "fd_rocksdb_init at path=%s returned error=%s", ledger_args->rocksdb_list[ idx ], err ));
+    }
+    fd_rocksdb_root_iter_new( iter );
+    ret = fd_rocksdb_root_iter_seek( iter, rocks_db, next_start, slot_meta, valloc );
+    if( ret<0 ) {
+      FD_LOG_ERR(( "Failed to seek to slot %lu", next_start ));
+    }
+  }
+  return ret<0 ? -1 : 0;
+}
+
+static int
+prefetch_main( int     argc,
+               char ** argv ) {
+  (void)argc;
+  fd_ledger_prefetch_t * prefetch    = (fd_ledger_prefetch_t *)argv;
+  fd_ledger_args_t *     ledger_args = prefetch->args;
+  fd_blockstore_t *      blockstore  = ledger_args->slot_ctx->blockstore;
+
+  ulong fmem[ 64UL ];
+  fd_scratch_attach( prefetch->scratch_smem, fmem, FD_LEDGER_PREFETCH_SCRATCH_SZ, 64UL );
+
+  uchar trash_hash_buf[32];
+  memset( trash_hash_buf, 0xFE, sizeof(trash_hash_buf) );
+
+  fd_rocksdb_t           rocks_db    = {0};
+  fd_rocksdb_root_iter_t iter        = {0};
+  ulong                  rocksdb_idx = 0UL;
+  while( rocksdb_idx+1UL<ledger_args->rocksdb_list_cnt && prefetch->start_slot>=ledger_args->rocksdb_list_slot[ rocksdb_idx ] ) rocksdb_idx++;
+  char * err = fd_rocksdb_init( &rocks_db, ledger_args->rocksdb_list[ rocksdb_idx ] );
+  if( FD_UNLIKELY( err!=NULL ) ) {
+    FD_LOG_ERR(( "fd_rocksdb_init at path=%s returned error=%s", ledger_args->rocksdb_list[ rocksdb_idx ], err ));
+  }
+  fd_rocksdb_root_iter_new( &iter );
+
+  /* poh is the PoH hash the next block starts from, as long as every
+     block so far verified.  After the first failure the chain is
+     unknown, so later blocks are left for replay to verify. */
+  fd_hash_t poh       = prefetch->start_poh;
+  int       poh_chain = 1;
+
+  for( ulong i=0UL; !FD_VOLATILE_CONST( prefetch->halt ); i++ ) {
+    int done = 0;
+    FD_SCRATCH_SCOPE_BEGIN {
+      fd_slot_meta_t slot_meta = {0};
+      if( !i ) {
+        done = fd_rocksdb_root_iter_seek( &iter, &rocks_db, prefetch->start_slot, &slot_meta, fd_scratch_virtual() )!=0;
+      } else {
+        done = prefetch_next_meta( ledger_args, &rocks_db, &iter, &rocksdb_idx, prefetch->ent[ (i-1UL)%FD_LEDGER_PREFETCH_MAX ].slot, &slot_meta )!=0;
+      }
+      done |= slot_meta.slot>ledger_args->end_slot;
+      if( done ) break;
+
+      /* Wait for room in the ring (and the blockstore) */
+
+      long idle = -fd_log_wallclock();
+      while( FD_UNLIKELY( i-FD_VOLATILE_CONST( prefetch->cons_cnt )>=ledger_args->prefetch_depth && !FD_VOLATILE_CONST( prefetch->halt ) ) ) FD_SPIN_PAUSE();
+      idle += fd_log_wallclock();
+      prefetch->idle_ns += idle;
+
+      ulong                      slot = slot_meta.slot;
+      fd_ledger_prefetch_ent_t * ent  = prefetch->ent + (i%FD_LEDGER_PREFETCH_MAX);
+      ent->slot         = slot;
+      ent->poh_verified = 0;
+      ent->in_poh       = poh;
+
+      long import_time = -fd_log_wallclock();
+      ent->err = fd_rocksdb_import_block_blockstore( &rocks_db, &slot_meta, blockstore, ledger_args->copy_txn_status,
+                                                     slot==ledger_args->trash_hash ? trash_hash_buf : NULL );
+      import_time += fd_log_wallclock();
+      prefetch->import_ns += import_time;
+
+      if( FD_LIKELY( !ent->err && poh_chain ) ) {
+        long verify_time = -fd_log_wallclock();
+        FD_SCRATCH_SCOPE_BEGIN {
+          fd_hash_t out_poh;
+          ent->poh_verified = fd_runtime_block_verify_poh( blockstore, slot, &poh, &out_poh, fd_scratch_virtual(), prefetch->tpool )==FD_RUNTIME_EXECUTE_SUCCESS;
+          if( FD_LIKELY( ent->poh_verified ) ) poh       = out_poh;
+          else                                 poh_chain = 0;
+        } FD_SCRATCH_SCOPE_END;
+        verify_time += fd_log_wallclock();
+        prefetch->verify_ns += verify_time;
+      }
+
+      FD_COMPILER_MFENCE();
+      FD_VOLATILE( prefetch->prod_cnt ) = i+1UL;
+      FD_COMPILER_MFENCE();
+      /* Execution stops at the first block that fails to import */
+      done = !!ent->err;
+    } FD_SCRATCH_SCOPE_END;
+    if( done ) break;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( prefetch->done ) = 1;
+
+  fd_rocksdb_root_iter_destroy( &iter );
+  fd_rocksdb_destroy( &rocks_db );
+  fd_scratch_detach( NULL );
+  return 0;
+}
+
+/* prefetch_start starts prefetching blocks from start_slot, whose parent
+   block ends with PoH hash start_poh. */
+
+static fd_ledger_prefetch_t *
+prefetch_start( fd_ledger_args_t * ledger_args,
+                ulong              start_slot,
+                fd_hash_t const *  start_poh ) {
+  fd_valloc_t valloc = ledger_args->slot_ctx->valloc;
+  fd_ledger_prefetch_t * prefetch = fd_valloc_malloc( valloc, alignof(fd_ledger_prefetch_t), sizeof(fd_ledger_prefetch_t) );
+  uchar * smem = fd_valloc_malloc( valloc, FD_SCRATCH_SMEM_ALIGN, fd_scratch_smem_footprint( FD_LEDGER_PREFETCH_SCRATCH_SZ ) );
+  if( FD_UNLIKELY( !prefetch || !smem ) ) {
+    FD_LOG_ERR(( "failed to allocate block prefetcher" ));
+  }
+  fd_memset( prefetch, 0, sizeof(fd_ledger_prefetch_t) );
+  prefetch->args         = ledger_args;
+  prefetch->start_slot   = start_slot;
+  prefetch->start_poh    = *start_poh;
+  prefetch->scratch_smem = smem;
+
+  /* The prefetch tile is the first reserved tile, it verifies PoH with
+     the others */
+
+  ulong tile0 = fd_tile_cnt() - ledger_args->prefetch_tile_cnt;
+  prefetch->tpool = fd_tpool_init( prefetch->tpool_mem, ledger_args->prefetch_tile_cnt );
+  if( FD_UNLIKELY( !prefetch->tpool ) ) {
+    FD_LOG_ERR(( "failed to create prefetch thread pool" ));
+  }
+  for( ulong i=1UL; i<ledger_args->prefetch_tile_cnt; i++ ) {
+    if( FD_UNLIKELY( !fd_tpool_worker_push( prefetch->tpool, tile0+i, NULL, 0UL ) ) ) {
+      FD_LOG_ERR(( "failed to launch prefetch worker" ));
+    }
+  }
+
+  FD_COMPILER_MFENCE();
+  prefetch->exec = fd_tile_exec_new( tile0, prefetch_main, 0, (char **)prefetch );
+  if( FD_UNLIKELY( !prefetch->exec ) ) {
+    FD_LOG_ERR(( "failed to launch prefetch tile" ));
+  }
+  FD_LOG_NOTICE(( "prefetching up to %lu blocks ahead on tiles [%lu,%lu)", ledger_args->prefetch_depth, tile0, fd_tile_cnt() ));
+  return prefetch;
+}
+
+/* prefetch_peek waits for the next prefetched block and returns it, or
+   returns NULL if there are no more blocks.  The time spent waiting is
+   accumulated into *wait_ns. */
+
+static fd_ledger_prefetch_ent_t const *
+prefetch_peek( fd_ledger_prefetch_t * prefetch,
+               long *                 wait_ns ) {
+  ulong cons_cnt = prefetch->cons_cnt;
+  long  wait     = -fd_log_wallclock();
+  for(;;) {
+    if( FD_LIKELY( FD_VOLATILE_CONST( prefetch->prod_cnt )>cons_cnt ) ) break;
+    if( FD_VOLATILE_CONST( prefetch->done ) ) {
+      FD_COMPILER_MFENCE();
+      if( FD_VOLATILE_CONST( prefetch->prod_cnt )>cons_cnt ) break;
+      *wait_ns += wait + fd_log_wallclock();
+      return NULL;
+    }
+    FD_SPIN_PAUSE();
+  }
+  FD_COMPILER_MFENCE();
+  *wait_ns += wait + fd_log_wallclock();
+  return prefetch->ent + (cons_cnt%FD_LEDGER_PREFETCH_MAX);
+}
+
+static void
+prefetch_pop( fd_ledger_prefetch_t * prefetch ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( prefetch->cons_cnt ) = prefetch->cons_cnt+1UL;
+  FD_COMPILER_MFENCE();
+}
+
+static void
+prefetch_stop( fd_ledger_prefetch_t * prefetch ) {
+  if( !prefetch ) return;
+  FD_VOLATILE( prefetch->halt ) = 1;
+  int ret;
+  fd_tile_exec_delete( prefetch->exec, &ret );
+  fd_tpool_fini( prefetch->tpool );
+
+  fd_valloc_t valloc = prefetch->args->slot_ctx->valloc;
+  fd_valloc_free( valloc, prefetch->scratch_smem );
+  fd_valloc_free( valloc, prefetch );
+}
+
 int
 runtime_replay( fd_ledger_args_t * ledger_args ) {
   fd_features_restore( ledger_args->slot_ctx );
@@ -311,6 +579,15 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
   fd_wksp_usage_t init_usage = {0};
   fd_wksp_usage( fd_blockstore_wksp( ledger_args->blockstore ), NULL, 0UL, &init_usage );
 
+  fd_ledger_prefetch_t * prefetch = NULL;
+  if( ledger_args->prefetch_depth ) {
+    prefetch = prefetch_start( ledger_args, start_slot, &ledger_args->slot_ctx->slot_bank.poh );
+  }
+
+  /* Stage timings */
+  long import_ns = 0L; /* importing blocks inline, or waiting for the prefetcher */
+  long exec_ns   = 0L;
+
   ulong block_slot = start_slot;
   for( ulong slot = start_slot; slot <= ledger_args->end_slot; ++slot ) {
     ledger_args->slot_ctx->slot_bank.prev_slot = prev_slot;
@@ -324,14 +601,34 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
       fd_funk_end_write( ledger_args->capture_ctx->pruned_funk );
     }
 
-    /* If we have reached a new block, load one in from rocksdb to the blockstore */
-    if( fd_blockstore_block_query( blockstore, slot ) == NULL && slot_meta.slot == slot ) {
+    /* If we have reached a new block, load one in from rocksdb to the
+       blockstore (or take it from the prefetcher, which already did) */
+    int new_block    = 0;
+    int poh_verified = 0;
+    if( prefetch ) {
+      fd_ledger_prefetch_ent_t const * ent = prefetch_peek( prefetch, &import_ns );
+      if( FD_UNLIKELY( !ent ) ) break; /* No more blocks */
+      if( ent->slot == slot ) {
+        if( FD_UNLIKELY( ent->err ) ) {
+          FD_LOG_ERR(( "Failed to import block %lu", slot ));
+        }
+        poh_verified = ent->poh_verified && !memcmp( ent->in_poh.hash, ledger_args->slot_ctx->slot_bank.poh.hash, sizeof(fd_hash_t) );
+        prefetch_pop( prefetch );
+        new_block = 1;
+      }
+    } else if( fd_blockstore_block_query( blockstore, slot ) == NULL && slot_meta.slot == slot ) {
+      long import_time = -fd_log_wallclock();
       int err = fd_rocksdb_import_block_blockstore( &rocks_db, &slot_meta, blockstore,
                                                     ledger_args->copy_txn_status, slot == (ledger_args->trash_hash) ? trash_hash_buf : NULL );
       if( FD_UNLIKELY( err ) ) {
         FD_LOG_ERR(( "Failed to import block %lu", start_slot ));
       }
+      import_time += fd_log_wallclock();
+      import_ns   += import_time;
+      new_block    = 1;
+    }
 
+    if( new_block ) {
       fd_blockstore_start_write( blockstore );
 
       /* Remove the previous block from the blockstore */
@@ -362,21 +659,21 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
       continue;
     }
 
-    uchar * val = fd_blockstore_block_data_laddr( blockstore, blk );
-    ulong   sz  = blk->data_sz;
     fd_blockstore_end_read( blockstore );
 
+    long  exec_time   = -fd_log_wallclock();
     ulong blk_txn_cnt = 0;
     FD_TEST( fd_runtime_block_eval_tpool( ledger_args->slot_ctx,
                                           ledger_args->capture_ctx,
-                                          val,
-                                          sz,
                                           ledger_args->tpool,
                                           1,
+                                          poh_verified,
                                           &blk_txn_cnt,
                                           ledger_args->spads,
                                           ledger_args->spad_cnt ) == FD_RUNTIME_EXECUTE_SUCCESS );
-    txn_cnt += blk_txn_cnt;
+    exec_time += fd_log_wallclock();
+    exec_ns   += exec_time;
+    txn_cnt   += blk_txn_cnt;
     slot_cnt++;
 
     fd_blockstore_start_read( blockstore );
@@ -397,6 +694,7 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
       }
       if( ledger_args->abort_on_mismatch ) {
         fd_blockstore_end_read( blockstore );
+        prefetch_stop( prefetch );
         return 1;
       }
     }
@@ -423,6 +721,7 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
       }
       if( ledger_args->abort_on_mismatch ) {
         fd_blockstore_end_read( blockstore );
+        prefetch_stop( prefetch );
         return 1;
       }
     }
@@ -430,7 +729,7 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
 
     prev_slot = slot;
 
-    if( slot<ledger_args->end_slot ) {
+    if( !prefetch && slot<ledger_args->end_slot ) {
       /* TODO: This currently doesn't support switching over on slots that occur
          on a fork */
       /* If need to go to next rocksdb, switch over */
@@ -485,6 +784,16 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
   }
 
 
+  long prefetch_import_ns = 0L;
+  long prefetch_verify_ns = 0L;
+  long prefetch_idle_ns   = 0L;
+  if( prefetch ) {
+    prefetch_import_ns = prefetch->import_ns;
+    prefetch_verify_ns = prefetch->verify_ns;
+    prefetch_idle_ns   = prefetch->idle_ns;
+    prefetch_stop( prefetch );
+  }
+
   if( ledger_args->tpool ) {
     fd_tpool_fini( ledger_args->tpool );
   }
@@ -497,12 +806,24 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
   double tps           = (double)txn_cnt / replay_time_s;
   double sec_per_slot  = replay_time_s / (double)slot_cnt;
   FD_LOG_NOTICE((
-        "replay completed - slots: %lu, elapsed: %6.6f s, txns: %lu, tps: %6.6f, sec/slot: %6.6f",
+        "replay completed - slots: %lu, elapsed: %6.6f s, txns: %lu, tps: %6.6f, sec/slot: %6.6f, slots/s: %6.6f",
         slot_cnt,
         replay_time_s,
         txn_cnt,
         tps,
-        sec_per_slot ));
+        sec_per_slot,
+        (double)slot_cnt / replay_time_s ));
+  if( slot_cnt ) {
+    double ms_per_slot = 1e-6 / (double)slot_cnt;
+    if( prefetch_import_ns || prefetch_verify_ns ) {
+      FD_LOG_NOTICE(( "replay stages (ms/slot) - execute: %6.3f, wait for prefetch: %6.3f, prefetch import: %6.3f, prefetch poh verify: %6.3f, prefetch idle: %6.3f",
+                      (double)exec_ns * ms_per_slot, (double)import_ns * ms_per_slot,
+                      (double)prefetch_import_ns * ms_per_slot, (double)prefetch_verify_ns * ms_per_slot, (double)prefetch_idle_ns * ms_per_slot ));
+    } else {
+      FD_LOG_NOTICE(( "replay stages (ms/slot) - execute: %6.3f, import: %6.3f",
+                      (double)exec_ns * ms_per_slot, (double)import_ns * ms_per_slot ));
+    }
+  }
 
   if ( slot_cnt == 0 ) {
     FD_LOG_ERR(( "No slots replayed" ));
@@ -1504,6 +1825,8 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   char const * checkpt_path            = fd_env_strip_cmdline_cstr ( &argc, &argv, "--checkpt-path",            NULL, NULL      );
   ulong        checkpt_freq            = fd_env_strip_cmdline_ulong( &argc, &argv, "--checkpt-freq",            NULL, ULONG_MAX );
   int          checkpt_mismatch        = fd_env_strip_cmdline_int  ( &argc, &argv, "--checkpt-mismatch",        NULL, 0         );
+  ulong        prefetch_depth          = fd_env_strip_cmdline_ulong( &argc, &argv, "--prefetch-depth",          NULL, 0UL       );
+  ulong        prefetch_tile_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--prefetch-tile-cnt",       NULL, 1UL       );
   char const * allocator               = fd_env_strip_cmdline_cstr ( &argc, &argv, "--allocator",               NULL, "wksp"    );
   int          abort_on_mismatch       = fd_env_strip_cmdline_int  ( &argc, &argv, "--abort-on-mismatch",       NULL, 1         );
   int          dump_insn_to_pb         = fd_env_strip_cmdline_int  ( &argc, &argv, "--dump-insn-to-pb",         NULL, 0         );
@@ -1608,6 +1931,8 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   args->checkpt_path            = checkpt_path;
   args->checkpt_freq            = checkpt_freq;
   args->checkpt_mismatch        = checkpt_mismatch;
+  args->prefetch_depth          = prefetch_depth;
+  args->prefetch_tile_cnt       = prefetch_tile_cnt;
   args->allocator               = allocator;
   args->abort_on_mismatch       = abort_on_mismatch;
   args->dump_insn_to_pb         = dump_insn_to_pb;
@@ -1630,6 +1955,17 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   args->rmq_pass = fd_env_strip_cmdline_cstr(&argc, &argv, 
       "--rmq-pass", NULL, "guest");
   args->rmq = NULL;
+  if( prefetch_depth ) {
+    if( FD_UNLIKELY( prefetch_depth>FD_LEDGER_PREFETCH_MAX ) ) {
+      FD_LOG_ERR(( "--prefetch-depth must be at most %lu", FD_LEDGER_PREFETCH_MAX ));
+    }
+    if( FD_UNLIKELY( prefetch_depth+2UL>slot_history_max ) ) {
+      FD_LOG_ERR(( "--slot-history must be at least --prefetch-depth+2 to hold the prefetched blocks" ));
+    }
+    if( FD_UNLIKELY( !prefetch_tile_cnt || prefetch_tile_cnt>=fd_tile_cnt() ) ) {
+      FD_LOG_ERR(( "--prefetch-tile-cnt must be in [1,%lu) (increase --tile-cpus)", fd_tile_cnt() ));
+    }
+  }
   parse_one_off_features( args, one_off_features );
   parse_rocksdb_list( args, rocksdb_list, rocksdb_list_starts );
 
@@ -152,6 +152,8 @@ init_args_offline( int * argc, char *** argv, fd_rpcserver_args_t * args ) {
   args->params.outgoing_buffer_sz    = fd_env_strip_cmdline_ulong( argc, argv, "--max-send-buf",          NULL, 100U<<20U );
 }
 
+#define SMAX 1LU<<28
+
 static int stopflag = 0;
 static void
 signal1( int sig ) {
@@ -159,11 +161,48 @@ signal1( int sig ) {
   stopflag = 1;
 }
 
+/* Every tile but tile 0 serves one of the extra web server workers.
+   Tile 0 serves worker 0 and delivers the replay and stake
+   notifications. */
+
+static int
+worker_main( int argc, char ** argv ) {
+  (void)argc;
+  fd_rpc_ctx_t * ctx = (fd_rpc_ctx_t *)argv;
+
+  uchar * smem = aligned_alloc( FD_SCRATCH_SMEM_ALIGN,
+                                fd_ulong_align_up( fd_scratch_smem_footprint( SMAX  ), FD_SCRATCH_SMEM_ALIGN ) );
+  ulong fmem[16U];
+  fd_scratch_attach( smem, fmem, SMAX, 16U );
+
+  while( !FD_VOLATILE_CONST( stopflag ) ) {
+    fd_rpc_ws_poll( ctx );
+  }
+
+  fd_scratch_detach( NULL );
+  free( smem );
+  return 0;
+}
+
+static void
+start_workers( fd_rpc_ctx_t * ctx, fd_tile_exec_t ** exec ) {
+  for( ulong i = 1; i < fd_rpc_worker_cnt( ctx ); ++i ) {
+    exec[i] = fd_tile_exec_new( i, worker_main, 0, (char **)fd_rpc_worker_ctx( ctx, i ) );
+    if( FD_UNLIKELY( !exec[i] ) ) FD_LOG_ERR(( "fd_tile_exec_new failed" ));
+  }
+}
+
+static void
+stop_workers( fd_rpc_ctx_t * ctx, fd_tile_exec_t ** exec ) {
+  for( ulong i = 1; i < fd_rpc_worker_cnt( ctx ); ++i ) {
+    fd_tile_exec_delete( exec[i], NULL );
+  }
+}
+
 int main( int argc, char ** argv ) {
   fd_boot( &argc, &argv );
   fd_rpcserver_args_t args;
 
-#define SMAX 1LU<<28
   uchar * smem = aligned_alloc( FD_SCRATCH_SMEM_ALIGN,
                                 fd_ulong_align_up( fd_scratch_smem_footprint( SMAX  ), FD_SCRATCH_SMEM_ALIGN ) );
   ulong fmem[16U];
@@ -185,6 +224,7 @@ int main( int argc, char ** argv ) {
   } else {
     init_args_offline( &argc, &argv, &args );
   }
+  args.worker_cnt = fd_tile_cnt();
 
   struct sigaction sa = {
     .sa_handler = signal1,
@@ -200,10 +240,14 @@ int main( int argc, char ** argv ) {
   fd_rpc_create_ctx( &args, &ctx );
   fd_rpc_start_service( &args, ctx );
 
+  fd_tile_exec_t * exec[ FD_TILE_MAX ];
+  start_workers( ctx, exec );
+
   if( args.offline ) {
     while( !stopflag ) {
       fd_rpc_ws_poll( ctx );
     }
+    stop_workers( ctx, exec );
     fd_rpc_stop_service( ctx );
     fd_halt();
     return 0;
@@ -220,6 +264,7 @@ int main( int argc, char ** argv ) {
     fd_rpc_ws_poll( ctx );
   }
 
+  stop_workers( ctx, exec );
   fd_rpc_stop_service( ctx );
 
   fd_halt();
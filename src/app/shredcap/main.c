@@ -1,4 +1,7 @@
 #include "../../flamenco/shredcap/fd_shredcap.h"
+#if FD_HAS_ZSTD
+#include "../../flamenco/shredcap/fd_shredcap_archive.h"
+#endif
 
 /* fd_shredcap is a tool to ingest and verify rocksdb into a fd_shredcap capture.
    The main commands are "--cmd ingest and --cmd verify". By default, "ingest" 
@@ -13,11 +16,86 @@
    
    The "populate" command populates a blockstore with a specified block range. It
    will also contain the bank hash information for each slot. frank_ledger can be 
-   used to generate checkpoints using a shredstore.  */
+   used to generate checkpoints using a shredstore.
+
+   With --archive <file>, the same commands operate on a single file
+   fd_shredcap_archive instead of a --capturepath directory. Blocks are
+   zstd compressed at --zstdlevel and ingest, verify and populate are
+   spread over all tiles, e.g.:
+
+   build/native/clang/bin/fd_shred_cap --pages 10 --tile-cpus 1-16 --rocksdb
+   /data/ibhatt/hash/rocksdb/ --archive ~/bigcap.shredcap --cmd ingest
+   --startslot 250553925 --endslot 250558000.
+
+   The archive file must not exist yet. */
 
 #define DEFAULT_SHREDCAP_FILE_SIZE (1737418240UL)
 #define DEFAULT_SLOT_HISTORY_MAX   (10000000UL)
 
+#if FD_HAS_ZSTD
+static uchar tpool_mem[ FD_TPOOL_FOOTPRINT( FD_TILE_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+
+static fd_tpool_t *
+init_tpool( void ) {
+  ulong tcnt = fd_tile_cnt();
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, tcnt );
+  if( tpool == NULL ) {
+    FD_LOG_ERR(( "failed to create thread pool" ));
+  }
+  for( ulong i=1UL; i<tcnt; ++i ) {
+    if( fd_tpool_worker_push( tpool, i, NULL, 0UL ) == NULL ) {
+      FD_LOG_ERR(( "failed to launch worker" ));
+    }
+  }
+  return tpool;
+}
+
+static void
+archive_cmd( char const *      cmd,
+             char const *      rocksdb_dir,
+             char const *      archive_path,
+             ulong             start_slot,
+             ulong             end_slot,
+             int               zstd_level,
+             char const *      do_verify,
+             fd_blockstore_t * blockstore ) {
+  fd_tpool_t * tpool = init_tpool();
+  fd_shredcap_archive_t ar[1];
+
+  if ( strcmp( cmd, "ingest" ) == 0 ) {
+    if( rocksdb_dir ) {
+      fd_shredcap_archive_ingest_rocksdb( rocksdb_dir, archive_path, start_slot, end_slot, zstd_level, tpool );
+      if ( strcmp( do_verify, "true" ) == 0 ) {
+        if( FD_UNLIKELY( !fd_shredcap_archive_open( ar, archive_path ) ) ) {
+          FD_LOG_ERR(( "failed to open archive=%s", archive_path ));
+        }
+        fd_shredcap_archive_verify( ar, fd_libc_alloc_virtual(), tpool );
+        fd_shredcap_archive_close( ar );
+      }
+    }
+  }
+  else if ( strcmp( cmd, "verify" ) == 0 ) {
+    if( FD_UNLIKELY( !fd_shredcap_archive_open( ar, archive_path ) ) ) {
+      FD_LOG_ERR(( "failed to open archive=%s", archive_path ));
+    }
+    fd_shredcap_archive_verify( ar, fd_libc_alloc_virtual(), tpool );
+    fd_shredcap_archive_close( ar );
+  }
+  else if ( strcmp( cmd, "populate" ) == 0 ) {
+    if( FD_UNLIKELY( !fd_shredcap_archive_open( ar, archive_path ) ) ) {
+      FD_LOG_ERR(( "failed to open archive=%s", archive_path ));
+    }
+    fd_shredcap_archive_populate_blockstore( ar, blockstore, start_slot, end_slot, fd_libc_alloc_virtual(), tpool );
+    fd_shredcap_archive_close( ar );
+  }
+  else {
+    FD_LOG_ERR(( "unknown command=%s", cmd ));
+  }
+
+  fd_tpool_fini( tpool );
+}
+#endif
+
 int
 main( int argc, char ** argv ) {
 
@@ -36,6 +114,10 @@ main( int argc, char ** argv ) {
   ulong max_file_sz         = fd_env_strip_cmdline_ulong( &argc, &argv, "--maxfilesz",   NULL, DEFAULT_SHREDCAP_FILE_SIZE );
   ulong slot_history_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--slothistory", NULL, DEFAULT_SLOT_HISTORY_MAX   );
   char const * do_verify    = fd_env_strip_cmdline_cstr ( &argc, &argv, "--doverify",    NULL, "true"                     );
+  char const * archive_path = fd_env_strip_cmdline_cstr ( &argc, &argv, "--archive",     NULL, NULL                       );
+#if FD_HAS_ZSTD
+  int zstd_level            = fd_env_strip_cmdline_int  ( &argc, &argv, "--zstdlevel",   NULL, FD_SHREDCAP_ARCHIVE_LEVEL_DEFAULT );
+#endif
 
   fd_wksp_t * wksp;
   if ( wkspname == NULL ) {
@@ -97,7 +179,14 @@ main( int argc, char ** argv ) {
     FD_LOG_ERR(( "no command specified" ));
   }
 
-  if ( strcmp( cmd, "ingest" ) == 0 ) {
+  if( archive_path ) {
+#if FD_HAS_ZSTD
+    archive_cmd( cmd, rocksdb_dir, archive_path, start_slot, end_slot, zstd_level, do_verify, blockstore );
+#else
+    FD_LOG_ERR(( "--archive requires a build with zstd support" ));
+#endif
+  }
+  else if ( strcmp( cmd, "ingest" ) == 0 ) {
     if( rocksdb_dir ) {
       fd_shredcap_ingest_rocksdb_to_capture( rocksdb_dir, capture_path,
                                                max_file_sz, start_slot, end_slot );
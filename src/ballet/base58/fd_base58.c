@@ -4,6 +4,10 @@
 #include "fd_base58_avx.h"
 #endif
 
+#if FD_HAS_AVX512
+#include "fd_base58_avx512.h"
+#endif
+
 /* base58_chars maps [0, 58) to the base58 character.  In the AVX case,
    this lookup table is contained implicitly in raw_to_base58 */
 
@@ -69,6 +69,31 @@ char * fd_base58_encode_64( uchar const * bytes, ulong * opt_len, char * out );
 uchar * fd_base58_decode_32( char const * encoded, uchar * out );
 uchar * fd_base58_decode_64( char const * encoded, uchar * out );
 
+/* fd_base58_encode_{32,64}_batch: Converts cnt numbers of 32 or 64
+   bytes (respectively), stored back to back starting at bytes, to
+   base58.  The cstr of number i is stored at
+   out+i*FD_BASE58_ENCODED_{32,64}_SZ and, if opt_len is non-NULL, its
+   length at opt_len[ i ].  Equivalent to calling
+   fd_base58_encode_{32,64} on each number, but on targets with AVX-512
+   support, it converts 8 numbers at a time, which is several times
+   faster per number.  Returns out.  Meant for things like serializing
+   all the account addresses or signatures of a transaction. */
+
+char * fd_base58_encode_32_batch( uchar const * bytes, ulong cnt, ulong * opt_len, char * out );
+char * fd_base58_encode_64_batch( uchar const * bytes, ulong cnt, ulong * opt_len, char * out );
+
+/* fd_base58_decode_{32,64}_batch: Converts the cnt base58 cstrs
+   encoded[ i ] to 32 or 64 byte numbers, stored back to back starting
+   at out (which must have room for cnt*{32,64} bytes).  Equivalent to
+   calling fd_base58_decode_{32,64} on each cstr, but on targets with
+   AVX-512 support, it converts 8 cstrs at a time.  Returns cnt if all
+   cstrs are valid.  Otherwise, returns the index of the first invalid
+   cstr, in which case the contents of out at and after that number are
+   undefined. */
+
+ulong fd_base58_decode_32_batch( char const * const encoded[], ulong cnt, uchar * out );
+ulong fd_base58_decode_64_batch( char const * const encoded[], ulong cnt, uchar * out );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_ballet_base58_fd_base58_h */
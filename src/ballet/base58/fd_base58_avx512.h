@@ -0,0 +1,87 @@
+#include "../../util/simd/fd_avx512.h"
+
+/* This is not a proper header and so should not be included from
+   anywhere besides fd_base58.c and test_base58.c.  As such, it has no
+   include guard.
+
+   Unlike fd_base58_avx.h, which spreads a single number over the lanes
+   of a vector, these helpers are for the batch conversions, which
+   convert 8 independent numbers at a time, one per 64-bit lane.  The
+   per number arithmetic is then exactly the scalar arithmetic, just 8
+   wide. */
+
+/* divmod_58_5 returns floor(x/58^5) and stores x%58^5 in *rem for each
+   lane.  There is no 64-bit vector division (or high multiplication)
+   so the quotient is estimated in double precision and corrected.  The
+   quotient is less than 2^35 and the estimate has a relative error of a
+   few 2^-53, so it is off by at most one in either direction.  The
+   remainder of an estimate that is too large is negative (as a long),
+   and the remainder of an estimate that is too small is at least 58^5,
+   so a single fix up in each direction suffices. */
+
+static inline wwv_t
+divmod_58_5( wwv_t   x,
+             wwv_t * rem ) {
+  wwv_t d = wwv_bcast( 656356768UL ); /* = 58^5 */
+  wwv_t q = _mm512_cvttpd_epu64( _mm512_mul_pd( _mm512_cvtepu64_pd( x ), _mm512_set1_pd( 1. / 656356768. ) ) );
+  wwv_t r = wwv_sub( x, wwv_mul( q, d ) );
+
+  int over = (int)_mm512_cmplt_epi64_mask( r, wwv_zero() );
+  q = wwv_sub_if( over, q, wwv_one(), q );
+  r = wwv_add_if( over, r, d,         r );
+
+  int under = wwv_ge( r, d );
+  q = wwv_add_if( under, q, wwv_one(), q );
+  r = wwv_sub_if( under, r, d,         r );
+
+  *rem = r;
+  return q;
+}
+
+/* intermediate_to_raw_lanes converts the number in intermediate form
+   ( digits in [0,58^5) ) in each lane to 5 digits of raw base58 (<58),
+   most significant digit in raw[0].  See intermediate_to_raw in
+   fd_base58_avx.h for the magic multiplications. */
+
+static inline void
+intermediate_to_raw_lanes( wwv_t intermediate,
+                           wwv_t raw[ 5 ] ) {
+  wwv_t cA  = wwv_bcast( 2369637129UL ); /* =2^37/58 */
+  wwv_t cB  = wwv_bcast( 1307386003UL ); /* =2^42/58^2 */
+  wwv_t _58 = wwv_bcast( 58UL );
+
+# define DIV58(r)    wwv_shr( wwv_mul_ll( r,               cA ), 37 )
+# define DIV3364(r)  wwv_shr( wwv_mul_ll( wwv_shr( r, 2 ), cB ), 40 )
+
+  wwv_t div0 = intermediate;
+  wwv_t div1 = DIV58(div0);
+  wwv_t div2 = DIV3364(div0);
+  wwv_t div3 = DIV3364(div1);
+  wwv_t div4 = DIV3364(div2);
+
+# undef DIV58
+# undef DIV3364
+
+  raw[ 4 ] = wwv_sub( div0, wwv_mul_ll( div1, _58 ) );
+  raw[ 3 ] = wwv_sub( div1, wwv_mul_ll( div2, _58 ) );
+  raw[ 2 ] = wwv_sub( div2, wwv_mul_ll( div3, _58 ) );
+  raw[ 1 ] = wwv_sub( div3, wwv_mul_ll( div4, _58 ) );
+  raw[ 0 ] = div4; /* We know the values are less than 58 at this point */
+}
+
+/* raw_to_base58_512 converts each byte in the vector from raw base58
+   [0, 58) to base58 digits.  Same arithmetic as raw_to_base58 in
+   fd_base58_avx.h, but with mask registers:
+
+     b58ch(x) = '1' + x + 7*[x>8] + [x>16] + [x>21] + 6*[x>32] + [x>43] */
+
+static inline __m512i
+raw_to_base58_512( __m512i in ) {
+  __m512i out = _mm512_add_epi8( in, _mm512_set1_epi8( '1' ) );
+  out = _mm512_mask_add_epi8( out, _mm512_cmpgt_epu8_mask( in, _mm512_set1_epi8(  8 ) ), out, _mm512_set1_epi8( 7 ) );
+  out = _mm512_mask_add_epi8( out, _mm512_cmpgt_epu8_mask( in, _mm512_set1_epi8( 16 ) ), out, _mm512_set1_epi8( 1 ) );
+  out = _mm512_mask_add_epi8( out, _mm512_cmpgt_epu8_mask( in, _mm512_set1_epi8( 21 ) ), out, _mm512_set1_epi8( 1 ) );
+  out = _mm512_mask_add_epi8( out, _mm512_cmpgt_epu8_mask( in, _mm512_set1_epi8( 32 ) ), out, _mm512_set1_epi8( 6 ) );
+  out = _mm512_mask_add_epi8( out, _mm512_cmpgt_epu8_mask( in, _mm512_set1_epi8( 43 ) ), out, _mm512_set1_epi8( 1 ) );
+  return out;
+}
@@ -21,6 +21,7 @@
 
 #define BYTE_CNT     ((ulong) N)
 #define SUFFIX(s)    FD_EXPAND_THEN_CONCAT3(s,_,N)
+#define BATCH_SUFFIX(s) FD_EXPAND_THEN_CONCAT4(s,_,N,_batch)
 #define ENCODED_SZ() FD_EXPAND_THEN_CONCAT3(FD_BASE58_ENCODED_, N, _SZ)
 #define RAW58_SZ     (INTERMEDIATE_SZ*5UL)
 
@@ -296,9 +297,15 @@ SUFFIX(fd_base58_encode)( uchar const * bytes,
   return out;
 }
 
-uchar *
-SUFFIX(fd_base58_decode)( char const * encoded,
-                          uchar      * out      ) {
+/* SUFFIX(decode_intermediate) validates the cstr encoded and converts
+   it to the intermediate format (base 58^5), storing term i at
+   intermediate[ i*stride ].  Returns 1 on success and 0 if encoded is
+   invalid (bad character or too long). */
+
+static inline int
+SUFFIX(decode_intermediate)( char const * encoded,
+                             ulong      * intermediate,
+                             ulong        stride ) {
 
   /* Validate string and count characters before the nul terminator */
 
@@ -309,10 +316,10 @@ SUFFIX(fd_base58_decode)( char const * encoded,
     /* If c<'1', this will underflow and idx will be huge */
     ulong idx = (ulong)(uchar)c - (ulong)BASE58_INVERSE_TABLE_OFFSET;
     idx = fd_ulong_min( idx, BASE58_INVERSE_TABLE_SENTINEL );
-    if( FD_UNLIKELY( base58_inverse[ idx ] == BASE58_INVALID_CHAR ) ) return NULL;
+    if( FD_UNLIKELY( base58_inverse[ idx ] == BASE58_INVALID_CHAR ) ) return 0;
   }
 
-  if( FD_UNLIKELY( char_cnt == ENCODED_SZ() ) ) return NULL; /* too long */
+  if( FD_UNLIKELY( char_cnt == ENCODED_SZ() ) ) return 0; /* too long */
 
   /* X = sum_i raw_base58[i] * 58^(RAW58_SZ-1-i) */
 
@@ -327,14 +334,57 @@ SUFFIX(fd_base58_decode)( char const * encoded,
   /* Convert to the intermediate format (base 58^5):
        X = sum_i intermediate[i] * 58^(5*(INTERMEDIATE_SZ-1-i)) */
 
-  ulong intermediate[ INTERMEDIATE_SZ ];
   for( ulong i=0UL; i<INTERMEDIATE_SZ; i++ )
-    intermediate[ i ] = (ulong)raw_base58[ 5UL*i+0UL ] * 11316496UL +
-                        (ulong)raw_base58[ 5UL*i+1UL ] * 195112UL   +
-                        (ulong)raw_base58[ 5UL*i+2UL ] * 3364UL     +
-                        (ulong)raw_base58[ 5UL*i+3UL ] * 58UL       +
-                        (ulong)raw_base58[ 5UL*i+4UL ] * 1UL;
+    intermediate[ i*stride ] = (ulong)raw_base58[ 5UL*i+0UL ] * 11316496UL +
+                               (ulong)raw_base58[ 5UL*i+1UL ] * 195112UL   +
+                               (ulong)raw_base58[ 5UL*i+2UL ] * 3364UL     +
+                               (ulong)raw_base58[ 5UL*i+3UL ] * 58UL       +
+                               (ulong)raw_base58[ 5UL*i+4UL ] * 1UL;
+  return 1;
+}
+
+/* SUFFIX(decode_binary) finishes the conversion of encoded from the
+   reduced base 2^32 terms binary[ i*stride ] (all but the first are
+   less than 2^32).  Returns out on success and NULL if encoded doesn't
+   represent a BYTE_CNT byte number. */
+
+static inline uchar *
+SUFFIX(decode_binary)( char const  * encoded,
+                       ulong const * binary,
+                       ulong         stride,
+                       uchar       * out ) {
+
+  /* If the largest term is 2^32 or bigger, it means N is larger than
+     what can fit in BYTE_CNT bytes.  This can be triggered, by passing
+     a base58 string of all 'z's for example. */
+
+  if( FD_UNLIKELY( binary[ 0UL ] > 0xFFFFFFFFUL ) ) return NULL;
+
+  /* Convert each term to big endian for the final output */
 
+  uint * out_as_uint = (uint*)out;
+  for( ulong i=0UL; i<BINARY_SZ; i++ ) {
+    FD_STORE( uint, &out_as_uint[ i ], fd_uint_bswap( (uint)binary[ i*stride ] ) );
+  }
+  /* Make sure the encoded version has the same number of leading '1's
+     as the decoded version has leading 0s. The check doesn't read past
+     the end of encoded, because '\0' != '1', so it will return NULL. */
+
+  ulong leading_zero_cnt = 0UL;
+  for( ; leading_zero_cnt<BYTE_CNT; leading_zero_cnt++ ) {
+    if( out[ leading_zero_cnt ] ) break;
+    if( FD_UNLIKELY( encoded[ leading_zero_cnt ] != '1' ) ) return NULL;
+  }
+  if( FD_UNLIKELY( encoded[ leading_zero_cnt ] == '1' ) ) return NULL;
+  return out;
+}
+
+uchar *
+SUFFIX(fd_base58_decode)( char const * encoded,
+                          uchar      * out      ) {
+
+  ulong intermediate[ INTERMEDIATE_SZ ];
+  if( FD_UNLIKELY( !SUFFIX(decode_intermediate)( encoded, intermediate, 1UL ) ) ) return NULL;
 
   /* Using the table, convert to overcomplete base 2^32 (terms can be
      larger than 2^32).  We need to be careful about overflow.
@@ -367,33 +417,201 @@ SUFFIX(fd_base58_decode)( char const * encoded,
     binary[ i     ] &= 0xFFFFFFFFUL;
   }
 
-  /* If the largest term is 2^32 or bigger, it means N is larger than
-     what can fit in BYTE_CNT bytes.  This can be triggered, by passing
-     a base58 string of all 'z's for example. */
+  return SUFFIX(decode_binary)( encoded, binary, 1UL, out );
+}
 
-  if( FD_UNLIKELY( binary[ 0UL ] > 0xFFFFFFFFUL ) ) return NULL;
+/* The batch conversions below do the same arithmetic as the single
+   conversions above on 8 numbers at a time, one per 64-bit lane (see
+   fd_base58_avx512.h).  The per number prologue and epilogue (leading
+   zeros, validation) stay scalar. */
 
-  /* Convert each term to big endian for the final output */
+#define VEC_CNT ((RAW58_SZ+63UL)/64UL) /* Vectors per number once transposed */
 
-  uint * out_as_uint = (uint*)out;
-  for( ulong i=0UL; i<BINARY_SZ; i++ ) {
-    FD_STORE( uint, &out_as_uint[ i ], fd_uint_bswap( (uint)binary[ i ] ) );
+char *
+BATCH_SUFFIX(fd_base58_encode)( uchar const * bytes,
+                                ulong         cnt,
+                                ulong       * opt_len,
+                                char        * out ) {
+#if FD_HAS_AVX512
+  uchar pad[ 8UL*BYTE_CNT ];
+
+  __m256i limb_idx = _mm256_setr_epi32( 0*N, 1*N, 2*N, 3*N, 4*N, 5*N, 6*N, 7*N );
+  __m256i bswap32  = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                       3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+
+  for( ulong b=0UL; b<cnt; b+=8UL ) {
+    ulong         lane_cnt = fd_ulong_min( cnt-b, 8UL );
+    uchar const * in       = bytes + b*BYTE_CNT;
+    if( FD_UNLIKELY( lane_cnt<8UL ) ) {
+      fd_memset( pad, 0,  8UL*BYTE_CNT      );
+      fd_memcpy( pad, in, lane_cnt*BYTE_CNT );
+      in = pad;
+    }
+
+    /* Convert to the intermediate format, one 32-bit limb of each
+       number at a time.  Same bounds as the scalar version. */
+
+    wwv_t intermediate[ INTERMEDIATE_SZ ];
+    for( ulong i=0UL; i<INTERMEDIATE_SZ; i++ ) intermediate[ i ] = wwv_zero();
+
+    for( ulong i=0UL; i<BINARY_SZ; i++ ) {
+#     if N==64
+      if( i==8UL ) { /* Mini-reduction */
+        wwv_t rem;
+        intermediate[ 15 ] = wwv_add( intermediate[ 15 ], divmod_58_5( intermediate[ 16 ], &rem ) );
+        intermediate[ 16 ] = rem;
+      }
+#     endif
+      __m256i limb   = _mm256_i32gather_epi32( (int const *)(in + i*sizeof(uint)), limb_idx, 1 );
+      wwv_t   binary = _mm512_cvtepu32_epi64( _mm256_shuffle_epi8( limb, bswap32 ) );
+      for( ulong j=0UL; j<INTERMEDIATE_SZ-1UL; j++ )
+        intermediate[ j+1UL ] = wwv_add( intermediate[ j+1UL ], wwv_mul_ll( binary, wwv_bcast( SUFFIX(enc_table)[ i ][ j ] ) ) );
+    }
+
+    /* Reduce each term below 58^5.  The scalar version does this with
+       a single pass of carries, but that is a long dependency chain of
+       divisions, so the carries are done in two passes where all the
+       divisions are independent (the first leaves terms below
+       58^5+2^35, the second below 58^5+54) and a final ripple of 0/1
+       carries.  The representation with all terms below 58^5 is
+       unique, so this gives the same result.  Terms only get smaller
+       than in the scalar version, so the overflow analysis above still
+       holds. */
+
+    for( ulong pass=0UL; pass<2UL; pass++ ) {
+      wwv_t carry = wwv_zero();
+      for( ulong i=INTERMEDIATE_SZ-1UL; i>0UL; i-- ) {
+        wwv_t rem;
+        wwv_t quo = divmod_58_5( intermediate[ i ], &rem );
+        intermediate[ i ] = wwv_add( rem, carry );
+        carry = quo;
+      }
+      intermediate[ 0 ] = wwv_add( intermediate[ 0 ], carry );
+    }
+
+    wwv_t r1div = wwv_bcast( 656356768UL );
+    int   carry = 0;
+    for( ulong i=INTERMEDIATE_SZ-1UL; i>0UL; i-- ) {
+      wwv_t t = wwv_add_if( carry, intermediate[ i ], wwv_one(), intermediate[ i ] );
+      carry   = wwv_ge( t, r1div );
+      intermediate[ i ] = wwv_sub_if( carry, t, r1div, t );
+    }
+    intermediate[ 0 ] = wwv_add_if( carry, intermediate[ 0 ], wwv_one(), intermediate[ 0 ] );
+
+    /* Convert to raw base58, packing the digits of each number 8 per
+       ulong in string order, and then to base58 characters. */
+
+    wwv_t group[ 8UL*VEC_CNT ];
+    for( ulong g=0UL; g<8UL*VEC_CNT; g++ ) group[ g ] = wwv_zero();
+    for( ulong i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+      wwv_t raw[ 5 ];
+      intermediate_to_raw_lanes( intermediate[ i ], raw );
+      for( ulong k=0UL; k<5UL; k++ ) {
+        ulong r = 5UL*i+k;
+        group[ r/8UL ] = wwv_or( group[ r/8UL ], wwv_shl( raw[ k ], 8UL*(r%8UL) ) );
+      }
+    }
+    for( ulong g=0UL; g<8UL*VEC_CNT; g++ ) group[ g ] = raw_to_base58_512( group[ g ] );
+
+    /* Transpose so that group[ 8*v+l ] holds the characters
+       [64*v,64*v+64) of number l */
+
+    for( ulong v=0UL; v<VEC_CNT; v++ ) {
+      wwv_t * g = group + 8UL*v;
+      wwv_transpose_8x8( g[0], g[1], g[2], g[3], g[4], g[5], g[6], g[7],
+                         g[0], g[1], g[2], g[3], g[4], g[5], g[6], g[7] );
+    }
+
+    /* Skip leading zeros like the scalar version.  The padding digits
+       past RAW58_SZ are '1's too, hence the min.  As in the AVX
+       version, the string is written with masked stores to out-skip. */
+
+    for( ulong l=0UL; l<lane_cnt; l++ ) {
+      uchar const * num = in + l*BYTE_CNT;
+#     if N==32
+      ulong in_leading_0s  = (ulong)fd_ulong_find_lsb_w_default( (ulong)_mm256_cmpneq_epi8_mask( _mm256_loadu_si256( (__m256i const *)num ), _mm256_setzero_si256() ), 32 );
+      ulong raw_leading_0s = (ulong)fd_ulong_find_lsb_w_default( (ulong)_mm512_cmpneq_epi8_mask( group[ l ], _mm512_set1_epi8( '1' ) ), 64 );
+#     else
+      ulong in_leading_0s  = (ulong)fd_ulong_find_lsb_w_default( (ulong)_mm512_cmpneq_epi8_mask( _mm512_loadu_si512( num ), _mm512_setzero_si512() ), 64 );
+      ulong raw_leading_0s = (ulong)fd_ulong_find_lsb_w_default( (ulong)_mm512_cmpneq_epi8_mask( group[ l ], _mm512_set1_epi8( '1' ) ), -1 );
+      if( FD_UNLIKELY( raw_leading_0s==ULONG_MAX ) )
+        raw_leading_0s = 64UL + (ulong)fd_ulong_find_lsb_w_default( (ulong)_mm512_cmpneq_epi8_mask( group[ 8UL+l ], _mm512_set1_epi8( '1' ) ), 64 );
+#     endif
+      raw_leading_0s = fd_ulong_min( raw_leading_0s, RAW58_SZ );
+
+      ulong  skip = raw_leading_0s - in_leading_0s;
+      char * o    = out + (b+l)*ENCODED_SZ() - skip;
+      _mm512_mask_storeu_epi8( o, (~0UL<<skip) & fd_ulong_mask_lsb( (int)fd_ulong_min( RAW58_SZ, 64UL ) ), group[ l ] );
+#     if N==64
+      _mm512_mask_storeu_epi8( o+64UL, fd_ulong_mask_lsb( (int)(RAW58_SZ-64UL) ), group[ 8UL+l ] );
+#     endif
+      o[ RAW58_SZ ] = '\0';
+      if( opt_len ) opt_len[ b+l ] = RAW58_SZ-skip;
+    }
   }
-  /* Make sure the encoded version has the same number of leading '1's
-     as the decoded version has leading 0s. The check doesn't read past
-     the end of encoded, because '\0' != '1', so it will return NULL. */
+#else
+  for( ulong i=0UL; i<cnt; i++ )
+    SUFFIX(fd_base58_encode)( bytes + i*BYTE_CNT, opt_len ? opt_len+i : NULL, out + i*ENCODED_SZ() );
+#endif
+  return out;
+}
 
-  ulong leading_zero_cnt = 0UL;
-  for( ; leading_zero_cnt<BYTE_CNT; leading_zero_cnt++ ) {
-    if( out[ leading_zero_cnt ] ) break;
-    if( FD_UNLIKELY( encoded[ leading_zero_cnt ] != '1' ) ) return NULL;
+ulong
+BATCH_SUFFIX(fd_base58_decode)( char const * const encoded[],
+                                ulong              cnt,
+                                uchar            * out ) {
+#if FD_HAS_AVX512
+  ulong intermediate[ INTERMEDIATE_SZ ][ 8UL ] __attribute__((aligned(64)));
+  ulong binary      [ BINARY_SZ       ][ 8UL ] __attribute__((aligned(64)));
+
+  for( ulong b=0UL; b<cnt; b+=8UL ) {
+    /* Stop at the first cstr with an invalid character.  The lanes
+       before it are still converted, since one of them might fail the
+       binary checks below and has to be reported first. */
+
+    ulong lane_cnt = fd_ulong_min( cnt-b, 8UL );
+    ulong bad_lane = lane_cnt;
+    for( ulong l=0UL; l<lane_cnt; l++ ) {
+      if( FD_UNLIKELY( !SUFFIX(decode_intermediate)( encoded[ b+l ], intermediate[ 0 ]+l, 8UL ) ) ) { bad_lane = l; break; }
+    }
+    lane_cnt = bad_lane;
+    for( ulong l=lane_cnt; l<8UL; l++ ) {
+      for( ulong i=0UL; i<INTERMEDIATE_SZ; i++ ) intermediate[ i ][ l ] = 0UL;
+    }
+
+    /* Same bounds as the scalar version */
+
+    wwv_t acc[ BINARY_SZ ];
+    for( ulong j=0UL; j<BINARY_SZ; j++ ) acc[ j ] = wwv_zero();
+    for( ulong i=0UL; i<INTERMEDIATE_SZ; i++ ) {
+      wwv_t x = wwv_ld( intermediate[ i ] );
+      for( ulong j=0UL; j<BINARY_SZ; j++ )
+        acc[ j ] = wwv_add( acc[ j ], wwv_mul_ll( x, wwv_bcast( SUFFIX(dec_table)[ i ][ j ] ) ) );
+    }
+    for( ulong i=BINARY_SZ-1UL; i>0UL; i-- ) {
+      acc[ i-1UL ] = wwv_add( acc[ i-1UL ], wwv_shr( acc[ i ], 32 ) );
+      acc[ i     ] = wwv_and( acc[ i ], wwv_bcast( 0xFFFFFFFFUL ) );
+    }
+    for( ulong j=0UL; j<BINARY_SZ; j++ ) wwv_st( binary[ j ], acc[ j ] );
+
+    for( ulong l=0UL; l<lane_cnt; l++ ) {
+      if( FD_UNLIKELY( !SUFFIX(decode_binary)( encoded[ b+l ], binary[ 0 ]+l, 8UL, out + (b+l)*BYTE_CNT ) ) ) return b+l;
+    }
+    if( FD_UNLIKELY( lane_cnt<fd_ulong_min( cnt-b, 8UL ) ) ) return b+lane_cnt;
   }
-  if( FD_UNLIKELY( encoded[ leading_zero_cnt ] == '1' ) ) return NULL;
-  return out;
+#else
+  for( ulong i=0UL; i<cnt; i++ ) {
+    if( FD_UNLIKELY( !SUFFIX(fd_base58_decode)( encoded[ i ], out + i*BYTE_CNT ) ) ) return i;
+  }
+#endif
+  return cnt;
 }
 
+#undef VEC_CNT
+
 #undef RAW58_SZ
 #undef ENCODED_SZ
+#undef BATCH_SUFFIX
 #undef SUFFIX
 
 #undef BINARY_SZ
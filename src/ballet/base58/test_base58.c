@@ -486,6 +486,159 @@ battery_performance( encode_func_t encode_func,
                   (double)(encode_decode - encode  )/(double)test_count  ));
 }
 
+/* battery_batch checks that the batch conversions match the single
+   number conversions for batches of all sizes in [0,BATCH_MAX] (so that
+   partial vectors are covered), with numbers that have long runs of
+   leading zeros mixed in, and that a batch decode reports the first
+   invalid cstr. */
+
+#define BATCH_MAX (67UL)
+
+typedef char * (*encode_batch_func_t)( uchar const * bytes, ulong cnt, ulong * opt_len, char * out );
+typedef ulong  (*decode_batch_func_t)( char const * const encoded[], ulong cnt, uchar * out );
+
+static uchar batch_bytes  [ BATCH_MAX*64UL ];
+static uchar batch_decoded[ BATCH_MAX*64UL ];
+static char  batch_out    [ BATCH_MAX*FD_BASE58_ENCODED_64_SZ ];
+static char  batch_ref    [ BATCH_MAX*FD_BASE58_ENCODED_64_SZ ];
+static char  batch_bad    [ 2UL*(FD_BASE58_ENCODED_64_SZ+1UL) ];
+
+/* make_bad writes to dst an invalid version of the valid cstr src:
+   kind 0 replaces a random character with the invalid '0', kind 1 adds
+   a superfluous leading '1' and kind 2 replaces it with a number that
+   overflows.  dst must have room for encode_sz+1 chars. */
+
+static void
+make_bad( char *       dst,
+          char const * src,
+          uint         kind,
+          ulong        encode_sz,
+          fd_rng_t *   rng ) {
+  switch( kind ) {
+  case 0U:
+    strcpy( dst, src );
+    dst[ fd_rng_ulong_roll( rng, strlen( dst ) ) ] = '0';
+    break;
+  case 1U:
+    dst[ 0 ] = '1';
+    strcpy( dst+1, src );
+    break;
+  default:
+    fd_memset( dst, 'z', encode_sz-1UL );
+    dst[ encode_sz-1UL ] = '\0';
+    break;
+  }
+}
+
+static void
+battery_batch( encode_func_t       encode_func,
+               encode_batch_func_t encode_batch_func,
+               decode_batch_func_t decode_batch_func,
+               ulong               n,
+               ulong               encode_sz,
+               fd_rng_t *          rng,
+               ulong               iter_cnt ) {
+  ulong         len    [ BATCH_MAX ];
+  ulong         len_ref[ BATCH_MAX ];
+  char const *  encoded[ BATCH_MAX ];
+
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong cnt = iter % (BATCH_MAX+1UL);
+
+    for( ulong i=0UL; i<cnt; i++ ) {
+      uchar * bytes = batch_bytes + i*n;
+      switch( fd_rng_uint_roll( rng, 8U ) ) {
+      case 0U: fd_memset( bytes, 0,    n ); break;
+      case 1U: fd_memset( bytes, 0xFF, n ); break;
+      default: {
+        for( ulong j=0UL; j<n; j++ ) bytes[ j ] = fd_rng_uchar( rng );
+        ulong zero_cnt = fd_rng_ulong_roll( rng, n+1UL );
+        if( fd_rng_uint_roll( rng, 2U ) ) fd_memset( bytes, 0, zero_cnt );
+        break;
+      }
+      }
+      FD_TEST( encode_func( bytes, len_ref+i, batch_ref + i*encode_sz )==batch_ref + i*encode_sz );
+      encoded[ i ] = batch_out + i*encode_sz;
+    }
+
+    fd_memset( batch_out, 0xCC, sizeof(batch_out) );
+    FD_TEST( encode_batch_func( batch_bytes, cnt, len, batch_out )==batch_out );
+    for( ulong i=0UL; i<cnt; i++ ) {
+      FD_TEST( !strcmp( batch_out + i*encode_sz, batch_ref + i*encode_sz ) );
+      FD_TEST( len[ i ]==len_ref[ i ] );
+    }
+    FD_TEST( encode_batch_func( batch_bytes, cnt, NULL, batch_out )==batch_out );
+    for( ulong i=0UL; i<cnt; i++ ) FD_TEST( !strcmp( batch_out + i*encode_sz, batch_ref + i*encode_sz ) );
+
+    FD_TEST( decode_batch_func( encoded, cnt, batch_decoded )==cnt );
+    FD_TEST( !memcmp( batch_decoded, batch_bytes, cnt*n ) );
+
+    if( !cnt ) continue;
+
+    /* An invalid character, a superfluous leading '1' and an overflow */
+
+    ulong bad = fd_rng_ulong_roll( rng, cnt );
+    make_bad( batch_bad, encoded[ bad ], fd_rng_uint_roll( rng, 3U ), encode_sz, rng );
+    encoded[ bad ] = batch_bad;
+    FD_TEST( decode_batch_func( encoded, cnt, batch_decoded )==bad );
+    FD_TEST( !memcmp( batch_decoded, batch_bytes, bad*n ) );
+    encoded[ bad ] = batch_out + bad*encode_sz;
+
+    /* Two errors in the same group of 8: one only detected once the
+       number is converted to binary (leading '1' or overflow), followed
+       by an invalid character.  The first one must be reported, with
+       every cstr before it decoded. */
+
+    if( cnt<2UL ) continue;
+    ulong bad0      = fd_rng_ulong_roll( rng, cnt-1UL );
+    ulong group_end = fd_ulong_min( cnt, fd_ulong_align_dn( bad0, 8UL )+8UL );
+    if( bad0+1UL>=group_end ) continue;
+    ulong bad1      = bad0+1UL+fd_rng_ulong_roll( rng, group_end-bad0-1UL );
+    make_bad( batch_bad,                   encoded[ bad0 ], 1U+fd_rng_uint_roll( rng, 2U ), encode_sz, rng );
+    make_bad( batch_bad+encode_sz+1UL,     encoded[ bad1 ], 0U,                             encode_sz, rng );
+    encoded[ bad0 ] = batch_bad;
+    encoded[ bad1 ] = batch_bad+encode_sz+1UL;
+    fd_memset( batch_decoded, 0, sizeof(batch_decoded) );
+    FD_TEST( decode_batch_func( encoded, cnt, batch_decoded )==bad0 );
+    FD_TEST( !memcmp( batch_decoded, batch_bytes, bad0*n ) );
+  }
+}
+
+static void
+battery_batch_performance( encode_batch_func_t encode_batch_func,
+                           decode_batch_func_t decode_batch_func,
+                           ulong               n,
+                           ulong               encode_sz,
+                           fd_rng_t *          rng ) {
+  ulong const test_count = 3000UL;
+  ulong const cnt        = 64UL;
+
+  char const * encoded[ BATCH_MAX ];
+  for( ulong i=0UL; i<cnt*n; i++ ) batch_bytes[ i ] = fd_rng_uchar( rng );
+  for( ulong i=0UL; i<cnt;   i++ ) encoded[ i ] = batch_out + i*encode_sz;
+
+  encode_batch_func( batch_bytes, cnt, NULL, batch_out );
+
+  long encode = -fd_log_wallclock();
+  for( ulong i=0UL; i<test_count; i++ ) {
+    FD_VOLATILE( batch_bytes[ 0 ] ) = (uchar)i;
+    encode_batch_func( batch_bytes, cnt, NULL, batch_out );
+    FD_VOLATILE_CONST( batch_out[ 0 ] );
+  }
+  encode += fd_log_wallclock();
+
+  long decode = -fd_log_wallclock();
+  for( ulong i=0UL; i<test_count; i++ ) {
+    FD_TEST( decode_batch_func( encoded, cnt, batch_decoded )==cnt );
+    FD_VOLATILE_CONST( batch_decoded[ 0 ] );
+  }
+  decode += fd_log_wallclock();
+
+  FD_LOG_NOTICE(( "average time per batched encode %f ns, average time per batched decode %f ns",
+                  (double)encode/(double)(test_count*cnt),
+                  (double)decode/(double)(test_count*cnt) ));
+}
+
 #define MAKE_TESTS(n,name)                                                                     \
 static inline void                                                                             \
 test_encode_basic##name( void ) {                                                              \
@@ -743,6 +896,12 @@ main( int     argc,
   test_match64( rng, cnt );
   test_performance64( rng );
 
+  FD_LOG_NOTICE(( "Testing batch conversions" ));
+  battery_batch( fd_base58_encode_32, fd_base58_encode_32_batch, fd_base58_decode_32_batch, 32UL, FD_BASE58_ENCODED_32_SZ, rng, 10UL*(BATCH_MAX+1UL) );
+  battery_batch( fd_base58_encode_64, fd_base58_encode_64_batch, fd_base58_decode_64_batch, 64UL, FD_BASE58_ENCODED_64_SZ, rng, 10UL*(BATCH_MAX+1UL) );
+  battery_batch_performance( fd_base58_encode_32_batch, fd_base58_decode_32_batch, 32UL, FD_BASE58_ENCODED_32_SZ, rng );
+  battery_batch_performance( fd_base58_encode_64_batch, fd_base58_decode_64_batch, 64UL, FD_BASE58_ENCODED_64_SZ, rng );
+
   fd_rng_delete( fd_rng_leave( rng ) );
 
   FD_LOG_NOTICE(( "pass" ));
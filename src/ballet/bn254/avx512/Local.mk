@@ -0,0 +1,5 @@
+$(call add-hdrs,fd_r52x5.h)
+ifdef FD_HAS_AVX512
+$(call make-unit-test,test_r52x5,test_r52x5,fd_ballet fd_util)
+$(call run-unit-test,test_r52x5,)
+endif
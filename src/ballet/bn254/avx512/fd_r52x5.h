@@ -0,0 +1,259 @@
+#ifndef HEADER_fd_src_ballet_bn254_avx512_fd_r52x5_h
+#define HEADER_fd_src_ballet_bn254_avx512_fd_r52x5_h
+
+/* fd_r52x5 provides AVX-512 IFMA arithmetic on 8 independent elements
+   of a ~254-bit prime field at a time (e.g. the bn254 base field Fp or
+   the bn254 scalar field).
+
+   A fd_r52x5_t holds 8 field elements, one per 64-bit lane.  Each
+   element is represented in radix 2^52 with 5 limbs, i.e. lane i of
+   l[k] holds limb k of element i:
+
+     x_i = sum_k l[k]_i 2^(52k)
+
+   Elements are in Montgomery form with R=2^256, i.e. the same
+   representation used by fd_bn254_fp_t and fd_bn254_scalar_t, so that
+   converting between the two is just a change of radix (see
+   fd_r52x5_ld / fd_r52x5_st) and results are bit-identical to the
+   64-bit implementation.  Unless otherwise stated, inputs and outputs
+   are fully reduced, i.e. limbs are in [0,2^52) and values in [0,p).
+
+   Montgomery multiplication uses 52-bit digits (vpmadd52{lo,hi}uq),
+   4 reduction rounds of 52 bits and a last one of 48 bits, to divide
+   by exactly 2^256. */
+
+#include "../../fd_ballet_base.h"
+#include "../../bigint/fd_uint256.h"
+#include "../../../util/simd/fd_avx512.h"
+
+#define FD_R52X5_MASK52 ((1L<<52)-1L)
+#define FD_R52X5_MASK48 ((1L<<48)-1L)
+
+struct fd_r52x5 {
+  wwl_t l[5];
+};
+typedef struct fd_r52x5 fd_r52x5_t;
+
+/* fd_r52x5_mod_t holds the constants for a prime modulus p */
+
+struct fd_r52x5_mod {
+  long p[5];  /* p, 52-bit limbs */
+  long p_inv; /* -p^-1 mod 2^52 */
+};
+typedef struct fd_r52x5_mod fd_r52x5_mod_t;
+
+/* bn254 base field
+   0x30644e72e131a029b85045b68181585d97816a916871ca8d3c208c16d87cfd47 */
+static const fd_r52x5_mod_t fd_r52x5_bn254_p[1] = {{
+  .p     = { 0x08c16d87cfd47L, 0x916871ca8d3c2L, 0x181585d97816aL, 0xa029b85045b68L, 0x030644e72e131L },
+  .p_inv = 0x20782e4866389L,
+}};
+
+/* bn254 scalar field
+   0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001 */
+static const fd_r52x5_mod_t fd_r52x5_bn254_r[1] = {{
+  .p     = { 0x1f593f0000001L, 0x4879b9709143eL, 0x181585d2833e8L, 0xa029b85045b68L, 0x030644e72e131L },
+  .p_inv = 0x1f593efffffffL,
+}};
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_r52x5_limbs converts a 256-bit value to 5 52-bit limbs. */
+
+static inline long *
+fd_r52x5_limbs( long                 r[5],
+                fd_uint256_t const * a ) {
+  ulong const * x = a->limbs;
+  r[0] = (long)(   x[0]                      & (ulong)FD_R52X5_MASK52 );
+  r[1] = (long)( ((x[0]>>52) | (x[1]<<12)) & (ulong)FD_R52X5_MASK52 );
+  r[2] = (long)( ((x[1]>>40) | (x[2]<<24)) & (ulong)FD_R52X5_MASK52 );
+  r[3] = (long)( ((x[2]>>28) | (x[3]<<36)) & (ulong)FD_R52X5_MASK52 );
+  r[4] = (long)(   x[3]>>16 );
+  return r;
+}
+
+/* fd_r52x5_unlimbs is the inverse of fd_r52x5_limbs. */
+
+static inline fd_uint256_t *
+fd_r52x5_unlimbs( fd_uint256_t * r,
+                  long const     a[5] ) {
+  ulong const * x = (ulong const *)a;
+  r->limbs[0] =  x[0]      | (x[1]<<52);
+  r->limbs[1] = (x[1]>>12) | (x[2]<<40);
+  r->limbs[2] = (x[2]>>24) | (x[3]<<28);
+  r->limbs[3] = (x[3]>>36) | (x[4]<<16);
+  return r;
+}
+
+/* fd_r52x5_bcast sets all 8 lanes of r to the element with limbs a
+   (as returned by fd_r52x5_limbs). */
+
+static inline fd_r52x5_t *
+fd_r52x5_bcast( fd_r52x5_t * r,
+                long const   a[5] ) {
+  for( ulong k=0UL; k<5UL; k++ ) r->l[k] = wwl_bcast( a[k] );
+  return r;
+}
+
+static inline fd_r52x5_t *
+fd_r52x5_zero( fd_r52x5_t * r ) {
+  for( ulong k=0UL; k<5UL; k++ ) r->l[k] = wwl_zero();
+  return r;
+}
+
+/* fd_r52x5_ld loads a[i] into lane i of r.  fd_r52x5_st stores lane i
+   of r into a[i]. */
+
+static inline fd_r52x5_t *
+fd_r52x5_ld( fd_r52x5_t *         r,
+             fd_uint256_t const * a[8] ) {
+  long FD_ALIGNED t[5][8];
+  for( ulong i=0UL; i<8UL; i++ ) {
+    long l[5];
+    fd_r52x5_limbs( l, a[i] );
+    for( ulong k=0UL; k<5UL; k++ ) t[k][i] = l[k];
+  }
+  for( ulong k=0UL; k<5UL; k++ ) r->l[k] = wwl_ld( t[k] );
+  return r;
+}
+
+static inline void
+fd_r52x5_st( fd_uint256_t *     a[8],
+             fd_r52x5_t const * r ) {
+  long FD_ALIGNED t[5][8];
+  for( ulong k=0UL; k<5UL; k++ ) wwl_st( t[k], r->l[k] );
+  for( ulong i=0UL; i<8UL; i++ ) {
+    long l[5];
+    for( ulong k=0UL; k<5UL; k++ ) l[k] = t[k][i];
+    fd_r52x5_unlimbs( a[i], l );
+  }
+}
+
+/* fd_r52x5_private_sub_p computes r = x<p ? x : x-p, where x has
+   normalized limbs and x<2p. */
+
+static inline void
+fd_r52x5_private_sub_p( wwl_t                  r[5],
+                        wwl_t const            x[5],
+                        fd_r52x5_mod_t const * mod ) {
+  wwl_t const mask = wwl_bcast( FD_R52X5_MASK52 );
+  wwl_t s[5];
+  wwl_t b = wwl_zero();
+  for( ulong k=0UL; k<5UL; k++ ) {
+    wwl_t t = wwl_add( wwl_sub( x[k], wwl_bcast( mod->p[k] ) ), b );
+    b    = wwl_shr( t, 52 ); /* arithmetic, borrow is 0 or -1 */
+    s[k] = wwl_and( t, mask );
+  }
+  int keep = wwl_lt( b, wwl_zero() ); /* x<p */
+  for( ulong k=0UL; k<5UL; k++ ) r[k] = wwl_if( keep, x[k], s[k] );
+}
+
+/* fd_r52x5_add computes r = a + b mod p. */
+
+static inline fd_r52x5_t *
+fd_r52x5_add( fd_r52x5_t *           r,
+              fd_r52x5_t const *     a,
+              fd_r52x5_t const *     b,
+              fd_r52x5_mod_t const * mod ) {
+  wwl_t const mask = wwl_bcast( FD_R52X5_MASK52 );
+  wwl_t t[5];
+  wwl_t c = wwl_zero();
+  for( ulong k=0UL; k<5UL; k++ ) {
+    wwl_t s = wwl_add( wwl_add( a->l[k], b->l[k] ), c );
+    c    = wwl_shru( s, 52 );
+    t[k] = wwl_and( s, mask );
+  }
+  fd_r52x5_private_sub_p( r->l, t, mod );
+  return r;
+}
+
+/* fd_r52x5_sub computes r = a - b mod p. */
+
+static inline fd_r52x5_t *
+fd_r52x5_sub( fd_r52x5_t *           r,
+              fd_r52x5_t const *     a,
+              fd_r52x5_t const *     b,
+              fd_r52x5_mod_t const * mod ) {
+  wwl_t const mask = wwl_bcast( FD_R52X5_MASK52 );
+  wwl_t t[5];
+  wwl_t c = wwl_zero();
+  for( ulong k=0UL; k<5UL; k++ ) {
+    wwl_t s = wwl_add( wwl_sub( a->l[k], b->l[k] ), c );
+    c    = wwl_shr( s, 52 ); /* arithmetic, borrow is 0 or -1 */
+    t[k] = wwl_and( s, mask );
+  }
+  /* if a<b, add p back (the final carry cancels the borrow) */
+  int neg = wwl_lt( c, wwl_zero() );
+  c = wwl_zero();
+  for( ulong k=0UL; k<5UL; k++ ) {
+    wwl_t s = wwl_add( wwl_add_if( neg, t[k], wwl_bcast( mod->p[k] ), t[k] ), c );
+    c         = wwl_shru( s, 52 );
+    r->l[k] = wwl_and( s, mask );
+  }
+  return r;
+}
+
+/* fd_r52x5_mul computes r = a * b / 2^256 mod p (Montgomery mul).
+   In-place operation fine. */
+
+static inline fd_r52x5_t *
+fd_r52x5_mul( fd_r52x5_t *           r,
+              fd_r52x5_t const *     a,
+              fd_r52x5_t const *     b,
+              fd_r52x5_mod_t const * mod ) {
+  wwl_t const mask52 = wwl_bcast( FD_R52X5_MASK52 );
+  wwl_t const zero   = wwl_zero();
+  wwl_t p[5];
+  for( ulong k=0UL; k<5UL; k++ ) p[k] = wwl_bcast( mod->p[k] );
+  wwl_t p_inv = wwl_bcast( mod->p_inv );
+
+  /* Schoolbook product, columns are < 10*2^52 */
+  wwl_t t[10];
+  for( ulong k=0UL; k<10UL; k++ ) t[k] = zero;
+  for( ulong i=0UL; i<5UL; i++ ) {
+    for( ulong j=0UL; j<5UL; j++ ) {
+      t[i+j    ] = wwl_madd52lo( t[i+j    ], a->l[i], b->l[j] );
+      t[i+j+1UL] = wwl_madd52hi( t[i+j+1UL], a->l[i], b->l[j] );
+    }
+  }
+
+  /* 4 rounds of 52-bit Montgomery reduction */
+  for( ulong k=0UL; k<4UL; k++ ) {
+    wwl_t m = wwl_madd52lo( zero, t[k], p_inv );
+    for( ulong j=0UL; j<5UL; j++ ) {
+      t[k+j    ] = wwl_madd52lo( t[k+j    ], m, p[j] );
+      t[k+j+1UL] = wwl_madd52hi( t[k+j+1UL], m, p[j] );
+    }
+    t[k+1UL] = wwl_add( t[k+1UL], wwl_shru( t[k], 52 ) );
+  }
+
+  /* Last round of 48 bits (208+48=256) */
+  wwl_t m = wwl_and( wwl_madd52lo( zero, t[4], p_inv ), wwl_bcast( FD_R52X5_MASK48 ) );
+  for( ulong j=0UL; j<5UL; j++ ) {
+    t[4+j    ] = wwl_madd52lo( t[4+j    ], m, p[j] );
+    t[4+j+1UL] = wwl_madd52hi( t[4+j+1UL], m, p[j] );
+  }
+  for( ulong k=4UL; k<9UL; k++ ) {
+    t[k+1UL] = wwl_add( t[k+1UL], wwl_shru( t[k], 52 ) );
+    t[k]     = wwl_and( t[k], mask52 );
+  }
+
+  /* Divide by 2^48, result is < 2p */
+  wwl_t x[5];
+  for( ulong k=0UL; k<5UL; k++ ) {
+    x[k] = wwl_or( wwl_shru( t[4+k], 48 ), wwl_and( wwl_shl( t[5+k], 4 ), mask52 ) );
+  }
+  fd_r52x5_private_sub_p( r->l, x, mod );
+  return r;
+}
+
+static inline fd_r52x5_t *
+fd_r52x5_sqr( fd_r52x5_t *           r,
+              fd_r52x5_t const *     a,
+              fd_r52x5_mod_t const * mod ) {
+  return fd_r52x5_mul( r, a, a, mod );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_ballet_bn254_avx512_fd_r52x5_h */
@@ -0,0 +1,140 @@
+#include "../../fd_ballet.h"
+#include "fd_r52x5.h"
+#include "../../fiat-crypto/bn254_64.c"
+#include "../../fiat-crypto/bn254_scalar_64.c"
+
+/* Reference implementations, 64-bit Montgomery (R=2^256) */
+
+static const fd_uint256_t test_p[1] = {{{
+  0x3c208c16d87cfd47, 0x97816a916871ca8d, 0xb85045b68181585d, 0x30644e72e131a029,
+}}};
+
+static const fd_uint256_t test_r[1] = {{{
+  0x43e1f593f0000001, 0x2833e84879b97091, 0xb85045b68181585d, 0x30644e72e131a029,
+}}};
+
+static void
+ref_op( fd_uint256_t *       r,
+        fd_uint256_t const * a,
+        fd_uint256_t const * b,
+        int                  is_scalar,
+        int                  op ) {
+  switch( op ) {
+  case 0:
+    if( is_scalar ) fiat_bn254_scalar_add( r->limbs, a->limbs, b->limbs );
+    else            fiat_bn254_add       ( r->limbs, a->limbs, b->limbs );
+    break;
+  case 1:
+    if( is_scalar ) fiat_bn254_scalar_sub( r->limbs, a->limbs, b->limbs );
+    else            fiat_bn254_sub       ( r->limbs, a->limbs, b->limbs );
+    break;
+  default:
+    if( is_scalar ) fd_uint256_mul_mod_p( r, a, b, test_r, 0xC2E1F593EFFFFFFFUL );
+    else            fd_uint256_mul_mod_p( r, a, b, test_p, 0x87D20782E4866389UL );
+    break;
+  }
+}
+
+static void
+rand_elem( fd_rng_t *     rng,
+           fd_uint256_t * r,
+           fd_uint256_t const * mod ) {
+  switch( fd_rng_uint_roll( rng, 8U ) ) {
+  case 0: /* 0 */
+    memset( r, 0, 32 );
+    break;
+  case 1: /* mod-1 */
+    *r = *mod; r->limbs[0]--;
+    break;
+  default: /* < 2^253 < mod */
+    for( ulong k=0UL; k<4UL; k++ ) r->limbs[k] = fd_rng_ulong( rng );
+    r->limbs[3] >>= 3;
+  }
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  /* Radix conversion */
+
+  for( ulong iter=0UL; iter<100000UL; iter++ ) {
+    fd_uint256_t a[1], b[1];
+    long l[5];
+    rand_elem( rng, a, test_p );
+    fd_r52x5_limbs( l, a );
+    for( ulong k=0UL; k<5UL; k++ ) FD_TEST( (ulong)l[k]<(1UL<<52) );
+    fd_r52x5_unlimbs( b, l );
+    FD_TEST( fd_uint256_eq( a, b ) );
+  }
+
+  /* Arithmetic, each lane vs the 64-bit implementation */
+
+  for( int is_scalar=0; is_scalar<2; is_scalar++ ) {
+    fd_r52x5_mod_t const * mod = is_scalar ? fd_r52x5_bn254_r : fd_r52x5_bn254_p;
+    fd_uint256_t const *   m   = is_scalar ? test_r : test_p;
+
+    for( ulong iter=0UL; iter<100000UL; iter++ ) {
+      fd_uint256_t a[8], b[8], c[8], e[1];
+      fd_uint256_t const * pa[8]; fd_uint256_t const * pb[8]; fd_uint256_t * pc[8];
+      for( ulong i=0UL; i<8UL; i++ ) {
+        rand_elem( rng, &a[i], m ); pa[i] = &a[i];
+        rand_elem( rng, &b[i], m ); pb[i] = &b[i];
+        pc[i] = &c[i];
+      }
+
+      fd_r52x5_t x[1], y[1], z[1];
+      fd_r52x5_ld( x, pa );
+      fd_r52x5_ld( y, pb );
+
+      int op = (int)(iter % 3UL);
+      switch( op ) {
+      case 0:  fd_r52x5_add( z, x, y, mod ); break;
+      case 1:  fd_r52x5_sub( z, x, y, mod ); break;
+      default: fd_r52x5_mul( z, x, y, mod ); break;
+      }
+      fd_r52x5_st( pc, z );
+
+      for( ulong i=0UL; i<8UL; i++ ) {
+        ref_op( e, &a[i], &b[i], is_scalar, op );
+        FD_TEST( fd_uint256_eq( e, &c[i] ) );
+      }
+    }
+  }
+
+  /* Benchmark */
+
+  for( int is_scalar=0; is_scalar<2; is_scalar++ ) {
+    fd_r52x5_mod_t const * mod = is_scalar ? fd_r52x5_bn254_r : fd_r52x5_bn254_p;
+    fd_uint256_t const *   m   = is_scalar ? test_r : test_p;
+
+    fd_uint256_t a[8];
+    fd_uint256_t const * pa[8];
+    for( ulong i=0UL; i<8UL; i++ ) { rand_elem( rng, &a[i], m ); pa[i] = &a[i]; }
+    fd_r52x5_t x[1], y[1];
+    fd_r52x5_ld( x, pa );
+    fd_r52x5_ld( y, pa );
+
+    ulong iter = 1000000UL;
+    long dt = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) fd_r52x5_mul( x, x, y, mod );
+    dt += fd_log_wallclock();
+    fd_uint256_t * pc[8] = { &a[0], &a[1], &a[2], &a[3], &a[4], &a[5], &a[6], &a[7] };
+    fd_r52x5_st( pc, x );
+    FD_LOG_NOTICE(( "fd_r52x5_mul (%s): %.3f ns/elem", is_scalar ? "r" : "p", (double)dt/(8.*(double)iter) ));
+
+    fd_uint256_t u[1] = { a[0] };
+    dt = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) fd_uint256_mul_mod_p( u, u, &a[1], m, is_scalar ? 0xC2E1F593EFFFFFFFUL : 0x87D20782E4866389UL );
+    dt += fd_log_wallclock();
+    ulong sink = u->limbs[0]; FD_COMPILER_FORGET( sink );
+    FD_LOG_NOTICE(( "fd_uint256_mul_mod_p (%s): %.3f ns/elem", is_scalar ? "r" : "p", (double)dt/(double)iter ));
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
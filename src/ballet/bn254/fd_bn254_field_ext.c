@@ -593,6 +593,87 @@ fd_bn254_fp12_mul( fd_bn254_fp12_t * r,
   return r;
 }
 
+/* fd_bn254_fp6_mul_by_01 computes r = a * (b0 + b1 v), i.e. a product by
+   a sparse fp6 element with el[2]==0. */
+static inline fd_bn254_fp6_t *
+fd_bn254_fp6_mul_by_01( fd_bn254_fp6_t * r,
+                        fd_bn254_fp6_t const * a,
+                        fd_bn254_fp2_t const * b0,
+                        fd_bn254_fp2_t const * b1 ) {
+  /* https://github.com/Consensys/gnark-crypto/blob/v0.12.1/ecc/bn254/internal/fptower/e6.go#L185 */
+  fd_bn254_fp2_t const * a0 = &a->el[0];
+  fd_bn254_fp2_t const * a1 = &a->el[1];
+  fd_bn254_fp2_t const * a2 = &a->el[2];
+  fd_bn254_fp2_t a0b0[1], a1b1[1];
+  fd_bn254_fp2_t sa[1], sb[1];
+  fd_bn254_fp2_t r0[1], r1[1], r2[1];
+
+  fd_bn254_fp2_mul( a0b0, a0, b0 );
+  fd_bn254_fp2_mul( a1b1, a1, b1 );
+
+  /* r0 = a0b0 + xi * a2b1 */
+  fd_bn254_fp2_add( sa, a1, a2 );
+  fd_bn254_fp2_mul( r0, sa, b1 );
+  fd_bn254_fp2_sub( r0, r0, a1b1 );
+  fd_bn254_fp2_mul_by_xi( r0, r0 );
+  fd_bn254_fp2_add( r0, r0, a0b0 );
+
+  /* r2 = a1b1 + a2b0 */
+  fd_bn254_fp2_add( sa, a0, a2 );
+  fd_bn254_fp2_mul( r2, sa, b0 );
+  fd_bn254_fp2_sub( r2, r2, a0b0 );
+  fd_bn254_fp2_add( r2, r2, a1b1 );
+
+  /* r1 = a0b1 + a1b0 */
+  fd_bn254_fp2_add( sa, a0, a1 );
+  fd_bn254_fp2_add( sb, b0, b1 );
+  fd_bn254_fp2_mul( r1, sa, sb );
+  fd_bn254_fp2_sub( r1, r1, a0b0 );
+  fd_bn254_fp2_sub( r1, r1, a1b1 );
+
+  fd_bn254_fp2_set( &r->el[0], r0 );
+  fd_bn254_fp2_set( &r->el[1], r1 );
+  fd_bn254_fp2_set( &r->el[2], r2 );
+  return r;
+}
+
+/* fd_bn254_fp12_mul_by_034 computes r = a * b, where b is a line
+   evaluation with only b->el[0].el[0], b->el[1].el[0] and b->el[1].el[1]
+   nonzero (coefficients 0, 3 and 4 in the w basis).  This costs 13 fp2
+   muls, vs 18 for fd_bn254_fp12_mul. */
+static inline fd_bn254_fp12_t *
+fd_bn254_fp12_mul_by_034( fd_bn254_fp12_t * r,
+                          fd_bn254_fp12_t const * a,
+                          fd_bn254_fp12_t const * b ) {
+  /* https://github.com/Consensys/gnark-crypto/blob/v0.12.1/ecc/bn254/internal/fptower/e12_pairing.go#L50 */
+  fd_bn254_fp2_t const * c0 = &b->el[0].el[0];
+  fd_bn254_fp2_t const * c3 = &b->el[1].el[0];
+  fd_bn254_fp2_t const * c4 = &b->el[1].el[1];
+  fd_bn254_fp6_t const * a0 = &a->el[0];
+  fd_bn254_fp6_t const * a1 = &a->el[1];
+  fd_bn254_fp6_t a0b0[1], a1b1[1], sa[1];
+  fd_bn254_fp2_t sb[1];
+
+  /* a0b0 = a0 * c0 */
+  fd_bn254_fp2_mul( &a0b0->el[0], &a0->el[0], c0 );
+  fd_bn254_fp2_mul( &a0b0->el[1], &a0->el[1], c0 );
+  fd_bn254_fp2_mul( &a0b0->el[2], &a0->el[2], c0 );
+  /* a1b1 = a1 * (c3 + c4 v) */
+  fd_bn254_fp6_mul_by_01( a1b1, a1, c3, c4 );
+
+  /* r1 = (a0 + a1) * (c0 + c3 + c4 v) - a0b0 - a1b1 */
+  fd_bn254_fp6_add( sa, a0, a1 );
+  fd_bn254_fp2_add( sb, c0, c3 );
+  fd_bn254_fp6_mul_by_01( &r->el[1], sa, sb, c4 );
+  fd_bn254_fp6_sub( &r->el[1], &r->el[1], a0b0 );
+  fd_bn254_fp6_sub( &r->el[1], &r->el[1], a1b1 );
+
+  /* r0 = a0b0 + gamma * a1b1 */
+  fd_bn254_fp6_mul_by_gamma( a1b1, a1b1 );
+  fd_bn254_fp6_add( &r->el[0], a0b0, a1b1 );
+  return r;
+}
+
 static inline fd_bn254_fp12_t *
 fd_bn254_fp12_sqr( fd_bn254_fp12_t * r,
                         fd_bn254_fp12_t const * a ) {
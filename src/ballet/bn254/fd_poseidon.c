@@ -1,6 +1,10 @@
 #include "./fd_poseidon.h"
 #include "fd_poseidon_params.c"
 
+#if FD_HAS_AVX512
+#include "avx512/fd_r52x5.h"
+#endif
+
 /* Poseidon internals */
 
 static inline void
@@ -74,6 +78,132 @@ fd_poseidon_get_params( fd_poseidon_par_t * params,
 #undef FD_POSEIDON_GET_PARAMS
 }
 
+static const ulong fd_poseidon_partial_rounds[] = { 56, 57, 56, 60, 60, 63, 64, 63, 60, 66, 60, 65, 70, 60, 64, 68 };
+
+#define FD_POSEIDON_FULL_ROUNDS (8UL)
+
+static void
+fd_poseidon_permute( fd_bn254_scalar_t         state[],
+                     ulong const               width,
+                     fd_poseidon_par_t const * params ) {
+  const ulong partial_rounds = fd_poseidon_partial_rounds[ width-2 ];
+  const ulong half_rounds = FD_POSEIDON_FULL_ROUNDS / 2;
+  const ulong all_rounds = FD_POSEIDON_FULL_ROUNDS + partial_rounds;
+
+  ulong round=0;
+  for (; round<half_rounds; round++ ) {
+    fd_poseidon_apply_ark         ( state, width, params, round );
+    fd_poseidon_apply_sbox_full   ( state, width );
+    fd_poseidon_apply_mds         ( state, width, params );
+  }
+
+  for (; round<half_rounds+partial_rounds; round++ ) {
+    fd_poseidon_apply_ark         ( state, width, params, round );
+    fd_poseidon_apply_sbox_partial( state );
+    fd_poseidon_apply_mds         ( state, width, params );
+  }
+
+  for (; round<all_rounds; round++ ) {
+    fd_poseidon_apply_ark         ( state, width, params, round );
+    fd_poseidon_apply_sbox_full   ( state, width );
+    fd_poseidon_apply_mds         ( state, width, params );
+  }
+}
+
+#if FD_HAS_AVX512
+
+/* fd_poseidon_permute8 is fd_poseidon_permute on 8 states at a time,
+   one per SIMD lane.  mds is params->mds converted to 52-bit limbs. */
+
+static void
+fd_poseidon_permute8( fd_r52x5_t                state[],
+                      ulong const               width,
+                      fd_poseidon_par_t const * params,
+                      long const                mds[][5] ) {
+  fd_r52x5_mod_t const * mod = fd_r52x5_bn254_r;
+
+  const ulong partial_rounds = fd_poseidon_partial_rounds[ width-2 ];
+  const ulong half_rounds = FD_POSEIDON_FULL_ROUNDS / 2;
+  const ulong all_rounds = FD_POSEIDON_FULL_ROUNDS + partial_rounds;
+
+  for( ulong round=0; round<all_rounds; round++ ) {
+    /* ark */
+    for( ulong i=0; i<width; i++ ) {
+      long c[5]; fd_r52x5_t t[1];
+      fd_r52x5_bcast( t, fd_r52x5_limbs( c, &params->ark[ round * width + i ] ) );
+      fd_r52x5_add( &state[i], &state[i], t, mod );
+    }
+
+    /* sbox, s^5 */
+    int is_full = round<half_rounds || round>=half_rounds+partial_rounds;
+    for( ulong i=0; i<(is_full ? width : 1UL); i++ ) {
+      fd_r52x5_t t[1];
+      fd_r52x5_sqr( t, &state[i], mod );
+      fd_r52x5_sqr( t, t, mod );
+      fd_r52x5_mul( &state[i], &state[i], t, mod );
+    }
+
+    /* mds */
+    fd_r52x5_t x[FD_POSEIDON_MAX_WIDTH+1];
+    for( ulong i=0; i<width; i++ ) {
+      fd_r52x5_zero( &x[i] );
+      for( ulong j=0; j<width; j++ ) {
+        fd_r52x5_t t[1];
+        fd_r52x5_mul( t, &state[j], fd_r52x5_bcast( t, mds[ i * width + j ] ), mod );
+        fd_r52x5_add( &x[i], &x[i], t, mod );
+      }
+    }
+    for( ulong i=0; i<width; i++ ) {
+      state[i] = x[i];
+    }
+  }
+}
+
+#endif
+
+/* fd_poseidon_parse converts the sz bytes pointed to by data into the
+   scalar r, in Montgomery form.  Returns r on success, NULL if data is
+   empty, too long or not a valid field element. */
+
+static fd_bn254_scalar_t *
+fd_poseidon_parse( fd_bn254_scalar_t * r,
+                   uchar const *       data,
+                   ulong               sz,
+                   int const           big_endian ) {
+  /* Empty input and non-field are errors. Short element is extended with 0s. */
+  if( FD_UNLIKELY( sz==0 || sz>32UL ) ) {
+    return NULL;
+  }
+
+  /* Handle endianness */
+  fd_bn254_scalar_t cur[1] = { 0 };
+  fd_memcpy( cur->buf + (32-sz)*(big_endian?1:0), data, sz );
+  if( big_endian ) {
+    fd_uint256_bswap( cur, cur );
+  }
+
+  if( FD_UNLIKELY( !fd_bn254_scalar_validate( cur ) ) ) {
+    return NULL;
+  }
+  return fd_bn254_scalar_to_mont( r, cur );
+}
+
+/* fd_poseidon_output converts the Montgomery scalar s into the 32-byte
+   hash output. */
+
+static uchar *
+fd_poseidon_output( uchar                     hash[ FD_POSEIDON_HASH_SZ ],
+                    fd_bn254_scalar_t const * s,
+                    int const                 big_endian ) {
+  fd_bn254_scalar_t scalar_hash[1];
+  fd_bn254_scalar_from_mont( scalar_hash, s );
+  if( big_endian ) {
+    fd_uint256_bswap( scalar_hash, scalar_hash );
+  }
+  fd_memcpy( hash, scalar_hash, 32 );
+  return hash;
+}
+
 /* Poseidon interface */
 
 fd_poseidon_t *
@@ -98,23 +228,10 @@ fd_poseidon_append( fd_poseidon_t * pos,
   if( FD_UNLIKELY( pos->cnt >= FD_POSEIDON_MAX_WIDTH ) ) {
     return NULL;
   }
-  /* Empty input and non-field are errors. Short element is extended with 0s. */
-  if( FD_UNLIKELY( sz==0 || sz>32UL ) ) {
-    return NULL;
-  }
-
-  /* Handle endianness */
-  fd_bn254_scalar_t cur[1] = { 0 };
-  fd_memcpy( cur->buf + (32-sz)*(pos->big_endian?1:0), data, sz );
-  if( pos->big_endian ) {
-    fd_uint256_bswap( cur, cur );
-  }
-
-  if( FD_UNLIKELY( !fd_bn254_scalar_validate( cur ) ) ) {
+  if( FD_UNLIKELY( !fd_poseidon_parse( &pos->state[ pos->cnt+1 ], data, sz, pos->big_endian ) ) ) {
     return NULL;
   }
   pos->cnt++;
-  fd_bn254_scalar_to_mont( &pos->state[ pos->cnt ], cur );
 
   return pos;
 }
@@ -135,37 +252,74 @@ fd_poseidon_fini( fd_poseidon_t * pos,
     return NULL;
   }
 
-  const ulong PARTIAL_ROUNDS[] = { 56, 57, 56, 60, 60, 63, 64, 63, 60, 66, 60, 65, 70, 60, 64, 68 };
-  const ulong partial_rounds = PARTIAL_ROUNDS[ pos->cnt-1 ];
-  const ulong full_rounds = 8;
-  const ulong half_rounds = full_rounds / 2;
-  const ulong all_rounds = full_rounds + partial_rounds;
+  fd_poseidon_permute( pos->state, width, params );
 
-  ulong round=0;
-  for (; round<half_rounds; round++ ) {
-    fd_poseidon_apply_ark         ( pos->state, width, params, round );
-    fd_poseidon_apply_sbox_full   ( pos->state, width );
-    fd_poseidon_apply_mds         ( pos->state, width, params );
-  }
+  return fd_poseidon_output( hash, &pos->state[0], pos->big_endian );
+}
 
-  for (; round<half_rounds+partial_rounds; round++ ) {
-    fd_poseidon_apply_ark         ( pos->state, width, params, round );
-    fd_poseidon_apply_sbox_partial( pos->state );
-    fd_poseidon_apply_mds         ( pos->state, width, params );
+int
+fd_poseidon_hash_batch( fd_poseidon_hash_result_t * results,
+                        uchar const *               inputs,
+                        ulong                       elem_cnt,
+                        ulong                       batch_cnt,
+                        int const                   big_endian ) {
+  if( FD_UNLIKELY( !elem_cnt || elem_cnt>FD_POSEIDON_MAX_WIDTH ) ) {
+    return 1;
+  }
+  const ulong width = elem_cnt+1;
+  fd_poseidon_par_t params[1] = { 0 };
+  fd_poseidon_get_params( params, width );
+  if( FD_UNLIKELY( !params->ark || !params->mds ) ) {
+    return 1;
   }
 
-  for (; round<all_rounds; round++ ) {
-    fd_poseidon_apply_ark         ( pos->state, width, params, round );
-    fd_poseidon_apply_sbox_full   ( pos->state, width );
-    fd_poseidon_apply_mds         ( pos->state, width, params );
+#if FD_HAS_AVX512
+  long mds[ (FD_POSEIDON_MAX_WIDTH+1)*(FD_POSEIDON_MAX_WIDTH+1) ][5];
+  for( ulong i=0; i<width*width; i++ ) {
+    fd_r52x5_limbs( mds[i], &params->mds[i] );
   }
 
-  /* Directly convert scalar into return hash buffer - hash MUST be FD_UINT256_ALIGNED */
-  fd_bn254_scalar_t scalar_hash[1];
-  fd_bn254_scalar_from_mont( scalar_hash, &pos->state[0] );
-  if( pos->big_endian ) {
-    fd_uint256_bswap( scalar_hash, scalar_hash );
+  for( ulong j=0; j<batch_cnt; j+=8 ) {
+    ulong lane_cnt = fd_ulong_min( batch_cnt-j, 8UL );
+
+    /* Unused lanes hash zeros */
+    fd_bn254_scalar_t st[ FD_POSEIDON_MAX_WIDTH+1 ][ 8 ] = { 0 };
+    for( ulong lane=0; lane<lane_cnt; lane++ ) {
+      uchar const * in = inputs + (j+lane)*elem_cnt*32UL;
+      for( ulong k=0; k<elem_cnt; k++ ) {
+        if( FD_UNLIKELY( !fd_poseidon_parse( &st[k+1][lane], in + k*32UL, 32UL, big_endian ) ) ) {
+          return 1;
+        }
+      }
+    }
+
+    fd_r52x5_t state[ FD_POSEIDON_MAX_WIDTH+1 ];
+    for( ulong k=0; k<width; k++ ) {
+      fd_uint256_t const * ld[8] = { &st[k][0], &st[k][1], &st[k][2], &st[k][3], &st[k][4], &st[k][5], &st[k][6], &st[k][7] };
+      fd_r52x5_ld( &state[k], ld );
+    }
+
+    fd_poseidon_permute8( state, width, params, (long const (*)[5])mds );
+
+    fd_uint256_t * st0[8] = { &st[0][0], &st[0][1], &st[0][2], &st[0][3], &st[0][4], &st[0][5], &st[0][6], &st[0][7] };
+    fd_r52x5_st( st0, &state[0] );
+    for( ulong lane=0; lane<lane_cnt; lane++ ) {
+      fd_poseidon_output( results[j+lane].v, &st[0][lane], big_endian );
+    }
   }
-  fd_memcpy( hash, scalar_hash, 32 );
-  return hash;
+#else
+  for( ulong j=0; j<batch_cnt; j++ ) {
+    fd_bn254_scalar_t state[ FD_POSEIDON_MAX_WIDTH+1 ] = { 0 };
+    uchar const * in = inputs + j*elem_cnt*32UL;
+    for( ulong k=0; k<elem_cnt; k++ ) {
+      if( FD_UNLIKELY( !fd_poseidon_parse( &state[k+1], in + k*32UL, 32UL, big_endian ) ) ) {
+        return 1;
+      }
+    }
+    fd_poseidon_permute( state, width, params );
+    fd_poseidon_output( results[j].v, &state[0], big_endian );
+  }
+#endif
+
+  return 0;
 }
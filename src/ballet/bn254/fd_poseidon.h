@@ -104,6 +104,25 @@ fd_poseidon_hash( fd_poseidon_hash_result_t * result,
   return !fd_poseidon_fini( pos, fd_type_pun(result) );
 }
 
+/* fd_poseidon_hash_batch computes batch_cnt independent Poseidon hashes
+   of elem_cnt 32-byte field elements each.  inputs points to the first
+   byte of batch_cnt*elem_cnt*32 contiguous bytes, the k-th element of
+   the j-th hash being at inputs + (j*elem_cnt+k)*32.  On success, the
+   j-th hash is stored in results[j] and 0 is returned.  Returns 1 if
+   elem_cnt is 0 or more than FD_POSEIDON_MAX_WIDTH, or if any element is
+   not a valid field element, in which case the content of results is
+   undefined.  On targets with AVX-512, 8 hashes are computed at a time,
+   one per SIMD lane, so callers hashing many same-width inputs (e.g. a
+   tx with many Poseidon syscalls, or Merkle tree levels) should prefer
+   this to repeated calls to fd_poseidon_hash. */
+
+int
+fd_poseidon_hash_batch( fd_poseidon_hash_result_t * results,
+                        uchar const *               inputs,
+                        ulong                       elem_cnt,
+                        ulong                       batch_cnt,
+                        int const                   big_endian );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_ballet_bn254_fd_poseidon_h */
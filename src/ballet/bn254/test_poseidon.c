@@ -249,6 +249,58 @@ int main( int     argc,
     }
   }
 
+  /* batch */
+  {
+    fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+
+#   define BATCH_MAX (64UL)
+    static uchar                     in  [ BATCH_MAX*FD_POSEIDON_MAX_WIDTH*32UL ];
+    static fd_poseidon_hash_result_t res [ BATCH_MAX ];
+    for( ulong i=0; i<sizeof(in); i++ ) in[i] = fd_rng_uchar( rng );
+    /* ensure all elements are < modulus in both endiannesses */
+    for( ulong i=0; i<sizeof(in); i+=32 ) { in[i] &= 0x1f; in[i+31] &= 0x1f; }
+
+    static const ulong BATCH_CNT[] = { 1, 7, 8, 9, 19, BATCH_MAX };
+    for( ulong elem_cnt=1; elem_cnt<=FD_POSEIDON_MAX_WIDTH; elem_cnt++ ) {
+      for( ulong b=0; b<sizeof(BATCH_CNT)/sizeof(ulong); b++ ) {
+        for( int big_endian=0; big_endian<2; big_endian++ ) {
+          ulong batch_cnt = BATCH_CNT[b];
+          FD_TEST( fd_poseidon_hash_batch( res, in, elem_cnt, batch_cnt, big_endian )==0 );
+          for( ulong j=0; j<batch_cnt; j++ ) {
+            fd_poseidon_hash_result_t exp;
+            FD_TEST( fd_poseidon_hash( &exp, in + j*elem_cnt*32UL, elem_cnt*32UL, big_endian )==0 );
+            FD_TEST( !memcmp( res[j].v, exp.v, FD_POSEIDON_HASH_SZ ) );
+          }
+        }
+      }
+    }
+
+    /* errors */
+    FD_TEST( fd_poseidon_hash_batch( res, in, 0,                         4, 1 )==1 );
+    FD_TEST( fd_poseidon_hash_batch( res, in, FD_POSEIDON_MAX_WIDTH+1UL, 4, 1 )==1 );
+    uchar bad[ 9*2*32 ];
+    fd_memcpy( bad, in, sizeof(bad) );
+    memset( bad + 8*2*32 + 32, 0xff, 32 ); /* second element of the last hash >= modulus */
+    FD_TEST( fd_poseidon_hash_batch( res, bad, 2, 9, 1 )==1 );
+    FD_TEST( fd_poseidon_hash_batch( res, bad, 2, 8, 1 )==0 );
+
+    /* benchmark */
+    char cstr[128];
+    ulong iter = 100UL;
+    for( ulong j=1; j<=12; j*=2 ) {
+      long dt = fd_log_wallclock();
+      for( ulong rem=iter; rem; rem-- ) {
+        fd_poseidon_hash_batch( res, in, j, BATCH_MAX, 1 );
+      }
+      dt = fd_log_wallclock() - dt;
+      log_bench( fd_cstr_printf( cstr, 128UL, NULL,"fd_poseidon_hash_batch(%lu)", j), iter*BATCH_MAX, dt );
+      if( j==4 ) j=3; /* mini-hack to get 1, 2, 4, 6, 12 */
+    }
+#   undef BATCH_MAX
+
+    fd_rng_delete( fd_rng_leave( rng ) );
+  }
+
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
   return 0;
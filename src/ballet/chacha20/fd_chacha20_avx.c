@@ -14,48 +14,18 @@ wu_rol8( wu_t x ) {
   return _mm256_shuffle_epi8( x, mask );
 }
 
-void
-fd_chacha20rng_refill_avx( fd_chacha20rng_t * rng ) {
-
-  /* This function should only be called if the buffer is empty. */
-  assert( rng->buf_off == rng->buf_fill );
-
-  wu_t iv0  = wu_bcast( 0x61707865U );
-  wu_t iv1  = wu_bcast( 0x3320646eU );
-  wu_t iv2  = wu_bcast( 0x79622d32U );
-  wu_t iv3  = wu_bcast( 0x6b206574U );
-  wb_t key  = wb_ld( rng->key );
-  wu_t zero = wu_zero();
-
-  /* Unpack key equivalent to:
-
-       c4 = wu_bcast( (uint const *)(rng->key)[0] );
-       c5 = wu_bcast( (uint const *)(rng->key)[1] );
-       ...
-       cB = wu_bcast( (uint const *)(rng->key)[7] ); */
-
-  wu_t key_lo = _mm256_permute2x128_si256( key, key, 0x00 );  /* [0,1,2,3,0,1,2,3] */
-  wu_t key_hi = _mm256_permute2x128_si256( key, key, 0x11 );  /* [4,5,6,7,4,5,6,7] */
-  wu_t k0 = _mm256_shuffle_epi32( key_lo, 0x00 );
-  wu_t k1 = _mm256_shuffle_epi32( key_lo, 0x55 );
-  wu_t k2 = _mm256_shuffle_epi32( key_lo, 0xaa );
-  wu_t k3 = _mm256_shuffle_epi32( key_lo, 0xff );
-  wu_t k4 = _mm256_shuffle_epi32( key_hi, 0x00 );
-  wu_t k5 = _mm256_shuffle_epi32( key_hi, 0x55 );
-  wu_t k6 = _mm256_shuffle_epi32( key_hi, 0xaa );
-  wu_t k7 = _mm256_shuffle_epi32( key_hi, 0xff );
-
-  /* Derive block index */
-
-  ulong idx = rng->buf_fill / FD_CHACHA20_BLOCK_SZ;  /* really a right shift */
-  wu_t idxs = wu_add( wu_bcast( idx ), wu( 0, 1, 2, 3, 4, 5, 6, 7 ) );
-
-  /* Run through the round function */
-
-  wu_t c0 = iv0;   wu_t c1 = iv1;   wu_t c2 = iv2;   wu_t c3 = iv3;
-  wu_t c4 = k0;    wu_t c5 = k1;    wu_t c6 = k2;    wu_t c7 = k3;
-  wu_t c8 = k4;    wu_t c9 = k5;    wu_t cA = k6;    wu_t cB = k7;
-  wu_t cC = idxs;  wu_t cD = zero;  wu_t cE = zero;  wu_t cF = zero;
+/* fd_chacha20_avx_core runs the ChaCha20 block function on 8
+   independent states at once, one per lane.  c holds the input state
+   on entry and the output block words (state after the rounds plus the
+   input state) on return.  Word i of the block computed by lane j is
+   lane j of c[i]. */
+
+static inline __attribute__((always_inline)) void
+fd_chacha20_avx_core( wu_t c[ 16 ] ) {
+  wu_t c0 = c[ 0x0 ];  wu_t c1 = c[ 0x1 ];  wu_t c2 = c[ 0x2 ];  wu_t c3 = c[ 0x3 ];
+  wu_t c4 = c[ 0x4 ];  wu_t c5 = c[ 0x5 ];  wu_t c6 = c[ 0x6 ];  wu_t c7 = c[ 0x7 ];
+  wu_t c8 = c[ 0x8 ];  wu_t c9 = c[ 0x9 ];  wu_t cA = c[ 0xA ];  wu_t cB = c[ 0xB ];
+  wu_t cC = c[ 0xC ];  wu_t cD = c[ 0xD ];  wu_t cE = c[ 0xE ];  wu_t cF = c[ 0xF ];
 
 # define QUARTER_ROUND(a,b,c,d)                                        \
   do {                                                                 \
@@ -79,43 +49,124 @@ fd_chacha20rng_refill_avx( fd_chacha20rng_t * rng ) {
 
   /* Finalize */
 
-  c0 = wu_add( c0, iv0  );
-  c1 = wu_add( c1, iv1  );
-  c2 = wu_add( c2, iv2  );
-  c3 = wu_add( c3, iv3  );
-  c4 = wu_add( c4, k0   );
-  c5 = wu_add( c5, k1   );
-  c6 = wu_add( c6, k2   );
-  c7 = wu_add( c7, k3   );
-  c8 = wu_add( c8, k4   );
-  c9 = wu_add( c9, k5   );
-  cA = wu_add( cA, k6   );
-  cB = wu_add( cB, k7   );
-  cC = wu_add( cC, idxs );
-  //cD = wu_add( cD, zero );
-  //cE = wu_add( cE, zero );
-  //cF = wu_add( cF, zero );
-
-  /* Transpose matrix to get output vector */
-
-  wu_transpose_8x8( c0, c1, c2, c3, c4, c5, c6, c7,
-                    c0, c1, c2, c3, c4, c5, c6, c7 );
-  wu_transpose_8x8( c8, c9, cA, cB, cC, cD, cE, cF,
-                    c8, c9, cA, cB, cC, cD, cE, cF );
-
-  /* Update ring buffer */
-
-  uint * out = (uint *)rng->buf;
-  wu_st( out+0x00, c0 ); wu_st( out+0x08, c8 );
-  wu_st( out+0x10, c1 ); wu_st( out+0x18, c9 );
-  wu_st( out+0x20, c2 ); wu_st( out+0x28, cA );
-  wu_st( out+0x30, c3 ); wu_st( out+0x38, cB );
-  wu_st( out+0x40, c4 ); wu_st( out+0x48, cC );
-  wu_st( out+0x50, c5 ); wu_st( out+0x58, cD );
-  wu_st( out+0x60, c6 ); wu_st( out+0x68, cE );
-  wu_st( out+0x70, c7 ); wu_st( out+0x78, cF );
+  c[ 0x0 ] = wu_add( c0, c[ 0x0 ] );  c[ 0x1 ] = wu_add( c1, c[ 0x1 ] );
+  c[ 0x2 ] = wu_add( c2, c[ 0x2 ] );  c[ 0x3 ] = wu_add( c3, c[ 0x3 ] );
+  c[ 0x4 ] = wu_add( c4, c[ 0x4 ] );  c[ 0x5 ] = wu_add( c5, c[ 0x5 ] );
+  c[ 0x6 ] = wu_add( c6, c[ 0x6 ] );  c[ 0x7 ] = wu_add( c7, c[ 0x7 ] );
+  c[ 0x8 ] = wu_add( c8, c[ 0x8 ] );  c[ 0x9 ] = wu_add( c9, c[ 0x9 ] );
+  c[ 0xA ] = wu_add( cA, c[ 0xA ] );  c[ 0xB ] = wu_add( cB, c[ 0xB ] );
+  c[ 0xC ] = wu_add( cC, c[ 0xC ] );  c[ 0xD ] = wu_add( cD, c[ 0xD ] );
+  c[ 0xE ] = wu_add( cE, c[ 0xE ] );  c[ 0xF ] = wu_add( cF, c[ 0xF ] );
+
+  /* Transpose matrix so that c[j] holds words [0,8) and c[8+j] holds
+     words [8,16) of the block computed by lane j. */
+
+  wu_transpose_8x8( c[ 0x0 ], c[ 0x1 ], c[ 0x2 ], c[ 0x3 ], c[ 0x4 ], c[ 0x5 ], c[ 0x6 ], c[ 0x7 ],
+                    c[ 0x0 ], c[ 0x1 ], c[ 0x2 ], c[ 0x3 ], c[ 0x4 ], c[ 0x5 ], c[ 0x6 ], c[ 0x7 ] );
+  wu_transpose_8x8( c[ 0x8 ], c[ 0x9 ], c[ 0xA ], c[ 0xB ], c[ 0xC ], c[ 0xD ], c[ 0xE ], c[ 0xF ],
+                    c[ 0x8 ], c[ 0x9 ], c[ 0xA ], c[ 0xB ], c[ 0xC ], c[ 0xD ], c[ 0xE ], c[ 0xF ] );
+}
+
+void
+fd_chacha20rng_refill_avx( fd_chacha20rng_t * rng ) {
+
+  /* This function should only be called if the buffer is empty. */
+  assert( rng->buf_off == rng->buf_fill );
+
+  wb_t key  = wb_ld( rng->key );
+
+  /* Unpack key equivalent to:
+
+       c4 = wu_bcast( (uint const *)(rng->key)[0] );
+       c5 = wu_bcast( (uint const *)(rng->key)[1] );
+       ...
+       cB = wu_bcast( (uint const *)(rng->key)[7] ); */
+
+  wu_t key_lo = _mm256_permute2x128_si256( key, key, 0x00 );  /* [0,1,2,3,0,1,2,3] */
+  wu_t key_hi = _mm256_permute2x128_si256( key, key, 0x11 );  /* [4,5,6,7,4,5,6,7] */
+
+  /* Derive block index */
+
+  ulong idx = rng->buf_fill / FD_CHACHA20_BLOCK_SZ;  /* really a right shift */
+
+  wu_t c[ 16 ];
+  c[ 0x0 ] = wu_bcast( 0x61707865U );
+  c[ 0x1 ] = wu_bcast( 0x3320646eU );
+  c[ 0x2 ] = wu_bcast( 0x79622d32U );
+  c[ 0x3 ] = wu_bcast( 0x6b206574U );
+  c[ 0x4 ] = _mm256_shuffle_epi32( key_lo, 0x00 );
+  c[ 0x5 ] = _mm256_shuffle_epi32( key_lo, 0x55 );
+  c[ 0x6 ] = _mm256_shuffle_epi32( key_lo, 0xaa );
+  c[ 0x7 ] = _mm256_shuffle_epi32( key_lo, 0xff );
+  c[ 0x8 ] = _mm256_shuffle_epi32( key_hi, 0x00 );
+  c[ 0x9 ] = _mm256_shuffle_epi32( key_hi, 0x55 );
+  c[ 0xA ] = _mm256_shuffle_epi32( key_hi, 0xaa );
+  c[ 0xB ] = _mm256_shuffle_epi32( key_hi, 0xff );
+  c[ 0xC ] = wu_add( wu_bcast( (uint)idx ), wu( 0, 1, 2, 3, 4, 5, 6, 7 ) );
+  c[ 0xD ] = wu_zero();
+  c[ 0xE ] = wu_zero();
+  c[ 0xF ] = wu_zero();
+
+  fd_chacha20_avx_core( c );
+
+  /* Update ring buffer.  The buffer is usually empty at a multiple of
+     its size, but it need not be (e.g. after
+     fd_chacha20rng_init_prefilled), so the 8 blocks are written
+     starting at the current fill position and wrap around. */
+
+  for( ulong j=0UL; j<8UL; j++ ) {
+    uint * out = (uint *)( rng->buf + ( (rng->buf_fill + j*FD_CHACHA20_BLOCK_SZ) % FD_CHACHA20RNG_BUFSZ ) );
+    wu_st( out,     c[ j     ] );
+    wu_st( out+8UL, c[ j+8UL ] );
+  }
 
   /* Update ring descriptor */
 
   rng->buf_fill += 8*FD_CHACHA20_BLOCK_SZ;
 }
+
+void
+fd_chacha20rng_first_block_batch( uchar       (* block)[ FD_CHACHA20_BLOCK_SZ ],
+                                  uchar const (* key  )[ FD_CHACHA20_KEY_SZ   ],
+                                  ulong          cnt ) {
+  for( ulong i=0UL; i<cnt; i+=8UL ) {
+    ulong lane_cnt = fd_ulong_min( cnt-i, 8UL );
+
+    /* Gather the keys of this batch, padding a partial batch with
+       zero keys whose output is discarded. */
+
+    uchar _key[ 8 ][ FD_CHACHA20_KEY_SZ ] __attribute__((aligned(32)));
+    uchar const (* k)[ FD_CHACHA20_KEY_SZ ] = key+i;
+    if( FD_UNLIKELY( lane_cnt<8UL ) ) {
+      memset( _key, 0, sizeof(_key) );
+      memcpy( _key, key+i, lane_cnt*FD_CHACHA20_KEY_SZ );
+      k = (uchar const (*)[ FD_CHACHA20_KEY_SZ ])_key;
+    }
+
+    /* Transpose the keys so that c[4+w] holds word w of every lane's
+       key. */
+
+    wu_t c[ 16 ];
+    c[ 0x0 ] = wu_bcast( 0x61707865U );
+    c[ 0x1 ] = wu_bcast( 0x3320646eU );
+    c[ 0x2 ] = wu_bcast( 0x79622d32U );
+    c[ 0x3 ] = wu_bcast( 0x6b206574U );
+    wu_t r0 = wu_ldu( k[ 0 ] );  wu_t r1 = wu_ldu( k[ 1 ] );
+    wu_t r2 = wu_ldu( k[ 2 ] );  wu_t r3 = wu_ldu( k[ 3 ] );
+    wu_t r4 = wu_ldu( k[ 4 ] );  wu_t r5 = wu_ldu( k[ 5 ] );
+    wu_t r6 = wu_ldu( k[ 6 ] );  wu_t r7 = wu_ldu( k[ 7 ] );
+    wu_transpose_8x8( r0, r1, r2, r3, r4, r5, r6, r7,
+                      c[ 0x4 ], c[ 0x5 ], c[ 0x6 ], c[ 0x7 ], c[ 0x8 ], c[ 0x9 ], c[ 0xA ], c[ 0xB ] );
+    c[ 0xC ] = wu_zero(); /* block index 0 */
+    c[ 0xD ] = wu_zero();
+    c[ 0xE ] = wu_zero();
+    c[ 0xF ] = wu_zero();
+
+    fd_chacha20_avx_core( c );
+
+    for( ulong j=0UL; j<lane_cnt; j++ ) {
+      wu_stu( block[ i+j ],       c[ j     ] );
+      wu_stu( block[ i+j ]+32UL,  c[ j+8UL ] );
+    }
+  }
+}
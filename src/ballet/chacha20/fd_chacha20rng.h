@@ -116,6 +116,29 @@ fd_chacha20rng_t *
 fd_chacha20rng_init( fd_chacha20rng_t * rng,
                      void const *       key );
 
+/* fd_chacha20rng_first_block_batch computes the first ChaCha20 block
+   of the RNG stream of each of cnt keys, i.e. the first 64 bytes that
+   fd_chacha20rng_init would buffer for that key.  key[i] is the key of
+   the i-th stream and the corresponding block is stored in block[i],
+   for i in [0,cnt).  On targets with AVX, 8 keys are processed at once
+   (one per lane), which is much cheaper than initializing one RNG per
+   key when only a few values are drawn from each stream.
+
+   fd_chacha20rng_init_prefilled is equivalent to fd_chacha20rng_init
+   but takes the first block of the stream of key (as produced by
+   fd_chacha20rng_first_block_batch) instead of computing it.  Further
+   blocks are computed on demand as usual.  Returns rng. */
+
+void
+fd_chacha20rng_first_block_batch( uchar       (* block)[ FD_CHACHA20_BLOCK_SZ ],
+                                  uchar const (* key  )[ FD_CHACHA20_KEY_SZ   ],
+                                  ulong          cnt );
+
+fd_chacha20rng_t *
+fd_chacha20rng_init_prefilled( fd_chacha20rng_t * rng,
+                               void const *       key,
+                               void const *       block );
+
 /* The refill function .  Not part of the public API. */
 
 void
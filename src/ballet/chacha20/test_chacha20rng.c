@@ -34,6 +34,53 @@ main( int     argc,
     fd_chacha20rng_ulong( rng );
   FD_TEST( fd_chacha20rng_ulong( rng )==0xf4682b7e28eae4a7UL );
 
+  /* Test that streams initialized from a batch of first blocks match
+     streams initialized from the key alone, including a partial batch
+     and the refills that follow the prefilled block. */
+
+  do {
+    uchar batch_key  [ 11 ][ FD_CHACHA20_KEY_SZ   ];
+    uchar batch_block[ 11 ][ FD_CHACHA20_BLOCK_SZ ];
+    for( ulong i=0UL; i<11UL; i++ ) for( ulong j=0UL; j<FD_CHACHA20_KEY_SZ; j++ ) batch_key[ i ][ j ] = (uchar)(i*37UL+j);
+    fd_chacha20rng_first_block_batch( batch_block, (uchar const (*)[ FD_CHACHA20_KEY_SZ ])batch_key, 11UL );
+
+    fd_chacha20rng_t _ref[1];
+    fd_chacha20rng_t * ref = fd_chacha20rng_join( fd_chacha20rng_new( _ref, FD_CHACHA20RNG_MODE_MOD ) );
+    for( ulong i=0UL; i<11UL; i++ ) {
+      FD_TEST( fd_chacha20rng_init          ( ref, batch_key[ i ]                   )==ref );
+      FD_TEST( fd_chacha20rng_init_prefilled( rng, batch_key[ i ], batch_block[ i ] )==rng );
+      for( ulong j=0UL; j<300UL; j++ ) FD_TEST( fd_chacha20rng_ulong( rng )==fd_chacha20rng_ulong( ref ) );
+    }
+    fd_chacha20rng_delete( fd_chacha20rng_leave( ref ) );
+
+    FD_TEST( fd_chacha20rng_init_prefilled( rng, key, batch_block[ 0 ] )==rng ); /* does not check the block */
+  } while(0);
+
+  do {
+    FD_LOG_NOTICE(( "Benchmarking fd_chacha20rng_first_block_batch" ));
+    uchar batch_key  [ 64 ][ FD_CHACHA20_KEY_SZ   ];
+    uchar batch_block[ 64 ][ FD_CHACHA20_BLOCK_SZ ];
+    for( ulong i=0UL; i<64UL; i++ ) for( ulong j=0UL; j<FD_CHACHA20_KEY_SZ; j++ ) batch_key[ i ][ j ] = (uchar)(i+j);
+
+    ulong iter = 100000UL;
+    long  dt   = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      batch_key[ 0 ][ 0 ]++;
+      fd_chacha20rng_first_block_batch( batch_block, (uchar const (*)[ FD_CHACHA20_KEY_SZ ])batch_key, 64UL );
+      FD_COMPILER_UNPREDICTABLE( batch_block[ 0 ][ 0 ] );
+    }
+    dt += fd_log_wallclock();
+    FD_LOG_NOTICE(( "  ~%6.3f ns / key (batched)", (double)dt / (double)(64UL*iter) ));
+
+    dt = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      batch_key[ 0 ][ 0 ]++;
+      for( ulong i=0UL; i<64UL; i++ ) fd_chacha20rng_init( rng, batch_key[ i ] );
+    }
+    dt += fd_log_wallclock();
+    FD_LOG_NOTICE(( "  ~%6.3f ns / key (fd_chacha20rng_init)", (double)dt / (double)(64UL*iter) ));
+  } while(0);
+
   do {
     FD_LOG_NOTICE(( "Benchmarking fd_chacha20rng_ulong" ));
     key[ 0 ]++;
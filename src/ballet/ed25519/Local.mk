@@ -5,6 +5,7 @@ $(call make-unit-test,test_ed25519,test_ed25519,fd_ballet fd_util)
 $(call make-unit-test,test_ed25519_signature_malleability,test_ed25519_signature_malleability,fd_ballet fd_util)
 $(call make-unit-test,test_x25519,test_x25519,fd_ballet fd_util)
 $(call make-unit-test,test_ristretto255,test_ristretto255,fd_ballet fd_util)
+$(call make-unit-test,bench_ristretto255,bench_ristretto255,fd_ballet fd_util)
 #$(call make-unit-test,fd_curve25519_tables,fd_curve25519_tables,fd_ballet fd_util)
 $(call run-unit-test,test_ed25519)
 $(call run-unit-test,test_ed25519_signature_malleability)
@@ -0,0 +1,105 @@
+#include <stdlib.h>
+
+#include "../fd_ballet.h"
+#include "fd_ristretto255.h"
+
+/* bench_ristretto255 compares Straus and Pippenger multi scalar
+   multiplication on random reduced scalars and random points, at the
+   sizes around the Pippenger threshold and up to the syscall limit.
+   The window size for Pippenger is picked by
+   fd_curve25519_msm_window_sz. */
+
+#define BENCH_ITER  (10000UL)
+#define BENCH_N     (512UL)
+
+/* ristretto255 base point, draft-irtf-cfrg-ristretto255-decaf448-08
+   Appendix A.1 */
+
+static uchar const base_point[32] =
+  "\xe2\xf2\xae\x0a\x6a\xbc\x4e\x71\xa8\x84\xa9\x61\xc5\x00\x51\x5f\x58\xe3\x0b\x6a\xa5\x82\xdd\x8d\xb6\xa6\x59\x45\xe0\x8d\x2d\x76";
+
+static void
+log_bench( char const * descr,
+           ulong        iter,
+           long         dt ) {
+  float khz = 1e6f *(float)iter/(float)dt;
+  float tau = (float)dt /(float)iter;
+  FD_LOG_NOTICE(( "%-31s %11.3fK/s/core %10.3f ns/call", descr, (double)khz, (double)tau ));
+}
+
+static uchar *
+fd_rng_b256( fd_rng_t * rng,
+             uchar *    r ) {
+  ulong * u = (ulong *)r;
+  u[0] = fd_rng_ulong( rng ); u[1] = fd_rng_ulong( rng ); u[2] = fd_rng_ulong( rng ); u[3] = fd_rng_ulong( rng );
+  return r;
+}
+
+/* msm_straus computes a MSM with Straus only, in batches below the
+   Pippenger threshold */
+
+static fd_ristretto255_point_t *
+msm_straus( fd_ristretto255_point_t *       r,
+            uchar const *                   n,
+            fd_ristretto255_point_t const * a,
+            ulong                           sz ) {
+  fd_ristretto255_point_t h[1];
+  fd_ristretto255_point_set_zero( r );
+  for( ulong i=0; i<sz; i+=FD_BALLET_CURVE25519_MSM_BATCH_SZ ) {
+    ulong batch_sz = fd_ulong_min( sz-i, FD_BALLET_CURVE25519_MSM_BATCH_SZ );
+    fd_ristretto255_multi_scalar_mul( h, n + 32*i, a + i, batch_sz );
+    fd_ristretto255_point_add( r, r, h );
+  }
+  return r;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_ristretto255_point_t _h[1]; fd_ristretto255_point_t * h = _h;
+  fd_ristretto255_point_t _b[1]; fd_ristretto255_point_t * b = _b;
+  FD_TEST( fd_ristretto255_point_decompress( b, base_point ) );
+
+  fd_ristretto255_point_t * f = aligned_alloc( alignof(fd_ristretto255_point_t), BENCH_N*sizeof(fd_ristretto255_point_t) );
+  FD_TEST( f );
+  uchar _a[BENCH_N][32]; uchar * a = (uchar *)_a;
+  for( ulong i=0; i<BENCH_N; i++ ) {
+    uchar k[32];
+    fd_rng_b256( rng, k ); k[31] &= 0x0f;
+    fd_ristretto255_scalar_mul( &f[i], k, b );
+    fd_rng_b256( rng, _a[i] ); _a[i][31] &= 0x0f;
+  }
+
+  ulong bench_szs[] = { 32, 128, 256, 512 };
+  for( ulong l=0; l<sizeof(bench_szs)/sizeof(ulong); l++ ) {
+    ulong sz   = bench_szs[l];
+    ulong iter = BENCH_ITER/sz;
+    char cstr[128];
+
+    long dt = fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      FD_COMPILER_FORGET( f ); FD_COMPILER_FORGET( a ); FD_COMPILER_FORGET( h );
+      msm_straus( h, a, f, sz );
+    }
+    dt = fd_log_wallclock() - dt;
+    log_bench( fd_cstr_printf( cstr, 128UL, NULL, "straus(%lu)", sz ), iter, dt );
+
+    dt = fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      FD_COMPILER_FORGET( f ); FD_COMPILER_FORGET( a ); FD_COMPILER_FORGET( h );
+      fd_ed25519_multi_scalar_mul_pippenger( h, a, f, sz );
+    }
+    dt = fd_log_wallclock() - dt;
+    log_bench( fd_cstr_printf( cstr, 128UL, NULL, "pippenger(%lu,c=%lu)", sz, fd_curve25519_msm_window_sz( sz ) ), iter, dt );
+  }
+
+  free( f );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
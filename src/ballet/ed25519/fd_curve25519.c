@@ -206,12 +206,163 @@ fd_ed25519_multi_scalar_mul_with_opts( fd_ed25519_point_t *     r,
   return r;
 }
 
+/*
+ * Pippenger
+ */
+
+FD_FN_CONST ulong
+fd_curve25519_msm_window_sz( ulong sz ) {
+  ulong best_c    = 4UL;
+  ulong best_cost = ULONG_MAX;
+  for( ulong c=4UL; c<=FD_BALLET_CURVE25519_MSM_PIPPENGER_WINDOW_MAX; c++ ) {
+    /* per window: 1 add per point into its bucket, plus 2 adds per
+       bucket for the running sum reduction */
+    ulong cost = ((255UL+c-1UL)/c) * ( sz + (1UL<<c) );
+    if( cost<best_cost ) { best_c = c; best_cost = cost; }
+  }
+  return best_c;
+}
+
+/* fd_ed25519_multi_scalar_mul_pippenger_batch computes a MSM of
+   sz<=FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ points.
+
+   Scalars are recoded into w signed digits of c bits each, in
+   [-2^(c-1),2^(c-1)), by computing m = n + sum_k 2^(kc+c-1) and taking
+   d_k = ((m>>kc) mod 2^c) - 2^(c-1).  For w*c >= b+2, where b is the bit
+   length of the largest scalar, m < 2^(wc) so no digit is lost.  Digit
+   d!=0 adds (or subtracts) the point into bucket |d|-1, so only
+   2^(c-1) buckets are needed per window.  Windows are processed from
+   the most significant one, accumulating into r with c dbl each
+   (Horner). */
+
+static fd_ed25519_point_t *
+fd_ed25519_multi_scalar_mul_pippenger_batch( fd_ed25519_point_t *     r,
+                                             uchar const              n[], /* sz * 32 */
+                                             fd_ed25519_point_t const a[], /* sz */
+                                             ulong const              sz ) {
+  fd_ed25519_point_t pre   [ FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ ];
+  ulong              m     [ FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ ][ 5 ];
+  fd_ed25519_point_t bucket[ 1UL<<(FD_BALLET_CURVE25519_MSM_PIPPENGER_WINDOW_MAX-1) ];
+  uchar              used  [ 1UL<<(FD_BALLET_CURVE25519_MSM_PIPPENGER_WINDOW_MAX-1) ];
+  fd_ed25519_point_t sum[1], acc[1], t[1];
+
+  fd_ed25519_point_set_zero( r );
+
+  /* Bit length of the largest scalar */
+  ulong nor[4] = { 0UL, 0UL, 0UL, 0UL };
+  for( ulong i=0UL; i<sz; i++ ) {
+    for( ulong j=0UL; j<4UL; j++ ) nor[j] |= fd_ulong_load_8_fast( n + 32UL*i + 8UL*j );
+  }
+  ulong b = 0UL;
+  for( ulong j=0UL; j<4UL; j++ ) if( nor[j] ) b = 64UL*j + (ulong)fd_ulong_find_msb( nor[j] ) + 1UL;
+  if( FD_UNLIKELY( !b ) ) return r;
+
+  ulong c    = fd_curve25519_msm_window_sz( sz );
+  ulong w    = (b+2UL+c-1UL) / c;
+  ulong half = 1UL<<(c-1UL);
+  ulong mask = (1UL<<c)-1UL;
+
+  /* h = sum_k 2^(kc+c-1) */
+  ulong h[5] = { 0UL, 0UL, 0UL, 0UL, 0UL };
+  for( ulong k=0UL; k<w; k++ ) {
+    ulong bit = k*c + c-1UL;
+    h[ bit>>6 ] |= 1UL<<(bit&63UL);
+  }
+
+  for( ulong i=0UL; i<sz; i++ ) {
+    ulong carry = 0UL;
+    for( ulong j=0UL; j<5UL; j++ ) {
+      ulong nj = j<4UL ? fd_ulong_load_8_fast( n + 32UL*i + 8UL*j ) : 0UL;
+      ulong s0 = nj + carry;
+      ulong c0 = (ulong)( s0<carry );
+      ulong s1 = s0 + h[j];
+      m[i][j]  = s1;
+      carry    = c0 | (ulong)( s1<s0 );
+    }
+
+    fd_ed25519_point_set( &pre[i], &a[i] );
+    fd_curve25519_into_precomputed( &pre[i] );
+  }
+
+  for( ulong k=w; k; k-- ) {
+    ulong off = (k-1UL)*c;
+    ulong idx = off>>6;
+    ulong sft = off&63UL;
+
+    if( k<w ) fd_ed25519_point_dbln( r, r, (int)c );
+
+    memset( used, 0, half );
+    for( ulong i=0UL; i<sz; i++ ) {
+      ulong u = m[i][idx] >> sft;
+      if( sft+c>64UL ) u |= m[i][idx+1UL] << (64UL-sft);
+      u &= mask;
+      if( u==half ) continue; /* digit 0 */
+
+      if( u>half ) {
+        ulong j = u-half-1UL;
+        if( !used[j] ) { fd_ed25519_point_set( &bucket[j], &a[i] ); used[j] = 1; }
+        else {
+          fd_ed25519_point_add_with_opts( t, &bucket[j], &pre[i], 0, 1, 1 );
+          fd_ed25519_point_add_final_mul( &bucket[j], t );
+        }
+      } else {
+        ulong j = half-u-1UL;
+        if( !used[j] ) { fd_ed25519_point_neg( &bucket[j], &a[i] ); used[j] = 1; }
+        else {
+          fd_ed25519_point_sub_with_opts( t, &bucket[j], &pre[i], 0, 1, 1 );
+          fd_ed25519_point_add_final_mul( &bucket[j], t );
+        }
+      }
+    }
+
+    /* window sum = sum_j (j+1) bucket[j], computed as a running sum
+       from the top bucket, skipping leading empty buckets */
+    ulong j = half;
+    while( j && !used[j-1UL] ) j--;
+    if( !j ) continue;
+    j--;
+    fd_ed25519_point_set( sum, &bucket[j] );
+    fd_ed25519_point_set( acc, &bucket[j] );
+    while( j ) {
+      j--;
+      if( used[j] ) fd_ed25519_point_add( sum, sum, &bucket[j] );
+      fd_ed25519_point_add( acc, acc, sum );
+    }
+    fd_ed25519_point_add( r, r, acc );
+  }
+
+  return r;
+}
+
+fd_ed25519_point_t *
+fd_ed25519_multi_scalar_mul_pippenger( fd_ed25519_point_t *     r,
+                                       uchar const              n[], /* sz * 32 */
+                                       fd_ed25519_point_t const a[], /* sz */
+                                       ulong const              sz ) {
+
+  fd_ed25519_point_t h[1];
+  fd_ed25519_point_set_zero( r );
+
+  for( ulong i=0; i<sz; i+=FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ ) {
+    ulong batch_sz = fd_ulong_min(sz-i, FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ);
+
+    fd_ed25519_multi_scalar_mul_pippenger_batch( h, &n[ 32*i ], &a[ i ], batch_sz );
+    fd_ed25519_point_add( r, r, h );
+  }
+
+  return r;
+}
+
 fd_ed25519_point_t *
 fd_ed25519_multi_scalar_mul( fd_ed25519_point_t *     r,
                              uchar const              n[], /* sz * 32 */
                              fd_ed25519_point_t const a[], /* sz */
                              ulong const              sz ) {
 
+  if( sz>=FD_BALLET_CURVE25519_MSM_PIPPENGER_MIN_SZ ) {
+    return fd_ed25519_multi_scalar_mul_pippenger( r, n, a, sz );
+  }
+
   fd_ed25519_point_t h[1];
   fd_ed25519_point_set_zero( r );
 
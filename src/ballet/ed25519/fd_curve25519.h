@@ -18,6 +18,16 @@
 /* Max batch size for MSM. */
 #define FD_BALLET_CURVE25519_MSM_BATCH_SZ 32
 
+/* MSMs of at least FD_BALLET_CURVE25519_MSM_PIPPENGER_MIN_SZ points use
+   Pippenger's bucket method instead of Straus, processing batches of up
+   to FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ points at a time (the
+   max number of points accepted by the curve multiscalar mul syscall).
+   The window size is picked per batch, up to
+   FD_BALLET_CURVE25519_MSM_PIPPENGER_WINDOW_MAX bits. */
+#define FD_BALLET_CURVE25519_MSM_PIPPENGER_MIN_SZ     64
+#define FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ   512
+#define FD_BALLET_CURVE25519_MSM_PIPPENGER_WINDOW_MAX 8
+
 /* curve constants. these are imported from table/fd_curve25519_table_{arch}.c.
    they are (re)defined here to avoid breaking compilation when the table needs
    to be rebuilt. */
@@ -161,13 +171,34 @@ fd_ed25519_double_scalar_mul_base( fd_ed25519_point_t *       r,
                                    uchar const                n2[ 32 ] );
 
 /* fd_ed25519_multi_scalar_mul computes r = n0 * a0 + n1 * a1 + ..., and returns r.
-   n is a vector of sz scalars. a is a vector of sz points. */
+   n is a vector of sz scalars. a is a vector of sz points.
+   Uses Straus for small sz and Pippenger for sz>=FD_BALLET_CURVE25519_MSM_PIPPENGER_MIN_SZ. */
 fd_ed25519_point_t *
 fd_ed25519_multi_scalar_mul( fd_ed25519_point_t *     r,
                              uchar const              n[], /* sz * 32 */
                              fd_ed25519_point_t const a[],  /* sz */
                              ulong const              sz );
 
+/* fd_ed25519_multi_scalar_mul_pippenger is like fd_ed25519_multi_scalar_mul
+   but always uses Pippenger's bucket method, for any sz.  Scalars are
+   recoded into signed c-bit digits so that only 2^(c-1) buckets per
+   window are needed, with c picked to minimize the number of point adds
+   (see fd_curve25519_msm_window_sz).  Cost per batch of sz points is
+   roughly ceil(b/c)*(sz + 2^c) adds + b dbl, where b is the bit length
+   of the largest scalar, vs sz*(b/5 + 8) adds + b dbl per 32 points for
+   Straus. */
+fd_ed25519_point_t *
+fd_ed25519_multi_scalar_mul_pippenger( fd_ed25519_point_t *     r,
+                                       uchar const              n[], /* sz * 32 */
+                                       fd_ed25519_point_t const a[],  /* sz */
+                                       ulong const              sz );
+
+/* fd_curve25519_msm_window_sz returns the Pippenger window size in bits,
+   in [4,FD_BALLET_CURVE25519_MSM_PIPPENGER_WINDOW_MAX], that minimizes
+   the estimated number of point adds for an MSM of sz points. */
+FD_FN_CONST ulong
+fd_curve25519_msm_window_sz( ulong sz );
+
 /* fd_ed25519_multi_scalar_mul computes r = n0 * B + n1 * a1 + ..., and returns r.
    n is a vector of sz scalars. a is a vector of sz points.
    the first point is ignored, and the base point is used instead. */
@@ -382,6 +382,24 @@ fd_rng_b256( fd_rng_t * rng,
   return r;
 }
 
+/* msm_straus computes a MSM with Straus only, in batches below the
+   Pippenger threshold */
+
+static fd_ristretto255_point_t *
+msm_straus( fd_ristretto255_point_t *       r,
+            uchar const *                   n,
+            fd_ristretto255_point_t const * a,
+            ulong                           sz ) {
+  fd_ristretto255_point_t h[1];
+  fd_ristretto255_point_set_zero( r );
+  for( ulong i=0; i<sz; i+=FD_BALLET_CURVE25519_MSM_BATCH_SZ ) {
+    ulong batch_sz = fd_ulong_min( sz-i, FD_BALLET_CURVE25519_MSM_BATCH_SZ );
+    fd_ristretto255_multi_scalar_mul( h, n + 32*i, a + i, batch_sz );
+    fd_ristretto255_point_add( r, r, h );
+  }
+  return r;
+}
+
 static void FD_FN_NO_ASAN
 test_multiscalar_mul( FD_FN_UNUSED fd_rng_t * rng ) {
   fd_ristretto255_point_t _h[1];       fd_ristretto255_point_t * h = _h;
@@ -464,6 +482,65 @@ test_multiscalar_mul( FD_FN_UNUSED fd_rng_t * rng ) {
     FD_TEST( fd_ristretto255_point_eq( h, t ) );
   }
 
+  /* Pippenger vs Straus, on random reduced scalars and random points */
+#undef MSM_N
+#define MSM_N 600
+  {
+    fd_ristretto255_point_t * f = aligned_alloc( alignof(fd_ristretto255_point_t), MSM_N * sizeof(fd_ristretto255_point_t) );
+    uchar _a[MSM_N][32]; uchar * a = (uchar *)_a;
+    fd_ristretto255_point_t _t[1]; fd_ristretto255_point_t * t = _t;
+
+    fd_ristretto255_point_t _b[1]; fd_ristretto255_point_t * b = _b;
+    fd_ristretto255_point_decompress( b, base_point_multiples[1] );
+    for( ulong i=0; i<MSM_N; i++ ) {
+      uchar k[32];
+      fd_rng_b256( rng, k ); k[31] &= 0x0f;
+      fd_ristretto255_scalar_mul( &f[i], k, b );
+      fd_rng_b256( rng, _a[i] );
+      _a[i][31] &= 0x0f;
+    }
+
+    ulong szs[] = { 1, 2, 31, 127, 128, 300, 512, 513, MSM_N };
+    for( ulong l=0; l<sizeof(szs)/sizeof(ulong); l++ ) {
+      ulong sz = szs[l];
+      FD_TEST( fd_ed25519_multi_scalar_mul_pippenger( h, a, f, sz )==h );
+      msm_straus( t, a, f, sz );
+      FD_TEST( fd_ristretto255_point_eq( h, t ) );
+      FD_TEST( fd_ristretto255_multi_scalar_mul( h, a, f, sz )==h );
+      FD_TEST( fd_ristretto255_point_eq( h, t ) );
+    }
+
+    /* Pippenger handles full 256-bit scalars, compare against Straus
+       on the same scalars reduced mod l */
+    uchar _n[MSM_N][32]; uchar * n = (uchar *)_n;
+    for( ulong i=0; i<MSM_N; i++ ) {
+      uchar wide[64] = {0};
+      fd_rng_b256( rng, _a[i] ); _a[i][31] |= 0x80;
+      memcpy( wide, _a[i], 32 );
+      fd_curve25519_scalar_reduce( _n[i], wide );
+    }
+    FD_TEST( fd_ed25519_multi_scalar_mul_pippenger( h, a, f, MSM_N )==h );
+    msm_straus( t, n, f, MSM_N );
+    FD_TEST( fd_ristretto255_point_eq( h, t ) );
+
+    /* small and zero scalars */
+    memset( a, 0, MSM_N*32 );
+    FD_TEST( fd_ed25519_multi_scalar_mul_pippenger( h, a, f, MSM_N )==h );
+    FD_TEST( fd_ed25519_point_is_zero( h ) );
+    _a[7][0] = 1; _a[300][0] = 3;
+    FD_TEST( fd_ed25519_multi_scalar_mul_pippenger( h, a, f, MSM_N )==h );
+    msm_straus( t, a, f, MSM_N );
+    FD_TEST( fd_ristretto255_point_eq( h, t ) );
+
+    for( ulong sz=1; sz<=4096; sz*=2 ) {
+      ulong c = fd_curve25519_msm_window_sz( sz );
+      FD_TEST( c>=4 && c<=FD_BALLET_CURVE25519_MSM_PIPPENGER_WINDOW_MAX );
+      FD_TEST( c>=fd_curve25519_msm_window_sz( sz/2 ) );
+    }
+
+    free( f );
+  }
+
   /* Benchmarks */
   ulong iter = 10000UL;
 
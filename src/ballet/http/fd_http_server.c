@@ -161,6 +161,7 @@ fd_http_server_new( void *                     shmem,
   http->max_request_len       = params.max_request_len;
   http->max_ws_recv_frame_len = params.max_ws_recv_frame_len;
   http->max_ws_send_frame_cnt = params.max_ws_send_frame_cnt;
+  http->reuse_port            = params.reuse_port;
 
   http->conns = conn_pool_join( conn_pool_new( conn_pool, params.max_connection_cnt ) );
   conn_treap_join( conn_treap_new( http->conn_treap, params.max_connection_cnt ) );
@@ -276,6 +277,9 @@ fd_http_server_listen( fd_http_server_t * http,
   if( FD_UNLIKELY( -1==setsockopt( sockfd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof( optval ) ) ) )
     FD_LOG_ERR(( "setsockopt failed (%i-%s)", errno, strerror( errno ) ));
 
+  if( FD_UNLIKELY( http->reuse_port && -1==setsockopt( sockfd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof( optval ) ) ) )
+    FD_LOG_ERR(( "setsockopt failed (%i-%s)", errno, strerror( errno ) ));
+
   struct sockaddr_in addr = {
     .sin_family      = AF_INET,
     .sin_port        = fd_ushort_bswap( port ),
@@ -83,6 +83,7 @@ struct fd_http_server_params {
   ulong max_ws_recv_frame_len; /* Maximum size of an incoming websocket frame from the client.  Must be >= max_request_len */
   ulong max_ws_send_frame_cnt; /* Maximum number of outgoing websocket frames that can be queued before the client is disconnected */
   ulong outgoing_buffer_sz;    /* Size of the outgoing data ring, which is used to stage outgoing HTTP response bodies and WebSocket frames */
+  int   reuse_port;            /* If non-zero, the listen socket is bound with SO_REUSEPORT, so several servers can listen on the same port with the kernel balancing new connections between them */
 };
 
 typedef struct fd_http_server_params fd_http_server_params_t;
@@ -1,6 +1,10 @@
 #include "fd_http_server.h"
 #include "fd_http_server_private.h"
 
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
 void
 test_oring( void ) {
   fd_http_server_params_t params = {
@@ -76,12 +80,48 @@ test_oring( void ) {
   FD_TEST( fd_http_server_stage_body( http, &response ) );
 }
 
+/* Several servers with reuse_port can listen on the same port */
+
+void
+test_reuse_port( void ) {
+  fd_http_server_params_t params = {
+    .max_connection_cnt    = 5UL,
+    .max_ws_connection_cnt = 0UL,
+    .max_request_len       = 1<<16,
+    .max_ws_recv_frame_len = 2048,
+    .max_ws_send_frame_cnt = 100,
+    .outgoing_buffer_sz    = 8UL,
+    .reuse_port            = 1,
+  };
+
+  fd_http_server_callbacks_t callbacks = { 0 };
+
+  static uchar scratch[ 2 ][ 329216 ] __attribute__((aligned(128UL)));
+  fd_http_server_t * http0 = fd_http_server_join( fd_http_server_new( scratch[ 0 ], params, callbacks, NULL ) );
+  fd_http_server_t * http1 = fd_http_server_join( fd_http_server_new( scratch[ 1 ], params, callbacks, NULL ) );
+
+  FD_TEST( fd_http_server_listen( http0, 0U, 0 )==http0 );
+  struct sockaddr_in addr;
+  socklen_t addr_len = sizeof(addr);
+  FD_TEST( !getsockname( fd_http_server_fd( http0 ), fd_type_pun( &addr ), &addr_len ) );
+  ushort port = fd_ushort_bswap( addr.sin_port );
+
+  FD_TEST( fd_http_server_listen( http1, 0U, port )==http1 );
+  addr_len = sizeof(addr);
+  FD_TEST( !getsockname( fd_http_server_fd( http1 ), fd_type_pun( &addr ), &addr_len ) );
+  FD_TEST( fd_ushort_bswap( addr.sin_port )==port );
+
+  FD_TEST( !close( fd_http_server_fd( http0 ) ) );
+  FD_TEST( !close( fd_http_server_fd( http1 ) ) );
+}
+
 int
 main( int     argc,
       char ** argv ) {
   fd_boot( &argc, &argv );
 
   test_oring();
+  test_reuse_port();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
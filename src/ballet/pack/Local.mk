@@ -1,6 +1,6 @@
 ifdef FD_HAS_DOUBLE
-$(call add-hdrs,fd_pack.h fd_est_tbl.h fd_compute_budget_program.h fd_microblock.h)
-$(call add-objs,fd_pack,fd_ballet)
+$(call add-hdrs,fd_pack.h fd_pack_part.h fd_est_tbl.h fd_compute_budget_program.h fd_microblock.h)
+$(call add-objs,fd_pack fd_pack_part,fd_ballet)
 $(call make-unit-test,test_compute_budget_program,test_compute_budget_program,fd_ballet fd_util)
 $(call make-unit-test,test_est_tbl,test_est_tbl,fd_ballet fd_util)
 $(call make-unit-test,test_pack_bitset,test_pack_bitset,fd_ballet fd_util)
@@ -14,6 +14,9 @@ $(call run-unit-test,test_tip_prog_blacklist)
 ifdef FD_HAS_HOSTED
 $(call make-fuzz-test,fuzz_compute_budget_program_parse,fuzz_compute_budget_program_parse,fd_ballet fd_util)
 $(call make-unit-test,test_pack,test_pack,fd_disco fd_ballet fd_util)
+$(call make-unit-test,test_pack_part,test_pack_part,fd_disco fd_ballet fd_util)
+$(call make-unit-test,bench_pack_part,bench_pack_part,fd_disco fd_ballet fd_util)
 $(call run-unit-test,test_pack)
+$(call run-unit-test,test_pack_part)
 endif
 endif
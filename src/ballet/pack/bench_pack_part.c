@@ -0,0 +1,176 @@
+#include "test_pack_part_helper.h"
+
+/* bench_pack_part measures how many transactions per second
+   partitioned pack schedules as partitions and bank tiles scale.  Each
+   partition is driven by its own tile (when enough tiles are
+   available), which repeatedly inserts transactions that belong to its
+   partition and schedules them round-robin to its banks.  Banks
+   complete their microblocks instantly, so this measures the rate at
+   which pack can produce work. */
+
+#define BENCH_DEPTH     (4096UL)
+#define BENCH_TXN_CNT   (8192UL)
+#define BENCH_ACCT_CNT  (2048UL)
+#define BENCH_DURATION  (20000000L) /* ns */
+
+struct bench_part {
+  fd_pack_part_t * part;
+  ulong            idx;
+  test_txn_t     * txns;     /* indexed [0, BENCH_TXN_CNT) */
+  ulong            sched_cnt;
+  long             elapsed;
+};
+typedef struct bench_part bench_part_t;
+
+static void
+bench_gen( fd_rng_t       * rng,
+           fd_pack_part_t * part,
+           ulong            idx,
+           test_txn_t     * txns ) {
+  fd_acct_addr_t prog[1];
+  fd_acct_addr_t hot[ BENCH_ACCT_CNT ];
+  rand_acct( rng, part, ULONG_MAX, prog );
+  for( ulong i=0UL; i<BENCH_ACCT_CNT; i++ ) rand_acct( rng, part, idx, hot+i );
+
+  for( ulong i=0UL; i<BENCH_TXN_CNT; i++ ) {
+    fd_acct_addr_t signer[1], w[2], r[1];
+    rand_acct( rng, part, idx, signer );
+    w[0] = hot[ fd_rng_ulong_roll( rng, BENCH_ACCT_CNT ) ];
+    w[1] = hot[ fd_rng_ulong_roll( rng, BENCH_ACCT_CNT ) ];
+    r[0] = hot[ fd_rng_ulong_roll( rng, BENCH_ACCT_CNT ) ];
+    ulong w_cnt = fd_ulong_if( !memcmp( w+0, w+1, sizeof(fd_acct_addr_t) ), 1UL, 2UL );
+    ulong r_cnt = fd_ulong_if( !memcmp( r+0, w+0, sizeof(fd_acct_addr_t) ) || !memcmp( r+0, w+1, sizeof(fd_acct_addr_t) ), 0UL, 1UL );
+    make_txn( txns+i, (idx<<32) | i, signer, w, w_cnt, r, r_cnt, prog );
+  }
+}
+
+static int
+bench_part_main( int     argc,
+                 char ** argv ) {
+  (void)argc;
+  bench_part_t   * b    = (bench_part_t *)argv;
+  fd_pack_part_t * part = b->part;
+  ulong            idx  = b->idx;
+
+  fd_metrics_register( (ulong *)fd_metrics_new( metrics_scratch[ idx ], 0UL, 0UL ) );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, (uint)idx, 0UL ) );
+
+  void      * mem;
+  fd_pack_t * pack     = new_pack( part, idx, BENCH_DEPTH, rng, &mem );
+  ulong       bank_lo  = fd_pack_part_bank_lo ( part, idx );
+  ulong       bank_cnt = fd_pack_part_bank_cnt( part, idx );
+
+  fd_txn_p_t out[ 31 ];
+  ulong next_txn  = 0UL;
+  ulong next_bank = 0UL;
+  ulong sched_cnt = 0UL;
+
+  long start = fd_log_wallclock();
+  long now   = start;
+  while( now-start<BENCH_DURATION ) {
+    for( ulong k=0UL; k<64UL; k++ ) {
+      /* Keep pack about half full */
+      while( fd_pack_avail_txn_cnt( pack )<BENCH_DEPTH/2UL ) {
+        fd_txn_e_t * txne = fd_pack_insert_txn_init( pack );
+        load_txn( txne, b->txns + (next_txn % BENCH_TXN_CNT) );
+        /* Make the signature unique so re-inserting the same template
+           isn't rejected as a duplicate. */
+        FD_STORE( ulong, txne->txnp->payload+1UL+sizeof(ulong), next_txn );
+        fd_pack_insert_txn_fini( pack, txne, 0UL );
+        next_txn++;
+      }
+
+      ulong bank = bank_lo + next_bank;
+      next_bank  = fd_ulong_if( next_bank+1UL==bank_cnt, 0UL, next_bank+1UL );
+      fd_pack_part_microblock_complete( part, idx, pack, bank );
+      ulong cnt = fd_pack_part_schedule( part, idx, pack, 31UL*200000UL, 0.0f, bank, out );
+      sched_cnt += cnt;
+
+      /* Block full or every account busy */
+      if( FD_UNLIKELY( !cnt ) ) {
+        for( ulong j=0UL; j<bank_cnt; j++ ) fd_pack_part_microblock_complete( part, idx, pack, bank_lo+j );
+        fd_pack_end_block( pack );
+      }
+    }
+    now = fd_log_wallclock();
+  }
+  b->elapsed   = now-start;
+  b->sched_cnt = sched_cnt;
+
+  fd_pack_delete( fd_pack_leave( pack ) );
+  free( mem );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_metrics_register( (ulong *)metrics_scratch[ FD_PACK_PART_MAX ] );
+  return 0;
+}
+
+static void
+bench_scale( fd_rng_t * rng ) {
+  FD_LOG_NOTICE(( "BENCHMARK: partitioned pack scheduled txn/s vs bank tile count" ));
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "only %lu tile(s) available, partitions will run serially and the rate shown is the sum of per-partition rates", tile_cnt ));
+  }
+
+  static ulong const bank_cnts[] = { 1UL, 2UL, 4UL, 8UL, 16UL, 32UL, 62UL };
+  static ulong const part_cnts[] = { 1UL, 2UL, 4UL, 8UL, 16UL };
+
+  test_txn_t   * txns = aligned_alloc( alignof(test_txn_t), FD_PACK_PART_MAX*BENCH_TXN_CNT*sizeof(test_txn_t) );
+  bench_part_t   b[ FD_PACK_PART_MAX ];
+  FD_TEST( txns );
+
+  for( ulong pi=0UL; pi<sizeof(part_cnts)/sizeof(ulong); pi++ ) {
+    ulong part_cnt = part_cnts[ pi ];
+
+    /* Transactions depend on the partition count through the hash */
+    fd_pack_part_t * part = fd_pack_part_join( fd_pack_part_new( part_mem, part_cnt, part_cnt, 10UL, ULONG_MAX ) );
+    for( ulong i=0UL; i<part_cnt; i++ ) bench_gen( rng, part, i, txns+i*BENCH_TXN_CNT );
+    fd_pack_part_delete( fd_pack_part_leave( part ) );
+
+    for( ulong bi=0UL; bi<sizeof(bank_cnts)/sizeof(ulong); bi++ ) {
+      ulong bank_cnt = bank_cnts[ bi ];
+      if( bank_cnt<part_cnt ) continue;
+
+      /* cross_period==ULONG_MAX: no cross-partition traffic here */
+      part = fd_pack_part_join( fd_pack_part_new( part_mem, part_cnt, bank_cnt, 10UL, ULONG_MAX ) );
+
+      fd_tile_exec_t * exec[ FD_PACK_PART_MAX ] = { NULL };
+      for( ulong i=0UL; i<part_cnt; i++ ) {
+        b[ i ] = (bench_part_t){ .part = part, .idx = i, .txns = txns+i*BENCH_TXN_CNT };
+        if( i+1UL<tile_cnt ) exec[ i ] = fd_tile_exec_new( i+1UL, bench_part_main, 0, (char **)(b+i) );
+        else                 bench_part_main( 0, (char **)(b+i) );
+      }
+      for( ulong i=0UL; i<part_cnt; i++ ) if( exec[ i ] ) fd_tile_exec_delete( exec[ i ], NULL );
+
+      double rate = 0.0;
+      for( ulong i=0UL; i<part_cnt; i++ ) rate += (double)b[ i ].sched_cnt * 1e9 / (double)b[ i ].elapsed;
+      FD_LOG_NOTICE(( "part_cnt %2lu bank_tile_cnt %2lu: %12.0f txn/s (%.0f txn/s/bank)",
+                      part_cnt, bank_cnt, rate, rate/(double)bank_cnt ));
+
+      fd_pack_part_delete( fd_pack_part_leave( part ) );
+    }
+  }
+
+  free( txns );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+  fd_metrics_register( (ulong *)fd_metrics_new( metrics_scratch[ FD_PACK_PART_MAX ], 0UL, 0UL ) );
+
+  bench_scale( rng );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
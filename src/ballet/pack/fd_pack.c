@@ -1612,6 +1612,7 @@ fd_pack_schedule_next_microblock( fd_pack_t *  pack,
 }
 
 ulong fd_pack_bank_tile_cnt     ( fd_pack_t const * pack ) { return pack->bank_tile_cnt;         }
+int   fd_pack_acct_is_unwritable( fd_acct_addr_t const * acct ) { return fd_pack_unwritable_contains( acct ); }
 ulong fd_pack_current_block_cost( fd_pack_t const * pack ) { return pack->cumulative_block_cost; }
 
 
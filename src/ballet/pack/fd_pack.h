@@ -53,6 +53,10 @@
 #define FD_TXN_P_FLAGS_IS_SIMPLE_VOTE   (1U)
 #define FD_TXN_P_FLAGS_SANITIZE_SUCCESS (2U)
 #define FD_TXN_P_FLAGS_EXECUTE_SUCCESS  (4U)
+/* Set by the verify tiles if the signatures of all precompile
+   instructions in the transaction were verified, in which case
+   execution can skip verifying them again. */
+#define FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED (8U)
 
 
 /* The Solana network and Firedancer implementation details impose
@@ -408,6 +412,13 @@ void * fd_pack_leave(  fd_pack_t * pack );
    and returns ownership of the memory to the caller.  Returns mem. */
 void * fd_pack_delete( void      * mem  );
 
+/* fd_pack_acct_is_unwritable returns 1 if acct is one of the sysvars
+   or builtin programs that pack refuses to write lock (i.e. a
+   transaction that writes to it is rejected with WRITES_SYSVAR) and 0
+   otherwise.  Since any scheduled use of such an account is a read, it
+   never causes a conflict. */
+FD_FN_PURE int fd_pack_acct_is_unwritable( fd_acct_addr_t const * acct );
+
 /* fd_pack_verify (for debugging use primarily) checks to ensure several
    invariants are satisfied.  scratch must point to the first byte of a
    piece of memory meeting the same alignment and footprint constraints
@@ -0,0 +1,285 @@
+#include "fd_pack_part.h"
+#include "fd_pack_bitset.h"
+#include "../../flamenco/runtime/fd_system_ids_pp.h"
+
+/* Invoking any of these programs may modify a program account, so a
+   transaction that invokes one is always cross-partition.  See the
+   comment at the top of fd_pack_part.h. */
+FD_STATIC_ASSERT( FD_PACK_PART_MAX<=FD_PACK_BITSET_MAX, part_bitset );
+
+static const fd_acct_addr_t loader_ids[ 4 ] = {
+  { .b = { BPF_UPGRADEABLE_PROG_ID } },
+  { .b = { BPF_LOADER_1_PROG_ID    } },
+  { .b = { BPF_LOADER_2_PROG_ID    } },
+  { .b = { LOADER_V4_PROG_ID       } }
+};
+
+void *
+fd_pack_part_new( void * mem,
+                  ulong  part_cnt,
+                  ulong  bank_tile_cnt,
+                  ulong  cross_pct,
+                  ulong  cross_period ) {
+
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)mem, fd_pack_part_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (part_cnt<1UL) | (part_cnt>FD_PACK_PART_MAX) ) ) {
+    FD_LOG_WARNING(( "part_cnt %lu not in [1, %lu]", part_cnt, FD_PACK_PART_MAX ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (bank_tile_cnt<part_cnt) | (bank_tile_cnt>FD_PACK_MAX_BANK_TILES) ) ) {
+    FD_LOG_WARNING(( "bank_tile_cnt %lu not in [%lu, %lu]", bank_tile_cnt, part_cnt, FD_PACK_MAX_BANK_TILES ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (cross_pct<1UL) | (cross_pct>99UL) ) ) {
+    FD_LOG_WARNING(( "cross_pct %lu not in [1, 99]", cross_pct ));
+    return NULL;
+  }
+
+  fd_pack_part_t * part = (fd_pack_part_t *)mem;
+  fd_memset( part, 0, sizeof(fd_pack_part_t) );
+
+  part->part_cnt          = part_cnt;
+  part->bank_tile_cnt     = bank_tile_cnt;
+  part->cross_pct         = cross_pct;
+  part->cross_period      = cross_period;
+  part->state             = FD_PACK_PART_STATE_PART;
+  part->seq               = 0UL;
+  part->polls_since_cross = 0UL;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( part->magic ) = FD_PACK_PART_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return mem;
+}
+
+fd_pack_part_t *
+fd_pack_part_join( void * mem ) {
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  fd_pack_part_t * part = (fd_pack_part_t *)mem;
+  if( FD_UNLIKELY( part->magic!=FD_PACK_PART_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return part;
+}
+
+void * fd_pack_part_leave( fd_pack_part_t * part ) { return (void *)part; }
+
+void *
+fd_pack_part_delete( void * mem ) {
+  if( FD_UNLIKELY( !mem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  fd_pack_part_t * part = (fd_pack_part_t *)mem;
+  if( FD_UNLIKELY( part->magic!=FD_PACK_PART_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( part->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return mem;
+}
+
+fd_pack_limits_t *
+fd_pack_part_limits( fd_pack_part_t const   * part,
+                     ulong                    idx,
+                     fd_pack_limits_t const * block,
+                     fd_pack_limits_t       * out ) {
+  ulong part_cnt = part->part_cnt;
+  ulong pct      = part->cross_pct;
+
+  /* Compute the coordinator's share first, then split what remains
+     evenly (rounding down) between the partitions.  All the products
+     are done in a way that can't overflow for in-range limits. */
+#define CROSS_SHARE( x ) ( ((x)/100UL)*pct + (((x)%100UL)*pct)/100UL )
+#define SHARE( x ) fd_ulong_if( idx==part_cnt, CROSS_SHARE( x ), ((x) - CROSS_SHARE( x ))/part_cnt )
+
+  *out = *block;
+  out->max_cost_per_block        = SHARE( block->max_cost_per_block        );
+  out->max_vote_cost_per_block   = SHARE( block->max_vote_cost_per_block   );
+  out->max_data_bytes_per_block  = SHARE( block->max_data_bytes_per_block  );
+  out->max_microblocks_per_block = SHARE( block->max_microblocks_per_block );
+
+  /* Each account belongs to exactly one partition, so the per-account
+     limit only gets split two ways. */
+  out->max_write_cost_per_acct   = fd_ulong_if( idx==part_cnt, CROSS_SHARE( block->max_write_cost_per_acct ),
+                                                block->max_write_cost_per_acct - CROSS_SHARE( block->max_write_cost_per_acct ) );
+  out->max_vote_cost_per_block   = fd_ulong_min( out->max_vote_cost_per_block, out->max_cost_per_block );
+  out->max_write_cost_per_acct   = fd_ulong_min( out->max_write_cost_per_acct, out->max_cost_per_block );
+
+#undef SHARE
+#undef CROSS_SHARE
+  return out;
+}
+
+ulong
+fd_pack_part_classify( fd_pack_part_t const * part,
+                       fd_txn_e_t const     * txne ) {
+  ulong part_cnt = part->part_cnt;
+  if( FD_UNLIKELY( part_cnt==1UL ) ) return 0UL;
+
+  fd_txn_t const * txn     = TXN( txne->txnp );
+  ulong            imm_cnt = fd_txn_account_cnt( txn, FD_TXN_ACCT_CAT_IMM );
+
+  fd_acct_addr_t const * accts   = fd_txn_get_acct_addrs( txn, txne->txnp->payload );
+  fd_acct_addr_t const * alt_adj = txne->alt_accts - imm_cnt;
+
+  /* Program ids are always immediate accounts, so their index is less
+     than 256. */
+  ulong prog_mask[ 4 ] = { 0UL, 0UL, 0UL, 0UL };
+  for( ulong i=0UL; i<(ulong)txn->instr_cnt; i++ ) {
+    ulong prog_idx = (ulong)txn->instr[ i ].program_id;
+    prog_mask[ prog_idx>>6 ] |= 1UL<<(prog_idx & 63UL);
+
+    fd_acct_addr_t const * prog = accts + prog_idx;
+    for( ulong j=0UL; j<4UL; j++ ) if( FD_UNLIKELY( !memcmp( prog, loader_ids+j, FD_TXN_ACCT_ADDR_SZ ) ) ) return part_cnt;
+  }
+
+  /* rw_bitset has a bit for each partition the transaction references,
+     the way an fd_pack_ord_txn_t has one for each hot account. */
+  FD_PACK_BITSET_DECLARE( rw_bitset );
+  FD_PACK_BITSET_CLEAR( rw_bitset );
+
+  ulong result = ULONG_MAX;
+  for( fd_txn_acct_iter_t iter=fd_txn_acct_iter_init( txn, FD_TXN_ACCT_CAT_ALL );
+      iter!=fd_txn_acct_iter_end(); iter=fd_txn_acct_iter_next( iter ) ) {
+    ulong idx = fd_txn_acct_iter_idx( iter );
+    if( (idx<256UL) && (prog_mask[ idx>>6 ] & (1UL<<(idx & 63UL))) ) continue;
+
+    fd_acct_addr_t const * acct = fd_ptr_if( idx<imm_cnt, accts, alt_adj ) + idx;
+    if( FD_UNLIKELY( fd_pack_acct_is_unwritable( acct ) ) ) continue;
+
+    result = fd_pack_part_acct_idx( part, acct );
+    FD_PACK_BITSET_SETN( rw_bitset, result );
+  }
+
+  /* Only possible if every account is excluded, which means the fee
+     payer is a program or sysvar.  Pack will reject it, so it doesn't
+     matter where it goes. */
+  if( FD_UNLIKELY( result==ULONG_MAX ) ) return fd_pack_part_acct_idx( part, accts );
+
+  /* Single-partition iff no other bit is set */
+  FD_PACK_BITSET_CLEARN( rw_bitset, result );
+  return fd_ulong_if( FD_PACK_BITSET_ISNULL( rw_bitset ), result, part_cnt );
+}
+
+int
+fd_pack_part_quiesce( fd_pack_part_t * part,
+                      ulong            idx ) {
+  ulong state = FD_VOLATILE_CONST( part->state );
+  if( FD_LIKELY( state==FD_PACK_PART_STATE_PART ) ) return 1;
+
+  /* The coordinator writes seq before it moves out of the PART state,
+     so the seq we read here is at least the one for this drain. */
+  FD_COMPILER_MFENCE();
+  ulong seq = FD_VOLATILE_CONST( part->seq );
+  if( FD_LIKELY( !part->busy[ idx ] ) ) FD_VOLATILE( part->ack[ idx ] ) = seq;
+  return 0;
+}
+
+ulong
+fd_pack_part_schedule( fd_pack_part_t * part,
+                       ulong            idx,
+                       fd_pack_t      * pack,
+                       ulong            total_cus,
+                       float            vote_fraction,
+                       ulong            bank_tile,
+                       fd_txn_p_t     * out ) {
+  ulong local_bank = bank_tile - fd_pack_part_bank_lo( part, idx );
+  if( FD_UNLIKELY( local_bank>=fd_pack_part_bank_cnt( part, idx ) ) ) return 0UL;
+
+  if( FD_LIKELY( idx<part->part_cnt ) ) {
+    if( FD_UNLIKELY( !fd_pack_part_quiesce( part, idx ) ) ) return 0UL;
+  } else {
+    if( FD_UNLIKELY( FD_VOLATILE_CONST( part->state )!=FD_PACK_PART_STATE_CROSS ) ) return 0UL;
+  }
+
+  ulong txn_cnt = fd_pack_schedule_next_microblock( pack, total_cus, vote_fraction, local_bank, out );
+
+  /* Only the owner of idx writes busy[ idx ] */
+  if( FD_LIKELY( txn_cnt ) ) FD_VOLATILE( part->busy[ idx ] ) = part->busy[ idx ] | (1UL<<bank_tile);
+  return txn_cnt;
+}
+
+int
+fd_pack_part_microblock_complete( fd_pack_part_t * part,
+                                  ulong            idx,
+                                  fd_pack_t      * pack,
+                                  ulong            bank_tile ) {
+  ulong local_bank = bank_tile - fd_pack_part_bank_lo( part, idx );
+  if( FD_UNLIKELY( local_bank>=fd_pack_part_bank_cnt( part, idx ) ) ) return 0;
+
+  int completed = fd_pack_microblock_complete( pack, local_bank );
+
+  /* The bank tile must not be reported idle until pack has released
+     all its account locks. */
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( part->busy[ idx ] ) = part->busy[ idx ] & ~(1UL<<bank_tile);
+  return completed;
+}
+
+ulong
+fd_pack_part_cross_poll( fd_pack_part_t * part,
+                         fd_pack_t      * cross,
+                         ulong            sched_cnt ) {
+  ulong part_cnt = part->part_cnt;
+  ulong state    = part->state;
+
+  switch( state ) {
+    case FD_PACK_PART_STATE_PART: {
+      part->polls_since_cross++;
+      if( FD_LIKELY( !fd_pack_avail_txn_cnt( cross ) || part->polls_since_cross<part->cross_period ) ) break;
+      FD_VOLATILE( part->seq ) = part->seq+1UL;
+      FD_COMPILER_MFENCE();
+      state = FD_PACK_PART_STATE_DRAIN;
+      FD_VOLATILE( part->state ) = state;
+      break;
+    }
+    case FD_PACK_PART_STATE_DRAIN: {
+      ulong seq   = part->seq;
+      int   ready = 1;
+      for( ulong i=0UL; i<part_cnt; i++ ) ready &= FD_VOLATILE_CONST( part->ack[ i ] )==seq;
+      if( FD_UNLIKELY( !ready ) ) break;
+      FD_COMPILER_MFENCE();
+      state = FD_PACK_PART_STATE_CROSS;
+      FD_VOLATILE( part->state ) = state;
+      break;
+    }
+    case FD_PACK_PART_STATE_CROSS: {
+      if( FD_LIKELY( part->busy[ part_cnt ] ) ) break;
+      if( FD_LIKELY( fd_pack_avail_txn_cnt( cross ) && sched_cnt ) ) break;
+      part->polls_since_cross = 0UL;
+      FD_COMPILER_MFENCE();
+      state = FD_PACK_PART_STATE_PART;
+      FD_VOLATILE( part->state ) = state;
+      break;
+    }
+    default: {
+      FD_LOG_CRIT(( "corrupt pack part state %lu", state ));
+    }
+  }
+
+  return state;
+}
@@ -0,0 +1,273 @@
+#ifndef HEADER_fd_src_ballet_pack_fd_pack_part_h
+#define HEADER_fd_src_ballet_pack_fd_pack_part_h
+
+/* fd_pack_part coordinates a partitioned pack mode in which several
+   pack tiles schedule transactions in parallel, each one to its own
+   disjoint subset of the bank tiles.
+
+   A single fd_pack object does all the treap traversal, bitset conflict
+   checks and writer-cost accounting for every bank tile, which makes
+   one pack core the ceiling on how many bank tiles can be fed.  In
+   partitioned mode, the account address space is split into part_cnt
+   partitions by hashing account addresses (see fd_pack_part_acct_idx).
+   Each partition is owned by
+   exactly one pack tile, which has its own private fd_pack object and
+   its own contiguous range of bank tiles.  A transaction that only
+   references accounts in one partition is scheduled by that
+   partition's owner.  Since no other partition can ever reference
+   those accounts, partition owners never need to synchronize with each
+   other for conflict detection.
+
+   Transactions that reference accounts in more than one partition are
+   "cross-partition" transactions.  These are inserted into one more
+   fd_pack object, owned by the coordinator, with idx==part_cnt.  The
+   coordinator periodically runs a cross phase: it asks all partitions
+   to drain, waits until each partition acknowledges that it has no
+   outstanding microblocks, schedules cross-partition transactions to
+   any bank tile, waits for those to complete, and then releases the
+   partitions.  This is a simple barrier rather than fine-grained
+   locking, so it is most effective when cross-partition transactions
+   are a small fraction of the total.
+
+   Some accounts are excluded when classifying a transaction:
+     * accounts pack refuses to write (sysvars, builtin programs, see
+       fd_pack_acct_is_unwritable), since every use of them is a read.
+     * the program id of each instruction.  An invoked program account
+       can only be modified by its loader, so every transaction that
+       invokes a loader is classified as cross-partition.  Then no
+       partition can write a program account that another partition is
+       concurrently executing.
+   This means e.g. transactions that invoke the Token program but
+   touch token accounts in a single partition stay in that partition.
+
+   The consensus-critical block limits are split statically between the
+   fd_pack objects (see fd_pack_part_limits) so that the sum over all
+   partitions and the coordinator never exceeds the block limits.
+   Since every account hashes to exactly one partition, the per-account
+   write cost limit only needs to be split between that partition and
+   the coordinator.
+
+   The shared state is a small control object that should live in a
+   workspace all the pack tiles join.  Each fd_pack object lives in its
+   owner's private memory, as usual.  Aside from the control object,
+   all the partition-specific functions below must only be called from
+   the owner of the corresponding fd_pack.
+
+   This is a library only for now.  The pack tile still runs a single
+   fd_pack for all bank tiles and the topology has no way to configure
+   more than one pack tile, so nothing in the validator uses
+   fd_pack_part yet.  Running several pack tiles (splitting the
+   dedup->pack link, routing bank completions back to the owning pack
+   tile and sharing the control object) is out of scope here.
+   bench_pack_part shows what it would buy. */
+
+#include "fd_pack.h"
+
+/* FD_PACK_PART_MAX is the maximum number of partitions (not including
+   the coordinator). */
+#define FD_PACK_PART_MAX   (16UL)
+
+#define FD_PACK_PART_ALIGN (128UL)
+
+/* Coordinator states.  See fd_pack_part_cross_poll. */
+#define FD_PACK_PART_STATE_PART  (0UL) /* partitions schedule freely          */
+#define FD_PACK_PART_STATE_DRAIN (1UL) /* waiting for partitions to quiesce   */
+#define FD_PACK_PART_STATE_CROSS (2UL) /* coordinator schedules to all banks */
+
+struct __attribute__((aligned(FD_PACK_PART_ALIGN))) fd_pack_part_private {
+  ulong magic; /* ==FD_PACK_PART_MAGIC */
+  ulong part_cnt;
+  ulong bank_tile_cnt;
+  ulong cross_pct;    /* percent of block limits given to the coordinator */
+  ulong cross_period; /* min coordinator polls between cross phases */
+
+  /* Written only by the coordinator.  seq is incremented each time the
+     coordinator starts draining the partitions. */
+  ulong state;
+  ulong seq;
+  ulong polls_since_cross;
+
+  /* ack[i] is written only by the owner of partition i.  It is set to
+     seq once partition i has observed the drain request and has no
+     outstanding microblocks. */
+  ulong ack[ FD_PACK_PART_MAX ] __attribute__((aligned(128)));
+
+  /* busy[i] is a bitmask of bank tiles (global index) with an
+     outstanding microblock scheduled by fd_pack object i.  Indexed [0,
+     part_cnt].  Each element is written only by the owner of i. */
+  ulong busy[ FD_PACK_PART_MAX+1UL ] __attribute__((aligned(128)));
+};
+typedef struct fd_pack_part_private fd_pack_part_t;
+
+#define FD_PACK_PART_MAGIC (0xf17eda2ce7ba7700UL) /* firedancer pack part version 0 */
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_pack_part_{align,footprint} return the required alignment and
+   footprint of a memory region suitable for use as a pack partition
+   control object. */
+
+FD_FN_CONST static inline ulong fd_pack_part_align    ( void ) { return FD_PACK_PART_ALIGN;     }
+FD_FN_CONST static inline ulong fd_pack_part_footprint( void ) { return sizeof(fd_pack_part_t); }
+
+/* fd_pack_part_new formats a memory region as a pack partition control
+   object.  part_cnt is the number of partitions, in [1,
+   FD_PACK_PART_MAX].  bank_tile_cnt is the total number of bank tiles,
+   in [part_cnt, FD_PACK_MAX_BANK_TILES].  cross_pct, in [1, 99], is
+   the percentage of the block limits reserved for cross-partition
+   transactions.  cross_period is the minimum number of calls to
+   fd_pack_part_cross_poll between the end of one cross phase and the
+   start of the next.  Returns mem on success and NULL on failure (logs
+   details). */
+
+void *
+fd_pack_part_new( void * mem,
+                  ulong  part_cnt,
+                  ulong  bank_tile_cnt,
+                  ulong  cross_pct,
+                  ulong  cross_period );
+
+fd_pack_part_t * fd_pack_part_join  ( void           * mem  );
+void *           fd_pack_part_leave ( fd_pack_part_t * part );
+void *           fd_pack_part_delete( void           * mem  );
+
+FD_FN_PURE static inline ulong fd_pack_part_cnt  ( fd_pack_part_t const * part ) { return part->part_cnt; }
+FD_FN_PURE static inline ulong fd_pack_part_state( fd_pack_part_t const * part ) { return FD_VOLATILE_CONST( part->state ); }
+
+/* fd_pack_part_bank_{lo,cnt} return the range [lo, lo+cnt) of global
+   bank tile indices that the fd_pack object with index idx schedules
+   to.  idx in [0, part_cnt) is a partition, and idx==part_cnt is the
+   coordinator, which may schedule to any bank tile. */
+
+FD_FN_PURE static inline ulong
+fd_pack_part_bank_lo( fd_pack_part_t const * part,
+                      ulong                  idx ) {
+  return fd_ulong_if( idx==part->part_cnt, 0UL, (idx*part->bank_tile_cnt)/part->part_cnt );
+}
+
+FD_FN_PURE static inline ulong
+fd_pack_part_bank_cnt( fd_pack_part_t const * part,
+                       ulong                  idx ) {
+  return fd_ulong_if( idx==part->part_cnt, part->bank_tile_cnt,
+                      ((idx+1UL)*part->bank_tile_cnt)/part->part_cnt - fd_pack_part_bank_lo( part, idx ) );
+}
+
+/* fd_pack_part_limits populates out with the limits that the fd_pack
+   object with index idx (in [0, part_cnt]) should be created with,
+   given the whole-block limits in block.  The sum of each
+   consensus-critical limit over all part_cnt+1 objects is no more than
+   the corresponding limit in block.  Returns out. */
+
+fd_pack_limits_t *
+fd_pack_part_limits( fd_pack_part_t const   * part,
+                     ulong                    idx,
+                     fd_pack_limits_t const * block,
+                     fd_pack_limits_t       * out );
+
+/* fd_pack_part_acct_idx returns the partition, in [0, part_cnt), that
+   owns the account acct.  It uses the same hash fd_pack uses to map an
+   account to its bit in the rw_bitset/w_bitset of each transaction, but
+   takes the partition from the high half of it.  fd_pack's maps only
+   use the low half, so the accounts of one partition still spread over
+   all the slots of its owner's maps. */
+
+FD_FN_PURE static inline ulong
+fd_pack_part_acct_idx( fd_pack_part_t const * part,
+                       fd_acct_addr_t const * acct ) {
+  return ((fd_ulong_hash( fd_ulong_load_8( acct->b ) )>>32)*part->part_cnt)>>32;
+}
+
+/* fd_pack_part_classify returns the index of the fd_pack object that
+   must schedule the transaction in txne.  The result is in [0,
+   part_cnt) if the transaction only references accounts in a single
+   partition (or no partitionable accounts at all, in which case the
+   fee payer decides), and part_cnt if it is a cross-partition
+   transaction.  Like fd_pack does for conflict detection, it builds
+   the set of partitions the transaction references in a bitset, and
+   any account it reads or writes counts, as a read of another
+   partition's account still conflicts with that partition's writers.
+   txne must point to a transaction with a valid fd_txn_t
+   and, if it loads accounts from address lookup tables, alt_accts
+   populated.  Every pack tile computes the same answer for the same
+   transaction, so each can filter its input independently. */
+
+FD_FN_PURE ulong
+fd_pack_part_classify( fd_pack_part_t const * part,
+                       fd_txn_e_t const     * txne );
+
+/* fd_pack_part_schedule is the partition-aware wrapper around
+   fd_pack_schedule_next_microblock.  pack must be a local join of the
+   fd_pack object with index idx, which must be owned by the caller.
+   bank_tile is a global bank tile index, which must be in the range
+   given by fd_pack_part_bank_{lo,cnt} for idx.
+
+   A partition (idx<part_cnt) only schedules while the coordinator is
+   in the PART state.  Otherwise, it returns 0 and acknowledges the
+   drain request once it has no outstanding microblocks.  The
+   coordinator (idx==part_cnt) only schedules in the CROSS state.
+   Partitions must keep calling this (or fd_pack_part_quiesce) while
+   idle so that drain requests are acknowledged promptly.
+
+   Otherwise, the arguments and return value are as in
+   fd_pack_schedule_next_microblock. */
+
+ulong
+fd_pack_part_schedule( fd_pack_part_t * part,
+                       ulong            idx,
+                       fd_pack_t      * pack,
+                       ulong            total_cus,
+                       float            vote_fraction,
+                       ulong            bank_tile,
+                       fd_txn_p_t     * out );
+
+/* fd_pack_part_microblock_complete is the partition-aware wrapper
+   around fd_pack_microblock_complete.  idx, pack, and bank_tile are as
+   in fd_pack_part_schedule.  The completion for a bank tile must be
+   delivered to the fd_pack object that scheduled the microblock, which
+   is the one for which fd_pack_part_owns returns 1. */
+
+int
+fd_pack_part_microblock_complete( fd_pack_part_t * part,
+                                  ulong            idx,
+                                  fd_pack_t      * pack,
+                                  ulong            bank_tile );
+
+/* fd_pack_part_owns returns 1 if the fd_pack object with index idx has
+   an outstanding microblock on bank_tile and 0 otherwise. */
+
+static inline int
+fd_pack_part_owns( fd_pack_part_t const * part,
+                   ulong                  idx,
+                   ulong                  bank_tile ) {
+  return !!(FD_VOLATILE_CONST( part->busy[ idx ] ) & (1UL<<bank_tile));
+}
+
+/* fd_pack_part_quiesce acknowledges a pending drain request on behalf
+   of partition idx if it has no outstanding microblocks.  Returns 1 if
+   partition idx may schedule (the coordinator is in the PART state)
+   and 0 otherwise. */
+
+int
+fd_pack_part_quiesce( fd_pack_part_t * part,
+                      ulong            idx );
+
+/* fd_pack_part_cross_poll advances the coordinator's state machine.
+   It must only be called by the coordinator, which owns the fd_pack
+   object cross (idx==part_cnt).
+     PART  -> DRAIN when cross has available transactions and at least
+              cross_period polls have elapsed since the last cross phase
+     DRAIN -> CROSS when every partition has acknowledged the drain
+     CROSS -> PART  when cross has no available transactions, or none
+              could be scheduled in the previous poll, and no
+              microblocks from cross are outstanding
+   Returns the new state.  sched_cnt is the number of transactions the
+   coordinator scheduled since the previous call. */
+
+ulong
+fd_pack_part_cross_poll( fd_pack_part_t * part,
+                         fd_pack_t      * cross,
+                         ulong            sched_cnt );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_ballet_pack_fd_pack_part_h */
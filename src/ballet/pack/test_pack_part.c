@@ -0,0 +1,183 @@
+#include "test_pack_part_helper.h"
+
+static fd_txn_e_t scratch_txne[1];
+
+static void
+test_classify( fd_rng_t * rng ) {
+  fd_pack_part_t * part = fd_pack_part_join( fd_pack_part_new( part_mem, 4UL, 8UL, 10UL, 0UL ) );
+  FD_TEST( part );
+
+  FD_TEST( fd_pack_part_cnt( part )==4UL );
+  for( ulong i=0UL; i<4UL; i++ ) {
+    FD_TEST( fd_pack_part_bank_lo ( part, i )==2UL*i );
+    FD_TEST( fd_pack_part_bank_cnt( part, i )==2UL   );
+  }
+  FD_TEST( fd_pack_part_bank_lo ( part, 4UL )==0UL );
+  FD_TEST( fd_pack_part_bank_cnt( part, 4UL )==8UL );
+
+  static const fd_acct_addr_t token   = { .b = { TOKEN_PROG_ID           } };
+  static const fd_acct_addr_t clock   = { .b = { SYSVAR_CLOCK_ID         } };
+  static const fd_acct_addr_t loader  = { .b = { BPF_UPGRADEABLE_PROG_ID } };
+  fd_acct_addr_t prog[1];
+  rand_acct( rng, part, ULONG_MAX, prog );
+
+  test_txn_t txn[1];
+  for( ulong p=0UL; p<4UL; p++ ) {
+    fd_acct_addr_t signer[1], w[2], r[2];
+    rand_acct( rng, part, p, signer );
+    rand_acct( rng, part, p, w+0 ); rand_acct( rng, part, p, w+1 );
+    rand_acct( rng, part, p, r+0 ); r[1] = clock;
+
+    /* All accounts in one partition.  The program id and the sysvar
+       don't count. */
+    make_txn( txn, p, signer, w, 2UL, r, 2UL, prog );
+    FD_TEST( fd_pack_part_classify( part, load_txn( scratch_txne, txn ) )==p );
+    make_txn( txn, p, signer, w, 2UL, r, 2UL, &token );
+    FD_TEST( fd_pack_part_classify( part, load_txn( scratch_txne, txn ) )==p );
+
+    /* Invoking a loader is always cross-partition */
+    make_txn( txn, p, signer, w, 2UL, r, 2UL, &loader );
+    FD_TEST( fd_pack_part_classify( part, load_txn( scratch_txne, txn ) )==4UL );
+
+    /* Writing or reading an account in a different partition */
+    fd_acct_addr_t other[1];
+    rand_acct( rng, part, (p+1UL)&3UL, other );
+    make_txn( txn, p, signer, other, 1UL, r, 2UL, prog );
+    FD_TEST( fd_pack_part_classify( part, load_txn( scratch_txne, txn ) )==4UL );
+    make_txn( txn, p, signer, w, 2UL, other, 1UL, prog );
+    FD_TEST( fd_pack_part_classify( part, load_txn( scratch_txne, txn ) )==4UL );
+  }
+
+  /* Limits sum to no more than the block limits */
+  fd_pack_limits_t block[1] = { {
+    .max_cost_per_block        = FD_PACK_MAX_COST_PER_BLOCK,
+    .max_vote_cost_per_block   = FD_PACK_MAX_VOTE_COST_PER_BLOCK,
+    .max_write_cost_per_acct   = FD_PACK_MAX_WRITE_COST_PER_ACCT,
+    .max_data_bytes_per_block  = FD_PACK_MAX_DATA_PER_BLOCK,
+    .max_txn_per_microblock    = 31UL,
+    .max_microblocks_per_block = 131072UL,
+  } };
+  fd_pack_limits_t sum[1] = { { 0 } };
+  fd_pack_limits_t lim[1];
+  for( ulong i=0UL; i<=4UL; i++ ) {
+    fd_pack_part_limits( part, i, block, lim );
+    FD_TEST( lim->max_txn_per_microblock==block->max_txn_per_microblock );
+    sum->max_cost_per_block        += lim->max_cost_per_block;
+    sum->max_vote_cost_per_block   += lim->max_vote_cost_per_block;
+    sum->max_data_bytes_per_block  += lim->max_data_bytes_per_block;
+    sum->max_microblocks_per_block += lim->max_microblocks_per_block;
+    if( i==0UL || i==4UL ) sum->max_write_cost_per_acct += lim->max_write_cost_per_acct;
+  }
+  FD_TEST( sum->max_cost_per_block       <=block->max_cost_per_block        );
+  FD_TEST( sum->max_vote_cost_per_block  <=block->max_vote_cost_per_block   );
+  FD_TEST( sum->max_data_bytes_per_block <=block->max_data_bytes_per_block  );
+  FD_TEST( sum->max_microblocks_per_block<=block->max_microblocks_per_block );
+  FD_TEST( sum->max_write_cost_per_acct  <=block->max_write_cost_per_acct   );
+  FD_TEST( sum->max_cost_per_block       > block->max_cost_per_block-8UL    );
+
+  FD_TEST( fd_pack_part_delete( fd_pack_part_leave( part ) )==part_mem );
+}
+
+static void
+test_protocol( fd_rng_t * rng ) {
+  ulong part_cnt = 2UL;
+  fd_pack_part_t * part = fd_pack_part_join( fd_pack_part_new( part_mem, part_cnt, 4UL, 10UL, 2UL ) );
+
+  fd_pack_t * pack[ 3 ];
+  void      * mem [ 3 ];
+  for( ulong i=0UL; i<=part_cnt; i++ ) pack[ i ] = new_pack( part, i, 64UL, rng, mem+i );
+
+  fd_acct_addr_t prog[1];
+  rand_acct( rng, part, ULONG_MAX, prog );
+
+  /* 8 transactions in each partition and 4 cross-partition ones */
+  test_txn_t txn[1];
+  ulong      ins[ 3 ] = { 0UL, 0UL, 0UL };
+  for( ulong i=0UL; i<20UL; i++ ) {
+    fd_acct_addr_t signer[1], w[2];
+    ulong p = fd_ulong_if( i<16UL, i&1UL, ULONG_MAX );
+    rand_acct( rng, part, fd_ulong_if( p==ULONG_MAX, 0UL, p ), signer );
+    rand_acct( rng, part, fd_ulong_if( p==ULONG_MAX, 0UL, p ), w+0    );
+    rand_acct( rng, part, fd_ulong_if( p==ULONG_MAX, 1UL, p ), w+1    );
+    make_txn( txn, i, signer, w, 2UL, NULL, 0UL, prog );
+
+    ulong idx = fd_pack_part_classify( part, load_txn( scratch_txne, txn ) );
+    FD_TEST( idx==fd_ulong_if( p==ULONG_MAX, part_cnt, p ) );
+    FD_TEST( fd_pack_insert_txn_fini( pack[ idx ], load_txn( fd_pack_insert_txn_init( pack[ idx ] ), txn ), 0UL )>=0 );
+    ins[ idx ]++;
+  }
+  for( ulong i=0UL; i<=part_cnt; i++ ) FD_TEST( fd_pack_avail_txn_cnt( pack[ i ] )==ins[ i ] );
+
+  fd_txn_p_t out[ 31 ];
+
+  /* The coordinator can't schedule while partitions run */
+  FD_TEST( !fd_pack_part_schedule( part, part_cnt, pack[ part_cnt ], 1000000UL, 0.0f, 0UL, out ) );
+
+  /* Partitions can only schedule to their own banks */
+  FD_TEST( !fd_pack_part_schedule( part, 0UL, pack[ 0 ], 1000000UL, 0.0f, 2UL, out ) );
+  FD_TEST(  fd_pack_part_schedule( part, 0UL, pack[ 0 ], 1000000UL, 0.0f, 0UL, out ) );
+  FD_TEST(  fd_pack_part_schedule( part, 1UL, pack[ 1 ], 1000000UL, 0.0f, 3UL, out ) );
+  FD_TEST(  fd_pack_part_owns( part, 0UL, 0UL ) );
+  FD_TEST(  fd_pack_part_owns( part, 1UL, 3UL ) );
+  FD_TEST( !fd_pack_part_owns( part, 1UL, 2UL ) );
+
+  /* cross_period==2 */
+  FD_TEST( fd_pack_part_cross_poll( part, pack[ part_cnt ], 0UL )==FD_PACK_PART_STATE_PART  );
+  FD_TEST( fd_pack_part_cross_poll( part, pack[ part_cnt ], 0UL )==FD_PACK_PART_STATE_DRAIN );
+
+  /* Partitions stop scheduling but partition 0 still has an
+     outstanding microblock */
+  FD_TEST( !fd_pack_part_schedule( part, 0UL, pack[ 0 ], 1000000UL, 0.0f, 1UL, out ) );
+  FD_TEST(  fd_pack_part_microblock_complete( part, 1UL, pack[ 1 ], 3UL ) );
+  FD_TEST( !fd_pack_part_quiesce( part, 1UL ) );
+  FD_TEST( fd_pack_part_cross_poll( part, pack[ part_cnt ], 0UL )==FD_PACK_PART_STATE_DRAIN );
+  FD_TEST(  fd_pack_part_microblock_complete( part, 0UL, pack[ 0 ], 0UL ) );
+  FD_TEST( !fd_pack_part_quiesce( part, 0UL ) );
+  FD_TEST( fd_pack_part_cross_poll( part, pack[ part_cnt ], 0UL )==FD_PACK_PART_STATE_CROSS );
+
+  /* The coordinator may use any bank */
+  ulong cross_sched = 0UL;
+  for( ulong b=0UL; b<4UL; b++ ) cross_sched += fd_pack_part_schedule( part, part_cnt, pack[ part_cnt ], 1000000UL, 0.0f, b, out );
+  FD_TEST( cross_sched==ins[ part_cnt ] );
+  FD_TEST( !fd_pack_part_schedule( part, 0UL, pack[ 0 ], 1000000UL, 0.0f, 0UL, out ) );
+
+  /* Can't leave the cross state until the coordinator's microblocks
+     complete. */
+  FD_TEST( fd_pack_part_cross_poll( part, pack[ part_cnt ], cross_sched )==FD_PACK_PART_STATE_CROSS );
+  for( ulong b=0UL; b<4UL; b++ ) {
+    if( fd_pack_part_owns( part, part_cnt, b ) ) FD_TEST( fd_pack_part_microblock_complete( part, part_cnt, pack[ part_cnt ], b ) );
+  }
+  FD_TEST( fd_pack_part_cross_poll( part, pack[ part_cnt ], 0UL )==FD_PACK_PART_STATE_PART );
+
+  /* And partitions resume */
+  fd_acct_addr_t signer[1];
+  rand_acct( rng, part, 0UL, signer );
+  make_txn( txn, 20UL, signer, NULL, 0UL, NULL, 0UL, prog );
+  FD_TEST( fd_pack_insert_txn_fini( pack[ 0 ], load_txn( fd_pack_insert_txn_init( pack[ 0 ] ), txn ), 0UL )>=0 );
+  FD_TEST( fd_pack_part_schedule( part, 0UL, pack[ 0 ], 1000000UL, 0.0f, 1UL, out )==1UL );
+
+  for( ulong i=0UL; i<=part_cnt; i++ ) {
+    fd_pack_delete( fd_pack_leave( pack[ i ] ) );
+    free( mem[ i ] );
+  }
+  fd_pack_part_delete( fd_pack_part_leave( part ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+  fd_metrics_register( (ulong *)fd_metrics_new( metrics_scratch[ FD_PACK_PART_MAX ], 0UL, 0UL ) );
+
+  test_classify( rng );
+  test_protocol( rng );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,149 @@
+#ifndef HEADER_fd_src_ballet_pack_test_pack_part_helper_h
+#define HEADER_fd_src_ballet_pack_test_pack_part_helper_h
+
+#include "../fd_ballet.h"
+#include "fd_pack_part.h"
+#include "../../disco/metrics/fd_metrics.h"
+#include "../../flamenco/runtime/fd_system_ids_pp.h"
+#include <stdlib.h>
+
+/* Common routines for test_pack_part and bench_pack_part */
+
+/* Transactions in these tests are just enough of a transaction to satisfy
+   pack: a signer (the fee payer), some writable accounts, a compute
+   budget instruction requesting TXN_CU_LIMIT CUs, one instruction for
+   a program, and some readonly accounts. */
+
+#define MAX_WRITES     (4UL)
+#define MAX_READS      (4UL)
+#define TXN_CU_LIMIT   (1000U)
+#define PAYLOAD_MAX_SZ (1UL + FD_TXN_SIGNATURE_SZ + FD_TXN_ACCT_ADDR_SZ*(3UL+MAX_WRITES+MAX_READS) + 8UL)
+
+struct test_txn {
+  uchar payload[ PAYLOAD_MAX_SZ ];
+  ulong payload_sz;
+  uchar txn[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+};
+typedef struct test_txn test_txn_t;
+
+static const fd_acct_addr_t cbp = { .b = { COMPUTE_BUDGET_PROG_ID } };
+
+static const char SIGNATURE_SUFFIX[ FD_TXN_SIGNATURE_SZ - sizeof(ulong) ] = ": fake signature of transaction number  ";
+
+static uchar metrics_scratch[ FD_PACK_PART_MAX+1UL ][ FD_METRICS_FOOTPRINT( 0, 0 ) ] __attribute__((aligned(FD_METRICS_ALIGN)));
+
+static uchar part_mem[ sizeof(fd_pack_part_t) ] __attribute__((aligned(FD_PACK_PART_ALIGN)));
+
+/* make_txn builds transaction number i in out.  The fee payer is
+   signer, it writes the w_cnt accounts in w, reads the r_cnt accounts
+   in r and invokes prog. */
+static FD_FN_UNUSED void
+make_txn( test_txn_t           * out,
+          ulong                  i,
+          fd_acct_addr_t const * signer,
+          fd_acct_addr_t const * w,     ulong w_cnt,
+          fd_acct_addr_t const * r,     ulong r_cnt,
+          fd_acct_addr_t const * prog ) {
+  uchar    * p      = out->payload;
+  uchar    * p_base = p;
+  fd_txn_t * t      = (fd_txn_t *)out->txn;
+
+  *(p++) = (uchar)1;
+  fd_memcpy( p,                &i,               sizeof(ulong)                       );
+  fd_memcpy( p+sizeof(ulong),  SIGNATURE_SUFFIX, FD_TXN_SIGNATURE_SZ - sizeof(ulong) );
+  p += FD_TXN_SIGNATURE_SZ;
+
+  t->transaction_version   = FD_TXN_VLEGACY;
+  t->signature_cnt         = 1;
+  t->signature_off         = 1;
+  t->message_off           = FD_TXN_SIGNATURE_SZ+1UL;
+  t->readonly_signed_cnt   = 0;
+  t->readonly_unsigned_cnt = (uchar)(r_cnt+2UL);
+  t->acct_addr_cnt         = (ushort)(1UL+w_cnt+2UL+r_cnt);
+  t->acct_addr_off         = FD_TXN_SIGNATURE_SZ+1UL;
+
+  t->recent_blockhash_off         = 0;
+  t->addr_table_lookup_cnt        = 0;
+  t->addr_table_adtl_writable_cnt = 0;
+  t->addr_table_adtl_cnt          = 0;
+
+  fd_memcpy( p, signer, FD_TXN_ACCT_ADDR_SZ );                     p += FD_TXN_ACCT_ADDR_SZ;
+  for( ulong j=0UL; j<w_cnt; j++ ) { fd_memcpy( p, w+j, FD_TXN_ACCT_ADDR_SZ ); p += FD_TXN_ACCT_ADDR_SZ; }
+  fd_memcpy( p, prog,   FD_TXN_ACCT_ADDR_SZ );                     p += FD_TXN_ACCT_ADDR_SZ;
+  fd_memcpy( p, &cbp,   FD_TXN_ACCT_ADDR_SZ );                     p += FD_TXN_ACCT_ADDR_SZ;
+  for( ulong j=0UL; j<r_cnt; j++ ) { fd_memcpy( p, r+j, FD_TXN_ACCT_ADDR_SZ ); p += FD_TXN_ACCT_ADDR_SZ; }
+
+  t->instr_cnt              = 2;
+  t->instr[ 0 ].program_id  = (uchar)(2UL+w_cnt);
+  t->instr[ 0 ].acct_cnt    = 0;
+  t->instr[ 0 ].data_sz     = 5;
+  t->instr[ 0 ].acct_off    = (ushort)(p - p_base);
+  t->instr[ 0 ].data_off    = (ushort)(p - p_base);
+  uint cu_limit = TXN_CU_LIMIT;
+  *p = (uchar)2; fd_memcpy( p+1, &cu_limit, sizeof(uint) ); p += 5UL;
+
+  t->instr[ 1 ].program_id  = (uchar)(1UL+w_cnt);
+  t->instr[ 1 ].acct_cnt    = 0;
+  t->instr[ 1 ].data_sz     = 1;
+  t->instr[ 1 ].acct_off    = (ushort)(p - p_base);
+  t->instr[ 1 ].data_off    = (ushort)(p - p_base);
+  *(p++) = (uchar)0;
+
+  out->payload_sz = (ulong)(p-p_base);
+}
+
+static FD_FN_UNUSED fd_txn_e_t *
+load_txn( fd_txn_e_t       * txne,
+          test_txn_t const * txn ) {
+  fd_txn_t const * t = (fd_txn_t const *)txn->txn;
+  txne->txnp->payload_sz = txn->payload_sz;
+  fd_memcpy( txne->txnp->payload, txn->payload, txn->payload_sz                                     );
+  fd_memcpy( TXN(txne->txnp),     t,            fd_txn_footprint( t->instr_cnt, t->addr_table_lookup_cnt ) );
+  return txne;
+}
+
+/* rand_acct generates a random account address that fd_pack_part
+   assigns to partition target (or any partition if target==ULONG_MAX). */
+static FD_FN_UNUSED void
+rand_acct( fd_rng_t       * rng,
+           fd_pack_part_t * part,
+           ulong            target,
+           fd_acct_addr_t * out ) {
+  for( ulong j=0UL; j<FD_TXN_ACCT_ADDR_SZ/8UL; j++ ) FD_STORE( ulong, out->b+8UL*j, fd_rng_ulong( rng ) );
+  if( target==ULONG_MAX ) return;
+  for(;;) {
+    FD_STORE( ulong, out->b, fd_rng_ulong( rng ) );
+    if( fd_pack_part_acct_idx( part, out )==target ) return;
+  }
+}
+
+/* test_limits are the block limits new_pack splits between the
+   partitions and the coordinator. */
+
+static fd_pack_limits_t const test_limits[1] = { {
+  .max_cost_per_block        = FD_PACK_MAX_COST_PER_BLOCK,
+  .max_vote_cost_per_block   = FD_PACK_MAX_VOTE_COST_PER_BLOCK,
+  .max_write_cost_per_acct   = FD_PACK_MAX_WRITE_COST_PER_ACCT,
+  .max_data_bytes_per_block  = ULONG_MAX/2UL,
+  .max_txn_per_microblock    = 31UL,
+  .max_microblocks_per_block = 10000000UL,
+} };
+
+static FD_FN_UNUSED fd_pack_t *
+new_pack( fd_pack_part_t * part,
+          ulong            idx,
+          ulong            depth,
+          fd_rng_t       * rng,
+          void        ** out_mem ) {
+  fd_pack_limits_t lim[1];
+  fd_pack_part_limits( part, idx, test_limits, lim );
+  ulong bank_cnt  = fd_pack_part_bank_cnt( part, idx );
+  ulong footprint = fd_pack_footprint( depth, bank_cnt, lim );
+  FD_TEST( footprint );
+  void * mem = aligned_alloc( fd_pack_align(), fd_ulong_align_up( footprint, fd_pack_align() ) );
+  FD_TEST( mem );
+  *out_mem = mem;
+  return fd_pack_join( fd_pack_new( mem, depth, bank_cnt, lim, rng ) );
+}
+
+#endif /* HEADER_fd_src_ballet_pack_test_pack_part_helper_h */
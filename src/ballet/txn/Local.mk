@@ -1,5 +1,8 @@
 $(call add-hdrs,fd_txn.h )
 $(call add-objs,fd_txn_parse,fd_ballet)
+ifdef FD_HAS_AVX512
+$(call add-objs,fd_txn_parse_batch_avx512,fd_ballet)
+endif
 $(call make-unit-test,test_txn_parse,test_txn_parse,fd_ballet fd_util)
 $(call make-unit-test,test_txn,test_txn,fd_ballet fd_util)
 $(call make-unit-test,test_compact_u16,test_compact_u16,fd_ballet fd_util)
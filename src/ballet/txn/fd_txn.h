@@ -706,6 +706,25 @@ fd_txn_parse( uchar const * payload, ulong payload_sz, void * out_buf, fd_txn_pa
   return fd_txn_parse_core( payload, payload_sz, out_buf, counters_opt, NULL );
 }
 
+/* fd_txn_parse_batch: Parses a batch of cnt transactions.  This is
+   equivalent to
+
+     for( ulong i=0UL; i<cnt; i++ ) out_sz[ i ] = fd_txn_parse( payload[ i ], payload_sz[ i ], out_buf[ i ], counters_opt );
+
+   (including the contents of the out_buf on success and the counters
+   accumulated into counters_opt) but, on targets with AVX-512, the
+   message headers of several transactions are decoded in parallel.
+   out_buf[ i ] must be non-NULL.  Returns the number of transactions
+   that parsed successfully. */
+
+ulong
+fd_txn_parse_batch( uchar const * const       payload[],
+                    ulong const               payload_sz[],
+                    ulong                     cnt,
+                    void * const              out_buf[],
+                    ulong                     out_sz[],
+                    fd_txn_parse_counters_t * counters_opt );
+
 /* fd_txn_is_writable: Is the account at the supplied index writable
 
      Accounts ordered:
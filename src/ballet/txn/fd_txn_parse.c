@@ -250,3 +250,22 @@ fd_txn_parse_core( uchar const             * payload,
   #undef CHECK_LEFT
   #undef READ_CHECKED_COMPACT_U16
 }
+
+#if !FD_HAS_AVX512
+
+ulong
+fd_txn_parse_batch( uchar const * const       payload[],
+                    ulong const               payload_sz[],
+                    ulong                     cnt,
+                    void * const              out_buf[],
+                    ulong                     out_sz[],
+                    fd_txn_parse_counters_t * counters_opt ) {
+  ulong ok_cnt = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    out_sz[ i ] = fd_txn_parse_core( payload[ i ], payload_sz[ i ], out_buf[ i ], counters_opt, NULL );
+    ok_cnt += (ulong)!!out_sz[ i ];
+  }
+  return ok_cnt;
+}
+
+#endif /* !FD_HAS_AVX512 */
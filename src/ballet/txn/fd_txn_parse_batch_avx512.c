@@ -0,0 +1,314 @@
+#include "fd_txn.h"
+#include "fd_compact_u16.h"
+
+#if FD_HAS_AVX512
+
+#include "../../util/simd/fd_avx512.h"
+
+/* The batch parser works in two phases.
+
+   The first phase decodes the fixed part of the message header of 8
+   transactions at a time, one transaction per 64-bit lane: signature
+   count, message header, account address count, the offsets of the
+   account addresses and recent blockhash and the instruction count.
+   These fields sit at offsets that only depend on the signature count
+   and two compact-u16s, so they are fetched with masked gathers of 8
+   bytes (lanes whose gather would reach past the end of their payload
+   are masked off) and the compact-u16s are decoded branch free.
+
+   The second phase walks the instructions and address table lookups of
+   each transaction that passed the first phase.  These form a chain of
+   variable length fields that can't be decoded in parallel but the
+   account indices of all instructions are range checked with masked
+   64 byte loads and a single vector compare at the end.
+
+   Both phases only ever accept a transaction.  Anything they reject or
+   can't handle (e.g. 3 byte compact-u16 counts) is handed to
+   fd_txn_parse_core, which then decides (and accounts for the failure
+   in the counters) exactly as if the batch parser was not used.  Hence
+   fd_txn_parse_batch is equivalent to fd_txn_parse by construction as
+   long as the fast path never accepts what fd_txn_parse_core rejects
+   (fuzz_txn_parse checks this). */
+
+#define LANE_CNT (8UL)
+
+#ifdef FD_OFFLINE_REPLAY
+#define INSTR_MAX (128L) /* See fd_txn_parse_core */
+#else
+#define INSTR_MAX ((long)FD_TXN_INSTR_MAX)
+#endif
+
+/* gather loads the 8 bytes at p+off (as a little endian ulong) in the
+   lanes of m and 0 in the other lanes. */
+
+static inline wwl_t
+gather( int   m,
+        wwl_t p,
+        wwl_t off ) {
+  return _mm512_mask_i64gather_epi64( wwl_zero(), (__mmask8)m, wwl_add( p, off ), NULL, 1 );
+}
+
+/* cu16_dec decodes the compact-u16 in the low bytes of x, accepting
+   minimally encoded 1 and 2 byte encodings.  Returns the lanes where
+   this succeeded and, in those lanes, the value in *val and the
+   encoded size in *sz. */
+
+static inline int
+cu16_dec( wwl_t   x,
+          wwl_t * val,
+          wwl_t * sz ) {
+  wwl_t b0  = wwl_and( x,               wwl_bcast( 0xFFL ) );
+  wwl_t b1  = wwl_and( wwl_shru( x, 8 ), wwl_bcast( 0xFFL ) );
+  int   two = wwl_ge( b0, wwl_bcast( 0x80L ) );
+  *val = wwl_if( two, wwl_add( wwl_and( b0, wwl_bcast( 0x7FL ) ), wwl_shl( b1, 7 ) ), b0 );
+  *sz  = wwl_if( two, wwl_bcast( 2L ), wwl_one() );
+  return (~two) | ( wwl_ne( b1, wwl_zero() ) & wwl_lt( b1, wwl_bcast( 0x80L ) ) );
+}
+
+/* header decodes the message headers of the transactions in the lanes
+   of m (see above) into parsed and returns the lanes that were
+   accepted.  For those, off[ lane ] is the offset of the first
+   instruction. */
+
+static int
+header( uchar const * const payload[],
+        ulong const         payload_sz[],
+        void * const        out_buf[],
+        int                 m,
+        ulong               off[ LANE_CNT ] ) {
+  long _p [ LANE_CNT ] __attribute__((aligned(64)));
+  long _sz[ LANE_CNT ] __attribute__((aligned(64)));
+  for( ulong l=0UL; l<LANE_CNT; l++ ) {
+    _p [ l ] = (m>>l)&1 ? (long)payload   [ l ] : 0L;
+    _sz[ l ] = (m>>l)&1 ? (long)payload_sz[ l ] : 0L;
+  }
+  wwl_t p  = wwl_ld( _p  );
+  wwl_t sz = wwl_ld( _sz );
+
+  /* Signature count and message header.  The signature count and the
+     first message byte are read with a gather at 0 and the rest of
+     the header with a gather at the message offset. */
+
+  m &= wwl_le( sz, wwl_bcast( (long)FD_TXN_MTU ) ) & wwl_ge( sz, wwl_bcast( 8L ) );
+
+  wwl_t q0      = gather( m, p, wwl_zero() );
+  wwl_t sig_cnt = wwl_and( q0, wwl_bcast( 0xFFL ) );
+  m &= wwl_ge( sig_cnt, wwl_one() ) & wwl_le( sig_cnt, wwl_bcast( (long)FD_TXN_SIG_MAX ) );
+
+  wwl_t msg_off = wwl_add( wwl_one(), wwl_shl( sig_cnt, 6 ) ); /* FD_TXN_SIGNATURE_SZ==64 */
+  m &= wwl_le( wwl_add( msg_off, wwl_bcast( 8L ) ), sz );
+
+  /* A versioned message has one more header byte than a legacy one.
+     Past that byte, the layouts are the same.  The byte before the
+     readonly counts must match the signature count in both cases. */
+
+  wwl_t q1        = gather( m, p, msg_off );
+  int   versioned = wwl_ge( wwl_and( q1, wwl_bcast( 0xFFL ) ), wwl_bcast( 0x80L ) );
+  m &= (~versioned) | wwl_eq( wwl_and( q1, wwl_bcast( 0xFFL ) ), wwl_bcast( 0x80L | (long)FD_TXN_V0 ) );
+
+  wwl_t q1s = wwl_if( versioned, wwl_shru( q1, 8 ), q1 );
+  m &= wwl_eq( wwl_and( q1s, wwl_bcast( 0xFFL ) ), sig_cnt );
+
+  wwl_t ro_signed_cnt   = wwl_and( wwl_shru( q1s,  8 ), wwl_bcast( 0xFFL ) );
+  wwl_t ro_unsigned_cnt = wwl_and( wwl_shru( q1s, 16 ), wwl_bcast( 0xFFL ) );
+  m &= wwl_lt( ro_signed_cnt, sig_cnt );
+
+  wwl_t acct_addr_cnt; wwl_t cu16_sz;
+  m &= cu16_dec( wwl_shru( q1s, 24 ), &acct_addr_cnt, &cu16_sz );
+  m &= wwl_le( sig_cnt, acct_addr_cnt ) & wwl_le( acct_addr_cnt, wwl_bcast( (long)FD_TXN_ACCT_ADDR_MAX ) );
+  m &= wwl_le( wwl_add( sig_cnt, ro_unsigned_cnt ), acct_addr_cnt );
+
+  wwl_t acct_addr_off        = wwl_add( wwl_add( msg_off, cu16_sz ), wwl_if( versioned, wwl_bcast( 4L ), wwl_bcast( 3L ) ) );
+  wwl_t recent_blockhash_off = wwl_add( acct_addr_off, wwl_shl( acct_addr_cnt, 5 ) ); /* FD_TXN_ACCT_ADDR_SZ==32 */
+  wwl_t instr_cnt_off        = wwl_add( recent_blockhash_off, wwl_bcast( (long)FD_TXN_BLOCKHASH_SZ ) );
+  m &= wwl_le( wwl_add( instr_cnt_off, wwl_bcast( 8L ) ), sz );
+
+  /* Instruction count */
+
+  wwl_t instr_cnt;
+  m &= cu16_dec( gather( m, p, instr_cnt_off ), &instr_cnt, &cu16_sz );
+  m &= wwl_le( instr_cnt, wwl_bcast( INSTR_MAX ) );
+
+  wwl_t instr_off = wwl_add( instr_cnt_off, cu16_sz );
+  m &= wwl_le( wwl_mul( instr_cnt, wwl_bcast( 3L ) ), wwl_sub( sz, instr_off ) ); /* MIN_INSTR_SZ==3 */
+  m &= wwl_gt( acct_addr_cnt, wwl_if( wwl_ne( instr_cnt, wwl_zero() ), wwl_one(), wwl_zero() ) );
+
+  /* Write out the accepted headers */
+
+  long _sig_cnt    [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _sig_cnt,     sig_cnt              );
+  long _msg_off    [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _msg_off,     msg_off              );
+  long _ro_signed  [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _ro_signed,   ro_signed_cnt        );
+  long _ro_unsigned[ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _ro_unsigned, ro_unsigned_cnt      );
+  long _acct_cnt   [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _acct_cnt,    acct_addr_cnt        );
+  long _acct_off   [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _acct_off,    acct_addr_off        );
+  long _bh_off     [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _bh_off,      recent_blockhash_off );
+  long _instr_cnt  [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _instr_cnt,   instr_cnt            );
+  long _instr_off  [ LANE_CNT ] __attribute__((aligned(64))); wwl_st( _instr_off,   instr_off            );
+
+  for( ulong l=0UL; l<LANE_CNT; l++ ) {
+    if( !((m>>l)&1) ) continue;
+    fd_txn_t * parsed = (fd_txn_t *)out_buf[ l ];
+    parsed->transaction_version   = (uchar)fd_uchar_if( (versioned>>l)&1, FD_TXN_V0, FD_TXN_VLEGACY );
+    parsed->signature_cnt         = (uchar )_sig_cnt    [ l ];
+    parsed->signature_off         = (ushort)1;
+    parsed->message_off           = (ushort)_msg_off    [ l ];
+    parsed->readonly_signed_cnt   = (uchar )_ro_signed  [ l ];
+    parsed->readonly_unsigned_cnt = (uchar )_ro_unsigned[ l ];
+    parsed->acct_addr_cnt         = (ushort)_acct_cnt   [ l ];
+    parsed->acct_addr_off         = (ushort)_acct_off   [ l ];
+    parsed->recent_blockhash_off  = (ushort)_bh_off     [ l ];
+    parsed->instr_cnt             = (ushort)_instr_cnt  [ l ];
+    off[ l ] = (ulong)_instr_off[ l ];
+  }
+
+  return m;
+}
+
+/* body parses the instructions and address table lookups of a
+   transaction whose header was accepted by header, starting at offset
+   i.  Returns the footprint of the parsed transaction on success and 0
+   if the transaction should be handed to fd_txn_parse_core.  Mirrors
+   the corresponding part of fd_txn_parse_core. */
+
+static ulong
+body( uchar const * payload,
+      ulong         payload_sz,
+      fd_txn_t *    parsed,
+      ulong         i ) {
+
+# define CHECK( cond )  do { if( FD_UNLIKELY( !(cond) ) ) return 0UL; } while( 0 )
+# define CHECK_LEFT( n ) CHECK( (n)<=(payload_sz-i) )
+# define READ_CHECKED_COMPACT_U16( out_sz, var_name, where )              \
+    do {                                                                  \
+      ulong _where = (where);                                             \
+      ulong _out_sz = fd_cu16_dec_sz( payload+_where, payload_sz-_where ); \
+      CHECK( _out_sz );                                                   \
+      (var_name) = fd_cu16_dec_fixed( payload+_where, _out_sz );          \
+      (out_sz)   = _out_sz;                                               \
+    } while( 0 )
+
+  ulong  bytes_consumed = 0UL;
+  ulong  acct_addr_cnt  = parsed->acct_addr_cnt;
+  ulong  instr_cnt      = parsed->instr_cnt;
+  __m512i max_acct      = _mm512_setzero_si512();
+
+  for( ulong j=0UL; j<instr_cnt; j++ ) {
+    ushort acct_cnt = (ushort)0;
+    ushort data_sz  = (ushort)0;
+    CHECK_LEFT( 3UL                             );   uchar program_id     = payload[ i ];     i++;
+    READ_CHECKED_COMPACT_U16( bytes_consumed,             acct_cnt,                  i );     i+=bytes_consumed;
+    CHECK_LEFT( acct_cnt                        );   ulong acct_off       =          i  ;
+
+    /* Masked off bytes are not read, so this never reads past the
+       account indices */
+
+    for( ulong k=0UL; k<(ulong)acct_cnt; k+=64UL ) {
+      ulong     rem  = (ulong)acct_cnt - k;
+      __mmask64 mask = rem>=64UL ? ~0UL : ((1UL<<rem)-1UL);
+      max_acct = _mm512_max_epu8( max_acct, _mm512_maskz_loadu_epi8( mask, payload+i+k ) );
+    }
+    i += acct_cnt;
+
+    READ_CHECKED_COMPACT_U16( bytes_consumed,             data_sz,                   i );     i+=bytes_consumed;
+    CHECK_LEFT( data_sz                         );   ulong data_off       =          i  ;     i+=data_sz;
+
+    CHECK( (0UL < (ulong)program_id) & ((ulong)program_id < acct_addr_cnt) );
+
+    parsed->instr[ j ].program_id          = program_id;
+    parsed->instr[ j ]._padding_reserved_1 = (uchar)0;
+    parsed->instr[ j ].acct_cnt            = acct_cnt;
+    parsed->instr[ j ].data_sz             = data_sz;
+    parsed->instr[ j ].acct_off            = (ushort)acct_off;
+    parsed->instr[ j ].data_off            = (ushort)data_off;
+  }
+
+  ushort addr_table_cnt               = 0;
+  ulong  addr_table_adtl_writable_cnt = 0;
+  ulong  addr_table_adtl_cnt          = 0;
+
+  if( FD_LIKELY( parsed->transaction_version==FD_TXN_V0 ) ) {
+    fd_txn_acct_addr_lut_t * address_tables = fd_txn_get_address_tables( parsed );
+
+    READ_CHECKED_COMPACT_U16( bytes_consumed,             addr_table_cnt,            i );     i+=bytes_consumed;
+    CHECK( addr_table_cnt <= FD_TXN_ADDR_TABLE_LOOKUP_MAX );
+    CHECK_LEFT( 34UL*addr_table_cnt             );
+
+    for( ulong j=0; j<addr_table_cnt; j++ ) {
+      CHECK_LEFT( FD_TXN_ACCT_ADDR_SZ           );   ulong addr_off       =          i  ;     i+=FD_TXN_ACCT_ADDR_SZ;
+
+      ushort writable_cnt = 0;
+      ushort readonly_cnt = 0;
+      READ_CHECKED_COMPACT_U16( bytes_consumed,            writable_cnt,             i );     i+=bytes_consumed;
+      CHECK_LEFT( writable_cnt                  );   ulong writable_off   =          i  ;     i+=writable_cnt;
+      READ_CHECKED_COMPACT_U16( bytes_consumed,            readonly_cnt,             i );     i+=bytes_consumed;
+      CHECK_LEFT( readonly_cnt                  );   ulong readonly_off   =          i  ;     i+=readonly_cnt;
+
+      CHECK( writable_cnt<=FD_TXN_ACCT_ADDR_MAX-acct_addr_cnt );
+      CHECK( readonly_cnt<=FD_TXN_ACCT_ADDR_MAX-acct_addr_cnt );
+      CHECK( (ushort)1   <=writable_cnt+readonly_cnt          );
+
+      address_tables[ j ].addr_off     = (ushort)addr_off;
+      address_tables[ j ].writable_cnt = (uchar )writable_cnt;
+      address_tables[ j ].readonly_cnt = (uchar )readonly_cnt;
+      address_tables[ j ].writable_off = (ushort)writable_off;
+      address_tables[ j ].readonly_off = (ushort)readonly_off;
+
+      addr_table_adtl_writable_cnt += (ulong)writable_cnt;
+      addr_table_adtl_cnt          += (ulong)writable_cnt + (ulong)readonly_cnt;
+    }
+  }
+
+  CHECK( i==payload_sz );
+  CHECK( acct_addr_cnt+addr_table_adtl_cnt<=FD_TXN_ACCT_ADDR_MAX );
+
+  /* All the account indices must be below acct_addr_cnt +
+     addr_table_adtl_cnt (which is at most 128 at this point) */
+
+  CHECK( !_mm512_cmpge_epu8_mask( max_acct, _mm512_set1_epi8( (char)(acct_addr_cnt+addr_table_adtl_cnt) ) ) );
+
+  parsed->addr_table_lookup_cnt        = (uchar)addr_table_cnt;
+  parsed->addr_table_adtl_writable_cnt = (uchar)addr_table_adtl_writable_cnt;
+  parsed->addr_table_adtl_cnt          = (uchar)addr_table_adtl_cnt;
+  parsed->_padding_reserved_1          = (uchar)0;
+
+  return fd_txn_footprint( instr_cnt, addr_table_cnt );
+
+# undef CHECK
+# undef CHECK_LEFT
+# undef READ_CHECKED_COMPACT_U16
+}
+
+ulong
+fd_txn_parse_batch( uchar const * const       payload[],
+                    ulong const               payload_sz[],
+                    ulong                     cnt,
+                    void * const              out_buf[],
+                    ulong                     out_sz[],
+                    fd_txn_parse_counters_t * counters_opt ) {
+  ulong ok_cnt = 0UL;
+
+  for( ulong b=0UL; b<cnt; b+=LANE_CNT ) {
+    ulong lane_cnt = fd_ulong_min( cnt-b, LANE_CNT );
+    ulong off[ LANE_CNT ];
+    int   m = header( payload+b, payload_sz+b, out_buf+b, (int)((1UL<<lane_cnt)-1UL), off );
+
+    for( ulong l=0UL; l<lane_cnt; l++ ) {
+      ulong idx = b+l;
+      ulong sz  = (m>>l)&1 ? body( payload[ idx ], payload_sz[ idx ], (fd_txn_t *)out_buf[ idx ], off[ l ] ) : 0UL;
+      if( FD_LIKELY( sz ) ) {
+        if( FD_LIKELY( counters_opt ) ) counters_opt->success_cnt++;
+      } else {
+        sz = fd_txn_parse_core( payload[ idx ], payload_sz[ idx ], out_buf[ idx ], counters_opt, NULL );
+      }
+      out_sz[ idx ] = sz;
+      ok_cnt += (ulong)!!sz;
+    }
+  }
+
+  return ok_cnt;
+}
+
+#undef INSTR_MAX
+#undef LANE_CNT
+
+#endif /* FD_HAS_AVX512 */
@@ -37,6 +37,38 @@ LLVMFuzzerTestOneInput( uchar const * data,
     FD_TEST( fd_txn_footprint( txn->instr_cnt, txn->addr_table_lookup_cnt )<=FD_TXN_MAX_SZ );
   }
 
+  /* fd_txn_parse_batch must match fd_txn_parse exactly.  The batch
+     holds the input and some truncations of it (so it covers several
+     lanes of the vectorized parser with different outcomes). */
+
+# define BATCH_CNT (11UL)
+  static uchar __attribute__((aligned((alignof(fd_txn_t))))) ref_buf  [ BATCH_CNT ][ FD_TXN_MAX_SZ ];
+  static uchar __attribute__((aligned((alignof(fd_txn_t))))) batch_buf[ BATCH_CNT ][ FD_TXN_MAX_SZ ];
+  uchar const *           payload   [ BATCH_CNT ];
+  ulong                   payload_sz[ BATCH_CNT ];
+  void *                  out       [ BATCH_CNT ];
+  ulong                   out_sz    [ BATCH_CNT ];
+  ulong                   ref_sz    [ BATCH_CNT ];
+  fd_txn_parse_counters_t ref_counters   = {0};
+  fd_txn_parse_counters_t batch_counters = {0};
+  ulong                   ref_ok         = 0UL;
+  for( ulong i=0UL; i<BATCH_CNT; i++ ) {
+    payload   [ i ] = data;
+    payload_sz[ i ] = i ? size - fd_ulong_min( size, (i*i*size)/(BATCH_CNT*BATCH_CNT) + (i&1UL) ) : size;
+    out       [ i ] = batch_buf[ i ];
+    memset( ref_buf  [ i ], 0, FD_TXN_MAX_SZ );
+    memset( batch_buf[ i ], 0, FD_TXN_MAX_SZ );
+    ref_sz[ i ] = fd_txn_parse( payload[ i ], payload_sz[ i ], ref_buf[ i ], &ref_counters );
+    ref_ok     += (ulong)!!ref_sz[ i ];
+  }
+  FD_TEST( fd_txn_parse_batch( payload, payload_sz, BATCH_CNT, out, out_sz, &batch_counters )==ref_ok );
+  for( ulong i=0UL; i<BATCH_CNT; i++ ) {
+    FD_TEST( out_sz[ i ]==ref_sz[ i ] );
+    if( ref_sz[ i ] ) FD_TEST( !memcmp( ref_buf[ i ], batch_buf[ i ], ref_sz[ i ] ) );
+  }
+  FD_TEST( !memcmp( &ref_counters, &batch_counters, sizeof(fd_txn_parse_counters_t) ) );
+# undef BATCH_CNT
+
   FD_FUZZ_MUST_BE_COVERED;
   return 0;
 }
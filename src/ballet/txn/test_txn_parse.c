@@ -221,6 +221,96 @@ void test_mutate( uchar const * payload,
 }
 
 
+/* test_batch checks fd_txn_parse_batch against fd_txn_parse on batches
+   of randomly corrupted and truncated copies of the given transactions
+   (the batch is sized so that it doesn't divide evenly into the lanes
+   of the vectorized parser). */
+
+#define BATCH_MAX (61UL)
+
+uchar batch_payload[ BATCH_MAX ][ FD_TXN_MTU ];
+uchar batch_ref    [ BATCH_MAX ][ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+uchar batch_out    [ BATCH_MAX ][ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+
+void test_batch( fd_rng_t *          rng,
+                 uchar const * const txn[],
+                 ulong const         txn_sz[],
+                 ulong               txn_cnt ) {
+  uchar const * payload   [ BATCH_MAX ];
+  ulong         payload_sz[ BATCH_MAX ];
+  void *        out       [ BATCH_MAX ];
+  ulong         out_sz    [ BATCH_MAX ];
+
+  fd_txn_parse_counters_t ref_counters   = {0};
+  fd_txn_parse_counters_t batch_counters = {0};
+
+  for( ulong iter=0UL; iter<10000UL; iter++ ) {
+    ulong cnt    = fd_rng_ulong_roll( rng, BATCH_MAX+1UL );
+    ulong ref_ok = 0UL;
+    for( ulong i=0UL; i<cnt; i++ ) {
+      ulong t  = fd_rng_ulong_roll( rng, txn_cnt );
+      ulong sz = txn_sz[ t ];
+      fd_memcpy( batch_payload[ i ], txn[ t ], sz );
+      switch( fd_rng_uint_roll( rng, 4U ) ) {
+      case 0U: break;
+      case 1U: sz = fd_rng_ulong_roll( rng, sz+1UL ); break;
+      default: {
+        /* Corrupt a byte, usually in the header */
+        ulong off = fd_rng_ulong_roll( rng, fd_ulong_if( (int)fd_rng_uint_roll( rng, 2U ), sz, fd_ulong_min( sz, 80UL ) ) );
+        batch_payload[ i ][ off ] = fd_rng_uchar( rng );
+        break;
+      }
+      }
+      payload   [ i ] = batch_payload[ i ];
+      payload_sz[ i ] = sz;
+      out       [ i ] = batch_out[ i ];
+
+      fd_memset( batch_ref[ i ], 0, FD_TXN_MAX_SZ );
+      fd_memset( batch_out[ i ], 0, FD_TXN_MAX_SZ );
+      ulong ref_sz = fd_txn_parse( payload[ i ], sz, batch_ref[ i ], &ref_counters );
+      out_sz[ i ] = ref_sz ^ 1UL; /* Make sure it gets written */
+      ref_ok += (ulong)!!ref_sz;
+    }
+
+    FD_TEST( fd_txn_parse_batch( payload, payload_sz, cnt, out, out_sz, &batch_counters )==ref_ok );
+    for( ulong i=0UL; i<cnt; i++ ) {
+      FD_TEST( out_sz[ i ]==fd_txn_parse( payload[ i ], payload_sz[ i ], batch_ref[ i ], NULL ) );
+      if( out_sz[ i ] ) FD_TEST( !memcmp( batch_ref[ i ], batch_out[ i ], out_sz[ i ] ) );
+    }
+  }
+
+  FD_TEST( ref_counters.success_cnt );
+  FD_TEST( ref_counters.failure_cnt );
+  FD_TEST( !memcmp( &ref_counters, &batch_counters, sizeof(fd_txn_parse_counters_t) ) );
+
+  /* NULL counters */
+  for( ulong i=0UL; i<BATCH_MAX; i++ ) {
+    ulong t = i%txn_cnt;
+    payload   [ i ] = txn   [ t ];
+    payload_sz[ i ] = txn_sz[ t ];
+    out       [ i ] = batch_out[ i ];
+  }
+  fd_txn_parse_batch( payload, payload_sz, BATCH_MAX, out, out_sz, NULL );
+  for( ulong i=0UL; i<BATCH_MAX; i++ ) FD_TEST( out_sz[ i ]==fd_txn_parse( payload[ i ], payload_sz[ i ], batch_ref[ i ], NULL ) );
+}
+
+void test_batch_performance( uchar const * payload,
+                             ulong         sz ) {
+  uchar const * batch   [ BATCH_MAX ];
+  ulong         batch_sz[ BATCH_MAX ];
+  void *        out     [ BATCH_MAX ];
+  ulong         out_sz  [ BATCH_MAX ];
+  for( ulong i=0UL; i<BATCH_MAX; i++ ) { batch[ i ] = payload; batch_sz[ i ] = sz; out[ i ] = batch_out[ i ]; }
+
+  const ulong test_count = 10000000UL/BATCH_MAX;
+  long start = fd_log_wallclock( );
+  for( ulong i = 0; i < test_count; i++ ) {
+    FD_TEST( fd_txn_parse_batch( batch, batch_sz, BATCH_MAX, out, out_sz, NULL )==BATCH_MAX );
+  }
+  long end = fd_log_wallclock( );
+  FD_LOG_NOTICE(( "Average time per batched parse: %f ns", (double)(end-start)/(double)(test_count*BATCH_MAX) ));
+}
+
 void test_performance( uchar const * payload,
                        ulong sz ) {
   const ulong test_count = 10000000UL;
@@ -248,6 +338,13 @@ main( int     argc,
   test_mutate( transaction1, transaction1_sz );
   test_mutate( transaction2, transaction2_sz );
 
+  uchar const * txns  [ 6 ] = { transaction1,    transaction2,    transaction3,    transaction4,    transaction5,    transaction6    };
+  ulong         txn_sz[ 6 ] = { transaction1_sz, transaction2_sz, transaction3_sz, transaction4_sz, transaction5_sz, transaction6_sz };
+  test_batch( rng, txns, txn_sz, 6UL );
+
+  test_batch_performance( transaction1, transaction1_sz );
+  test_batch_performance( transaction2, transaction2_sz );
+
   fd_memset( out_buf+FD_TXN_MAX_SZ, RED_ZONE_VAL, RED_ZONE_SZ );
   fd_asan_poison( out_buf+FD_TXN_MAX_SZ, RED_ZONE_SZ );
 
@@ -414,6 +414,59 @@ fd_wsample_restore_all( fd_wsample_t * sampler ) {
   return sampler;
 }
 
+/* RESTORE_SEEN_MAX bounds the number of internal nodes tracked by
+   fd_wsample_restore_removed to avoid restoring a node twice.  Nodes
+   are stored level by level, so this covers the top levels of the
+   tree, which are the ones shared by many removed elements.  Nodes
+   below that are simply restored once per removed element under them,
+   which is rare. */
+#define RESTORE_SEEN_MAX (4096UL)
+
+fd_wsample_t *
+fd_wsample_restore_removed( fd_wsample_t * sampler,
+                            ulong const  * idxs,
+                            ulong          cnt ) {
+  if( FD_UNLIKELY( !sampler->restore_enabled ) )  return NULL;
+
+  /* Copying nodes one path at a time is slower per node than one big
+     memcpy, so only bother when it touches well under the whole tree. */
+  ulong internal_cnt = sampler->internal_node_cnt;
+  if( FD_UNLIKELY( 2UL*cnt*sampler->height>=internal_cnt ) ) return fd_wsample_restore_all( sampler );
+
+  tree_ele_t       * tree = sampler->tree;
+  tree_ele_t const * orig = sampler->tree+internal_cnt+1UL;
+
+  ulong seen_max = fd_ulong_min( internal_cnt, RESTORE_SEEN_MAX );
+  ulong seen[ RESTORE_SEEN_MAX/64UL ];
+  memset( seen, 0, ((seen_max+63UL)/64UL)*sizeof(ulong) );
+
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong idx = idxs[ i ];
+    if( FD_UNLIKELY( idx>=sampler->total_cnt ) ) continue;
+
+    /* Walk from the leaf to the root, restoring each node on the path.
+       Parents have smaller indices than their children, so once the
+       walk reaches a node that was already restored, the rest of the
+       path was restored by the walk that got there first. */
+    ulong cursor = idx + internal_cnt;
+    for( ulong h=0UL; h<sampler->height; h++ ) {
+      ulong parent = (cursor-1UL)/R;
+      if( parent<seen_max ) {
+        ulong bit = 1UL<<(parent&63UL);
+        if( seen[ parent>>6 ] & bit ) break;
+        seen[ parent>>6 ] |= bit;
+      }
+      tree[ parent ] = orig[ parent ];
+      cursor = parent;
+    }
+  }
+
+  sampler->unremoved_weight = sampler->total_weight;
+  sampler->unremoved_cnt    = sampler->total_cnt;
+  sampler->poisoned_mode    = 0;
+  return sampler;
+}
+
 #define fd_ulong_if_force( c, t, f ) (__extension__({ \
       ulong result;                                   \
       __asm__( "testl  %1, %1; \n\t"                  \
@@ -191,6 +191,25 @@ void fd_wsample_remove_idx( fd_wsample_t * sampler, ulong idx );
    in which case no elements are restored. */
 fd_wsample_t * fd_wsample_restore_all( fd_wsample_t * sampler );
 
+/* fd_wsample_restore_removed is equivalent to fd_wsample_restore_all
+   when idxs[i] for i in [0, cnt) includes every element removed since
+   the last restore, but it only rewrites the parts of the tree on the
+   paths from those elements to the root.  This makes repeated partial
+   shuffles over the same weights (sample a few elements without
+   replacement, restore, reseed, repeat) cost proportional to the
+   number of elements sampled rather than to ele_cnt.  Entries of idxs
+   that are FD_WSAMPLE_EMPTY or FD_WSAMPLE_INDETERMINATE (or otherwise
+   not in [0, ele_cnt)) are ignored and duplicates are fine, so the
+   output of the sample_and_remove functions can be passed directly.
+   If idxs omits a removed element, the sampler is left in an
+   undefined state.  Falls back to fd_wsample_restore_all when cnt is
+   large relative to the size of the tree.  Returns sampler on success
+   and NULL if sampler was constructed with restore_enabled set to 0. */
+fd_wsample_t *
+fd_wsample_restore_removed( fd_wsample_t * sampler,
+                            ulong const  * idxs,
+                            ulong          cnt );
+
 
 
 #endif /* HEADER_fd_src_ballet_shred_fd_wsample_h */
@@ -463,6 +463,80 @@ test_poison( void ) {
   fd_chacha20rng_delete( fd_chacha20rng_leave( rng ) );
 }
 
+/* Runs many partial shuffles with two samplers over the same weights,
+   restoring one with fd_wsample_restore_all and the other with
+   fd_wsample_restore_removed, and checks they always agree. */
+static void
+test_restore_removed( void ) {
+  fd_chacha20rng_t _rng1[1];
+  fd_chacha20rng_t _rng2[1];
+  fd_chacha20rng_t * rng1 = fd_chacha20rng_join( fd_chacha20rng_new( _rng1, FD_CHACHA20RNG_MODE_SHIFT ) );
+  fd_chacha20rng_t * rng2 = fd_chacha20rng_join( fd_chacha20rng_new( _rng2, FD_CHACHA20RNG_MODE_SHIFT ) );
+
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+
+  uchar round_seed[ 32 ];
+  memcpy( round_seed, seed, 32UL );
+
+  for( ulong poisoned=0UL; poisoned<2UL; poisoned++ ) {
+    ulong sz = 1000UL;
+    void * partial1 = fd_wsample_new_init( _shmem,  rng1, sz, 1, FD_WSAMPLE_HINT_POWERLAW_REMOVE );
+    void * partial2 = fd_wsample_new_init( _shmem2, rng2, sz, 1, FD_WSAMPLE_HINT_POWERLAW_REMOVE );
+    for( ulong i=0UL; i<sz; i++ ) {
+      partial1 = fd_wsample_new_add( partial1, 2000000UL / (i+1UL) );
+      partial2 = fd_wsample_new_add( partial2, 2000000UL / (i+1UL) );
+    }
+    fd_wsample_t * ws1 = fd_wsample_join( fd_wsample_new_fini( partial1, poisoned*200UL ) );
+    fd_wsample_t * ws2 = fd_wsample_join( fd_wsample_new_fini( partial2, poisoned*200UL ) );
+
+    ulong idxs1[ 1+150 ];
+    ulong idxs2[ 1+150 ];
+    for( ulong round=0UL; round<2000UL; round++ ) {
+      round_seed[ 0 ] = (uchar)round; round_seed[ 1 ] = (uchar)(round>>8);
+      fd_chacha20rng_init( rng1, round_seed );
+      fd_chacha20rng_init( rng2, round_seed );
+
+      /* Remove one element by index first, like Turbine does with the
+         leader, then sample a few without replacement. */
+      idxs2[ 0 ] = fd_rng_ulong_roll( rng, sz );
+      fd_wsample_remove_idx( ws1, idxs2[ 0 ] );
+      fd_wsample_remove_idx( ws2, idxs2[ 0 ] );
+
+      ulong cnt = 1UL + fd_rng_ulong_roll( rng, 100UL ); /* small enough to not fall back to restore_all */
+      fd_wsample_sample_and_remove_many( ws1, idxs1+1, cnt );
+      fd_wsample_sample_and_remove_many( ws2, idxs2+1, cnt );
+      FD_TEST( !memcmp( idxs1+1, idxs2+1, cnt*sizeof(ulong) ) );
+
+      FD_TEST( fd_wsample_restore_all    ( ws1              )==ws1 );
+      FD_TEST( fd_wsample_restore_removed( ws2, idxs2, 1+cnt )==ws2 );
+    }
+
+    /* Restoring everything falls back to restore_all */
+    for( ulong i=0UL; i<sz; i++ ) counts[ i ] = i;
+    fd_wsample_sample_and_remove_many( ws2, idxs2, 150UL );
+    FD_TEST( fd_wsample_restore_removed( ws2, counts, sz )==ws2 );
+    fd_chacha20rng_init( rng1, round_seed );
+    fd_chacha20rng_init( rng2, round_seed );
+    fd_wsample_sample_and_remove_many( ws1, idxs1, 150UL );
+    fd_wsample_sample_and_remove_many( ws2, idxs2, 150UL );
+    FD_TEST( !memcmp( idxs1, idxs2, 150UL*sizeof(ulong) ) );
+
+    fd_wsample_delete( fd_wsample_leave( ws1 ) );
+    fd_wsample_delete( fd_wsample_leave( ws2 ) );
+  }
+  /* Restore disabled */
+  void * partial = fd_wsample_new_init( _shmem, rng1, 2UL, 0, FD_WSAMPLE_HINT_FLAT );
+  fd_wsample_t * ws = fd_wsample_join( fd_wsample_new_fini( fd_wsample_new_add( fd_wsample_new_add( partial, 2UL ), 1UL ), 0UL ) );
+  ulong idx = fd_wsample_sample_and_remove( ws );
+  FD_TEST( fd_wsample_restore_removed( ws, &idx, 1UL )==NULL );
+  fd_wsample_delete( fd_wsample_leave( ws ) );
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_chacha20rng_delete( fd_chacha20rng_leave( rng1 ) );
+  fd_chacha20rng_delete( fd_chacha20rng_leave( rng2 ) );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -479,6 +553,7 @@ main( int     argc,
   test_empty();
   test_footprint();
   test_poison();
+  test_restore_removed();
 
   test_probability_dist_replacement();
   test_probability_dist_noreplacement();
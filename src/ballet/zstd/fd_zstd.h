@@ -154,7 +154,95 @@ fd_zstd_dstream_read( fd_zstd_dstream_t *     dstream,
                       uchar *                 out_end,
                       ulong *                 opt_errcode );
 
-/* TODO: Migrate compression logic from fd_snapshot_create. to fd_zstd.h */
+FD_PROTOTYPES_END
+
+/* Compress API *******************************************************/
+
+/* fd_zstd_cstream_t provides streaming compression into Zstandard
+   frames.  Produces one frame at a time. */
+
+struct fd_zstd_cstream;
+typedef struct fd_zstd_cstream fd_zstd_cstream_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_zstd_cstream_{align,footprint} return the parameters of the
+   memory region backing a fd_zstd_cstream_t.  level is the compression
+   level (as in the zstd command line tool, 1 to 22).  The footprint
+   grows quickly with level: a few MiB at level 3 but hundreds of MiB
+   for the highest levels. */
+
+FD_FN_CONST ulong
+fd_zstd_cstream_align( void );
+
+FD_FN_CONST ulong
+fd_zstd_cstream_footprint( int level );
+
+/* fd_zstd_cstream_new creates a new cstream object compressing at
+   the given level backed by the memory region at mem.  mem matches
+   align/footprint requirements for level.  Returns a handle to the
+   newly created cstream object on success (not just a simple cast of
+   mem).  The cstream expects the start of a frame of unknown size on
+   return.  On failure, returns NULL. */
+
+fd_zstd_cstream_t *
+fd_zstd_cstream_new( void * mem,
+                     int    level );
+
+/* fd_zstd_cstream_delete destroys the cstream object and releases its
+   memory region back to the caller.  Returns pointer to memory region
+   on success (same as provided in call to new).  Acts as a no-op if
+   cstream==NULL. */
+
+void *
+fd_zstd_cstream_delete( fd_zstd_cstream_t * cstream );
+
+/* fd_zstd_cstream_reset discards any frame in progress and prepares
+   cstream for a new frame.  frame_content_sz is the exact number of
+   bytes that will be compressed into the frame (ULONG_MAX if unknown).
+   It is recorded in the frame header, so that readers can size their
+   buffers up front.  Returns 0 on success and EINVAL if
+   frame_content_sz could not be applied. */
+
+int
+fd_zstd_cstream_reset( fd_zstd_cstream_t * cstream,
+                       ulong               frame_content_sz );
+
+/* fd_zstd_cstream_write compresses a fragment of frame data.
+
+   *in_p, in_end, *out_p and out_end have the same meaning as in
+   fd_zstd_dstream_read, with the input being uncompressed data and the
+   output compressed data.  If end is zero, more data will follow for
+   the current frame.  If end is non-zero, [*in_p,in_end) is the last
+   fragment of the frame and the frame is finished.
+
+   Returns fd_io compatible error code.  Returns 0 if the compressor
+   made progress.  If end is zero, the caller should call again while
+   *in_p<in_end (providing more output space if *out_p==out_end).  If
+   end is non-zero, the caller should call again with more output space
+   until -1 is returned, which indicates the frame was fully flushed
+   to the output.  The cstream then expects the start of a new frame
+   of unknown size.  Returns EPROTO on error, in which case the caller
+   should reset the cstream.  If opt_errcode!=NULL and an error
+   occured, *opt_errcode is set accordingly. */
+
+int
+fd_zstd_cstream_write( fd_zstd_cstream_t *     cstream,
+                       uchar const ** restrict in_p,
+                       uchar const *           in_end,
+                       uchar ** restrict       out_p,
+                       uchar *                 out_end,
+                       int                     end,
+                       ulong *                 opt_errcode );
+
+/* fd_zstd_compress_bound returns the max size of a frame compressing
+   sz bytes of data. */
+
+FD_FN_CONST ulong
+fd_zstd_compress_bound( ulong sz );
+
+/* TODO: Migrate compression logic from fd_snapshot_create to
+   fd_zstd_cstream_t */
 
 FD_PROTOTYPES_END
 
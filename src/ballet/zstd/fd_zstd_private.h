@@ -15,3 +15,18 @@ struct __attribute__((aligned(FD_ZSTD_DSTREAM_ALIGN))) fd_zstd_dstream {
 
   __extension__ uchar mem[0];
 };
+
+#define FD_ZSTD_CSTREAM_MAGIC (0x5f1d3c0a88e2c7b4UL)  /* random */
+
+struct __attribute__((aligned(FD_ZSTD_CSTREAM_ALIGN))) fd_zstd_cstream {
+  /* This point is 64-byte aligned */
+
+  ulong magic;
+  ulong mem_sz;
+
+  uchar pad[48];
+
+  /* This point is 64-byte aligned */
+
+  __extension__ uchar mem[0];
+};
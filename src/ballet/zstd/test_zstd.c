@@ -3,6 +3,8 @@
 #include "../../util/fd_util.h"
 #include <stdalign.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <errno.h>
 
 #if !FD_HAS_ZSTD
 #error "fd_compress requires Zstandard"
@@ -12,6 +14,8 @@
 
 FD_STATIC_ASSERT( alignof ( fd_zstd_dstream_t      )==FD_ZSTD_DSTREAM_ALIGN, layout );
 FD_STATIC_ASSERT( offsetof( fd_zstd_dstream_t, mem )==FD_ZSTD_DSTREAM_ALIGN, layout );
+FD_STATIC_ASSERT( alignof ( fd_zstd_cstream_t      )==FD_ZSTD_CSTREAM_ALIGN, layout );
+FD_STATIC_ASSERT( offsetof( fd_zstd_cstream_t, mem )==FD_ZSTD_CSTREAM_ALIGN, layout );
 
 /* Test vectors */
 
@@ -130,6 +134,86 @@ test_decompress( void ) {
   FD_TEST( dstream->magic==0UL );
 }
 
+static uchar test_compress_in [ 1UL<<18 ];
+static uchar test_compress_out[ 1UL<<18 ];
+static uchar test_compress_rt [ 1UL<<18 ];
+
+static void
+test_compress( void ) {
+  FD_TEST( fd_zstd_cstream_align()==FD_ZSTD_CSTREAM_ALIGN );
+
+  /* Compressible input: a few repeated random words */
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+  ulong words[ 16 ];
+  for( ulong i=0UL; i<16UL; i++ ) words[ i ] = fd_rng_ulong( rng );
+  for( ulong i=0UL; i<sizeof(test_compress_in); i+=8UL ) {
+    FD_STORE( ulong, test_compress_in+i, words[ fd_rng_uint_roll( rng, 16U ) ] );
+  }
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  ulong cmem_sz = fd_zstd_cstream_footprint( 3 );
+  uchar * cmem = aligned_alloc( FD_ZSTD_CSTREAM_ALIGN, fd_ulong_align_up( cmem_sz, FD_ZSTD_CSTREAM_ALIGN ) );
+  FD_TEST( cmem );
+
+  fd_zstd_cstream_t * cstream = fd_zstd_cstream_new( cmem, 3 );
+  FD_TEST( cstream );
+  FD_TEST( cstream->magic==FD_ZSTD_CSTREAM_MAGIC );
+  FD_TEST( cstream->mem_sz + sizeof(fd_zstd_cstream_t) == cmem_sz );
+
+  ulong window_sz = 1UL<<21;
+  ulong dmem_sz   = fd_zstd_dstream_footprint( window_sz );
+  uchar * dmem = aligned_alloc( FD_ZSTD_DSTREAM_ALIGN, fd_ulong_align_up( dmem_sz, FD_ZSTD_DSTREAM_ALIGN ) );
+  FD_TEST( dmem );
+  fd_zstd_dstream_t * dstream = fd_zstd_dstream_new( dmem, window_sz );
+  FD_TEST( dstream );
+
+  for( ulong k=0UL; k<2UL; k++ ) {
+
+    /* Compress in two fragments, the first with end==0, pledging the
+       frame size (k==0) or not (k==1).  Without a pledge, libzstd may
+       still record the size if the frame was buffered whole. */
+
+    ulong sz = sizeof(test_compress_in);
+    FD_TEST( !fd_zstd_cstream_reset( cstream, k ? ULONG_MAX : sz ) );
+
+    uchar const * in_cur  = test_compress_in;
+    uchar *       out_cur = test_compress_out;
+    while( in_cur<test_compress_in+sz/2UL ) {
+      FD_TEST( !fd_zstd_cstream_write( cstream, &in_cur, test_compress_in+sz/2UL, &out_cur, test_compress_out+sizeof(test_compress_out), 0, NULL ) );
+    }
+    int rc;
+    do {
+      rc = fd_zstd_cstream_write( cstream, &in_cur, test_compress_in+sz, &out_cur, test_compress_out+sizeof(test_compress_out), 1, NULL );
+      FD_TEST( rc<=0 );
+    } while( rc!=-1 );
+    FD_TEST( in_cur==test_compress_in+sz );
+
+    ulong csz = (ulong)(out_cur-test_compress_out);
+    FD_TEST( csz<sz/4UL );
+    FD_TEST( csz<=fd_zstd_compress_bound( sz ) );
+
+    fd_zstd_peek_t peek[1] = {0};
+    FD_TEST( fd_zstd_peek( peek, test_compress_out, csz )==peek );
+    if( !k ) FD_TEST( peek->frame_content_sz==sz );
+
+    /* Round trip */
+
+    uchar const * din_cur  = test_compress_out;
+    uchar *       dout_cur = test_compress_rt;
+    FD_TEST( fd_zstd_dstream_read( dstream, &din_cur, test_compress_out+csz, &dout_cur, test_compress_rt+sizeof(test_compress_rt), NULL )==-1 );
+    FD_TEST( din_cur==test_compress_out+csz );
+    FD_TEST( dout_cur==test_compress_rt+sz );
+    FD_TEST( !memcmp( test_compress_in, test_compress_rt, sz ) );
+  }
+
+  FD_TEST( fd_zstd_dstream_delete( dstream )==dmem );
+  FD_TEST( fd_zstd_cstream_delete( cstream )==cmem );
+  FD_TEST( cstream->magic==0UL );
+  free( dmem );
+  free( cmem );
+}
+
 #define ZSTD_STATIC_LINKING_ONLY
 #include <zstd.h>
 
@@ -151,6 +235,7 @@ main( int     argc,
   }
 
   test_decompress();
+  test_compress();
 
   for( int lvl=0; lvl<20; lvl++ ) {
     FD_LOG_INFO(( "ZSTD_estimateCCtxSize(%d) = %lu", lvl, ZSTD_estimateCCtxSize( lvl ) ));
@@ -40,6 +40,10 @@ fd_forks_new( void * shmem, ulong max, ulong seed ) {
   fd_fork_frontier_new( (void *)laddr, max, seed );
   laddr += fd_fork_frontier_footprint( max );
 
+  laddr = fd_ulong_align_up( laddr, fd_sysvar_cache_store_align() );
+  fd_sysvar_cache_store_new( (void *)laddr, max, seed );
+  laddr += fd_sysvar_cache_store_footprint( max );
+
   return shmem;
 }
 
@@ -71,6 +75,10 @@ fd_forks_join( void * shforks ) {
   forks->frontier = fd_fork_frontier_join( (void *)laddr );
   laddr += fd_fork_frontier_footprint( max );
 
+  laddr                     = fd_ulong_align_up( laddr, fd_sysvar_cache_store_align() );
+  forks->sysvar_cache_store = fd_sysvar_cache_store_join( (void *)laddr );
+  laddr += fd_sysvar_cache_store_footprint( max );
+
   return (fd_forks_t *)shforks;
 }
 
@@ -186,13 +194,14 @@ fd_forks_query_const( fd_forks_t const * forks, ulong slot ) {
 // }
 
 static void
-slot_ctx_restore( ulong                 slot,
-                  fd_acc_mgr_t *        acc_mgr,
-                  fd_blockstore_t *     blockstore,
-                  fd_exec_epoch_ctx_t * epoch_ctx,
-                  fd_funk_t *           funk,
-                  fd_valloc_t           valloc,
-                  fd_exec_slot_ctx_t *  slot_ctx_out ) {
+slot_ctx_restore( ulong                     slot,
+                  fd_sysvar_cache_store_t * sysvar_cache_store,
+                  fd_acc_mgr_t *            acc_mgr,
+                  fd_blockstore_t *         blockstore,
+                  fd_exec_epoch_ctx_t *     epoch_ctx,
+                  fd_funk_t *               funk,
+                  fd_valloc_t               valloc,
+                  fd_exec_slot_ctx_t *      slot_ctx_out ) {
   fd_funk_txn_t *  txn_map = fd_funk_txn_map( funk, fd_funk_wksp( funk ) );
   fd_block_map_t * block = fd_block_map_query( fd_blockstore_block_map( blockstore ), &slot, NULL );
   FD_LOG_DEBUG( ( "Current slot %lu", slot ) );
@@ -244,7 +253,18 @@ slot_ctx_restore( ulong                 slot,
   } else {
     FD_LOG_ERR( ( "failed to read banks record: invalid magic number" ) );
   }
-  FD_TEST( !fd_runtime_sysvar_cache_load( slot_ctx_out ) );
+
+  /* The parent's funk txn has already been replayed, so its sysvars can
+     be shared with every other fork started at the same parent. */
+
+  fd_sysvar_cache_t * sysvar_cache = fd_sysvar_cache_store_acquire( sysvar_cache_store, &xid, acc_mgr, txn, valloc );
+  if( FD_LIKELY( sysvar_cache ) ) {
+    fd_valloc_free( valloc, fd_sysvar_cache_delete( slot_ctx_out->sysvar_cache ) );
+    slot_ctx_out->sysvar_cache = sysvar_cache;
+  } else {
+    FD_TEST( !fd_runtime_sysvar_cache_load( slot_ctx_out ) );
+  }
+  slot_ctx_out->sysvar_cache_store = sysvar_cache_store;
 
   // TODO how do i get this info, ignoring rewards for now
   // slot_ctx_out->epoch_reward_status = ???
@@ -315,7 +335,7 @@ fd_forks_prepare( fd_forks_t const *    forks,
 
     /* Restore and decode w/ funk */
 
-    slot_ctx_restore( fork->slot, acc_mgr, blockstore, epoch_ctx, funk, valloc, slot_ctx );
+    slot_ctx_restore( fork->slot, forks->sysvar_cache_store, acc_mgr, blockstore, epoch_ctx, funk, valloc, slot_ctx );
 
     /* Add to frontier */
 
@@ -40,8 +40,10 @@ typedef struct fd_fork fd_fork_t;
 #include "../../util/tmpl/fd_map_chain.c"
 
 struct fd_forks {
-  fd_fork_frontier_t * frontier; /* the fork heads, map of slot->fd_fork_t */
-  fd_fork_t *          pool;     /* memory pool of fd_fork_t */
+  fd_fork_frontier_t *      frontier;           /* the fork heads, map of slot->fd_fork_t */
+  fd_fork_t *               pool;               /* memory pool of fd_fork_t */
+  fd_sysvar_cache_store_t * sysvar_cache_store; /* sysvar caches shared between forks
+                                                   started at the same parent */
 };
 typedef struct fd_forks fd_forks_t;
 
@@ -60,10 +62,12 @@ fd_forks_footprint( ulong max ) {
     FD_LAYOUT_APPEND(
     FD_LAYOUT_APPEND(
     FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
     FD_LAYOUT_INIT,
-      alignof(fd_forks_t),      sizeof(fd_forks_t) ),
-      fd_fork_pool_align(),     fd_fork_pool_footprint( max ) ),
-      fd_fork_frontier_align(), fd_fork_frontier_footprint( max ) ),
+      alignof(fd_forks_t),           sizeof(fd_forks_t) ),
+      fd_fork_pool_align(),          fd_fork_pool_footprint( max ) ),
+      fd_fork_frontier_align(),      fd_fork_frontier_footprint( max ) ),
+      fd_sysvar_cache_store_align(), fd_sysvar_cache_store_footprint( max ) ),
     alignof(fd_forks_t) );
 }
 
@@ -136,7 +140,8 @@ fd_forks_advance( fd_forks_t const * forks, fd_fork_t * fork, ulong slot );
 /* fd_forks_prepare prepares a fork for execution.  The fork will either
    be an existing fork in the frontier if parent_slot is already a fork
    head or it will start a new fork at parent_slot and add it to the
-   frontier.
+   frontier.  A new fork shares the sysvar cache of any other fork
+   started at the same parent_slot (see fd_sysvar_cache_store.h).
 
    Returns fork on success, NULL on failure.  Failure reasons include
    parent_slot is not present in the blockstore, is not present in funk,
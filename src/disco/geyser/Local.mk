@@ -1,5 +1,8 @@
 ifdef FD_HAS_INT128
-$(call add-hdrs,fd_geyser.h)
-$(call add-objs,fd_geyser,fd_disco)
+$(call add-hdrs,fd_geyser.h fd_geyser_acct.h)
+$(call add-objs,fd_geyser fd_geyser_acct,fd_disco)
 $(call make-unit-test,test_geyser,test_geyser,fd_reedsol fd_disco fd_flamenco fd_ballet fd_funk fd_tango fd_choreo fd_waltz fd_util)
+$(call make-unit-test,test_geyser_acct,test_geyser_acct,fd_disco fd_flamenco fd_tango fd_ballet fd_util)
+$(call run-unit-test,test_geyser_acct)
+$(call make-unit-test,bench_geyser_acct,bench_geyser_acct,fd_disco fd_flamenco fd_tango fd_ballet fd_util)
 endif
@@ -0,0 +1,203 @@
+#include "fd_geyser_acct.h"
+
+#if FD_HAS_HOSTED
+
+#include <stdlib.h>
+
+/* bench_geyser_acct measures the throughput of the replay_acct account
+   stream with a producer on tile 1 publishing account writes as fast as
+   it can (or at --rate writes/s) and a consumer on tile 0 reassembling
+   them, optionally through a filter.  Account data sizes follow a rough
+   mainnet mix: mostly token and system accounts (165 and 0 bytes),
+   some mid sized program state and a few large accounts.  For
+   reference, mainnet replay writes on the order of 10^4 to 10^5
+   accounts per second. */
+
+static fd_geyser_acct_tx_t * _tx;
+static ulong                 _write_cnt;
+static double                _rate;
+static int                   _go;
+static int                   _done;
+static long                  _tx_dt;
+static ulong                 _tx_sz;
+
+static uchar data[ 1UL<<20 ];
+
+static ulong
+bench_dlen( fd_rng_t * rng ) {
+  uint r = fd_rng_uint_roll( rng, 1000U );
+  if( r< 500U ) return 165UL;                                   /* token accounts */
+  if( r< 800U ) return 0UL;                                     /* system accounts */
+  if( r< 990U ) return 200UL + fd_rng_ulong_roll( rng, 3800UL ); /* program state */
+  return 4096UL + fd_rng_ulong_roll( rng, sizeof(data)-4096UL ); /* large accounts */
+}
+
+static int
+producer_main( int     argc,
+               char ** argv ) {
+  (void)argc; (void)argv;
+
+  fd_geyser_acct_tx_t * tx        = FD_VOLATILE_CONST( _tx        );
+  ulong                 write_cnt = FD_VOLATILE_CONST( _write_cnt );
+  double                rate      = FD_VOLATILE_CONST( _rate      );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1U, 0UL ) );
+
+  fd_geyser_acct_hdr_t hdr[1];
+  memset( hdr, 0, sizeof(fd_geyser_acct_hdr_t) );
+
+  while( !FD_VOLATILE_CONST( _go ) ) FD_SPIN_PAUSE();
+
+  ulong sz  = 0UL;
+  long  t0  = fd_log_wallclock();
+  for( ulong i=0UL; i<write_cnt; i++ ) {
+    if( rate>0. ) {
+      long next = t0 + (long)((double)i * 1e9 / rate);
+      while( fd_log_wallclock()<next ) FD_SPIN_PAUSE();
+    }
+
+    hdr->slot            = i;
+    hdr->address.ul[ 0 ] = fd_rng_ulong( rng );
+    hdr->meta.dlen       = bench_dlen( rng );
+    hdr->meta.info.owner[ 0 ] = (uchar)fd_rng_uint_roll( rng, 16U );
+    fd_geyser_acct_publish( tx, hdr, data, fd_frag_meta_ts_comp( fd_tickcount() ) );
+    sz += sizeof(fd_geyser_acct_hdr_t) + hdr->meta.dlen;
+  }
+  FD_VOLATILE( _tx_dt ) = fd_log_wallclock() - t0;
+  FD_VOLATILE( _tx_sz ) = sz;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( _done ) = 1;
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz  = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--page-sz",    NULL, "gigantic"            );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong ( &argc, &argv, "--page-cnt",   NULL, 1UL                   );
+  ulong        numa_idx  = fd_env_strip_cmdline_ulong ( &argc, &argv, "--numa-idx",   NULL, fd_shmem_numa_idx( 0 ) );
+  ulong        depth     = fd_env_strip_cmdline_ulong ( &argc, &argv, "--depth",      NULL, FD_GEYSER_ACCT_DEPTH  );
+  ulong        write_cnt = fd_env_strip_cmdline_ulong ( &argc, &argv, "--write-cnt",  NULL, 1000000UL             );
+  double       rate      = fd_env_strip_cmdline_double( &argc, &argv, "--rate",       NULL, 0.                    );
+  ulong        owner_cnt = fd_env_strip_cmdline_ulong ( &argc, &argv, "--owner-cnt",  NULL, 0UL                   );
+
+  if( FD_UNLIKELY( fd_tile_cnt()<2UL ) ) FD_LOG_ERR(( "this bench requires at least 2 tiles" ));
+  if( FD_UNLIKELY( owner_cnt>16UL    ) ) FD_LOG_ERR(( "--owner-cnt must be at most 16" ));
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-sz %s, --page-cnt %lu, --numa-idx %lu)", _page_sz, page_cnt, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  ulong  data_sz = fd_dcache_req_data_sz( FD_GEYSER_ACCT_MTU, depth, 1UL, 1 );
+  void * _mcache = fd_wksp_alloc_laddr( wksp, fd_mcache_align(), fd_mcache_footprint( depth, 0UL ), 1UL );
+  void * _dcache = fd_wksp_alloc_laddr( wksp, fd_dcache_align(), fd_dcache_footprint( data_sz, 0UL ), 1UL );
+  if( FD_UNLIKELY( (!_mcache) | (!_dcache) ) ) FD_LOG_ERR(( "workspace too small, increase --page-cnt" ));
+
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_mcache_new( _mcache, depth, 0UL, 0UL ) );
+  uchar *          dcache = fd_dcache_join( fd_dcache_new( _dcache, data_sz, 0UL ) );
+  FD_TEST( mcache && dcache );
+
+  fd_geyser_acct_tx_t tx[1];
+  FD_TEST( fd_geyser_acct_tx_init( tx, mcache, dcache, wksp ) );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+  for( ulong i=0UL; i<sizeof(data); i++ ) data[ i ] = fd_rng_uchar( rng );
+
+  /* Select owner_cnt of the 16 synthetic owners (0 selects all) */
+
+  fd_pubkey_t owner[ 16 ];
+  memset( owner, 0, sizeof(owner) );
+  for( ulong i=0UL; i<owner_cnt; i++ ) owner[ i ].uc[ 0 ] = (uchar)i;
+  fd_geyser_acct_filter_t filter[1];
+  FD_TEST( fd_geyser_acct_filter_init( filter, NULL, 0UL, owner, owner_cnt ) );
+
+  fd_geyser_acct_rx_t * rx = aligned_alloc( alignof(fd_geyser_acct_rx_t), sizeof(fd_geyser_acct_rx_t) );
+  FD_TEST( rx );
+  FD_TEST( fd_geyser_acct_rx_init( rx, owner_cnt ? filter : NULL ) );
+
+  FD_LOG_NOTICE(( "Publishing %lu account writes (--depth %lu --rate %g --owner-cnt %lu)", write_cnt, depth, rate, owner_cnt ));
+
+  _tx        = tx;
+  _write_cnt = write_cnt;
+  _rate      = rate;
+  FD_COMPILER_MFENCE();
+  fd_tile_exec_t * exec = fd_tile_exec_new( 1UL, producer_main, 0, NULL );
+  FD_TEST( exec );
+
+  ulong seq      = tx->seq;
+  ulong ovrn_cnt = 0UL;
+  ulong rx_sz    = 0UL;
+
+  FD_VOLATILE( _go ) = 1;
+  long dt = -fd_log_wallclock();
+  for(;;) {
+    fd_frag_meta_t const * mline = mcache + fd_mcache_line_idx( seq, depth );
+
+    ulong seq_found = fd_frag_meta_seq_query( mline );
+    long  diff      = fd_seq_diff( seq_found, seq );
+    if( FD_UNLIKELY( diff ) ) {
+      if( diff<0L ) {
+        if( FD_UNLIKELY( FD_VOLATILE_CONST( _done ) && seq==FD_VOLATILE_CONST( tx->seq ) ) ) break;
+        FD_SPIN_PAUSE();
+        continue;
+      }
+      ovrn_cnt += (ulong)diff;
+      seq       = seq_found;
+      continue;
+    }
+
+    ulong sig = mline->sig;
+    ulong ctl = mline->ctl;
+    ulong sz  = mline->sz;
+    fd_geyser_acct_rx_during( rx, seq, sig, ctl, fd_chunk_to_laddr_const( wksp, mline->chunk ), sz );
+
+    seq_found = fd_frag_meta_seq_query( mline );
+    if( FD_UNLIKELY( fd_seq_ne( seq_found, seq ) ) ) {
+      ovrn_cnt++;
+      seq = seq_found;
+      continue;
+    }
+
+    if( fd_geyser_acct_rx_after( rx ) ) rx_sz += sizeof(fd_geyser_acct_hdr_t) + rx->hdr.meta.dlen;
+    seq = fd_seq_inc( seq, 1UL );
+  }
+  dt += fd_log_wallclock();
+
+  FD_TEST( !fd_tile_exec_delete( exec, NULL ) );
+
+  double tx_s = (double)_tx_dt*1e-9;
+  double rx_s = (double)dt*1e-9;
+  FD_LOG_NOTICE(( "tx: %.3f M writes/s, %.3f GB/s", (double)write_cnt*1e-6/tx_s, (double)_tx_sz*1e-9/tx_s ));
+  FD_LOG_NOTICE(( "rx: %.3f M writes/s, %.3f GB/s (%lu received, %lu filtered, %lu dropped, %lu frags overrun)",
+                  (double)rx->msg_cnt*1e-6/rx_s, (double)rx_sz*1e-9/rx_s, rx->msg_cnt, rx->filt_cnt, rx->drop_cnt, ovrn_cnt ));
+
+  free( rx );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_wksp_free_laddr( fd_dcache_delete( fd_dcache_leave( dcache ) ) );
+  fd_wksp_free_laddr( fd_mcache_delete( fd_mcache_leave( mcache ) ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
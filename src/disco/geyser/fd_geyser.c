@@ -24,6 +24,11 @@
 #define SHAM_LINK_NAME    stake_sham_link
 #include "sham_link.h"
 
+#define SHAM_LINK_CONTEXT fd_geyser_t
+#define SHAM_LINK_STATE   fd_geyser_acct_rx_t
+#define SHAM_LINK_NAME    acct_sham_link
+#include "sham_link.h"
+
 struct fd_geyser {
   fd_funk_t *          funk;
   fd_blockstore_t *    blockstore;
@@ -31,6 +36,10 @@ struct fd_geyser {
   fd_stake_ci_t *      stake_ci;
   replay_sham_link_t * rep_notify;
   stake_sham_link_t *  stake_notify;
+  acct_sham_link_t *   acct_notify;  /* NULL if the account stream is not used */
+  fd_geyser_acct_filter_t * acct_filter;
+  fd_geyser_acct_rx_t *     acct_rx;
+  ulong                     acct_fallback_cnt; /* Notifications whose streamed accounts were looked up in funk */
 
   void * fun_arg;
   fd_geyser_execute_fun execute_fun; /* Slot numbers, bank hash */
@@ -49,6 +58,9 @@ fd_geyser_footprint( void ) {
   l = FD_LAYOUT_APPEND( l, fd_stake_ci_align(), fd_stake_ci_footprint() );
   l = FD_LAYOUT_APPEND( l, replay_sham_link_align(), replay_sham_link_footprint() );
   l = FD_LAYOUT_APPEND( l, stake_sham_link_align(), stake_sham_link_footprint() );
+  l = FD_LAYOUT_APPEND( l, acct_sham_link_align(), acct_sham_link_footprint() );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_geyser_acct_filter_t), sizeof(fd_geyser_acct_filter_t) );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_geyser_acct_rx_t), sizeof(fd_geyser_acct_rx_t) );
   return FD_LAYOUT_FINI( l, 1UL );
 }
 
@@ -64,6 +76,9 @@ fd_geyser_new( void * mem, fd_geyser_args_t * args ) {
   void * stake_ci_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_stake_ci_align(), fd_stake_ci_footprint() );
   void * rep_notify_mem = FD_SCRATCH_ALLOC_APPEND( l, replay_sham_link_align(), replay_sham_link_footprint() );
   void * stake_notify_mem = FD_SCRATCH_ALLOC_APPEND( l, stake_sham_link_align(), stake_sham_link_footprint() );
+  void * acct_notify_mem = FD_SCRATCH_ALLOC_APPEND( l, acct_sham_link_align(), acct_sham_link_footprint() );
+  void * acct_filter_mem = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_geyser_acct_filter_t), sizeof(fd_geyser_acct_filter_t) );
+  void * acct_rx_mem = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_geyser_acct_rx_t), sizeof(fd_geyser_acct_rx_t) );
   ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
   FD_TEST( scratch_top <= (ulong)mem + fd_geyser_footprint() );
 
@@ -99,6 +114,16 @@ fd_geyser_new( void * mem, fd_geyser_args_t * args ) {
   replay_sham_link_start( self->rep_notify );
   stake_sham_link_start( self->stake_notify );
 
+  self->acct_notify = NULL;
+  self->acct_fallback_cnt = 0UL;
+  if( args->acct_stream ) {
+    self->acct_filter = fd_geyser_acct_filter_init( acct_filter_mem, args->acct_addrs, args->acct_addr_cnt, args->acct_owners, args->acct_owner_cnt );
+    if( FD_UNLIKELY( !self->acct_filter ) ) FD_LOG_ERR(( "invalid account filter" ));
+    self->acct_rx = fd_geyser_acct_rx_init( acct_rx_mem, self->acct_filter );
+    self->acct_notify = acct_sham_link_new( acct_notify_mem, "fd1_replay_acct.wksp" );
+    acct_sham_link_start( self->acct_notify );
+  }
+
   self->execute_fun = args->execute_fun;
   self->block_fun = args->block_fun;
   self->block_done_fun = args->block_done_fun;
@@ -204,8 +229,8 @@ fd_geyser_replay_block( fd_geyser_t * ctx, ulong slotn ) {
 }
 
 static void
-replay_sham_link_during_frag( fd_geyser_t * ctx, fd_replay_notif_msg_t * state, void const * msg, int sz ) {
-  (void)ctx;
+replay_sham_link_during_frag( fd_geyser_t * ctx, fd_replay_notif_msg_t * state, ulong seq, ulong sig, ulong ctl, void const * msg, int sz ) {
+  (void)ctx; (void)seq; (void)sig; (void)ctl;
   FD_TEST( sz == (int)sizeof(fd_replay_notif_msg_t) );
   fd_memcpy(state, msg, sizeof(fd_replay_notif_msg_t));
 }
@@ -222,15 +247,40 @@ replay_sham_link_after_frag(fd_geyser_t * ctx, fd_replay_notif_msg_t * msg) {
 
   } else if( msg->type == FD_REPLAY_ACCTS_TYPE ) {
     if( ctx->acct_fun != NULL ) {
+      /* Streamed accounts were normally delivered by the account stream
+         already.  If frags of this message's range were lost on the
+         stream, they are looked up in funk like the others (written by
+         blocks we produced).  A streamed account that was received
+         before the loss may then be delivered twice. */
+      int streamed = 0;
+      if( ctx->acct_notify != NULL ) {
+        ulong seq0 = msg->accts.acct_seq0;
+        ulong seq1 = msg->accts.acct_seq1;
+        if( FD_UNLIKELY( fd_seq_lt( fd_geyser_acct_rx_seq( ctx->acct_rx ), seq1 ) ) ) {
+          acct_sham_link_poll( ctx->acct_notify, ctx, ctx->acct_rx );
+        }
+        streamed = !fd_geyser_acct_rx_lost( ctx->acct_rx, seq0, seq1 );
+        if( FD_UNLIKELY( !streamed ) ) ctx->acct_fallback_cnt++;
+      }
       for( uint i = 0; i < msg->accts.accts_cnt; ++i ) {
         FD_SCRATCH_SCOPE_BEGIN {
           fd_pubkey_t addr;
           fd_memcpy(&addr, msg->accts.accts[i].id, 32U );
+          if( ctx->acct_notify != NULL ) {
+            if( streamed && ( msg->accts.accts[i].flags & FD_REPLAY_NOTIF_ACCT_STREAMED ) ) continue;
+            if( !fd_geyser_acct_filter_sig( ctx->acct_filter, fd_geyser_acct_sig( &addr ) ) ) continue;
+          }
           fd_funk_rec_key_t key = fd_acc_funk_key( &addr );
           ulong datalen;
           void * data = fd_funk_rec_query_xid_safe( ctx->funk, &key, &msg->accts.funk_xid, fd_scratch_virtual(), &datalen );
           if( data ) {
             fd_account_meta_t const * meta = fd_type_pun_const( data );
+            if( ctx->acct_notify != NULL ) {
+              fd_geyser_acct_hdr_t hdr[1];
+              hdr->address = addr;
+              hdr->meta    = *meta;
+              if( !fd_geyser_acct_filter_hdr( ctx->acct_filter, hdr ) ) continue;
+            }
             (*ctx->acct_fun)( msg->accts.funk_xid.ul[0], msg->accts.sig, &addr, meta, (uchar*)data + meta->hlen, meta->dlen, ctx->fun_arg );
           }
         } FD_SCRATCH_SCOPE_END;
@@ -240,8 +290,20 @@ replay_sham_link_after_frag(fd_geyser_t * ctx, fd_replay_notif_msg_t * msg) {
 }
 
 static void
-stake_sham_link_during_frag( fd_geyser_t * ctx, fd_stake_ci_t * state, void const * msg, int sz ) {
-  (void)ctx; (void)sz;
+acct_sham_link_during_frag( fd_geyser_t * ctx, fd_geyser_acct_rx_t * rx, ulong seq, ulong sig, ulong ctl, void const * msg, int sz ) {
+  (void)ctx;
+  fd_geyser_acct_rx_during( rx, seq, sig, ctl, msg, (ulong)sz );
+}
+
+static void
+acct_sham_link_after_frag( fd_geyser_t * ctx, fd_geyser_acct_rx_t * rx ) {
+  if( !fd_geyser_acct_rx_after( rx ) || ctx->acct_fun == NULL ) return;
+  (*ctx->acct_fun)( rx->hdr.slot, rx->hdr.txn_sig, &rx->hdr.address, &rx->hdr.meta, fd_geyser_acct_rx_data( rx ), rx->hdr.meta.dlen, ctx->fun_arg );
+}
+
+static void
+stake_sham_link_during_frag( fd_geyser_t * ctx, fd_stake_ci_t * state, ulong seq, ulong sig, ulong ctl, void const * msg, int sz ) {
+  (void)ctx; (void)seq; (void)sig; (void)ctl; (void)sz;
   fd_stake_ci_stake_msg_init( state, msg );
 }
 
@@ -253,6 +315,12 @@ stake_sham_link_after_frag(fd_geyser_t * ctx, fd_stake_ci_t * state) {
 
 void
 fd_geyser_poll( fd_geyser_t * self ) {
+  /* Poll the account stream first so streamed account updates are
+     delivered before the block they belong to */
+  if( self->acct_notify != NULL ) {
+    acct_sham_link_poll( self->acct_notify, self, self->acct_rx );
+  }
+
   fd_replay_notif_msg_t msg;
   replay_sham_link_poll( self->rep_notify, self, &msg );
 
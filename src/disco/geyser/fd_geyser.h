@@ -6,6 +6,7 @@
 #include "../../flamenco/runtime/fd_blockstore.h"
 #include "../shred/fd_stake_ci.h"
 #include "../../app/fdctl/run/tiles/fd_replay_notif.h"
+#include "fd_geyser_acct.h"
 
 /* This API is the moral equivalent of the solana "plug-in" api. The
    purpose is to allow applications external to firedancer to
@@ -127,6 +128,20 @@ struct fd_geyser_args {
 
   /* Called as accounts are updated */
   fd_geyser_acct_fun       acct_fun;         /* Account written */
+
+  /* If acct_stream is set, account values are read from the replay_acct
+     stream (see fd_geyser_acct.h) instead of being looked up in funk
+     for each notified account, and acct_fun is only called for the
+     accounts selected by the addresses and owners below (no addresses
+     or no owners selects any).  The validator must be run with
+     [tiles.replay.account_stream] enabled.  The stream only covers
+     replayed blocks, accounts written by blocks this validator produces
+     as leader are still looked up in funk. */
+  int                      acct_stream;
+  fd_pubkey_t const *      acct_addrs;       /* At most FD_GEYSER_ACCT_FILTER_MAX */
+  ulong                    acct_addr_cnt;
+  fd_pubkey_t const *      acct_owners;      /* At most FD_GEYSER_ACCT_FILTER_MAX */
+  ulong                    acct_owner_cnt;
 };
 
 typedef struct fd_geyser_args fd_geyser_args_t;
@@ -0,0 +1,257 @@
+#include "fd_geyser_acct.h"
+
+/* Actions of fd_geyser_acct_rx_after on a frag */
+
+#define RX_OP_IGNORE (0) /* Continuation of a message that is not received */
+#define RX_OP_FILTER (1) /* First frag of a message not selected */
+#define RX_OP_START  (2) /* First frag of a selected message */
+#define RX_OP_CONT   (3) /* Next frag of the message being received */
+#define RX_OP_DROP   (4) /* Frag that cannot belong to the message being received */
+
+fd_geyser_acct_tx_t *
+fd_geyser_acct_tx_init( fd_geyser_acct_tx_t * tx,
+                        fd_frag_meta_t *      mcache,
+                        uchar *               dcache,
+                        void *                base ) {
+  ulong depth = fd_mcache_depth( mcache );
+  if( FD_UNLIKELY( !fd_dcache_compact_is_safe( base, dcache, FD_GEYSER_ACCT_MTU, depth ) ) ) {
+    FD_LOG_WARNING(( "dcache too small for the account stream" ));
+    return NULL;
+  }
+
+  tx->mcache = mcache;
+  tx->sync   = fd_mcache_seq_laddr( mcache );
+  tx->depth  = depth;
+  tx->seq    = fd_mcache_seq_query( tx->sync );
+  tx->base   = base;
+  tx->chunk0 = fd_dcache_compact_chunk0( base, dcache );
+  tx->wmark  = fd_dcache_compact_wmark ( base, dcache, FD_GEYSER_ACCT_MTU );
+  tx->chunk  = tx->chunk0;
+  return tx;
+}
+
+ulong
+fd_geyser_acct_publish( fd_geyser_acct_tx_t *        tx,
+                        fd_geyser_acct_hdr_t const * hdr,
+                        void const *                 data,
+                        ulong                        tsorig ) {
+  ulong sig     = fd_geyser_acct_sig( &hdr->address );
+  ulong data_sz = hdr->meta.dlen;
+  ulong tspub   = fd_frag_meta_ts_comp( fd_tickcount() );
+
+  /* The first frag carries the header and as much data as fits */
+
+  uchar * dst = fd_chunk_to_laddr( tx->base, tx->chunk );
+  ulong   sz  = fd_ulong_min( data_sz, FD_GEYSER_ACCT_MTU-sizeof(fd_geyser_acct_hdr_t) );
+  fd_memcpy( dst, hdr, sizeof(fd_geyser_acct_hdr_t) );
+  fd_memcpy( dst+sizeof(fd_geyser_acct_hdr_t), data, sz );
+  ulong off = sz;
+  sz += sizeof(fd_geyser_acct_hdr_t);
+
+  ulong frag_cnt = 0UL;
+  for(;;) {
+    int   eom = off==data_sz;
+    ulong ctl = fd_frag_meta_ctl( 0UL, !frag_cnt, eom, 0 );
+    fd_mcache_publish( tx->mcache, tx->depth, tx->seq, sig, tx->chunk, sz, ctl, tsorig, tspub );
+    tx->seq   = fd_seq_inc( tx->seq, 1UL );
+    tx->chunk = fd_dcache_compact_next( tx->chunk, sz, tx->chunk0, tx->wmark );
+    frag_cnt++;
+    if( eom ) break;
+
+    sz = fd_ulong_min( data_sz-off, FD_GEYSER_ACCT_MTU );
+    fd_memcpy( fd_chunk_to_laddr( tx->base, tx->chunk ), (uchar const *)data+off, sz );
+    off += sz;
+  }
+
+  fd_mcache_seq_update( tx->sync, tx->seq );
+  return frag_cnt;
+}
+
+fd_geyser_acct_filter_t *
+fd_geyser_acct_filter_init( fd_geyser_acct_filter_t * filter,
+                            fd_pubkey_t const *       address,
+                            ulong                     address_cnt,
+                            fd_pubkey_t const *       owner,
+                            ulong                     owner_cnt ) {
+  if( FD_UNLIKELY( (address_cnt>FD_GEYSER_ACCT_FILTER_MAX) | (owner_cnt>FD_GEYSER_ACCT_FILTER_MAX) ) ) {
+    FD_LOG_WARNING(( "too many addresses or owners in filter" ));
+    return NULL;
+  }
+
+  filter->address_cnt = address_cnt;
+  filter->owner_cnt   = owner_cnt;
+  for( ulong i=0UL; i<address_cnt; i++ ) {
+    filter->address    [ i ] = address[ i ];
+    filter->address_sig[ i ] = fd_geyser_acct_sig( address+i );
+  }
+  for( ulong i=0UL; i<owner_cnt; i++ ) filter->owner[ i ] = owner[ i ];
+  return filter;
+}
+
+int
+fd_geyser_acct_filter_sig( fd_geyser_acct_filter_t const * filter,
+                           ulong                           sig ) {
+  if( !filter->address_cnt ) return 1;
+  for( ulong i=0UL; i<filter->address_cnt; i++ ) if( filter->address_sig[ i ]==sig ) return 1;
+  return 0;
+}
+
+int
+fd_geyser_acct_filter_hdr( fd_geyser_acct_filter_t const * filter,
+                           fd_geyser_acct_hdr_t const *    hdr ) {
+  int found = !filter->address_cnt;
+  for( ulong i=0UL; (!found) & (i<filter->address_cnt); i++ ) {
+    found = !memcmp( filter->address[ i ].uc, hdr->address.uc, sizeof(fd_pubkey_t) );
+  }
+  if( !found ) return 0;
+
+  found = !filter->owner_cnt;
+  for( ulong i=0UL; (!found) & (i<filter->owner_cnt); i++ ) {
+    found = !memcmp( filter->owner[ i ].uc, hdr->meta.info.owner, sizeof(fd_pubkey_t) );
+  }
+  return found;
+}
+
+fd_geyser_acct_rx_t *
+fd_geyser_acct_rx_init( fd_geyser_acct_rx_t *           rx,
+                        fd_geyser_acct_filter_t const * filter ) {
+  rx->filter   = filter;
+  rx->seq_next = 0UL;
+  rx->active   = 0;
+  rx->off      = 0UL;
+  rx->pend_op  = RX_OP_IGNORE;
+  rx->pend_seq = 0UL;
+  rx->pend_sz  = 0UL;
+  rx->pend_eom = 0;
+  rx->msg_cnt  = 0UL;
+  rx->filt_cnt = 0UL;
+  rx->drop_cnt = 0UL;
+
+  rx->seq_valid     = 0;
+  rx->seq_first     = 0UL;
+  rx->seq_expect    = 0UL;
+  rx->gap_floor     = 0UL;
+  rx->gap_cnt       = 0UL;
+  rx->lost_frag_cnt = 0UL;
+  return rx;
+}
+
+/* rx_gap records that frags [seq0,seq1) were lost */
+
+static void
+rx_gap( fd_geyser_acct_rx_t * rx,
+        ulong                 seq0,
+        ulong                 seq1 ) {
+  ulong idx = rx->gap_cnt % FD_GEYSER_ACCT_GAP_MAX;
+  if( rx->gap_cnt>=FD_GEYSER_ACCT_GAP_MAX ) rx->gap_floor = rx->gap[ idx ].seq1;
+  rx->gap[ idx ].seq0 = seq0;
+  rx->gap[ idx ].seq1 = seq1;
+  rx->gap_cnt++;
+  rx->lost_frag_cnt += seq1 - seq0;
+}
+
+int
+fd_geyser_acct_rx_lost( fd_geyser_acct_rx_t const * rx,
+                        ulong                       seq0,
+                        ulong                       seq1 ) {
+  if( fd_seq_ge( seq0, seq1 ) ) return 0;
+  if( !rx->seq_valid || fd_seq_lt( seq0, rx->seq_first ) ) return 1; /* Before rx joined the stream */
+  if( rx->gap_cnt>FD_GEYSER_ACCT_GAP_MAX && fd_seq_lt( seq0, rx->gap_floor ) ) return 1;
+  ulong cnt = fd_ulong_min( rx->gap_cnt, FD_GEYSER_ACCT_GAP_MAX );
+  for( ulong i=0UL; i<cnt; i++ ) {
+    if( fd_seq_lt( rx->gap[ i ].seq0, seq1 ) && fd_seq_gt( rx->gap[ i ].seq1, seq0 ) ) return 1;
+  }
+  return 0;
+}
+
+void
+fd_geyser_acct_rx_during( fd_geyser_acct_rx_t * rx,
+                          ulong                 seq,
+                          ulong                 sig,
+                          ulong                 ctl,
+                          void const *          msg,
+                          ulong                 sz ) {
+  /* Frags between the last one committed and this one were overrun
+     (or overrun while being copied) */
+
+  if( FD_UNLIKELY( rx->seq_valid && seq!=rx->seq_expect ) ) {
+    rx_gap( rx, rx->seq_expect, seq );
+    rx->seq_expect = seq;
+  }
+
+  rx->pend_seq = seq;
+  rx->pend_sz  = sz;
+  rx->pend_eom = fd_frag_meta_ctl_eom( ctl );
+
+  if( fd_frag_meta_ctl_som( ctl ) ) {
+
+    /* A new message.  It is safe to overwrite the one being received
+       (if any), as the publisher never interleaves messages. */
+
+    if( FD_UNLIKELY( (sz<sizeof(fd_geyser_acct_hdr_t)) | (sz>FD_GEYSER_ACCT_MTU) ) ) { rx->pend_op = RX_OP_DROP; return; }
+    if( rx->filter && !fd_geyser_acct_filter_sig( rx->filter, sig ) ) { rx->pend_op = RX_OP_FILTER; return; }
+
+    fd_memcpy( rx->buf, msg, sizeof(fd_geyser_acct_hdr_t) );
+    if( FD_UNLIKELY( rx->hdr.meta.dlen>FD_GEYSER_ACCT_DATA_MAX ) ) { rx->pend_op = RX_OP_DROP; return; }
+    if( rx->filter && !fd_geyser_acct_filter_hdr( rx->filter, &rx->hdr ) ) { rx->pend_op = RX_OP_FILTER; return; }
+
+    /* Only copy the data of selected messages */
+
+    if( FD_UNLIKELY( sz>sizeof(fd_geyser_acct_hdr_t)+rx->hdr.meta.dlen ) ) { rx->pend_op = RX_OP_DROP; return; }
+    fd_memcpy( rx->buf+sizeof(fd_geyser_acct_hdr_t), (uchar const *)msg+sizeof(fd_geyser_acct_hdr_t), sz-sizeof(fd_geyser_acct_hdr_t) );
+    rx->pend_op = RX_OP_START;
+    return;
+  }
+
+  if( !rx->active ) { rx->pend_op = RX_OP_IGNORE; return; }
+
+  if( FD_UNLIKELY( (seq!=rx->seq_next) | (sz>sizeof(fd_geyser_acct_hdr_t)+rx->hdr.meta.dlen-rx->off) ) ) {
+    rx->pend_op = RX_OP_DROP;
+    return;
+  }
+
+  fd_memcpy( rx->buf+rx->off, msg, sz );
+  rx->pend_op = RX_OP_CONT;
+}
+
+int
+fd_geyser_acct_rx_after( fd_geyser_acct_rx_t * rx ) {
+  int op = rx->pend_op;
+  rx->pend_op    = RX_OP_IGNORE;
+  if( FD_UNLIKELY( !rx->seq_valid ) ) rx->seq_first = rx->pend_seq;
+  rx->seq_valid  = 1;
+  rx->seq_expect = fd_seq_inc( rx->pend_seq, 1UL );
+
+  switch( op ) {
+  case RX_OP_IGNORE:
+    return 0;
+  case RX_OP_FILTER:
+    rx->drop_cnt += (ulong)rx->active;
+    rx->filt_cnt++;
+    rx->active = 0;
+    return 0;
+  case RX_OP_START:
+    rx->drop_cnt += (ulong)rx->active;
+    rx->active    = 1;
+    rx->off       = 0UL;
+    break;
+  case RX_OP_CONT:
+    break;
+  default: /* RX_OP_DROP */
+    rx->drop_cnt += (ulong)rx->active;
+    rx->active    = 0;
+    return 0;
+  }
+
+  rx->off     += rx->pend_sz;
+  rx->seq_next = fd_seq_inc( rx->pend_seq, 1UL );
+  if( !rx->pend_eom ) return 0;
+
+  rx->active = 0;
+  if( FD_UNLIKELY( rx->off!=sizeof(fd_geyser_acct_hdr_t)+rx->hdr.meta.dlen ) ) {
+    rx->drop_cnt++;
+    return 0;
+  }
+  rx->msg_cnt++;
+  return 1;
+}
@@ -0,0 +1,243 @@
+#ifndef HEADER_fd_src_disco_geyser_fd_geyser_acct_h
+#define HEADER_fd_src_disco_geyser_fd_geyser_acct_h
+
+/* fd_geyser_acct is the wire format of the replay_acct stream, a tango
+   mcache/dcache ring on which replay publishes the value of every
+   account written by the transactions it executes.  External geyser
+   consumers read the ring directly instead of querying funk for each
+   notified account, which is slow and races with funk publication.
+
+   Each account write is one message: an fd_geyser_acct_hdr_t followed
+   by the account data (hdr->meta.dlen bytes).  A message larger than
+   FD_GEYSER_ACCT_MTU is split across consecutive frags; its first frag
+   has SOM set and its last EOM.  The sig of every frag is the first 8
+   bytes of the account address, so that consumers can discard
+   messages for uninteresting addresses without touching the dcache.
+
+   There is no flow control.  A consumer that falls more than a ring
+   depth behind is overrun and loses the messages in between (a
+   partially received message is discarded as a whole).  The receiver
+   records the sequence numbers it lost, so that a consumer can tell
+   which messages it missed (fd_geyser_acct_rx_lost) and look the
+   accounts up elsewhere (e.g. in funk). */
+
+#include "../../tango/fd_tango.h"
+#include "../../flamenco/types/fd_types.h"
+
+#define FD_GEYSER_ACCT_MTU   (4096UL)
+#define FD_GEYSER_ACCT_DEPTH (16384UL)
+
+/* FD_GEYSER_ACCT_DATA_MAX is the largest account data size */
+
+#define FD_GEYSER_ACCT_DATA_MAX (10UL<<20)
+
+/* FD_GEYSER_ACCT_FILTER_MAX is the max number of addresses and of
+   owners in a filter */
+
+#define FD_GEYSER_ACCT_FILTER_MAX (64UL)
+
+/* FD_GEYSER_ACCT_GAP_MAX is the number of lost sequence number ranges
+   remembered by a receiver */
+
+#define FD_GEYSER_ACCT_GAP_MAX (64UL)
+
+struct __attribute__((aligned(8UL))) fd_geyser_acct_hdr {
+  ulong             slot;
+  uchar             txn_sig[ 64 ]; /* First signature of the transaction that wrote the account */
+  fd_pubkey_t       address;
+  fd_account_meta_t meta;          /* Value of the account after the write, meta.dlen data bytes follow */
+};
+
+typedef struct fd_geyser_acct_hdr fd_geyser_acct_hdr_t;
+
+FD_STATIC_ASSERT( sizeof(fd_geyser_acct_hdr_t)<FD_GEYSER_ACCT_MTU, geyser_acct_mtu );
+
+/* fd_geyser_acct_tx_t is a local publisher onto the stream */
+
+struct fd_geyser_acct_tx {
+  fd_frag_meta_t * mcache;
+  ulong *          sync;
+  ulong            depth;
+  ulong            seq;
+
+  void *           base;
+  ulong            chunk0;
+  ulong            wmark;
+  ulong            chunk;
+};
+
+typedef struct fd_geyser_acct_tx fd_geyser_acct_tx_t;
+
+/* fd_geyser_acct_filter_t selects the messages a consumer wants.  A
+   message is selected if its address is one of address (or there are
+   no addresses) and its owner is one of owner (or there are no
+   owners). */
+
+struct fd_geyser_acct_filter {
+  ulong       address_cnt;
+  ulong       owner_cnt;
+  ulong       address_sig[ FD_GEYSER_ACCT_FILTER_MAX ];
+  fd_pubkey_t address    [ FD_GEYSER_ACCT_FILTER_MAX ];
+  fd_pubkey_t owner      [ FD_GEYSER_ACCT_FILTER_MAX ];
+};
+
+typedef struct fd_geyser_acct_filter fd_geyser_acct_filter_t;
+
+/* fd_geyser_acct_rx_t reassembles messages from the stream.  Frags are
+   handed to it in two steps, following the usual speculative tango
+   consume pattern: rx_during copies the frag out of the dcache, then
+   the caller checks the frag was not overrun while copying and, if
+   not, calls rx_after to commit it.  It holds a whole message, so it is
+   too large to be declared on the stack. */
+
+struct fd_geyser_acct_rx {
+  fd_geyser_acct_filter_t const * filter; /* NULL selects everything */
+
+  ulong seq_next;  /* Sequence number expected for the next frag of the current message */
+  int   active;    /* 1 if a selected message is being received */
+  ulong off;       /* Bytes of the current message received */
+
+  int   pend_op;   /* What rx_after should do with the frag passed to rx_during */
+  ulong pend_seq;
+  ulong pend_sz;
+  int   pend_eom;
+
+  ulong msg_cnt;   /* Messages received */
+  ulong filt_cnt;  /* Messages not selected by the filter */
+  ulong drop_cnt;  /* Selected messages lost to overruns */
+
+  /* Frags that were never handed to rx (overruns) */
+
+  int   seq_valid;  /* 0 until the first frag was committed */
+  ulong seq_first;  /* Sequence number of the first frag committed */
+  ulong seq_expect; /* Sequence number of the next frag on the stream */
+  ulong gap_floor;  /* Frags before this one may have been lost (forgotten gaps) */
+  ulong gap_cnt;    /* Gaps recorded, gap[ (gap_cnt-1) % FD_GEYSER_ACCT_GAP_MAX ] is the latest */
+  struct {
+    ulong seq0;     /* Frags [seq0,seq1) were lost */
+    ulong seq1;
+  } gap[ FD_GEYSER_ACCT_GAP_MAX ];
+  ulong lost_frag_cnt; /* Frags lost */
+
+  union {
+    fd_geyser_acct_hdr_t hdr;
+    uchar                buf[ sizeof(fd_geyser_acct_hdr_t)+FD_GEYSER_ACCT_DATA_MAX ];
+  };
+};
+
+typedef struct fd_geyser_acct_rx fd_geyser_acct_rx_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_geyser_acct_sig returns the frag sig of messages for address */
+
+FD_FN_PURE static inline ulong
+fd_geyser_acct_sig( fd_pubkey_t const * address ) {
+  return address->ul[ 0 ];
+}
+
+/* fd_geyser_acct_rx_data returns the data of the message completed by
+   the last call to fd_geyser_acct_rx_after. */
+
+FD_FN_CONST static inline uchar const *
+fd_geyser_acct_rx_data( fd_geyser_acct_rx_t const * rx ) {
+  return rx->buf + sizeof(fd_geyser_acct_hdr_t);
+}
+
+/* fd_geyser_acct_rx_seq returns the sequence number of the next frag
+   rx expects, i.e. every frag before it was either received or lost. */
+
+FD_FN_PURE static inline ulong
+fd_geyser_acct_rx_seq( fd_geyser_acct_rx_t const * rx ) {
+  return rx->seq_expect;
+}
+
+/* fd_geyser_acct_tx_init sets up tx to publish onto the stream backed
+   by the given local joins.  base is the address chunks are relative
+   to (usually the workspace containing dcache).  Returns tx on success
+   and NULL if dcache cannot hold FD_GEYSER_ACCT_MTU frags for a ring
+   as deep as mcache. */
+
+fd_geyser_acct_tx_t *
+fd_geyser_acct_tx_init( fd_geyser_acct_tx_t * tx,
+                        fd_frag_meta_t *      mcache,
+                        uchar *               dcache,
+                        void *                base );
+
+/* fd_geyser_acct_publish publishes the write of the account described
+   by hdr whose data is [data,data+hdr->meta.dlen).  Returns the number
+   of frags published. */
+
+ulong
+fd_geyser_acct_publish( fd_geyser_acct_tx_t *        tx,
+                        fd_geyser_acct_hdr_t const * hdr,
+                        void const *                 data,
+                        ulong                        tsorig );
+
+/* fd_geyser_acct_filter_init formats filter to select the given
+   addresses and owners.  Returns filter, or NULL if there are more
+   than FD_GEYSER_ACCT_FILTER_MAX of either. */
+
+fd_geyser_acct_filter_t *
+fd_geyser_acct_filter_init( fd_geyser_acct_filter_t * filter,
+                            fd_pubkey_t const *       address,
+                            ulong                     address_cnt,
+                            fd_pubkey_t const *       owner,
+                            ulong                     owner_cnt );
+
+/* fd_geyser_acct_filter_sig returns 0 if no message with the given
+   frag sig can be selected by filter and 1 otherwise. */
+
+FD_FN_PURE int
+fd_geyser_acct_filter_sig( fd_geyser_acct_filter_t const * filter,
+                           ulong                           sig );
+
+/* fd_geyser_acct_filter_hdr returns 1 if the message with header hdr
+   is selected by filter and 0 otherwise. */
+
+FD_FN_PURE int
+fd_geyser_acct_filter_hdr( fd_geyser_acct_filter_t const * filter,
+                           fd_geyser_acct_hdr_t const *    hdr );
+
+/* fd_geyser_acct_rx_init formats rx to reassemble messages selected by
+   filter (NULL for all).  filter must outlive rx. */
+
+fd_geyser_acct_rx_t *
+fd_geyser_acct_rx_init( fd_geyser_acct_rx_t *           rx,
+                        fd_geyser_acct_filter_t const * filter );
+
+/* fd_geyser_acct_rx_during consumes frag seq with the given sig and ctl
+   whose payload is [msg,msg+sz).  Nothing is committed until
+   rx_after. */
+
+void
+fd_geyser_acct_rx_during( fd_geyser_acct_rx_t * rx,
+                          ulong                 seq,
+                          ulong                 sig,
+                          ulong                 ctl,
+                          void const *          msg,
+                          ulong                 sz );
+
+/* fd_geyser_acct_rx_after commits the frag last passed to rx_during.
+   Returns 1 if this completed a selected message, which is then
+   available in rx->hdr with its data following it in rx->buf, until
+   the next call to rx_during.  Returns 0 otherwise. */
+
+int
+fd_geyser_acct_rx_after( fd_geyser_acct_rx_t * rx );
+
+/* fd_geyser_acct_rx_lost returns 1 if any frag with a sequence number
+   in [seq0,seq1) was lost to an overrun, and 0 otherwise.  The answer
+   is conservative: once more than FD_GEYSER_ACCT_GAP_MAX gaps were
+   recorded, ranges older than the forgotten gaps are reported lost.
+   Frags before the first one rx received are reported lost, frags
+   that rx has not reached yet are not. */
+
+FD_FN_PURE int
+fd_geyser_acct_rx_lost( fd_geyser_acct_rx_t const * rx,
+                        ulong                       seq0,
+                        ulong                       seq1 );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_geyser_fd_geyser_acct_h */
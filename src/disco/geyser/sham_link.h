@@ -35,7 +35,7 @@ SHAM_LINK_(start)( SHAM_LINK_(t) * self ) {
   self->seq_expect = fd_mcache_seq0( mcache );
 }
 
-static void SHAM_LINK_(during_frag)( SHAM_LINK_CONTEXT * ctx, SHAM_LINK_STATE * state, void const * msg, int sz );
+static void SHAM_LINK_(during_frag)( SHAM_LINK_CONTEXT * ctx, SHAM_LINK_STATE * state, ulong seq, ulong sig, ulong ctl, void const * msg, int sz );
 
 static void SHAM_LINK_(after_frag)( SHAM_LINK_CONTEXT * ctx, SHAM_LINK_STATE * state );
 
@@ -59,7 +59,7 @@ SHAM_LINK_(poll)( SHAM_LINK_(t) * self, SHAM_LINK_CONTEXT * ctx, SHAM_LINK_STATE
 
     ulong chunk = mline->chunk;
     /* TODO: sanity check chunk,sz */
-    SHAM_LINK_(during_frag)( ctx, state, fd_chunk_to_laddr( self->wksp, chunk ), mline->sz );
+    SHAM_LINK_(during_frag)( ctx, state, self->seq_expect, mline->sig, mline->ctl, fd_chunk_to_laddr( self->wksp, chunk ), mline->sz );
 
     seq_found = fd_frag_meta_seq_query( mline );
     diff      = fd_seq_diff( seq_found, self->seq_expect );
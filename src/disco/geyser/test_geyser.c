@@ -90,6 +90,8 @@ init_args( int * argc, char *** argv, fd_geyser_args_t * args ) {
   if( fd_env_strip_cmdline_int ( argc, argv, "--notify-acct", NULL, 0 ) ) {
     args->acct_fun = my_acct_fun;
   }
+
+  args->acct_stream = fd_env_strip_cmdline_int ( argc, argv, "--acct-stream", NULL, 0 );
 }
 
 static int stopflag = 0;
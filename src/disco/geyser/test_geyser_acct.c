@@ -0,0 +1,199 @@
+#include "fd_geyser_acct.h"
+
+#define DEPTH   (128UL)
+#define DATA_SZ (1UL<<20) /* >= fd_dcache_req_data_sz( FD_GEYSER_ACCT_MTU, DEPTH, 1UL, 1 ) */
+
+static uchar mcache_mem[ 65536UL   ] __attribute__((aligned(FD_MCACHE_ALIGN)));
+static uchar dcache_mem[ 2UL<<20   ] __attribute__((aligned(FD_DCACHE_ALIGN)));
+static uchar data      [ 300000UL  ];
+
+static fd_geyser_acct_rx_t rx[1];
+
+/* consume hands the frags [*seq,seq_end) to rx, skipping the frag with
+   sequence number skip (to simulate an overrun).  Returns the number
+   of messages completed and leaves the last one in rx. */
+
+static ulong
+consume( fd_frag_meta_t const * mcache,
+         void const *           base,
+         ulong *                seq,
+         ulong                  seq_end,
+         ulong                  skip ) {
+  ulong msg_cnt = 0UL;
+  for( ; *seq!=seq_end; (*seq)++ ) {
+    if( *seq==skip ) continue;
+    fd_frag_meta_t const * meta = mcache + fd_mcache_line_idx( *seq, DEPTH );
+    FD_TEST( meta->seq==*seq );
+    fd_geyser_acct_rx_during( rx, *seq, meta->sig, meta->ctl, fd_chunk_to_laddr_const( base, meta->chunk ), meta->sz );
+    msg_cnt += (ulong)fd_geyser_acct_rx_after( rx );
+  }
+  return msg_cnt;
+}
+
+static void
+make_hdr( fd_geyser_acct_hdr_t * hdr,
+          ulong                  slot,
+          ulong                  address,
+          ulong                  owner,
+          ulong                  dlen ) {
+  memset( hdr, 0, sizeof(fd_geyser_acct_hdr_t) );
+  hdr->slot              = slot;
+  hdr->address.ul[ 0 ]   = address;
+  hdr->address.ul[ 1 ]   = ~address;
+  hdr->meta.dlen         = dlen;
+  hdr->meta.info.lamports = slot*1000UL;
+  memset( hdr->meta.info.owner, (int)owner, sizeof(fd_pubkey_t) );
+  memset( hdr->txn_sig, (int)slot, 64UL );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+  for( ulong i=0UL; i<sizeof(data); i++ ) data[ i ] = fd_rng_uchar( rng );
+
+  FD_TEST( fd_mcache_footprint( DEPTH, 0UL )<=sizeof(mcache_mem) );
+  FD_TEST( fd_dcache_req_data_sz( FD_GEYSER_ACCT_MTU, DEPTH, 1UL, 1 )<=DATA_SZ );
+  FD_TEST( fd_dcache_footprint( DATA_SZ, 0UL )<=sizeof(dcache_mem) );
+
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_mcache_new( mcache_mem, DEPTH, 0UL, 0UL ) );
+  FD_TEST( mcache );
+
+  /* A dcache too small for the ring is rejected */
+
+  uchar * small = fd_dcache_join( fd_dcache_new( dcache_mem, 8192UL, 0UL ) );
+  FD_TEST( small );
+  fd_geyser_acct_tx_t tx[1];
+  FD_TEST( !fd_geyser_acct_tx_init( tx, mcache, small, dcache_mem ) );
+  FD_TEST( fd_dcache_delete( fd_dcache_leave( small ) ) );
+
+  uchar * dcache = fd_dcache_join( fd_dcache_new( dcache_mem, DATA_SZ, 0UL ) );
+  FD_TEST( dcache );
+  FD_TEST( fd_geyser_acct_tx_init( tx, mcache, dcache, dcache_mem )==tx );
+
+  fd_geyser_acct_hdr_t hdr[1];
+  ulong seq = tx->seq;
+
+  /* Single frag and multi frag messages are reassembled */
+
+  FD_TEST( fd_geyser_acct_rx_init( rx, NULL )==rx );
+
+  ulong dlen[ 6 ] = { 0UL, 165UL, FD_GEYSER_ACCT_MTU-sizeof(fd_geyser_acct_hdr_t), FD_GEYSER_ACCT_MTU-sizeof(fd_geyser_acct_hdr_t)+1UL, 3UL*FD_GEYSER_ACCT_MTU, 300000UL };
+  ulong frag_cnt[ 6 ] = { 1UL, 1UL, 1UL, 2UL, 4UL, 74UL };
+  for( ulong i=0UL; i<6UL; i++ ) {
+    make_hdr( hdr, 10UL+i, 7UL, 1UL, dlen[ i ] );
+    FD_TEST( fd_geyser_acct_publish( tx, hdr, data, 0UL )==frag_cnt[ i ] );
+    FD_TEST( fd_mcache_seq_query( fd_mcache_seq_laddr_const( mcache ) )==tx->seq );
+    FD_TEST( consume( mcache, dcache_mem, &seq, tx->seq, ULONG_MAX )==1UL );
+    FD_TEST( !memcmp( &rx->hdr, hdr, sizeof(fd_geyser_acct_hdr_t) ) );
+    FD_TEST( !memcmp( fd_geyser_acct_rx_data( rx ), data, dlen[ i ] ) );
+  }
+  FD_TEST( rx->msg_cnt==6UL && !rx->filt_cnt && !rx->drop_cnt );
+
+  /* A message missing a frag is dropped as a whole and the stream
+     recovers at the next message */
+
+  make_hdr( hdr, 20UL, 7UL, 1UL, 20000UL );
+  fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  make_hdr( hdr, 21UL, 8UL, 1UL, 100UL );
+  fd_geyser_acct_publish( tx, hdr, data+1, 0UL );
+  FD_TEST( consume( mcache, dcache_mem, &seq, tx->seq, seq+2UL )==1UL );
+  FD_TEST( rx->drop_cnt==1UL );
+  FD_TEST( rx->hdr.slot==21UL && !memcmp( fd_geyser_acct_rx_data( rx ), data+1, 100UL ) );
+
+  /* Losing the first frag of a message just loses the message */
+
+  fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  FD_TEST( consume( mcache, dcache_mem, &seq, tx->seq, seq )==0UL );
+  FD_TEST( rx->drop_cnt==1UL );
+
+  /* Filters by address and by owner */
+
+  fd_pubkey_t addr [ 2 ];
+  fd_pubkey_t owner[ 1 ];
+  make_hdr( hdr, 0UL, 7UL, 0UL, 0UL ); addr[ 0 ] = hdr->address;
+  make_hdr( hdr, 0UL, 9UL, 0UL, 0UL ); addr[ 1 ] = hdr->address;
+  memset( owner, 2, sizeof(fd_pubkey_t) );
+
+  fd_geyser_acct_filter_t filter[1];
+  FD_TEST( !fd_geyser_acct_filter_init( filter, addr, FD_GEYSER_ACCT_FILTER_MAX+1UL, NULL, 0UL ) );
+  FD_TEST( fd_geyser_acct_filter_init( filter, addr, 2UL, NULL, 0UL )==filter );
+  FD_TEST( fd_geyser_acct_rx_init( rx, filter )==rx );
+
+  ulong addrs[ 4 ] = { 7UL, 8UL, 9UL, 10UL };
+  for( ulong i=0UL; i<4UL; i++ ) {
+    make_hdr( hdr, 30UL+i, addrs[ i ], 1UL+(i&1UL), 10000UL );
+    fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  }
+  FD_TEST( consume( mcache, dcache_mem, &seq, tx->seq, ULONG_MAX )==2UL );
+  FD_TEST( rx->msg_cnt==2UL && rx->filt_cnt==2UL && !rx->drop_cnt );
+  FD_TEST( rx->hdr.slot==32UL );
+
+  FD_TEST( fd_geyser_acct_filter_init( filter, NULL, 0UL, owner, 1UL )==filter );
+  FD_TEST( fd_geyser_acct_rx_init( rx, filter )==rx );
+  for( ulong i=0UL; i<4UL; i++ ) {
+    make_hdr( hdr, 40UL+i, addrs[ i ], 1UL+(i&1UL), 10000UL );
+    fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  }
+  FD_TEST( consume( mcache, dcache_mem, &seq, tx->seq, ULONG_MAX )==2UL );
+  FD_TEST( rx->msg_cnt==2UL && rx->filt_cnt==2UL && !rx->drop_cnt );
+  FD_TEST( rx->hdr.slot==43UL );
+  FD_TEST( !memcmp( fd_geyser_acct_rx_data( rx ), data, 10000UL ) );
+
+  FD_TEST( fd_geyser_acct_filter_init( filter, addr, 2UL, owner, 1UL )==filter );
+  FD_TEST( fd_geyser_acct_rx_init( rx, filter )==rx );
+  for( ulong i=0UL; i<4UL; i++ ) {
+    make_hdr( hdr, 50UL+i, addrs[ i ], 1UL+(i&1UL), 10UL );
+    fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  }
+  FD_TEST( consume( mcache, dcache_mem, &seq, tx->seq, ULONG_MAX )==0UL );
+  FD_TEST( rx->filt_cnt==4UL );
+
+  /* Lost frags are remembered, so that the consumer can tell which
+     messages it missed */
+
+  FD_TEST( fd_geyser_acct_rx_init( rx, NULL )==rx );
+  ulong seq_a = tx->seq;
+  make_hdr( hdr, 60UL, 7UL, 1UL, 100UL );
+  fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  ulong seq_b = tx->seq;
+  make_hdr( hdr, 61UL, 8UL, 1UL, 3UL*FD_GEYSER_ACCT_MTU );
+  fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  ulong seq_c = tx->seq;
+  make_hdr( hdr, 62UL, 9UL, 1UL, 100UL );
+  fd_geyser_acct_publish( tx, hdr, data, 0UL );
+  ulong seq_d = tx->seq;
+  FD_TEST( consume( mcache, dcache_mem, &seq, seq_d, seq_b+1UL )==2UL );
+  FD_TEST( fd_geyser_acct_rx_seq( rx )==seq_d );
+  FD_TEST( rx->lost_frag_cnt==1UL );
+  FD_TEST( !fd_geyser_acct_rx_lost( rx, seq_a, seq_b ) );
+  FD_TEST(  fd_geyser_acct_rx_lost( rx, seq_b, seq_c ) );
+  FD_TEST( !fd_geyser_acct_rx_lost( rx, seq_c, seq_d ) );
+  FD_TEST(  fd_geyser_acct_rx_lost( rx, seq_a, seq_d ) );
+  FD_TEST( !fd_geyser_acct_rx_lost( rx, seq_b, seq_b ) );      /* empty range */
+  FD_TEST(  fd_geyser_acct_rx_lost( rx, seq_a-1UL, seq_a ) );  /* before the first frag */
+  FD_TEST( !fd_geyser_acct_rx_lost( rx, seq_d, seq_d+5UL ) ); /* not reached yet */
+
+  /* Forgotten gaps make older ranges conservatively lost */
+
+  for( ulong i=0UL; i<FD_GEYSER_ACCT_GAP_MAX; i++ ) {
+    make_hdr( hdr, 70UL, 7UL, 1UL, 10UL );
+    fd_geyser_acct_publish( tx, hdr, data, 0UL );
+    fd_geyser_acct_publish( tx, hdr, data, 0UL );
+    FD_TEST( consume( mcache, dcache_mem, &seq, tx->seq, tx->seq-2UL )==1UL );
+  }
+  FD_TEST( rx->gap_cnt==FD_GEYSER_ACCT_GAP_MAX+1UL );
+  FD_TEST(  fd_geyser_acct_rx_lost( rx, seq_a, seq_b ) );
+  FD_TEST(  fd_geyser_acct_rx_lost( rx, tx->seq-2UL, tx->seq-1UL ) );
+  FD_TEST( !fd_geyser_acct_rx_lost( rx, tx->seq-1UL, tx->seq ) );
+
+  FD_TEST( fd_dcache_delete( fd_dcache_leave( dcache ) ) );
+  FD_TEST( fd_mcache_delete( fd_mcache_leave( mcache ) ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
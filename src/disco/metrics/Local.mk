@@ -1,2 +1,3 @@
 $(call add-hdrs,fd_prometheus.h fd_metrics.h)
 $(call add-objs,fd_prometheus fd_metrics,fd_disco)
+$(call add-objs,fd_prometheus_vm_prof,fd_disco)
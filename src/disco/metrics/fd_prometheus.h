@@ -5,6 +5,14 @@
 #include "../../ballet/http/fd_http_server.h"
 #include "../topo/fd_topo.h"
 
+/* FD_PROMETHEUS_VM_PROF_TOP_MAX is the maximum number of programs
+   fd_prometheus_render_vm_prof will export. */
+
+#define FD_PROMETHEUS_VM_PROF_TOP_MAX (64UL)
+
+struct fd_vm_prof;
+typedef struct fd_vm_prof fd_vm_prof_t;
+
 FD_PROTOTYPES_BEGIN
 
 /* Format all of the metrics for the given topology as a Prometheus
@@ -22,6 +30,17 @@ fd_prometheus_render_tile( fd_http_server_t *        http,
                            fd_metrics_meta_t const * metrics,
                            ulong                     metrics_cnt );
 
+/* Format the (up to) top_max on-chain programs that consumed the most
+   compute units in the given program profiler (see fd_vm_prof) into
+   the HTTP server outgoing ring buffer, in the same format as the
+   above.  Programs are labeled by their base58 program id.  top_max is
+   capped at FD_PROMETHEUS_VM_PROF_TOP_MAX. */
+
+void
+fd_prometheus_render_vm_prof( fd_vm_prof_t const * prof,
+                              ulong                top_max,
+                              fd_http_server_t *   http );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_disco_metrics_fd_prometheus_h */
@@ -0,0 +1,86 @@
+#include "fd_prometheus.h"
+
+#include "fd_metrics.h"
+
+#include "../../flamenco/vm/fd_vm_base.h"
+
+/* This lives apart from fd_prometheus.c so that users of the tile
+   metrics renderer do not need to link the VM. */
+
+static void
+render_vm_prof_header( fd_http_server_t * http,
+                       char const *       name,
+                       char const *       type,
+                       char const *       desc ) {
+  fd_http_server_printf( http, "\n# HELP %s %s\n# TYPE %s %s\n", name, desc, name, type );
+}
+
+static void
+render_vm_prof_histogram( fd_http_server_t * http,
+                          char const *       name,
+                          char const *       program,
+                          fd_histf_t const * hist,
+                          int                seconds ) {
+  ulong cnt = 0UL;
+  for( ulong b=0UL; b<FD_HISTF_BUCKET_CNT; b++ ) {
+    cnt += fd_histf_cnt( hist, b );
+
+    char le_str[ 64 ];
+    if( FD_UNLIKELY( b==FD_HISTF_BUCKET_CNT-1UL ) ) {
+      FD_TEST( fd_cstr_printf_check( le_str, sizeof(le_str), NULL, "+Inf" ) );
+    } else if( seconds ) {
+      FD_TEST( fd_cstr_printf_check( le_str, sizeof(le_str), NULL, "%.17g", fd_metrics_convert_ticks_to_seconds( fd_histf_right( hist, b )-1UL ) ) );
+    } else {
+      FD_TEST( fd_cstr_printf_check( le_str, sizeof(le_str), NULL, "%lu", fd_histf_right( hist, b )-1UL ) );
+    }
+    fd_http_server_printf( http, "%s_bucket{program=\"%s\",le=\"%s\"} %lu\n", name, program, le_str, cnt );
+  }
+
+  if( seconds ) fd_http_server_printf( http, "%s_sum{program=\"%s\"} %.17g\n", name, program, fd_metrics_convert_ticks_to_seconds( fd_histf_sum( hist ) ) );
+  else          fd_http_server_printf( http, "%s_sum{program=\"%s\"} %lu\n",   name, program, fd_histf_sum( hist ) );
+  fd_http_server_printf( http, "%s_count{program=\"%s\"} %lu\n", name, program, cnt );
+}
+
+void
+fd_prometheus_render_vm_prof( fd_vm_prof_t const * prof,
+                              ulong                top_max,
+                              fd_http_server_t *   http ) {
+  ulong top[ FD_PROMETHEUS_VM_PROF_TOP_MAX ];
+  ulong top_cnt = fd_vm_prof_top( prof, top, fd_ulong_min( top_max, FD_PROMETHEUS_VM_PROF_TOP_MAX ) );
+
+  fd_vm_prof_prog_t const * prog = fd_vm_prof_prog_const( prof );
+
+  char program[ FD_PROMETHEUS_VM_PROF_TOP_MAX ][ FD_BASE58_ENCODED_32_SZ ];
+  for( ulong i=0UL; i<top_cnt; i++ ) fd_base58_encode_32( prog[ top[ i ] ].id.uc, NULL, program[ i ] );
+
+  render_vm_prof_header( http, "vm_prof_programs_dropped", "counter", "Number of on-chain program invocations not profiled because they lost a race for a program table entry" );
+  fd_http_server_printf( http, "vm_prof_programs_dropped %lu\n", prof->prog_drop_cnt );
+
+  render_vm_prof_header( http, "vm_prof_programs_evicted", "counter", "Number of program table entries reclaimed from the program that consumed the fewest compute units" );
+  fd_http_server_printf( http, "vm_prof_programs_evicted %lu\n", prof->prog_evict_cnt );
+
+  render_vm_prof_header( http, "vm_prof_program_invocations", "counter", "Number of invocations of the on-chain programs that consumed the most compute units" );
+  for( ulong i=0UL; i<top_cnt; i++ ) {
+    fd_http_server_printf( http, "vm_prof_program_invocations{program=\"%s\"} %lu\n", program[ i ], prog[ top[ i ] ].invoke_cnt );
+  }
+
+  render_vm_prof_header( http, "vm_prof_program_samples", "counter", "Number of program counter samples taken while executing the program" );
+  for( ulong i=0UL; i<top_cnt; i++ ) {
+    fd_http_server_printf( http, "vm_prof_program_samples{program=\"%s\"} %lu\n", program[ i ], prog[ top[ i ] ].sample_cnt );
+  }
+
+  render_vm_prof_header( http, "vm_prof_program_samples_dropped", "counter", "Number of program counter samples evicted from the program's hot pc table" );
+  for( ulong i=0UL; i<top_cnt; i++ ) {
+    fd_http_server_printf( http, "vm_prof_program_samples_dropped{program=\"%s\"} %lu\n", program[ i ], prog[ top[ i ] ].sample_drop_cnt );
+  }
+
+  render_vm_prof_header( http, "vm_prof_program_compute_units", "histogram", "Compute units consumed per invocation of the program (including CPIs)" );
+  for( ulong i=0UL; i<top_cnt; i++ ) {
+    render_vm_prof_histogram( http, "vm_prof_program_compute_units", program[ i ], prog[ top[ i ] ].cu_hist, 0 );
+  }
+
+  render_vm_prof_header( http, "vm_prof_program_duration_seconds", "histogram", "Wallclock duration of each invocation of the program (including CPIs)" );
+  for( ulong i=0UL; i<top_cnt; i++ ) {
+    render_vm_prof_histogram( http, "vm_prof_program_duration_seconds", program[ i ], prog[ top[ i ] ].ticks_hist, 1 );
+  }
+}
@@ -1,7 +1,12 @@
 ifdef FD_HAS_INT128
 $(call add-hdrs,fd_rpc_service.h)
-$(call add-objs,fd_block_to_json fd_methods fd_rpc_service fd_webserver json_lex keywords fd_stub_to_json base_enc,fd_disco)
+$(call add-objs,fd_block_to_json fd_methods fd_rpc_service fd_webserver json_lex json_sax keywords fd_stub_to_json base_enc,fd_disco)
 
 $(call make-unit-test,test_rpc_keywords,test_keywords keywords,fd_util)
+$(call make-unit-test,test_json_sax,test_json_sax json_sax fd_methods json_lex keywords,fd_util)
 $(call make-fuzz-test,fuzz_json_lex,fuzz_json_lex json_lex,fd_util)
+ifdef FD_HAS_HOSTED
+$(call make-unit-test,test_rpc_service,test_rpc_service,fd_disco fd_flamenco fd_ballet fd_funk fd_tango fd_util,$(SECP256K1_LIBS))
+$(call run-unit-test,test_rpc_service)
+endif
 endif
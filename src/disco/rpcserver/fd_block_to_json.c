@@ -529,20 +529,21 @@ fd_txn_to_json_full( fd_webserver_t * ws,
   ushort acct_cnt = txn->acct_addr_cnt;
   const fd_pubkey_t * accts = (const fd_pubkey_t *)(raw + txn->acct_addr_off);
   char buf32[FD_BASE58_ENCODED_32_SZ];
+  char acct_strs[FD_TXN_ACCT_ADDR_MAX][FD_BASE58_ENCODED_32_SZ];
 
   if( encoding == FD_ENC_JSON ) {
+    fd_base58_encode_32_batch(accts[0].uc, acct_cnt, NULL, acct_strs[0]);
     for (ushort idx = 0; idx < acct_cnt; idx++) {
-      fd_base58_encode_32(accts[idx].uc, NULL, buf32);
-      fd_web_reply_sprintf(ws, "%s\"%s\"", (idx == 0 ? "" : ","), buf32);
+      fd_web_reply_sprintf(ws, "%s\"%s\"", (idx == 0 ? "" : ","), acct_strs[idx]);
     }
   } else if( encoding == FD_ENC_JSON_PARSED ) {
+    fd_base58_encode_32_batch(accts[0].uc, acct_cnt, NULL, acct_strs[0]);
     for (ushort idx = 0; idx < acct_cnt; idx++) {
-      fd_base58_encode_32(accts[idx].uc, NULL, buf32);
       bool signer = (idx < txn->signature_cnt);
       bool writable = ((idx < txn->signature_cnt - txn->readonly_signed_cnt) ||
                        ((idx >= txn->signature_cnt) && (idx < acct_cnt - txn->readonly_unsigned_cnt)));
       fd_web_reply_sprintf(ws, "%s{\"pubkey\":\"%s\",\"signer\":%s,\"source\":\"transaction\",\"writable\":%s}",
-                           (idx == 0 ? "" : ","), buf32, (signer ? "true" : "false"), (writable ? "true" : "false"));
+                           (idx == 0 ? "" : ","), acct_strs[idx], (signer ? "true" : "false"), (writable ? "true" : "false"));
     }
   }
 
@@ -588,10 +589,10 @@ fd_txn_to_json_full( fd_webserver_t * ws,
   fd_web_reply_sprintf(ws, "],\"recentBlockhash\":\"%s\"},\"signatures\":[", buf32);
 
   fd_ed25519_sig_t const * sigs = (fd_ed25519_sig_t const *)(raw + txn->signature_off);
+  char sig_strs[FD_TXN_SIG_MAX][FD_BASE58_ENCODED_64_SZ];
+  fd_base58_encode_64_batch((const uchar*)sigs, txn->signature_cnt, NULL, sig_strs[0]);
   for ( uchar j = 0; j < txn->signature_cnt; j++ ) {
-    char buf64[FD_BASE58_ENCODED_64_SZ];
-    fd_base58_encode_64((const uchar*)&sigs[j], NULL, buf64);
-    fd_web_reply_sprintf(ws, "%s\"%s\"", (j == 0 ? "" : ","), buf64);
+    fd_web_reply_sprintf(ws, "%s\"%s\"", (j == 0 ? "" : ","), sig_strs[j]);
   }
 
   const char* vers;
@@ -619,22 +620,22 @@ fd_txn_to_json_accts( fd_webserver_t * ws,
 
   ushort acct_cnt = txn->acct_addr_cnt;
   const fd_pubkey_t * accts = (const fd_pubkey_t *)(raw + txn->acct_addr_off);
-  char buf32[FD_BASE58_ENCODED_32_SZ];
+  char acct_strs[FD_TXN_ACCT_ADDR_MAX][FD_BASE58_ENCODED_32_SZ];
+  fd_base58_encode_32_batch(accts[0].uc, acct_cnt, NULL, acct_strs[0]);
   for (ushort idx = 0; idx < acct_cnt; idx++) {
-    fd_base58_encode_32(accts[idx].uc, NULL, buf32);
     bool signer = (idx < txn->signature_cnt);
     bool writable = ((idx < txn->signature_cnt - txn->readonly_signed_cnt) ||
                      ((idx >= txn->signature_cnt) && (idx < acct_cnt - txn->readonly_unsigned_cnt)));
     fd_web_reply_sprintf(ws, "%s{\"pubkey\":\"%s\",\"signer\":%s,\"source\":\"transaction\",\"writable\":%s}",
-                         (idx == 0 ? "" : ","), buf32, (signer ? "true" : "false"), (writable ? "true" : "false"));
+                         (idx == 0 ? "" : ","), acct_strs[idx], (signer ? "true" : "false"), (writable ? "true" : "false"));
   }
 
   fd_web_reply_sprintf(ws, "],\"signatures\":[");
   fd_ed25519_sig_t const * sigs = (fd_ed25519_sig_t const *)(raw + txn->signature_off);
+  char sig_strs[FD_TXN_SIG_MAX][FD_BASE58_ENCODED_64_SZ];
+  fd_base58_encode_64_batch((const uchar*)sigs, txn->signature_cnt, NULL, sig_strs[0]);
   for ( uchar j = 0; j < txn->signature_cnt; j++ ) {
-    char buf64[FD_BASE58_ENCODED_64_SZ];
-    fd_base58_encode_64((const uchar*)&sigs[j], NULL, buf64);
-    fd_web_reply_sprintf(ws, "%s\"%s\"", (j == 0 ? "" : ","), buf64);
+    fd_web_reply_sprintf(ws, "%s\"%s\"", (j == 0 ? "" : ","), sig_strs[j]);
   }
   EMIT_SIMPLE("]}");
 
@@ -727,10 +728,10 @@ fd_block_to_json( fd_webserver_t * ws,
 
           /* Loop across signatures */
           fd_ed25519_sig_t const * sigs = (fd_ed25519_sig_t const *)(raw + txn->signature_off);
+          char sig_strs[FD_TXN_SIG_MAX][FD_BASE58_ENCODED_64_SZ];
+          fd_base58_encode_64_batch((const uchar*)sigs, txn->signature_cnt, NULL, sig_strs[0]);
           for ( uchar j = 0; j < txn->signature_cnt; j++ ) {
-            char buf64[FD_BASE58_ENCODED_64_SZ];
-            fd_base58_encode_64((const uchar*)&sigs[j], NULL, buf64);
-            fd_web_reply_sprintf(ws, "%s\"%s\"", (first_sig ? "" : ","), buf64);
+            fd_web_reply_sprintf(ws, "%s\"%s\"", (first_sig ? "" : ","), sig_strs[j]);
             first_sig = 0;
           }
 
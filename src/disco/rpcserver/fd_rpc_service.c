@@ -10,6 +10,7 @@
 #include "../../flamenco/runtime/sysvar/fd_sysvar_epoch_schedule.h"
 #include "../../ballet/base58/fd_base58.h"
 #include "../../ballet/base64/fd_base64.h"
+#include "../../flamenco/fd_rwlock.h"
 #include "keywords.h"
 #include <errno.h>
 #include <stdlib.h>
@@ -66,9 +67,11 @@ struct fd_perf_sample {
 };
 typedef struct fd_perf_sample fd_perf_sample_t;
 
+#define FD_RPC_PERF_SAMPLE_MAX 720UL
+
 #define DEQUE_NAME fd_perf_sample_deque
 #define DEQUE_T    fd_perf_sample_t
-#define DEQUE_MAX  720UL /* MAX RPC PERF SAMPLES */
+#define DEQUE_MAX  FD_RPC_PERF_SAMPLE_MAX
 #include "../../util/tmpl/fd_deque.c"
 
 static int fd_hash_eq( const fd_hash_t * key1, const fd_hash_t * key2 ) {
@@ -103,17 +106,76 @@ typedef struct fd_rpc_acct_map_elem fd_rpc_acct_map_elem_t;
 #include "../../util/tmpl/fd_pool.c"
 #define FD_RPC_ACCT_MAP_POOL_SIZE (1U<<20)
 
+/* Responses to the hottest methods (getSlot, getLatestBlockhash,
+   getEpochInfo and getBalance) are cached per worker as pre-serialized
+   JSON, everything up to and including the "id": member, so a hit is
+   served with three appends.  An entry is valid while gen matches the
+   notif_gen of the global context, which is bumped on every replay
+   slot notification.  getEpochInfo keeps one entry per commitment
+   level, keyed by the slot the level resolves to.  getBalance keeps a
+   direct mapped table of accounts, and an entry is also dropped when
+   a replay account notification touches its account after acct_age. */
+
+#define FD_RPC_HOT_RESULT_MAX     512UL
+#define FD_RPC_HOT_EPOCH_INFO_CNT   4UL
+#define FD_RPC_HOT_BALANCE_CNT   1024UL /* power of 2 */
+
+struct fd_rpc_hot_result {
+  ulong       gen;      /* notif_gen when filled, 0 if empty */
+  ulong       slot;     /* slot the response was computed at */
+  ulong       acct_age; /* getBalance only, acct_age when filled */
+  fd_pubkey_t acct;     /* getBalance only */
+  ulong       len;
+  char        buf[FD_RPC_HOT_RESULT_MAX];
+};
+
+/* Replay notifications are broadcast to the workers through a ring of
+   the most recent FD_RPC_NOTIF_DEPTH messages, written under the global
+   lock, so that each worker sends websocket subscription updates on its
+   own connections.  A worker that falls more than FD_RPC_NOTIF_DEPTH
+   messages behind skips the ones it missed. */
+
+#define FD_RPC_NOTIF_DEPTH 1024UL /* power of 2 */
+
+/* Per worker state.  A worker serves its own listen socket (sharing the
+   port with the other workers) and is only ever touched by the thread
+   polling it. */
+
+struct fd_rpc_worker {
+  fd_webserver_t ws;
+  struct fd_ws_subscription sub_list[FD_WS_MAX_SUBS];
+  ulong sub_cnt;
+  fd_epoch_bank_t * epoch_bank;
+  ulong epoch_bank_epoch;
+  ulong notif_seq; /* sequence number of the next notification to process */
+  struct fd_rpc_hot_result slot_hot;
+  struct fd_rpc_hot_result blockhash_hot;
+  struct fd_rpc_hot_result epoch_info_hot[FD_RPC_HOT_EPOCH_INFO_CNT];
+  ulong epoch_info_hot_next;
+  struct fd_rpc_hot_result balance_hot[FD_RPC_HOT_BALANCE_CNT];
+};
+typedef struct fd_rpc_worker fd_rpc_worker_t;
+
+#define FD_RPC_WORKER_MAX 64UL
+
+/* The global context is shared by the workers.  Everything the replay
+   and stake notifications update is protected by lock.  Method handlers
+   hold it for reading only while they copy shared state out, never
+   while they serialize a reply, so that notifications are not held up
+   by slow requests. */
+
 struct fd_rpc_global_ctx {
   fd_valloc_t valloc;
-  fd_webserver_t ws;
+  fd_rwlock_t lock;
   fd_funk_t * funk;
   fd_blockstore_t * blockstore;
   int blockstore_fd;
-  struct fd_ws_subscription sub_list[FD_WS_MAX_SUBS];
-  ulong sub_cnt;
   ulong last_subsc_id;
-  fd_epoch_bank_t * epoch_bank;
-  ulong epoch_bank_epoch;
+  fd_rpc_ctx_t * workers[FD_RPC_WORKER_MAX];
+  ulong worker_cnt;
+  ulong notif_gen;
+  fd_replay_notif_msg_t * notif_ring;
+  ulong notif_seq; /* sequence number of the next notification to publish */
   fd_replay_notif_msg_t last_slot_notify;
   int tpu_socket;
   struct sockaddr_in tpu_addr;
@@ -131,6 +193,11 @@ typedef struct fd_rpc_global_ctx fd_rpc_global_ctx_t;
 struct fd_rpc_ctx {
   char call_id[64];
   fd_rpc_global_ctx_t * global;
+  fd_rpc_worker_t * worker;
+  /* Copied from global under the lock when a request starts */
+  __typeof__( ((fd_replay_notif_msg_t *)0)->slot_exec ) last_slot;
+  ulong notif_gen;
+  ulong acct_age;
 };
 
 static void *
@@ -142,7 +209,7 @@ read_account( fd_rpc_ctx_t * ctx, fd_pubkey_t * acct, ulong * result_len ) {
 
 static void
 fd_method_simple_error( fd_rpc_ctx_t * ctx, int errcode, const char* text ) {
-  fd_web_reply_error( &ctx->global->ws, errcode, text, ctx->call_id );
+  fd_web_reply_error( &ctx->worker->ws, errcode, text, ctx->call_id );
 }
 
 static void
@@ -184,23 +251,88 @@ get_slot_from_commitment_level( struct json_values * values, fd_rpc_ctx_t * ctx
   }
 }
 
+/* hot_fill serializes the response prefix of a hot method into hot,
+   valid until the next slot notification.  The prefixes are made of a
+   handful of numbers and hashes and always fit. */
+
+static void
+hot_fill( fd_rpc_ctx_t * ctx, struct fd_rpc_hot_result * hot, ulong slot, const char * format, ... )
+  __attribute__ ((format (printf, 4, 5)));
+
+static void
+hot_fill( fd_rpc_ctx_t * ctx, struct fd_rpc_hot_result * hot, ulong slot, const char * format, ... ) {
+  va_list ap;
+  va_start(ap, format);
+  int r = vsnprintf(hot->buf, sizeof(hot->buf), format, ap);
+  va_end(ap);
+  FD_TEST( r>=0 && (ulong)r<sizeof(hot->buf) );
+  hot->gen  = ctx->notif_gen;
+  hot->slot = slot;
+  hot->len  = (ulong)r;
+}
+
+/* hot_reply completes a cached response prefix with the call id */
+
+static void
+hot_reply( fd_rpc_ctx_t * ctx, struct fd_rpc_hot_result const * hot ) {
+  fd_webserver_t * ws = &ctx->worker->ws;
+  fd_web_reply_append(ws, hot->buf, hot->len);
+  fd_web_reply_append(ws, ctx->call_id, strlen(ctx->call_id));
+  EMIT_SIMPLE("}" CRLF);
+}
+
+/* reply_id finishes a reply with the call id.  reply_ulong emits a
+   complete reply with an integer result.  Neither goes through printf
+   formatting. */
+
+static void
+reply_id( fd_rpc_ctx_t * ctx ) {
+  fd_webserver_t * ws = &ctx->worker->ws;
+  EMIT_SIMPLE("\"id\":");
+  fd_web_reply_append(ws, ctx->call_id, strlen(ctx->call_id));
+  EMIT_SIMPLE("}" CRLF);
+}
+
+static void
+reply_ulong( fd_rpc_ctx_t * ctx, ulong val ) {
+  fd_webserver_t * ws = &ctx->worker->ws;
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":");
+  fd_web_reply_append_ulong(ws, val);
+  EMIT_SIMPLE(",");
+  reply_id(ctx);
+}
+
+static int
+hot_balance_valid( fd_rpc_ctx_t * ctx, struct fd_rpc_hot_result const * hot, fd_pubkey_t const * acct ) {
+  fd_rpc_global_ctx_t * glob = ctx->global;
+  if( hot->gen != ctx->notif_gen || !fd_hash_eq( &hot->acct, acct ) ) return 0;
+  if( glob->acct_map == NULL ) return 1;
+  /* The map chain inserts at the head, so this is the latest touch */
+  fd_rwlock_read( &glob->lock );
+  fd_rpc_acct_map_elem_t const * ele = fd_rpc_acct_map_ele_query_const( glob->acct_map, acct, NULL, glob->acct_pool );
+  int valid = ele == NULL || ele->age < hot->acct_age;
+  fd_rwlock_unread( &glob->lock );
+  return valid;
+}
+
 fd_epoch_bank_t *
 read_epoch_bank( fd_rpc_ctx_t * ctx, ulong slot ) {
   fd_rpc_global_ctx_t * glob = ctx->global;
+  fd_rpc_worker_t * worker = ctx->worker;
 
   for(;;) FD_SCRATCH_SCOPE_BEGIN {
-    if( glob->epoch_bank != NULL &&
-        glob->epoch_bank_epoch == fd_slot_to_epoch(&glob->epoch_bank->epoch_schedule, slot, NULL) ) {
+    if( worker->epoch_bank != NULL &&
+        worker->epoch_bank_epoch == fd_slot_to_epoch(&worker->epoch_bank->epoch_schedule, slot, NULL) ) {
       /* Leave lock held */
-      return glob->epoch_bank;
+      return worker->epoch_bank;
     }
 
-    if( glob->epoch_bank != NULL ) {
+    if( worker->epoch_bank != NULL ) {
       fd_bincode_destroy_ctx_t binctx;
       binctx.valloc = glob->valloc;
-      fd_epoch_bank_destroy( glob->epoch_bank, &binctx );
-      fd_valloc_free( glob->valloc, glob->epoch_bank );
-      glob->epoch_bank = NULL;
+      fd_epoch_bank_destroy( worker->epoch_bank, &binctx );
+      fd_valloc_free( glob->valloc, worker->epoch_bank );
+      worker->epoch_bank = NULL;
     }
 
     fd_funk_rec_key_t recid = fd_runtime_epoch_bank_key();
@@ -237,8 +369,8 @@ read_epoch_bank( fd_rpc_ctx_t * ctx, ulong slot ) {
       FD_LOG_ERR(("failed to read banks record: invalid magic number"));
     }
 
-    glob->epoch_bank = epoch_bank;
-    glob->epoch_bank_epoch = fd_slot_to_epoch(&epoch_bank->epoch_schedule, slot, NULL);
+    worker->epoch_bank = epoch_bank;
+    worker->epoch_bank_epoch = fd_slot_to_epoch(&epoch_bank->epoch_schedule, slot, NULL);
   } FD_SCRATCH_SCOPE_END;
 }
 
@@ -304,7 +436,7 @@ block_flags_to_confirmation_status( uchar flags ) {
 
 static int
 method_getAccountInfo(struct json_values* values, fd_rpc_ctx_t * ctx) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
 
   FD_SCRATCH_SCOPE_BEGIN {
     // Path to argument
@@ -352,7 +484,7 @@ method_getAccountInfo(struct json_values* values, fd_rpc_ctx_t * ctx) {
     void * val = read_account(ctx, &acct, &val_sz);
     if (val == NULL) {
       fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":null},\"id\":%s}" CRLF,
-                           ctx->global->last_slot_notify.slot_exec.slot, ctx->call_id);
+                           ctx->last_slot.slot, ctx->call_id);
       return 0;
     }
 
@@ -378,7 +510,7 @@ method_getAccountInfo(struct json_values* values, fd_rpc_ctx_t * ctx) {
     long len = (len_ptr ? *(long *)len_ptr : FD_LONG_UNSET);
 
     fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":",
-                         ctx->global->last_slot_notify.slot_exec.slot);
+                         ctx->last_slot.slot);
     const char * err = fd_account_to_json( ws, acct, enc, val, val_sz, off, len );
     if( err ) {
       fd_method_error(ctx, -1, "%s", err);
@@ -403,7 +535,6 @@ method_getBalance(struct json_values* values, fd_rpc_ctx_t * ctx) {
       (JSON_TOKEN_LBRACKET<<16) | 0,
       (JSON_TOKEN_STRING<<16)
     };
-    fd_webserver_t * ws = &ctx->global->ws;
     ulong arg_sz = 0;
     const void* arg = json_get_value(values, PATH, 3, &arg_sz);
     if (arg == NULL) {
@@ -415,16 +546,21 @@ method_getBalance(struct json_values* values, fd_rpc_ctx_t * ctx) {
       fd_method_error(ctx, -1, "invalid base58 encoding");
       return 0;
     }
-    ulong val_sz;
-    void * val = read_account(ctx, &acct, &val_sz);
-    if (val == NULL) {
-      fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":0},\"id\":%s}" CRLF,
-                         ctx->global->last_slot_notify.slot_exec.slot, ctx->call_id);
+    struct fd_rpc_hot_result * hot = &ctx->worker->balance_hot[acct.ul[0] & (FD_RPC_HOT_BALANCE_CNT-1UL)];
+    if( hot_balance_valid( ctx, hot, &acct ) ) {
+      hot_reply( ctx, hot );
       return 0;
     }
-    fd_account_meta_t * metadata = (fd_account_meta_t *)val;
-    fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":%lu},\"id\":%s}" CRLF,
-                         ctx->global->last_slot_notify.slot_exec.slot, metadata->info.lamports, ctx->call_id);
+    ulong acct_age = ctx->acct_age;
+    ulong slot = ctx->last_slot.slot;
+    ulong val_sz;
+    void * val = read_account(ctx, &acct, &val_sz);
+    ulong lamports = ( val == NULL ? 0UL : ((fd_account_meta_t *)val)->info.lamports );
+    hot_fill( ctx, hot, slot, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":%lu},\"id\":",
+              slot, lamports );
+    hot->acct     = acct;
+    hot->acct_age = acct_age;
+    hot_reply( ctx, hot );
   } FD_SCRATCH_SCOPE_END;
   return 0;
 }
@@ -464,7 +600,7 @@ method_getBlock(struct json_values* values, fd_rpc_ctx_t * ctx) {
     (JSON_TOKEN_BOOL<<16)
   };
 
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   ulong slot_sz = 0;
   const void* slot = json_get_value(values, PATH_SLOT, 3, &slot_sz);
   if (slot == NULL) {
@@ -556,10 +692,7 @@ method_getBlockCommitment(struct json_values* values, fd_rpc_ctx_t * ctx) {
 static int
 method_getBlockHeight(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void) values;
-  fd_rpc_global_ctx_t * glob = ctx->global;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}" CRLF,
-                       glob->last_slot_notify.slot_exec.height, ctx->call_id);
+  reply_ulong(ctx, ctx->last_slot.height);
   return 0;
 }
 
@@ -590,11 +723,12 @@ static int
 method_getBlockProduction(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void)values;
   fd_rpc_global_ctx_t * glob = ctx->global;
-  fd_webserver_t * ws = &glob->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   fd_blockstore_t * blockstore = glob->blockstore;
   FD_SCRATCH_SCOPE_BEGIN {
     ulong startslot = blockstore->smr;
     ulong endslot = blockstore->lps;
+    fd_rwlock_read( &glob->lock );
     fd_per_epoch_info_t const * ei = glob->stake_ci->epoch_info;
     startslot = fd_ulong_max( startslot, fd_ulong_min( ei[0].start_slot, ei[1].start_slot ) );
 
@@ -629,9 +763,10 @@ method_getBlockProduction(struct json_values* values, fd_rpc_ctx_t * ctx) {
         }
       }
     }
+    fd_rwlock_unread( &glob->lock );
 
     fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":{\"byIdentity\":{",
-                         ctx->global->last_slot_notify.slot_exec.slot);
+                         ctx->last_slot.slot);
     int first=1;
     for ( product_rb_node_t* nd = product_rb_minimum(pool, root); nd; nd = product_rb_successor(pool, nd) ) {
       char str[50];
@@ -655,7 +790,7 @@ method_getBlocks(struct json_values* values, fd_rpc_ctx_t * ctx) {
     (JSON_TOKEN_LBRACKET<<16) | 0,
     (JSON_TOKEN_INTEGER<<16)
   };
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   ulong startslot_sz = 0;
   const void* startslot = json_get_value(values, PATH_STARTSLOT, 3, &startslot_sz);
   if (startslot == NULL) {
@@ -678,17 +813,19 @@ method_getBlocks(struct json_values* values, fd_rpc_ctx_t * ctx) {
   if (endslotn > blockstore->hcs)
     endslotn = blockstore->hcs;
 
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":[");
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":[");
   uint cnt = 0;
   for ( ulong i = startslotn; i <= endslotn && cnt < 500000U; ++i ) {
     fd_block_map_t meta[1];
     int ret = fd_blockstore_block_map_query_volatile(blockstore, ctx->global->blockstore_fd, i, meta);
     if (!ret) {
-      fd_web_reply_sprintf(ws, "%s%lu", (cnt==0 ? "" : ","), i);
+      if (cnt) EMIT_SIMPLE(",");
+      fd_web_reply_append_ulong(ws, i);
       ++cnt;
     }
   }
-  fd_web_reply_sprintf(ws, "],\"id\":%s}" CRLF, ctx->call_id);
+  EMIT_SIMPLE("],");
+  reply_id(ctx);
 
   return 0;
 }
@@ -703,7 +840,7 @@ method_getBlocksWithLimit(struct json_values* values, fd_rpc_ctx_t * ctx) {
     (JSON_TOKEN_LBRACKET<<16) | 0,
     (JSON_TOKEN_INTEGER<<16)
   };
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   ulong startslot_sz = 0;
   const void* startslot = json_get_value(values, PATH_SLOT, 3, &startslot_sz);
   if (startslot == NULL) {
@@ -730,21 +867,23 @@ method_getBlocksWithLimit(struct json_values* values, fd_rpc_ctx_t * ctx) {
   if (limitn > 500000)
     limitn = 500000;
 
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":[");
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":[");
   uint cnt = 0;
   uint skips = 0;
   for ( ulong i = startslotn; i <= blockstore->lps && cnt < limitn && skips < 100U; ++i ) {
     fd_block_map_t meta[1];
     int ret = fd_blockstore_block_map_query_volatile(blockstore, ctx->global->blockstore_fd, i, meta);
     if (!ret) {
-      fd_web_reply_sprintf(ws, "%s%lu", (cnt==0 ? "" : ","), i);
+      if (cnt) EMIT_SIMPLE(",");
+      fd_web_reply_append_ulong(ws, i);
       ++cnt;
       skips = 0;
     } else {
       ++skips;
     }
   }
-  fd_web_reply_sprintf(ws, "],\"id\":%s}" CRLF, ctx->call_id);
+  EMIT_SIMPLE("],");
+  reply_id(ctx);
 
   return 0;
 }
@@ -759,7 +898,7 @@ method_getBlockTime(struct json_values* values, fd_rpc_ctx_t * ctx) {
     (JSON_TOKEN_LBRACKET<<16) | 0,
     (JSON_TOKEN_INTEGER<<16)
   };
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   ulong slot_sz = 0;
   const void* slot = json_get_value(values, PATH_SLOT, 3, &slot_sz);
   if (slot == NULL) {
@@ -776,9 +915,10 @@ method_getBlockTime(struct json_values* values, fd_rpc_ctx_t * ctx) {
     return 0;
   }
 
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%ld,\"id\":%s}" CRLF,
-                       meta->ts/(long)1e9,
-                       ctx->call_id);
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":");
+  fd_web_reply_append_long(ws, meta->ts/(long)1e9);
+  EMIT_SIMPLE(",");
+  reply_id(ctx);
   return 0;
 }
 
@@ -800,8 +940,18 @@ method_getEpochInfo(struct json_values* values, fd_rpc_ctx_t * ctx) {
 
   FD_SCRATCH_SCOPE_BEGIN { /* read_epoch consumes a ton of scratch space! */
 
-    fd_webserver_t * ws   = &ctx->global->ws;
+    fd_webserver_t * ws   = &ctx->worker->ws;
     ulong            slot = get_slot_from_commitment_level( values, ctx );
+    if( slot == FD_SLOT_NULL ) return 0;
+
+    fd_rpc_worker_t * worker = ctx->worker;
+    for( ulong i = 0; i < FD_RPC_HOT_EPOCH_INFO_CNT; ++i ) {
+      struct fd_rpc_hot_result * hot = &worker->epoch_info_hot[i];
+      if( hot->gen == ctx->notif_gen && hot->slot == slot ) {
+        hot_reply( ctx, hot );
+        return 0;
+      }
+    }
 
     fd_epoch_bank_t * epoch_bank = read_epoch_bank(ctx, slot );
     if( epoch_bank == NULL ) {
@@ -812,14 +962,28 @@ method_getEpochInfo(struct json_values* values, fd_rpc_ctx_t * ctx) {
     ulong epoch = fd_slot_to_epoch( &epoch_bank->epoch_schedule, slot, &slot_index );
     fd_block_map_t meta[1];
     int ret = fd_blockstore_block_map_query_volatile(ctx->global->blockstore, ctx->global->blockstore_fd, slot, meta);
-    fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"absoluteSlot\":%lu,\"blockHeight\":%lu,\"epoch\":%lu,\"slotIndex\":%lu,\"slotsInEpoch\":%lu,\"transactionCount\":%lu},\"id\":%s}" CRLF,
-                         slot,
-                         (!ret ? meta->height : 0UL),
-                         epoch,
-                         slot_index,
-                         fd_epoch_slot_cnt( &epoch_bank->epoch_schedule, epoch ),
-                         ctx->global->last_slot_notify.slot_exec.transaction_count,
-                         ctx->call_id);
+    if( ret ) {
+      /* Not cached, the height may show up later */
+      fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"absoluteSlot\":%lu,\"blockHeight\":%lu,\"epoch\":%lu,\"slotIndex\":%lu,\"slotsInEpoch\":%lu,\"transactionCount\":%lu},\"id\":%s}" CRLF,
+                           slot,
+                           0UL,
+                           epoch,
+                           slot_index,
+                           fd_epoch_slot_cnt( &epoch_bank->epoch_schedule, epoch ),
+                           ctx->last_slot.transaction_count,
+                           ctx->call_id);
+      return 0;
+    }
+    struct fd_rpc_hot_result * hot = &worker->epoch_info_hot[worker->epoch_info_hot_next];
+    worker->epoch_info_hot_next = (worker->epoch_info_hot_next + 1UL) % FD_RPC_HOT_EPOCH_INFO_CNT;
+    hot_fill( ctx, hot, slot, "{\"jsonrpc\":\"2.0\",\"result\":{\"absoluteSlot\":%lu,\"blockHeight\":%lu,\"epoch\":%lu,\"slotIndex\":%lu,\"slotsInEpoch\":%lu,\"transactionCount\":%lu},\"id\":",
+              slot,
+              meta->height,
+              epoch,
+              slot_index,
+              fd_epoch_slot_cnt( &epoch_bank->epoch_schedule, epoch ),
+              ctx->last_slot.transaction_count );
+    hot_reply( ctx, hot );
   } FD_SCRATCH_SCOPE_END;
   return 0;
 }
@@ -831,7 +995,7 @@ static int
 method_getEpochSchedule(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void)values;
   FD_SCRATCH_SCOPE_BEGIN { /* read_epoch consumes a ton of scratch space! */
-    fd_webserver_t * ws = &ctx->global->ws;
+    fd_webserver_t * ws = &ctx->worker->ws;
     ulong            slot = get_slot_from_commitment_level( values, ctx );
     fd_epoch_bank_t * epoch_bank = read_epoch_bank(ctx, slot );
     if( FD_UNLIKELY( !epoch_bank ) ) {
@@ -852,7 +1016,7 @@ method_getEpochSchedule(struct json_values* values, fd_rpc_ctx_t * ctx) {
 // Implementation of the "getFeeForMessage" methods
 static int
 method_getFeeForMessage(struct json_values* values, fd_rpc_ctx_t * ctx) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   static const uint PATH[3] = {
     (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_PARAMS,
     (JSON_TOKEN_LBRACKET<<16) | 0,
@@ -879,7 +1043,7 @@ method_getFeeForMessage(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void)data;
   (void)data_sz;
   fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":5000},\"id\":%s}" CRLF,
-                       ctx->global->last_slot_notify.slot_exec.slot, ctx->call_id);
+                       ctx->last_slot.slot, ctx->call_id);
   return 0;
 }
 
@@ -890,9 +1054,7 @@ static int
 method_getFirstAvailableBlock(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void) values;
   fd_blockstore_t * blockstore = ctx->global->blockstore;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}" CRLF,
-                       blockstore->smr, ctx->call_id); /* FIXME archival file */
+  reply_ulong(ctx, blockstore->smr); /* FIXME archival file */
   return 0;
 }
 
@@ -909,10 +1071,11 @@ method_getGenesisHash(struct json_values* values, fd_rpc_ctx_t * ctx) {
       fd_method_error(ctx, -1, "unable to read epoch_bank");
       return 0;
     }
-    fd_webserver_t * ws = &ctx->global->ws;
-    fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":\"");
-    fd_web_reply_encode_base58(ws, epoch_bank->genesis_hash.uc, sizeof(fd_pubkey_t));
-    fd_web_reply_sprintf(ws, "\",\"id\":%s}" CRLF, ctx->call_id);
+    fd_webserver_t * ws = &ctx->worker->ws;
+    EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":\"");
+    fd_web_reply_encode_base58_32(ws, epoch_bank->genesis_hash.uc);
+    EMIT_SIMPLE("\",");
+    reply_id(ctx);
   } FD_SCRATCH_SCOPE_END;
   return 0;
 }
@@ -921,8 +1084,9 @@ method_getGenesisHash(struct json_values* values, fd_rpc_ctx_t * ctx) {
 static int
 method_getHealth(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void)values;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":\"ok\",\"id\":%s}" CRLF, ctx->call_id);
+  fd_webserver_t * ws = &ctx->worker->ws;
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":\"ok\",");
+  reply_id(ctx);
   return 0;
 }
 
@@ -942,11 +1106,11 @@ method_getHighestSnapshotSlot(struct json_values* values, fd_rpc_ctx_t * ctx) {
 static int
 method_getIdentity(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void)values;
-  fd_rpc_global_ctx_t * glob = ctx->global;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"identity\":\"");
-  fd_web_reply_encode_base58(ws, &glob->last_slot_notify.slot_exec.identity, sizeof(fd_pubkey_t));
-  fd_web_reply_sprintf(ws, "\"},\"id\":%s}" CRLF, ctx->call_id);
+  fd_webserver_t * ws = &ctx->worker->ws;
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":{\"identity\":\"");
+  fd_web_reply_encode_base58_32(ws, &ctx->last_slot.identity);
+  EMIT_SIMPLE("\"},");
+  reply_id(ctx);
   return 0;
 }
 // Implementation of the "getInflationGovernor" methods
@@ -970,7 +1134,7 @@ method_getInflationRate(struct json_values* values, fd_rpc_ctx_t * ctx) {
   fd_method_error(ctx, -1, "getInflationRate is not implemented");
   return 0;
   /* FIXME!
-     fd_webserver_t * ws = &ctx->global->ws;
+     fd_webserver_t * ws = &ctx->worker->ws;
      fd_inflation_rates_t rates;
      calculate_inflation_rates( get_slot_ctx(ctx), &rates );
      fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"epoch\":%lu,\"foundation\":%.18f,\"total\":%.18f,\"validator\":%.18f},\"id\":%s}" CRLF,
@@ -1010,13 +1174,15 @@ method_getLargestAccounts(struct json_values* values, fd_rpc_ctx_t * ctx) {
 static int
 method_getLatestBlockhash(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void) values;
-  fd_rpc_global_ctx_t * glob = ctx->global;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":{\"blockhash\":\"",
-                       glob->last_slot_notify.slot_exec.slot);
-  fd_web_reply_encode_base58(ws, &glob->last_slot_notify.slot_exec.block_hash, sizeof(fd_hash_t));
-  fd_web_reply_sprintf(ws, "\",\"lastValidBlockHeight\":%lu}},\"id\":%s}" CRLF,
-                       glob->last_slot_notify.slot_exec.height, ctx->call_id);
+  struct fd_rpc_hot_result * hot = &ctx->worker->blockhash_hot;
+  if( hot->gen != ctx->notif_gen ) {
+    char block_hash[FD_BASE58_ENCODED_32_SZ];
+    fd_base58_encode_32(ctx->last_slot.block_hash.uc, 0, block_hash);
+    hot_fill( ctx, hot, ctx->last_slot.slot,
+              "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":{\"blockhash\":\"%s\",\"lastValidBlockHeight\":%lu}},\"id\":",
+              ctx->last_slot.slot, block_hash, ctx->last_slot.height );
+  }
+  hot_reply( ctx, hot );
   return 0;
 }
 
@@ -1046,7 +1212,7 @@ FD_FN_PURE static long leader_rb_compare(leader_rb_node_t* left, leader_rb_node_
 static int
 method_getLeaderSchedule(struct json_values* values, fd_rpc_ctx_t * ctx) {
   FD_SCRATCH_SCOPE_BEGIN {
-    fd_webserver_t * ws = &ctx->global->ws;
+    fd_webserver_t * ws = &ctx->worker->ws;
     ulong            slot = get_slot_from_commitment_level( values, ctx );
 
     fd_epoch_bank_t * epoch_bank = read_epoch_bank(ctx, slot);
@@ -1056,6 +1222,7 @@ method_getLeaderSchedule(struct json_values* values, fd_rpc_ctx_t * ctx) {
     }
     ulong slot_index;
     ulong epoch = fd_slot_to_epoch( &epoch_bank->epoch_schedule, slot, &slot_index );
+    fd_rwlock_read( &ctx->global->lock );
     fd_epoch_leaders_t * leaders = ctx->global->stake_ci->epoch_info[epoch%2].lsched;
 
     /* Reorganize the map to index on sorted leader key */
@@ -1080,6 +1247,7 @@ method_getLeaderSchedule(struct json_values* values, fd_rpc_ctx_t * ctx) {
         leader_rb_insert( pool, &root, nd );
       }
     }
+    fd_rwlock_unread( &ctx->global->lock );
 
     fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{");
 
@@ -1119,9 +1287,7 @@ static int
 method_getMaxShredInsertSlot(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void) values;
   fd_blockstore_t * blockstore = ctx->global->blockstore;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}" CRLF,
-                       blockstore->smr, ctx->call_id); /* FIXME archival file */
+  reply_ulong(ctx, blockstore->smr); /* FIXME archival file */
   return 0;
 }
 
@@ -1147,9 +1313,7 @@ method_getMinimumBalanceForRentExemption(struct json_values* values, fd_rpc_ctx_
     }
     ulong min_balance = fd_rent_exempt_minimum_balance( &epoch_bank->rent, sizen );
 
-    fd_webserver_t * ws = &ctx->global->ws;
-    fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}" CRLF,
-                         min_balance, ctx->call_id);
+    reply_ulong(ctx, min_balance);
   } FD_SCRATCH_SCOPE_END;
   return 0;
 }
@@ -1166,7 +1330,7 @@ method_getMultipleAccounts(struct json_values* values, fd_rpc_ctx_t * ctx) {
       (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_ENCODING,
       (JSON_TOKEN_STRING<<16)
     };
-    fd_webserver_t * ws = &ctx->global->ws;
+    fd_webserver_t * ws = &ctx->worker->ws;
     ulong enc_str_sz = 0;
     const void* enc_str = json_get_value(values, ENC_PATH, 4, &enc_str_sz);
     fd_rpc_encoding_t enc;
@@ -1184,7 +1348,7 @@ method_getMultipleAccounts(struct json_values* values, fd_rpc_ctx_t * ctx) {
     }
 
     fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":[",
-                         ctx->global->last_slot_notify.slot_exec.slot);
+                         ctx->last_slot.slot);
 
     // Iterate through account ids
     for ( ulong i = 0; ; ++i ) {
@@ -1245,7 +1409,7 @@ method_getRecentPerformanceSamples(struct json_values* values, fd_rpc_ctx_t * ct
   (void)values;
   (void)ctx;
 
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
 
   static const uint PATH_LIMIT[3] = {
     (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_PARAMS,
@@ -1261,12 +1425,18 @@ method_getRecentPerformanceSamples(struct json_values* values, fd_rpc_ctx_t * ct
   }
   ulong limitn = (ulong)(*(long*)limit);
 
+  fd_perf_sample_t samples[ FD_RPC_PERF_SAMPLE_MAX ];
+  fd_rwlock_read( &ctx->global->lock );
   ulong cnt = fd_ulong_min( fd_perf_sample_deque_cnt( ctx->global->perf_samples ), limitn );
+  for (ulong i = 0; i < cnt; i++) {
+    samples[i] = *fd_perf_sample_deque_peek_index_const( ctx->global->perf_samples, i );
+  }
+  fd_rwlock_unread( &ctx->global->lock );
+
   fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":[");
 
   for (ulong i = 0; i < cnt; i++) {
-    fd_perf_sample_t const * perf_sample = fd_perf_sample_deque_peek_index_const( ctx->global->perf_samples, i );
-    FD_TEST( perf_sample );
+    fd_perf_sample_t const * perf_sample = &samples[i];
     fd_web_reply_sprintf(ws, "{\"numSlots\":%lu,\"numTransactions\":%lu,\"numNonVoteTransactions\":%lu,\"samplePeriodSecs\":60,\"slot\":%lu}", perf_sample->num_slots, perf_sample->num_transactions, perf_sample->num_non_vote_transactions, perf_sample->highest_slot );
     if ( FD_LIKELY( i < cnt - 1 ) ) {
       fd_web_reply_sprintf(ws, ",");
@@ -1290,7 +1460,7 @@ method_getRecentPrioritizationFees(struct json_values* values, fd_rpc_ctx_t * ct
 // Implementation of the "getSignaturesForAddress" methods
 static int
 method_getSignaturesForAddress(struct json_values* values, fd_rpc_ctx_t * ctx) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
 
   FD_SCRATCH_SCOPE_BEGIN {
     // Path to argument
@@ -1321,13 +1491,22 @@ method_getSignaturesForAddress(struct json_values* values, fd_rpc_ctx_t * ctx) {
     const void* limit_ptr = json_get_value(values, PATH2, 4, &limit_sz);
     ulong limit = ( limit_ptr ? fd_ulong_min( *(const ulong*)limit_ptr, 1000U ) : 1000U );
 
-    fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":[");
     fd_rpc_global_ctx_t * gctx = ctx->global;
-    fd_rpc_acct_map_elem_t const * ele = fd_rpc_acct_map_ele_query_const( gctx->acct_map, &acct, NULL, gctx->acct_pool );
+    fd_rpc_acct_map_elem_t * eles = fd_scratch_alloc( alignof(fd_rpc_acct_map_elem_t), limit*sizeof(fd_rpc_acct_map_elem_t) );
     ulong cnt = 0;
+    fd_rwlock_read( &gctx->lock );
+    for( fd_rpc_acct_map_elem_t const * ele = fd_rpc_acct_map_ele_query_const( gctx->acct_map, &acct, NULL, gctx->acct_pool );
+         ele != NULL && cnt < limit;
+         ele = fd_rpc_acct_map_ele_next_const( ele, NULL, gctx->acct_pool ) ) {
+      eles[cnt++] = *ele;
+    }
+    fd_rwlock_unread( &gctx->lock );
+
+    fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":[");
     fd_block_map_t block_map_entry = { 0 };
-    while( ele != NULL && cnt < limit ) {
-      if( cnt ) EMIT_SIMPLE(",");
+    for( ulong i = 0; i < cnt; i++ ) {
+      fd_rpc_acct_map_elem_t const * ele = &eles[i];
+      if( i ) EMIT_SIMPLE(",");
 
       if( FD_UNLIKELY( block_map_entry.slot != ele->slot ) ) {
         fd_blockstore_block_map_query_volatile( gctx->blockstore, ctx->global->blockstore_fd, ele->slot, &block_map_entry );
@@ -1336,10 +1515,6 @@ method_getSignaturesForAddress(struct json_values* values, fd_rpc_ctx_t * ctx) {
       fd_base58_encode_64(ele->sig, NULL, buf64);
       fd_web_reply_sprintf(ws, "{\"blockTime\":%ld,\"confirmationStatus\":%s,\"err\":null,\"memo\":null,\"signature\":\"%s\",\"slot\":%lu}",
                            block_map_entry.ts/(long)1e9, block_flags_to_confirmation_status(block_map_entry.flags), buf64, ele->slot);
-
-      cnt++;
-
-      ele = fd_rpc_acct_map_ele_next_const( ele, NULL, gctx->acct_pool );
     }
     fd_web_reply_sprintf(ws, "],\"id\":%s}" CRLF, ctx->call_id);
 
@@ -1353,10 +1528,10 @@ method_getSignaturesForAddress(struct json_values* values, fd_rpc_ctx_t * ctx) {
 
 static int
 method_getSignatureStatuses(struct json_values* values, fd_rpc_ctx_t * ctx) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   fd_blockstore_t * blockstore = ctx->global->blockstore;
   fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":[",
-                       ctx->global->last_slot_notify.slot_exec.slot);
+                       ctx->last_slot.slot);
 
   // Iterate through account ids
   for ( ulong i = 0; ; ++i ) {
@@ -1377,22 +1552,27 @@ method_getSignatureStatuses(struct json_values* values, fd_rpc_ctx_t * ctx) {
 
     uchar key[FD_ED25519_SIG_SZ];
     if ( fd_base58_decode_64( sig, key ) == NULL ) {
-      fd_web_reply_sprintf(ws, "null");
+      EMIT_SIMPLE("null");
       continue;
     }
     fd_txn_map_t elem;
     uchar flags;
     if( fd_blockstore_txn_query_volatile( blockstore, ctx->global->blockstore_fd,  key, &elem, NULL, &flags, NULL ) ) {
-      fd_web_reply_sprintf(ws, "null");
+      EMIT_SIMPLE("null");
       continue;
     }
 
     // TODO other fields
-    fd_web_reply_sprintf(ws, "{\"slot\":%lu,\"confirmations\":null,\"err\":null,\"status\":{\"Ok\":null},\"confirmationStatus\":%s}",
-                         elem.slot, block_flags_to_confirmation_status(flags));
+    EMIT_SIMPLE("{\"slot\":");
+    fd_web_reply_append_ulong(ws, elem.slot);
+    EMIT_SIMPLE(",\"confirmations\":null,\"err\":null,\"status\":{\"Ok\":null},\"confirmationStatus\":");
+    const char * status = block_flags_to_confirmation_status(flags);
+    fd_web_reply_append(ws, status, strlen(status));
+    EMIT_SIMPLE("}");
   }
 
-  fd_web_reply_sprintf(ws, "]},\"id\":%s}" CRLF, ctx->call_id);
+  EMIT_SIMPLE("]},");
+  reply_id(ctx);
   return 0;
 }
 
@@ -1402,10 +1582,12 @@ method_getSignatureStatuses(struct json_values* values, fd_rpc_ctx_t * ctx) {
 static int
 method_getSlot(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void) values;
-  fd_rpc_global_ctx_t * glob = ctx->global;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}" CRLF,
-                       glob->last_slot_notify.slot_exec.slot, ctx->call_id);
+  struct fd_rpc_hot_result * hot = &ctx->worker->slot_hot;
+  if( hot->gen != ctx->notif_gen ) {
+    hot_fill( ctx, hot, ctx->last_slot.slot, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":",
+              ctx->last_slot.slot );
+  }
+  hot_reply( ctx, hot );
   return 0;
 }
 
@@ -1414,19 +1596,24 @@ method_getSlot(struct json_values* values, fd_rpc_ctx_t * ctx) {
 
 static int
 method_getSlotLeader(struct json_values* values, fd_rpc_ctx_t * ctx) {
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":");
+  fd_webserver_t * ws = &ctx->worker->ws;
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":");
   ulong slot = get_slot_from_commitment_level( values, ctx );
+  fd_pubkey_t leader;
+  fd_rwlock_read( &ctx->global->lock );
   fd_epoch_leaders_t const * lsched = fd_stake_ci_get_lsched_for_slot( ctx->global->stake_ci, slot );
   fd_pubkey_t const * slot_leader = fd_epoch_leaders_get( lsched, slot );
+  if( slot_leader ) leader = *slot_leader;
+  fd_rwlock_unread( &ctx->global->lock );
   if( slot_leader ) {
-    char str[50];
-    fd_base58_encode_32(slot_leader->uc, 0, str);
-    fd_web_reply_sprintf(ws, "\"%s\"", str);
+    EMIT_SIMPLE("\"");
+    fd_web_reply_encode_base58_32(ws, leader.uc);
+    EMIT_SIMPLE("\"");
   } else {
     EMIT_SIMPLE("null");
   }
-  fd_web_reply_sprintf(ws, ",\"id\":%s}" CRLF, ctx->call_id);
+  EMIT_SIMPLE(",");
+  reply_id(ctx);
   return 0;
 }
 
@@ -1438,7 +1625,7 @@ method_getSlotLeaders(struct json_values* values, fd_rpc_ctx_t * ctx) {
     (JSON_TOKEN_LBRACKET<<16) | 0,
     (JSON_TOKEN_INTEGER<<16)
   };
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   ulong startslot_sz = 0;
   const void* startslot = json_get_value(values, PATH_SLOT, 3, &startslot_sz);
   if (startslot == NULL) {
@@ -1461,22 +1648,35 @@ method_getSlotLeaders(struct json_values* values, fd_rpc_ctx_t * ctx) {
   if (limitn > 5000)
     limitn = 5000;
 
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":[");
-  fd_epoch_leaders_t const * lsched = fd_stake_ci_get_lsched_for_slot( ctx->global->stake_ci, startslotn );
-  if( lsched ) {
-    for ( ulong i = startslotn; i < startslotn + limitn; ++i ) {
-      if( i > startslotn ) EMIT_SIMPLE(",");
-      fd_pubkey_t const * slot_leader = fd_epoch_leaders_get( lsched, i );
-      if( slot_leader ) {
-        char str[50];
-        fd_base58_encode_32(slot_leader->uc, 0, str);
-        fd_web_reply_sprintf(ws, "\"%s\"", str);
+  FD_SCRATCH_SCOPE_BEGIN {
+    /* Copy the leaders out, a NULL leader is marked with an all zero key */
+    fd_pubkey_t * leaders = fd_scratch_alloc( alignof(fd_pubkey_t), limitn*sizeof(fd_pubkey_t) );
+    ulong cnt = 0;
+    fd_rwlock_read( &ctx->global->lock );
+    fd_epoch_leaders_t const * lsched = fd_stake_ci_get_lsched_for_slot( ctx->global->stake_ci, startslotn );
+    if( lsched ) {
+      for( ; cnt < limitn; ++cnt ) {
+        fd_pubkey_t const * slot_leader = fd_epoch_leaders_get( lsched, startslotn + cnt );
+        if( slot_leader ) leaders[cnt] = *slot_leader;
+        else              memset( &leaders[cnt], 0, sizeof(fd_pubkey_t) );
+      }
+    }
+    fd_rwlock_unread( &ctx->global->lock );
+
+    EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":[");
+    for( ulong i = 0; i < cnt; ++i ) {
+      if( i ) EMIT_SIMPLE(",");
+      if( leaders[i].ul[0] | leaders[i].ul[1] | leaders[i].ul[2] | leaders[i].ul[3] ) {
+        EMIT_SIMPLE("\"");
+        fd_web_reply_encode_base58_32(ws, leaders[i].uc);
+        EMIT_SIMPLE("\"");
       } else {
         EMIT_SIMPLE("null");
       }
     }
-  }
-  fd_web_reply_sprintf(ws, "],\"id\":%s}" CRLF, ctx->call_id);
+    EMIT_SIMPLE("],");
+    reply_id(ctx);
+  } FD_SCRATCH_SCOPE_END;
 
   return 0;
 }
@@ -1512,9 +1712,9 @@ method_getSupply(struct json_values* values, fd_rpc_ctx_t * ctx) {
       fd_method_error( ctx, -1, "slot bank %lu not found", slot );
       return 0;
     }
-    fd_webserver_t * ws = &ctx->global->ws;
+    fd_webserver_t * ws = &ctx->worker->ws;
     fd_web_reply_sprintf( ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"value\":{\"circulating\":%lu,\"nonCirculating\":%lu,\"nonCirculatingAccounts\":[],\"total\":%lu}},\"id\":%s}",
-                          ctx->global->last_slot_notify.slot_exec.slot, slot_bank->capitalization, 0UL, slot_bank->capitalization, ctx->call_id);
+                          ctx->last_slot.slot, slot_bank->capitalization, 0UL, slot_bank->capitalization, ctx->call_id);
   } FD_SCRATCH_SCOPE_END;
   return 0;
 }
@@ -1591,7 +1791,7 @@ method_getTransaction(struct json_values* values, fd_rpc_ctx_t * ctx) {
     (JSON_TOKEN_STRING<<16)
   };
 
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   ulong sig_sz = 0;
   const void* sig = json_get_value(values, PATH_SIG, 3, &sig_sz);
   if (sig == NULL) {
@@ -1656,7 +1856,7 @@ method_getTransaction(struct json_values* values, fd_rpc_ctx_t * ctx) {
   void const * meta = fd_wksp_laddr_fast( fd_blockstore_wksp( blockstore ), elem.meta_gaddr );
 
   fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"" FIREDANCER_VERSION "\",\"slot\":%lu},\"blockTime\":%ld,\"slot\":%lu,",
-                       ctx->global->last_slot_notify.slot_exec.slot, blk_ts/(long)1e9, elem.slot);
+                       ctx->last_slot.slot, blk_ts/(long)1e9, elem.slot);
 
   /* Emit meta, including the case for `meta:null` */
   const char * err = fd_txn_meta_to_json( ws, meta, elem.meta_sz );
@@ -1680,7 +1880,7 @@ static int
 method_getTransactionCount(struct json_values* values, fd_rpc_ctx_t * ctx) {
   FD_SCRATCH_SCOPE_BEGIN { /* read_epoch consumes a ton of scratch space! */
     (void)values;
-    fd_webserver_t * ws = &ctx->global->ws;
+    fd_webserver_t * ws = &ctx->worker->ws;
 
     ulong                 slot      = get_slot_from_commitment_level( values, ctx );
     fd_slot_bank_t *      slot_bank = read_slot_bank( ctx, slot );
@@ -1702,7 +1902,7 @@ method_getTransactionCount(struct json_values* values, fd_rpc_ctx_t * ctx) {
 static int
 method_getVersion(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void) values;
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   /* TODO Where does feature-set come from? */
   fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"feature-set\":666,\"solana-core\":\"" FIREDANCER_VERSION "\"},\"id\":%s}" CRLF,
                        ctx->call_id);
@@ -1737,7 +1937,7 @@ method_getVoteAccounts(struct json_values* values, fd_rpc_ctx_t * ctx) {
     fd_vote_accounts_pair_t_mapnode_t * root = accts->vote_accounts_root;
     fd_vote_accounts_pair_t_mapnode_t * pool = accts->vote_accounts_pool;
 
-    fd_webserver_t * ws = &ctx->global->ws;
+    fd_webserver_t * ws = &ctx->worker->ws;
     fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"current\":[");
 
     uint path[4] = {
@@ -1795,7 +1995,7 @@ method_getVoteAccounts(struct json_values* values, fd_rpc_ctx_t * ctx) {
 static int
 method_isBlockhashValid(struct json_values* values, fd_rpc_ctx_t * ctx) {
   fd_rpc_global_ctx_t * glob = ctx->global;
-  fd_webserver_t * ws = &glob->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
 
   // Path to argument
   static const uint PATH[3] = {
@@ -1817,14 +2017,16 @@ method_isBlockhashValid(struct json_values* values, fd_rpc_ctx_t * ctx) {
   }
 
   int res = 0;
+  fd_rwlock_read( &glob->lock );
   for( ulong i = 0; i < MAX_RECENT_BLOCKHASHES; ++i ) {
     if( fd_hash_eq( &glob->recent_blockhash[i], &h ) ) {
       res = 1;
       break;
     }
   }
+  fd_rwlock_unread( &glob->lock );
   fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"slot\":%lu},\"value\":%s},\"id\":%s}" CRLF,
-                       ctx->global->last_slot_notify.slot_exec.slot, (res ? "true" : "false"), ctx->call_id);
+                       ctx->last_slot.slot, (res ? "true" : "false"), ctx->call_id);
 
   return 0;
 }
@@ -1834,9 +2036,7 @@ static int
 method_minimumLedgerSlot(struct json_values* values, fd_rpc_ctx_t * ctx) {
   (void) values;
   fd_rpc_global_ctx_t * glob = ctx->global;
-  fd_webserver_t * ws = &ctx->global->ws;
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}" CRLF,
-                       glob->blockstore->smr, ctx->call_id); /* FIXME archival file */
+  reply_ulong(ctx, glob->blockstore->smr); /* FIXME archival file */
   return 0;
 }
 
@@ -1853,7 +2053,7 @@ method_requestAirdrop(struct json_values* values, fd_rpc_ctx_t * ctx) {
 // Implementation of the "sendTransaction" methods
 static int
 method_sendTransaction(struct json_values* values, fd_rpc_ctx_t * ctx) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   static const uint ENCPATH[4] = {
     (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_PARAMS,
     (JSON_TOKEN_LBRACKET<<16) | 1,
@@ -1923,9 +2123,10 @@ method_sendTransaction(struct json_values* values, fd_rpc_ctx_t * ctx) {
 
   fd_txn_t * txn = (fd_txn_t *)txn_out;
   fd_ed25519_sig_t const * sigs = (fd_ed25519_sig_t const *)(data + txn->signature_off);
-  char buf64[FD_BASE58_ENCODED_64_SZ];
-  fd_base58_encode_64((const uchar*)sigs, NULL, buf64);
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":\"%s\",\"id\":%s}" CRLF, buf64, ctx->call_id);
+  EMIT_SIMPLE("{\"jsonrpc\":\"2.0\",\"result\":\"");
+  fd_web_reply_encode_base58_64(ws, sigs);
+  EMIT_SIMPLE("\",");
+  reply_id(ctx);
 
   return 0;
 }
@@ -1940,285 +2141,294 @@ method_simulateTransaction(struct json_values* values, fd_rpc_ctx_t * ctx) {
   return 0;
 }
 
-// Top level method dispatch function
-void
-fd_webserver_method_generic(struct json_values* values, void * cb_arg) {
-  fd_rpc_ctx_t ctx = *( fd_rpc_ctx_t *)cb_arg;
-
-  snprintf(ctx.call_id, sizeof(ctx.call_id)-1, "null");
-
-  static const uint PATH[2] = {
-    (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_JSONRPC,
-    (JSON_TOKEN_STRING<<16)
-  };
-  ulong arg_sz = 0;
-  const void* arg = json_get_value(values, PATH, 2, &arg_sz);
-  if (arg == NULL) {
-    fd_method_error(&ctx, -1, "missing jsonrpc member");
-    return;
-  }
-  if (!MATCH_STRING(arg, arg_sz, "2.0")) {
-    fd_method_error(&ctx, -1, "jsonrpc value must be 2.0");
-    return;
-  }
-
-  static const uint PATH3[2] = {
-    (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_ID,
-    (JSON_TOKEN_INTEGER<<16)
-  };
-  arg_sz = 0;
-  arg = json_get_value(values, PATH3, 2, &arg_sz);
-  if (arg != NULL) {
-    snprintf(ctx.call_id, sizeof(ctx.call_id)-1, "%lu", *(ulong*)arg); /* TODO check signedness of arg */
-  } else {
-    static const uint PATH4[2] = {
-      (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_ID,
-      (JSON_TOKEN_STRING<<16)
-    };
-    arg_sz = 0;
-    arg = json_get_value(values, PATH4, 2, &arg_sz);
-    if (arg != NULL) {
-      snprintf(ctx.call_id, sizeof(ctx.call_id)-1, "\"%s\"", (const char *)arg);
-    } else {
-      fd_method_error(&ctx, -1, "missing id member");
-      return;
-    }
-  }
-
-  static const uint PATH2[2] = {
-    (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_METHOD,
-    (JSON_TOKEN_STRING<<16)
-  };
-  arg_sz = 0;
-  arg = json_get_value(values, PATH2, 2, &arg_sz);
-  if (arg == NULL) {
-    fd_method_error(&ctx, -1, "missing method member");
-    return;
-  }
-  long meth_id = fd_webserver_json_keyword((const char*)arg, arg_sz);
-
+static void
+method_dispatch(struct json_values* values, fd_rpc_ctx_t * ctx, long meth_id, const char * meth_name) {
   switch (meth_id) {
   case KEYW_RPCMETHOD_GETACCOUNTINFO:
-    if (!method_getAccountInfo(values, &ctx))
+    if (!method_getAccountInfo(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBALANCE:
-    if (!method_getBalance(values, &ctx))
+    if (!method_getBalance(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBLOCK:
-    if (!method_getBlock(values, &ctx))
+    if (!method_getBlock(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBLOCKCOMMITMENT:
-    if (!method_getBlockCommitment(values, &ctx))
+    if (!method_getBlockCommitment(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBLOCKHEIGHT:
-    if (!method_getBlockHeight(values, &ctx))
+    if (!method_getBlockHeight(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBLOCKPRODUCTION:
-    if (!method_getBlockProduction(values, &ctx))
+    if (!method_getBlockProduction(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBLOCKS:
-    if (!method_getBlocks(values, &ctx))
+    if (!method_getBlocks(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBLOCKSWITHLIMIT:
-    if (!method_getBlocksWithLimit(values, &ctx))
+    if (!method_getBlocksWithLimit(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETBLOCKTIME:
-    if (!method_getBlockTime(values, &ctx))
+    if (!method_getBlockTime(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETCLUSTERNODES:
-    if (!method_getClusterNodes(values, &ctx))
+    if (!method_getClusterNodes(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETEPOCHINFO:
-    if (!method_getEpochInfo(values, &ctx))
+    if (!method_getEpochInfo(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETEPOCHSCHEDULE:
-    if (!method_getEpochSchedule(values, &ctx))
+    if (!method_getEpochSchedule(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETFEEFORMESSAGE:
-    if (!method_getFeeForMessage(values, &ctx))
+    if (!method_getFeeForMessage(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETFIRSTAVAILABLEBLOCK:
-    if (!method_getFirstAvailableBlock(values, &ctx))
+    if (!method_getFirstAvailableBlock(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETGENESISHASH:
-    if (!method_getGenesisHash(values, &ctx))
+    if (!method_getGenesisHash(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETHEALTH:
-    if (!method_getHealth(values, &ctx))
+    if (!method_getHealth(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETHIGHESTSNAPSHOTSLOT:
-    if (!method_getHighestSnapshotSlot(values, &ctx))
+    if (!method_getHighestSnapshotSlot(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETIDENTITY:
-    if (!method_getIdentity(values, &ctx))
+    if (!method_getIdentity(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETINFLATIONGOVERNOR:
-    if (!method_getInflationGovernor(values, &ctx))
+    if (!method_getInflationGovernor(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETINFLATIONRATE:
-    if (!method_getInflationRate(values, &ctx))
+    if (!method_getInflationRate(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETINFLATIONREWARD:
-    if (!method_getInflationReward(values, &ctx))
+    if (!method_getInflationReward(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETLARGESTACCOUNTS:
-    if (!method_getLargestAccounts(values, &ctx))
+    if (!method_getLargestAccounts(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETLATESTBLOCKHASH:
-    if (!method_getLatestBlockhash(values, &ctx))
+    if (!method_getLatestBlockhash(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETLEADERSCHEDULE:
-    if (!method_getLeaderSchedule(values, &ctx))
+    if (!method_getLeaderSchedule(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETMAXRETRANSMITSLOT:
-    if (!method_getMaxRetransmitSlot(values, &ctx))
+    if (!method_getMaxRetransmitSlot(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETMAXSHREDINSERTSLOT:
-    if (!method_getMaxShredInsertSlot(values, &ctx))
+    if (!method_getMaxShredInsertSlot(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETMINIMUMBALANCEFORRENTEXEMPTION:
-    if (!method_getMinimumBalanceForRentExemption(values, &ctx))
+    if (!method_getMinimumBalanceForRentExemption(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETMULTIPLEACCOUNTS:
-    if (!method_getMultipleAccounts(values, &ctx))
+    if (!method_getMultipleAccounts(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETPROGRAMACCOUNTS:
-    if (!method_getProgramAccounts(values, &ctx))
+    if (!method_getProgramAccounts(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETRECENTPERFORMANCESAMPLES:
-    if (!method_getRecentPerformanceSamples(values, &ctx))
+    if (!method_getRecentPerformanceSamples(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETRECENTPRIORITIZATIONFEES:
-    if (!method_getRecentPrioritizationFees(values, &ctx))
+    if (!method_getRecentPrioritizationFees(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSIGNATURESFORADDRESS:
-    if (!method_getSignaturesForAddress(values, &ctx))
+    if (!method_getSignaturesForAddress(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSIGNATURESTATUSES:
-    if (!method_getSignatureStatuses(values, &ctx))
+    if (!method_getSignatureStatuses(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSLOT:
-    if (!method_getSlot(values, &ctx))
+    if (!method_getSlot(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSLOTLEADER:
-    if (!method_getSlotLeader(values, &ctx))
+    if (!method_getSlotLeader(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSLOTLEADERS:
-    if (!method_getSlotLeaders(values, &ctx))
+    if (!method_getSlotLeaders(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSTAKEACTIVATION:
-    if (!method_getStakeActivation(values, &ctx))
+    if (!method_getStakeActivation(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSTAKEMINIMUMDELEGATION:
-    if (!method_getStakeMinimumDelegation(values, &ctx))
+    if (!method_getStakeMinimumDelegation(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETSUPPLY:
-    if (!method_getSupply(values, &ctx))
+    if (!method_getSupply(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETTOKENACCOUNTBALANCE:
-    if (!method_getTokenAccountBalance(values, &ctx))
+    if (!method_getTokenAccountBalance(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETTOKENACCOUNTSBYDELEGATE:
-    if (!method_getTokenAccountsByDelegate(values, &ctx))
+    if (!method_getTokenAccountsByDelegate(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETTOKENACCOUNTSBYOWNER:
-    if (!method_getTokenAccountsByOwner(values, &ctx))
+    if (!method_getTokenAccountsByOwner(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETTOKENLARGESTACCOUNTS:
-    if (!method_getTokenLargestAccounts(values, &ctx))
+    if (!method_getTokenLargestAccounts(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETTOKENSUPPLY:
-    if (!method_getTokenSupply(values, &ctx))
+    if (!method_getTokenSupply(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETTRANSACTION:
-    if (!method_getTransaction(values, &ctx))
+    if (!method_getTransaction(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETTRANSACTIONCOUNT:
-    if (!method_getTransactionCount(values, &ctx))
+    if (!method_getTransactionCount(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETVERSION:
-    if (!method_getVersion(values, &ctx))
+    if (!method_getVersion(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_GETVOTEACCOUNTS:
-    if (!method_getVoteAccounts(values, &ctx))
+    if (!method_getVoteAccounts(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_ISBLOCKHASHVALID:
-    if (!method_isBlockhashValid(values, &ctx))
+    if (!method_isBlockhashValid(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_MINIMUMLEDGERSLOT:
-    if (!method_minimumLedgerSlot(values, &ctx))
+    if (!method_minimumLedgerSlot(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_REQUESTAIRDROP:
-    if (!method_requestAirdrop(values, &ctx))
+    if (!method_requestAirdrop(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_SENDTRANSACTION:
-    if (!method_sendTransaction(values, &ctx))
+    if (!method_sendTransaction(values, ctx))
       return;
     break;
   case KEYW_RPCMETHOD_SIMULATETRANSACTION:
-    if (!method_simulateTransaction(values, &ctx))
+    if (!method_simulateTransaction(values, ctx))
       return;
     break;
   default:
-    fd_method_error(&ctx, -1, "unknown or unimplemented method %s", (const char*)arg);
+    fd_method_error(ctx, -1, "unknown or unimplemented method %s", meth_name);
+    return;
+  }
+}
+
+// Top level method dispatch function
+void
+fd_webserver_method_generic(struct json_values* values, void * cb_arg) {
+  fd_rpc_ctx_t ctx = *( fd_rpc_ctx_t *)cb_arg;
+
+  fd_cstr_fini( fd_cstr_append_text( fd_cstr_init( ctx.call_id ), "null", 4UL ) );
+
+  static const uint PATH[2] = {
+    (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_JSONRPC,
+    (JSON_TOKEN_STRING<<16)
+  };
+  ulong arg_sz = 0;
+  const void* arg = json_get_value(values, PATH, 2, &arg_sz);
+  if (arg == NULL) {
+    fd_method_error(&ctx, -1, "missing jsonrpc member");
+    return;
+  }
+  if (!MATCH_STRING(arg, arg_sz, "2.0")) {
+    fd_method_error(&ctx, -1, "jsonrpc value must be 2.0");
+    return;
+  }
+
+  static const uint PATH3[2] = {
+    (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_ID,
+    (JSON_TOKEN_INTEGER<<16)
+  };
+  arg_sz = 0;
+  arg = json_get_value(values, PATH3, 2, &arg_sz);
+  if (arg != NULL) {
+    fd_cstr_fini( fd_cstr_append_ulong_as_text( fd_cstr_init( ctx.call_id ), '0', '\0', *(ulong*)arg, fd_ulong_base10_dig_cnt( *(ulong*)arg ) ) ); /* TODO check signedness of arg */
+  } else {
+    static const uint PATH4[2] = {
+      (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_ID,
+      (JSON_TOKEN_STRING<<16)
+    };
+    arg_sz = 0;
+    arg = json_get_value(values, PATH4, 2, &arg_sz);
+    if (arg != NULL) {
+      snprintf(ctx.call_id, sizeof(ctx.call_id)-1, "\"%s\"", (const char *)arg);
+    } else {
+      fd_method_error(&ctx, -1, "missing id member");
+      return;
+    }
+  }
+
+  static const uint PATH2[2] = {
+    (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_METHOD,
+    (JSON_TOKEN_STRING<<16)
+  };
+  arg_sz = 0;
+  arg = json_get_value(values, PATH2, 2, &arg_sz);
+  if (arg == NULL) {
+    fd_method_error(&ctx, -1, "missing method member");
     return;
   }
+  long meth_id = fd_webserver_json_keyword((const char*)arg, arg_sz);
+  fd_rwlock_read( &ctx.global->lock );
+  ctx.last_slot = ctx.global->last_slot_notify.slot_exec;
+  ctx.notif_gen = ctx.global->notif_gen;
+  ctx.acct_age  = ctx.global->acct_age;
+  fd_rwlock_unread( &ctx.global->lock );
+  method_dispatch(values, &ctx, meth_id, (const char*)arg);
 }
 
 static int
 ws_method_accountSubscribe(ulong conn_id, struct json_values * values, fd_rpc_ctx_t * ctx) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
 
   FD_SCRATCH_SCOPE_BEGIN {
     // Path to argument
@@ -2286,7 +2496,7 @@ ws_method_accountSubscribe(ulong conn_id, struct json_values * values, fd_rpc_ct
       }
     }
 
-    fd_rpc_global_ctx_t * subs = ctx->global;
+    fd_rpc_worker_t * subs = ctx->worker;
     if( subs->sub_cnt >= FD_WS_MAX_SUBS ) {
       fd_method_simple_error(ctx, -1, "too many subscriptions");
       return 0;
@@ -2295,7 +2505,7 @@ ws_method_accountSubscribe(ulong conn_id, struct json_values * values, fd_rpc_ct
     sub->conn_id = conn_id;
     sub->meth_id = KEYW_WS_METHOD_ACCOUNTSUBSCRIBE;
     strncpy(sub->call_id, ctx->call_id, sizeof(sub->call_id));
-    ulong subid = sub->subsc_id = ++(subs->last_subsc_id);
+    ulong subid = sub->subsc_id = FD_ATOMIC_ADD_AND_FETCH( &ctx->global->last_subsc_id, 1UL );
     sub->acct_subscribe.acct = acct;
     sub->acct_subscribe.enc = enc;
     sub->acct_subscribe.off = (off_ptr ? *(long*)off_ptr : FD_LONG_UNSET);
@@ -2311,7 +2521,7 @@ ws_method_accountSubscribe(ulong conn_id, struct json_values * values, fd_rpc_ct
 
 static int
 ws_method_accountSubscribe_update(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * msg, struct fd_ws_subscription * sub) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   fd_web_reply_new( ws );
 
   FD_SCRATCH_SCOPE_BEGIN {
@@ -2339,9 +2549,9 @@ ws_method_accountSubscribe_update(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * ms
 static int
 ws_method_slotSubscribe(ulong conn_id, struct json_values * values, fd_rpc_ctx_t * ctx) {
   (void)values;
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
 
-  fd_rpc_global_ctx_t * subs = ctx->global;
+  fd_rpc_worker_t * subs = ctx->worker;
   if( subs->sub_cnt >= FD_WS_MAX_SUBS ) {
     fd_method_simple_error(ctx, -1, "too many subscriptions");
     return 0;
@@ -2350,7 +2560,7 @@ ws_method_slotSubscribe(ulong conn_id, struct json_values * values, fd_rpc_ctx_t
   sub->conn_id = conn_id;
   sub->meth_id = KEYW_WS_METHOD_SLOTSUBSCRIBE;
   strncpy(sub->call_id, ctx->call_id, sizeof(sub->call_id));
-  ulong subid = sub->subsc_id = ++(subs->last_subsc_id);
+  ulong subid = sub->subsc_id = FD_ATOMIC_ADD_AND_FETCH( &ctx->global->last_subsc_id, 1UL );
 
   fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"result\":%lu,\"id\":%s}" CRLF,
                        subid, sub->call_id);
@@ -2360,7 +2570,7 @@ ws_method_slotSubscribe(ulong conn_id, struct json_values * values, fd_rpc_ctx_t
 
 static int
 ws_method_slotSubscribe_update(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * msg, struct fd_ws_subscription * sub) {
-  fd_webserver_t * ws = &ctx->global->ws;
+  fd_webserver_t * ws = &ctx->worker->ws;
   fd_web_reply_new( ws );
 
   char bank_hash[50];
@@ -2374,7 +2584,7 @@ ws_method_slotSubscribe_update(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * msg,
 int
 fd_webserver_ws_subscribe(struct json_values* values, ulong conn_id, void * cb_arg) {
   fd_rpc_ctx_t ctx = *( fd_rpc_ctx_t *)cb_arg;
-  fd_webserver_t * ws = &ctx.global->ws;
+  fd_webserver_t * ws = &ctx.worker->ws;
 
   static const uint PATH[2] = {
     (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_JSONRPC,
@@ -2398,7 +2608,7 @@ fd_webserver_ws_subscribe(struct json_values* values, ulong conn_id, void * cb_a
   arg_sz = 0;
   arg = json_get_value(values, PATH3, 2, &arg_sz);
   if (arg != NULL) {
-    snprintf(ctx.call_id, sizeof(ctx.call_id)-1, "%lu", *(ulong*)arg); /* TODO: check signedness of arg */
+    fd_cstr_fini( fd_cstr_append_ulong_as_text( fd_cstr_init( ctx.call_id ), '0', '\0', *(ulong*)arg, fd_ulong_base10_dig_cnt( *(ulong*)arg ) ) ); /* TODO: check signedness of arg */
   } else {
     static const uint PATH4[2] = {
       (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_ID,
@@ -2445,18 +2655,46 @@ fd_webserver_ws_subscribe(struct json_values* values, ulong conn_id, void * cb_a
   return 0;
 }
 
+static fd_rpc_ctx_t *
+fd_rpc_create_worker(fd_rpcserver_args_t * args, fd_rpc_global_ctx_t * gctx) {
+  fd_valloc_t valloc = args->valloc;
+
+  fd_rpc_ctx_t * ctx         = (fd_rpc_ctx_t *)fd_valloc_malloc(valloc, alignof(fd_rpc_ctx_t), sizeof(fd_rpc_ctx_t));
+  fd_rpc_worker_t * worker   = (fd_rpc_worker_t *)fd_valloc_malloc(valloc, alignof(fd_rpc_worker_t), sizeof(fd_rpc_worker_t));
+  fd_memset(ctx, 0, sizeof(fd_rpc_ctx_t));
+  fd_memset(worker, 0, sizeof(fd_rpc_worker_t));
+
+  ctx->global = gctx;
+  ctx->worker = worker;
+
+  /* Workers listen on the same port and the kernel spreads incoming
+     connections between them */
+  fd_http_server_params_t params = args->params;
+  params.reuse_port = ( gctx->worker_cnt > 1UL );
+  if (fd_webserver_start(args->port, params, valloc, &worker->ws, ctx))
+    FD_LOG_ERR(("fd_webserver_start failed"));
+
+  return ctx;
+}
+
 void
 fd_rpc_create_ctx(fd_rpcserver_args_t * args, fd_rpc_ctx_t ** ctx_p) {
   fd_valloc_t valloc = args->valloc;
 
-  fd_rpc_ctx_t * ctx         = (fd_rpc_ctx_t *)fd_valloc_malloc(valloc, alignof(fd_rpc_ctx_t), sizeof(fd_rpc_ctx_t));
+  ulong worker_cnt = fd_ulong_max( args->worker_cnt, 1UL );
+  if( worker_cnt > FD_RPC_WORKER_MAX ) {
+    FD_LOG_ERR(( "too many rpc workers (%lu), at most %lu are supported", worker_cnt, FD_RPC_WORKER_MAX ));
+  }
+
   fd_rpc_global_ctx_t * gctx = (fd_rpc_global_ctx_t *)fd_valloc_malloc(valloc, alignof(fd_rpc_global_ctx_t), sizeof(fd_rpc_global_ctx_t));
-  fd_memset(ctx, 0, sizeof(fd_rpc_ctx_t));
   fd_memset(gctx, 0, sizeof(fd_rpc_global_ctx_t));
 
-  ctx->global = gctx;
   gctx->valloc = valloc;
   gctx->stake_ci = args->stake_ci;
+  gctx->worker_cnt = worker_cnt;
+  gctx->notif_gen = 1UL;
+  gctx->notif_ring = (fd_replay_notif_msg_t *)fd_valloc_malloc(valloc, alignof(fd_replay_notif_msg_t), FD_RPC_NOTIF_DEPTH*sizeof(fd_replay_notif_msg_t));
+  FD_TEST( gctx->notif_ring );
 
   if( !args->offline ) {
     gctx->tpu_socket = socket(AF_INET, SOCK_DGRAM, 0);
@@ -2484,11 +2722,22 @@ fd_rpc_create_ctx(fd_rpcserver_args_t * args, fd_rpc_ctx_t ** ctx_p) {
   gctx->perf_samples = fd_perf_sample_deque_join( fd_perf_sample_deque_new( mem ) );
   FD_TEST( gctx->perf_samples );
 
-  FD_LOG_NOTICE(( "starting web server on port %u", (uint)args->port ));
-  if (fd_webserver_start(args->port, args->params, valloc, &gctx->ws, ctx))
-    FD_LOG_ERR(("fd_webserver_start failed"));
+  FD_LOG_NOTICE(( "starting web server on port %u with %lu workers", (uint)args->port, worker_cnt ));
+  for( ulong i = 0; i < worker_cnt; ++i ) {
+    gctx->workers[i] = fd_rpc_create_worker( args, gctx );
+  }
+
+  *ctx_p = gctx->workers[0];
+}
 
-  *ctx_p = ctx;
+ulong
+fd_rpc_worker_cnt(fd_rpc_ctx_t * ctx) {
+  return ctx->global->worker_cnt;
+}
+
+fd_rpc_ctx_t *
+fd_rpc_worker_ctx(fd_rpc_ctx_t * ctx, ulong idx) {
+  return ctx->global->workers[idx];
 }
 
 void
@@ -2510,36 +2759,98 @@ fd_rpc_stop_service(fd_rpc_ctx_t * ctx) {
   fd_rpc_global_ctx_t * glob = ctx->global;
   fd_valloc_t valloc = glob->valloc;
   FD_LOG_NOTICE(( "stopping web server" ));
-  if (fd_webserver_stop(valloc, &glob->ws))
-    FD_LOG_ERR(("fd_webserver_stop failed"));
-  if( ctx->global->epoch_bank != NULL ) {
-    fd_bincode_destroy_ctx_t binctx;
-    binctx.valloc = valloc;
-    fd_epoch_bank_destroy( glob->epoch_bank, &binctx );
-    fd_valloc_free( valloc, glob->epoch_bank );
-    glob->epoch_bank = NULL;
+  for( ulong i = 0; i < glob->worker_cnt; ++i ) {
+    fd_rpc_ctx_t * wctx = glob->workers[i];
+    fd_rpc_worker_t * worker = wctx->worker;
+    if (fd_webserver_stop(valloc, &worker->ws))
+      FD_LOG_ERR(("fd_webserver_stop failed"));
+    if( worker->epoch_bank != NULL ) {
+      fd_bincode_destroy_ctx_t binctx;
+      binctx.valloc = valloc;
+      fd_epoch_bank_destroy( worker->epoch_bank, &binctx );
+      fd_valloc_free( valloc, worker->epoch_bank );
+      worker->epoch_bank = NULL;
+    }
+    fd_valloc_free(valloc, worker);
+    fd_valloc_free(valloc, wctx);
   }
   if ( FD_LIKELY( glob->perf_samples ) ) {
     fd_valloc_free( valloc, fd_perf_sample_deque_delete( fd_perf_sample_deque_leave( glob->perf_samples ) ) );
   }
-  fd_valloc_free(valloc, ctx->global);
-  fd_valloc_free(valloc, ctx);
+  fd_valloc_free(valloc, glob->notif_ring);
+  fd_valloc_free(valloc, glob);
+}
+
+static void
+fd_rpc_notif_send(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * msg) {
+  fd_rpc_worker_t * subs = ctx->worker;
+
+  if( msg->type == FD_REPLAY_SLOT_TYPE ) {
+    for( ulong j = 0; j < subs->sub_cnt; ++j ) {
+      struct fd_ws_subscription * sub = &subs->sub_list[ j ];
+      if( sub->meth_id == KEYW_WS_METHOD_SLOTSUBSCRIBE ) {
+        if( ws_method_slotSubscribe_update( ctx, msg, sub ) )
+          fd_web_ws_send( &subs->ws, sub->conn_id );
+      }
+    }
+
+  } else if( msg->type == FD_REPLAY_ACCTS_TYPE ) {
+    for( uint i = 0; i < msg->accts.accts_cnt; ++i ) {
+      if( !( msg->accts.accts[i].flags & FD_REPLAY_NOTIF_ACCT_WRITTEN ) ) continue;
+      for( ulong j = 0; j < subs->sub_cnt; ++j ) {
+        struct fd_ws_subscription * sub = &subs->sub_list[ j ];
+        if( sub->meth_id == KEYW_WS_METHOD_ACCOUNTSUBSCRIBE &&
+            !memcmp( msg->accts.accts[i].id, &sub->acct_subscribe.acct, sizeof(fd_pubkey_t) ) ) {
+          if( ws_method_accountSubscribe_update( ctx, msg, sub ) )
+            fd_web_ws_send( &subs->ws, sub->conn_id );
+        }
+      }
+    }
+  }
+}
+
+/* fd_rpc_notif_drain sends the subscription updates for the replay
+   notifications published since the worker last looked */
+
+static void
+fd_rpc_notif_drain(fd_rpc_ctx_t * ctx) {
+  fd_rpc_global_ctx_t * glob = ctx->global;
+  fd_rpc_worker_t * worker = ctx->worker;
+
+  if( !worker->sub_cnt ) {
+    worker->notif_seq = FD_VOLATILE_CONST( glob->notif_seq );
+    return;
+  }
+
+  fd_rwlock_read( &glob->lock );
+  ulong pub_seq = glob->notif_seq;
+  if( FD_UNLIKELY( pub_seq - worker->notif_seq > FD_RPC_NOTIF_DEPTH ) ) {
+    FD_LOG_WARNING(( "rpc worker fell behind, skipping %lu replay notifications", pub_seq - worker->notif_seq - FD_RPC_NOTIF_DEPTH ));
+    worker->notif_seq = pub_seq - FD_RPC_NOTIF_DEPTH;
+  }
+  for( ; worker->notif_seq != pub_seq; worker->notif_seq++ ) {
+    fd_rpc_notif_send( ctx, &glob->notif_ring[ worker->notif_seq & (FD_RPC_NOTIF_DEPTH-1UL) ] );
+  }
+  fd_rwlock_unread( &glob->lock );
 }
 
 int
 fd_rpc_ws_poll(fd_rpc_ctx_t * ctx) {
-  return fd_webserver_poll(&ctx->global->ws);
+  if( FD_UNLIKELY( ctx->worker->notif_seq != FD_VOLATILE_CONST( ctx->global->notif_seq ) ) ) {
+    fd_rpc_notif_drain( ctx );
+  }
+  return fd_webserver_poll(&ctx->worker->ws);
 }
 
 int
 fd_rpc_ws_fd(fd_rpc_ctx_t * ctx) {
-  return fd_webserver_fd(&ctx->global->ws);
+  return fd_webserver_fd(&ctx->worker->ws);
 }
 
 void
 fd_webserver_ws_closed(ulong conn_id, void * cb_arg) {
   fd_rpc_ctx_t * ctx = ( fd_rpc_ctx_t *)cb_arg;
-  fd_rpc_global_ctx_t * subs = ctx->global;
+  fd_rpc_worker_t * subs = ctx->worker;
   for( ulong i = 0; i < subs->sub_cnt; ++i ) {
     if( subs->sub_list[i].conn_id == conn_id ) {
       fd_memcpy( &subs->sub_list[i], &subs->sub_list[--(subs->sub_cnt)], sizeof(struct fd_ws_subscription) );
@@ -2580,6 +2891,8 @@ void
 fd_rpc_replay_after_frag(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * msg) {
   fd_rpc_global_ctx_t * subs = ctx->global;
 
+  fd_rwlock_write( &subs->lock );
+
   if( msg->type == FD_REPLAY_SLOT_TYPE ) {
     long ts = fd_log_wallclock() / (long)1e9;
     if( FD_UNLIKELY( ts - subs->perf_sample_ts >= 60 ) ) {
@@ -2616,13 +2929,8 @@ fd_rpc_replay_after_frag(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * msg) {
     fd_hash_t * h = &subs->recent_blockhash[msg->slot_exec.slot % MAX_RECENT_BLOCKHASHES];
     fd_hash_copy( h, &msg->slot_exec.block_hash );
 
-    for( ulong j = 0; j < subs->sub_cnt; ++j ) {
-      struct fd_ws_subscription * sub = &subs->sub_list[ j ];
-      if( sub->meth_id == KEYW_WS_METHOD_SLOTSUBSCRIBE ) {
-        if( ws_method_slotSubscribe_update( ctx, msg, sub ) )
-          fd_web_ws_send( &subs->ws, sub->conn_id );
-      }
-    }
+    /* Invalidates the hot response caches */
+    subs->notif_gen++;
 
   } else if( msg->type == FD_REPLAY_ACCTS_TYPE ) {
     /* TODO: replace with a hash table lookup? */
@@ -2638,29 +2946,27 @@ fd_rpc_replay_after_frag(fd_rpc_ctx_t * ctx, fd_replay_notif_msg_t * msg) {
       ele->age = subs->acct_age++;
       fd_memcpy( ele->sig, msg->accts.sig, sizeof( ele->sig ) );
       fd_rpc_acct_map_ele_insert( subs->acct_map, ele, subs->acct_pool );
-
-      if( ( msg->accts.accts[i].flags & FD_REPLAY_NOTIF_ACCT_WRITTEN ) ) {
-        for( ulong j = 0; j < subs->sub_cnt; ++j ) {
-          struct fd_ws_subscription * sub = &subs->sub_list[ j ];
-          if( sub->meth_id == KEYW_WS_METHOD_ACCOUNTSUBSCRIBE &&
-              !memcmp( &id, &sub->acct_subscribe.acct, sizeof(fd_pubkey_t) ) ) {
-            if( ws_method_accountSubscribe_update( ctx, msg, sub ) )
-              fd_web_ws_send( &subs->ws, sub->conn_id );
-          }
-        }
-      }
     }
   }
+
+  /* Publish to the workers for subscription updates */
+  fd_memcpy( &subs->notif_ring[ subs->notif_seq & (FD_RPC_NOTIF_DEPTH-1UL) ], msg, sizeof(fd_replay_notif_msg_t) );
+  FD_VOLATILE( subs->notif_seq ) = subs->notif_seq + 1UL;
+
+  fd_rwlock_unwrite( &subs->lock );
 }
 
 void
 fd_rpc_stake_during_frag( fd_rpc_ctx_t * ctx, fd_stake_ci_t * state, void const * msg, int sz ) {
-  (void)ctx; (void)sz;
+  (void)sz;
+  fd_rwlock_write( &ctx->global->lock );
   fd_stake_ci_stake_msg_init( state, msg );
+  fd_rwlock_unwrite( &ctx->global->lock );
 }
 
 void
 fd_rpc_stake_after_frag(fd_rpc_ctx_t * ctx, fd_stake_ci_t * state) {
-  (void)ctx;
+  fd_rwlock_write( &ctx->global->lock );
   fd_stake_ci_stake_msg_fini( state );
+  fd_rwlock_unwrite( &ctx->global->lock );
 }
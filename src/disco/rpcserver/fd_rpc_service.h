@@ -25,11 +25,25 @@ struct fd_rpcserver_args {
   ushort               port;
   fd_http_server_params_t params;
   struct sockaddr_in   tpu_addr;
+  ulong                worker_cnt; /* Number of web server workers, 0 means 1 */
 };
 typedef struct fd_rpcserver_args fd_rpcserver_args_t;
 
 void fd_rpc_create_ctx(fd_rpcserver_args_t * args, fd_rpc_ctx_t ** ctx);
 
+/* The service runs args->worker_cnt web server workers which listen on
+   the same port.  fd_rpc_create_ctx returns the context of worker 0,
+   and fd_rpc_worker_ctx returns the context of worker idx, in
+   [0,fd_rpc_worker_cnt).  Each worker must be polled with
+   fd_rpc_ws_poll by a single thread which has its own scratch attached,
+   and different workers can be polled concurrently.  Replay and stake
+   notifications must all be delivered by one thread, with any worker
+   context. */
+
+ulong fd_rpc_worker_cnt(fd_rpc_ctx_t * ctx);
+
+fd_rpc_ctx_t * fd_rpc_worker_ctx(fd_rpc_ctx_t * ctx, ulong idx);
+
 void fd_rpc_start_service(fd_rpcserver_args_t * args, fd_rpc_ctx_t * ctx);
 
 void fd_rpc_stop_service(fd_rpc_ctx_t * ctx);
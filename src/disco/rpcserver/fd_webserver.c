@@ -1,5 +1,5 @@
 #include "../../util/fd_util.h"
-#include "../../ballet/base64/fd_base64.h"
+#include "../../ballet/base58/fd_base58.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -12,6 +12,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include "fd_methods.h"
+#include "json_sax.h"
 #include "fd_webserver.h"
 #include "../../ballet/http/fd_http_server_private.h"
 
@@ -36,11 +37,11 @@ fd_web_reply_new( fd_webserver_t * ws ) {
   ws->status_code = 200; // OK
 }
 
-// Parse the top level json request object
+// Parse the top level json request object. A batch request is parsed
+// and dispatched one element at a time.
 static void
-json_parse_root(fd_webserver_t * ws, json_lex_state_t* lex) {
-  struct json_path path;
-  if (json_lex_next_token(lex) == JSON_TOKEN_LBRACKET) {
+json_parse_root(fd_webserver_t * ws, json_sax_t* sax) {
+  if (json_sax_batch_begin(sax)) {
     /* We have an array of requests */
     fd_web_reply_append(ws, "[", 1);
     while(1) {
@@ -49,21 +50,18 @@ json_parse_root(fd_webserver_t * ws, json_lex_state_t* lex) {
 
       struct json_values values;
       json_values_new(&values);
-      path.len = 0;
-      if (json_values_parse(lex, &values, &path)) {
+      if (json_sax_parse(sax, &values)) {
         fd_webserver_method_generic(&values, ws->cb_arg);
       } else {
-        ulong sz;
-        const char* text = json_lex_get_text(lex, &sz);
         char text2[4096];
-        snprintf( text2, sizeof(text2), "Parse error: %s", text );
+        snprintf( text2, sizeof(text2), "Parse error: %s", sax->err );
         fd_web_reply_error( ws, -1, text2, "null" );
         json_values_delete(&values);
         break;
       }
       json_values_delete(&values);
 
-      long tok = json_lex_next_token(lex);
+      long tok = json_sax_batch_next(sax);
       if( tok == JSON_TOKEN_COMMA ) {
         fd_web_reply_append(ws, ",", 1);
       } else if( tok == JSON_TOKEN_RBRACKET ) {
@@ -79,20 +77,13 @@ json_parse_root(fd_webserver_t * ws, json_lex_state_t* lex) {
     fd_web_reply_append(ws, "]", 1);
 
   } else {
-    /* Go back to the first token */
-    lex->pos = 0;
-    lex->last_tok = JSON_TOKEN_ERROR;
-
     struct json_values values;
     json_values_new(&values);
-    path.len = 0;
-    if (json_values_parse(lex, &values, &path)) {
+    if (json_sax_parse(sax, &values)) {
       fd_webserver_method_generic(&values, ws->cb_arg);
     } else {
-      ulong sz;
-      const char* text = json_lex_get_text(lex, &sz);
       char text2[4096];
-      snprintf( text2, sizeof(text2), "Parse error: %s", text );
+      snprintf( text2, sizeof(text2), "Parse error: %s", sax->err );
       fd_web_reply_error( ws, -1, text2, "null" );
     }
     json_values_delete(&values);
@@ -103,9 +94,14 @@ void
 fd_web_reply_error( fd_webserver_t * ws, int errcode, const char * text, const char * call_id ) {
   ws->quick_size = 0;
   fd_http_server_stage_trunc(ws->server, ws->prev_reply_len);
-  fd_web_reply_sprintf(ws, "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":%d,\"message\":", errcode);
+  static const char PREFIX[] = "{\"jsonrpc\":\"2.0\",\"error\":{\"code\":";
+  fd_web_reply_append(ws, PREFIX, sizeof(PREFIX)-1);
+  fd_web_reply_append_long(ws, errcode);
+  fd_web_reply_append(ws, ",\"message\":", 11);
   fd_web_reply_encode_json_string(ws, text);
-  fd_web_reply_sprintf(ws, "},\"id\":%s}", call_id );
+  fd_web_reply_append(ws, "},\"id\":", 7);
+  fd_web_reply_append(ws, call_id, strlen(call_id));
+  fd_web_reply_append(ws, "}", 1);
 }
 
 static void
@@ -182,10 +178,9 @@ request( fd_http_server_request_t const * request ) {
       fflush(stdout);
 #endif
       FD_SCRATCH_SCOPE_BEGIN {
-        json_lex_state_t lex;
-        json_lex_state_new(&lex, (const char*)request->post.body, request->post.body_len);
-        json_parse_root(ws, &lex);
-        json_lex_state_delete(&lex);
+        json_sax_t sax;
+        json_sax_new(&sax, (const char*)request->post.body, request->post.body_len);
+        json_parse_root(ws, &sax);
         fd_web_reply_flush( ws );
       } FD_SCRATCH_SCOPE_END;
     }
@@ -257,25 +252,20 @@ ws_message( ulong conn_id, uchar const * data, ulong data_len, void * ctx ) {
   fd_webserver_t * ws = (fd_webserver_t *)ctx;
   fd_web_reply_new( ws );
 
-  json_lex_state_t lex;
-  json_lex_state_new(&lex, (const char*)data, data_len);
+  json_sax_t sax;
+  json_sax_new(&sax, (const char*)data, data_len);
   struct json_values values;
   json_values_new(&values);
-  struct json_path path;
-  path.len = 0;
-  int ret = json_values_parse(&lex, &values, &path);
+  int ret = json_sax_parse(&sax, &values);
   if (ret) {
     // json_values_printout(&values);
     ret = fd_webserver_ws_subscribe(&values, conn_id, ws->cb_arg);
   } else {
-    ulong sz;
-    const char* text = json_lex_get_text(&lex, &sz);
     char text2[4096];
-    snprintf( text2, sizeof(text2), "Parse error: %s", text );
+    snprintf( text2, sizeof(text2), "Parse error: %s", sax.err );
     fd_web_reply_error( ws, -1, text2, "null" );
   }
   json_values_delete(&values);
-  json_lex_state_delete(&lex);
   fd_web_ws_send( ws, conn_id );
 }
 
@@ -402,44 +392,38 @@ int
 fd_web_reply_encode_base64( fd_webserver_t * ws,
                             const void *     data,
                             ulong            data_sz ) {
-  for (ulong i = 0; i < data_sz; ) {
+  const uchar * in = (const uchar *)data;
+  while( data_sz ) {
     if( FD_UNLIKELY( ws->quick_size + 4U > FD_WEBSERVER_QUICK_MAX ) ) {
       fd_web_reply_flush( ws );
     }
     char * out_data = ws->quick_buf + ws->quick_size;
-    switch (data_sz - i) {
-    default: { /* 3 and above */
-      uint octet_a = ((uchar*)data)[i++];
-      uint octet_b = ((uchar*)data)[i++];
-      uint octet_c = ((uchar*)data)[i++];
-      uint triple = (octet_a << 0x10) + (octet_b << 0x08) + octet_c;
-      out_data[0] = base64_encoding_table[(triple >> 3 * 6) & 0x3F];
-      out_data[1] = base64_encoding_table[(triple >> 2 * 6) & 0x3F];
-      out_data[2] = base64_encoding_table[(triple >> 1 * 6) & 0x3F];
-      out_data[3] = base64_encoding_table[(triple >> 0 * 6) & 0x3F];
-      break;
-    }
-    case 2: {
-      uint octet_a = ((uchar*)data)[i++];
-      uint octet_b = ((uchar*)data)[i++];
-      uint triple = (octet_a << 0x10) + (octet_b << 0x08);
+
+    if( data_sz < 3U ) { /* Last group, with padding */
+      uint octet_b = ( data_sz == 2U ? in[1] : 0U );
+      uint triple = ((uint)in[0] << 0x10) + (octet_b << 0x08);
       out_data[0] = base64_encoding_table[(triple >> 3 * 6) & 0x3F];
       out_data[1] = base64_encoding_table[(triple >> 2 * 6) & 0x3F];
-      out_data[2] = base64_encoding_table[(triple >> 1 * 6) & 0x3F];
+      out_data[2] = ( data_sz == 2U ? base64_encoding_table[(triple >> 1 * 6) & 0x3F] : '=' );
       out_data[3] = '=';
+      ws->quick_size += 4U;
       break;
     }
-    case 1: {
-      uint octet_a = ((uchar*)data)[i++];
-      uint triple = (octet_a << 0x10);
+
+    /* Encode as many whole groups as fit in the buffer without checking
+       for room on every group */
+    ulong grp_cnt = fd_ulong_min( data_sz / 3U, ( FD_WEBSERVER_QUICK_MAX - ws->quick_size ) / 4U );
+    for( ulong i = 0; i < grp_cnt; i++ ) {
+      uint triple = ((uint)in[0] << 0x10) + ((uint)in[1] << 0x08) + (uint)in[2];
       out_data[0] = base64_encoding_table[(triple >> 3 * 6) & 0x3F];
       out_data[1] = base64_encoding_table[(triple >> 2 * 6) & 0x3F];
-      out_data[2] = '=';
-      out_data[3] = '=';
-      break;
-    }
+      out_data[2] = base64_encoding_table[(triple >> 1 * 6) & 0x3F];
+      out_data[3] = base64_encoding_table[(triple >> 0 * 6) & 0x3F];
+      in += 3;
+      out_data += 4;
     }
-    ws->quick_size += 4U;
+    ws->quick_size += grp_cnt * 4U;
+    data_sz -= grp_cnt * 3U;
   }
   return 0;
 }
@@ -487,6 +471,51 @@ fd_web_reply_sprintf( fd_webserver_t * ws, const char* format, ... ) {
   return 0;
 }
 
+int
+fd_web_reply_append_ulong( fd_webserver_t * ws, ulong val ) {
+  if( FD_UNLIKELY( ws->quick_size + 20U > FD_WEBSERVER_QUICK_MAX ) ) {
+    fd_web_reply_flush( ws );
+  }
+  ulong n = fd_ulong_base10_dig_cnt( val );
+  fd_cstr_append_ulong_as_text( ws->quick_buf + ws->quick_size, '0', '\0', val, n );
+  ws->quick_size += n;
+  return 0;
+}
+
+int
+fd_web_reply_append_long( fd_webserver_t * ws, long val ) {
+  if( FD_UNLIKELY( ws->quick_size + 20U > FD_WEBSERVER_QUICK_MAX ) ) {
+    fd_web_reply_flush( ws );
+  }
+  ulong abs = ( val < 0L ? -(ulong)val : (ulong)val );
+  ulong n   = fd_ulong_base10_dig_cnt( abs ) + (ulong)( val < 0L );
+  fd_cstr_append_ulong_as_text( ws->quick_buf + ws->quick_size, ' ', ( val < 0L ? '-' : '\0' ), abs, n );
+  ws->quick_size += n;
+  return 0;
+}
+
+int
+fd_web_reply_encode_base58_32( fd_webserver_t * ws, const void * data ) {
+  if( FD_UNLIKELY( ws->quick_size + FD_BASE58_ENCODED_32_SZ > FD_WEBSERVER_QUICK_MAX ) ) {
+    fd_web_reply_flush( ws );
+  }
+  ulong len;
+  fd_base58_encode_32( (const uchar *)data, &len, ws->quick_buf + ws->quick_size );
+  ws->quick_size += len;
+  return 0;
+}
+
+int
+fd_web_reply_encode_base58_64( fd_webserver_t * ws, const void * data ) {
+  if( FD_UNLIKELY( ws->quick_size + FD_BASE58_ENCODED_64_SZ > FD_WEBSERVER_QUICK_MAX ) ) {
+    fd_web_reply_flush( ws );
+  }
+  ulong len;
+  fd_base58_encode_64( (const uchar *)data, &len, ws->quick_buf + ws->quick_size );
+  ws->quick_size += len;
+  return 0;
+}
+
 int
 fd_web_reply_encode_json_string( fd_webserver_t * ws, const char * str ) {
   char buf[512];
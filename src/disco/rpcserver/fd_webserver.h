@@ -62,6 +62,19 @@ int fd_web_reply_encode_hex( fd_webserver_t * ws,
 int fd_web_reply_sprintf( fd_webserver_t * ws, const char* format, ... )
   __attribute__ ((format (printf, 2, 3)));
 
+/* Typed reply writers.  These append a single value without any format
+   string parsing, which is most of the cost of a small reply.  The
+   base58 writers are for fixed size values (pubkeys, hashes and
+   signatures). */
+
+int fd_web_reply_append_ulong( fd_webserver_t * ws, ulong val );
+
+int fd_web_reply_append_long( fd_webserver_t * ws, long val );
+
+int fd_web_reply_encode_base58_32( fd_webserver_t * ws, const void * data );
+
+int fd_web_reply_encode_base58_64( fd_webserver_t * ws, const void * data );
+
 int fd_web_reply_encode_json_string( fd_webserver_t * ws, const char* str );
 
 #endif /* HEADER_fd_src_tango_webserver_fd_webserver_h */
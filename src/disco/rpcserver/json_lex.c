@@ -79,7 +79,7 @@ static long json_lex_parse_number(struct json_lex_state* state, const char* star
 
 // Validate a segment of UTF-8 encoded test. If an error is found, a
 // pointer to it is returned. A NULL is returned if there is no error.
-static const char* json_lex_validate_encoding(const char* t, const char* t_end) {
+const char* json_lex_validate_encoding(const char* t, const char* t_end) {
   /****
 Code Points		First Byte	Second Byte	Third Byte	Fourth Byte
 U+0020..U+007F		20..7F
@@ -61,6 +61,11 @@ long json_lex_as_int(json_lex_state_t* lex);
 // Convert the string to a float
 double json_lex_as_float(json_lex_state_t* lex);
 
+// Validate a segment of UTF-8 encoded string text. If an error is
+// found, a pointer to it is returned. A NULL is returned if there is
+// no error.
+const char* json_lex_validate_encoding(const char* t, const char* t_end);
+
 // Replaces the string with the result of a formatted printf.
 void json_lex_sprintf(json_lex_state_t* lex, const char* format, ...)
   __attribute__ ((format (printf, 2, 3)));
@@ -0,0 +1,510 @@
+#include "json_sax.h"
+#include "keywords.h"
+#include <stdio.h>
+#include <stdlib.h>
+#if FD_HAS_AVX
+#include "../../util/simd/fd_avx.h"
+#endif
+
+// Numbers longer than this are rejected, like json_lex does with its
+// initial buffer
+#define JSON_SAX_NUMBER_MAX 512UL
+
+// Report a syntax error
+#define SAX_ERROR(...)                                                  \
+  do {                                                                  \
+    snprintf(sax->err, sizeof(sax->err), __VA_ARGS__);                  \
+    return 0;                                                           \
+  } while (0)
+
+void json_sax_new(json_sax_t* sax, const char* json, ulong json_sz) {
+  sax->json = json;
+  sax->json_sz = json_sz;
+  sax->pos = 0;
+  sax->last_tok = JSON_TOKEN_ERROR;
+  sax->err[0] = '\0';
+}
+
+// Make room for sz more bytes after the first used bytes of the
+// uncommitted space at the end of the values buffer. The room
+// includes a null terminator and a word of slack for the keyword
+// matcher, which reads whole words. The start of the uncommitted
+// space is returned.
+static char* json_sax_reserve(struct json_values* values, ulong used, ulong sz) {
+  ulong need = values->buf_sz + used + sz + 1UL + sizeof(ulong);
+  if (FD_UNLIKELY(need > values->buf_alloc)) {
+    // Grow the allocation, just like json_add_value
+    do {
+      values->buf_alloc <<= 1;
+    } while (need > values->buf_alloc);
+    char* newbuf = (char*)fd_scratch_alloc(1, values->buf_alloc);
+    fd_memcpy(newbuf, values->buf, values->buf_sz + used);
+    values->buf = newbuf;
+  }
+  return values->buf + values->buf_sz;
+}
+
+// Add the data_sz bytes of uncommitted space as a new value, the same
+// way json_add_value does
+static void json_sax_commit(struct json_values* values, struct json_path* path, ulong data_sz) {
+  if (values->num_values == JSON_MAX_PATHS) {
+    // Ignore when we have too many values
+    return;
+  }
+  uint i = values->num_values++;
+  values->values[i].path = *path;
+  values->values[i].data_offset = values->buf_sz;
+  values->values[i].data_sz = data_sz;
+  values->buf[values->buf_sz + data_sz] = '\0';
+  values->buf_sz = ((values->buf_sz + data_sz + 1UL + 7UL) & ~7UL); // 8-byte align
+}
+
+// Parse a numeric constant. See json_lex_parse_number.
+static long json_sax_number(json_sax_t* sax, struct json_values* values, ulong* sz, const char* start_pos) {
+  // Scan to the end of the number
+  const char* pos = start_pos;
+  const char* const end_pos = sax->json + sax->json_sz;
+  if (pos < end_pos && *pos == '-')
+    pos++;
+  while (pos < end_pos && (uchar)(*pos - '0') <= (uchar)9)
+    pos++;
+  int isfloat = 0;
+  if (pos < end_pos && *pos == '.') {
+    isfloat = 1;
+    pos++;
+    while (pos < end_pos && (uchar)(*pos - '0') <= (uchar)9)
+      pos++;
+  }
+  if (pos < end_pos && (*pos == 'e' || *pos == 'E')) {
+    isfloat = 1;
+    pos++;
+    if (pos < end_pos && (*pos == '+' || *pos == '-'))
+      pos++;
+    while (pos < end_pos && (uchar)(*pos - '0') <= (uchar)9)
+      pos++;
+  }
+
+  // Numbers must end on whitespace or punctuation
+  if (pos < end_pos) {
+    switch (*pos) {
+    case ' ': case '\t': case '\r': case '\n':
+    case '[': case ']':  case '{':  case '}':
+    case ',': case ':':
+      break;
+    default:
+      sax->pos = (ulong)(start_pos - sax->json);
+      snprintf(sax->err, sizeof(sax->err), "malformed number at position %lu in json", sax->pos);
+      return JSON_TOKEN_ERROR;
+    }
+  }
+
+  ulong text_sz = (ulong)(pos - start_pos);
+  if (text_sz >= JSON_SAX_NUMBER_MAX) {
+    sax->pos = (ulong)(start_pos - sax->json);
+    snprintf(sax->err, sizeof(sax->err), "malformed number at position %lu in json", sax->pos);
+    return JSON_TOKEN_ERROR;
+  }
+  sax->pos = (ulong)(pos - sax->json);
+
+  if (isfloat) {
+    // strtod needs a terminated string, so the text goes right after
+    // the value
+    char* out = json_sax_reserve(values, 0, sizeof(double) + text_sz);
+    char* text = out + sizeof(double);
+    fd_memcpy(text, start_pos, text_sz);
+    text[text_sz] = '\0';
+    double val = strtod(text, NULL);
+    fd_memcpy(out, &val, sizeof(double));
+    *sz = sizeof(double);
+    return JSON_TOKEN_FLOAT;
+  }
+
+  // Convert the decimal text to an integer, wrapping like
+  // json_lex_as_int
+  const char* i = start_pos;
+  int isneg = 0;
+  if (i < pos && *i == '-') {
+    isneg = 1;
+    i++;
+  }
+  ulong n = 0;
+  while (i < pos)
+    n = n*10UL + (ulong)(*(i++) - '0');
+  long val = (long)(isneg ? -n : n);
+  fd_memcpy(json_sax_reserve(values, 0, sizeof(long)), &val, sizeof(long));
+  *sz = sizeof(long);
+  return JSON_TOKEN_INTEGER;
+}
+
+// Encode a unicode character in UTF-8. Returns the number of bytes
+// written. See json_lex_append_char.
+static ulong json_sax_utf8(char* dest, uint ch) {
+  if (ch < 0x80) {
+    dest[0] = (char)ch;
+    return 1;
+  } else if (ch < 0x800) {
+    dest[0] = (char)((ch>>6) | 0xC0);
+    dest[1] = (char)((ch & 0x3F) | 0x80);
+    return 2;
+  } else if (ch < 0x10000) {
+    dest[0] = (char)((ch>>12) | 0xE0);
+    dest[1] = (char)(((ch>>6) & 0x3F) | 0x80);
+    dest[2] = (char)((ch & 0x3F) | 0x80);
+    return 3;
+  } else if (ch < 0x110000) {
+    dest[0] = (char)((ch>>18) | 0xF0);
+    dest[1] = (char)(((ch>>12) & 0x3F) | 0x80);
+    dest[2] = (char)(((ch>>6) & 0x3F) | 0x80);
+    dest[3] = (char)((ch & 0x3F) | 0x80);
+    return 4;
+  }
+  return 0;
+}
+
+// Return the first byte in [pos,end_pos) that is not printable ASCII
+// (a control character or part of a multibyte sequence), a quote or a
+// backslash. Printable ASCII is all a request usually has and needs
+// no further validation.
+static const char* json_sax_scan_ascii(const char* pos, const char* end_pos) {
+#if FD_HAS_AVX
+  while (pos + 32 <= end_pos) {
+    wb_t c = wb_ldu(pos);
+    // The signed compare catches the control characters and the bytes
+    // of multibyte sequences at once
+    wb_t stop = wb_or(wb_or(wb_eq(c, wb_bcast('"')), wb_eq(c, wb_bcast('\\'))),
+                      _mm256_cmpgt_epi8(wb_bcast(0x20), c));
+    int mask = _mm256_movemask_epi8(stop);
+    if (mask)
+      return pos + fd_uint_find_lsb((uint)mask);
+    pos += 32;
+  }
+#endif
+  while (pos < end_pos && (uchar)(*pos - 0x20) < (uchar)0x60 && *pos != '"' && *pos != '\\')
+    pos++;
+  return pos;
+}
+
+// Parse a json string, decoding it to pure UTF-8 directly into the
+// uncommitted space of values. See json_lex_parse_string.
+static long json_sax_string(json_sax_t* sax, struct json_values* values, ulong* sz, const char* start_pos) {
+  const char* pos = start_pos + 1; // Skip leading quote
+  const char* const end_pos = sax->json + sax->json_sz;
+  ulong used = 0;
+  // Loop over all characters
+  while (pos < end_pos) {
+    if (*pos == '"') {
+      json_sax_reserve(values, used, 0); // Room for the terminator
+      sax->pos = (ulong)(pos + 1 - sax->json);
+      *sz = used;
+      return JSON_TOKEN_STRING;
+    }
+
+    if (*pos != '\\') {
+      // A segment of simple text without escapes
+      const char* s = pos;
+      pos = json_sax_scan_ascii(pos, end_pos);
+      if (pos < end_pos && *pos != '"' && *pos != '\\') {
+        // Find the end of the segment and make sure the text is
+        // correctly encoded
+        do {
+          pos++;
+        } while (pos < end_pos && *pos != '"' && *pos != '\\');
+        const char* err_pos = json_lex_validate_encoding(s, pos);
+        if (err_pos) {
+          sax->pos = (ulong)(start_pos - sax->json);
+          snprintf(sax->err, sizeof(sax->err), "invalid character literal at position %ld in json", err_pos - sax->json);
+          return JSON_TOKEN_ERROR;
+        }
+      }
+      ulong seg_sz = (ulong)(pos - s);
+      fd_memcpy(json_sax_reserve(values, used, seg_sz) + used, s, seg_sz);
+      used += seg_sz;
+      continue;
+    }
+
+    // Process an escape
+    if (pos + 2 > end_pos)
+      break;
+    uint ch;
+    switch (pos[1]) {
+      // Simple escapes
+    case '"':  ch = 0x22; pos += 2; break;
+    case '\\': ch = 0x5C; pos += 2; break;
+    case '/':  ch = 0x2F; pos += 2; break;
+    case 'b':  ch = 0x8;  pos += 2; break;
+    case 'f':  ch = 0xC;  pos += 2; break;
+    case 'n':  ch = 0xA;  pos += 2; break;
+    case 'r':  ch = 0xD;  pos += 2; break;
+    case 't':  ch = 0x9;  pos += 2; break;
+
+    case 'u': // Hexadecimal escape
+      if (pos + 6 <= end_pos) {
+        ch = 0;
+        unsigned i;
+        for (i = 2; i < 6; ++i) {
+          char j = pos[i];
+          if ((uchar)(j - '0') <= (uchar)9)
+            ch = (ch<<4) + (uchar)(j - '0');
+          else if ((uchar)(j - 'a') <= (uchar)5)
+            ch = (ch<<4) + (uchar)(j - ('a' - 10));
+          else if ((uchar)(j - 'A') <= (uchar)5)
+            ch = (ch<<4) + (uchar)(j - ('A' - 10));
+          else
+            break;
+        }
+        // See if the loop succeeded
+        if (i == 6) {
+          pos += 6;
+          break; // Fall out of switch to the append
+        }
+      }
+      // Fall through to error case
+      __attribute__((fallthrough));
+    default:
+      sax->pos = (ulong)(start_pos - sax->json);
+      snprintf(sax->err, sizeof(sax->err), "invalid character literal at position %ld in json", pos - sax->json);
+      return JSON_TOKEN_ERROR;
+    }
+    // Append the escaped character
+    used += json_sax_utf8(json_sax_reserve(values, used, 4) + used, ch);
+  }
+  // We were looking for a closing quote
+  sax->pos = (ulong)(start_pos - sax->json);
+  snprintf(sax->err, sizeof(sax->err), "unterminated string starting at position %lu in json", sax->pos);
+  return JSON_TOKEN_ERROR;
+}
+
+// Report a lexical error
+static long json_sax_lex_error(json_sax_t* sax, const char* pos) {
+  sax->pos = (ulong)(pos - sax->json);
+  snprintf(sax->err, sizeof(sax->err), "lexical error at position %lu in json", sax->pos);
+  return JSON_TOKEN_ERROR;
+}
+
+// Scan the next token, like json_lex_next_token. The value of a
+// string, number or boolean is left in the uncommitted space of
+// values and its size is stored in *sz.
+static long json_sax_next_token(json_sax_t* sax, struct json_values* values, ulong* sz) {
+  const char* pos = sax->json + sax->pos;
+  const char* end_pos = sax->json + sax->json_sz;
+  while (pos < end_pos) {
+    switch (*pos) {
+      // Whitespace
+    case ' ': case '\t': case '\r': case '\n':
+      ++pos;
+      continue;
+
+      // Single character cases
+    case '[':
+      sax->pos = (ulong)(pos + 1 - sax->json);
+      return sax->last_tok = JSON_TOKEN_LBRACKET;
+    case ']':
+      sax->pos = (ulong)(pos + 1 - sax->json);
+      return sax->last_tok = JSON_TOKEN_RBRACKET;
+    case '{':
+      sax->pos = (ulong)(pos + 1 - sax->json);
+      return sax->last_tok = JSON_TOKEN_LBRACE;
+    case '}':
+      sax->pos = (ulong)(pos + 1 - sax->json);
+      return sax->last_tok = JSON_TOKEN_RBRACE;
+    case ',':
+      sax->pos = (ulong)(pos + 1 - sax->json);
+      return sax->last_tok = JSON_TOKEN_COMMA;
+    case ':':
+      sax->pos = (ulong)(pos + 1 - sax->json);
+      return sax->last_tok = JSON_TOKEN_COLON;
+
+    case 'n': // null
+      if (pos + 4 <= end_pos && pos[1] == 'u' && pos[2] == 'l' && pos[3] == 'l') {
+        sax->pos = (ulong)(pos + 4 - sax->json);
+        json_sax_reserve(values, 0, 0); // Room for the terminator
+        *sz = 0;
+        return sax->last_tok = JSON_TOKEN_NULL;
+      }
+      return sax->last_tok = json_sax_lex_error(sax, pos);
+
+    case 't': // true
+    case 'f': { // false
+      int val = (*pos == 't');
+      ulong len = (val ? 4UL : 5UL);
+      if (pos + len <= end_pos && !memcmp(pos, (val ? "true" : "false"), len)) {
+        sax->pos = (ulong)(pos + len - sax->json);
+        fd_memcpy(json_sax_reserve(values, 0, sizeof(int)), &val, sizeof(int));
+        *sz = sizeof(int);
+        return sax->last_tok = JSON_TOKEN_BOOL;
+      }
+      return sax->last_tok = json_sax_lex_error(sax, pos);
+    }
+
+      // number
+    case '-': case '0': case '1': case '2': case '3': case '4': case '5':
+    case '6': case '7': case '8': case '9':
+      return sax->last_tok = json_sax_number(sax, values, sz, pos);
+
+    case '"': // string
+      return sax->last_tok = json_sax_string(sax, values, sz, pos);
+
+    default: // Any other character
+      return sax->last_tok = json_sax_lex_error(sax, pos);
+    }
+  }
+  sax->pos = (ulong)(pos - sax->json);
+  return sax->last_tok = JSON_TOKEN_END;
+}
+
+// Read the next token and fail on a lexical error
+#define NEXT_TOKEN                                                      \
+  do {                                                                  \
+    prevpos = sax->pos;                                                 \
+    prevtoken = sax->last_tok;                                          \
+    token = json_sax_next_token(sax, values, &data_sz);                 \
+    if (token == JSON_TOKEN_ERROR) return 0;                            \
+  } while (0)
+
+#define UNNEXT_TOKEN                                                    \
+  sax->pos = prevpos;                                                   \
+  sax->last_tok = prevtoken;
+
+// Parse a generic json value. This follows json_values_parse token
+// for token, but leaf values are committed where the scanner left
+// them.
+static int
+json_sax_value(json_sax_t* sax, struct json_values* values, struct json_path* path) {
+  ulong prevpos;
+  long token;
+  long prevtoken;
+  ulong data_sz = 0;
+
+  // Prepare to update the path to include a new element
+  if (path->len == JSON_MAX_PATH)
+    SAX_ERROR("json value is too nested at position %lu", sax->pos);
+  uint* path_last = &path->elems[path->len ++];
+
+  NEXT_TOKEN;
+  switch (token) {
+  case JSON_TOKEN_LBRACE: // Start a new json object
+    do {
+      NEXT_TOKEN;
+      if (token == JSON_TOKEN_RBRACE)
+        break;
+      if (token != JSON_TOKEN_STRING)
+        SAX_ERROR("expected string key at position %lu", prevpos);
+      // Translate the key string to a known keyword ID, in place. We
+      // only allow a predetermined set of keys.
+      long keyid = fd_webserver_json_keyword(values->buf + values->buf_sz, data_sz);
+      if (keyid == KEYW_UNKNOWN)
+        SAX_ERROR("unrecognized string key at position %lu", prevpos);
+      // Append to the path
+      *path_last = ((JSON_TOKEN_LBRACE<<16) | (uint)keyid);
+
+      NEXT_TOKEN;
+      if (token != JSON_TOKEN_COLON)
+        SAX_ERROR("expected colon at position %lu", prevpos);
+
+      // Recursively parse the inner value
+      if (!json_sax_value(sax, values, path))
+        return 0;
+
+      NEXT_TOKEN;
+      if (token == JSON_TOKEN_RBRACE)
+        break;
+      if (token != JSON_TOKEN_COMMA)
+        SAX_ERROR("expected comma at position %lu", prevpos);
+    } while(1);
+    break;
+
+  case JSON_TOKEN_LBRACKET: { // Start an array
+    uint i = 0;
+    do {
+      // Append to the path
+      *path_last = ((JSON_TOKEN_LBRACKET<<16) | i);
+      // Recursively parse the array element
+      if (!json_sax_value(sax, values, path))
+        return 0;
+
+      NEXT_TOKEN;
+      if (token == JSON_TOKEN_RBRACKET)
+        break;
+      if (token != JSON_TOKEN_COMMA)
+        SAX_ERROR("expected comma at position %lu", prevpos);
+
+      ++i;
+    } while(1);
+    break;
+  }
+
+  case JSON_TOKEN_STRING:
+  case JSON_TOKEN_INTEGER:
+  case JSON_TOKEN_FLOAT:
+  case JSON_TOKEN_BOOL:
+  case JSON_TOKEN_NULL:
+    // The scanner left the value at the end of the buffer
+    *path_last = ((uint)token<<16);
+    json_sax_commit(values, path, data_sz);
+    break;
+
+  case JSON_TOKEN_RBRACKET:
+    if (prevtoken == JSON_TOKEN_LBRACKET) {
+      /* Empty array */
+      UNNEXT_TOKEN;
+      break;
+    }
+    SAX_ERROR("unexpected ']' at position %lu", prevpos);
+    break;
+
+  case JSON_TOKEN_RBRACE:
+    if (prevtoken == JSON_TOKEN_LBRACE) {
+      /* Empty object */
+      UNNEXT_TOKEN;
+      break;
+    }
+    SAX_ERROR("unexpected '}' at position %lu", prevpos);
+    break;
+
+  default:
+    SAX_ERROR("expected json value at position %lu", prevpos);
+  }
+
+  path->len --;
+  return 1;
+}
+
+int json_sax_parse(json_sax_t* sax, struct json_values* values) {
+  struct json_path path;
+  path.len = 0;
+  return json_sax_value(sax, values, &path);
+}
+
+// Skip whitespace and return the position of the next character
+static const char* json_sax_skip_ws(json_sax_t* sax) {
+  const char* pos = sax->json + sax->pos;
+  const char* end_pos = sax->json + sax->json_sz;
+  while (pos < end_pos && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n'))
+    ++pos;
+  return pos;
+}
+
+int json_sax_batch_begin(json_sax_t* sax) {
+  const char* pos = json_sax_skip_ws(sax);
+  if (pos == sax->json + sax->json_sz || *pos != '[')
+    return 0;
+  sax->pos = (ulong)(pos + 1 - sax->json);
+  sax->last_tok = JSON_TOKEN_LBRACKET;
+  return 1;
+}
+
+long json_sax_batch_next(json_sax_t* sax) {
+  const char* pos = json_sax_skip_ws(sax);
+  if (pos == sax->json + sax->json_sz)
+    return JSON_TOKEN_ERROR;
+  switch (*pos) {
+  case ',':
+    sax->pos = (ulong)(pos + 1 - sax->json);
+    return sax->last_tok = JSON_TOKEN_COMMA;
+  case ']':
+    sax->pos = (ulong)(pos + 1 - sax->json);
+    return sax->last_tok = JSON_TOKEN_RBRACKET;
+  default:
+    return JSON_TOKEN_ERROR;
+  }
+}
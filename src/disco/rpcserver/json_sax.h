@@ -0,0 +1,53 @@
+#ifndef HEADER_fd_src_disco_rpcserver_json_sax_h
+#define HEADER_fd_src_disco_rpcserver_json_sax_h
+
+#include "fd_methods.h"
+
+// Single pass json parser for rpc requests. It produces exactly the
+// same json_values as json_lex + json_values_parse, but tokens are
+// never materialized in a separate lexer buffer: strings are
+// unescaped and numbers converted straight into the json_values
+// buffer (the arena), keys are matched with the generated keyword
+// matcher (keywords.c) in place, and a value is committed to the
+// json_values without being copied again. A typical request is
+// parsed without any allocation. The arena only grows (from scratch
+// space, like json_values) for requests with more than
+// sizeof(buf_init) bytes of values.
+//
+// A batch request is parsed one element at a time with
+// json_sax_batch_begin, json_sax_parse and json_sax_batch_next, so
+// each request is dispatched as soon as it is parsed and the request
+// text is only scanned once.
+struct json_sax {
+    // Input json text
+    const char* json;
+    ulong json_sz;
+
+    // Current position in text
+    ulong pos;
+    // Last token parsed
+    long last_tok;
+
+    // Error message of the last failure
+    char err[128];
+};
+typedef struct json_sax json_sax_t;
+
+// Initialize a parser given some json text
+void json_sax_new(json_sax_t* sax, const char* json, ulong json_sz);
+
+// Parse the next json value into a freshly initialized values.
+// Returns 1 on success. On failure, 0 is returned and sax->err holds
+// the error message.
+int json_sax_parse(json_sax_t* sax, struct json_values* values);
+
+// Consume the opening bracket of a batch request. Returns 1 if the
+// text is a batch request and 0 (nothing is consumed) otherwise.
+int json_sax_batch_begin(json_sax_t* sax);
+
+// Consume the separator after an element of a batch request. Returns
+// JSON_TOKEN_COMMA if another element follows, JSON_TOKEN_RBRACKET at
+// the end of the batch and JSON_TOKEN_ERROR otherwise.
+long json_sax_batch_next(json_sax_t* sax);
+
+#endif /* HEADER_fd_src_disco_rpcserver_json_sax_h */
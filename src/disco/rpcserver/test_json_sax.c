@@ -0,0 +1,207 @@
+#include "json_sax.h"
+#include "keywords.h"
+
+#define SMAX (1UL<<22)
+#define FMAX (16UL)
+static uchar scratch_mem [ SMAX ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+static ulong scratch_fmem[ FMAX ] __attribute__((aligned(FD_SCRATCH_FMEM_ALIGN)));
+
+static char const * requests[] = {
+  "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"getSlot\"}",
+  " { \"jsonrpc\": \"2.0\", \"id\": 1, \"method\": \"getBalance\", \"params\": [ \"6s5gDyLyfNXP6WHUEn4YSMQJVcGETpKze7FCPeg9wxYT\" ] } ",
+  "{\"jsonrpc\":\"2.0\",\"id\":\"abc\",\"method\":\"getBlock\",\"params\":[270562740,{\"encoding\":\"json\",\"maxSupportedTransactionVersion\":0,\"transactionDetails\":\"full\",\"rewards\":false}]}",
+  "{\"jsonrpc\":\"2.0\",\"id\":-17,\"method\":\"getInflationRate\",\"params\":[1.5e3,-0.25,true,null,{}]}",
+  "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"getBlocks\",\"params\":[[],[[1,2],[3]],{\"limit\":18446744073709551616}]}",
+  "{\"method\":\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u0041\\u00e9\\u20AC\\ud83d\\u0000\",\"id\":\"\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\"}",
+  "{\"met\\u0068od\":\"getSlot\"}",
+  "[{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"getSlot\"},{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"getHealth\"}]",
+  "{\"params\":[[[[[[[[1]]]]]]]]}",
+  "{\"params\":[[[[[[[1]]]]]]]}",
+  "{\"params\":[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,32,33,34,35]}",
+  "{\"unknownKey\":1}",
+  "{\"id\":1,}",
+  "{\"id\" 1}",
+  "{\"id\":1 \"method\":2}",
+  "[1,]",
+  "[1 2]",
+  "{\"id\":nul}",
+  "{\"id\":tru}",
+  "{\"id\":01x}",
+  "{\"id\":-}",
+  "{\"id\":\"\\x\"}",
+  "{\"id\":\"\\u12G4\"}",
+  "{\"id\":\"abc",
+  "{\"id\":\"a\x01\"}",
+  "{\"id\":\"\xc0\xaf\"}",
+  "{1:2}",
+  "}",
+  "]",
+  "",
+  "   ",
+  "@",
+  NULL
+};
+
+/* check_same parses json with json_values_parse and json_sax_parse and
+   checks that they agree on the outcome, the error and the values */
+
+static int
+check_same( char const * json,
+            ulong        json_sz ) {
+  int ok0, ok1;
+  struct json_values values0[1];
+  struct json_values values1[1];
+
+  FD_SCRATCH_SCOPE_BEGIN {
+    json_lex_state_t lex[1];
+    json_lex_state_new( lex, json, json_sz );
+    json_values_new( values0 );
+    struct json_path path = { .len = 0 };
+    ok0 = json_values_parse( lex, values0, &path );
+
+    json_sax_t sax[1];
+    json_sax_new( sax, json, json_sz );
+    json_values_new( values1 );
+    ok1 = json_sax_parse( sax, values1 );
+
+    FD_TEST( ok0==ok1 );
+    if( ok0 ) {
+      FD_TEST( lex->pos==sax->pos );
+      FD_TEST( values0->num_values==values1->num_values );
+      for( uint i=0U; i<values0->num_values; i++ ) {
+        struct json_path const * p0 = &values0->values[i].path;
+        struct json_path const * p1 = &values1->values[i].path;
+        FD_TEST( p0->len==p1->len );
+        FD_TEST( !memcmp( p0->elems, p1->elems, p0->len*sizeof(uint) ) );
+        ulong sz = values0->values[i].data_sz;
+        FD_TEST( sz==values1->values[i].data_sz );
+        FD_TEST( !memcmp( values0->buf + values0->values[i].data_offset,
+                          values1->buf + values1->values[i].data_offset, sz+1UL ) );
+      }
+    } else {
+      FD_TEST( !strcmp( json_lex_get_text( lex, NULL ), sax->err ) );
+    }
+    json_lex_state_delete( lex );
+    json_values_delete( values0 );
+    json_values_delete( values1 );
+  } FD_SCRATCH_SCOPE_END;
+  return ok0;
+}
+
+static void
+test_batch( void ) {
+  char const * json = " [ {\"id\":1} , {\"id\":2} ,{\"id\":3}] ";
+  json_sax_t sax[1];
+  json_sax_new( sax, json, strlen( json ) );
+  FD_TEST( json_sax_batch_begin( sax ) );
+  for( long i=1L; i<=3L; i++ ) {
+    struct json_values values[1];
+    json_values_new( values );
+    FD_TEST( json_sax_parse( sax, values ) );
+    static const uint PATH[2] = { (JSON_TOKEN_LBRACE<<16) | KEYW_JSON_ID, (JSON_TOKEN_INTEGER<<16) };
+    ulong sz;
+    long const * id = json_get_value( values, PATH, 2, &sz );
+    FD_TEST( id && sz==sizeof(long) && *id==i );
+    FD_TEST( json_sax_batch_next( sax )==(i<3L ? JSON_TOKEN_COMMA : JSON_TOKEN_RBRACKET) );
+  }
+
+  json_sax_new( sax, json+3, strlen( json+3 ) );
+  FD_TEST( !json_sax_batch_begin( sax ) );
+  FD_TEST( sax->pos==0UL );
+
+  json = "[{\"id\":1}}";
+  json_sax_new( sax, json, strlen( json ) );
+  FD_TEST( json_sax_batch_begin( sax ) );
+  struct json_values values[1];
+  json_values_new( values );
+  FD_TEST( json_sax_parse( sax, values ) );
+  FD_TEST( json_sax_batch_next( sax )==JSON_TOKEN_ERROR );
+}
+
+static void
+test_performance( void ) {
+  char const * json = "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"getBalance\",\"params\":[\"6s5gDyLyfNXP6WHUEn4YSMQJVcGETpKze7FCPeg9wxYT\",{\"commitment\":\"processed\"}]}";
+  ulong json_sz = strlen( json );
+  ulong iter    = 1000000UL;
+
+  long dt0 = -fd_log_wallclock();
+  for( ulong i=0UL; i<iter; i++ ) {
+    json_lex_state_t lex[1];
+    json_lex_state_new( lex, json, json_sz );
+    struct json_values values[1];
+    json_values_new( values );
+    struct json_path path = { .len = 0 };
+    FD_TEST( json_values_parse( lex, values, &path ) );
+    FD_COMPILER_UNPREDICTABLE( values->num_values );
+  }
+  dt0 += fd_log_wallclock();
+
+  long dt1 = -fd_log_wallclock();
+  for( ulong i=0UL; i<iter; i++ ) {
+    json_sax_t sax[1];
+    json_sax_new( sax, json, json_sz );
+    struct json_values values[1];
+    json_values_new( values );
+    FD_TEST( json_sax_parse( sax, values ) );
+    FD_COMPILER_UNPREDICTABLE( values->num_values );
+  }
+  dt1 += fd_log_wallclock();
+
+  FD_LOG_NOTICE(( "average time per request: json_values_parse %.1f ns, json_sax_parse %.1f ns",
+                  (double)dt0/(double)iter, (double)dt1/(double)iter ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  fd_scratch_attach( scratch_mem, scratch_fmem, SMAX, FMAX );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  ulong ok_cnt = 0UL;
+  for( ulong i=0UL; requests[i]; i++ ) ok_cnt += (ulong)check_same( requests[i], strlen( requests[i] ) );
+  FD_TEST( ok_cnt==11UL );
+
+  /* Values that outgrow the initial buffer */
+
+  static char big[ 1UL<<16 ];
+  char * p = fd_cstr_init( big );
+  p = fd_cstr_append_cstr( p, "{\"params\":[" );
+  for( ulong i=0UL; i<20UL; i++ ) {
+    p = fd_cstr_append_cstr( p, i ? ",\"" : "\"" );
+    for( ulong j=0UL; j<1000UL; j++ ) p = fd_cstr_append_char( p, (char)('a' + fd_rng_uint_roll( rng, 26U )) );
+    p = fd_cstr_append_cstr( p, "\\n\"" );
+  }
+  p = fd_cstr_append_cstr( p, "]}" );
+  fd_cstr_fini( p );
+  FD_TEST( check_same( big, strlen( big ) ) );
+
+  /* Truncations and byte flips of the requests above */
+
+  for( ulong iter=0UL; iter<100000UL; iter++ ) {
+    char const * req    = requests[ fd_rng_uint_roll( rng, 11U ) ];
+    ulong        req_sz = strlen( req );
+    char buf[ 512 ];
+    fd_memcpy( buf, req, req_sz );
+    ulong flip_cnt = fd_rng_uint_roll( rng, 4U );
+    for( ulong i=0UL; i<flip_cnt; i++ ) {
+      ulong idx = fd_rng_ulong_roll( rng, req_sz );
+      switch( fd_rng_uint_roll( rng, 3U ) ) {
+      case 0U: buf[ idx ] = (char)fd_rng_uchar( rng ); break;
+      case 1U: buf[ idx ] = "{}[],:\"\\ 0-.e"[ fd_rng_uint_roll( rng, 13U ) ]; break;
+      case 2U: buf[ idx ] = (char)( buf[ idx ] ^ (1 << fd_rng_uint_roll( rng, 8U )) ); break;
+      }
+    }
+    check_same( buf, fd_rng_ulong_roll( rng, req_sz+1UL ) );
+  }
+
+  test_batch();
+  test_performance();
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_scratch_detach( NULL );
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
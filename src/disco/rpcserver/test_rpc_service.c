@@ -0,0 +1,232 @@
+#include "fd_rpc_service.h"
+#include "../../flamenco/runtime/fd_acc_mgr.h"
+#include "../../ballet/base58/fd_base58.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+/* Checks that the pre-serialized replies of the hot methods are served
+   from the cache until a replay notification invalidates them.  The
+   service is driven through HTTP over loopback, and funk is changed
+   underneath it without a notification to tell a cached reply from a
+   fresh one. */
+
+#define SMAX (1UL<<22)
+#define FMAX (16UL)
+static uchar scratch_mem [ SMAX ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+static ulong scratch_fmem[ FMAX ] __attribute__((aligned(FD_SCRATCH_FMEM_ALIGN)));
+
+#define REPLY_MAX (4096UL)
+
+/* rpc_call posts the JSON request body to the service on port, polling
+   ctx until the server closes the connection.  Returns the reply body
+   as a cstr in reply. */
+
+static char const *
+rpc_call( fd_rpc_ctx_t * ctx,
+          ushort         port,
+          char const *   body,
+          char           reply[ REPLY_MAX ] ) {
+  int sock = socket( AF_INET, SOCK_STREAM, 0 );
+  FD_TEST( sock>=0 );
+  struct sockaddr_in addr = {
+    .sin_family      = AF_INET,
+    .sin_port        = fd_ushort_bswap( port ),
+    .sin_addr.s_addr = FD_IP4_ADDR( 127, 0, 0, 1 ),
+  };
+  FD_TEST( !connect( sock, fd_type_pun( &addr ), sizeof(addr) ) );
+
+  char req[ 1024 ];
+  ulong req_sz;
+  FD_TEST( fd_cstr_printf_check( req, sizeof(req), &req_sz,
+                                 "POST / HTTP/1.1\r\nContent-Type: application/json\r\nContent-Length: %lu\r\n\r\n%s",
+                                 strlen( body ), body ) );
+  FD_TEST( send( sock, req, req_sz, 0 )==(long)req_sz );
+
+  ulong reply_sz = 0UL;
+  for(;;) {
+    fd_rpc_ws_poll( ctx );
+    long r = recv( sock, reply+reply_sz, REPLY_MAX-1UL-reply_sz, MSG_DONTWAIT );
+    if( r==0L ) break;
+    if( r<0L ) {
+      FD_TEST( errno==EAGAIN || errno==EWOULDBLOCK );
+      continue;
+    }
+    reply_sz += (ulong)r;
+    FD_TEST( reply_sz<REPLY_MAX-1UL );
+  }
+  FD_TEST( !close( sock ) );
+  reply[ reply_sz ] = '\0';
+
+  FD_TEST( !strncmp( reply, "HTTP/1.1 200", 12UL ) );
+  char const * reply_body = strstr( reply, "\r\n\r\n" );
+  FD_TEST( reply_body );
+  return reply_body+4UL;
+}
+
+/* check_balance checks the reply to the getBalance request req,
+   skipping over the api version */
+
+static void
+check_balance( fd_rpc_ctx_t * ctx,
+               ushort         port,
+               char const *   req,
+               ulong          slot,
+               ulong          lamports ) {
+  static char const prefix[] = "{\"jsonrpc\":\"2.0\",\"result\":{\"context\":{\"apiVersion\":\"";
+  char reply [ REPLY_MAX ];
+  char expect[ 256 ];
+  char const * body = rpc_call( ctx, port, req, reply );
+  FD_TEST( !strncmp( body, prefix, sizeof(prefix)-1UL ) );
+  char const * tail = strstr( body+sizeof(prefix)-1UL, "\"," );
+  FD_TEST( tail );
+  FD_TEST( fd_cstr_printf_check( expect, sizeof(expect), NULL,
+                                 "\",\"slot\":%lu},\"value\":%lu},\"id\":4}\r\n", slot, lamports ) );
+  if( FD_UNLIKELY( strcmp( tail, expect ) ) ) FD_LOG_ERR(( "unexpected reply %s", body ));
+}
+
+static void
+set_lamports( fd_funk_t *         funk,
+              fd_pubkey_t const * acct,
+              ulong               lamports ) {
+  fd_funk_start_write( funk );
+  fd_funk_rec_key_t key = fd_acc_funk_key( acct );
+  fd_funk_rec_t * rec = fd_funk_rec_write_prepare( funk, NULL, &key, sizeof(fd_account_meta_t), 1, NULL, NULL );
+  FD_TEST( rec );
+  fd_account_meta_t * meta = fd_funk_val( rec, fd_funk_wksp( funk ) );
+  FD_TEST( meta );
+  fd_account_meta_init( meta );
+  meta->info.lamports = lamports;
+  fd_funk_end_write( funk );
+}
+
+static void
+notify_slot( fd_rpc_ctx_t * ctx,
+             ulong          slot ) {
+  fd_replay_notif_msg_t msg[1];
+  fd_memset( msg, 0, sizeof(msg) );
+  msg->type               = FD_REPLAY_SLOT_TYPE;
+  msg->slot_exec.parent   = slot-1UL;
+  msg->slot_exec.root     = slot-1UL;
+  msg->slot_exec.slot     = slot;
+  msg->slot_exec.height   = slot;
+  msg->slot_exec.block_hash.ul[0] = slot;
+  fd_rpc_replay_after_frag( ctx, msg );
+}
+
+static void
+notify_acct( fd_rpc_ctx_t *      ctx,
+             fd_pubkey_t const * acct ) {
+  fd_replay_notif_msg_t msg[1];
+  fd_memset( msg, 0, sizeof(msg) );
+  msg->type            = FD_REPLAY_ACCTS_TYPE;
+  msg->accts.accts_cnt = 1U;
+  fd_memcpy( msg->accts.accts[0].id, acct, sizeof(fd_pubkey_t) );
+  msg->accts.accts[0].flags = FD_REPLAY_NOTIF_ACCT_WRITTEN;
+  fd_rpc_replay_after_frag( ctx, msg );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--page-sz",  NULL,      "gigantic" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong ( &argc, &argv, "--page-cnt", NULL,             1UL );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong ( &argc, &argv, "--near-cpu", NULL, fd_log_cpu_id() );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  fd_funk_t * funk = fd_funk_join( fd_funk_new( fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint(), 42UL ), 42UL, 1234UL, 16UL, 512UL ) );
+  FD_TEST( funk );
+
+  ulong shred_max = 1024UL;
+  ulong block_max = 64UL;
+  ulong idx_max   = 64UL;
+  ulong txn_max   = 64UL;
+  void * mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_align(), fd_blockstore_footprint( shred_max, block_max, idx_max, txn_max ), 1UL );
+  FD_TEST( mem );
+  fd_blockstore_t * blockstore = fd_blockstore_join( fd_blockstore_new( mem, 1UL, 42UL, shred_max, block_max, idx_max, txn_max ) );
+  FD_TEST( blockstore );
+
+  fd_scratch_attach( scratch_mem, scratch_fmem, SMAX, FMAX );
+
+  fd_rpcserver_args_t args[1];
+  fd_memset( args, 0, sizeof(args) );
+  args->valloc     = fd_libc_alloc_virtual();
+  args->funk       = funk;
+  args->blockstore = blockstore;
+  args->port       = 0; /* ephemeral */
+  args->params     = (fd_http_server_params_t){
+    .max_connection_cnt    = 4UL,
+    .max_ws_connection_cnt = 1UL,
+    .max_request_len       = 1<<12,
+    .max_ws_recv_frame_len = 1<<12,
+    .max_ws_send_frame_cnt = 4UL,
+    .outgoing_buffer_sz    = 1<<16,
+  };
+
+  fd_rpc_ctx_t * ctx;
+  fd_rpc_create_ctx( args, &ctx );
+  fd_rpc_start_service( args, ctx );
+
+  struct sockaddr_in addr;
+  socklen_t addr_len = sizeof(addr);
+  FD_TEST( !getsockname( fd_rpc_ws_fd( ctx ), fd_type_pun( &addr ), &addr_len ) );
+  ushort port = fd_ushort_bswap( addr.sin_port );
+
+  char reply[ REPLY_MAX ];
+
+  /* getSlot is cached until the next slot notification */
+
+  notify_slot( ctx, 100UL );
+  FD_TEST( !strcmp( rpc_call( ctx, port, "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"getSlot\"}", reply ),
+                    "{\"jsonrpc\":\"2.0\",\"result\":100,\"id\":1}\r\n" ) );
+  FD_TEST( !strcmp( rpc_call( ctx, port, "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"getSlot\"}", reply ),
+                    "{\"jsonrpc\":\"2.0\",\"result\":100,\"id\":2}\r\n" ) );
+  notify_slot( ctx, 101UL );
+  FD_TEST( !strcmp( rpc_call( ctx, port, "{\"jsonrpc\":\"2.0\",\"id\":3,\"method\":\"getSlot\"}", reply ),
+                    "{\"jsonrpc\":\"2.0\",\"result\":101,\"id\":3}\r\n" ) );
+
+  /* getBalance is cached until a slot notification, or an account
+     notification that touches the account */
+
+  fd_pubkey_t acct = { .ul = { 0x1234UL, 1UL, 2UL, 3UL } };
+  char acct_b58[ FD_BASE58_ENCODED_32_SZ ];
+  fd_base58_encode_32( acct.uc, NULL, acct_b58 );
+  char req[ 256 ];
+  FD_TEST( fd_cstr_printf_check( req, sizeof(req), NULL,
+                                 "{\"jsonrpc\":\"2.0\",\"id\":4,\"method\":\"getBalance\",\"params\":[\"%s\"]}", acct_b58 ) );
+
+  set_lamports( funk, &acct, 5UL );
+  check_balance( ctx, port, req, 101UL, 5UL );
+
+  set_lamports( funk, &acct, 7UL ); /* not notified, still served from the cache */
+  check_balance( ctx, port, req, 101UL, 5UL );
+
+  fd_pubkey_t other = { .ul = { 0x1234UL, 4UL, 5UL, 6UL } }; /* same cache slot */
+  notify_acct( ctx, &other );
+  check_balance( ctx, port, req, 101UL, 5UL );
+
+  notify_acct( ctx, &acct );
+  check_balance( ctx, port, req, 101UL, 7UL );
+
+  set_lamports( funk, &acct, 9UL );
+  check_balance( ctx, port, req, 101UL, 7UL );
+  notify_slot( ctx, 102UL );
+  check_balance( ctx, port, req, 102UL, 9UL );
+
+  fd_rpc_stop_service( ctx );
+  fd_scratch_detach( NULL );
+
+  fd_wksp_free_laddr( fd_funk_delete( fd_funk_leave( funk ) ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -220,14 +220,22 @@ sample_unstaked( fd_shred_dest_t * sdest ) {
 }
 
 
-/* Returns 0 on success */
+/* compute_seeds computes the ChaCha20 seed of each of the shred_cnt
+   (at most FD_SHRED_DEST_MAX_SHRED_CNT) shreds in input_shreds, along
+   with the first block of each seed's ChaCha20 stream, so that seeding
+   the rng for a shred with seed_rng below doesn't compute any blocks
+   until more than the first 8 samples are needed.  That is always the
+   case for compute_first and the common case for compute_children when
+   the source validator is at the bottom of the tree.  Returns 0 on
+   success */
 static inline int
 compute_seeds( fd_shred_dest_t           * sdest,
                fd_shred_t  const * const * input_shreds,
                ulong                       shred_cnt,
                fd_pubkey_t       const   * leader,
                ulong                       slot,
-               uchar                       dest_hash_output[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ] ) {
+               uchar                       dest_hash_output[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ],
+               uchar                       first_block     [ FD_SHRED_DEST_MAX_SHRED_CNT ][ FD_CHACHA20_BLOCK_SZ ] ) {
 
   shred_dest_input_t dest_hash_inputs [ FD_SHRED_DEST_MAX_SHRED_CNT ];
   fd_sha256_batch_t * sha256 = fd_sha256_batch_init( sdest->_sha256_batch );
@@ -246,9 +254,21 @@ compute_seeds( fd_shred_dest_t           * sdest,
     fd_sha256_batch_add( sha256, dest_hash_inputs+i,   sizeof(shred_dest_input_t), dest_hash_output[ i ] );
   }
   fd_sha256_batch_fini( sha256 );
+
+  fd_chacha20rng_first_block_batch( first_block, (uchar const (*)[ 32 ])dest_hash_output, shred_cnt );
   return 0;
 }
 
+/* seed_rng seeds the rng shared by the staked and unstaked samplers
+   for shred i of the batch computed by compute_seeds. */
+static inline void
+seed_rng( fd_shred_dest_t * sdest,
+          uchar             dest_hash_output[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ],
+          uchar             first_block     [ FD_SHRED_DEST_MAX_SHRED_CNT ][ FD_CHACHA20_BLOCK_SZ ],
+          ulong             i ) {
+  fd_chacha20rng_init_prefilled( sdest->rng, dest_hash_output[ i ], first_block[ i ] );
+}
+
 
 fd_shred_dest_idx_t *
 fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
@@ -266,13 +286,12 @@ fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
   }
 
   uchar dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ];
+  uchar first_blocks     [ FD_SHRED_DEST_MAX_SHRED_CNT ][ FD_CHACHA20_BLOCK_SZ ] __attribute__((aligned(FD_CHACHA20_BLOCK_SZ)));
 
   ulong slot = input_shreds[0]->slot;
   fd_pubkey_t const * leader = fd_epoch_leaders_get( sdest->lsched, slot );
   if( FD_UNLIKELY( !leader ) ) return NULL;
 
-  if( FD_UNLIKELY( compute_seeds( sdest, input_shreds, shred_cnt, leader, slot, dest_hash_outputs ) ) ) return NULL;
-
   /* If we're calling this, we must be the leader.  That means we had
      some stake when the leader schedule was created, but maybe not
      anymore?  This version of the code is safe either way, but I should
@@ -282,13 +301,21 @@ fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
     fd_wsample_remove_idx( sdest->staked, sdest->source_validator_orig_idx );
 
   int any_staked_candidates = sdest->staked_cnt > (ulong)source_validator_is_staked;
-  for( ulong i=0UL; i<shred_cnt; i++ ) {
-    fd_wsample_seed_rng( fd_wsample_get_rng( sdest->staked ), dest_hash_outputs[ i ] );
-    /* Map FD_WSAMPLE_INDETERMINATE to FD_SHRED_DEST_NO_DEST */
-    if( FD_LIKELY( any_staked_candidates ) ) out[i] = (ushort)fd_ulong_min( fd_wsample_sample( sdest->staked ), FD_SHRED_DEST_NO_DEST );
-    else                                     out[i] = (ushort)sample_unstaked_noprepare( sdest, sdest->source_validator_orig_idx );
+  for( ulong off=0UL; off<shred_cnt; off+=FD_SHRED_DEST_MAX_SHRED_CNT ) {
+    ulong batch_cnt = fd_ulong_min( shred_cnt-off, FD_SHRED_DEST_MAX_SHRED_CNT );
+    if( FD_UNLIKELY( compute_seeds( sdest, input_shreds+off, batch_cnt, leader, slot, dest_hash_outputs, first_blocks ) ) ) {
+      fd_wsample_restore_all( sdest->staked );
+      return NULL;
+    }
+
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      seed_rng( sdest, dest_hash_outputs, first_blocks, i );
+      /* Map FD_WSAMPLE_INDETERMINATE to FD_SHRED_DEST_NO_DEST */
+      if( FD_LIKELY( any_staked_candidates ) ) out[off+i] = (ushort)fd_ulong_min( fd_wsample_sample( sdest->staked ), FD_SHRED_DEST_NO_DEST );
+      else                                     out[off+i] = (ushort)sample_unstaked_noprepare( sdest, sdest->source_validator_orig_idx );
+    }
   }
-  fd_wsample_restore_all( sdest->staked );
+  fd_wsample_restore_removed( sdest->staked, &sdest->source_validator_orig_idx, 1UL );
 
   return out;
 }
@@ -337,21 +364,31 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
   }
 
   uchar dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ];
-
-
-  if( FD_UNLIKELY( compute_seeds( sdest, input_shreds, shred_cnt, leader, slot, dest_hash_outputs ) ) ) return NULL;
+  uchar first_blocks     [ FD_SHRED_DEST_MAX_SHRED_CNT ][ FD_CHACHA20_BLOCK_SZ ] __attribute__((aligned(FD_CHACHA20_BLOCK_SZ)));
 
   ulong max_dest_cnt = 0UL;
 
-  ulong staked_shuffle[ sdest->staked_cnt+1UL ];
-  ulong staked_shuffle_populated_cnt = 0UL;
+  /* removed[0] is the leader, if it's staked, and staked_shuffle holds
+     the staked samples drawn without replacement for the current shred,
+     so removed lists everything removed from the staked sampler, which
+     lets it restore just the parts of the tree that changed. */
+  ulong   removed[ sdest->staked_cnt+2UL ];
+  ulong * staked_shuffle = removed+1UL;
+  ulong   staked_shuffle_populated_cnt = 0UL;
+  removed[ 0 ] = fd_ulong_if( query && leader_is_staked, leader_idx, FD_WSAMPLE_EMPTY );
 
   for( ulong i=0UL; i<shred_cnt; i++ ) {
+    ulong batch_i = i % FD_SHRED_DEST_MAX_SHRED_CNT;
+    if( FD_UNLIKELY( !batch_i ) ) {
+      ulong batch_cnt = fd_ulong_min( shred_cnt-i, FD_SHRED_DEST_MAX_SHRED_CNT );
+      if( FD_UNLIKELY( compute_seeds( sdest, input_shreds+i, batch_cnt, leader, slot, dest_hash_outputs, first_blocks ) ) ) return NULL;
+    }
+
     /* Remove the leader. */
     if( FD_LIKELY( query && leader_is_staked ) ) fd_wsample_remove_idx( sdest->staked, leader_idx );
 
     ulong my_idx         = 0UL;
-    fd_wsample_seed_rng( fd_wsample_get_rng( sdest->staked ), dest_hash_outputs[ i ] ); /* Seeds both samplers since the rng is shared */
+    seed_rng( sdest, dest_hash_outputs, first_blocks, batch_i ); /* Seeds both samplers since the rng is shared */
 
     if( FD_UNLIKELY( !i_am_staked ) ) {
       /* If there's excluded stake, we don't know about any unstaked
@@ -400,7 +437,7 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
          the destinations with NO_DEST. */
       for( ulong j=0UL; j<dest_cnt; j++ ) out[ j*out_stride + i ] = FD_SHRED_DEST_NO_DEST;
 
-      fd_wsample_restore_all( sdest->staked   );
+      fd_wsample_restore_removed( sdest->staked, removed, 1UL+staked_shuffle_populated_cnt );
       continue; /* Next shred */
     }
     /* If my index is    |  Send to indices
@@ -460,7 +497,7 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
     /* The rest of my destinations are past the end of the tree */
     for( ulong j=stored_cnt; j<dest_cnt; j++ ) out[ j*out_stride + i ] = FD_SHRED_DEST_NO_DEST;
 
-    fd_wsample_restore_all( sdest->staked );
+    fd_wsample_restore_removed( sdest->staked, removed, 1UL+staked_shuffle_populated_cnt );
 
   }
   fd_ulong_store_if( !!opt_max_dest_cnt, opt_max_dest_cnt, max_dest_cnt );
@@ -153,13 +153,16 @@ static inline ulong fd_shred_dest_cnt_all     ( fd_shred_dest_t * sdest ) { retu
    in _new is the leader (determined using the leader schedule provided
    in _new).  shred_cnt specifies the number of shreds for which
    destinations should be computes.  input_shreds is accessed
-   input_shreds[i] for i in [0, shred_cnt).  shred_cnt must be in [0,
-   67].  The destination index for input_shreds[i] is stored at out[i].
-   input_shreds==NULL is fine if shred_cnt==0, in which case this
-   function is a no-op.  Returns out on success and NULL on failure.
-   This function uses the sha256 batch API internally for performance,
-   which is why it operates on several shreds at the same time as
-   opposed to one at a time. */
+   input_shreds[i] for i in [0, shred_cnt).  shred_cnt can be any
+   value, e.g. all the shreds of one or more FEC sets.  The destination
+   index for input_shreds[i] is stored at out[i].  input_shreds==NULL is
+   fine if shred_cnt==0, in which case this function is a no-op.
+   Returns out on success and NULL on failure.  This function works on
+   batches of up to FD_SHRED_DEST_MAX_SHRED_CNT shreds internally,
+   using the sha256 batch API to compute the per-shred seeds and
+   multi-lane ChaCha20 to compute the start of each seed's random
+   stream, which is why it operates on several shreds at the same time
+   as opposed to one at a time. */
 fd_shred_dest_idx_t *
 fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
                              fd_shred_t const * const * input_shreds,
@@ -175,7 +178,7 @@ fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
    that slot must be known by the leader schedule.  As in
    fd_shred_dest_compute_first, shred_cnt specifies the number of
    shreds, input_shreds is accessed input_shreds[i] for i in [0,
-   shred_cnt), and 0<=shred_cnt<=67.  Computes the first dest_cnt
+   shred_cnt), and shred_cnt can be any value.  Computes the first dest_cnt
    destinations for each shred, using a tree with fanout `fanout`.
    Exactly dest_cnt destination indices will be written for each shreds,
    so if that is more than the number of destinations that the source
@@ -188,9 +188,11 @@ test_batching( void ) {
     fd_epoch_leaders_t * lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( _l_footprint, 0UL, 0UL, 100UL, cnt, stakes, 0UL ) );
     fd_shred_dest_t * sdest = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, src_key, 0UL ) );
 
-#define BATCH_CNT 5
-    fd_shred_dest_idx_t result1[BATCH_CNT*BATCH_CNT];
-    fd_shred_dest_idx_t result2[BATCH_CNT*BATCH_CNT];
+    /* More shreds than FD_SHRED_DEST_MAX_SHRED_CNT, i.e. a batch
+       spanning several FEC sets */
+#define BATCH_CNT 150
+    fd_shred_dest_idx_t result1[5*BATCH_CNT];
+    fd_shred_dest_idx_t result2[5*BATCH_CNT];
     fd_shred_t shred[BATCH_CNT];
     fd_shred_t const * shred_ptr[ BATCH_CNT ];
     for( ulong j=0UL; j<BATCH_CNT; j++ ) shred_ptr[j] = shred+j;
@@ -206,14 +208,14 @@ test_batching( void ) {
       }
       if( FD_LIKELY( memcmp( fd_epoch_leaders_get( lsched, slot ), src_key, 32UL ) ) ) {
         /* Not leader */
-        FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 5UL, result1, 5UL, 5UL, 5UL, NULL ) );
+        FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, BATCH_CNT, result1, BATCH_CNT, 5UL, 5UL, NULL ) );
         for( ulong j=0UL; j<BATCH_CNT; j++ ) {
-          FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr+j, 1UL, result2+j, 5UL, 5UL, 5UL, NULL ) );
+          FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr+j, 1UL, result2+j, BATCH_CNT, 5UL, 5UL, NULL ) );
         }
-        for( ulong j=0UL; j<BATCH_CNT*BATCH_CNT; j++ ) FD_TEST( result1[j]==result2[j] );
+        for( ulong j=0UL; j<5UL*BATCH_CNT; j++ ) FD_TEST( result1[j]==result2[j] );
       } else {
         /* Leader */
-        FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr, 5UL, result1 ) );
+        FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr, BATCH_CNT, result1 ) );
         for( ulong j=0UL; j<BATCH_CNT; j++ ) {
           FD_TEST( fd_shred_dest_compute_first( sdest, shred_ptr+j, 1UL, result2+j ) );
           FD_TEST( result1[j]==result2[j] );
@@ -480,6 +482,31 @@ test_performance( void ) {
   dt += fd_log_wallclock();
   FD_LOG_NOTICE(( "Compute children (16 shred/batch): %.2f ns/shred", (double)dt / (double)(16UL*TEST_CNT) ));
 #undef TEST_CNT
+
+  /* A full FEC set computed by its leader */
+  ulong leader_slot = 1UL;
+  fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+  sdest = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, fd_epoch_leaders_get( lsched, leader_slot ), 0UL ) );
+  FD_TEST( sdest );
+
+  fd_shred_t fec_shred[ 67 ];
+  fd_shred_t const * fec_shred_ptr[ 67 ];
+  for( ulong j=0UL; j<67UL; j++ ) {
+    fec_shred_ptr[j] = fec_shred+j;
+
+    fec_shred[j].slot = leader_slot;
+    fec_shred[j].variant = j<32UL ? FD_SHRED_TYPE_MERKLE_DATA : FD_SHRED_TYPE_MERKLE_CODE;
+  }
+
+  dt = -fd_log_wallclock();
+#define TEST_CNT 10000
+  for( ulong j=0UL; j<TEST_CNT; j++ ) {
+    for( ulong k=0UL; k<67UL; k++ ) fec_shred[k].idx = (uint)(j*67UL+k);
+    FD_TEST( fd_shred_dest_compute_first( sdest, fec_shred_ptr, 67UL, result ) );
+  }
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "Compute first (67 shred/batch): %.2f ns/shred", (double)dt / (double)(67UL*TEST_CNT) ));
+#undef TEST_CNT
 }
 
 int
@@ -225,13 +225,15 @@ fd_store_shred_insert( fd_store_t * store,
     return FD_BLOCKSTORE_OK;
   }
 
-  fd_blockstore_start_write( blockstore );
+  fd_blockstore_start_read( blockstore );
   if( fd_blockstore_block_query( blockstore, shred->slot ) != NULL ) {
-    fd_blockstore_end_write( blockstore );
+    fd_blockstore_end_read( blockstore );
     return FD_BLOCKSTORE_OK;
   }
+  fd_blockstore_end_read( blockstore );
+
+  /* The insert does its own locking, see fd_blockstore.h. */
   int rc = fd_buf_shred_insert( blockstore, shred );
-  fd_blockstore_end_write( blockstore );
 
   /* FIXME */
   if( FD_UNLIKELY( rc < FD_BLOCKSTORE_OK ) ) {
@@ -353,7 +355,7 @@ fd_store_slot_repair( fd_store_t * store,
   backoff->last_repair_time = store->now;
 
   ulong repair_req_cnt = 0;
-  fd_blockstore_start_read( store->blockstore );
+  fd_blockstore_slot_start_read( store->blockstore, slot );
   fd_block_map_t * block_map_entry = fd_blockstore_block_map_query( store->blockstore, slot );
 
   if( FD_LIKELY( !block_map_entry ) ) {
@@ -380,7 +382,7 @@ fd_store_slot_repair( fd_store_t * store,
     if( repair_req_cnt==out_repair_reqs_sz ) {
       backoff->last_backoff_duration += backoff->last_backoff_duration>>2;
       FD_LOG_INFO( ( "[repair] MAX need %lu [%u, %u], sent %lu requests (backoff: %ld ms)", slot, block_map_entry->consumed_idx + 1, complete_idx, repair_req_cnt, backoff->last_backoff_duration/(long)1e6 ) );
-      fd_blockstore_end_read( store->blockstore );
+      fd_blockstore_slot_end_read( store->blockstore, slot );
       return repair_req_cnt;
     }
 
@@ -399,7 +401,7 @@ fd_store_slot_repair( fd_store_t * store,
     }
 
     if( !good ) {
-      fd_blockstore_end_read( store->blockstore );
+      fd_blockstore_slot_end_read( store->blockstore, slot );
       return repair_req_cnt;
     }
 
@@ -415,7 +417,7 @@ fd_store_slot_repair( fd_store_t * store,
       if( repair_req_cnt == out_repair_reqs_sz ) {
         backoff->last_backoff_duration += backoff->last_backoff_duration>>2;
         FD_LOG_INFO( ( "[repair] MAX need %lu [%u, %u], sent %lu requests (backoff: %ld ms)", slot, block_map_entry->consumed_idx + 1, complete_idx, repair_req_cnt, backoff->last_backoff_duration/(long)1e6 ) );
-        fd_blockstore_end_read( store->blockstore );
+        fd_blockstore_slot_end_read( store->blockstore, slot );
         return repair_req_cnt;
       }
     }
@@ -425,6 +427,6 @@ fd_store_slot_repair( fd_store_t * store,
     }
   }
 
-  fd_blockstore_end_read( store->blockstore );
+  fd_blockstore_slot_end_read( store->blockstore, slot );
   return repair_req_cnt;
 }
@@ -127,6 +127,11 @@ struct fd_txn_m {
       so we just store this redundantly. */
    ushort   txn_t_sz;
 
+   /* A combination of FD_TXN_P_FLAGS_*, populated by the verify tile
+      (currently only FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED) and copied by
+      pack into the fd_txn_p_t. */
+   uint     flags;
+
    /* There are three additional fields at the end here, which are
       variable length and not included in the size of this struct.
    uchar          payload[ ]
@@ -1,8 +1,10 @@
 ifdef FD_HAS_HOSTED
 ifdef FD_HAS_THREADS
 ifdef FD_HAS_LINUX
-$(call add-hdrs,fd_topo.h fd_pod_format.h)
-$(call add-objs,fd_topo fd_topob fd_topo_run,fd_disco)
+$(call add-hdrs,fd_topo.h fd_pod_format.h fd_topo_place.h)
+$(call add-objs,fd_topo fd_topob fd_topo_run fd_topo_place,fd_disco)
+$(call make-unit-test,test_topo_place,test_topo_place,fd_disco fd_tango fd_util)
+$(call run-unit-test,test_topo_place,)
 endif
 endif
 endif
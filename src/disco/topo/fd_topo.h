@@ -272,6 +272,18 @@ typedef struct {
       float cu_price_spread;
     } benchg;
 
+    struct {
+      char  rec_path[ PATH_MAX ];
+      ulong rec_sz;
+      ulong target_tile_id;
+      int   max_rate;
+      ulong loop_cnt;
+    } tbplay;
+
+    struct {
+      ulong target_tile_id;
+    } tbsink;
+
     /* Firedancer-only tile configs */
 
     struct {
@@ -693,6 +705,21 @@ fd_topo_run_single_process( fd_topo_t * topo,
                             fd_topo_run_tile_t (* tile_run )( fd_topo_tile_t * tile ),
                             int *       done_futex );
 
+/* fd_topo_run_single_process_tiles is the same as
+   fd_topo_run_single_process but only starts the tile_cnt tiles whose
+   ids are given in tile_ids.  This is useful for running a tile in
+   isolation (e.g. for benchmarking) with the rest of the topology
+   present in memory but not running. */
+
+void
+fd_topo_run_single_process_tiles( fd_topo_t *   topo,
+                                  ulong         tile_cnt,
+                                  ulong const * tile_ids,
+                                  uint          uid,
+                                  uint          gid,
+                                  fd_topo_run_tile_t (* tile_run )( fd_topo_tile_t * tile ),
+                                  int *         done_futex );
+
 /* fd_topo_run_tile runs the given tile directly within the current
    process (and thread).  The function will never return, as tiles are
    expected to run forever.  An error is logged and the application will
@@ -0,0 +1,277 @@
+#include "fd_topo_place.h"
+#include "fd_topob.h"
+
+#include <math.h>
+
+/* Weight of a producer / consumer edge, in cache lines moved per frag.
+   Every consumer pulls the mcache line from the producer, reliable
+   consumers additionally push their fseq line back. */
+
+#define FLOW_POLL     (1.0)
+#define FLOW_RELIABLE (1.0)
+
+static ulong
+place_idx( fd_topo_place_t const * place,
+           ulong                   tile_id ) {
+  for( ulong i=0UL; i<place->tile_cnt; i++ ) {
+    if( place->tile_id[ i ]==tile_id ) return i;
+  }
+  return ULONG_MAX;
+}
+
+fd_topo_place_t *
+fd_topo_place_init( fd_topo_place_t * place,
+                    fd_topo_t const * topo ) {
+  place->tile_cnt = 0UL;
+  for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
+    if( FD_UNLIKELY( fd_topob_tile_is_floating( topo->tiles[ i ].name ) ) ) continue;
+    place->tile_id[ place->tile_cnt++ ] = i;
+  }
+
+  ulong n = place->tile_cnt;
+  for( ulong i=0UL; i<n; i++ ) {
+    place->slot[ i ] = ULONG_MAX;
+    for( ulong j=0UL; j<n; j++ ) {
+      place->flow [ i ][ j ] = 0.0;
+      place->bytes[ i ][ j ] = 0.0;
+    }
+  }
+  place->cost = 0.0;
+
+  for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
+    fd_topo_tile_t const * producer = &topo->tiles[ i ];
+    ulong p = place_idx( place, i );
+    if( FD_UNLIKELY( p==ULONG_MAX ) ) continue;
+
+    for( ulong k=0UL; k<producer->out_cnt; k++ ) {
+      fd_topo_link_t const * link = &topo->links[ producer->out_link_id[ k ] ];
+      double payload = (double)fd_ulong_min( link->mtu, FD_TOPO_PLACE_PAYLOAD_MAX );
+
+      for( ulong j=0UL; j<topo->tile_cnt; j++ ) {
+        fd_topo_tile_t const * consumer = &topo->tiles[ j ];
+        ulong c = place_idx( place, j );
+        if( FD_UNLIKELY( c==ULONG_MAX || c==p ) ) continue;
+
+        for( ulong l=0UL; l<consumer->in_cnt; l++ ) {
+          if( FD_LIKELY( consumer->in_link_id[ l ]!=link->id ) ) continue;
+          double flow = FLOW_POLL + fd_double_if( consumer->in_link_reliable[ l ], FLOW_RELIABLE, 0.0 );
+          place->flow [ p ][ c ] += flow;
+          place->flow [ c ][ p ] += flow;
+          place->bytes[ p ][ c ] += payload;
+        }
+      }
+    }
+  }
+
+  return place;
+}
+
+/* edge_cost returns the cost of the edges between placed tiles i and j
+   if they were on candidate CPUs a and b. */
+
+static inline double
+edge_cost( fd_topo_place_t const *         place,
+           fd_topo_place_machine_t const * machine,
+           ulong                           i,
+           ulong                           a,
+           ulong                           j,
+           ulong                           b ) {
+  ulong na = machine->cpu_node[ a ];
+  ulong nb = machine->cpu_node[ b ];
+  double cost = place->flow[ i ][ j ] * (double)machine->lat_ns[ a ][ b ];
+  if( place->bytes[ i ][ j ]>0.0 ) cost += place->bytes[ i ][ j ] / (double)machine->bw[ nb ][ na ];
+  if( place->bytes[ j ][ i ]>0.0 ) cost += place->bytes[ j ][ i ] / (double)machine->bw[ na ][ nb ];
+  return cost;
+}
+
+/* tile_cost returns the cost of all edges of placed tile i to other
+   placed tiles if it were on candidate CPU a. */
+
+static double
+tile_cost( fd_topo_place_t const *         place,
+           fd_topo_place_machine_t const * machine,
+           ulong                           i,
+           ulong                           a ) {
+  double cost = 0.0;
+  for( ulong j=0UL; j<place->tile_cnt; j++ ) {
+    ulong b = place->slot[ j ];
+    if( FD_UNLIKELY( j==i || b==ULONG_MAX ) ) continue;
+    cost += edge_cost( place, machine, i, a, j, b );
+  }
+  return cost;
+}
+
+double
+fd_topo_place_cost( fd_topo_place_t const *         place,
+                    fd_topo_place_machine_t const * machine ) {
+  double cost = 0.0;
+  for( ulong i=0UL; i<place->tile_cnt; i++ ) {
+    if( FD_UNLIKELY( place->slot[ i ]==ULONG_MAX ) ) continue;
+    for( ulong j=i+1UL; j<place->tile_cnt; j++ ) {
+      if( FD_UNLIKELY( place->slot[ j ]==ULONG_MAX ) ) continue;
+      cost += edge_cost( place, machine, i, place->slot[ i ], j, place->slot[ j ] );
+    }
+  }
+  return cost;
+}
+
+double
+fd_topo_place_solve( fd_topo_place_t *               place,
+                     fd_topo_place_machine_t const * machine,
+                     ulong                           iter_max ) {
+  ulong n = place->tile_cnt;
+  ulong m = machine->cpu_cnt;
+  if( FD_UNLIKELY( n>m ) ) FD_LOG_ERR(( "The topology has %lu tiles which need a dedicated CPU, but only %lu candidate CPUs are available", n, m ));
+
+  /* Greedy placement.  Tiles are placed in order of decreasing total
+     edge weight, each on the free CPU that minimizes its cost to the
+     tiles already placed.  The first tile has nothing to be close to
+     and goes on the first CPU of the node with the most CPUs, so the
+     heaviest part of the graph has the most room to grow. */
+
+  int    cpu_used[ FD_TOPO_PLACE_CPU_MAX ] = {0};
+  double weight  [ FD_TOPO_MAX_TILES ];
+  ulong  order   [ FD_TOPO_MAX_TILES ];
+  for( ulong i=0UL; i<n; i++ ) {
+    place->slot[ i ] = ULONG_MAX;
+    weight[ i ] = 0.0;
+    for( ulong j=0UL; j<n; j++ ) weight[ i ] += place->flow[ i ][ j ] + place->bytes[ i ][ j ] + place->bytes[ j ][ i ];
+    order[ i ] = i;
+  }
+  for( ulong i=1UL; i<n; i++ ) { /* insertion sort, stable so ties keep topology order */
+    ulong t = order[ i ];
+    ulong j = i;
+    while( j && weight[ order[ j-1UL ] ]<weight[ t ] ) { order[ j ] = order[ j-1UL ]; j--; }
+    order[ j ] = t;
+  }
+
+  ulong node_cpu_cnt[ FD_TOPO_PLACE_NODE_MAX ] = {0};
+  for( ulong a=0UL; a<m; a++ ) node_cpu_cnt[ machine->cpu_node[ a ] ]++;
+  ulong first_node = 0UL;
+  for( ulong k=1UL; k<machine->node_cnt; k++ ) if( node_cpu_cnt[ k ]>node_cpu_cnt[ first_node ] ) first_node = k;
+
+  for( ulong r=0UL; r<n; r++ ) {
+    ulong  i         = order[ r ];
+    ulong  best      = ULONG_MAX;
+    double best_cost = 0.0;
+    for( ulong a=0UL; a<m; a++ ) {
+      if( cpu_used[ a ] ) continue;
+      double cost = r ? tile_cost( place, machine, i, a ) : (double)( machine->cpu_node[ a ]!=first_node );
+      if( best==ULONG_MAX || cost<best_cost ) { best = a; best_cost = cost; }
+    }
+    place->slot[ i ] = best;
+    cpu_used[ best ] = 1;
+  }
+
+  /* Local search.  Each pass tries to move every tile to every free
+     CPU and to swap every pair of tiles, applying any improvement
+     immediately.  Stops once a pass makes no improvement. */
+
+  double eps = 1e-9;
+  for( ulong iter=0UL; iter<iter_max; iter++ ) {
+    int improved = 0;
+
+    for( ulong i=0UL; i<n; i++ ) {
+      ulong  a      = place->slot[ i ];
+      double cost_a = tile_cost( place, machine, i, a );
+      for( ulong b=0UL; b<m; b++ ) {
+        if( cpu_used[ b ] ) continue;
+        double cost_b = tile_cost( place, machine, i, b );
+        if( cost_b<cost_a-eps ) {
+          cpu_used[ a ] = 0; cpu_used[ b ] = 1;
+          place->slot[ i ] = b;
+          a = b; cost_a = cost_b;
+          improved = 1;
+        }
+      }
+    }
+
+    for( ulong i=0UL; i<n; i++ ) {
+      for( ulong j=i+1UL; j<n; j++ ) {
+        ulong a = place->slot[ i ];
+        ulong b = place->slot[ j ];
+
+        double before = tile_cost( place, machine, i, a ) + tile_cost( place, machine, j, b ) - edge_cost( place, machine, i, a, j, b );
+        place->slot[ i ] = b; place->slot[ j ] = a;
+        double after  = tile_cost( place, machine, i, b ) + tile_cost( place, machine, j, a ) - edge_cost( place, machine, i, b, j, a );
+        if( after<before-eps ) improved = 1;
+        else { place->slot[ i ] = a; place->slot[ j ] = b; }
+      }
+    }
+
+    if( !improved ) break;
+  }
+
+  place->cost = fd_topo_place_cost( place, machine );
+  return place->cost;
+}
+
+void
+fd_topo_place_apply( fd_topo_place_t const *         place,
+                     fd_topo_place_machine_t const * machine,
+                     fd_topo_t *                     topo ) {
+  for( ulong i=0UL; i<topo->tile_cnt; i++ ) topo->tiles[ i ].cpu_idx = ULONG_MAX;
+  for( ulong i=0UL; i<place->tile_cnt; i++ ) {
+    if( FD_UNLIKELY( place->slot[ i ]==ULONG_MAX ) ) continue;
+    topo->tiles[ place->tile_id[ i ] ].cpu_idx = machine->cpu_idx[ place->slot[ i ] ];
+  }
+}
+
+static ulong
+machine_slot( fd_topo_place_machine_t const * machine,
+              ulong                           cpu_idx ) {
+  for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+    if( machine->cpu_idx[ a ]==cpu_idx ) return a;
+  }
+  return ULONG_MAX;
+}
+
+ulong
+fd_topo_place_link_depth( fd_topo_t const *               topo,
+                          fd_topo_place_machine_t const * machine,
+                          ulong                           link_id ) {
+  fd_topo_link_t const * link = &topo->links[ link_id ];
+
+  /* The reference is the mean latency between distinct CPUs of the
+     same node, or the smallest latency if there are no such pairs. */
+
+  double ref_sum = 0.0;
+  ulong  ref_cnt = 0UL;
+  double ref_min = 0.0;
+  for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+    for( ulong b=a+1UL; b<machine->cpu_cnt; b++ ) {
+      double lat = (double)machine->lat_ns[ a ][ b ];
+      if( FD_UNLIKELY( lat<=0.0 ) ) continue;
+      if( !ref_min || lat<ref_min ) ref_min = lat;
+      if( machine->cpu_node[ a ]==machine->cpu_node[ b ] ) { ref_sum += lat; ref_cnt++; }
+    }
+  }
+  double ref = ref_cnt ? ref_sum/(double)ref_cnt : ref_min;
+  if( FD_UNLIKELY( ref<=0.0 ) ) return link->depth;
+
+  double lat_max = 0.0;
+  for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
+    fd_topo_tile_t const * producer = &topo->tiles[ i ];
+    ulong p = machine_slot( machine, producer->cpu_idx );
+    if( FD_UNLIKELY( p==ULONG_MAX ) ) continue;
+
+    for( ulong k=0UL; k<producer->out_cnt; k++ ) {
+      if( FD_LIKELY( producer->out_link_id[ k ]!=link_id ) ) continue;
+
+      for( ulong j=0UL; j<topo->tile_cnt; j++ ) {
+        fd_topo_tile_t const * consumer = &topo->tiles[ j ];
+        ulong c = machine_slot( machine, consumer->cpu_idx );
+        if( FD_UNLIKELY( c==ULONG_MAX ) ) continue;
+        for( ulong l=0UL; l<consumer->in_cnt; l++ ) {
+          if( FD_LIKELY( consumer->in_link_id[ l ]!=link_id ) ) continue;
+          lat_max = fmax( lat_max, (double)machine->lat_ns[ p ][ c ] );
+        }
+      }
+    }
+  }
+
+  double ratio = lat_max/ref;
+  if( FD_LIKELY( ratio<1.5 ) ) return link->depth;
+  ulong scale = fd_ulong_min( (ulong)ceil( ratio ), 8UL );
+  return fd_ulong_min( fd_ulong_pow2_up( link->depth*scale ), link->depth*8UL );
+}
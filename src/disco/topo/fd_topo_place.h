@@ -0,0 +1,114 @@
+#ifndef HEADER_fd_src_disco_topo_fd_topo_place_h
+#define HEADER_fd_src_disco_topo_fd_topo_place_h
+
+/* fd_topo_place solves for a tile to CPU assignment of a topology given
+   measurements of the machine it will run on.
+
+   The machine is described by the one way latency of moving a cache
+   line between every pair of candidate CPUs (which captures SMT, L3
+   slice / CCX and socket boundaries without having to model them) and
+   by the read bandwidth between every pair of NUMA nodes.  The
+   topology is reduced to a weighted graph between its non-floating
+   tiles, with one edge per producer / consumer pair of each link.
+
+   The cost of an assignment is the sum, over all edges, of the cache
+   line latencies paid per frag (the mcache line and, for reliable
+   consumers, the fseq line going the other way) and the time to read
+   a typical payload from the producer's NUMA node.  Link workspaces are
+   modeled as living on the NUMA node of the producer.  The solver
+   places tiles greedily, heaviest first, then improves the assignment
+   by moving tiles to free CPUs and swapping pairs of tiles until no
+   move lowers the cost (a local optimum of the quadratic assignment
+   problem, which is NP-hard to solve exactly). */
+
+#include "fd_topo.h"
+
+/* FD_TOPO_PLACE_{CPU,NODE}_MAX bound the number of candidate CPUs and
+   NUMA nodes of a machine. */
+
+#define FD_TOPO_PLACE_CPU_MAX  (256UL)
+#define FD_TOPO_PLACE_NODE_MAX ( 16UL)
+
+/* FD_TOPO_PLACE_PAYLOAD_MAX caps the payload size a link is assumed to
+   carry per frag.  Link MTUs are sized for the worst case, while the
+   typical frag is a packet or a transaction. */
+
+#define FD_TOPO_PLACE_PAYLOAD_MAX (2048UL)
+
+struct fd_topo_place_machine {
+  ulong cpu_cnt;                                  /* number of candidate CPUs */
+  ulong cpu_idx [ FD_TOPO_PLACE_CPU_MAX ];        /* OS index of candidate CPU i */
+  ulong cpu_node[ FD_TOPO_PLACE_CPU_MAX ];        /* NUMA node of candidate CPU i, in [0,node_cnt) */
+  ulong node_cnt;                                 /* number of NUMA nodes */
+
+  float lat_ns[ FD_TOPO_PLACE_CPU_MAX ][ FD_TOPO_PLACE_CPU_MAX ];   /* one way cache line latency between candidate CPUs, symmetric */
+  float bw    [ FD_TOPO_PLACE_NODE_MAX ][ FD_TOPO_PLACE_NODE_MAX ]; /* bytes/ns read by CPUs on node [i] from memory on node [j] */
+};
+typedef struct fd_topo_place_machine fd_topo_place_machine_t;
+
+struct fd_topo_place {
+  ulong  tile_cnt;                                      /* number of tiles being placed */
+  ulong  tile_id[ FD_TOPO_MAX_TILES ];                  /* topology tile id of placed tile i */
+  double flow   [ FD_TOPO_MAX_TILES ][ FD_TOPO_MAX_TILES ]; /* cache lines moved per frag between placed tiles i and j, symmetric */
+  double bytes  [ FD_TOPO_MAX_TILES ][ FD_TOPO_MAX_TILES ]; /* payload bytes per frag produced by i and read by j */
+
+  ulong  slot   [ FD_TOPO_MAX_TILES ];                  /* candidate CPU of placed tile i, ULONG_MAX if not placed */
+  double cost;                                          /* cost of the assignment in slot */
+};
+typedef struct fd_topo_place fd_topo_place_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_topo_place_init reduces topo to the graph of tiles to be placed.
+   Floating tiles (see fd_topob_tile_is_floating) are not placed.  All
+   tiles start out unplaced.  Returns place. */
+
+fd_topo_place_t *
+fd_topo_place_init( fd_topo_place_t * place,
+                    fd_topo_t const * topo );
+
+/* fd_topo_place_cost returns the cost of the current assignment of
+   place on machine.  Edges to unplaced tiles are ignored. */
+
+FD_FN_PURE double
+fd_topo_place_cost( fd_topo_place_t const *         place,
+                    fd_topo_place_machine_t const * machine );
+
+/* fd_topo_place_solve assigns every tile of place a distinct candidate
+   CPU of machine, minimizing the cost.  Performs at most iter_max
+   passes of local search after the greedy placement.  Logs an error
+   and terminates the process if the machine has fewer candidate CPUs
+   than there are tiles to place.  Returns the cost of the assignment,
+   which is also stored in place->cost. */
+
+double
+fd_topo_place_solve( fd_topo_place_t *               place,
+                     fd_topo_place_machine_t const * machine,
+                     ulong                           iter_max );
+
+/* fd_topo_place_apply sets the cpu_idx of every tile in topo according
+   to the assignment in place.  Floating tiles get ULONG_MAX. */
+
+void
+fd_topo_place_apply( fd_topo_place_t const *         place,
+                     fd_topo_place_machine_t const * machine,
+                     fd_topo_t *                     topo );
+
+/* fd_topo_place_link_depth returns the recommended depth of the link
+   with the given id once the tiles of topo are placed on machine (see
+   fd_topo_place_apply).  The credit return loop of a link is bound by
+   the cache line latency between its producer and slowest consumer, so
+   a link crossing a slower boundary than the typical same node pair of
+   CPUs needs proportionally more frags in flight to sustain the same
+   rate.  The current depth is scaled by that ratio, rounded up to a
+   power of two and capped at 8 times the current depth.  Links between
+   floating tiles keep their depth. */
+
+FD_FN_PURE ulong
+fd_topo_place_link_depth( fd_topo_t const *               topo,
+                          fd_topo_place_machine_t const * machine,
+                          ulong                           link_id );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_disco_topo_fd_topo_place_h */
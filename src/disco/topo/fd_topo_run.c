@@ -286,6 +286,26 @@ fd_topo_run_single_process( fd_topo_t * topo,
                             uint        gid,
                             fd_topo_run_tile_t (* tile_run )( fd_topo_tile_t * tile ),
                             int *       done_futex ) {
+  ulong tile_cnt = 0UL;
+  ulong tile_ids[ FD_TOPO_MAX_TILES ];
+  for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
+    fd_topo_tile_t * tile = &topo->tiles[ i ];
+    if( !agave && tile->is_agave ) continue;
+    if( agave==1 && !tile->is_agave ) continue;
+    tile_ids[ tile_cnt++ ] = i;
+  }
+
+  fd_topo_run_single_process_tiles( topo, tile_cnt, tile_ids, uid, gid, tile_run, done_futex );
+}
+
+void
+fd_topo_run_single_process_tiles( fd_topo_t *   topo,
+                                  ulong         tile_cnt,
+                                  ulong const * tile_ids,
+                                  uint          uid,
+                                  uint          gid,
+                                  fd_topo_run_tile_t (* tile_run )( fd_topo_tile_t * tile ),
+                                  int *         done_futex ) {
   /* Save the current affinity, it will be restored after creating any child tiles */
   FD_CPUSET_DECL( floating_cpu_set );
   if( FD_UNLIKELY( fd_cpuset_getaffinity( 0, floating_cpu_set ) ) )
@@ -295,10 +315,9 @@ fd_topo_run_single_process( fd_topo_t * topo,
   int save_priority = getpriority( PRIO_PROCESS, 0 );
   if( FD_UNLIKELY( -1==save_priority && errno ) ) FD_LOG_ERR(( "getpriority() failed (%i-%s)", errno, fd_io_strerror( errno ) ));
 
-  for( ulong i=0UL; i<topo->tile_cnt; i++ ) {
-    fd_topo_tile_t * tile = &topo->tiles[ i ];
-    if( !agave && tile->is_agave ) continue;
-    if( agave==1 && !tile->is_agave ) continue;
+  for( ulong i=0UL; i<tile_cnt; i++ ) {
+    if( FD_UNLIKELY( tile_ids[ i ]>=topo->tile_cnt ) ) FD_LOG_ERR(( "tile id %lu out of range", tile_ids[ i ] ));
+    fd_topo_tile_t * tile = &topo->tiles[ tile_ids[ i ] ];
 
     fd_topo_run_tile_t run_tile = tile_run( tile );
     run_tile_thread( topo, tile, run_tile, uid, gid, done_futex, floating_cpu_set, save_priority );
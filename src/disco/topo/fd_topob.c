@@ -315,12 +315,8 @@ validate( fd_topo_t const * topo ) {
   }
 }
 
-void
-fd_topob_auto_layout( fd_topo_t * topo ) {
-  /* Incredibly simple automatic layout system for now ... just assign
-     tiles to CPU cores in NUMA sequential order, except for a few tiles
-     which should be floating. */
-
+int
+fd_topob_tile_is_floating( char const * tile_name ) {
   char const * FLOATING[] = {
     "metric",
     "cswtch",
@@ -328,6 +324,18 @@ fd_topob_auto_layout( fd_topo_t * topo ) {
     "bhole",  /* FIREDANCER only */
   };
 
+  for( ulong i=0UL; i<sizeof(FLOATING)/sizeof(FLOATING[0]); i++ ) {
+    if( !strcmp( tile_name, FLOATING[ i ] ) ) return 1;
+  }
+  return 0;
+}
+
+void
+fd_topob_auto_layout( fd_topo_t * topo ) {
+  /* Incredibly simple automatic layout system for now ... just assign
+     tiles to CPU cores in NUMA sequential order, except for a few tiles
+     which should be floating. */
+
   char const * ORDERED[] = {
     "benchg",
     "benchs",
@@ -403,15 +411,7 @@ fd_topob_auto_layout( fd_topo_t * topo ) {
     fd_topo_tile_t * tile = &topo->tiles[ i ];
     if( tile->cpu_idx!=ULONG_MAX ) continue;
 
-    int found = 0;
-    for( ulong j=0UL; j<sizeof(FLOATING)/sizeof(FLOATING[0]); j++ ) {
-      if( !strcmp( tile->name, FLOATING[ j ] ) ) {
-        found = 1;
-        break;
-      }
-    }
-
-    if( FD_UNLIKELY( !found ) ) FD_LOG_WARNING(( "auto layout cannot affine tile `%s:%lu` because it is unknown. Leaving it floating", tile->name, tile->kind_id ));
+    if( FD_UNLIKELY( !fd_topob_tile_is_floating( tile->name ) ) ) FD_LOG_WARNING(( "auto layout cannot affine tile `%s:%lu` because it is unknown. Leaving it floating", tile->name, tile->kind_id ));
   }
 
   for( ulong i=cpu_idx; i<num_cpus; i++ ) {
@@ -127,6 +127,14 @@ fd_topob_tile_out( fd_topo_t *  topo,
                    char const * link_name,
                    ulong        link_kind_id );
 
+/* fd_topob_tile_is_floating returns 1 if tiles with the given name
+   are not performance sensitive and should float on the remaining
+   cores rather than get a dedicated one when laying out a topology
+   automatically, and 0 otherwise. */
+
+FD_FN_PURE int
+fd_topob_tile_is_floating( char const * tile_name );
+
 /* Automatically layout the tiles onto CPUs in the topology for a
    best effort. */
 
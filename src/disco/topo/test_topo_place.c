@@ -0,0 +1,101 @@
+#include "fd_topo_place.h"
+#include "fd_topob.h"
+
+static fd_topo_t               topo[1];
+static fd_topo_place_t         place[1];
+static fd_topo_place_machine_t machine[1];
+
+/* A pipeline of tile_cnt tiles, each producing one reliable link into
+   the next, plus a floating metric tile. */
+
+static void
+chain_topo( ulong tile_cnt ) {
+  static char const * NAMES[] = { "t0", "t1", "t2", "t3", "t4", "t5", "t6", "t7" };
+  static char const * LINKS[] = { "t0_t1", "t1_t2", "t2_t3", "t3_t4", "t4_t5", "t5_t6", "t6_t7" };
+
+  fd_topob_new( topo, "test" );
+  fd_topob_wksp( topo, "w" );
+  for( ulong i=0UL; i+1UL<tile_cnt; i++ ) fd_topob_link( topo, LINKS[ i ], "w", 128UL, 1232UL, 1UL );
+  for( ulong i=0UL; i<tile_cnt; i++ ) fd_topob_tile( topo, NAMES[ i ], "w", "w", ULONG_MAX, 0 );
+  fd_topob_tile( topo, "metric", "w", "w", ULONG_MAX, 0 );
+  for( ulong i=0UL; i+1UL<tile_cnt; i++ ) {
+    fd_topob_tile_out( topo, NAMES[ i     ], 0UL,      LINKS[ i ], 0UL );
+    fd_topob_tile_in ( topo, NAMES[ i+1UL ], 0UL, "w", LINKS[ i ], 0UL, FD_TOPOB_RELIABLE, FD_TOPOB_POLLED );
+  }
+}
+
+/* Two NUMA nodes of node_cpu_cnt CPUs each, with node 1 listed first
+   and CPUs of the two nodes interleaved, so the solver can't get lucky
+   by placing tiles in order. */
+
+static void
+two_node_machine( ulong node_cpu_cnt ) {
+  machine->node_cnt = 2UL;
+  machine->cpu_cnt  = 2UL*node_cpu_cnt;
+  for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+    machine->cpu_idx [ a ] = 100UL+a;
+    machine->cpu_node[ a ] = (a+1UL)&1UL;
+  }
+  for( ulong a=0UL; a<machine->cpu_cnt; a++ ) {
+    for( ulong b=0UL; b<machine->cpu_cnt; b++ ) {
+      if(      a==b                                         ) machine->lat_ns[ a ][ b ] =   0.0f;
+      else if( machine->cpu_node[ a ]==machine->cpu_node[ b ] ) machine->lat_ns[ a ][ b ] =  40.0f;
+      else                                                    machine->lat_ns[ a ][ b ] = 120.0f;
+    }
+  }
+  machine->bw[ 0 ][ 0 ] = 10.0f; machine->bw[ 0 ][ 1 ] = 5.0f;
+  machine->bw[ 1 ][ 0 ] =  5.0f; machine->bw[ 1 ][ 1 ] = 10.0f;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  /* A chain that fits on one node must be placed entirely on it */
+
+  chain_topo( 4UL );
+  two_node_machine( 4UL );
+  FD_TEST( fd_topo_place_init( place, topo )==place );
+  FD_TEST( place->tile_cnt==4UL ); /* metric floats */
+  FD_TEST( place->flow [ 0 ][ 1 ]==2.0 && place->flow[ 1 ][ 0 ]==2.0 );
+  FD_TEST( place->bytes[ 0 ][ 1 ]==1232.0 && place->bytes[ 1 ][ 0 ]==0.0 );
+  FD_TEST( place->flow [ 0 ][ 2 ]==0.0 );
+
+  double cost = fd_topo_place_solve( place, machine, 100UL );
+  FD_TEST( cost==place->cost );
+  FD_TEST( cost==fd_topo_place_cost( place, machine ) );
+  FD_TEST( fabs( cost-3.0*(2.0*40.0+1232.0/10.0) )<1e-6 );
+  for( ulong i=1UL; i<4UL; i++ ) FD_TEST( machine->cpu_node[ place->slot[ i ] ]==machine->cpu_node[ place->slot[ 0 ] ] );
+  for( ulong i=0UL; i<4UL; i++ ) for( ulong j=i+1UL; j<4UL; j++ ) FD_TEST( place->slot[ i ]!=place->slot[ j ] );
+
+  fd_topo_place_apply( place, machine, topo );
+  FD_TEST( topo->tiles[ 4 ].cpu_idx==ULONG_MAX );
+  for( ulong i=0UL; i<4UL; i++ ) FD_TEST( topo->tiles[ i ].cpu_idx==machine->cpu_idx[ place->slot[ i ] ] );
+  for( ulong i=0UL; i<topo->link_cnt; i++ ) FD_TEST( fd_topo_place_link_depth( topo, machine, i )==128UL );
+
+  /* A longer chain must cross between the nodes exactly once, and only
+     the crossing link gets a deeper buffer (3x latency -> 4x depth) */
+
+  chain_topo( 6UL );
+  two_node_machine( 3UL );
+  fd_topo_place_init( place, topo );
+  cost = fd_topo_place_solve( place, machine, 100UL );
+  FD_TEST( fabs( cost-( 4.0*(2.0*40.0+1232.0/10.0) + (2.0*120.0+1232.0/5.0) ) )<1e-6 );
+
+  fd_topo_place_apply( place, machine, topo );
+  ulong cross_cnt = 0UL;
+  for( ulong i=0UL; i<topo->link_cnt; i++ ) {
+    int cross = machine->cpu_node[ place->slot[ i ] ]!=machine->cpu_node[ place->slot[ i+1UL ] ];
+    cross_cnt += (ulong)cross;
+    FD_TEST( fd_topo_place_link_depth( topo, machine, i )==( cross ? 512UL : 128UL ) );
+  }
+  FD_TEST( cross_cnt==1UL );
+
+  /* More tiles than CPUs is rejected by fd_topo_place_solve, not
+     tested here as it terminates the process. */
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
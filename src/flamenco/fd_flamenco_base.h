@@ -94,6 +94,9 @@ typedef struct fd_acc_mgr fd_acc_mgr_t;
 struct fd_capture_ctx;
 typedef struct fd_capture_ctx fd_capture_ctx_t;
 
+struct fd_vm_prof;
+typedef struct fd_vm_prof fd_vm_prof_t;
+
 /* fd_rawtxn_b_t is a convenience type to store a pointer to a
    serialized transaction.  Should probably be removed in the future. */
 
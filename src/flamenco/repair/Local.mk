@@ -3,5 +3,6 @@ $(call add-hdrs,fd_repair.h)
 $(call add-objs,fd_repair,fd_flamenco)
 ifdef FD_HAS_HOSTED
 $(call make-bin,fd_repair_tool,fd_repair_tool,fd_flamenco fd_ballet fd_funk fd_util)
+$(call make-unit-test,bench_repair,bench_repair,fd_flamenco fd_ballet fd_util)
 endif
 endif
@@ -0,0 +1,339 @@
+#include "fd_repair.h"
+#include "../fd_flamenco.h"
+
+#if FD_HAS_HOSTED
+
+#include <stdlib.h>
+
+/* bench_repair measures how quickly the repair client catches up on a
+   range of missing slots when served by a simulated set of peers, for
+   several sizes of the per peer window of unanswered requests.
+
+   Time is simulated, so the bench is deterministic and runs much
+   faster than real time.  Each peer has a stake, a round trip time, a
+   probability of losing a request and a service time per request.
+   Requests queue at a peer and are dropped once the peer is more than
+   --queue-max-ms behind, as a rate limiting validator would.  The
+   application asks for the first --ask-max missing shreds every 500ms,
+   mimicking a replay stage waiting on a gap. */
+
+#define PEER_MAX    (64UL)
+#define PENDING_MAX (1UL<<18)
+#define SHRED_MAX   (1UL<<16)
+
+#define PEER_PORT0  (1000U)
+#define PAYLOAD_SZ  (64UL)
+
+struct peer {
+  fd_pubkey_t           id;
+  fd_repair_peer_addr_t addr;
+  ulong                 stake;
+  long                  rtt;
+  float                 loss;
+  long                  svc;
+  long                  busy;     /* Time the peer is done with its queue */
+  ulong                 req_cnt;  /* Requests received */
+  ulong                 rep_cnt;  /* Responses sent */
+};
+typedef struct peer peer_t;
+
+struct pending {
+  long  due;
+  ulong peer_idx;
+  ulong slot;
+  uint  shred_idx;
+  uint  nonce;
+};
+typedef struct pending pending_t;
+
+static peer_t    peers[ PEER_MAX ];
+static ulong     peer_cnt;
+static pending_t pending[ PENDING_MAX ];
+static ulong     pending_cnt;
+static uchar     have[ SHRED_MAX ];
+static ulong     have_cnt;
+
+static ulong     slot0;
+static ulong     slot_cnt;
+static ulong     shred_cnt;
+static long      queue_max;
+static ulong     ask_max;
+static long      now;
+static fd_rng_t  rng[1];
+
+static ulong     highest_need_cnt; /* Calls to fd_repair_need_highest_window_index */
+static ulong     highest_send_cnt; /* Highest window index requests put on the wire */
+static ulong     deliver_cnt;      /* Responses accepted by repair */
+
+static void
+sign_fun( void * ctx, uchar * sig, uchar const * buffer, ulong len, int sign_type ) {
+  (void)ctx; (void)buffer; (void)len; (void)sign_type;
+  fd_memset( sig, 0, 64UL );
+}
+
+static void
+deliver_fun( fd_shred_t const * shred, ulong shred_len, fd_repair_peer_addr_t const * from, fd_pubkey_t const * id, void * arg ) {
+  (void)shred_len; (void)from; (void)id; (void)arg;
+  deliver_cnt++;
+  ulong off = ( shred->slot - slot0 )*shred_cnt + shred->idx;
+  if( off<slot_cnt*shred_cnt && !have[ off ] ) {
+    have[ off ] = 1;
+    have_cnt++;
+  }
+}
+
+static void
+deliver_fail_fun( fd_pubkey_t const * id, ulong slot, uint shred_index, void * arg, int reason ) {
+  (void)id; (void)arg;
+  FD_LOG_WARNING(( "repair request failed: slot %lu, idx %u, reason %d", slot, shred_index, reason ));
+}
+
+/* Client requests land at the simulated peer addressed by port */
+
+static void
+clnt_send_fun( uchar const * msg, size_t msglen, fd_repair_peer_addr_t const * addr, void * arg ) {
+  (void)arg;
+  ulong peer_idx = (ulong)fd_ushort_bswap( addr->port ) - PEER_PORT0;
+  FD_TEST( peer_idx<peer_cnt );
+  peer_t * peer = &peers[ peer_idx ];
+
+  FD_SCRATCH_SCOPE_BEGIN {
+    fd_repair_protocol_t protocol;
+    fd_bincode_decode_ctx_t ctx = { .data = msg, .dataend = msg + msglen, .valloc = fd_scratch_virtual() };
+    FD_TEST( !fd_repair_protocol_decode( &protocol, &ctx ) );
+
+    ulong slot;
+    uint  shred_idx;
+    uint  nonce;
+    switch( protocol.discriminant ) {
+    case fd_repair_protocol_enum_window_index:
+      slot      = protocol.inner.window_index.slot;
+      shred_idx = (uint)protocol.inner.window_index.shred_index;
+      nonce     = protocol.inner.window_index.header.nonce;
+      break;
+    case fd_repair_protocol_enum_highest_window_index:
+      highest_send_cnt++;
+      slot      = protocol.inner.highest_window_index.slot;
+      shred_idx = (uint)shred_cnt-1U;
+      nonce     = protocol.inner.highest_window_index.header.nonce;
+      break;
+    default:
+      FD_LOG_ERR(( "unexpected repair request type %u", protocol.discriminant ));
+    }
+
+    peer->req_cnt++;
+    if( fd_rng_float_robust( rng )<peer->loss ) return;
+    long start = fd_long_max( peer->busy, now );
+    if( start-now>queue_max ) return;
+    if( pending_cnt==PENDING_MAX ) return;
+    peer->busy = start + peer->svc;
+    pending[ pending_cnt++ ] = (pending_t){ .due = peer->busy + peer->rtt, .peer_idx = peer_idx, .slot = slot, .shred_idx = shred_idx, .nonce = nonce };
+  } FD_SCRATCH_SCOPE_END;
+}
+
+static void
+respond( fd_repair_t * repair, pending_t const * p ) {
+  uchar buf[ FD_SHRED_DATA_HEADER_SZ + PAYLOAD_SZ + sizeof(uint) ];
+  fd_memset( buf, 0, sizeof(buf) );
+  fd_shred_t * shred = (fd_shred_t *)buf;
+  shred->signature[ 0 ]  = 0xff; /* so it doesn't decode as a ping */
+  shred->variant         = 0xa5; /* legacy data */
+  shred->slot            = p->slot;
+  shred->idx             = p->shred_idx;
+  shred->data.parent_off = (ushort)1;
+  shred->data.size       = (ushort)( FD_SHRED_DATA_HEADER_SZ + PAYLOAD_SZ );
+  FD_STORE( uint, buf + FD_SHRED_DATA_HEADER_SZ + PAYLOAD_SZ, p->nonce );
+
+  /* Responses with the right nonce but from another address or for
+     another shred must not be accepted */
+  ulong deliver_cnt0 = deliver_cnt;
+  fd_repair_peer_addr_t spoof = peers[ p->peer_idx ].addr;
+  spoof.port = fd_ushort_bswap( (ushort)( PEER_PORT0 + peer_cnt ) );
+  FD_TEST( !fd_repair_recv_clnt_packet( repair, buf, sizeof(buf), &spoof ) );
+  shred->slot++;
+  FD_TEST( !fd_repair_recv_clnt_packet( repair, buf, sizeof(buf), &peers[ p->peer_idx ].addr ) );
+  shred->slot--;
+  FD_TEST( deliver_cnt==deliver_cnt0 );
+
+  peers[ p->peer_idx ].rep_cnt++;
+  FD_TEST( !fd_repair_recv_clnt_packet( repair, buf, sizeof(buf), &peers[ p->peer_idx ].addr ) );
+}
+
+static void
+peers_init( ulong cnt ) {
+  peer_cnt = cnt;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    peer_t * peer = &peers[ i ];
+    fd_memset( peer, 0, sizeof(peer_t) );
+    for( ulong j=0UL; j<4UL; j++ ) peer->id.ul[ j ] = fd_rng_ulong( rng );
+    peer->addr.addr = FD_IP4_ADDR( 127, 0, 0, 1 );
+    peer->addr.port = fd_ushort_bswap( (ushort)( PEER_PORT0 + i ) );
+    /* A few big stakers, a long tail and some unstaked RPC nodes */
+    peer->stake = fd_rng_uint_roll( rng, 4U ) ? ( 1UL<<fd_rng_uint_roll( rng, 24U ) )*(ulong)1e9 : 0UL;
+    peer->rtt   = (long)5e6 + (long)fd_rng_ulong_roll( rng, (ulong)195e6 );
+    peer->loss  = 0.3f*fd_rng_float_robust( rng );
+    peer->svc   = (long)50e3 + (long)fd_rng_ulong_roll( rng, (ulong)950e3 );
+  }
+  peers[ 0 ].loss = 1.0f; /* one peer never answers */
+}
+
+static void
+bench( fd_repair_t * repair,
+       void *        shmem,
+       ulong         inflight_max,
+       long          limit ) {
+  fd_repair_t * r = fd_repair_join( fd_repair_new( shmem, 42UL ) );
+  FD_TEST( r==repair );
+
+  fd_pubkey_t self = { .ul = { 1UL, 2UL, 3UL, 4UL } };
+  fd_repair_config_t config;
+  fd_memset( &config, 0, sizeof(config) );
+  config.public_key              = &self;
+  config.intake_addr.addr        = FD_IP4_ADDR( 127, 0, 0, 1 );
+  config.intake_addr.port        = fd_ushort_bswap( 999 );
+  config.deliver_fun             = deliver_fun;
+  config.deliver_fail_fun        = deliver_fail_fun;
+  config.clnt_send_fun           = clnt_send_fun;
+  config.sign_fun                = sign_fun;
+  config.good_peer_cache_file_fd = -1;
+  config.peer_inflight_max       = inflight_max;
+  FD_TEST( !fd_repair_set_config( repair, &config ) );
+
+  fd_stake_weight_t stake_weights[ PEER_MAX ];
+  for( ulong i=0UL; i<peer_cnt; i++ ) {
+    peers[ i ].busy    = 0L;
+    peers[ i ].req_cnt = 0UL;
+    peers[ i ].rep_cnt = 0UL;
+    stake_weights[ i ].key   = peers[ i ].id;
+    stake_weights[ i ].stake = peers[ i ].stake;
+    FD_TEST( !fd_repair_add_active_peer( repair, &peers[ i ].addr, &peers[ i ].id ) );
+    fd_repair_add_sticky( repair, &peers[ i ].id );
+  }
+  fd_repair_set_stake_weights( repair, stake_weights, peer_cnt );
+
+  pending_cnt      = 0UL;
+  have_cnt         = 0UL;
+  highest_need_cnt = 0UL;
+  highest_send_cnt = 0UL;
+  fd_memset( have, 0, sizeof(have) );
+
+  now = 0L;
+  fd_repair_settime( repair, now );
+  FD_TEST( !fd_repair_start( repair ) );
+
+  ulong total    = slot_cnt*shred_cnt;
+  long  step     = (long)250e3;
+  long  last_ask = -(long)1e9;
+  while( have_cnt<total && now<limit ) {
+    now += step;
+
+    for( ulong i=0UL; i<pending_cnt; ) {
+      if( pending[ i ].due<=now ) {
+        fd_repair_settime( repair, pending[ i ].due );
+        respond( repair, &pending[ i ] );
+        pending[ i ] = pending[ --pending_cnt ];
+      } else {
+        i++;
+      }
+    }
+
+    fd_repair_settime( repair, now );
+    if( now-last_ask>=(long)500e6 ) {
+      ulong ask_cnt = 0UL;
+      for( ulong s=0UL; s<slot_cnt; s++ ) {
+        ulong got = 0UL;
+        for( ulong i=0UL; i<shred_cnt; i++ ) {
+          if( have[ s*shred_cnt+i ] ) { got++; continue; }
+          if( ask_cnt<ask_max ) {
+            fd_repair_need_window_index( repair, slot0+s, (uint)i );
+            ask_cnt++;
+          }
+        }
+        /* Ask for the tail of each incomplete slot at a few growing
+           indices, which repair coalesces into one request per slot */
+        for( ulong i=0UL; got<shred_cnt && i<4UL; i++ ) {
+          fd_repair_need_highest_window_index( repair, slot0+s, (uint)( got+i ) );
+          highest_need_cnt++;
+        }
+      }
+      last_ask = now;
+    }
+    fd_repair_continue( repair );
+  }
+
+  /* Share of responses served by the peers with below median round
+     trip time, to show that the scheduler leans on fast peers */
+  ulong req_tot = 0UL;
+  ulong rep_tot = 0UL;
+  ulong rep_fast = 0UL;
+  long  rtts[ PEER_MAX ];
+  for( ulong i=0UL; i<peer_cnt; i++ ) rtts[ i ] = peers[ i ].rtt;
+  for( ulong i=1UL; i<peer_cnt; i++ ) for( ulong j=i; j && rtts[ j-1UL ]>rtts[ j ]; j-- ) fd_swap( rtts[ j-1UL ], rtts[ j ] );
+  long rtt_med = rtts[ peer_cnt/2UL ];
+  for( ulong i=0UL; i<peer_cnt; i++ ) {
+    req_tot += peers[ i ].req_cnt;
+    rep_tot += peers[ i ].rep_cnt;
+    if( peers[ i ].rtt<rtt_med ) rep_fast += peers[ i ].rep_cnt;
+  }
+
+  FD_LOG_NOTICE(( "inflight_max %4lu: %s %lu/%lu shreds in %7.3f s, %8lu requests (%5.2f per shred), fast peers served %5.1f%%, dead peer got %lu requests, %lu highest requests for %lu asks",
+                  inflight_max, have_cnt==total ? "repaired" : "TIMEOUT ", have_cnt, total, 1e-9*(double)now,
+                  req_tot, (double)req_tot/(double)total, 100.0*(double)rep_fast/(double)fd_ulong_max( rep_tot, 1UL ),
+                  peers[ 0 ].req_cnt, highest_send_cnt, highest_need_cnt ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot         ( &argc, &argv );
+  fd_flamenco_boot( &argc, &argv );
+
+  ulong cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--peer-cnt",     NULL,   32UL );
+  slot_cnt        = fd_env_strip_cmdline_ulong( &argc, &argv, "--slot-cnt",     NULL,   16UL );
+  shred_cnt       = fd_env_strip_cmdline_ulong( &argc, &argv, "--shred-cnt",    NULL,  512UL );
+  queue_max       = (long)fd_env_strip_cmdline_ulong( &argc, &argv, "--queue-max-ms", NULL, 100UL )*(long)1e6;
+  ask_max         = fd_env_strip_cmdline_ulong( &argc, &argv, "--ask-max",      NULL, 4096UL );
+  long limit      = (long)fd_env_strip_cmdline_ulong( &argc, &argv, "--limit-s",      NULL, 120UL )*(long)1e9;
+  slot0           = 1000UL;
+
+  if( FD_UNLIKELY( !cnt || cnt>PEER_MAX               ) ) FD_LOG_ERR(( "--peer-cnt must be in [1,%lu]", PEER_MAX ));
+  if( FD_UNLIKELY( !shred_cnt || slot_cnt*shred_cnt>SHRED_MAX ) ) FD_LOG_ERR(( "--slot-cnt * --shred-cnt must be in [1,%lu]", SHRED_MAX ));
+
+  FD_LOG_NOTICE(( "--peer-cnt %lu --slot-cnt %lu --shred-cnt %lu --queue-max-ms %ld --ask-max %lu", cnt, slot_cnt, shred_cnt, queue_max/(long)1e6, ask_max ));
+
+  static uchar smem[ 1UL<<22 ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+  static ulong fmem[ 16UL ];
+  fd_scratch_attach( smem, fmem, sizeof(smem), 16UL );
+
+  fd_rng_join( fd_rng_new( rng, 1234U, 0UL ) );
+  peers_init( cnt );
+
+  void * shmem = aligned_alloc( fd_repair_align(), fd_ulong_align_up( fd_repair_footprint(), fd_repair_align() ) );
+  FD_TEST( shmem );
+  fd_repair_t * repair = (fd_repair_t *)shmem;
+
+  static ulong const windows[] = { 1UL, 4UL, 16UL, 64UL, 256UL };
+  for( ulong i=0UL; i<sizeof(windows)/sizeof(windows[0]); i++ ) bench( repair, shmem, windows[ i ], limit );
+
+  fd_repair_delete( fd_repair_leave( repair ) );
+  free( shmem );
+  fd_scratch_detach( NULL );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_flamenco_halt();
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
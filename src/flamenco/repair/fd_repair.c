@@ -31,6 +31,17 @@
 #define FD_PING_PRE_IMAGE_SZ (48UL)
 /* Number of peers to send requests to. */
 #define FD_REPAIR_NUM_NEEDED_PEERS (4)
+/* Round trip time assumed for a peer that has not answered yet */
+#define FD_REPAIR_RTT_INIT ((long)100e6)
+/* Lower bound on the round trip time used to weigh peers */
+#define FD_REPAIR_RTT_MIN ((long)1e6)
+/* Fixed point one for the peer success rate */
+#define FD_REPAIR_SUCCESS_ONE (1U<<16)
+/* Time after which an unanswered request no longer counts against the
+   window of its peer */
+#define FD_REPAIR_INFLIGHT_TIMEOUT ((long)500e6)
+/* Minimum time between resending a request for the same shred */
+#define FD_REPAIR_RESEND_INTERVAL ((long)200e6)
 
 /* Test if two hash values are equal */
 static int fd_hash_eq( const fd_hash_t * key1, const fd_hash_t * key2 ) {
@@ -85,6 +96,9 @@ struct fd_active_elem {
     uchar permanent;
     long  first_request_time;
     ulong stake;
+    long  ewma_rtt; /* Exponentially weighted round trip time, 0 until the first response */
+    uint  success;  /* Exponentially weighted response rate in units of FD_REPAIR_SUCCESS_ONE */
+    uint  inflight; /* Number of requests sent that are not yet answered or expired */
 };
 /* Active table */
 typedef struct fd_active_elem fd_active_elem_t;
@@ -111,6 +125,8 @@ struct fd_dupdetect_elem {
   fd_dupdetect_key_t key;
   long               last_send_time;
   uint               req_cnt;
+  uint               highest;  /* Largest shred index asked for by coalesced highest window index requests */
+  int                answered; /* A response arrived since the request was last made */
   ulong              next;
 };
 typedef struct fd_dupdetect_elem fd_dupdetect_elem_t;
@@ -155,6 +171,7 @@ struct fd_needed_elem {
   fd_pubkey_t id;
   fd_dupdetect_key_t dupkey;
   long when;
+  int  inflight; /* Sent and not yet answered, counted in the peer's inflight */
 };
 typedef struct fd_needed_elem fd_needed_elem_t;
 #define MAP_NAME     fd_needed_table
@@ -213,6 +230,10 @@ struct fd_repair {
     fd_pubkey_t actives_sticky[FD_REPAIR_STICKY_MAX]; /* cache of chosen repair peer samples */
     ulong       actives_sticky_cnt;
     ulong       actives_random_seed;
+    double      actives_cdf[FD_REPAIR_STICKY_MAX]; /* cumulative sampling weight of actives_sticky */
+    int         actives_cdf_dirty;                 /* actives_cdf must be recomputed before sampling */
+    /* Max number of unanswered requests per peer */
+    ulong peer_inflight_max;
     /* Duplicate request detection table */
     fd_dupdetect_elem_t * dupdetect;
     /* Table of needed shreds */
@@ -220,10 +241,13 @@ struct fd_repair {
     fd_repair_nonce_t oldest_nonce;
     fd_repair_nonce_t current_nonce;
     fd_repair_nonce_t next_nonce;
+    fd_repair_nonce_t timeout_nonce; /* Oldest sent request that may still be in flight */
     /* Table of validator clients that we have pinged */
     fd_pinged_elem_t * pinged;
     /* Last batch of sends */
     long last_sends;
+    /* Last update of peer sampling weights */
+    long last_weigh;
     /* Last statistics decay */
     long last_decay;
     /* Last statistics printout */
@@ -239,6 +263,8 @@ struct fd_repair {
     fd_stake_weight_t * stake_weights;
     /* Path to the file where we write the cache of known good repair peers, to make cold booting faster */
     int good_peer_cache_file_fd;
+    /* Responses dropped for not parsing or not answering their request */
+    ulong bad_resp_cnt;
 };
 
 ulong
@@ -273,14 +299,17 @@ fd_repair_new ( void * shmem, ulong seed ) {
   glob->stake_weights = FD_SCRATCH_ALLOC_APPEND( l, fd_stake_weight_align(), FD_STAKE_WEIGHTS_MAX * fd_stake_weight_footprint() );
   glob->stake_weights_cnt = 0;
   glob->last_sends = 0;
+  glob->last_weigh = 0;
   glob->last_decay = 0;
   glob->last_print = 0;
   glob->last_good_peer_cache_file_write = 0;
-  glob->oldest_nonce = glob->current_nonce = glob->next_nonce = 0;
+  glob->oldest_nonce = glob->current_nonce = glob->next_nonce = glob->timeout_nonce = 0;
   fd_rng_new(glob->rng, (uint)seed, 0UL);
 
   glob->actives_sticky_cnt   = 0;
   glob->actives_random_seed  = 0;
+  glob->actives_cdf_dirty    = 1;
+  glob->peer_inflight_max    = FD_REPAIR_PEER_INFLIGHT_DEFAULT;
 
   ulong scratch_top = FD_SCRATCH_ALLOC_FINI(l, 1UL);
   if ( scratch_top > (ulong)shmem + fd_repair_footprint() ) {
@@ -354,6 +383,7 @@ fd_repair_set_config( fd_repair_t * glob, const fd_repair_config_t * config ) {
   glob->sign_arg = config->sign_arg;
   glob->deliver_fail_fun = config->deliver_fail_fun;
   glob->good_peer_cache_file_fd = config->good_peer_cache_file_fd;
+  glob->peer_inflight_max = config->peer_inflight_max ? config->peer_inflight_max : FD_REPAIR_PEER_INFLIGHT_DEFAULT;
   return 0;
 }
 
@@ -392,6 +422,9 @@ fd_repair_add_active_peer( fd_repair_t * glob, fd_repair_peer_addr_t const * add
     val->first_request_time = 0;
     val->permanent = 0;
     val->stake = 0UL;
+    val->ewma_rtt = 0L;
+    val->success = FD_REPAIR_SUCCESS_ONE/2U;
+    val->inflight = 0U;
     FD_LOG_DEBUG(( "adding repair peer %s", FD_BASE58_ENC_32_ALLOCA( val->key.uc ) ));
   }
   fd_repair_unlock( glob );
@@ -458,6 +491,36 @@ fd_repair_sign_and_send( fd_repair_t *           glob,
   (*glob->clnt_send_fun)( buf, buflen, addr, glob->fun_arg );
 }
 
+/* Update the scheduling statistics of a peer for a request that was
+   answered (rtt is the round trip time) or expired unanswered
+   (rtt<0).  The round trip time and the success rate are exponentially
+   weighted with a factor of 1/8. */
+static void
+fd_repair_peer_settle( fd_active_elem_t * peer, long rtt ) {
+  if( FD_LIKELY( peer->inflight ) ) peer->inflight--;
+  if( rtt<0L ) {
+    peer->success -= peer->success>>3U;
+    return;
+  }
+  peer->success += (FD_REPAIR_SUCCESS_ONE - peer->success)>>3U;
+  if( FD_UNLIKELY( !peer->ewma_rtt ) ) peer->ewma_rtt = fd_long_max( rtt, 1L );
+  else                                 peer->ewma_rtt += (rtt - peer->ewma_rtt)/8L;
+}
+
+static fd_active_elem_t * actives_sample( fd_repair_t * repair );
+
+/* Sample a peer that has room in its window of unanswered requests.
+   Returns NULL if none of a few samples has room. */
+static fd_active_elem_t *
+actives_sample_with_room( fd_repair_t * repair ) {
+  for( ulong i=0UL; i<2UL*FD_REPAIR_NUM_NEEDED_PEERS; i++ ) {
+    fd_active_elem_t * peer = actives_sample( repair );
+    if( !peer ) return NULL;
+    if( peer->inflight < repair->peer_inflight_max ) return peer;
+  }
+  return NULL;
+}
+
 static void
 fd_repair_send_requests( fd_repair_t * glob ) {
   /* Garbage collect old requests */
@@ -470,6 +533,10 @@ fd_repair_send_requests( fd_repair_t * glob ) {
     if (ele->when > expire)
       break;
     // (*glob->deliver_fail_fun)( &ele->key, ele->slot, ele->shred_index, glob->fun_arg, FD_REPAIR_DELIVER_FAIL_TIMEOUT );
+    if( ele->inflight ) {
+      fd_active_elem_t * active = fd_active_table_query( glob->actives, &ele->id, NULL );
+      if( active ) fd_repair_peer_settle( active, -1L );
+    }
     fd_dupdetect_elem_t * dup = fd_dupdetect_table_query( glob->dupdetect, &ele->dupkey, NULL );
     if( dup && --dup->req_cnt == 0) {
       fd_dupdetect_table_remove( glob->dupdetect, &ele->dupkey );
@@ -478,7 +545,32 @@ fd_repair_send_requests( fd_repair_t * glob ) {
   }
   glob->oldest_nonce = n;
 
-  /* Send requests starting where we left off last time */
+  /* Stop waiting on requests that have been in flight for too long.
+     Their window slot is freed and the peer is charged a failure, but
+     a late response is still delivered.  Requests are sent in nonce
+     order, so the walk stops at the first one still in time. */
+  long timeout = glob->now - FD_REPAIR_INFLIGHT_TIMEOUT;
+  fd_repair_nonce_t t = glob->timeout_nonce;
+  if ( (int)(t - glob->oldest_nonce) < 0 )
+    t = glob->oldest_nonce;
+  for ( ; (int)(t - glob->current_nonce) < 0; ++t ) {
+    fd_needed_elem_t * ele = fd_needed_table_query( glob->needed, &t, NULL );
+    if ( NULL == ele )
+      continue;
+    if (ele->when > timeout)
+      break;
+    if( ele->inflight ) {
+      fd_active_elem_t * active = fd_active_table_query( glob->actives, &ele->id, NULL );
+      if( active ) fd_repair_peer_settle( active, -1L );
+      ele->inflight = 0;
+    }
+  }
+  glob->timeout_nonce = t;
+
+  /* Send requests starting where we left off last time.  A request
+     for a peer whose window is full is handed to another peer with
+     room.  If none has room, stop and resume from here once responses
+     or expiries open up the windows again. */
   if ( (int)(n - glob->current_nonce) < 0 )
     n = glob->current_nonce;
   ulong j = 0;
@@ -490,21 +582,31 @@ fd_repair_send_requests( fd_repair_t * glob ) {
       continue;
 
     if(j == 128U) break;
-    ++j;
-
-    /* Track statistics */
-    ele->when = glob->now;
 
+    /* Drop requests to peers we no longer know, requests already
+       answered by another peer while this one waited for a window, and
+       requests that waited so long they would be garbage collected */
     fd_active_elem_t * active = fd_active_table_query( glob->actives, &ele->id, NULL );
-    if ( active == NULL) {
-      fd_dupdetect_elem_t * dup = fd_dupdetect_table_query( glob->dupdetect, &ele->dupkey, NULL );
+    fd_dupdetect_elem_t * dup = fd_dupdetect_table_query( glob->dupdetect, &ele->dupkey, NULL );
+    if ( active == NULL || ( dup && dup->answered ) || ele->when <= expire ) {
       if( dup && --dup->req_cnt == 0) {
         fd_dupdetect_table_remove( glob->dupdetect, &ele->dupkey );
       }
       fd_needed_table_remove( glob->needed, &n );
       continue;
     }
-    
+
+    if( active->inflight >= glob->peer_inflight_max ) {
+      active = actives_sample_with_room( glob );
+      if( !active ) break;
+      fd_hash_copy( &ele->id, &active->key );
+    }
+    ++j;
+
+    /* Track statistics */
+    ele->when = glob->now;
+    ele->inflight = 1;
+    active->inflight++;
     active->avg_reqs++;
 
     fd_repair_protocol_t protocol;
@@ -530,7 +632,8 @@ fd_repair_send_requests( fd_repair_t * glob ) {
         wi->header.timestamp = glob->now/1000000L;
         wi->header.nonce = n;
         wi->slot = ele->dupkey.slot;
-        wi->shred_index = ele->dupkey.shred_index;
+        /* Requests for the slot are coalesced, ask for the highest index */
+        wi->shred_index = dup ? dup->highest : ele->dupkey.shred_index;
         break;
       }
 
@@ -687,6 +790,7 @@ fd_read_in_good_peer_cache_file( fd_repair_t * repair ) {
 int
 fd_repair_start( fd_repair_t * glob ) {
   glob->last_sends = glob->now;
+  glob->last_weigh = glob->now;
   glob->last_decay = glob->now;
   glob->last_print = glob->now;
   return fd_read_in_good_peer_cache_file( glob );
@@ -705,6 +809,10 @@ fd_repair_continue( fd_repair_t * glob ) {
     fd_repair_send_requests( glob );
     glob->last_sends = glob->now;
   }
+  if ( glob->now - glob->last_weigh > (long)100e6 ) { /* 100 milliseconds */
+    glob->actives_cdf_dirty = 1;
+    glob->last_weigh = glob->now;
+  }
   if ( glob->now - glob->last_print > (long)30e9 ) { /* 30 seconds */
     fd_repair_print_all_stats( glob );
     glob->last_print = glob->now;
@@ -753,6 +861,21 @@ fd_repair_recv_ping(fd_repair_t * glob, fd_gossip_ping_t const * ping, fd_gossip
   (*glob->clnt_send_fun)(buf, buflen, from, glob->fun_arg);
 }
 
+/* Test if a shred answers a request.  Window index requests name the
+   exact shred.  Highest window index requests are answered with the
+   highest shred the peer has in the slot, which is at least the index
+   asked for.  Orphan requests are answered with shreds from the slot or
+   its ancestors. */
+static int
+fd_repair_resp_matches( fd_dupdetect_key_t const * key, fd_shred_t const * shred ) {
+  switch( key->type ) {
+  case fd_needed_window_index:         return shred->slot==key->slot && shred->idx==key->shred_index;
+  case fd_needed_highest_window_index: return shred->slot==key->slot && shred->idx>=key->shred_index;
+  case fd_needed_orphan:               return shred->slot<=key->slot;
+  }
+  return 0;
+}
+
 int
 fd_repair_recv_clnt_packet(fd_repair_t * glob, uchar const * msg, ulong msglen, fd_gossip_peer_addr_t const * from) {
   fd_repair_lock( glob );
@@ -799,20 +922,40 @@ fd_repair_recv_clnt_packet(fd_repair_t * glob, uchar const * msg, ulong msglen,
       return 0;
     }
 
+    /* A response only counts once it is known to answer the request:
+       it has to parse, carry the shred that was asked for and come from
+       the peer it was asked of.  Otherwise anyone who sees a nonce could
+       settle requests and suppress the resend of a shred we still lack. */
+    fd_shred_t const * shred = fd_shred_parse(msg, shredlen);
+    if (shred == NULL) {
+      glob->bad_resp_cnt++;
+      fd_repair_unlock( glob );
+      FD_LOG_WARNING(("invalid shread"));
+      return 0;
+    }
+
     fd_active_elem_t * active = fd_active_table_query( glob->actives, &val->id, NULL );
+    if( !fd_repair_resp_matches( &val->dupkey, shred ) ||
+        ( NULL != active && !fd_repair_peer_addr_eq( &active->addr, from ) ) ) {
+      glob->bad_resp_cnt++;
+      fd_repair_unlock( glob );
+      FD_LOG_DEBUG(( "dropping repair response for slot %lu, idx %u that does not match its request", shred->slot, shred->idx ));
+      return 0;
+    }
+
     if ( NULL != active ) {
       /* Update statistics */
       active->avg_reps++;
       active->avg_lat += glob->now - val->when;
+      /* Only the first response to a request frees its window slot */
+      if( val->inflight ) fd_repair_peer_settle( active, glob->now - val->when );
     }
+    val->inflight = 0;
+    fd_dupdetect_elem_t * dup = fd_dupdetect_table_query( glob->dupdetect, &val->dupkey, NULL );
+    if( dup ) dup->answered = 1;
 
-    fd_shred_t const * shred = fd_shred_parse(msg, shredlen);
     fd_repair_unlock( glob );
-    if (shred == NULL) {
-      FD_LOG_WARNING(("invalid shread"));
-    } else {
-      (*glob->deliver_fun)(shred, shredlen, from, &val->id, glob->fun_arg);
-    }
+    (*glob->deliver_fun)(shred, shredlen, from, &val->id, glob->fun_arg);
   } FD_SCRATCH_SCOPE_END;
   return 0;
 }
@@ -962,6 +1105,7 @@ fd_actives_shuffle( fd_repair_t * repair ) {
       repair->actives_random_seed = seed;
     }
     repair->actives_sticky_cnt = tot_cnt;
+    repair->actives_cdf_dirty  = 1;
 
     FD_LOG_NOTICE(
         ( "selected %lu (previously: %lu) peers for repair (best was %lu, good was %lu, leftovers was %lu) (nonce_diff: %u)",
@@ -975,13 +1119,53 @@ fd_actives_shuffle( fd_repair_t * repair ) {
   FD_SCRATCH_SCOPE_END;
 }
 
+/* Sampling weight of a peer.  Peers are preferred in proportion to
+   their response rate and inversely to their round trip time, so that
+   a peer answering twice as fast gets twice the requests.  Stake gives
+   a logarithmic boost, as staked validators are more likely to have
+   the shreds and to stay up. */
+static double
+fd_repair_peer_weight( fd_active_elem_t const * peer ) {
+  long   rtt     = peer->ewma_rtt ? peer->ewma_rtt : FD_REPAIR_RTT_INIT;
+  double success = (double)fd_uint_max( peer->success, FD_REPAIR_SUCCESS_ONE/64U ) / (double)FD_REPAIR_SUCCESS_ONE;
+  double stake   = 1.0 + log2( 1.0 + (double)peer->stake/1e9 )/8.0;
+  return success*stake*1e6 / (double)fd_long_max( rtt, FD_REPAIR_RTT_MIN );
+}
+
+static void
+fd_actives_weigh( fd_repair_t * repair ) {
+  double tot = 0.0;
+  for( ulong i=0UL; i<repair->actives_sticky_cnt; i++ ) {
+    fd_active_elem_t * peer = fd_active_table_query( repair->actives, &repair->actives_sticky[i], NULL );
+    if( FD_LIKELY( peer ) ) tot += fd_repair_peer_weight( peer );
+    repair->actives_cdf[i] = tot;
+  }
+  repair->actives_cdf_dirty = 0;
+}
+
 static fd_active_elem_t *
 actives_sample( fd_repair_t * repair ) {
-  ulong seed = repair->actives_random_seed;
-  ulong actives_sticky_cnt = repair->actives_sticky_cnt;
-  while( actives_sticky_cnt ) {
-    seed += 774583887101UL;
-    fd_pubkey_t *      id   = &repair->actives_sticky[seed % actives_sticky_cnt];
+  while( repair->actives_sticky_cnt ) {
+    ulong cnt = repair->actives_sticky_cnt;
+    if( repair->actives_cdf_dirty ) fd_actives_weigh( repair );
+
+    /* Find the first peer whose cumulative weight exceeds a uniform
+       draw over the total weight */
+    ulong  idx = 0UL;
+    double tot = repair->actives_cdf[cnt-1UL];
+    if( FD_UNLIKELY( tot<=0.0 ) ) {
+      idx = fd_rng_ulong_roll( repair->rng, cnt );
+    } else {
+      double r  = fd_rng_double_o( repair->rng )*tot;
+      ulong  hi = cnt-1UL;
+      while( idx<hi ) {
+        ulong mid = (idx+hi)>>1;
+        if( repair->actives_cdf[mid]>r ) hi  = mid;
+        else                             idx = mid+1UL;
+      }
+    }
+
+    fd_pubkey_t *      id   = &repair->actives_sticky[idx];
     fd_active_elem_t * peer = fd_active_table_query( repair->actives, id, NULL );
     if( NULL != peer ) {
       if( peer->first_request_time == 0U ) peer->first_request_time = repair->now;
@@ -989,12 +1173,12 @@ actives_sample( fd_repair_t * repair ) {
       if( peer->permanent ||
           repair->now - peer->first_request_time < (long)5e9 || /* Sample the peer for at least 5 seconds */
           is_good_peer( peer ) != -1 ) {
-        repair->actives_random_seed = seed;
         return peer;
       }
       peer->sticky = 0;
     }
-    *id = repair->actives_sticky[--( actives_sticky_cnt )];
+    *id = repair->actives_sticky[--repair->actives_sticky_cnt];
+    repair->actives_cdf_dirty = 1;
   }
   return NULL;
 }
@@ -1002,49 +1186,64 @@ actives_sample( fd_repair_t * repair ) {
 static int
 fd_repair_create_needed_request( fd_repair_t * glob, int type, ulong slot, uint shred_index ) {
   fd_repair_lock( glob );
+
+  /* Highest window index requests are keyed by slot alone, so that
+     requests for the same slot coalesce into one asking for the
+     highest index needed so far. */
+  fd_dupdetect_key_t dupkey = { .type = (enum fd_needed_elem_type)type, .slot = slot,
+                                .shred_index = type==fd_needed_highest_window_index ? 0U : shred_index };
+  fd_dupdetect_elem_t * dupelem = fd_dupdetect_table_query( glob->dupdetect, &dupkey, NULL );
+  if( dupelem != NULL ) {
+    if( type==fd_needed_highest_window_index ) dupelem->highest = fd_uint_max( dupelem->highest, shred_index );
+    if( glob->now - dupelem->last_send_time < FD_REPAIR_RESEND_INTERVAL ) {
+      fd_repair_unlock( glob );
+      return 0;
+    }
+  }
+
+  /* Spread the request over distinct peers */
   fd_pubkey_t * ids[FD_REPAIR_NUM_NEEDED_PEERS] = {0};
-  uint found_peer = 0;
-  uint peer_cnt = fd_uint_min( (uint)glob->actives_sticky_cnt, FD_REPAIR_NUM_NEEDED_PEERS );
-  for( ulong i=0UL; i<peer_cnt; i++ ) {
+  uint peer_cnt = 0;
+  uint want_cnt = fd_uint_min( (uint)glob->actives_sticky_cnt, FD_REPAIR_NUM_NEEDED_PEERS );
+  for( ulong i=0UL; i<2UL*FD_REPAIR_NUM_NEEDED_PEERS && peer_cnt<want_cnt; i++ ) {
     fd_active_elem_t * peer = actives_sample( glob );
-    if(!peer) continue;
-    found_peer = 1;
-
-    ids[i] = &peer->key;
+    if(!peer) break;
+    uint dup = 0;
+    for( uint k=0; k<peer_cnt; k++ ) dup |= (uint)fd_hash_eq( ids[k], &peer->key );
+    if( dup ) continue;
+    ids[peer_cnt++] = &peer->key;
   }
-  
-  if (!found_peer) {
+
+  if (!peer_cnt) {
     FD_LOG_DEBUG( ( "failed to find a good peer." ) );
     fd_repair_unlock( glob );
     return -1;
   };
 
-  fd_dupdetect_key_t dupkey = { .type = (enum fd_needed_elem_type)type, .slot = slot, .shred_index = shred_index };
-  fd_dupdetect_elem_t * dupelem = fd_dupdetect_table_query( glob->dupdetect, &dupkey, NULL );
-  if( dupelem == NULL ) {
-    dupelem = fd_dupdetect_table_insert( glob->dupdetect, &dupkey );
-    dupelem->last_send_time = 0L;
-  } else if( ( dupelem->last_send_time+(long)200e6 )<glob->now ) {
-    fd_repair_unlock( glob );
-    return 0;
-  }
-
-  dupelem->last_send_time = glob->now;
-  dupelem->req_cnt = peer_cnt;
-
-  if (fd_needed_table_is_full(glob->needed)) {
+  if (fd_needed_table_key_cnt(glob->needed) + peer_cnt > fd_needed_table_key_max(glob->needed) ||
+      (dupelem == NULL && fd_dupdetect_table_is_full(glob->dupdetect))) {
     fd_repair_unlock( glob );
     FD_LOG_NOTICE(("table full"));
     ( *glob->deliver_fail_fun )(ids[0], slot, shred_index, glob->fun_arg, FD_REPAIR_DELIVER_FAIL_REQ_LIMIT_EXCEEDED );
     return -1;
   }
+
+  if( dupelem == NULL ) {
+    dupelem = fd_dupdetect_table_insert( glob->dupdetect, &dupkey );
+    dupelem->req_cnt = 0;
+    dupelem->highest = shred_index;
+  }
+  dupelem->last_send_time = glob->now;
+  dupelem->answered = 0;
   for( ulong i=0UL; i<peer_cnt; i++ ) {
     fd_repair_nonce_t key = glob->next_nonce++;
     fd_needed_elem_t * val = fd_needed_table_insert(glob->needed, &key);
     fd_hash_copy(&val->id, ids[i]);
     val->dupkey = dupkey;
     val->when = glob->now;
+    val->inflight = 0;
   }
+  dupelem->req_cnt += peer_cnt;
   fd_repair_unlock( glob );
   return 0;
 }
@@ -1133,11 +1332,14 @@ print_stats( fd_active_elem_t * val ) {
   else if( val->avg_reps == 0 )
     FD_LOG_DEBUG(( "repair peer %s: avg_requests=%lu, no responses received, stake=%lu", FD_BASE58_ENC_32_ALLOCA( id ), val->avg_reqs, val->stake / (ulong)1e9 ));
   else
-    FD_LOG_DEBUG(( "repair peer %s: avg_requests=%lu, response_rate=%f, latency=%f, stake=%lu",
+    FD_LOG_DEBUG(( "repair peer %s: avg_requests=%lu, response_rate=%f, latency=%f, rtt=%f, success=%f, inflight=%u, stake=%lu",
                     FD_BASE58_ENC_32_ALLOCA( id ),
                     val->avg_reqs,
                     ((double)val->avg_reps)/((double)val->avg_reqs),
                     1.0e-9*((double)val->avg_lat)/((double)val->avg_reps),
+                    1.0e-9*((double)val->ewma_rtt),
+                    ((double)val->success)/((double)FD_REPAIR_SUCCESS_ONE),
+                    val->inflight,
                     val->stake / (ulong)1e9 ));
 }
 
@@ -1150,12 +1352,13 @@ fd_repair_print_all_stats( fd_repair_t * glob ) {
     if( !val->sticky ) continue;
     print_stats( val );
   }
-  FD_LOG_INFO( ( "peer count: %lu", fd_active_table_key_cnt( glob->actives ) ) );
+  FD_LOG_INFO( ( "peer count: %lu, bad responses: %lu", fd_active_table_key_cnt( glob->actives ), glob->bad_resp_cnt ) );
 }
 
 void fd_repair_add_sticky( fd_repair_t * glob, fd_pubkey_t const * id ) {
   fd_repair_lock( glob );
   glob->actives_sticky[glob->actives_sticky_cnt++] = *id;
+  glob->actives_cdf_dirty = 1;
   fd_repair_unlock( glob );
 }
 
@@ -11,6 +11,12 @@
 /* Maximum size of a network packet */
 #define FD_REPAIR_MAX_PACKET_SIZE 1232
 
+/* Default bound on the number of requests sent to a single peer that
+   have not yet been answered or timed out.  Requests are pipelined to
+   a peer up to this bound, beyond which they are handed to another
+   peer or held back until the peer catches up. */
+#define FD_REPAIR_PEER_INFLIGHT_DEFAULT (64UL)
+
 /* Scratch space is used by the repair library to allocate an
    active element table and to shuffle that table.
    TODO: update comment to reflect the reasoning behind
@@ -60,6 +66,7 @@ struct fd_repair_config {
     fd_repair_sign_fun sign_fun;
     void * sign_arg;
     int good_peer_cache_file_fd;
+    ulong peer_inflight_max; /* max unanswered requests per peer, 0 for FD_REPAIR_PEER_INFLIGHT_DEFAULT */
 };
 typedef struct fd_repair_config fd_repair_config_t;
 
@@ -97,6 +104,9 @@ int fd_repair_is_full( fd_repair_t * glob );
 /* Register a request for a shred */
 int fd_repair_need_window_index( fd_repair_t * glob, ulong slot, uint shred_index );
 
+/* Register a request for the highest shred of a slot at or above
+   shred_index.  Outstanding requests for the same slot are coalesced
+   into a single request for the largest shred_index asked for. */
 int fd_repair_need_highest_window_index( fd_repair_t * glob, ulong slot, uint shred_index );
 
 int fd_repair_need_orphan( fd_repair_t * glob, ulong slot );
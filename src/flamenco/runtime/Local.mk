@@ -53,6 +53,8 @@ ifdef FD_HAS_ATOMIC
 
 ifdef FD_HAS_HOSTED
 $(call make-unit-test,test_archive_block,test_archive_block, fd_flamenco fd_util fd_ballet,$(SECP256K1_LIBS))
+$(call make-unit-test,test_blockstore_concur,test_blockstore_concur,fd_flamenco fd_ballet fd_util,$(SECP256K1_LIBS))
+$(call run-unit-test,test_blockstore_concur,)
 # TODO: Flakes
 # $(call run-unit-test,test_txncache,)
 endif
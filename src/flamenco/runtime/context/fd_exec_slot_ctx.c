@@ -90,8 +90,13 @@ fd_exec_slot_ctx_delete( void * mem ) {
   fd_bincode_destroy_ctx_t ctx = { .valloc = hdr->valloc };
   fd_slot_bank_destroy(&hdr->slot_bank, &ctx);
 
-  fd_valloc_free( hdr->valloc, fd_sysvar_cache_delete( hdr->sysvar_cache ) );
-  hdr->sysvar_cache = NULL;
+  if( hdr->sysvar_cache_store && fd_sysvar_cache_store_owns( hdr->sysvar_cache_store, hdr->sysvar_cache ) ) {
+    fd_sysvar_cache_store_release( hdr->sysvar_cache_store, hdr->sysvar_cache );
+  } else {
+    fd_valloc_free( hdr->valloc, fd_sysvar_cache_delete( hdr->sysvar_cache ) );
+  }
+  hdr->sysvar_cache       = NULL;
+  hdr->sysvar_cache_store = NULL;
 
   FD_COMPILER_MFENCE();
   FD_VOLATILE( hdr->magic ) = 0UL;
@@ -100,6 +105,14 @@ fd_exec_slot_ctx_delete( void * mem ) {
   return mem;
 }
 
+fd_sysvar_cache_t *
+fd_exec_slot_ctx_sysvar_cache_modify( fd_exec_slot_ctx_t * ctx ) {
+  if( ctx->sysvar_cache_store ) {
+    ctx->sysvar_cache = fd_sysvar_cache_store_modify( ctx->sysvar_cache_store, ctx->sysvar_cache, ctx->valloc );
+  }
+  return ctx->sysvar_cache;
+}
+
 /* recover_clock recovers PoH/wallclock synchronization.  Walks all vote
    accounts in current epoch stakes. */
 
@@ -6,7 +6,7 @@
 #include "../../../util/rng/fd_rng.h"
 #include "../../../util/wksp/fd_wksp.h"
 
-#include "../sysvar/fd_sysvar_cache.h"
+#include "../sysvar/fd_sysvar_cache_store.h"
 #include "../../types/fd_types.h"
 #include "../fd_txncache.h"
 
@@ -45,8 +45,14 @@ struct __attribute__((aligned(8UL))) fd_exec_slot_ctx {
   ulong                       total_compute_units_used;
 
   fd_sysvar_cache_t *         sysvar_cache;
+  fd_sysvar_cache_store_t *   sysvar_cache_store; /* Optional external join.  If non-NULL,
+                                                     sysvar_cache may be a shared, read-only
+                                                     cache owned by this store.  See
+                                                     fd_exec_slot_ctx_sysvar_cache_modify. */
 
   fd_txncache_t *             status_cache;
+  fd_vm_prof_t *              vm_prof;      /* Optional external join, NULL if programs are not
+                                               profiled.  See fd_vm_prof. */
   fd_slot_history_t           slot_history[1];
 
   int                         enable_exec_recording; /* Enable/disable execution metadata
@@ -110,6 +116,15 @@ fd_exec_slot_ctx_recover_status_cache( fd_exec_slot_ctx_t *   ctx,
                                        fd_bank_slot_deltas_t * slot_deltas );
 
 
+/* fd_exec_slot_ctx_sysvar_cache_modify returns ctx's sysvar cache for
+   modification.  If ctx->sysvar_cache is shared with other slot
+   contexts via ctx->sysvar_cache_store, replaces it with a private copy
+   first.  Must be called before any in-place update of the sysvar
+   cache. */
+
+fd_sysvar_cache_t *
+fd_exec_slot_ctx_sysvar_cache_modify( fd_exec_slot_ctx_t * ctx );
+
 /* Free all allocated memory within a slot ctx */
 void
 fd_exec_slot_ctx_free(fd_exec_slot_ctx_t * ctx);
@@ -272,6 +272,42 @@ fd_acc_mgr_modify( fd_acc_mgr_t *          acc_mgr,
   return FD_ACC_MGR_SUCCESS;
 }
 
+ulong
+fd_acc_mgr_prefetch( fd_acc_mgr_t const *  acc_mgr,
+                     fd_funk_txn_t const * txn,
+                     fd_pubkey_t const *   pubkey,
+                     ulong                 cnt ) {
+  fd_funk_t * funk = acc_mgr->funk;
+  fd_wksp_t * wksp = fd_funk_wksp( funk );
+
+  ulong found_cnt = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_funk_rec_key_t     id  = fd_acc_funk_key( pubkey+i );
+    fd_funk_rec_t const * rec = fd_funk_rec_query_global( funk, txn, &id, NULL );
+    if( FD_UNLIKELY( !rec || !rec->val_gaddr || !rec->val_sz ) ) continue;
+    found_cnt++;
+
+    uchar const * val = fd_funk_val_const( rec, wksp );
+    ulong         sz  = fd_ulong_min( rec->val_sz, rec->val_max );
+
+    /* The meta is at the head of the value and the data follows it */
+
+    for( ulong off=0UL; off<fd_ulong_min( sz, 256UL ); off+=64UL ) __builtin_prefetch( val+off, 0, 3 );
+
+    /* Touch every page of the value such that a non-resident page
+       faults here rather than on the thread executing the transaction
+       (software prefetches are dropped on a page fault).  This does not
+       need any syscall and thus works in sandboxed tiles. */
+
+    if( acc_mgr->page_in ) {
+      for( ulong off=0UL; off<sz; off+=FD_SHMEM_NORMAL_PAGE_SZ ) (void)FD_VOLATILE_CONST( val[ off ] );
+      (void)FD_VOLATILE_CONST( val[ sz-1UL ] );
+    }
+  }
+
+  return found_cnt;
+}
+
 FD_FN_CONST char const *
 fd_acc_mgr_strerror( int err ) {
   switch( err ) {
@@ -56,6 +56,12 @@ struct __attribute__((aligned(16UL))) fd_acc_mgr {
 
   uchar skip_rent_rewrites : 1;
 
+  /* page_in controls whether fd_acc_mgr_prefetch faults in the pages
+     of account values (useful when funk is backed by a file that might
+     not be resident). */
+
+  uchar page_in : 1;
+
   uint is_locked;
 };
 
@@ -260,6 +266,27 @@ fd_acc_mgr_save_many_tpool( fd_acc_mgr_t *           acc_mgr,
                             ulong                    accounts_cnt,
                             fd_tpool_t *             tpool );
 
+/* fd_acc_mgr_prefetch warms up the accounts pubkey[i] for i in
+   [0,cnt) for upcoming view/modify calls against txn.  The records are
+   resolved as seen from txn (i.e. on txn's fork), the account meta and
+   the head of the account data are software prefetched and, if
+   acc_mgr->page_in is set, every page of the account value is touched
+   such that a cold account is paged in by the caller instead of by the
+   thread that later executes the transaction (this can block on I/O).
+   Does not modify funk and has the same concurrency requirements as
+   fd_acc_mgr_view_raw: the caller must ensure that no other thread is
+   writing to txn (or inserting records that could alias the queried
+   ones) during the call.  In particular, this must not overlap with the
+   execution of transactions on txn that touch these accounts.
+   Accounts that don't exist are ignored.  Returns the number of
+   accounts found. */
+
+ulong
+fd_acc_mgr_prefetch( fd_acc_mgr_t const *  acc_mgr,
+                     fd_funk_txn_t const * txn,
+                     fd_pubkey_t const *   pubkey,
+                     ulong                 cnt );
+
 void
 fd_acc_mgr_lock( fd_acc_mgr_t * acc_mgr );
 
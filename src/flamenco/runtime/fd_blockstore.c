@@ -38,12 +38,14 @@ fd_blockstore_new( void * shmem,
 
   fd_memset( blockstore, 0, fd_blockstore_footprint( shred_max, block_max, idx_max, txn_max ) );
 
-  int lg_idx_max = fd_ulong_find_msb( fd_ulong_pow2_up( idx_max ) );
+  int   lg_idx_max      = fd_ulong_find_msb( fd_ulong_pow2_up( idx_max ) );
+  ulong shard_chain_cnt = fd_blockstore_shard_chain_cnt( shred_max );
+  ulong shard_map_sz    = fd_buf_shred_map_footprint( shard_chain_cnt );
 
   FD_SCRATCH_ALLOC_INIT( l, shmem );
   blockstore        = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_blockstore_t),  sizeof(fd_blockstore_t) );
   void * shred_pool = FD_SCRATCH_ALLOC_APPEND( l, fd_buf_shred_pool_align(), fd_buf_shred_pool_footprint( shred_max ) );
-  void * shred_map  = FD_SCRATCH_ALLOC_APPEND( l, fd_buf_shred_map_align(),  fd_buf_shred_map_footprint( shred_max ) );
+  void * shred_map  = FD_SCRATCH_ALLOC_APPEND( l, fd_buf_shred_map_align(),  FD_BLOCKSTORE_SHARD_CNT*shard_map_sz );
   void * block_map  = FD_SCRATCH_ALLOC_APPEND( l, fd_block_map_align(),      fd_block_map_footprint( block_max ) );
   void * block_idx  = FD_SCRATCH_ALLOC_APPEND( l, fd_block_idx_align(),      fd_block_idx_footprint( lg_idx_max ) );
   void * slot_deque = FD_SCRATCH_ALLOC_APPEND( l, fd_slot_deque_align(),     fd_slot_deque_footprint( block_max ) );
@@ -57,6 +59,8 @@ fd_blockstore_new( void * shmem,
 
   FD_COMPILER_MFENCE();
   fd_rwseq_new( &blockstore->lock );
+  fd_rwseq_new( &blockstore->shred_pool_lock );
+  for( ulong i = 0; i < FD_BLOCKSTORE_SHARD_CNT; i++ ) fd_rwseq_new( &blockstore->shard[i].lock );
   FD_COMPILER_MFENCE();
 
   blockstore->archiver = (fd_blockstore_archiver_t){
@@ -71,13 +75,19 @@ fd_blockstore_new( void * shmem,
   blockstore->hcs = FD_SLOT_NULL;
   blockstore->smr = FD_SLOT_NULL;
 
+  blockstore->orphan_cnt = 0;
+
   blockstore->shred_max = shred_max;
   blockstore->block_max = block_max;
   blockstore->idx_max   = idx_max;
   blockstore->txn_max   = txn_max;
 
   blockstore->shred_pool_gaddr = fd_wksp_gaddr( wksp, fd_buf_shred_pool_join( fd_buf_shred_pool_new( shred_pool, shred_max ) ) );
-  blockstore->shred_map_gaddr  = fd_wksp_gaddr( wksp, fd_buf_shred_map_join( fd_buf_shred_map_new( shred_map, shred_max, seed ) ) );
+  for( ulong i = 0; i < FD_BLOCKSTORE_SHARD_CNT; i++ ) {
+    void * shard_map = (void *)( (ulong)shred_map + i*shard_map_sz );
+    blockstore->shard[i].shred_map_gaddr = fd_wksp_gaddr( wksp, fd_buf_shred_map_join( fd_buf_shred_map_new( shard_map, shard_chain_cnt, seed ) ) );
+    FD_TEST( blockstore->shard[i].shred_map_gaddr );
+  }
   blockstore->block_map_gaddr  = fd_wksp_gaddr( wksp, fd_block_map_join( fd_block_map_new( block_map, block_max, seed ) ) );
   blockstore->block_idx_gaddr  = fd_wksp_gaddr( wksp, fd_block_idx_join( fd_block_idx_new( block_idx, lg_idx_max ) ) );
   blockstore->slot_deque_gaddr = fd_wksp_gaddr( wksp, fd_slot_deque_join (fd_slot_deque_new( slot_deque, block_max ) ) );
@@ -85,7 +95,6 @@ fd_blockstore_new( void * shmem,
   blockstore->alloc_gaddr      = fd_wksp_gaddr( wksp, fd_alloc_join (fd_alloc_new( alloc, wksp_tag ), wksp_tag ) );
 
   FD_TEST( blockstore->shred_pool_gaddr );
-  FD_TEST( blockstore->shred_map_gaddr  );
   FD_TEST( blockstore->block_map_gaddr  );
   FD_TEST( blockstore->block_idx_gaddr  );
   FD_TEST( blockstore->slot_deque_gaddr );
@@ -136,7 +145,9 @@ fd_blockstore_leave( fd_blockstore_t * blockstore ) {
   }
 
   FD_TEST( fd_buf_shred_pool_leave( fd_blockstore_shred_pool( blockstore ) ) );
-  FD_TEST( fd_buf_shred_map_leave( fd_blockstore_shred_map( blockstore ) ) );
+  for( ulong i = 0; i < FD_BLOCKSTORE_SHARD_CNT; i++ ) {
+    FD_TEST( fd_buf_shred_map_leave( fd_blockstore_shred_map( blockstore, i ) ) );
+  }
   FD_TEST( fd_block_map_leave( fd_blockstore_block_map( blockstore ) ) );
   FD_TEST( fd_block_idx_leave( fd_blockstore_block_idx( blockstore ) ) );
   FD_TEST( fd_slot_deque_leave( fd_blockstore_slot_deque( blockstore ) ) );
@@ -174,7 +185,9 @@ fd_blockstore_delete( void * shblockstore ) {
   /* Delete all structures. */
 
   FD_TEST( fd_buf_shred_pool_delete( fd_blockstore_shred_pool( blockstore ) ) );
-  FD_TEST( fd_buf_shred_map_delete( fd_blockstore_shred_map( blockstore ) ) );
+  for( ulong i = 0; i < FD_BLOCKSTORE_SHARD_CNT; i++ ) {
+    FD_TEST( fd_buf_shred_map_delete( fd_blockstore_shred_map( blockstore, i ) ) );
+  }
   FD_TEST( fd_block_map_delete( fd_blockstore_block_map( blockstore ) ) );
   FD_TEST( fd_block_idx_delete( fd_blockstore_block_idx( blockstore ) ) );
   FD_TEST( fd_slot_deque_delete( fd_blockstore_slot_deque( blockstore ) ) );
@@ -619,7 +632,7 @@ fd_blockstore_slot_remove( fd_blockstore_t * blockstore, ulong slot ) {
 
     /* Remove buf_shreds if there's no block yet (we haven't received all shreds). */
 
-    fd_buf_shred_map_t * map  = fd_blockstore_shred_map( blockstore );
+    fd_buf_shred_map_t * map  = fd_blockstore_shred_map( blockstore, slot );
     fd_buf_shred_t *     pool = fd_blockstore_shred_pool( blockstore );
     for( uint idx = 0; idx < block_map_entry->received_idx; idx++ ) {
       fd_shred_key_t key = { .slot = slot, .idx = idx };
@@ -672,7 +685,7 @@ fd_blockstore_buffered_shreds_remove( fd_blockstore_t * blockstore, ulong slot )
   fd_block_map_t * block_map_entry = fd_block_map_query( block_map, &slot, NULL );
   if( FD_UNLIKELY( !block_map_entry ) ) return FD_BLOCKSTORE_OK;
   fd_buf_shred_t *     shred_pool = fd_blockstore_shred_pool( blockstore );
-  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore );
+  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore, slot );
   ulong                       shred_cnt  = block_map_entry->complete_idx + 1;
   for( uint i = 0; i < shred_cnt; i++ ) {
     fd_shred_key_t          key = { .slot = slot, .idx = i };
@@ -983,7 +996,7 @@ deshred( fd_blockstore_t * blockstore, ulong slot ) {
 
 
   fd_buf_shred_t *     shred_pool = fd_blockstore_shred_pool( blockstore );
-  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore );
+  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore, slot );
 
   ulong block_sz  = 0UL;
   ulong shred_cnt = block_map_entry->complete_idx + 1;
@@ -1152,22 +1165,193 @@ is_eqvoc_fec( fd_shred_t * old, fd_shred_t const * new ) {
   return 0;
 }
 
+/* is_child_unlinked returns 1 if the slot of block_map_entry is missing
+   from its parent's child slots, 0 otherwise (including if the parent
+   is unknown).  Caller holds at least the read lock. */
+
+static int
+is_child_unlinked( fd_blockstore_t * blockstore, fd_block_map_t const * block_map_entry ) {
+  fd_block_map_t const * parent_block_map_entry = fd_blockstore_block_map_query( blockstore, block_map_entry->parent_slot );
+  if( FD_UNLIKELY( !parent_block_map_entry ) ) return 0;
+  for( ulong i = 0; i < parent_block_map_entry->child_slot_cnt; i++ ) {
+    if( FD_LIKELY( parent_block_map_entry->child_slots[i] == block_map_entry->slot ) ) return 0;
+  }
+  return 1;
+}
+
+/* link_child adds the slot of block_map_entry to its parent's child
+   slots if not already there.  Caller holds the write lock. */
+
+static void
+link_child( fd_blockstore_t * blockstore, fd_block_map_t const * block_map_entry ) {
+  if( FD_LIKELY( !is_child_unlinked( blockstore, block_map_entry ) ) ) return;
+  fd_block_map_t * parent_block_map_entry = fd_blockstore_block_map_query( blockstore, block_map_entry->parent_slot );
+  if( FD_UNLIKELY( parent_block_map_entry->child_slot_cnt == FD_BLOCKSTORE_CHILD_SLOT_MAX )) {
+    FD_LOG_ERR(( "failed to add slot %lu to parent %lu's children. exceeding child slot max",
+                  block_map_entry->slot,
+                  parent_block_map_entry->slot ));
+  }
+  parent_block_map_entry->child_slots[parent_block_map_entry->child_slot_cnt++] = block_map_entry->slot;
+}
+
+/* block_map_entry_insert creates the block map entry for the slot of
+   shred if it does not exist yet.  Caller holds the write lock. */
+
+static int
+block_map_entry_insert( fd_blockstore_t * blockstore, fd_shred_t const * shred ) {
+  ulong            slot            = shred->slot;
+  fd_block_map_t * block_map       = fd_blockstore_block_map( blockstore );
+  fd_block_map_t * block_map_entry = fd_block_map_query( block_map, &slot, NULL );
+  if( FD_UNLIKELY( block_map_entry ) ) return FD_BLOCKSTORE_OK;
+
+  if( FD_UNLIKELY( fd_block_map_key_cnt( block_map ) == fd_block_map_key_max( block_map ) ) ) {
+    FD_LOG_ERR(( "[%s] OOM: failed to insert new block map entry. blockstore needs to save metadata for all slots >= SMR, so increase memory or check for issues with publishing new SMRs.", __func__ ));
+  }
+
+  /* Try to insert slot into block_map */
+
+  block_map_entry = fd_block_map_insert( block_map, &slot );
+  if( FD_UNLIKELY( !block_map_entry ) ) return FD_BLOCKSTORE_ERR_SLOT_FULL;
+
+  /* Initialize the block_map_entry. Note some fields are initialized
+     to dummy values because we do not have all the necessary metadata
+     yet. */
+
+  block_map_entry->slot = block_map_entry->slot;
+
+  block_map_entry->parent_slot = shred->slot - shred->data.parent_off;
+  memset( block_map_entry->child_slots, UCHAR_MAX, FD_BLOCKSTORE_CHILD_SLOT_MAX * sizeof(ulong) );
+  block_map_entry->child_slot_cnt = 0;
+
+  block_map_entry->height         = 0;
+  block_map_entry->block_hash     = ( fd_hash_t ){ 0 };
+  block_map_entry->bank_hash      = ( fd_hash_t ){ 0 };
+  block_map_entry->flags          = fd_uchar_set_bit( 0, FD_BLOCK_FLAG_RECEIVING );
+  block_map_entry->ts             = 0;
+  block_map_entry->reference_tick = (uchar)( (int)shred->data.flags &
+                                             (int)FD_SHRED_DATA_REF_TICK_MASK );
+  block_map_entry->consumed_idx   = UINT_MAX;
+  block_map_entry->received_idx   = 0;
+  block_map_entry->complete_idx   = UINT_MAX;
+
+  block_map_entry->block_gaddr    = 0;
+
+  /* Adopt the orphans waiting on this slot, dropping any that have
+     since been removed from the block map. */
+
+  ulong orphan_cnt = 0;
+  for( ulong i = 0; i < blockstore->orphan_cnt; i++ ) {
+    fd_block_map_t const * orphan = fd_block_map_query_const( block_map, &blockstore->orphan_slot[i], NULL );
+    if( FD_UNLIKELY( !orphan ) ) continue;
+    if( FD_UNLIKELY( orphan->parent_slot == slot ) ) {
+      link_child( blockstore, orphan );
+      continue;
+    }
+    blockstore->orphan_slot[orphan_cnt++] = blockstore->orphan_slot[i];
+  }
+  blockstore->orphan_cnt = orphan_cnt;
+
+  /* Link slot to its parent, or remember it as an orphan if the parent
+     has no entry yet.  An orphan that does not fit links itself on its
+     next buf_shred_publish instead. */
+
+  if( FD_LIKELY( fd_block_map_query_const( block_map, &block_map_entry->parent_slot, NULL ) ) ) {
+    link_child( blockstore, block_map_entry );
+  } else if( FD_LIKELY( blockstore->orphan_cnt < FD_BLOCKSTORE_ORPHAN_MAX ) ) {
+    blockstore->orphan_slot[blockstore->orphan_cnt++] = slot;
+  }
+
+  return FD_BLOCKSTORE_OK;
+}
+
+/* buf_shred_publish does the part of a shred insert that modifies
+   structures shared by all slots: adding slot to its parent's child
+   slots and assembling the block once all shreds have been received.
+   Both are idempotent, as another inserter may have gotten here first
+   or the slot may have been removed since the caller's shard critical
+   section.  Caller holds the write lock. */
+
+static int
+buf_shred_publish( fd_blockstore_t * blockstore, ulong slot ) {
+  fd_block_map_t * block_map_entry = fd_blockstore_block_map_query( blockstore, slot );
+  if( FD_UNLIKELY( !block_map_entry ) ) return FD_BLOCKSTORE_OK;
+
+  /* Add this slot to its parent's child slots if not already there. */
+
+  link_child( blockstore, block_map_entry );
+
+  if( FD_LIKELY( block_map_entry->block_gaddr != 0 ||
+                 block_map_entry->consumed_idx == UINT_MAX ||
+                 block_map_entry->consumed_idx != block_map_entry->complete_idx ) ) {
+    return FD_BLOCKSTORE_OK;
+  }
+
+  /* Received all shreds, so try to assemble a block. */
+  FD_LOG_DEBUG(( "received all shreds for slot %lu - now building a block", slot ));
+
+  int rc = deshred( blockstore, slot );
+  switch( rc ) {
+  case FD_BLOCKSTORE_OK:
+    return FD_BLOCKSTORE_OK_SLOT_COMPLETE;
+  case FD_BLOCKSTORE_ERR_SLOT_FULL:
+    FD_LOG_DEBUG(( "already deshredded slot %lu. ignoring.", slot ));
+    return FD_BLOCKSTORE_OK;
+  case FD_BLOCKSTORE_ERR_DESHRED_INVALID:
+    FD_LOG_DEBUG(( "failed to deshred slot %lu. ignoring.", slot ));
+    return FD_BLOCKSTORE_OK;
+  default:
+    /* FIXME */
+    FD_LOG_ERR(( "deshred err %d", rc ));
+  }
+}
+
 int
 fd_buf_shred_insert( fd_blockstore_t * blockstore, fd_shred_t const * shred ) {
   FD_LOG_DEBUG(( "[%s] slot %lu idx %u", __func__, shred->slot, shred->idx ));
 
-  /* Check this shred > SMR. We ignore shreds before the SMR because by
-     it is invariant that we must have a connected, linear chain for the
-     SMR and its ancestors. */
+  ulong            slot = shred->slot;
+  fd_block_map_t * block_map_entry;
+
+  /* Look up the shred's slot meta under the read lock, escalating to the
+     write lock to create it for the first shred of a slot. */
+
+  for(;;) {
+    fd_blockstore_start_read( blockstore );
+
+    /* Check this shred > SMR. We ignore shreds before the SMR because by
+       it is invariant that we must have a connected, linear chain for the
+       SMR and its ancestors. */
+
+    if( FD_UNLIKELY( slot <= blockstore->smr ) ) {
+      fd_blockstore_end_read( blockstore );
+      return FD_BLOCKSTORE_OK;
+    }
+
+    block_map_entry = fd_blockstore_block_map_query( blockstore, slot );
+    if( FD_LIKELY( block_map_entry ) ) break;
+    fd_blockstore_end_read( blockstore );
+
+    fd_blockstore_start_write( blockstore );
+    int rc = block_map_entry_insert( blockstore, shred );
+    fd_blockstore_end_write( blockstore );
+    if( FD_UNLIKELY( rc != FD_BLOCKSTORE_OK ) ) return rc;
+  }
+
+  /* The slot was already assembled into a block, so there is nothing
+     left to buffer. */
 
-  if( FD_UNLIKELY( shred->slot <= blockstore->smr ) ) {
+  if( FD_UNLIKELY( block_map_entry->block_gaddr ) ) {
+    fd_blockstore_end_read( blockstore );
     return FD_BLOCKSTORE_OK;
   }
 
+  fd_rwseq_lock_t * shard_lock = &blockstore->shard[ fd_blockstore_shard_idx( slot ) ].lock;
+  fd_rwseq_start_write( shard_lock );
+
   /* Check if we already have this shred */
 
   fd_buf_shred_t *     shred_pool = fd_blockstore_shred_pool( blockstore );
-  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore );
+  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore, slot );
   fd_shred_key_t       shred_key  = { .slot = shred->slot, .idx = shred->idx };
   fd_buf_shred_t *     shred_     = fd_buf_shred_map_ele_query( shred_map, &shred_key, NULL, shred_pool );
   if( FD_UNLIKELY( shred_ ) ) {
@@ -1176,63 +1360,31 @@ fd_buf_shred_insert( fd_blockstore_t * blockstore, fd_shred_t const * shred ) {
 
     if( FD_UNLIKELY( is_eqvoc_fec( &shred_->hdr, shred ) ) ) {
       FD_LOG_WARNING(( "equivocating shred detected %lu %u. halting.", shred->slot, shred->idx ));
-      return FD_BLOCKSTORE_OK;
     }
 
     /* Short-circuit if we already have the shred. */
 
+    fd_rwseq_end_write( shard_lock );
+    fd_blockstore_end_read( blockstore );
     return FD_BLOCKSTORE_OK;
   }
 
+  /* The pool is shared by all shards.  Releases only happen under the
+     write lock, so only acquires from concurrent shards need to be
+     serialized. */
+
+  fd_rwseq_start_write( &blockstore->shred_pool_lock );
   if( FD_UNLIKELY( !fd_buf_shred_pool_free( shred_pool ) ) ) {
     FD_LOG_ERR(( "[%s] OOM: failed to buffer shred. blockstore needs to buffer shreds for slots >= SMR for block assembly, so either increase memory or check for issues with publishing new SMRs.", __func__ ));
   }
   fd_buf_shred_t * ele = fd_buf_shred_pool_ele_acquire( shred_pool ); /* always non-NULL */
+  fd_rwseq_end_write( &blockstore->shred_pool_lock );
+
   ele->key             = shred_key;
   ele->hdr             = *shred;
   fd_memcpy( &ele->raw, shred, fd_shred_sz( shred ) );
   fd_buf_shred_map_ele_insert( shred_map, ele, shred_pool ); /* always non-NULL */
 
-  /* Update shred's associated slot meta */
-
-  ulong slot = shred->slot;
-  fd_block_map_t * block_map = fd_blockstore_block_map( blockstore );
-  fd_block_map_t * block_map_entry = fd_block_map_query( block_map, &slot, NULL );
-  if( FD_UNLIKELY( !block_map_entry ) ) {
-
-    if( FD_UNLIKELY( fd_block_map_key_cnt( block_map ) == fd_block_map_key_max( block_map ) ) ) {
-      FD_LOG_ERR(( "[%s] OOM: failed to insert new block map entry. blockstore needs to save metadata for all slots >= SMR, so increase memory or check for issues with publishing new SMRs.", __func__ ));
-    }
-
-    /* Try to insert slot into block_map */
-
-    block_map_entry = fd_block_map_insert( block_map, &slot );
-    if( FD_UNLIKELY( !block_map_entry ) ) return FD_BLOCKSTORE_ERR_SLOT_FULL;
-
-    /* Initialize the block_map_entry. Note some fields are initialized
-       to dummy values because we do not have all the necessary metadata
-       yet. */
-
-    block_map_entry->slot = block_map_entry->slot;
-
-    block_map_entry->parent_slot = shred->slot - shred->data.parent_off;
-    memset( block_map_entry->child_slots, UCHAR_MAX, FD_BLOCKSTORE_CHILD_SLOT_MAX * sizeof(ulong) );
-    block_map_entry->child_slot_cnt = 0;
-
-    block_map_entry->height         = 0;
-    block_map_entry->block_hash     = ( fd_hash_t ){ 0 };
-    block_map_entry->bank_hash      = ( fd_hash_t ){ 0 };
-    block_map_entry->flags          = fd_uchar_set_bit( 0, FD_BLOCK_FLAG_RECEIVING );
-    block_map_entry->ts             = 0;
-    block_map_entry->reference_tick = (uchar)( (int)shred->data.flags &
-                                               (int)FD_SHRED_DATA_REF_TICK_MASK );
-    block_map_entry->consumed_idx   = UINT_MAX;
-    block_map_entry->received_idx   = 0;
-    block_map_entry->complete_idx   = UINT_MAX;
-
-    block_map_entry->block_gaddr    = 0;
-  }
-
   FD_LOG_DEBUG(( "slot_meta->consumed_idx: %u, shred->slot: %lu, slot_meta->received_idx: %u, "
                  "shred->idx: %u, shred->complete_idx: %u",
                  block_map_entry->consumed_idx,
@@ -1249,57 +1401,29 @@ fd_buf_shred_insert( fd_blockstore_t * blockstore, fd_shred_t const * shred ) {
   block_map_entry->received_idx = fd_uint_max( block_map_entry->received_idx, shred->idx + 1 );
   if( FD_UNLIKELY( shred->data.flags & FD_SHRED_DATA_FLAG_SLOT_COMPLETE ) ) block_map_entry->complete_idx = shred->idx;
 
-  /* update ancestry metadata: parent_slot, is_connected, next_slot */
+  int complete = block_map_entry->consumed_idx != UINT_MAX &&
+                 block_map_entry->consumed_idx == block_map_entry->complete_idx;
 
-  fd_block_map_t * parent_block_map_entry = fd_blockstore_block_map_query( blockstore, block_map_entry->parent_slot );
+  fd_rwseq_end_write( shard_lock );
 
-  /* Add this slot to its parent's child slots if not already there. */
+  /* update ancestry metadata: parent_slot, is_connected, next_slot */
 
-  if( FD_LIKELY( parent_block_map_entry ) ) {
-    int found = 0;
-    for( ulong i = 0; i < parent_block_map_entry->child_slot_cnt; i++ ) {
-      if( FD_LIKELY( parent_block_map_entry->child_slots[i] == slot ) ) {
-        found = 1;
-      }
-    }
-    if( FD_UNLIKELY( !found ) ) {
-      if( FD_UNLIKELY( parent_block_map_entry->child_slot_cnt == FD_BLOCKSTORE_CHILD_SLOT_MAX )) {
-        FD_LOG_ERR(( "failed to add slot %lu to parent %lu's children. exceeding child slot max",
-                      slot,
-                      parent_block_map_entry->slot ));
-      }
-      parent_block_map_entry->child_slots[parent_block_map_entry->child_slot_cnt++] = slot;
-    }
-  }
+  int unlinked = is_child_unlinked( blockstore, block_map_entry );
 
-  if( FD_LIKELY( block_map_entry->consumed_idx == UINT_MAX ||
-                 block_map_entry->consumed_idx != block_map_entry->complete_idx ) ) {
-    return FD_BLOCKSTORE_OK;
-  }
+  fd_blockstore_end_read( blockstore );
 
-  /* Received all shreds, so try to assemble a block. */
-  FD_LOG_DEBUG(( "received all shreds for slot %lu - now building a block", shred->slot ));
+  if( FD_LIKELY( !unlinked && !complete ) ) return FD_BLOCKSTORE_OK;
 
-  int rc = deshred( blockstore, shred->slot );
-  switch( rc ) {
-  case FD_BLOCKSTORE_OK:
-    return FD_BLOCKSTORE_OK_SLOT_COMPLETE;
-  case FD_BLOCKSTORE_ERR_SLOT_FULL:
-    FD_LOG_DEBUG(( "already deshredded slot %lu. ignoring.", shred->slot ));
-    return FD_BLOCKSTORE_OK;
-  case FD_BLOCKSTORE_ERR_DESHRED_INVALID:
-    FD_LOG_DEBUG(( "failed to deshred slot %lu. ignoring.", shred->slot ));
-    return FD_BLOCKSTORE_OK;
-  default:
-    /* FIXME */
-    FD_LOG_ERR(( "deshred err %d", rc ));
-  }
+  fd_blockstore_start_write( blockstore );
+  int rc = buf_shred_publish( blockstore, slot );
+  fd_blockstore_end_write( blockstore );
+  return rc;
 }
 
 fd_shred_t *
 fd_buf_shred_query( fd_blockstore_t * blockstore, ulong slot, uint shred_idx ) {
   fd_buf_shred_t *     shred_pool = fd_blockstore_shred_pool( blockstore );
-  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore );
+  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore, slot );
   fd_shred_key_t       key        = { .slot = slot, .idx = shred_idx };
   fd_buf_shred_t *     query =
       fd_buf_shred_map_ele_query( shred_map, &key, NULL, shred_pool );
@@ -1312,7 +1436,7 @@ fd_buf_shred_query_copy_data( fd_blockstore_t * blockstore, ulong slot, uint shr
   if( buf_max < FD_SHRED_MAX_SZ ) return -1;
 
   fd_buf_shred_t *     shred_pool = fd_blockstore_shred_pool( blockstore );
-  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore );
+  fd_buf_shred_map_t * shred_map  = fd_blockstore_shred_map( blockstore, slot );
   fd_shred_key_t              key        = { .slot = slot, .idx = shred_idx };
   fd_buf_shred_t *     shred =
       fd_buf_shred_map_ele_query( shred_map, &key, NULL, shred_pool );
@@ -1390,6 +1514,22 @@ fd_blockstore_child_slots_query( fd_blockstore_t * blockstore, ulong slot, ulong
   return FD_BLOCKSTORE_OK;
 }
 
+/* The windowing fields of a block map entry are written under the lock
+   of the slot's shard rather than the blockstore lock, so concurrent
+   reads that copy out a block map entry validate against both. */
+
+static inline int
+slot_start_concur_read( fd_blockstore_t * blockstore, ulong slot, uint seqnum[2] ) {
+  return fd_rwseq_start_concur_read( &blockstore->lock, &seqnum[0] ) |
+         fd_rwseq_start_concur_read( &blockstore->shard[ fd_blockstore_shard_idx( slot ) ].lock, &seqnum[1] );
+}
+
+static inline int
+slot_check_concur_read( fd_blockstore_t * blockstore, ulong slot, uint const seqnum[2] ) {
+  return fd_rwseq_check_concur_read( &blockstore->lock, seqnum[0] ) |
+         fd_rwseq_check_concur_read( &blockstore->shard[ fd_blockstore_shard_idx( slot ) ].lock, seqnum[1] );
+}
+
 int
 fd_blockstore_block_data_query_volatile( fd_blockstore_t *    blockstore,
                                          int                  fd,
@@ -1455,8 +1595,8 @@ fd_blockstore_block_data_query_volatile( fd_blockstore_t *    blockstore,
   uchar * prev_data_out = NULL;
   ulong prev_sz = 0;
   for(;;) {
-    uint seqnum;
-    if( FD_UNLIKELY( fd_rwseq_start_concur_read( &blockstore->lock, &seqnum ) ) ) continue;
+    uint seqnum[2];
+    if( FD_UNLIKELY( slot_start_concur_read( blockstore, slot, seqnum ) ) ) continue;
 
     fd_block_map_t const * query = fd_block_map_query_safe( block_map, &slot, NULL );
     if( FD_UNLIKELY( !query ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
@@ -1465,7 +1605,7 @@ fd_blockstore_block_data_query_volatile( fd_blockstore_t *    blockstore,
     ulong blk_gaddr = query->block_gaddr;
     if( FD_UNLIKELY( !blk_gaddr ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
 
-    if( FD_UNLIKELY( fd_rwseq_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( slot_check_concur_read( blockstore, slot, seqnum ) ) ) continue;
 
     fd_block_t * blk = fd_wksp_laddr_fast( wksp, blk_gaddr );
     if( block_rewards_out ) memcpy( block_rewards_out, &blk->rewards, sizeof(fd_block_rewards_t) );
@@ -1474,7 +1614,7 @@ fd_blockstore_block_data_query_volatile( fd_blockstore_t *    blockstore,
     ulong sz = *block_data_sz_out = blk->data_sz;
     if( sz >= FD_SHRED_MAX_PER_SLOT * FD_SHRED_MAX_SZ ) continue;
 
-    if( FD_UNLIKELY( fd_rwseq_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( slot_check_concur_read( blockstore, slot, seqnum ) ) ) continue;
 
     uchar * data_out;
     if( prev_sz >= sz ) {
@@ -1489,10 +1629,10 @@ fd_blockstore_block_data_query_volatile( fd_blockstore_t *    blockstore,
     if( FD_UNLIKELY( data_out == NULL ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
     fd_memcpy( data_out, fd_wksp_laddr_fast( wksp, blk_data_gaddr ), sz );
 
-    if( FD_UNLIKELY( fd_rwseq_check_concur_read( &blockstore->lock, seqnum ) ) ) {
-      fd_valloc_free( alloc, data_out );
-      continue;
-    }
+    /* On retry data_out is kept in prev_data_out for reuse, so it must
+       not be freed here. */
+
+    if( FD_UNLIKELY( slot_check_concur_read( blockstore, slot, seqnum ) ) ) continue;
 
     *block_data_out = data_out;
 
@@ -1502,10 +1642,7 @@ fd_blockstore_block_data_query_volatile( fd_blockstore_t *    blockstore,
       } else {
         fd_memcpy( parent_block_hash_out, query->block_hash.uc, sizeof(fd_hash_t) );
 
-        if( FD_UNLIKELY( fd_rwseq_check_concur_read( &blockstore->lock, seqnum ) ) ) {
-          fd_valloc_free( alloc, data_out );
-          continue;
-        }
+        if( FD_UNLIKELY( slot_check_concur_read( blockstore, slot, seqnum ) ) ) continue;
       }
     }
 
@@ -1555,15 +1692,15 @@ fd_blockstore_block_map_query_volatile( fd_blockstore_t * blockstore,
 
   fd_block_map_t const * block_map = fd_blockstore_block_map( blockstore );
   for(;;) {
-    uint seqnum;
-    if( FD_UNLIKELY( fd_rwseq_start_concur_read( &blockstore->lock, &seqnum ) ) ) continue;
+    uint seqnum[2];
+    if( FD_UNLIKELY( slot_start_concur_read( blockstore, slot, seqnum ) ) ) continue;
     fd_block_map_t const * query = fd_block_map_query_safe( block_map, &slot, NULL );
     if( FD_UNLIKELY( !query ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
     memcpy( block_map_entry_out, query, sizeof( fd_block_map_t ) );
     ulong blk_gaddr = query->block_gaddr;
     if( FD_UNLIKELY( !blk_gaddr ) ) return FD_BLOCKSTORE_ERR_SLOT_MISSING;
 
-    if( FD_UNLIKELY( fd_rwseq_check_concur_read( &blockstore->lock, seqnum ) ) ) continue;
+    if( FD_UNLIKELY( slot_check_concur_read( blockstore, slot, seqnum ) ) ) continue;
 
     return FD_BLOCKSTORE_OK;
   }
@@ -1718,11 +1855,14 @@ fd_blockstore_log_mem_usage( fd_blockstore_t * blockstore ) {
                   shred_used,
                   shred_max,
                   (100U*shred_used) / shred_max ));
-  fd_buf_shred_map_t * shred_map = fd_blockstore_shred_map( blockstore );
-  ulong shred_map_cnt = fd_buf_shred_map_chain_cnt( shred_map );
-  FD_LOG_NOTICE(( "shred map footprint: %s (%lu chains, load is %.3f)",
-                  fd_smart_size( fd_buf_shred_map_footprint( shred_map_cnt ), tmp1, sizeof(tmp1) ),
+  ulong shred_map_cnt = 0UL;
+  for( ulong i = 0; i < FD_BLOCKSTORE_SHARD_CNT; i++ ) {
+    shred_map_cnt += fd_buf_shred_map_chain_cnt( fd_blockstore_shred_map( blockstore, i ) );
+  }
+  FD_LOG_NOTICE(( "shred map footprint: %s (%lu chains over %lu shards, load is %.3f)",
+                  fd_smart_size( FD_BLOCKSTORE_SHARD_CNT*fd_buf_shred_map_footprint( shred_map_cnt/FD_BLOCKSTORE_SHARD_CNT ), tmp1, sizeof(tmp1) ),
                   shred_map_cnt,
+                  FD_BLOCKSTORE_SHARD_CNT,
                   ((double)shred_used)/((double)shred_map_cnt) ));
   fd_block_map_t * slot_map = fd_blockstore_block_map( blockstore );
   ulong slot_map_cnt = fd_block_map_key_cnt( slot_map );
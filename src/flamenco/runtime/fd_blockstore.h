@@ -10,7 +10,25 @@
    The blockstore alloc is used for allocating wksp resources for shred
    headers, microblock headers, and blocks.  This is an fd_alloc.
    Allocations from this allocator will be tagged with wksp_tag and
-   operations on this allocator will use concurrency group 0. */
+   operations on this allocator will use concurrency group 0.
+
+   Concurrency is managed with two levels of fd_rwseq locks.  The
+   blockstore lock guards the structure of the blockstore: inserting and
+   removing block map entries, assembling blocks, the txn map, the
+   archival index and publishing.  Below it, slots are striped across
+   FD_BLOCKSTORE_SHARD_CNT shards.  Each shard has its own lock and its
+   own map of buffered shreds, and its lock guards the buffered shreds
+   and the windowing fields (consumed_idx, received_idx, complete_idx)
+   of the block map entries of its slots.
+
+   Shred insertion holds the blockstore read lock and the shard write
+   lock of the shred's slot, so shreds for different slots are inserted
+   concurrently with each other and with readers of other slots, block
+   map queries and txn map lookups.  It only escalates to the blockstore
+   write lock for the first shred of a slot and to assemble the block
+   once all of the slot's shreds have been received.  Holding the
+   blockstore write lock implies exclusive access to every shard.
+   Locks are always acquired in blockstore, shard order. */
 
 #include "../../ballet/block/fd_microblock.h"
 #include "../../ballet/shred/fd_deshredder.h"
@@ -29,7 +47,8 @@
 /* clang-format off */
 #define FD_BLOCKSTORE_ALIGN     (128UL)
 #define FD_BLOCKSTORE_FOOTPRINT (256UL)
-#define FD_BLOCKSTORE_MAGIC     (0xf17eda2ce7b10c00UL) /* firedancer bloc version 0 */
+#define FD_BLOCKSTORE_MAGIC     (0xf17eda2ce7b10c01UL) /* firedancer bloc version 1 */
+#define FD_BLOCKSTORE_ORPHAN_MAX (64UL) /* max # of slots tracked as waiting on their parent's block map entry */
 
 /* DO NOT MODIFY. */
 // #define FD_BUF_SHRED_MAP_MAX (1UL << 24UL) /* 16 million shreds can be buffered */
@@ -40,6 +59,10 @@
 #define FD_BLOCKSTORE_CHILD_SLOT_MAX    (32UL)        /* the maximum # of children a slot can have */
 #define FD_BLOCKSTORE_ARCHIVE_MIN_SIZE  (1UL << 26UL) /* 64MB := ceil(MAX_DATA_SHREDS_PER_SLOT*1228) */
 
+/* FD_BLOCKSTORE_SHARD_CNT is the number of shards slots are striped
+   across (see above).  Must be a power of 2. */
+#define FD_BLOCKSTORE_SHARD_CNT         (8UL)
+
 // TODO centralize these
 // https://github.com/firedancer-io/solana/blob/v1.17.5/sdk/program/src/clock.rs#L34
 #define FD_MS_PER_TICK 6
@@ -343,6 +366,15 @@ struct fd_blockstore_archiver {
 typedef struct fd_blockstore_archiver fd_blockstore_archiver_t;
 #define FD_BLOCKSTORE_ARCHIVE_START sizeof(fd_blockstore_archiver_t)
 
+/* fd_blockstore_shard holds the lock and the buffered shreds of the
+   slots striped onto a shard. */
+
+struct fd_blockstore_shard {
+  fd_rwseq_lock_t lock;
+  ulong           shred_map_gaddr; /* map of (slot, shred_idx)->shred for the shard's slots */
+};
+typedef struct fd_blockstore_shard fd_blockstore_shard_t;
+
 struct __attribute__((aligned(FD_BLOCKSTORE_ALIGN))) fd_blockstore {
 /* clang-format on */
 
@@ -355,7 +387,9 @@ struct __attribute__((aligned(FD_BLOCKSTORE_ALIGN))) fd_blockstore {
 
   /* Concurrency */
 
-  fd_rwseq_lock_t lock;
+  fd_rwseq_lock_t       lock;                           /* blockstore lock */
+  fd_rwseq_lock_t       shred_pool_lock;                /* serializes shred pool acquires of concurrent shards */
+  fd_blockstore_shard_t shard[FD_BLOCKSTORE_SHARD_CNT]; /* slot-striped shard locks and shred maps */
 
   /* Persistence */
 
@@ -369,6 +403,13 @@ struct __attribute__((aligned(FD_BLOCKSTORE_ALIGN))) fd_blockstore {
   ulong smr; /* supermajority root. DO NOT MODIFY DIRECTLY. */
   ulong wmk; /* watermark. DO NOT MODIFY DIRECTLY. */
 
+  /* Slots whose block map entry was created before their parent's, so
+     could not be linked to it yet.  Bounded so inserting a slot never
+     scans the block map. */
+
+  ulong orphan_cnt;
+  ulong orphan_slot[FD_BLOCKSTORE_ORPHAN_MAX];
+
   /* Config limits */
 
   ulong shred_max; /* maximum # of shreds that can be held in memory */
@@ -379,8 +420,7 @@ struct __attribute__((aligned(FD_BLOCKSTORE_ALIGN))) fd_blockstore {
 
   /* Owned */
 
-  ulong shred_pool_gaddr; /* memory pool for buffering shreds before block assembly */
-  ulong shred_map_gaddr;  /* map of (slot, shred_idx)->shred */
+  ulong shred_pool_gaddr; /* memory pool for buffering shreds before block assembly, shared by all shards */
   ulong block_map_gaddr;  /* map of slot->(slot_meta, block) */
   ulong block_idx_gaddr;  /* map of slot->byte offset in archival file */
   ulong slot_deque_gaddr; /* deque of slot numbers */
@@ -400,6 +440,15 @@ fd_blockstore_align( void ) {
   return alignof(fd_blockstore_t);
 }
 
+/* fd_blockstore_shard_chain_cnt returns the number of chains of each
+   shard's shred map for a blockstore that buffers up to shred_max
+   shreds. */
+
+FD_FN_CONST static inline ulong
+fd_blockstore_shard_chain_cnt( ulong shred_max ) {
+  return fd_buf_shred_map_chain_cnt_est( fd_ulong_max( shred_max / FD_BLOCKSTORE_SHARD_CNT, 1UL ) );
+}
+
 FD_FN_CONST static inline ulong
 fd_blockstore_footprint( ulong shred_max, ulong block_max, ulong idx_max, ulong txn_max ) {
   int lg_idx_max = fd_ulong_find_msb( fd_ulong_pow2_up( idx_max ) );
@@ -415,7 +464,7 @@ fd_blockstore_footprint( ulong shred_max, ulong block_max, ulong idx_max, ulong
     FD_LAYOUT_INIT,
       alignof(fd_blockstore_t),  sizeof(fd_blockstore_t) ),
       fd_buf_shred_pool_align(), fd_buf_shred_pool_footprint( shred_max ) ),
-      fd_buf_shred_map_align(),  fd_buf_shred_map_footprint( shred_max ) ),
+      fd_buf_shred_map_align(),  FD_BLOCKSTORE_SHARD_CNT*fd_buf_shred_map_footprint( fd_blockstore_shard_chain_cnt( shred_max ) ) ),
       fd_block_map_align(),      fd_block_map_footprint( block_max ) ),
       fd_block_idx_align(),      fd_block_idx_footprint( lg_idx_max ) ),
       fd_slot_deque_align(),     fd_slot_deque_footprint( block_max ) ),
@@ -505,14 +554,23 @@ fd_blockstore_shred_pool( fd_blockstore_t * blockstore ) {
   return fd_wksp_laddr_fast( fd_blockstore_wksp( blockstore ), blockstore->shred_pool_gaddr );
 }
 
-/* fd_blockstore_buf_shred_map returns a pointer in the caller's address
-   space to the fd_buf_shred_map_t * in the blockstore wksp.  Assumes
-   blockstore is local join.  Lifetime of the returned pointer is that
-   of the local join. */
+/* fd_blockstore_shard_idx returns the index of the shard slot is
+   striped onto.  Consecutive slots land on different shards. */
+
+FD_FN_CONST static inline ulong
+fd_blockstore_shard_idx( ulong slot ) {
+  return slot & (FD_BLOCKSTORE_SHARD_CNT-1UL);
+}
+
+/* fd_blockstore_shred_map returns a pointer in the caller's address
+   space to the fd_buf_shred_map_t * buffering the shreds of slot in the
+   blockstore wksp.  Assumes blockstore is local join.  Lifetime of the
+   returned pointer is that of the local join. */
 
 FD_FN_PURE static inline fd_buf_shred_map_t *
-fd_blockstore_shred_map( fd_blockstore_t * blockstore ) {
-  return fd_wksp_laddr_fast( fd_blockstore_wksp( blockstore ), blockstore->shred_map_gaddr );
+fd_blockstore_shred_map( fd_blockstore_t * blockstore, ulong slot ) {
+  return fd_wksp_laddr_fast( fd_blockstore_wksp( blockstore ),
+                             blockstore->shard[ fd_blockstore_shard_idx( slot ) ].shred_map_gaddr );
 }
 
 /* fd_block_map returns a pointer in the caller's address space to the
@@ -583,8 +641,8 @@ fd_blockstore_block_micro_laddr( fd_blockstore_t * blockstore, fd_block_t * bloc
    removed.  Check return value for error info.  This API only works for
    shreds from incomplete blocks.
 
-   Callers should hold the read lock during the entirety of its read to
-   ensure the pointer remains valid. */
+   Callers should hold the slot read lock (fd_blockstore_slot_start_read)
+   during the entirety of its read to ensure the pointer remains valid. */
 fd_shred_t *
 fd_buf_shred_query( fd_blockstore_t * blockstore, ulong slot, uint shred_idx );
 
@@ -592,7 +650,7 @@ fd_buf_shred_query( fd_blockstore_t * blockstore, ulong slot, uint shred_idx );
    slot, shred_idx. Copies the shred data to the given buffer and
    returns the data size. Returns -1 on failure.
 
-   IMPORTANT!  Caller MUST hold the read lock when calling this
+   IMPORTANT!  Caller MUST hold the slot read lock when calling this
    function. */
 long
 fd_buf_shred_query_copy_data( fd_blockstore_t * blockstore,
@@ -736,8 +794,16 @@ fd_blockstore_slot_remove( fd_blockstore_t * blockstore, ulong slot );
    full.  Returns an error code indicating success or failure.
    TODO eventually this will need to support "upsert" duplicate shred handling.
 
-   IMPORTANT!  Caller MUST hold the write lock when calling this
-   function. */
+   Shreds for slots that are already assembled into a block or that are
+   not newer than the SMR are ignored.  Returns
+   FD_BLOCKSTORE_OK_SLOT_COMPLETE to exactly one of the callers that
+   inserted the last missing shred of a slot, once the block has been
+   assembled.
+
+   IMPORTANT!  Caller MUST NOT hold any blockstore lock when calling
+   this function.  It acquires the locks it needs internally (see the
+   concurrency notes at the top of this file), so multiple threads can
+   insert concurrently. */
 int
 fd_buf_shred_insert( fd_blockstore_t * blockstore, fd_shred_t const * shred );
 
@@ -798,6 +864,24 @@ fd_blockstore_end_write( fd_blockstore_t * blockstore ) {
   fd_rwseq_end_write( &blockstore->lock );
 }
 
+/* fd_blockstore_slot_start_read acquires the read lock and the read
+   lock of slot's shard.  This is required to query the buffered shreds
+   of slot and to get a consistent view of slot's windowing fields while
+   its shreds are being inserted. */
+static inline void
+fd_blockstore_slot_start_read( fd_blockstore_t * blockstore, ulong slot ) {
+  fd_rwseq_start_read( &blockstore->lock );
+  fd_rwseq_start_read( &blockstore->shard[ fd_blockstore_shard_idx( slot ) ].lock );
+}
+
+/* fd_blockstore_slot_end_read releases the locks acquired by
+   fd_blockstore_slot_start_read */
+static inline void
+fd_blockstore_slot_end_read( fd_blockstore_t * blockstore, ulong slot ) {
+  fd_rwseq_end_read( &blockstore->shard[ fd_blockstore_shard_idx( slot ) ].lock );
+  fd_rwseq_end_read( &blockstore->lock );
+}
+
 void
 fd_blockstore_log_block_status( fd_blockstore_t * blockstore, ulong around_slot );
 
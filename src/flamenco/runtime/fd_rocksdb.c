@@ -507,8 +507,6 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
                                     int txnstatus,
                                     const uchar *hash_override ) // How much effort should we go to here to confirm the size of the hash override?
 {
-  fd_blockstore_start_write( blockstore );
-
   ulong slot = m->slot;
   ulong start_idx = 0;
   ulong end_idx = m->received;
@@ -537,14 +535,12 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
     if (!valid || cur_slot != slot) {
       FD_LOG_WARNING(("missing shreds for slot %lu", slot));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
 
     if (index != i) {
       FD_LOG_WARNING(("missing shred %lu at index %lu for slot %lu", i, index, slot));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
 
@@ -554,7 +550,6 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
     if (data == NULL) {
       FD_LOG_WARNING(("failed to read shred %lu/%lu", slot, i));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
 
@@ -564,14 +559,12 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
     if (shred == NULL) {
       FD_LOG_WARNING(("failed to parse shred %lu/%lu", slot, i));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
     int rc = fd_buf_shred_insert( blockstore, shred );
     if (rc != FD_BLOCKSTORE_OK_SLOT_COMPLETE && rc != FD_BLOCKSTORE_OK) {
       FD_LOG_WARNING(("failed to store shred %lu/%lu", slot, i));
       rocksdb_iter_destroy(iter);
-      fd_blockstore_end_write(blockstore);
       return -1;
     }
 
@@ -580,6 +573,8 @@ fd_rocksdb_import_block_blockstore( fd_rocksdb_t *    db,
 
   rocksdb_iter_destroy(iter);
 
+  fd_blockstore_start_write( blockstore );
+
   fd_wksp_t * wksp = fd_blockstore_wksp( blockstore );
   fd_block_map_t * block_map_entry = fd_blockstore_block_map_query( blockstore, slot );
   if( FD_LIKELY( block_map_entry && block_map_entry->block_gaddr ) ) {
@@ -925,3 +920,92 @@ fd_rocksdb_import_block_shredcap( fd_rocksdb_t *               db,
   }
   return 0;
 }
+
+ulong
+fd_rocksdb_get_block_shreds( fd_rocksdb_t *         db,
+                             fd_slot_meta_t const * m,
+                             uchar *                buf,
+                             ulong                  buf_sz,
+                             ushort *               shred_sz ) {
+  ulong slot = m->slot;
+
+  rocksdb_iterator_t * iter = rocksdb_create_iterator_cf( db->db, db->ro, db->cf_handles[ FD_ROCKSDB_CFIDX_DATA_SHRED ] );
+
+  char k[16];
+  *((ulong *) &k[0]) = fd_ulong_bswap( slot );
+  *((ulong *) &k[8]) = fd_ulong_bswap( 0 );
+  rocksdb_iter_seek( iter, (const char *) k, sizeof(k) );
+
+  ulong off = 0UL;
+  for( ulong i=0UL; i<m->received; i++ ) {
+    size_t klen = 0;
+    char const * key = rocksdb_iter_valid( iter ) ? rocksdb_iter_key( iter, &klen ) : NULL;
+    if( FD_UNLIKELY( !key || klen!=16 ||
+                     fd_ulong_bswap( *((ulong *) &key[0]) )!=slot ||
+                     fd_ulong_bswap( *((ulong *) &key[8]) )!=i ) ) {
+      FD_LOG_WARNING(( "missing shred %lu for slot %lu", i, slot ));
+      off = ULONG_MAX;
+      break;
+    }
+
+    size_t dlen = 0;
+    uchar const * data = (uchar const *) rocksdb_iter_value( iter, &dlen );
+    fd_shred_t const * shred = data ? fd_shred_parse( data, (ulong) dlen ) : NULL;
+    if( FD_UNLIKELY( !shred ) ) {
+      FD_LOG_WARNING(( "failed to parse shred %lu/%lu", slot, i ));
+      off = ULONG_MAX;
+      break;
+    }
+
+    ulong sz = fd_shred_sz( shred );
+    if( FD_UNLIKELY( sz>buf_sz-off ) ) {
+      FD_LOG_WARNING(( "slot %lu does not fit in %lu bytes", slot, buf_sz ));
+      off = ULONG_MAX;
+      break;
+    }
+    fd_memcpy( buf+off, shred, sz );
+    shred_sz[ i ] = (ushort)sz;
+    off += sz;
+
+    rocksdb_iter_next( iter );
+  }
+
+  rocksdb_iter_destroy( iter );
+  return off;
+}
+
+int
+fd_rocksdb_get_bank_hash( fd_rocksdb_t * db,
+                          ulong          slot,
+                          fd_hash_t *    bank_hash ) {
+  ulong  slot_be = fd_ulong_bswap( slot );
+  size_t vallen  = 0;
+  char * err     = NULL;
+  char * res     = rocksdb_get_cf( db->db, db->ro, db->cf_handles[ FD_ROCKSDB_CFIDX_BANK_HASHES ],
+                                   (char const *)&slot_be, sizeof(ulong), &vallen, &err );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "Could not get bank hash data due to err=%s", err ));
+    free( err );
+    return -1;
+  }
+  if( FD_UNLIKELY( !res ) ) return -1;
+
+  /* The frozen hash has no dynamically sized fields, so decoding does
+     not allocate */
+
+  fd_bincode_decode_ctx_t decode = {
+    .data    = res,
+    .dataend = res + vallen,
+    .valloc  = fd_libc_alloc_virtual(),
+  };
+  fd_frozen_hash_versioned_t versioned;
+  int ret = -1;
+  if( FD_LIKELY( fd_frozen_hash_versioned_decode( &versioned, &decode )==FD_BINCODE_SUCCESS &&
+                 decode.data==decode.dataend &&
+                 versioned.discriminant==fd_frozen_hash_versioned_enum_current ) ) {
+    fd_memcpy( bank_hash->hash, versioned.inner.current.frozen_hash.hash, 32UL );
+    ret = 0;
+  }
+  free( res );
+  return ret;
+}
@@ -240,6 +240,30 @@ fd_rocksdb_import_block_shredcap( fd_rocksdb_t *             db,
                                   fd_io_buffered_ostream_t * ostream,
                                   fd_io_buffered_ostream_t * bank_hash_ostream );
 
+/* fd_rocksdb_get_block_shreds copies the data shreds [0,m->received)
+   of the slot described by m back to back into [buf,buf+buf_sz) and
+   sets shred_sz[i] to the size of shred i (shred_sz has room for
+   m->received entries).  Returns the number of bytes written to buf,
+   or ULONG_MAX if a shred is missing or invalid or buf is too small.
+   Safe to call concurrently from multiple threads on the same db. */
+
+ulong
+fd_rocksdb_get_block_shreds( fd_rocksdb_t *         db,
+                             fd_slot_meta_t const * m,
+                             uchar *                buf,
+                             ulong                  buf_sz,
+                             ushort *               shred_sz );
+
+/* fd_rocksdb_get_bank_hash sets *bank_hash to the frozen bank hash of
+   slot.  Returns 0 on success and -1 if the db has no (current
+   version) bank hash for slot.  Safe to call concurrently from
+   multiple threads on the same db. */
+
+int
+fd_rocksdb_get_bank_hash( fd_rocksdb_t * db,
+                          ulong          slot,
+                          fd_hash_t *    bank_hash );
+
 FD_PROTOTYPES_END
 
 #endif
@@ -154,6 +154,32 @@ fd_runtime_sysvar_cache_load( fd_exec_slot_ctx_t * slot_ctx ) {
     return -1;
   }
 
+  /* A cache shared with sibling forks stays in use until one of the
+     sysvar accounts is written in this fork.  This always happens when
+     a block is prepared, since fd_runtime_block_sysvar_update_pre_execute
+     rewrites the clock, fees, slot hashes and last restart slot sysvars.
+     In that case only the sysvars written since the shared cache was
+     restored are decoded again, into a private copy of the shared
+     cache.  If the shared cache is not an ancestor of this fork's funk
+     txn, every sysvar is restored into a fresh private cache (no copy of
+     the shared one). */
+
+  fd_sysvar_cache_store_t * store = slot_ctx->sysvar_cache_store;
+  if( store && fd_sysvar_cache_store_owns( store, slot_ctx->sysvar_cache ) ) {
+    ulong stale = fd_sysvar_cache_store_stale( store, slot_ctx->sysvar_cache, slot_ctx->acc_mgr->funk, slot_ctx->funk_txn );
+    if( FD_LIKELY( !stale ) ) return FD_RUNTIME_EXECUTE_SUCCESS;
+    if( FD_LIKELY( stale!=ULONG_MAX ) ) {
+      fd_sysvar_cache_t * cache = fd_exec_slot_ctx_sysvar_cache_modify( slot_ctx );
+#     define X( type, name )                                                               \
+      if( stale & (1UL<<FD_SYSVAR_CACHE_STORE_IDX_##name) )                                \
+        fd_sysvar_cache_restore_##name( cache, slot_ctx->acc_mgr, slot_ctx->funk_txn );
+      FD_SYSVAR_CACHE_ITER(X)
+#     undef X
+      return FD_RUNTIME_EXECUTE_SUCCESS;
+    }
+    slot_ctx->sysvar_cache = fd_sysvar_cache_store_detach( store, slot_ctx->sysvar_cache, slot_ctx->valloc );
+  }
+
   fd_sysvar_cache_restore( slot_ctx->sysvar_cache, slot_ctx->acc_mgr, slot_ctx->funk_txn );
 
   return FD_RUNTIME_EXECUTE_SUCCESS;
@@ -1285,6 +1311,31 @@ fd_runtime_prepare_txns_start( fd_exec_slot_ctx_t *         slot_ctx,
   return res;
 }
 
+ulong
+fd_runtime_prefetch_txns( fd_exec_slot_ctx_t const * slot_ctx,
+                          fd_txn_p_t const *         txns,
+                          ulong                      txn_cnt ) {
+  fd_acc_mgr_t const *  acc_mgr  = slot_ctx->acc_mgr;
+  fd_funk_txn_t const * funk_txn = slot_ctx->funk_txn;
+
+  ulong found_cnt = 0UL;
+  for( ulong txn_idx=0UL; txn_idx<txn_cnt; txn_idx++ ) {
+    fd_txn_p_t const * txn            = txns + txn_idx;
+    fd_txn_t const *   txn_descriptor = (fd_txn_t const *)txn->_;
+
+    fd_pubkey_t const * acct_addrs = fd_type_pun_const( fd_txn_get_acct_addrs( txn_descriptor, txn->payload ) );
+    found_cnt += fd_acc_mgr_prefetch( acc_mgr, funk_txn, acct_addrs, txn_descriptor->acct_addr_cnt );
+
+    fd_txn_acct_addr_lut_t const * addr_luts = fd_txn_get_address_tables_const( txn_descriptor );
+    for( ulong i=0UL; i<txn_descriptor->addr_table_lookup_cnt; i++ ) {
+      fd_pubkey_t const * addr_lut = fd_type_pun_const( txn->payload + addr_luts[ i ].addr_off );
+      found_cnt += fd_acc_mgr_prefetch( acc_mgr, funk_txn, addr_lut, 1UL );
+    }
+  }
+
+  return found_cnt;
+}
+
 /* fd_runtime_pre_execute_check is responsible for conducting many of the 
    transaction sanitization checks. */
 
@@ -1325,12 +1376,15 @@ fd_runtime_pre_execute_check( fd_execute_txn_task_info_t * task_info ) {
                                           v
                               general transaction execution
 
-  */
-  err = fd_executor_verify_precompiles( txn_ctx );
-  if( FD_UNLIKELY( err!=FD_RUNTIME_EXECUTE_SUCCESS ) ) {
-    task_info->txn->flags = 0U;
-    task_info->exec_res   = err;
-    return;
+     Transactions we pack as leader had their precompile signatures
+     verified ahead of time by the verify tiles. */
+  if( !( task_info->txn->flags & FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED ) ) {
+    err = fd_executor_verify_precompiles( txn_ctx );
+    if( FD_UNLIKELY( err!=FD_RUNTIME_EXECUTE_SUCCESS ) ) {
+      task_info->txn->flags = 0U;
+      task_info->exec_res   = err;
+      return;
+    }
   }
 
   /* Post-sanitization checks. Called from `prepare_sanitized_batch()` which, for now, only is used
@@ -1583,8 +1637,9 @@ fd_runtime_process_txns( fd_exec_slot_ctx_t * slot_ctx,
 
     fd_execute_txn_task_info_t * task_infos = fd_scratch_alloc( 8, txn_cnt * sizeof(fd_execute_txn_task_info_t));
 
+    /* txns were packed by us, keep the verify tiles' results */
     for( ulong i=0UL; i<txn_cnt; i++ ) {
-      txns[i].flags = FD_TXN_P_FLAGS_SANITIZE_SUCCESS;
+      txns[i].flags = FD_TXN_P_FLAGS_SANITIZE_SUCCESS | ( txns[i].flags & FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED );
     }
 
     for( ulong i=0UL; i<txn_cnt; i++ ) {
@@ -3890,6 +3945,31 @@ fd_runtime_block_verify_tpool( fd_block_info_t const * block_info,
   return result;
 }
 
+int
+fd_runtime_block_verify_poh( fd_blockstore_t * blockstore,
+                             ulong             slot,
+                             fd_hash_t const * in_poh_hash,
+                             fd_hash_t *       out_poh_hash,
+                             fd_valloc_t       valloc,
+                             fd_tpool_t *      tpool ) {
+  fd_blockstore_start_read( blockstore );
+  fd_block_t * block = fd_blockstore_block_query( blockstore, slot );
+  fd_blockstore_end_read( blockstore );
+  if( FD_UNLIKELY( !block ) ) {
+    FD_LOG_WARNING(( "missing block for %lu", slot ));
+    return FD_RUNTIME_EXECUTE_GENERIC_ERR;
+  }
+
+  fd_block_info_t block_info;
+  if( FD_UNLIKELY( fd_runtime_block_prepare( blockstore, block, slot, valloc, &block_info ) ) ) {
+    return FD_RUNTIME_EXECUTE_GENERIC_ERR;
+  }
+  if( FD_UNLIKELY( !block_info.microblock_cnt ) ) {
+    return FD_RUNTIME_EXECUTE_GENERIC_ERR;
+  }
+  return fd_runtime_block_verify_tpool( &block_info, in_poh_hash, out_poh_hash, valloc, tpool );
+}
+
 static int
 fd_runtime_publish_old_txns( fd_exec_slot_ctx_t * slot_ctx,
                              fd_capture_ctx_t *   capture_ctx,
@@ -4045,6 +4125,7 @@ fd_runtime_block_eval_tpool( fd_exec_slot_ctx_t * slot_ctx,
                              fd_capture_ctx_t *   capture_ctx,
                              fd_tpool_t *         tpool,
                              ulong                scheduler,
+                             int                  poh_verified,
                              ulong *              txn_cnt,
                              fd_spad_t * *        spads,
                              ulong                spad_cnt ) {
@@ -4110,7 +4191,16 @@ fd_runtime_block_eval_tpool( fd_exec_slot_ctx_t * slot_ctx,
       break;
     }
 
-    if( FD_UNLIKELY( (ret = fd_runtime_block_verify_tpool( &block_info, &slot_ctx->slot_bank.poh, &slot_ctx->slot_bank.poh, fd_scratch_virtual(), tpool )) != FD_RUNTIME_EXECUTE_SUCCESS ) ) {
+    if( poh_verified ) {
+      /* The caller already verified the PoH of the block, starting from
+         the current PoH hash.  Just advance to the last entry hash. */
+      if( FD_UNLIKELY( !block_info.microblock_cnt ) ) {
+        ret = FD_RUNTIME_EXECUTE_GENERIC_ERR;
+        break;
+      }
+      fd_microblock_batch_info_t const * last_batch = &block_info.microblock_batch_infos[ block_info.microblock_batch_cnt-1UL ];
+      fd_memcpy( slot_ctx->slot_bank.poh.hash, last_batch->microblock_infos[ last_batch->microblock_cnt-1UL ].microblock_hdr.hash, sizeof(fd_hash_t) );
+    } else if( FD_UNLIKELY( (ret = fd_runtime_block_verify_tpool( &block_info, &slot_ctx->slot_bank.poh, &slot_ctx->slot_bank.poh, fd_scratch_virtual(), tpool )) != FD_RUNTIME_EXECUTE_SUCCESS ) ) {
       break;
     }
     if( FD_UNLIKELY( (ret = fd_runtime_block_execute_tpool( slot_ctx, capture_ctx, &block_info, tpool, spads, spad_cnt )) != FD_RUNTIME_EXECUTE_SUCCESS ) ) {
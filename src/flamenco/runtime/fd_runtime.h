@@ -202,7 +202,13 @@ FD_STATIC_ASSERT( FD_BPF_ALIGN_OF_U128==FD_ACCOUNT_REC_DATA_ALIGN, input_data_al
 #define FD_RUNTIME_VM_TRACE_FOOTPRINT (0UL)
 #endif
 
-#define FD_RUNTIME_MISC_FOOTPRINT (FD_RUNTIME_SYSCALL_TABLE_FOOTPRINT+FD_RUNTIME_VM_TRACE_FOOTPRINT)
+/* The curve25519 multiscalar mul syscall decompresses up to 512 points
+   (the syscall limit) into the spad, bounded here at 256 bytes per
+   point.  The allocation is released before the syscall returns, so
+   one is enough regardless of the instruction stack depth. */
+#define FD_RUNTIME_CURVE25519_MSM_FOOTPRINT (512UL*256UL)
+
+#define FD_RUNTIME_MISC_FOOTPRINT (FD_RUNTIME_SYSCALL_TABLE_FOOTPRINT+FD_RUNTIME_VM_TRACE_FOOTPRINT+FD_RUNTIME_CURVE25519_MSM_FOOTPRINT)
 
 /* Now finally, we bound out the footprint of transaction execution. */
 #define FD_RUNTIME_TRANSACTION_EXECUTION_FOOTPRINT(account_lock_limit, direct_mapping)                                         \
@@ -339,9 +345,27 @@ fd_runtime_prepare_txns_start( fd_exec_slot_ctx_t *         slot_ctx,
 void
 fd_runtime_pre_execute_check( fd_execute_txn_task_info_t * task_info );
 
+/* fd_runtime_prefetch_txns warms up the accounts that the txn_cnt
+   parsed transactions at txns will load (their static account keys and
+   their address lookup tables) on the fork of slot_ctx, such that they
+   are resident when the transactions are executed.  See
+   fd_acc_mgr_prefetch.  The prefetch runs on the calling thread and
+   must not overlap with any execution on the funk txn of slot_ctx that
+   writes to these accounts (e.g. the replay tile prefetches a
+   microblock from pack only after the bank it is dispatched to has
+   finished the previous one).  With acc_mgr->page_in set, this moves
+   page faults on a file backed funk off the executing thread.  Returns
+   the number of accounts found. */
+
+ulong
+fd_runtime_prefetch_txns( fd_exec_slot_ctx_t const * slot_ctx,
+                          fd_txn_p_t const *         txns,
+                          ulong                      txn_cnt );
+
 /* fd_runtime_process_txns is responsible for end-to-end preparing, executing,
    and finalizing a list of transactions. It will execute all of the
-   transactions on a single core. */
+   transactions on a single core.  The FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED
+   flag of txns is trusted, so txns must come from our own pack tile. */
 int
 fd_runtime_process_txns( fd_exec_slot_ctx_t * slot_ctx,
                          fd_spad_t *          spad,
@@ -424,15 +448,38 @@ fd_raw_block_txn_iter_ele( fd_raw_block_txn_iter_t iter, fd_txn_p_t * out_txn );
 
 /* Offline Replay *************************************************************/
 
+/* fd_runtime_block_eval_tpool executes the block of the slot following
+   slot_ctx from the blockstore.  If poh_verified is set, the caller
+   already verified the PoH of the block starting from the current PoH
+   hash of slot_ctx (e.g. with fd_runtime_block_verify_poh ahead of
+   execution) and it is not verified again. */
+
 int
 fd_runtime_block_eval_tpool( fd_exec_slot_ctx_t * slot_ctx,
                              fd_capture_ctx_t *   capture_ctx,
                              fd_tpool_t *         tpool,
                              ulong                scheduler,
+                             int                  poh_verified,
                              ulong *              txn_cnt,
                              fd_spad_t * *        spads,
                              ulong                spads_cnt );
 
+/* fd_runtime_block_verify_poh verifies the PoH entries of the block for
+   slot in blockstore, starting from in_poh_hash (the last entry hash of
+   the parent block), using tpool.  It does not depend on any execution
+   state, so offline replay can verify blocks ahead of executing them.
+   On success, returns FD_RUNTIME_EXECUTE_SUCCESS and sets *out_poh_hash
+   to the last entry hash of the block.  Allocates the parsed block from
+   valloc without freeing it (use a scratch scope). */
+
+int
+fd_runtime_block_verify_poh( fd_blockstore_t * blockstore,
+                             ulong             slot,
+                             fd_hash_t const * in_poh_hash,
+                             fd_hash_t *       out_poh_hash,
+                             fd_valloc_t       valloc,
+                             fd_tpool_t *      tpool );
+
 /* Genesis ********************************************************************/
 
 void
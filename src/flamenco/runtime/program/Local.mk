@@ -15,6 +15,8 @@ $(call add-objs,fd_bpf_program_util,fd_flamenco)
 
 $(call add-hdrs,fd_precompiles.h)
 $(call add-objs,fd_precompiles,fd_flamenco)
+$(call make-unit-test,test_precompiles,test_precompiles,fd_flamenco fd_funk fd_ballet fd_util,$(SECP256K1_LIBS))
+$(call run-unit-test,test_precompiles)
 
 ### Native programs
 
@@ -532,6 +532,22 @@ fd_bpf_execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t * p
     return FD_EXECUTOR_INSTR_ERR_PROGRAM_ENVIRONMENT_SETUP_FAILURE;
   }
 
+  vm->ptext = prog->ptext;
+
+  /* If programs are being profiled, sample this execution into the
+     program's profiler entry. */
+  fd_vm_prof_t * vm_prof = instr_ctx->slot_ctx->vm_prof;
+  if( vm_prof ) vm->prof = fd_vm_prof_prog_acquire( vm_prof, &instr_ctx->instr->program_id_pubkey );
+
+  /* Without direct mapping, track which parts of the copied input region
+     the program stores to so that deserialization only has to copy back
+     and compare account data that might have changed. */
+  if( !direct_mapping ) {
+    ulong dirty_sz = fd_vm_input_dirty_word_cnt( input_sz )*sizeof(ulong);
+    vm->input_dirty = fd_spad_alloc( instr_ctx->txn_ctx->spad, alignof(ulong), dirty_sz );
+    fd_memset( vm->input_dirty, 0, dirty_sz );
+  }
+
   fd_valloc_t valloc = fd_spad_virtual( instr_ctx->txn_ctx->spad );
 
 #ifdef FD_DEBUG_SBPF_TRACES
@@ -562,8 +578,10 @@ fd_bpf_execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t * p
   }
   vm->cu -= heap_cost_result;
 
-  int exec_err = fd_vm_exec( vm );
-  
+  long exec_tick0 = vm->prof ? fd_tickcount() : 0L;
+  int  exec_err   = fd_vm_exec( vm );
+  if( vm->prof ) fd_vm_prof_record( vm->prof, pre_insn_cus-vm->cu, (ulong)(fd_tickcount()-exec_tick0) );
+
   /* (SIMD-182) Consume ALL requested CUs on non-Syscall errors */
   if( FD_FEATURE_ACTIVE( instr_ctx->slot_ctx, consume_requested_cu_on_vm_err )
       && exec_err != FD_VM_ERR_SIGSYSCALL ) {
@@ -644,12 +662,12 @@ fd_bpf_execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t * p
 
   int err;
   if( FD_UNLIKELY( is_deprecated ) ) {
-    err = fd_bpf_loader_input_deserialize_unaligned( *instr_ctx, pre_lens, input, input_sz, !direct_mapping );
+    err = fd_bpf_loader_input_deserialize_unaligned( *instr_ctx, pre_lens, input, input_sz, vm->input_dirty, !direct_mapping );
     if( FD_UNLIKELY( err!=0 ) ) {
       return err;
     }
   } else {
-    err = fd_bpf_loader_input_deserialize_aligned( *instr_ctx, pre_lens, input, input_sz, !direct_mapping );
+    err = fd_bpf_loader_input_deserialize_aligned( *instr_ctx, pre_lens, input, input_sz, vm->input_dirty, !direct_mapping );
     if( FD_UNLIKELY( err!=0 ) ) {
       return err;
     }
@@ -33,7 +33,13 @@
   also have different write permissions. This should solve the problem of
   having to memcpy/memcmp account data regions (which can be up to 10MiB each).
   There is some nuance to this, as the account data can be resized. This means
-  that memcpys for account data regions can't totally be avoided. */
+  that memcpys for account data regions can't totally be avoided.
+
+  Until direct mapping is activated, the copy and compare after execution
+  is reduced by having the vm track which chunks of the input region were
+  stored to (see FD_VM_INPUT_DIRTY_CHUNK_SZ).  Account data that the
+  program never stored to, and whose length is unchanged, is still equal
+  to the account's data, so deserialization skips it. */
 
 /* Add a new memory region to represent the input region. All of the memory
    regions here have sorted virtual addresses. These regions may or may not
@@ -309,6 +315,7 @@ fd_bpf_loader_input_deserialize_aligned( fd_exec_instr_ctx_t ctx,
                                          ulong const *       pre_lens,
                                          uchar *             buffer,
                                          ulong FD_FN_UNUSED  buffer_sz,
+                                         ulong const *       input_dirty,
                                          int                 copy_account_data ) {
   /* TODO: An optimization would be to skip ahead through non-writable accounts */
   /* https://github.com/anza-xyz/agave/blob/b5f5c3cdd3f9a5859c49ebc27221dc27e143d760/programs/bpf_loader/src/serialization.rs#L507 */
@@ -366,18 +373,27 @@ fd_bpf_loader_input_deserialize_aligned( fd_exec_instr_ctx_t ctx,
       }
 
       if( copy_account_data ) {
+        /* If the program never stored to the account data and the length
+           is unchanged, the serialized data is still identical to the
+           account data.  Copying it back is then a no-op and the compare
+           below would always succeed, so skip both. */
+        int data_clean = post_len==pre_len && metadata_check->dlen==pre_len &&
+                         !fd_vm_input_dirty_test( input_dirty, start, pre_len );
+
         /* https://github.com/anza-xyz/agave/blob/b5f5c3cdd3f9a5859c49ebc27221dc27e143d760/programs/bpf_loader/src/serialization.rs#L551-563 */
         int err = 0;
         if( fd_account_can_data_be_resized( &ctx, view_acc->const_meta, post_len, &err ) &&
             fd_account_can_data_be_changed( &ctx, i, &err ) ) {
 
-          int err = fd_account_set_data_from_slice( &ctx, i, post_data, post_len );
-          if( FD_UNLIKELY( err ) ) {
-            return err;
+          if( !data_clean ) {
+            int err = fd_account_set_data_from_slice( &ctx, i, post_data, post_len );
+            if( FD_UNLIKELY( err ) ) {
+              return err;
+            }
           }
 
         } else if( FD_UNLIKELY( view_acc->const_meta->dlen!=post_len ||
-                                memcmp( view_acc->const_data, post_data, post_len ) ) ) {
+                                ( !data_clean && memcmp( view_acc->const_data, post_data, post_len ) ) ) ) {
           return err;
         }
         start += pre_len;
@@ -574,6 +590,7 @@ fd_bpf_loader_input_deserialize_unaligned( fd_exec_instr_ctx_t ctx,
                                            ulong const *       pre_lens,
                                            uchar *             input,
                                            ulong               input_sz,
+                                           ulong const *       input_dirty,
                                            int                 copy_account_data ) {
   uchar * input_cursor = input;
 
@@ -612,15 +629,20 @@ fd_bpf_loader_input_deserialize_unaligned( fd_exec_instr_ctx_t ctx,
         ulong   pre_len   = pre_lens[i];
         uchar * post_data = input_cursor;
         if( view_acc->const_meta ) {
+          /* See fd_bpf_loader_input_deserialize_aligned */
+          int data_clean = view_acc->const_meta->dlen==pre_len &&
+                           !fd_vm_input_dirty_test( input_dirty, (ulong)(post_data-input), pre_len );
           int err = 0;
           if( fd_account_can_data_be_resized( &ctx, view_acc->const_meta, pre_len, &err ) &&
               fd_account_can_data_be_changed( &ctx, i, &err ) ) {
-            err = fd_account_set_data_from_slice( &ctx, i, post_data, pre_len );
-            if( FD_UNLIKELY( err ) ) {
-              return err;
+            if( !data_clean ) {
+              err = fd_account_set_data_from_slice( &ctx, i, post_data, pre_len );
+              if( FD_UNLIKELY( err ) ) {
+                return err;
+              }
             }
           } else if( view_acc->const_meta->dlen != pre_len ||
-                     memcmp( post_data, view_acc->const_data, pre_len ) ) {
+                     ( !data_clean && memcmp( post_data, view_acc->const_data, pre_len ) ) ) {
             return err;
           }
         }
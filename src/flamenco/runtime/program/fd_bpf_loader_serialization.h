@@ -17,11 +17,19 @@ fd_bpf_loader_input_serialize_aligned( fd_exec_instr_ctx_t       ctx,
                                        fd_vm_acc_region_meta_t * acc_region_metas,
                                        int                       copy_account_data );
 
+/* fd_bpf_loader_input_deserialize_{aligned,unaligned} apply the
+   changes a program made to its input region back to the instruction's
+   borrowed accounts.  When copy_account_data is set, input_dirty is the
+   vm's dirty chunk bitmap for the input region (or NULL if stores were
+   not tracked) and account data that lies entirely in clean chunks is
+   neither copied back nor compared. */
+
 int
 fd_bpf_loader_input_deserialize_aligned( fd_exec_instr_ctx_t ctx, 
                                          ulong const *       pre_lens,
                                          uchar *             buffer,
                                          ulong               buffer_sz,
+                                         ulong const *       input_dirty,
                                          int                 copy_account_data );
 
 uchar *
@@ -38,6 +46,7 @@ fd_bpf_loader_input_deserialize_unaligned( fd_exec_instr_ctx_t ctx,
                                            ulong const *       pre_lens,
                                            uchar *             input,
                                            ulong               input_sz,
+                                           ulong const *       input_dirty,
                                            int                 copy_account_data );
 
 
@@ -21,6 +21,10 @@ fd_sbpf_validated_program_new( void * mem, fd_sbpf_elf_info_t const * elf_info )
   l = FD_LAYOUT_APPEND( l, fd_sbpf_calldests_align(), fd_sbpf_calldests_footprint(elf_info->rodata_sz/8UL) );
   validated_prog->rodata = (uchar *)mem + l;
 
+  /* pre-decoded text backing memory */
+  l = FD_LAYOUT_APPEND( l, 8UL, elf_info->rodata_footprint );
+  validated_prog->ptext = (fd_vm_pinstr_t *)( (uchar *)mem + fd_ulong_align_up( l, FD_VM_PINSTR_ALIGN ) );
+
   /* SBPF version */
   validated_prog->sbpf_version = elf_info->sbpf_version;
 
@@ -38,6 +42,7 @@ fd_sbpf_validated_program_footprint( fd_sbpf_elf_info_t const * elf_info ) {
   l = FD_LAYOUT_APPEND( l, alignof(fd_sbpf_validated_program_t), sizeof(fd_sbpf_validated_program_t) );
   l = FD_LAYOUT_APPEND( l, fd_sbpf_calldests_align(), fd_sbpf_calldests_footprint(elf_info->rodata_sz/8UL) );
   l = FD_LAYOUT_APPEND( l, 8UL, elf_info->rodata_footprint );
+  l = FD_LAYOUT_APPEND( l, FD_VM_PINSTR_ALIGN, fd_vm_predecode_footprint( elf_info->text_cnt ) );
   l = FD_LAYOUT_FINI( l, 128UL );
   return l;
 }
@@ -281,6 +286,14 @@ fd_bpf_create_bpf_program_cache_entry( fd_exec_slot_ctx_t    * slot_ctx,
     validated_prog->text_sz = prog->text_sz;
     validated_prog->rodata_sz = prog->rodata_sz;
 
+    /* Pre-decode the text once here so every execution of the program
+       can skip instruction decoding.  The space was sized from the ELF
+       headers, so fall back to the raw text in the (unexpected) case
+       the loaded text is larger. */
+
+    if( FD_UNLIKELY( prog->text_cnt>elf_info.text_cnt ) ) validated_prog->ptext = NULL;
+    else validated_prog->ptext = fd_vm_predecode( validated_prog->ptext, prog->text, prog->text_cnt );
+
     return 0;
   } FD_SCRATCH_SCOPE_END;
 }
@@ -4,6 +4,7 @@
 #include "../../fd_flamenco_base.h"
 #include "../../../ballet/sbpf/fd_sbpf_loader.h"
 #include "../../../funk/fd_funk_txn.h"
+#include "../../vm/fd_vm_base.h"
 
 struct fd_sbpf_validated_program {
   ulong magic;
@@ -23,9 +24,14 @@ struct fd_sbpf_validated_program {
 
   uchar * rodata;
 
-  /* Backing memory for calldests and rodata */
+  /* Pre-decoded text (see fd_vm_predecode), indexed [0,text_cnt), NULL
+     if the program was not pre-decoded. */
+  fd_vm_pinstr_t * ptext;
+
+  /* Backing memory for calldests, rodata and ptext */
   // uchar calldests_shmem[];
   // uchar rodata[];
+  // fd_vm_pinstr_t ptext[];
 
   /* SBPF version, SIMD-0161 */
   ulong sbpf_version;
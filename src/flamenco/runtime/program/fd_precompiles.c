@@ -1,5 +1,6 @@
 #include "fd_precompiles.h"
 #include "../fd_executor_err.h"
+#include "../fd_system_ids.h"
 #include "../../../ballet/keccak256/fd_keccak256.h"
 #include "../../../ballet/ed25519/fd_ed25519.h"
 #include "../../../ballet/secp256k1/fd_secp256k1.h"
@@ -75,7 +76,8 @@ FD_STATIC_ASSERT( sizeof( fd_secp256k1_signature_offsets_t )==SECP256K1_SIGNATUR
    We handle the special case of index==0xFFFF as in Ed25519.
    We handle errors as in Secp256k1. */
 static inline int
-fd_precompile_get_instr_data( fd_exec_txn_ctx_t *     txn_ctx,
+fd_precompile_get_instr_data( fd_txn_t const *        txn,
+                              uchar const *           payload,
                               fd_txn_instr_t const *  cur_instr,
                               ushort                  index,
                               ushort                  offset,
@@ -92,17 +94,16 @@ fd_precompile_get_instr_data( fd_exec_txn_ctx_t *     txn_ctx,
   if( index==USHORT_MAX ) {
 
     /* Use current instruction data */
-    data    = fd_txn_get_instr_data( cur_instr, txn_ctx->_txn_raw->raw );
+    data    = fd_txn_get_instr_data( cur_instr, payload );
     data_sz = cur_instr->data_sz;
 
   } else {
 
-    fd_txn_t const * txn_descriptor = txn_ctx->txn_descriptor;
-    if( FD_UNLIKELY( index >= txn_descriptor->instr_cnt ) )
+    if( FD_UNLIKELY( index >= txn->instr_cnt ) )
       return FD_EXECUTOR_PRECOMPILE_ERR_DATA_OFFSET;
 
-    fd_txn_instr_t const * instr = &txn_descriptor->instr[index];
-    data    = fd_txn_get_instr_data( instr, txn_ctx->_txn_raw->raw );
+    fd_txn_instr_t const * instr = &txn->instr[index];
+    data    = fd_txn_get_instr_data( instr, payload );
     data_sz = instr->data_sz;
 
   }
@@ -118,11 +119,13 @@ fd_precompile_get_instr_data( fd_exec_txn_ctx_t *     txn_ctx,
   Ed25519
 */
 
-int
-fd_precompile_ed25519_verify( fd_exec_txn_ctx_t *    txn_ctx,
-                              fd_txn_instr_t const * instr ) {
+static int
+fd_precompile_ed25519_verify_core( fd_txn_t const *       txn,
+                                   uchar const *          payload,
+                                   fd_txn_instr_t const * instr,
+                                   uint *                 custom_err ) {
 
-  uchar const * data    = fd_txn_get_instr_data( instr, txn_ctx->_txn_raw->raw );
+  uchar const * data    = fd_txn_get_instr_data( instr, payload );
   ulong         data_sz = instr->data_sz;
 
   /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/ed25519_instruction.rs#L90-L96
@@ -138,20 +141,20 @@ fd_precompile_ed25519_verify( fd_exec_txn_ctx_t *    txn_ctx,
     if( FD_UNLIKELY( data_sz == 2 && data[0] == 0 ) ) {
       return FD_EXECUTOR_INSTR_SUCCESS;
     }
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
   ulong sig_cnt = data[0];
   if( FD_UNLIKELY( sig_cnt==0 ) ) {
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
   /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/ed25519_instruction.rs#L97-L103 */
   ulong expected_data_size = sig_cnt * SIGNATURE_OFFSETS_SERIALIZED_SIZE + SIGNATURE_OFFSETS_START;
   if( FD_UNLIKELY( data_sz < expected_data_size ) ) {
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
@@ -165,14 +168,15 @@ fd_precompile_ed25519_verify( fd_exec_txn_ctx_t *    txn_ctx,
 
     /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/ed25519_instruction.rs#L114-L121 */
     uchar const * sig = NULL;
-    int err = fd_precompile_get_instr_data( txn_ctx,
+    int err = fd_precompile_get_instr_data( txn,
+                                            payload,
                                             instr,
                                             sigoffs->sig_instr_idx,
                                             sigoffs->sig_offset,
                                             SIGNATURE_SERIALIZED_SIZE,
                                             &sig );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
@@ -182,14 +186,15 @@ fd_precompile_ed25519_verify( fd_exec_txn_ctx_t *    txn_ctx,
 
     /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/ed25519_instruction.rs#L126-L133 */
     uchar const * pubkey = NULL;
-    err = fd_precompile_get_instr_data( txn_ctx,
+    err = fd_precompile_get_instr_data( txn,
+                                        payload,
                                         instr,
                                         sigoffs->pubkey_instr_idx,
                                         sigoffs->pubkey_offset,
                                         ED25519_PUBKEY_SERIALIZED_SIZE,
                                         &pubkey );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
@@ -200,21 +205,22 @@ fd_precompile_ed25519_verify( fd_exec_txn_ctx_t *    txn_ctx,
     /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/ed25519_instruction.rs#L138-L145 */
     uchar const * msg = NULL;
     ushort msg_sz = sigoffs->msg_data_sz;
-    err = fd_precompile_get_instr_data( txn_ctx,
+    err = fd_precompile_get_instr_data( txn,
+                                        payload,
                                         instr,
                                         sigoffs->msg_instr_idx,
                                         sigoffs->msg_offset,
                                         msg_sz,
                                         &msg );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
     /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/ed25519_instruction.rs#L147-L149 */
     fd_sha512_t sha[1];
     if( FD_UNLIKELY( fd_ed25519_verify( msg, msg_sz, sig, pubkey, sha )!=FD_ED25519_SUCCESS ) ) {
-      txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
+      *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
   }
@@ -226,11 +232,13 @@ fd_precompile_ed25519_verify( fd_exec_txn_ctx_t *    txn_ctx,
   Secp256K1
 */
 
-int
-fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
-                                fd_txn_instr_t const * instr ) {
+static int
+fd_precompile_secp256k1_verify_core( fd_txn_t const *       txn,
+                                     uchar const *          payload,
+                                     fd_txn_instr_t const * instr,
+                                     uint *                 custom_err ) {
 
-  uchar const * data    = fd_txn_get_instr_data( instr, txn_ctx->_txn_raw->raw );
+  uchar const * data    = fd_txn_get_instr_data( instr, payload );
   ulong         data_sz = instr->data_sz;
 
   /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/secp256k1_instruction.rs#L934-L947
@@ -239,21 +247,21 @@ fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
     if( FD_UNLIKELY( data_sz == 1 && data[0] == 0 ) ) {
       return FD_EXECUTOR_INSTR_SUCCESS;
     }
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
   /* https://github.com/anza-xyz/agave/blob/574bae8fefc0ed256b55340b9d87b7689bcdf222/sdk/src/secp256k1_instruction.rs#L938-L947 */
   ulong sig_cnt = data[0];
   if( FD_UNLIKELY( sig_cnt==0 && data_sz>1 ) ) {
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
   /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/secp256k1_instruction.rs#L948-L953 */
   ulong expected_data_size = sig_cnt * SECP256K1_SIGNATURE_OFFSETS_SERIALIZED_SIZE + SECP256K1_SIGNATURE_OFFSETS_START;
   if( FD_UNLIKELY( data_sz < expected_data_size ) ) {
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
@@ -269,14 +277,15 @@ fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
        Note: for whatever reason, Agave returns InvalidInstructionDataSize instead of InvalidDataOffsets.
        We just return the err as is. */
     uchar const * sig = NULL;
-    int err = fd_precompile_get_instr_data( txn_ctx,
+    int err = fd_precompile_get_instr_data( txn,
+                                            payload,
                                             instr,
                                             sigoffs->sig_instr_idx,
                                             sigoffs->sig_offset,
                                             SIGNATURE_SERIALIZED_SIZE + 1, /* extra byte is recovery id */
                                             &sig );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
@@ -287,28 +296,30 @@ fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
 
     /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/secp256k1_instruction.rs#L983-L989 */
     uchar const * eth_address = NULL;
-    err = fd_precompile_get_instr_data( txn_ctx,
+    err = fd_precompile_get_instr_data( txn,
+                                        payload,
                                         instr,
                                         sigoffs->pubkey_instr_idx,
                                         sigoffs->pubkey_offset,
                                         SECP256K1_PUBKEY_SERIALIZED_SIZE,
                                         &eth_address );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
     /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/secp256k1_instruction.rs#L991-L997 */
     uchar const * msg = NULL;
     ushort msg_sz = sigoffs->msg_data_sz;
-    err = fd_precompile_get_instr_data( txn_ctx,
+    err = fd_precompile_get_instr_data( txn,
+                                        payload,
                                         instr,
                                         sigoffs->msg_instr_idx,
                                         sigoffs->msg_offset,
                                         msg_sz,
                                         &msg );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
@@ -319,7 +330,7 @@ fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
     /* https://github.com/anza-xyz/agave/blob/v1.18.12/sdk/src/secp256k1_instruction.rs#L1003-L1008 */
     uchar pubkey[64];
     if ( FD_UNLIKELY( fd_secp256k1_recover( pubkey, msg_hash, sig, recovery_id ) == NULL ) ) {
-      txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
+      *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
@@ -328,7 +339,7 @@ fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
     fd_keccak256_hash( pubkey, 64, pubkey_hash );
 
     if( FD_UNLIKELY( memcmp( eth_address, pubkey_hash+(FD_KECCAK256_HASH_SZ-SECP256K1_PUBKEY_SERIALIZED_SIZE), SECP256K1_PUBKEY_SERIALIZED_SIZE ) ) ) {
-      txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
+      *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
   }
@@ -341,29 +352,31 @@ fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
 */
 
 #ifdef FD_HAS_S2NBIGNUM
-int
-fd_precompile_secp256r1_verify( fd_exec_txn_ctx_t *    txn_ctx,
-                                fd_txn_instr_t const * instr ) {
+static int
+fd_precompile_secp256r1_verify_core( fd_txn_t const *       txn,
+                                     uchar const *          payload,
+                                     fd_txn_instr_t const * instr,
+                                     uint *                 custom_err ) {
 
-  uchar const * data    = fd_txn_get_instr_data( instr, txn_ctx->_txn_raw->raw );
+  uchar const * data    = fd_txn_get_instr_data( instr, payload );
   ulong         data_sz = instr->data_sz;
 
   /* ... */
   if( FD_UNLIKELY( data_sz < DATA_START ) ) {
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
   ulong sig_cnt = data[0];
   if( FD_UNLIKELY( sig_cnt==0 ) ) {
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
   /* ... */
   ulong expected_data_size = sig_cnt * SIGNATURE_OFFSETS_SERIALIZED_SIZE + SIGNATURE_OFFSETS_START;
   if( FD_UNLIKELY( data_sz < expected_data_size ) ) {
-    txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
+    *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_INSTR_DATA_SIZE;
     return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
   }
 
@@ -374,48 +387,51 @@ fd_precompile_secp256r1_verify( fd_exec_txn_ctx_t *    txn_ctx,
 
     /* ... */
     uchar const * sig = NULL;
-    int err = fd_precompile_get_instr_data( txn_ctx,
+    int err = fd_precompile_get_instr_data( txn,
+                                            payload,
                                             instr,
                                             sigoffs->sig_instr_idx,
                                             sigoffs->sig_offset,
                                             SIGNATURE_SERIALIZED_SIZE,
                                             &sig );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
     /* ... */
     uchar const * pubkey = NULL;
-    err = fd_precompile_get_instr_data( txn_ctx,
+    err = fd_precompile_get_instr_data( txn,
+                                        payload,
                                         instr,
                                         sigoffs->pubkey_instr_idx,
                                         sigoffs->pubkey_offset,
                                         SECP256R1_PUBKEY_SERIALIZED_SIZE,
                                         &pubkey );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
     /* ... */
     uchar const * msg = NULL;
     ushort msg_sz = sigoffs->msg_data_sz;
-    err = fd_precompile_get_instr_data( txn_ctx,
+    err = fd_precompile_get_instr_data( txn,
+                                        payload,
                                         instr,
                                         sigoffs->msg_instr_idx,
                                         sigoffs->msg_offset,
                                         msg_sz,
                                         &msg );
     if( FD_UNLIKELY( err ) ) {
-      txn_ctx->custom_err = (uint)err;
+      *custom_err = (uint)err;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
 
     /* ... */
     fd_sha256_t sha[1];
     if( FD_UNLIKELY( fd_secp256r1_verify( msg, msg_sz, sig, pubkey, sha )!=FD_SECP256R1_SUCCESS ) ) {
-      txn_ctx->custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
+      *custom_err = FD_EXECUTOR_PRECOMPILE_ERR_SIGNATURE;
       return FD_EXECUTOR_INSTR_ERR_CUSTOM_ERR;
     }
   }
@@ -423,9 +439,55 @@ fd_precompile_secp256r1_verify( fd_exec_txn_ctx_t *    txn_ctx,
   return FD_EXECUTOR_INSTR_SUCCESS;
 }
 #else
-int
-fd_precompile_secp256r1_verify( FD_PARAM_UNUSED fd_exec_txn_ctx_t *    txn_ctx,
-                                FD_PARAM_UNUSED fd_txn_instr_t const * instr ) {
+static int
+fd_precompile_secp256r1_verify_core( FD_PARAM_UNUSED fd_txn_t const *       txn,
+                                     FD_PARAM_UNUSED uchar const *          payload,
+                                     FD_PARAM_UNUSED fd_txn_instr_t const * instr,
+                                     FD_PARAM_UNUSED uint *                 custom_err ) {
   return FD_EXECUTOR_INSTR_ERR_FATAL;
 }
 #endif
+
+/*
+  Entrypoints
+*/
+
+int
+fd_precompile_ed25519_verify( fd_exec_txn_ctx_t *    txn_ctx,
+                              fd_txn_instr_t const * instr ) {
+  return fd_precompile_ed25519_verify_core( txn_ctx->txn_descriptor, txn_ctx->_txn_raw->raw, instr, &txn_ctx->custom_err );
+}
+
+int
+fd_precompile_secp256k1_verify( fd_exec_txn_ctx_t *    txn_ctx,
+                                fd_txn_instr_t const * instr ) {
+  return fd_precompile_secp256k1_verify_core( txn_ctx->txn_descriptor, txn_ctx->_txn_raw->raw, instr, &txn_ctx->custom_err );
+}
+
+int
+fd_precompile_secp256r1_verify( fd_exec_txn_ctx_t *    txn_ctx,
+                                fd_txn_instr_t const * instr ) {
+  return fd_precompile_secp256r1_verify_core( txn_ctx->txn_descriptor, txn_ctx->_txn_raw->raw, instr, &txn_ctx->custom_err );
+}
+
+int
+fd_precompile_verify_txn( fd_txn_t const * txn,
+                          uchar const *    payload ) {
+  fd_acct_addr_t const * tx_accs = fd_txn_get_acct_addrs( txn, payload );
+  for( ushort i=0; i<txn->instr_cnt; i++ ) {
+    fd_txn_instr_t const * instr      = &txn->instr[i];
+    fd_acct_addr_t const * program_id = tx_accs + instr->program_id;
+    uint                   custom_err = 0U;
+    int                    err        = FD_EXECUTOR_INSTR_SUCCESS;
+    if( !memcmp( program_id, &fd_solana_ed25519_sig_verify_program_id, sizeof(fd_pubkey_t) ) ) {
+      err = fd_precompile_ed25519_verify_core( txn, payload, instr, &custom_err );
+    } else if( !memcmp( program_id, &fd_solana_keccak_secp_256k_program_id, sizeof(fd_pubkey_t) ) ) {
+      err = fd_precompile_secp256k1_verify_core( txn, payload, instr, &custom_err );
+    } else if( !memcmp( program_id, &fd_solana_secp256r1_program_id, sizeof(fd_pubkey_t) ) ) {
+      /* Feature gated, leave it to execution */
+      return 0;
+    }
+    if( FD_UNLIKELY( err ) ) return 0;
+  }
+  return 1;
+}
@@ -27,6 +27,19 @@ int
 fd_precompile_secp256r1_verify( fd_exec_txn_ctx_t *     txn_ctx,
                                 fd_txn_instr_t const *  instr );
 
+/* fd_precompile_verify_txn verifies the signatures of all ed25519 and
+   secp256k1 precompile instructions of txn, whose serialized form is
+   payload.  These checks only depend on the transaction itself, so they
+   can be done ahead of execution, e.g. in parallel by the verify tiles
+   (see FD_TXN_P_FLAGS_PRECOMPILE_VERIFIED).  Returns 1 if all of them
+   are valid and txn has no secp256r1 instruction (feature gated, so
+   left to execution), and 0 otherwise, in which case execution will
+   verify the transaction and report the appropriate error. */
+
+int
+fd_precompile_verify_txn( fd_txn_t const * txn,
+                          uchar const *    payload );
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_flamenco_runtime_program_fd_precompiles_h */
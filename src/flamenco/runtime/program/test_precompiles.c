@@ -0,0 +1,118 @@
+#include "fd_precompiles.h"
+#include "../fd_system_ids.h"
+#include "../../../ballet/ed25519/fd_ed25519.h"
+
+/* Tests fd_precompile_verify_txn on single instruction legacy
+   transactions built by hand and parsed with fd_txn_parse. */
+
+#define MSG_SZ      (32UL)
+#define DATA_HDR_SZ (16UL) /* count, padding and one offsets struct */
+#define PUBKEY_OFF  (DATA_HDR_SZ)
+#define SIG_OFF     (PUBKEY_OFF+32UL)
+#define MSG_OFF     (SIG_OFF+64UL)
+#define DATA_SZ     (MSG_OFF+MSG_SZ)
+
+static uchar payload[ FD_TXN_MTU ];
+static uchar txn_buf[ FD_TXN_MAX_SZ ] __attribute__((aligned(alignof(fd_txn_t))));
+
+/* make_txn builds and parses a transaction whose only instruction
+   invokes prog with data.  Returns the parsed transaction. */
+
+static fd_txn_t const *
+make_txn( fd_pubkey_t const * prog,
+          uchar const *       data,
+          ulong               data_sz ) {
+  uchar * p = payload;
+  *p++ = 1;                                        /* signature cnt */
+  fd_memset( p, 0x11, 64UL );      p += 64UL;      /* fee payer signature, not checked here */
+  *p++ = 1; *p++ = 0; *p++ = 1;                    /* message header */
+  *p++ = 2;                                        /* account cnt */
+  fd_memset( p, 0x22, 32UL );      p += 32UL;      /* fee payer */
+  fd_memcpy( p, prog->uc, 32UL );  p += 32UL;
+  fd_memset( p, 0x33, 32UL );      p += 32UL;      /* recent blockhash */
+  *p++ = 1;                                        /* instruction cnt */
+  *p++ = 1;                                        /* program id index */
+  *p++ = 0;                                        /* account cnt */
+  if( data_sz<0x80UL ) {                           /* data_sz as a compact-u16 */
+    *p++ = (uchar)data_sz;
+  } else {
+    *p++ = (uchar)( 0x80UL | (data_sz & 0x7fUL) );
+    *p++ = (uchar)( data_sz>>7 );
+  }
+  fd_memcpy( p, data, data_sz );   p += data_sz;
+
+  FD_TEST( fd_txn_parse( payload, (ulong)(p-payload), txn_buf, NULL ) );
+  return (fd_txn_t const *)txn_buf;
+}
+
+/* make_ed25519_data formats the data of an ed25519 precompile
+   instruction with one signature of a MSG_SZ byte message, all in the
+   instruction itself. */
+
+static void
+make_ed25519_data( uchar         data[ DATA_SZ ],
+                   fd_sha512_t * sha ) {
+  uchar private_key[ 32 ];
+  for( ulong i=0UL; i<32UL; i++ ) private_key[ i ] = (uchar)i;
+
+  fd_memset( data, 0, DATA_SZ );
+  data[ 0 ] = 1;
+  ushort offsets[ 7 ] = { (ushort)SIG_OFF, USHORT_MAX, (ushort)PUBKEY_OFF, USHORT_MAX,
+                          (ushort)MSG_OFF, (ushort)MSG_SZ, USHORT_MAX };
+  fd_memcpy( data+2UL, offsets, sizeof(offsets) );
+
+  for( ulong i=0UL; i<MSG_SZ; i++ ) data[ MSG_OFF+i ] = (uchar)(0xa0UL+i);
+  FD_TEST( fd_ed25519_public_from_private( data+PUBKEY_OFF, private_key, sha ) );
+  FD_TEST( fd_ed25519_sign( data+SIG_OFF, data+MSG_OFF, MSG_SZ, data+PUBKEY_OFF, private_key, sha ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  fd_sha512_t _sha[1];
+  fd_sha512_t * sha = fd_sha512_join( fd_sha512_new( _sha ) );
+
+  uchar data[ DATA_SZ ];
+  uchar bad [ DATA_SZ ];
+  make_ed25519_data( data, sha );
+
+  /* Valid signature */
+
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_ed25519_sig_verify_program_id, data, DATA_SZ ), payload )==1 );
+
+  /* Bad signature or message */
+
+  fd_memcpy( bad, data, DATA_SZ ); bad[ SIG_OFF+1UL ] ^= (uchar)1;
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_ed25519_sig_verify_program_id, bad, DATA_SZ ), payload )==0 );
+  fd_memcpy( bad, data, DATA_SZ ); bad[ MSG_OFF ] ^= (uchar)1;
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_ed25519_sig_verify_program_id, bad, DATA_SZ ), payload )==0 );
+
+  /* Bad data offsets: message past the end of the instruction data,
+     and signature in an instruction that does not exist */
+
+  fd_memcpy( bad, data, DATA_SZ ); FD_STORE( ushort, bad+2UL+8UL, (ushort)(MSG_OFF+1UL) );
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_ed25519_sig_verify_program_id, bad, DATA_SZ ), payload )==0 );
+  fd_memcpy( bad, data, DATA_SZ ); FD_STORE( ushort, bad+2UL+2UL, (ushort)1 );
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_ed25519_sig_verify_program_id, bad, DATA_SZ ), payload )==0 );
+
+  /* Data too short to hold the offsets */
+
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_ed25519_sig_verify_program_id, data, DATA_HDR_SZ-1UL ), payload )==0 );
+
+  /* No precompile instruction, so nothing to verify ahead of
+     execution */
+
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_system_program_id, bad, DATA_SZ ), payload )==1 );
+
+  /* secp256r1 is feature gated, so always left to execution */
+
+  FD_TEST( fd_precompile_verify_txn( make_txn( &fd_solana_secp256r1_program_id, data, DATA_SZ ), payload )==0 );
+
+  fd_sha512_delete( fd_sha512_leave( sha ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -5,6 +5,11 @@ $(call add-objs,fd_sysvar,fd_flamenco)
 $(call add-hdrs,fd_sysvar_cache.h)
 $(call add-objs,fd_sysvar_cache,fd_flamenco)
 
+$(call add-hdrs,fd_sysvar_cache_store.h)
+$(call add-objs,fd_sysvar_cache_store,fd_flamenco)
+$(call make-unit-test,test_sysvar_cache_store,test_sysvar_cache_store,fd_flamenco fd_funk fd_ballet fd_util,$(SECP256K1_LIBS))
+$(call run-unit-test,test_sysvar_cache_store)
+
 $(call add-hdrs,fd_sysvar_clock.h)
 $(call add-objs,fd_sysvar_clock,fd_flamenco)
 
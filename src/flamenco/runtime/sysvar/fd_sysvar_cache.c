@@ -73,6 +73,39 @@ fd_sysvar_cache_delete( fd_sysvar_cache_t * cache ) {
   return (void *)cache;
 }
 
+fd_sysvar_cache_t *
+fd_sysvar_cache_copy( fd_sysvar_cache_t *       dst,
+                      fd_sysvar_cache_t const * src ) {
+
+  fd_bincode_destroy_ctx_t destroy = { .valloc = dst->valloc };
+
+  /* Round trip each sysvar through its bincode encoding, which is the
+     only deep copy the type generator provides. */
+
+# define X( type, name )                                                  \
+  do {                                                                    \
+    type##_destroy( dst->val_##name, &destroy );                          \
+    dst->has_##name = 0;                                                  \
+    if( !src->has_##name ) break;                                         \
+                                                                          \
+    ulong   sz  = type##_size( src->val_##name );                         \
+    uchar * buf = fd_valloc_malloc( dst->valloc, 8UL, sz );               \
+    fd_bincode_encode_ctx_t encode = { .data = buf, .dataend = buf+sz };  \
+    if( FD_UNLIKELY( type##_encode( src->val_##name, &encode ) ) )        \
+      FD_LOG_ERR(( "failed to encode sysvar " #name ));                   \
+                                                                          \
+    fd_bincode_decode_ctx_t decode =                                      \
+      { .data = buf, .dataend = buf+sz, .valloc = dst->valloc };          \
+    int err = type##_decode( dst->val_##name, &decode );                  \
+    dst->has_##name = (err==FD_BINCODE_SUCCESS);                          \
+    fd_valloc_free( dst->valloc, buf );                                   \
+  } while(0);
+  FD_SYSVAR_CACHE_ITER(X)
+# undef X
+
+  return dst;
+}
+
 /* Provide accessor methods */
 
 #define X( type, name )                                                \
@@ -104,6 +104,15 @@ fd_sysvar_cache_new( void *      mem,
 void *
 fd_sysvar_cache_delete( fd_sysvar_cache_t * cache );
 
+/* fd_sysvar_cache_copy replaces the contents of dst with a deep copy
+   of src.  Heap allocations for the copy are made from dst's valloc.
+   Used to obtain a private, modifiable copy of a shared sysvar cache
+   (see fd_sysvar_cache_store.h).  Returns dst. */
+
+fd_sysvar_cache_t *
+fd_sysvar_cache_copy( fd_sysvar_cache_t *       dst,
+                      fd_sysvar_cache_t const * src );
+
 /* fd_sysvar_cache_restore restores all sysvars from the given slot
    context.
 
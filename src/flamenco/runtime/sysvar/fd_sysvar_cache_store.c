@@ -0,0 +1,230 @@
+#include "fd_sysvar_cache_store.h"
+#include "../fd_system_ids.h"
+
+void *
+fd_sysvar_cache_store_new( void * shmem,
+                           ulong  ele_max,
+                           ulong  seed ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_sysvar_cache_store_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !ele_max ) ) {
+    FD_LOG_WARNING(( "zero ele_max" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_sysvar_cache_store_footprint( ele_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad ele_max" ));
+    return NULL;
+  }
+
+  fd_memset( shmem, 0, sizeof(fd_sysvar_cache_store_t) );
+
+  ulong chain_cnt = fd_sysvar_cache_store_map_chain_cnt_est( ele_max );
+
+  FD_SCRATCH_ALLOC_INIT( l, shmem );
+  fd_sysvar_cache_store_t * store = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_sysvar_cache_store_t),   sizeof(fd_sysvar_cache_store_t)                      );
+  void *                    pool  = FD_SCRATCH_ALLOC_APPEND( l, fd_sysvar_cache_store_pool_align(), fd_sysvar_cache_store_pool_footprint( ele_max )     );
+  void *                    map   = FD_SCRATCH_ALLOC_APPEND( l, fd_sysvar_cache_store_map_align(),  fd_sysvar_cache_store_map_footprint( chain_cnt )   );
+  FD_SCRATCH_ALLOC_FINI( l, fd_sysvar_cache_store_align() );
+
+  if( FD_UNLIKELY( !fd_sysvar_cache_store_pool_new( pool, ele_max ) ) ) return NULL;
+  if( FD_UNLIKELY( !fd_sysvar_cache_store_map_new( map, chain_cnt, seed ) ) ) return NULL;
+
+  FD_COMPILER_MFENCE();
+  store->magic = FD_SYSVAR_CACHE_STORE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_sysvar_cache_store_t *
+fd_sysvar_cache_store_join( void * shstore ) {
+
+  if( FD_UNLIKELY( !shstore ) ) {
+    FD_LOG_WARNING(( "NULL store" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shstore, fd_sysvar_cache_store_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned store" ));
+    return NULL;
+  }
+
+  fd_sysvar_cache_store_t * store = (fd_sysvar_cache_store_t *)shstore;
+
+  if( FD_UNLIKELY( store->magic!=FD_SYSVAR_CACHE_STORE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  ulong laddr = (ulong)shstore + sizeof(fd_sysvar_cache_store_t);
+
+  laddr       = fd_ulong_align_up( laddr, fd_sysvar_cache_store_pool_align() );
+  store->pool = fd_sysvar_cache_store_pool_join( (void *)laddr );
+  ulong max   = fd_sysvar_cache_store_pool_max( store->pool );
+  laddr      += fd_sysvar_cache_store_pool_footprint( max );
+
+  laddr       = fd_ulong_align_up( laddr, fd_sysvar_cache_store_map_align() );
+  store->map  = fd_sysvar_cache_store_map_join( (void *)laddr );
+
+  return store;
+}
+
+void *
+fd_sysvar_cache_store_leave( fd_sysvar_cache_store_t * store ) {
+
+  if( FD_UNLIKELY( !store ) ) {
+    FD_LOG_WARNING(( "NULL store" ));
+    return NULL;
+  }
+
+  return (void *)store;
+}
+
+void *
+fd_sysvar_cache_store_delete( void * shstore ) {
+
+  if( FD_UNLIKELY( !shstore ) ) {
+    FD_LOG_WARNING(( "NULL store" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shstore, fd_sysvar_cache_store_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned store" ));
+    return NULL;
+  }
+
+  fd_sysvar_cache_store_t * store = (fd_sysvar_cache_store_t *)shstore;
+
+  if( FD_UNLIKELY( store->magic!=FD_SYSVAR_CACHE_STORE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( store->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shstore;
+}
+
+fd_sysvar_cache_t *
+fd_sysvar_cache_store_acquire( fd_sysvar_cache_store_t * store,
+                               fd_funk_txn_xid_t const * xid,
+                               fd_acc_mgr_t *            acc_mgr,
+                               fd_funk_txn_t *           funk_txn,
+                               fd_valloc_t               valloc ) {
+
+  fd_sysvar_cache_store_ele_t * ele = fd_sysvar_cache_store_map_ele_query( store->map, xid, NULL, store->pool );
+  if( FD_LIKELY( ele ) ) {
+    ele->refcnt++;
+    store->hit_cnt++;
+    return ele->cache;
+  }
+
+  if( FD_UNLIKELY( !fd_sysvar_cache_store_pool_free( store->pool ) ) ) return NULL;
+
+  ele = fd_sysvar_cache_store_pool_ele_acquire( store->pool );
+  fd_funk_txn_xid_copy( &ele->xid, xid );
+  ele->refcnt = 1UL;
+  fd_sysvar_cache_new( ele->cache, valloc );
+  fd_sysvar_cache_restore( ele->cache, acc_mgr, funk_txn );
+  fd_sysvar_cache_store_map_ele_insert( store->map, ele, store->pool );
+  store->miss_cnt++;
+
+  return ele->cache;
+}
+
+void
+fd_sysvar_cache_store_release( fd_sysvar_cache_store_t * store,
+                               fd_sysvar_cache_t *       cache ) {
+
+# if FD_SYSVAR_CACHE_STORE_USE_HANDHOLDING
+  if( FD_UNLIKELY( !fd_sysvar_cache_store_owns( store, cache ) ) ) FD_LOG_ERR(( "cache not owned by store" ));
+# endif
+
+  fd_sysvar_cache_store_ele_t * ele = (fd_sysvar_cache_store_ele_t *)
+      ( (ulong)cache - offsetof( fd_sysvar_cache_store_ele_t, cache ) );
+
+  if( FD_UNLIKELY( !ele->refcnt ) ) FD_LOG_ERR(( "refcnt underflow" ));
+  if( --ele->refcnt ) return;
+
+  fd_sysvar_cache_store_map_ele_remove( store->map, &ele->xid, NULL, store->pool );
+  fd_sysvar_cache_delete( ele->cache );
+  fd_sysvar_cache_store_pool_ele_release( store->pool, ele );
+}
+
+fd_sysvar_cache_t *
+fd_sysvar_cache_store_modify( fd_sysvar_cache_store_t * store,
+                              fd_sysvar_cache_t *       cache,
+                              fd_valloc_t               valloc ) {
+
+  if( FD_LIKELY( !fd_sysvar_cache_store_owns( store, cache ) ) ) return cache;
+
+  fd_sysvar_cache_t * copy = fd_sysvar_cache_new( fd_valloc_malloc( valloc, fd_sysvar_cache_align(), fd_sysvar_cache_footprint() ), valloc );
+  if( FD_UNLIKELY( !copy ) ) FD_LOG_ERR(( "failed to allocate sysvar cache" ));
+  fd_sysvar_cache_copy( copy, cache );
+
+  fd_sysvar_cache_store_release( store, cache );
+  return copy;
+}
+
+fd_sysvar_cache_t *
+fd_sysvar_cache_store_detach( fd_sysvar_cache_store_t * store,
+                              fd_sysvar_cache_t *       cache,
+                              fd_valloc_t               valloc ) {
+
+  if( FD_LIKELY( !fd_sysvar_cache_store_owns( store, cache ) ) ) return cache;
+
+  fd_sysvar_cache_t * priv = fd_sysvar_cache_new( fd_valloc_malloc( valloc, fd_sysvar_cache_align(), fd_sysvar_cache_footprint() ), valloc );
+  if( FD_UNLIKELY( !priv ) ) FD_LOG_ERR(( "failed to allocate sysvar cache" ));
+
+  fd_sysvar_cache_store_release( store, cache );
+  return priv;
+}
+
+ulong
+fd_sysvar_cache_store_stale( fd_sysvar_cache_store_t const * store,
+                             fd_sysvar_cache_t const *       cache,
+                             fd_funk_t *                     funk,
+                             fd_funk_txn_t const *           funk_txn ) {
+
+  if( FD_UNLIKELY( !fd_sysvar_cache_store_owns( store, cache ) ) ) return ULONG_MAX;
+
+  fd_sysvar_cache_store_ele_t const * ele = (fd_sysvar_cache_store_ele_t const *)
+      ( (ulong)cache - offsetof( fd_sysvar_cache_store_ele_t, cache ) );
+
+  fd_funk_rec_key_t keys[] = {
+# define X( type, name ) fd_acc_funk_key( &fd_sysvar_##name##_id ),
+  FD_SYSVAR_CACHE_ITER(X)
+# undef X
+  };
+
+  /* Walk from funk_txn up to the cache's transaction.  Any record of a
+     cached sysvar in between (including erase tombstones) means the
+     shared cache is stale for that sysvar as seen from funk_txn. */
+
+  ulong stale = 0UL;
+  fd_funk_txn_t * txn_map = fd_funk_txn_map( funk, fd_funk_wksp( funk ) );
+  for( fd_funk_txn_t const * txn=funk_txn; txn; txn=fd_funk_txn_parent( (fd_funk_txn_t *)txn, txn_map ) ) {
+    if( fd_funk_txn_xid_eq( fd_funk_txn_xid( txn ), &ele->xid ) ) return stale;
+    for( ulong i=0UL; i<FD_SYSVAR_CACHE_STORE_IDX_CNT; i++ ) {
+      if( fd_funk_rec_query( funk, txn, &keys[ i ] ) ) stale |= 1UL<<i;
+    }
+  }
+
+  /* Reached the last published transaction without passing the cache's
+     transaction (e.g. it was published or funk_txn is on another fork) */
+
+  return fd_ulong_if( fd_funk_txn_xid_eq( fd_funk_root( funk ), &ele->xid ), stale, ULONG_MAX );
+}
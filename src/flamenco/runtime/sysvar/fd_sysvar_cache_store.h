@@ -0,0 +1,240 @@
+#ifndef HEADER_fd_src_flamenco_runtime_sysvar_fd_sysvar_cache_store_h
+#define HEADER_fd_src_flamenco_runtime_sysvar_fd_sysvar_cache_store_h
+
+/* fd_sysvar_cache_store shares decoded sysvar caches between replay
+   forks.
+
+   Every fork in the frontier needs a sysvar cache.  Without sharing,
+   starting a fork at a parent slot decodes every sysvar account (slot
+   hashes, stake history, recent block hashes, ...) into a fresh,
+   private fd_sysvar_cache_t, even though all forks started at the same
+   parent decode exactly the same accounts.  When many competing forks
+   are created (e.g. a leader rollback or a burst of forks under
+   contention), this repeated decoding and the resulting duplicate heap
+   copies dominate fork creation.
+
+   The store keeps at most one sysvar cache per funk transaction,
+   keyed by funk xid.  fd_sysvar_cache_store_acquire returns the shared
+   cache for a funk transaction, restoring it from funk on first use,
+   and bumps a reference count.  A shared cache is read-only.  Callers
+   that need to modify their sysvar cache (e.g. to resync a sysvar after
+   writing the account) first obtain a private copy with
+   fd_sysvar_cache_store_modify (copy-on-write).  The entry is freed
+   when its last reference is released.
+
+   Sharing is only sound for funk transactions that no longer receive
+   writes, since the cache is not invalidated.  This is the case for the
+   parent of a new fork, which has already been replayed.  A fork keeps
+   using the parent's shared cache while fd_sysvar_cache_store_stale
+   finds no write to a cached sysvar account in the fork's own funk
+   transactions.  After such writes (e.g. the clock and slot hashes
+   updates made when a block is prepared), the fork refreshes a private
+   copy of the shared cache by restoring only the written sysvars.  If
+   the shared cache does not belong to an ancestor of the fork, the
+   cache is reloaded from an empty private cache
+   (fd_sysvar_cache_store_detach), so no copy of the shared cache is
+   made that would be overwritten right away.
+
+   The store is not safe for concurrent use.  It is expected to be
+   owned by the replay tile (see fd_forks).  Readers of a shared cache
+   (e.g. exec threads) may read it concurrently as long as its owner
+   holds a reference. */
+
+#include "fd_sysvar_cache.h"
+
+/* FD_SYSVAR_CACHE_STORE_USE_HANDHOLDING:  Define this to non-zero at
+   compile time to turn on additional runtime checks. */
+
+#ifndef FD_SYSVAR_CACHE_STORE_USE_HANDHOLDING
+#define FD_SYSVAR_CACHE_STORE_USE_HANDHOLDING 1
+#endif
+
+struct fd_sysvar_cache_store_ele {
+  fd_funk_txn_xid_t xid;    /* map key */
+  ulong             next;   /* reserved for use by fd_pool and fd_map_chain */
+  ulong             refcnt; /* number of holders of cache */
+  fd_sysvar_cache_t cache[1];
+};
+typedef struct fd_sysvar_cache_store_ele fd_sysvar_cache_store_ele_t;
+
+#define POOL_NAME fd_sysvar_cache_store_pool
+#define POOL_T    fd_sysvar_cache_store_ele_t
+#include "../../../util/tmpl/fd_pool.c"
+
+#define MAP_NAME               fd_sysvar_cache_store_map
+#define MAP_ELE_T              fd_sysvar_cache_store_ele_t
+#define MAP_KEY_T              fd_funk_txn_xid_t
+#define MAP_KEY                xid
+#define MAP_KEY_EQ(k0,k1)      fd_funk_txn_xid_eq((k0),(k1))
+#define MAP_KEY_HASH(key,seed) fd_funk_txn_xid_hash((key),(seed))
+#include "../../../util/tmpl/fd_map_chain.c"
+
+struct fd_sysvar_cache_store {
+  ulong                         magic; /* ==FD_SYSVAR_CACHE_STORE_MAGIC */
+  fd_sysvar_cache_store_ele_t * pool;  /* memory pool of entries */
+  fd_sysvar_cache_store_map_t * map;   /* map of xid->entry */
+  ulong                         hit_cnt;
+  ulong                         miss_cnt;
+};
+typedef struct fd_sysvar_cache_store fd_sysvar_cache_store_t;
+
+#define FD_SYSVAR_CACHE_STORE_MAGIC (0xf17eda2ce75c5700UL) /* firedancer sysvar cache store version 0 */
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_sysvar_cache_store_{align,footprint} return the required alignment
+   and footprint of a memory region suitable for use as a store of up
+   to ele_max shared sysvar caches. */
+
+FD_FN_CONST static inline ulong
+fd_sysvar_cache_store_align( void ) {
+  return fd_ulong_max( alignof(fd_sysvar_cache_store_t),
+         fd_ulong_max( fd_sysvar_cache_store_pool_align(), fd_sysvar_cache_store_map_align() ) );
+}
+
+FD_FN_CONST static inline ulong
+fd_sysvar_cache_store_footprint( ulong ele_max ) {
+  return FD_LAYOUT_FINI(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_INIT,
+      alignof(fd_sysvar_cache_store_t),   sizeof(fd_sysvar_cache_store_t) ),
+      fd_sysvar_cache_store_pool_align(), fd_sysvar_cache_store_pool_footprint( ele_max ) ),
+      fd_sysvar_cache_store_map_align(),  fd_sysvar_cache_store_map_footprint( fd_sysvar_cache_store_map_chain_cnt_est( ele_max ) ) ),
+    fd_sysvar_cache_store_align() );
+}
+
+/* fd_sysvar_cache_store_new formats an unused memory region for use as
+   a sysvar cache store.  shmem is a non-NULL pointer to this region in
+   the local address space with the required footprint and alignment.
+   seed is an arbitrary value used to seed the xid hash.  Returns shmem
+   on success and NULL on failure (logs details). */
+
+void *
+fd_sysvar_cache_store_new( void * shmem,
+                           ulong  ele_max,
+                           ulong  seed );
+
+/* fd_sysvar_cache_store_join joins the caller to the store.  Returns a
+   pointer in the local address space to the store on success and NULL
+   on failure (logs details). */
+
+fd_sysvar_cache_store_t *
+fd_sysvar_cache_store_join( void * shstore );
+
+void *
+fd_sysvar_cache_store_leave( fd_sysvar_cache_store_t * store );
+
+/* fd_sysvar_cache_store_delete unformats a memory region used as a
+   store.  Assumes all shared caches have been released. */
+
+void *
+fd_sysvar_cache_store_delete( void * shstore );
+
+/* fd_sysvar_cache_store_owns returns 1 if cache is a shared cache
+   owned by store and 0 otherwise (e.g. it is a private cache). */
+
+FD_FN_PURE static inline int
+fd_sysvar_cache_store_owns( fd_sysvar_cache_store_t const * store,
+                            fd_sysvar_cache_t const *       cache ) {
+  ulong lo = (ulong)store->pool;
+  ulong hi = lo + fd_sysvar_cache_store_pool_max( store->pool )*sizeof(fd_sysvar_cache_store_ele_t);
+  return ((ulong)cache>=lo) & ((ulong)cache<hi);
+}
+
+/* fd_sysvar_cache_store_acquire returns the shared sysvar cache for the
+   funk transaction funk_txn with id xid, and acquires a reference to
+   it.  If no such cache exists, restores one from funk_txn using
+   acc_mgr.  Heap allocations for the sysvar data are made from valloc,
+   which must outlive the returned cache.  The returned cache must not
+   be modified.  Returns NULL if the store is full, in which case the
+   caller should fall back to a private cache. */
+
+fd_sysvar_cache_t *
+fd_sysvar_cache_store_acquire( fd_sysvar_cache_store_t * store,
+                               fd_funk_txn_xid_t const * xid,
+                               fd_acc_mgr_t *            acc_mgr,
+                               fd_funk_txn_t *           funk_txn,
+                               fd_valloc_t               valloc );
+
+/* fd_sysvar_cache_store_release releases a reference to cache, which
+   must have been returned by fd_sysvar_cache_store_acquire.  Frees the
+   shared cache if this was the last reference. */
+
+void
+fd_sysvar_cache_store_release( fd_sysvar_cache_store_t * store,
+                               fd_sysvar_cache_t *       cache );
+
+/* fd_sysvar_cache_store_modify prepares cache for modification.  If
+   cache is owned by store, allocates a private copy of it from valloc,
+   releases the reference to the shared cache and returns the copy.
+   Otherwise, cache is already private and is returned as is.  The
+   caller owns the returned cache, and must release it with
+   fd_valloc_free( valloc, fd_sysvar_cache_delete( cache ) ). */
+
+fd_sysvar_cache_t *
+fd_sysvar_cache_store_modify( fd_sysvar_cache_store_t * store,
+                              fd_sysvar_cache_t *       cache,
+                              fd_valloc_t               valloc );
+
+/* fd_sysvar_cache_store_detach is fd_sysvar_cache_store_modify for
+   callers that are about to restore every sysvar.  If cache is owned by
+   store, releases the reference to the shared cache and returns a new,
+   empty private cache allocated from valloc, without copying the shared
+   contents.  Otherwise, cache is returned as is. */
+
+fd_sysvar_cache_t *
+fd_sysvar_cache_store_detach( fd_sysvar_cache_store_t * store,
+                              fd_sysvar_cache_t *       cache,
+                              fd_valloc_t               valloc );
+
+/* FD_SYSVAR_CACHE_STORE_IDX_{name} is the bit of the sysvar name in
+   the mask returned by fd_sysvar_cache_store_stale.  Bits follow the
+   order of FD_SYSVAR_CACHE_ITER. */
+
+enum {
+# define X( type, name ) FD_SYSVAR_CACHE_STORE_IDX_##name,
+  FD_SYSVAR_CACHE_ITER(X)
+# undef X
+  FD_SYSVAR_CACHE_STORE_IDX_CNT
+};
+
+/* fd_sysvar_cache_store_stale returns the set of sysvars for which
+   cache, a shared cache owned by store, no longer matches the sysvar
+   accounts as seen from funk_txn (NULL for the last published
+   transaction).  Bit FD_SYSVAR_CACHE_STORE_IDX_{name} is set if the
+   sysvar account name has been written (or erased) in funk_txn or one
+   of its ancestors below the transaction the cache was restored from.
+   Returns 0 if the cache is fully valid for funk_txn, and ULONG_MAX if
+   cache is not owned by store or funk_txn does not descend from the
+   cache's transaction.  Cost is O(depth) funk record queries, where
+   depth is the number of transactions between funk_txn and the cache's
+   transaction.
+
+   The runtime rewrites some sysvars (clock, slot hashes, ...) at the
+   start of every slot, so a shared cache is typically stale for a few
+   sysvars only.  Such a caller refreshes a private copy of the cache
+   (fd_sysvar_cache_store_modify) by restoring just the stale sysvars. */
+
+ulong
+fd_sysvar_cache_store_stale( fd_sysvar_cache_store_t const * store,
+                             fd_sysvar_cache_t const *       cache,
+                             fd_funk_t *                     funk,
+                             fd_funk_txn_t const *           funk_txn );
+
+/* fd_sysvar_cache_store_valid returns 1 if cache is a shared cache
+   owned by store that still matches every sysvar account as seen from
+   funk_txn, and 0 otherwise. */
+
+static inline int
+fd_sysvar_cache_store_valid( fd_sysvar_cache_store_t const * store,
+                             fd_sysvar_cache_t const *       cache,
+                             fd_funk_t *                     funk,
+                             fd_funk_txn_t const *           funk_txn ) {
+  return !fd_sysvar_cache_store_stale( store, cache, funk, funk_txn );
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_runtime_sysvar_fd_sysvar_cache_store_h */
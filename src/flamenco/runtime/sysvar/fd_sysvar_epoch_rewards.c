@@ -70,7 +70,7 @@ fd_sysvar_epoch_rewards_distribute(
     write_epoch_rewards( slot_ctx, epoch_rewards );
 
     /* Sync the epoch rewards sysvar cache entry with the account */
-    fd_sysvar_cache_restore_epoch_rewards( slot_ctx->sysvar_cache, slot_ctx->acc_mgr, slot_ctx->funk_txn );
+    fd_sysvar_cache_restore_epoch_rewards( fd_exec_slot_ctx_sysvar_cache_modify( slot_ctx ), slot_ctx->acc_mgr, slot_ctx->funk_txn );
 }
 
 void
@@ -94,7 +94,7 @@ fd_sysvar_epoch_rewards_set_inactive(
     write_epoch_rewards( slot_ctx, epoch_rewards );
 
     /* Sync the epoch rewards sysvar cache entry with the account */
-    fd_sysvar_cache_restore_epoch_rewards( slot_ctx->sysvar_cache, slot_ctx->acc_mgr, slot_ctx->funk_txn );
+    fd_sysvar_cache_restore_epoch_rewards( fd_exec_slot_ctx_sysvar_cache_modify( slot_ctx ), slot_ctx->acc_mgr, slot_ctx->funk_txn );
 }
 
 /* Create EpochRewards syavar with calculated rewards
@@ -0,0 +1,338 @@
+#include "fd_sysvar_cache_store.h"
+#include "../fd_system_ids.h"
+#include "../fd_runtime.h"
+#include "../context/fd_exec_epoch_ctx.h"
+#include "../context/fd_exec_slot_ctx.h"
+
+/* write_account creates or overwrites the account at pubkey in txn with
+   the given data. */
+
+static void
+write_account( fd_acc_mgr_t *      acc_mgr,
+               fd_funk_txn_t *     txn,
+               fd_pubkey_t const * pubkey,
+               void const *        data,
+               ulong               data_sz ) {
+  fd_funk_rec_t * rec;
+  fd_account_meta_t * meta = fd_acc_mgr_modify_raw( acc_mgr, txn, pubkey, 1, data_sz, NULL, &rec, NULL );
+  FD_TEST( meta );
+  meta->dlen          = data_sz;
+  meta->info.lamports = 1UL;
+  fd_memcpy( (uchar *)meta + meta->hlen, data, data_sz );
+}
+
+static void
+write_rent( fd_acc_mgr_t *  acc_mgr,
+            fd_funk_txn_t * txn,
+            ulong           lamports_per_uint8_year ) {
+  fd_rent_t rent = { .lamports_per_uint8_year = lamports_per_uint8_year, .exemption_threshold = 2.0, .burn_percent = 50 };
+  uchar buf[ 64 ];
+  fd_bincode_encode_ctx_t encode = { .data = buf, .dataend = buf+sizeof(buf) };
+  FD_TEST( !fd_rent_encode( &rent, &encode ) );
+  write_account( acc_mgr, txn, &fd_sysvar_rent_id, buf, (ulong)encode.data - (ulong)buf );
+}
+
+static void
+write_clock( fd_acc_mgr_t *  acc_mgr,
+             fd_funk_txn_t * txn,
+             ulong           slot ) {
+  fd_sol_sysvar_clock_t clock = { .slot = slot, .epoch = 0UL, .unix_timestamp = 1700000000L, .epoch_start_timestamp = 1700000000L };
+  uchar buf[ 64 ];
+  fd_bincode_encode_ctx_t encode = { .data = buf, .dataend = buf+sizeof(buf) };
+  FD_TEST( !fd_sol_sysvar_clock_encode( &clock, &encode ) );
+  write_account( acc_mgr, txn, &fd_sysvar_clock_id, buf, (ulong)encode.data - (ulong)buf );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--page-sz",  NULL,      "gigantic" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong ( &argc, &argv, "--page-cnt", NULL,             1UL );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong ( &argc, &argv, "--near-cpu", NULL, fd_log_cpu_id() );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+  ulong const static_tag = 1UL;
+
+  fd_alloc_t * alloc = fd_alloc_join( fd_alloc_new( fd_wksp_alloc_laddr( wksp, fd_alloc_align(), fd_alloc_footprint(), 41UL ), 41UL ), 0UL );
+  FD_TEST( alloc );
+  fd_valloc_t valloc = fd_alloc_virtual( alloc );
+
+  fd_funk_t * funk = fd_funk_join( fd_funk_new( fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint(), 42UL ), 42UL, 1234UL, 16UL, 512UL ) );
+  FD_TEST( funk );
+  fd_funk_start_write( funk );
+
+  fd_acc_mgr_t * acc_mgr = fd_acc_mgr_new( fd_wksp_alloc_laddr( wksp, FD_ACC_MGR_ALIGN, FD_ACC_MGR_FOOTPRINT, static_tag ), funk );
+  FD_TEST( acc_mgr );
+
+  ulong const ele_max = 4UL;
+  void * mem = fd_wksp_alloc_laddr( wksp, fd_sysvar_cache_store_align(), fd_sysvar_cache_store_footprint( ele_max ), static_tag );
+  FD_TEST( mem );
+
+  FD_TEST( !fd_sysvar_cache_store_new( NULL,                ele_max, 0UL ) ); /* NULL mem */
+  FD_TEST( !fd_sysvar_cache_store_new( (uchar *)mem + 1UL,  ele_max, 0UL ) ); /* misaligned */
+  FD_TEST( !fd_sysvar_cache_store_new( mem,                 0UL,     0UL ) ); /* zero ele_max */
+  FD_TEST( !fd_sysvar_cache_store_join( mem ) );                               /* not formatted */
+
+  fd_sysvar_cache_store_t * store = fd_sysvar_cache_store_join( fd_sysvar_cache_store_new( mem, ele_max, 5678UL ) );
+  FD_TEST( store );
+
+  /* Acquiring the same xid twice shares one cache */
+
+  fd_funk_txn_xid_t xid_a = { .ul = { 10UL, 1UL } };
+  fd_funk_txn_xid_t xid_b = { .ul = { 11UL, 2UL } };
+
+  fd_sysvar_cache_t * a0 = fd_sysvar_cache_store_acquire( store, &xid_a, acc_mgr, NULL, valloc );
+  fd_sysvar_cache_t * a1 = fd_sysvar_cache_store_acquire( store, &xid_a, acc_mgr, NULL, valloc );
+  fd_sysvar_cache_t * b0 = fd_sysvar_cache_store_acquire( store, &xid_b, acc_mgr, NULL, valloc );
+  FD_TEST( a0 && a0==a1 );
+  FD_TEST( b0 && b0!=a0 );
+  FD_TEST( store->hit_cnt==1UL && store->miss_cnt==2UL );
+  FD_TEST( fd_sysvar_cache_store_owns( store, a0 ) );
+  FD_TEST( fd_sysvar_cache_store_owns( store, b0 ) );
+
+  /* Empty funk, so no sysvars are present */
+
+  FD_TEST( !fd_sysvar_cache_rent       ( a0 ) );
+  FD_TEST( !fd_sysvar_cache_slot_hashes( a0 ) );
+
+  /* Populate the shared cache by hand, including a sysvar with heap
+     allocated contents */
+
+  a0->val_rent->lamports_per_uint8_year = 3480UL;
+  a0->val_rent->exemption_threshold     = 2.0;
+  a0->val_rent->burn_percent            = 50;
+  a0->has_rent                          = 1;
+
+  a0->val_slot_hashes->hashes = deq_fd_slot_hash_t_alloc( valloc, 512UL );
+  for( ulong i=0UL; i<8UL; i++ ) {
+    fd_slot_hash_t * ele = deq_fd_slot_hash_t_push_tail_nocopy( a0->val_slot_hashes->hashes );
+    ele->slot = 100UL-i;
+    memset( ele->hash.uc, (int)i, sizeof(fd_hash_t) );
+  }
+  a0->has_slot_hashes = 1;
+
+  /* Modifying a private cache is a no-op */
+
+  fd_sysvar_cache_t * priv = fd_sysvar_cache_new( fd_valloc_malloc( valloc, fd_sysvar_cache_align(), fd_sysvar_cache_footprint() ), valloc );
+  FD_TEST( priv );
+  FD_TEST( !fd_sysvar_cache_store_owns( store, priv ) );
+  FD_TEST( fd_sysvar_cache_store_modify( store, priv, valloc )==priv );
+  fd_valloc_free( valloc, fd_sysvar_cache_delete( priv ) );
+
+  /* Modifying a shared cache returns a deep, private copy and drops the
+     reference to the shared one */
+
+  fd_sysvar_cache_t * a2 = fd_sysvar_cache_store_modify( store, a1, valloc );
+  FD_TEST( a2 && a2!=a0 );
+  FD_TEST( !fd_sysvar_cache_store_owns( store, a2 ) );
+
+  fd_rent_t const * rent = fd_sysvar_cache_rent( a2 );
+  FD_TEST( rent );
+  FD_TEST( rent->lamports_per_uint8_year==3480UL );
+  FD_TEST( rent->exemption_threshold    ==2.0    );
+  FD_TEST( rent->burn_percent           ==50     );
+
+  fd_slot_hashes_t const * slot_hashes = fd_sysvar_cache_slot_hashes( a2 );
+  FD_TEST( slot_hashes );
+  FD_TEST( slot_hashes->hashes!=a0->val_slot_hashes->hashes );
+  FD_TEST( deq_fd_slot_hash_t_cnt( slot_hashes->hashes )==8UL );
+  for( ulong i=0UL; i<8UL; i++ ) {
+    fd_slot_hash_t const * ele = deq_fd_slot_hash_t_peek_index_const( slot_hashes->hashes, i );
+    FD_TEST( ele->slot==100UL-i );
+    FD_TEST( ele->hash.uc[ 31 ]==(uchar)i );
+  }
+  FD_TEST( !fd_sysvar_cache_clock( a2 ) );
+
+  /* The shared cache is still live for the remaining holder */
+
+  FD_TEST( fd_sysvar_cache_store_acquire( store, &xid_a, acc_mgr, NULL, valloc )==a0 );
+  fd_sysvar_cache_store_release( store, a0 );
+  FD_TEST( fd_sysvar_cache_rent( a0 ) );
+
+  /* Releasing the last reference frees the entry */
+
+  fd_sysvar_cache_store_release( store, a0 );
+  FD_TEST( !fd_sysvar_cache_store_map_ele_query_const( store->map, &xid_a, NULL, store->pool ) );
+  FD_TEST( fd_sysvar_cache_store_pool_free( store->pool )==ele_max-1UL );
+
+  /* A full store fails over to the caller */
+
+  fd_sysvar_cache_t * held[ 4 ];
+  for( ulong i=0UL; i<ele_max-1UL; i++ ) {
+    fd_funk_txn_xid_t xid = { .ul = { 20UL+i } };
+    held[ i ] = fd_sysvar_cache_store_acquire( store, &xid, acc_mgr, NULL, valloc );
+    FD_TEST( held[ i ] );
+  }
+  FD_TEST( !fd_sysvar_cache_store_acquire( store, &xid_a, acc_mgr, NULL, valloc ) );
+  for( ulong i=0UL; i<ele_max-1UL; i++ ) fd_sysvar_cache_store_release( store, held[ i ] );
+  fd_sysvar_cache_store_release( store, b0 );
+  FD_TEST( fd_sysvar_cache_store_pool_free( store->pool )==ele_max );
+
+  fd_valloc_free( valloc, fd_sysvar_cache_delete( a2 ) );
+
+  /* Two sibling forks started at the same parent share the parent's
+     cache until one of them writes a sysvar account */
+
+  fd_funk_txn_xid_t xid_p  = { .ul = { 30UL, 3UL } };
+  fd_funk_txn_xid_t xid_c1 = { .ul = { 31UL, 4UL } };
+  fd_funk_txn_xid_t xid_c2 = { .ul = { 32UL, 5UL } };
+  fd_funk_txn_xid_t xid_g2 = { .ul = { 33UL, 6UL } };
+  fd_funk_txn_t * txn_p  = fd_funk_txn_prepare( funk, NULL,   &xid_p,  1 ); FD_TEST( txn_p  );
+  write_rent( acc_mgr, txn_p, 3480UL );
+  fd_funk_txn_t * txn_c1 = fd_funk_txn_prepare( funk, txn_p,  &xid_c1, 1 ); FD_TEST( txn_c1 );
+  fd_funk_txn_t * txn_c2 = fd_funk_txn_prepare( funk, txn_p,  &xid_c2, 1 ); FD_TEST( txn_c2 );
+  fd_funk_txn_t * txn_g2 = fd_funk_txn_prepare( funk, txn_c2, &xid_g2, 1 ); FD_TEST( txn_g2 );
+
+  fd_sysvar_cache_t * fork1 = fd_sysvar_cache_store_acquire( store, &xid_p, acc_mgr, txn_p, valloc );
+  fd_sysvar_cache_t * fork2 = fd_sysvar_cache_store_acquire( store, &xid_p, acc_mgr, txn_p, valloc );
+  FD_TEST( fork1 && fork1==fork2 );
+  FD_TEST( fd_sysvar_cache_rent( fork1 )->lamports_per_uint8_year==3480UL );
+
+  FD_TEST( fd_sysvar_cache_store_valid( store, fork1, funk, txn_p  ) );
+  FD_TEST( fd_sysvar_cache_store_valid( store, fork1, funk, txn_c1 ) );
+  FD_TEST( fd_sysvar_cache_store_valid( store, fork2, funk, txn_c2 ) );
+  FD_TEST( fd_sysvar_cache_store_valid( store, fork2, funk, txn_g2 ) );
+  FD_TEST( !fd_sysvar_cache_store_valid( store, fork1, funk, NULL ) ); /* not an ancestor */
+
+  /* Writing an ordinary account does not invalidate the shared cache */
+
+  fd_pubkey_t other = { .ul = { 42UL } };
+  write_account( acc_mgr, txn_c1, &other, "ABCD", 4UL );
+  FD_TEST( fd_sysvar_cache_store_valid( store, fork1, funk, txn_c1 ) );
+
+  /* Writing a sysvar only invalidates the cache for the writing fork */
+
+  write_rent( acc_mgr, txn_c1, 1000UL );
+  FD_TEST( !fd_sysvar_cache_store_valid( store, fork1, funk, txn_c1 ) );
+  FD_TEST(  fd_sysvar_cache_store_valid( store, fork2, funk, txn_c2 ) );
+  FD_TEST(  fd_sysvar_cache_store_valid( store, fork2, funk, txn_g2 ) );
+
+  fd_sysvar_cache_t * fork1_priv = fd_sysvar_cache_store_detach( store, fork1, valloc );
+  FD_TEST( fork1_priv && !fd_sysvar_cache_store_owns( store, fork1_priv ) );
+  FD_TEST( !fd_sysvar_cache_rent( fork1_priv ) ); /* detach does not copy */
+  FD_TEST( !fd_sysvar_cache_store_valid( store, fork1_priv, funk, txn_c1 ) );
+  FD_TEST( fd_sysvar_cache_store_detach( store, fork1_priv, valloc )==fork1_priv );
+  fd_sysvar_cache_restore( fork1_priv, acc_mgr, txn_c1 );
+  FD_TEST( fd_sysvar_cache_rent( fork1_priv )->lamports_per_uint8_year==1000UL );
+
+  /* The sibling still holds the shared cache */
+
+  fd_sysvar_cache_store_ele_t const * ele = fd_sysvar_cache_store_map_ele_query_const( store->map, &xid_p, NULL, store->pool );
+  FD_TEST( ele && ele->cache==fork2 && ele->refcnt==1UL );
+  FD_TEST( fd_sysvar_cache_rent( fork2 )->lamports_per_uint8_year==3480UL );
+
+  /* A write further down the sibling's fork invalidates it as well */
+
+  write_rent( acc_mgr, txn_g2, 2000UL );
+  FD_TEST(  fd_sysvar_cache_store_valid( store, fork2, funk, txn_c2 ) );
+  FD_TEST( !fd_sysvar_cache_store_valid( store, fork2, funk, txn_g2 ) );
+
+  fd_sysvar_cache_store_release( store, fork2 );
+  fd_valloc_free( valloc, fd_sysvar_cache_delete( fork1_priv ) );
+  FD_TEST( fd_funk_txn_cancel( funk, txn_p, 1 )==4UL );
+  FD_TEST( fd_sysvar_cache_store_pool_free( store->pool )==ele_max );
+
+  /* Preparing a block on a fork that holds the parent's shared cache.
+     fd_runtime_block_execute_prepare rewrites the clock and slot hashes
+     sysvars before loading the sysvar cache, so the shared cache is
+     stale for those.  Only they are restored, into a private copy.  The
+     sibling fork keeps the shared cache. */
+
+  uchar scratch_smem[ 1UL<<20 ] __attribute__((aligned(FD_SCRATCH_SMEM_ALIGN)));
+  ulong scratch_fmem[ 4UL ]     __attribute__((aligned(FD_SCRATCH_FMEM_ALIGN)));
+  fd_scratch_attach( scratch_smem, scratch_fmem, sizeof(scratch_smem), 4UL );
+
+  void * epoch_ctx_mem = fd_wksp_alloc_laddr( wksp, fd_exec_epoch_ctx_align(), fd_exec_epoch_ctx_footprint( 4UL ), static_tag );
+  fd_exec_epoch_ctx_t * epoch_ctx = fd_exec_epoch_ctx_join( fd_exec_epoch_ctx_new( epoch_ctx_mem, 4UL ) );
+  FD_TEST( epoch_ctx );
+  fd_epoch_bank_t * epoch_bank = fd_exec_epoch_ctx_epoch_bank( epoch_ctx );
+  epoch_bank->epoch_schedule = (fd_epoch_schedule_t){ .slots_per_epoch = 432000UL, .leader_schedule_slot_offset = 432000UL };
+  epoch_bank->rent           = (fd_rent_t){ .lamports_per_uint8_year = 3480UL, .exemption_threshold = 2.0, .burn_percent = 50 };
+
+  ulong block_max = 16UL;
+  void * blockstore_mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_align(), fd_blockstore_footprint( 64UL, block_max, 16UL, 16UL ), static_tag );
+  fd_blockstore_t * blockstore = fd_blockstore_join( fd_blockstore_new( blockstore_mem, static_tag, 42UL, 64UL, block_max, 16UL, 16UL ) );
+  FD_TEST( blockstore );
+
+  fd_funk_txn_xid_t xid_s1 = { .ul = { 1UL, 7UL } };
+  fd_funk_txn_xid_t xid_s2 = { .ul = { 2UL, 8UL } };
+  fd_funk_txn_xid_t xid_s3 = { .ul = { 3UL, 9UL } };
+  fd_funk_txn_t * txn_s1 = fd_funk_txn_prepare( funk, NULL,   &xid_s1, 1 ); FD_TEST( txn_s1 );
+  write_rent ( acc_mgr, txn_s1, 3480UL );
+  write_clock( acc_mgr, txn_s1, 1UL    );
+  fd_funk_txn_t * txn_s2 = fd_funk_txn_prepare( funk, txn_s1, &xid_s2, 1 ); FD_TEST( txn_s2 );
+  fd_funk_txn_t * txn_s3 = fd_funk_txn_prepare( funk, txn_s1, &xid_s3, 1 ); FD_TEST( txn_s3 );
+
+  fd_exec_slot_ctx_t * slot_ctx = fd_exec_slot_ctx_join( fd_exec_slot_ctx_new(
+      fd_wksp_alloc_laddr( wksp, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT, static_tag ), valloc ) );
+  FD_TEST( slot_ctx );
+  slot_ctx->acc_mgr    = acc_mgr;
+  slot_ctx->blockstore = blockstore;
+  slot_ctx->epoch_ctx  = epoch_ctx;
+  slot_ctx->funk_txn   = txn_s2;
+  slot_ctx->slot_bank.slot      = 2UL;
+  slot_ctx->slot_bank.prev_slot = 1UL;
+
+  fd_sysvar_cache_t * parent  = fd_sysvar_cache_store_acquire( store, &xid_s1, acc_mgr, txn_s1, valloc );
+  fd_sysvar_cache_t * sibling = fd_sysvar_cache_store_acquire( store, &xid_s1, acc_mgr, txn_s1, valloc );
+  FD_TEST( parent && parent==sibling );
+  FD_TEST( fd_sysvar_cache_clock( parent )->slot==1UL );
+  fd_valloc_free( valloc, fd_sysvar_cache_delete( slot_ctx->sysvar_cache ) );
+  slot_ctx->sysvar_cache       = parent;
+  slot_ctx->sysvar_cache_store = store;
+  FD_TEST( fd_sysvar_cache_store_valid( store, parent, funk, txn_s2 ) );
+
+  /* Mark the shared rent so a copy can be told apart from a decode of
+     the rent account */
+
+  parent->val_rent->burn_percent = 51;
+
+  fd_funk_end_write( funk );
+  FD_TEST( fd_runtime_block_execute_prepare( slot_ctx )==FD_RUNTIME_EXECUTE_SUCCESS );
+  fd_funk_start_write( funk );
+
+  ulong stale = fd_sysvar_cache_store_stale( store, sibling, funk, txn_s2 );
+  FD_TEST( stale!=ULONG_MAX );
+  FD_TEST(   stale & (1UL<<FD_SYSVAR_CACHE_STORE_IDX_clock)       );
+  FD_TEST(   stale & (1UL<<FD_SYSVAR_CACHE_STORE_IDX_slot_hashes) );
+  FD_TEST( !(stale & (1UL<<FD_SYSVAR_CACHE_STORE_IDX_rent))       );
+  FD_TEST( fd_sysvar_cache_store_stale( store, sibling, funk, txn_s3 )==0UL       );
+  FD_TEST( fd_sysvar_cache_store_stale( store, sibling, funk, NULL   )==ULONG_MAX );
+
+  fd_sysvar_cache_t * prepared = slot_ctx->sysvar_cache;
+  FD_TEST( prepared!=sibling && !fd_sysvar_cache_store_owns( store, prepared ) );
+  FD_TEST( fd_sysvar_cache_clock( prepared )->slot==2UL );
+  FD_TEST( fd_sysvar_cache_rent( prepared )->lamports_per_uint8_year==3480UL );
+  FD_TEST( fd_sysvar_cache_rent( prepared )->burn_percent==51 ); /* copied, not restored */
+  fd_slot_hashes_t const * prepared_hashes = fd_sysvar_cache_slot_hashes( prepared );
+  FD_TEST( prepared_hashes && deq_fd_slot_hash_t_cnt( prepared_hashes->hashes )==1UL );
+  FD_TEST( deq_fd_slot_hash_t_peek_head_const( prepared_hashes->hashes )->slot==1UL );
+
+  FD_TEST( fd_sysvar_cache_clock( sibling )->slot==1UL );
+  FD_TEST( !fd_sysvar_cache_slot_hashes( sibling ) );
+  FD_TEST( fd_sysvar_cache_store_map_ele_query_const( store->map, &xid_s1, NULL, store->pool )->refcnt==1UL );
+
+  fd_wksp_free_laddr( fd_exec_slot_ctx_delete( fd_exec_slot_ctx_leave( slot_ctx ) ) );
+  fd_sysvar_cache_store_release( store, sibling );
+  FD_TEST( fd_sysvar_cache_store_pool_free( store->pool )==ele_max );
+  FD_TEST( fd_funk_txn_cancel( funk, txn_s1, 1 )==3UL );
+  FD_TEST( fd_blockstore_leave( blockstore )==blockstore_mem );
+  fd_wksp_free_laddr( blockstore_mem );
+  fd_wksp_free_laddr( fd_exec_epoch_ctx_delete( fd_exec_epoch_ctx_leave( epoch_ctx ) ) );
+  fd_scratch_detach( NULL );
+
+  FD_TEST( fd_sysvar_cache_store_delete( fd_sysvar_cache_store_leave( store ) )==mem );
+  fd_wksp_free_laddr( mem );
+  fd_wksp_free_laddr( fd_acc_mgr_delete( acc_mgr ) );
+  fd_funk_end_write( funk );
+  fd_wksp_free_laddr( fd_funk_delete( fd_funk_leave( funk ) ) );
+  fd_wksp_free_laddr( fd_alloc_delete( fd_alloc_leave( alloc ) ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
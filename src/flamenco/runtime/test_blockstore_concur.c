@@ -0,0 +1,239 @@
+#include "../../util/fd_util.h"
+
+#if FD_HAS_INT128 && FD_HAS_THREADS
+
+#include <pthread.h>
+#include "fd_blockstore.h"
+
+/* Stress test for concurrent blockstore access.  Writer threads insert
+   the shreds of many slots at once, each slot fed by two writers in
+   different orders so inserts race on the same shard as well as across
+   shards.  Reader threads concurrently query buffered shreds, block map
+   entries, block data and the txn map, checking that they only ever
+   observe consistent states.  At the end every slot must have been
+   assembled exactly once. */
+
+#define SLOT_CNT   (64UL)  /* slots inserted concurrently */
+#define SHRED_CNT  (32U)   /* data shreds per slot */
+#define PAYLOAD_SZ (256UL) /* payload bytes per shred */
+#define WRITER_CNT (4UL)
+#define READER_CNT (2UL)
+#define ROOT       (1UL)
+
+static fd_blockstore_t * blockstore;
+static ulong             complete_cnt[ SLOT_CNT ];
+static ulong volatile    writers_done;
+
+/* make_shred builds data shred idx of slot.  The block data is a single
+   batch holding one empty microblock, followed by zero padding that is
+   ignored as trailing batch bytes. */
+
+static fd_shred_t const *
+make_shred( uchar buf[ FD_SHRED_MAX_SZ ], ulong slot, uint idx ) {
+  fd_memset( buf, 0, FD_SHRED_MAX_SZ );
+  fd_shred_t * shred = (fd_shred_t *)buf;
+  shred->variant         = fd_shred_variant( FD_SHRED_TYPE_LEGACY_DATA, 0 );
+  shred->slot            = slot;
+  shred->idx             = idx;
+  shred->data.parent_off = 1;
+  shred->data.size       = (ushort)( FD_SHRED_DATA_HEADER_SZ + PAYLOAD_SZ );
+  if( idx==SHRED_CNT-1U ) shred->data.flags = FD_SHRED_DATA_FLAG_SLOT_COMPLETE | FD_SHRED_DATA_FLAG_DATA_COMPLETE;
+
+  if( !idx ) {
+    uchar * payload = buf + FD_SHRED_DATA_HEADER_SZ;
+    FD_STORE( ulong, payload, 1UL );
+    fd_microblock_hdr_t * hdr = (fd_microblock_hdr_t *)( payload + sizeof(ulong) );
+    hdr->hash_cnt = slot;
+    FD_STORE( ulong, hdr->hash, slot );
+  }
+  return shred;
+}
+
+static void *
+writer_fn( void * arg ) {
+  ulong writer_idx = (ulong)arg;
+  uchar buf[ FD_SHRED_MAX_SZ ] __attribute__((aligned(8)));
+
+  /* Walk all of this writer's slots round by round, so that many slots
+     are partially buffered at any time.  Writer w feeds slots k with
+     k%WRITER_CNT in {w,w-1}, each in its own permutation of the shred
+     indices (7 and 5 are coprime with SHRED_CNT). */
+
+  for( uint r=0U; r<SHRED_CNT; r++ ) {
+    for( ulong k=0UL; k<SLOT_CNT; k++ ) {
+      ulong owner = k%WRITER_CNT;
+      uint  idx;
+      if(      owner==writer_idx                           ) idx = (r*7U + (uint)k) % SHRED_CNT;
+      else if( (owner+1UL)%WRITER_CNT==writer_idx          ) idx = (r*5U + 3U   ) % SHRED_CNT;
+      else continue;
+
+      ulong slot = ROOT+1UL+k;
+      int   rc   = fd_buf_shred_insert( blockstore, make_shred( buf, slot, idx ) );
+      FD_TEST( rc==FD_BLOCKSTORE_OK || rc==FD_BLOCKSTORE_OK_SLOT_COMPLETE );
+      if( rc==FD_BLOCKSTORE_OK_SLOT_COMPLETE ) FD_ATOMIC_FETCH_AND_ADD( &complete_cnt[ k ], 1UL );
+    }
+  }
+
+  FD_ATOMIC_FETCH_AND_ADD( &writers_done, 1UL );
+  return NULL;
+}
+
+static void *
+reader_fn( void * arg ) {
+  fd_rng_t _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, (uint)(ulong)arg, 0UL ) );
+
+  fd_valloc_t valloc = fd_libc_alloc_virtual();
+
+  ulong iter = 0UL;
+  while( FD_VOLATILE_CONST( writers_done )<WRITER_CNT ) {
+    ulong slot = ROOT+1UL+fd_rng_ulong_roll( rng, SLOT_CNT );
+
+    /* Buffered shreds and the window under the slot read lock */
+
+    fd_blockstore_slot_start_read( blockstore, slot );
+    fd_block_map_t * entry = fd_blockstore_block_map_query( blockstore, slot );
+    if( entry ) {
+      FD_TEST( entry->parent_slot==slot-1UL );
+      FD_TEST( entry->received_idx<=SHRED_CNT );
+      if( !entry->block_gaddr ) {
+        FD_TEST( entry->consumed_idx==UINT_MAX || entry->consumed_idx<entry->received_idx );
+        for( uint idx=0U; idx<entry->received_idx; idx++ ) {
+          fd_shred_t * shred = fd_buf_shred_query( blockstore, slot, idx );
+          if( shred ) FD_TEST( shred->slot==slot && shred->idx==idx );
+          if( idx<=entry->consumed_idx && entry->consumed_idx!=UINT_MAX ) FD_TEST( shred );
+        }
+      }
+    }
+    fd_blockstore_slot_end_read( blockstore, slot );
+
+    /* Lock-free block map and block data queries */
+
+    fd_block_map_t meta[1];
+    if( fd_blockstore_block_map_query_volatile( blockstore, -1, slot, meta )==FD_BLOCKSTORE_OK ) {
+      FD_TEST( meta->slot==slot );
+      FD_TEST( meta->complete_idx==SHRED_CNT-1U );
+      FD_TEST( meta->consumed_idx==meta->complete_idx );
+    }
+
+    uchar * data    = NULL;
+    ulong   data_sz = 0UL;
+    if( fd_blockstore_block_data_query_volatile( blockstore, -1, slot, valloc, NULL, meta, NULL, &data, &data_sz )==FD_BLOCKSTORE_OK ) {
+      FD_TEST( data_sz==SHRED_CNT*PAYLOAD_SZ );
+      FD_TEST( FD_LOAD( ulong, data )==1UL );
+      FD_TEST( FD_LOAD( ulong, data+sizeof(ulong)+offsetof(fd_microblock_hdr_t, hash) )==slot );
+      fd_valloc_free( valloc, data );
+    }
+
+    /* Txn map lookups (the blocks have no txns) */
+
+    uchar sig[ FD_ED25519_SIG_SZ ];
+    for( ulong i=0UL; i<FD_ED25519_SIG_SZ; i++ ) sig[ i ] = fd_rng_uchar( rng );
+    fd_txn_map_t txn[1];
+    FD_TEST( fd_blockstore_txn_query_volatile( blockstore, -1, sig, txn, NULL, NULL, NULL )==FD_BLOCKSTORE_ERR_TXN_MISSING );
+
+    iter++;
+  }
+
+  FD_LOG_NOTICE(( "reader %lu: %lu iterations", (ulong)arg, iter ));
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return NULL;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "normal" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 16384UL  );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx( 0 ) );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  ulong shred_max = fd_ulong_pow2_up( 2UL*SLOT_CNT*SHRED_CNT );
+  ulong block_max = 2UL*SLOT_CNT;
+  ulong idx_max   = 64UL;
+  ulong txn_max   = 64UL;
+
+  void * mem = fd_wksp_alloc_laddr( wksp, fd_blockstore_align(), fd_blockstore_footprint( shred_max, block_max, idx_max, txn_max ), 1UL );
+  FD_TEST( mem );
+  blockstore = fd_blockstore_join( fd_blockstore_new( mem, 1UL, 42UL, shred_max, block_max, idx_max, txn_max ) );
+  FD_TEST( blockstore );
+
+  fd_slot_bank_t slot_bank[1];
+  fd_slot_bank_new( slot_bank );
+  slot_bank->slot         = ROOT;
+  slot_bank->prev_slot    = ROOT-1UL;
+  slot_bank->block_height = 1UL;
+  fd_hash_t fake_hash = { .hash = { 1 } };
+  slot_bank->block_hash_queue.last_hash = &fake_hash;
+  FD_TEST( fd_blockstore_init( blockstore, -1, FD_BLOCKSTORE_ARCHIVE_MIN_SIZE, slot_bank ) );
+
+  pthread_t writers[ WRITER_CNT ];
+  pthread_t readers[ READER_CNT ];
+  for( ulong i=0UL; i<READER_CNT; i++ ) FD_TEST( !pthread_create( readers+i, NULL, reader_fn, (void *)i ) );
+  for( ulong i=0UL; i<WRITER_CNT; i++ ) FD_TEST( !pthread_create( writers+i, NULL, writer_fn, (void *)i ) );
+  for( ulong i=0UL; i<WRITER_CNT; i++ ) FD_TEST( !pthread_join( writers[i], NULL ) );
+  for( ulong i=0UL; i<READER_CNT; i++ ) FD_TEST( !pthread_join( readers[i], NULL ) );
+
+  /* Every slot was assembled exactly once, linked to its parent, and
+     all buffered shreds were released */
+
+  fd_blockstore_start_read( blockstore );
+  for( ulong k=0UL; k<SLOT_CNT; k++ ) {
+    ulong slot = ROOT+1UL+k;
+    FD_TEST( complete_cnt[ k ]==1UL );
+
+    fd_block_t * block = fd_blockstore_block_query( blockstore, slot );
+    FD_TEST( block );
+    FD_TEST( block->data_sz==SHRED_CNT*PAYLOAD_SZ );
+    FD_TEST( block->shreds_cnt==SHRED_CNT );
+    FD_TEST( block->micros_cnt==1UL );
+
+    fd_block_map_t * entry = fd_blockstore_block_map_query( blockstore, slot );
+    FD_TEST( fd_uchar_extract_bit( entry->flags, FD_BLOCK_FLAG_COMPLETED ) );
+    FD_TEST( !fd_uchar_extract_bit( entry->flags, FD_BLOCK_FLAG_RECEIVING ) );
+
+    ulong * child_slots    = NULL;
+    ulong   child_slot_cnt = 0UL;
+    FD_TEST( fd_blockstore_child_slots_query( blockstore, slot-1UL, &child_slots, &child_slot_cnt )==FD_BLOCKSTORE_OK );
+    FD_TEST( child_slot_cnt==1UL && child_slots[0]==slot );
+  }
+  FD_TEST( !fd_buf_shred_pool_used( fd_blockstore_shred_pool( blockstore ) ) );
+  fd_blockstore_end_read( blockstore );
+
+  /* Shreds for assembled slots and slots behind the SMR are ignored */
+
+  uchar buf[ FD_SHRED_MAX_SZ ] __attribute__((aligned(8)));
+  FD_TEST( fd_buf_shred_insert( blockstore, make_shred( buf, ROOT+1UL, 0U ) )==FD_BLOCKSTORE_OK );
+  FD_TEST( fd_buf_shred_insert( blockstore, make_shred( buf, ROOT,     0U ) )==FD_BLOCKSTORE_OK );
+  FD_TEST( !fd_buf_shred_pool_used( fd_blockstore_shred_pool( blockstore ) ) );
+
+  fd_blockstore_fini( blockstore );
+  FD_TEST( fd_blockstore_leave( blockstore ) );
+  fd_wksp_free_laddr( mem );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_INT128 and FD_HAS_THREADS capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -1,4 +1,10 @@
 ifdef FD_HAS_ROCKSDB
 $(call add-hdrs,fd_shredcap.h)
 $(call add-objs,fd_shredcap,fd_flamenco)
+ifdef FD_HAS_ZSTD
+$(call add-hdrs,fd_shredcap_archive.h)
+$(call add-objs,fd_shredcap_archive,fd_flamenco)
+$(call make-unit-test,test_shredcap_archive,test_shredcap_archive,fd_flamenco fd_ballet fd_funk fd_util,$(ROCKSDB_LIBS) $(SECP256K1_LIBS))
+$(call run-unit-test,test_shredcap_archive)
+endif
 endif
@@ -0,0 +1,770 @@
+#define _GNU_SOURCE /* copy_file_range */
+#include "fd_shredcap_archive.h"
+#include "../runtime/fd_rocksdb.h"
+#include <stdio.h>
+#include <sys/mman.h>
+
+#define OBUF_FOOTPRINT (1UL<<20)
+#define PART_PATH_MAX  (FD_SHREDCAP_CAPTURE_PATH_NAME_LENGTH+32UL)
+
+/**** Ingest ******************************************************************/
+
+/* fd_shredcap_archive_ingest_t holds the index being built and what
+   each worker needs to write its part.  The columns are indexed by row
+   and filled in by the caller (slot metadata) and the workers (block
+   location, sizes and bank hash).  Block offsets are relative to the
+   start of their part until the parts are concatenated. */
+
+struct fd_shredcap_archive_ingest {
+  fd_rocksdb_t * db;
+  char const *   archive_path;
+  int            level;
+  fd_valloc_t    valloc;
+  ulong          row_cnt;
+  ulong          part_cnt;
+  ulong *        part_sz;
+
+  ulong *        slot;
+  ulong *        parent_slot;
+  long *         first_shred_ts;
+  ulong *        last_index;
+  ulong *        shred_cnt;
+  ulong *        block_off;
+  ulong *        block_csz;
+  ulong *        block_dsz;
+  fd_hash_t *    bank_hash;
+};
+typedef struct fd_shredcap_archive_ingest fd_shredcap_archive_ingest_t;
+
+static void
+set_part_path( char * buf, char const * archive_path, ulong part_idx ) {
+  int len = snprintf( buf, PART_PATH_MAX, "%s.part%lu", archive_path, part_idx );
+  if( FD_UNLIKELY( len<0 || (ulong)len>=PART_PATH_MAX ) ) {
+    FD_LOG_ERR(( "archive path too long" ));
+  }
+}
+
+static void
+write_all( int fd, void const * buf, ulong sz ) {
+  ulong wsz;
+  int err = fd_io_write( fd, buf, sz, sz, &wsz );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_ERR(( "fd_io_write failed (%i-%s)", err, fd_io_strerror( err ) ));
+  }
+}
+
+/* ingest_part reads and compresses the rows of part part_idx */
+
+static void
+ingest_part( fd_shredcap_archive_ingest_t const * info,
+             ulong                                part_idx ) {
+  ulong row0 = (part_idx    *info->row_cnt)/info->part_cnt;
+  ulong row1 = ((part_idx+1)*info->row_cnt)/info->part_cnt;
+
+  char path[ PART_PATH_MAX ];
+  set_part_path( path, info->archive_path, part_idx );
+  int fd = open( path, O_CREAT|O_TRUNC|O_WRONLY, (mode_t)0666 );
+  if( FD_UNLIKELY( fd==-1 ) ) {
+    FD_LOG_ERR(( "open(\"%s\",O_CREAT|O_TRUNC|O_WRONLY,0%03o) failed (%i-%s)",
+                 path, (uint)0666, errno, fd_io_strerror( errno ) ));
+  }
+
+  /* A block is formatted in place as the shred size column followed by
+     the shreds and compressed as a single frame */
+
+  void *  cmem = fd_valloc_malloc( info->valloc, fd_zstd_cstream_align(), fd_zstd_cstream_footprint( info->level ) );
+  uchar * buf  = fd_valloc_malloc( info->valloc, FD_SHREDCAP_ARCHIVE_ALIGN, FD_SHREDCAP_ARCHIVE_BLOCK_MAX );
+  uchar * obuf = fd_valloc_malloc( info->valloc, FD_SHREDCAP_ARCHIVE_ALIGN, OBUF_FOOTPRINT );
+  if( FD_UNLIKELY( !cmem || !buf || !obuf ) ) {
+    FD_LOG_ERR(( "failed to allocate ingest buffers for part %lu", part_idx ));
+  }
+  fd_zstd_cstream_t * cstream = fd_zstd_cstream_new( cmem, info->level );
+  if( FD_UNLIKELY( !cstream ) ) {
+    FD_LOG_ERR(( "failed to create zstd compressor at level %d", info->level ));
+  }
+
+  ulong off = 0UL;
+  for( ulong row=row0; row<row1; row++ ) {
+    ulong slot      = info->slot     [ row ];
+    ulong shred_cnt = info->shred_cnt[ row ];
+
+    fd_slot_meta_t meta;
+    fd_memset( &meta, 0, sizeof(fd_slot_meta_t) );
+    meta.slot     = slot;
+    meta.received = shred_cnt;
+
+    ulong sz_sz = shred_cnt*sizeof(ushort);
+    ulong data_sz = fd_rocksdb_get_block_shreds( info->db, &meta, buf+sz_sz, FD_SHREDCAP_ARCHIVE_BLOCK_MAX-sz_sz, (ushort *)buf );
+    if( FD_UNLIKELY( data_sz==ULONG_MAX ) ) {
+      FD_LOG_ERR(( "fd_rocksdb_get_block_shreds failed at slot=%lu", slot ));
+    }
+    ulong dsz = sz_sz + data_sz;
+
+    if( FD_UNLIKELY( fd_zstd_cstream_reset( cstream, dsz ) ) ) {
+      FD_LOG_ERR(( "failed to start zstd frame for slot=%lu", slot ));
+    }
+    uchar const * in  = buf;
+    ulong         csz = 0UL;
+    for(;;) {
+      uchar * out = obuf;
+      int rc = fd_zstd_cstream_write( cstream, &in, buf+dsz, &out, obuf+OBUF_FOOTPRINT, 1, NULL );
+      if( FD_UNLIKELY( rc>0 ) ) {
+        FD_LOG_ERR(( "failed to compress slot=%lu (%i-%s)", slot, rc, fd_io_strerror( rc ) ));
+      }
+      write_all( fd, obuf, (ulong)(out-obuf) );
+      csz += (ulong)(out-obuf);
+      if( rc==-1 ) break;
+    }
+
+    info->block_off[ row ] = off;
+    info->block_csz[ row ] = csz;
+    info->block_dsz[ row ] = dsz;
+    if( fd_rocksdb_get_bank_hash( info->db, slot, info->bank_hash+row ) ) {
+      fd_hash_set_zero( info->bank_hash+row );
+    }
+    off += csz;
+  }
+  info->part_sz[ part_idx ] = off;
+
+  if( FD_UNLIKELY( close( fd ) ) ) {
+    FD_LOG_ERR(( "unable to close part file=%s", path ));
+  }
+  fd_valloc_free( info->valloc, fd_zstd_cstream_delete( cstream ) );
+  fd_valloc_free( info->valloc, buf  );
+  fd_valloc_free( info->valloc, obuf );
+
+  FD_LOG_NOTICE(( "ingested slots [%lu,%lu] into part %lu (%lu bytes)",
+                  info->slot[ row0 ], info->slot[ row1-1UL ], part_idx, off ));
+}
+
+static void
+ingest_task( void * tpool,
+             ulong  t0 FD_PARAM_UNUSED,      ulong t1 FD_PARAM_UNUSED,
+             void * args FD_PARAM_UNUSED,
+             void * reduce FD_PARAM_UNUSED,  ulong stride FD_PARAM_UNUSED,
+             ulong  l0 FD_PARAM_UNUSED,      ulong l1 FD_PARAM_UNUSED,
+             ulong  m0,                      ulong m1 FD_PARAM_UNUSED,
+             ulong  n0 FD_PARAM_UNUSED,      ulong n1 FD_PARAM_UNUSED ) {
+  ingest_part( (fd_shredcap_archive_ingest_t const *)tpool, m0 );
+}
+
+/* append_file appends the content of the file at path to fd and
+   removes it.  Returns the number of bytes appended. */
+
+static ulong
+append_file( int fd, char const * path ) {
+  int in_fd = open( path, O_RDONLY, (mode_t)0 );
+  if( FD_UNLIKELY( in_fd==-1 ) ) {
+    FD_LOG_ERR(( "open(\"%s\",O_RDONLY,0) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+  }
+
+  ulong sz = 0UL;
+  for(;;) {
+    long res = (long)copy_file_range( in_fd, NULL, fd, NULL, 1UL<<30, 0U );
+    if( FD_LIKELY( res>0L ) ) { sz += (ulong)res; continue; }
+    if( FD_LIKELY( !res ) ) break;
+    if( errno==EINTR ) continue;
+    if( FD_UNLIKELY( sz || ( errno!=EXDEV && errno!=ENOSYS && errno!=EOPNOTSUPP && errno!=EINVAL ) ) ) {
+      FD_LOG_ERR(( "copy_file_range from \"%s\" failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    }
+
+    /* The file systems do not support copy_file_range, copy through
+       user space */
+
+    static uchar rbuf[ OBUF_FOOTPRINT ]; /* Only called by the tpool caller */
+    for(;;) {
+      ulong rsz;
+      int err = fd_io_read( in_fd, rbuf, 1UL, OBUF_FOOTPRINT, &rsz );
+      if( err==-1 ) break;
+      if( FD_UNLIKELY( err ) ) {
+        FD_LOG_ERR(( "read from \"%s\" failed (%i-%s)", path, err, fd_io_strerror( err ) ));
+      }
+      write_all( fd, rbuf, rsz );
+      sz += rsz;
+    }
+    break;
+  }
+
+  if( FD_UNLIKELY( close( in_fd ) ) ) {
+    FD_LOG_ERR(( "unable to close part file=%s", path ));
+  }
+  if( FD_UNLIKELY( unlink( path ) ) ) {
+    FD_LOG_WARNING(( "unlink(\"%s\") failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+  }
+  return sz;
+}
+
+/* write_column writes the sz byte column at fd offset *off padded to
+   FD_SHREDCAP_ARCHIVE_ALIGN.  Returns the offset of the column. */
+
+static ulong
+write_column( int fd, ulong * off, void const * col, ulong sz ) {
+  static uchar const zero[ FD_SHREDCAP_ARCHIVE_ALIGN ] = {0};
+  ulong col_off = *off;
+  write_all( fd, col, sz );
+  ulong pad = fd_ulong_align_up( sz, FD_SHREDCAP_ARCHIVE_ALIGN ) - sz;
+  write_all( fd, zero, pad );
+  *off += sz + pad;
+  return col_off;
+}
+
+void
+fd_shredcap_archive_ingest_rocksdb( char const * rocksdb_dir,
+                                    char const * archive_path,
+                                    ulong        start_slot,
+                                    ulong        end_slot,
+                                    int          level,
+                                    fd_tpool_t * tpool ) {
+  if( FD_UNLIKELY( level<FD_SHREDCAP_ARCHIVE_LEVEL_MIN || level>FD_SHREDCAP_ARCHIVE_LEVEL_MAX ) ) {
+    FD_LOG_ERR(( "zstd level %d not in [%d,%d]", level, FD_SHREDCAP_ARCHIVE_LEVEL_MIN, FD_SHREDCAP_ARCHIVE_LEVEL_MAX ));
+  }
+
+  fd_rocksdb_t rocks_db;
+  char * rocksdb_err = fd_rocksdb_init( &rocks_db, rocksdb_dir );
+  if( FD_UNLIKELY( rocksdb_err ) ) {
+    FD_LOG_ERR(( "fd_rocksdb_init returned %s", rocksdb_err ));
+  }
+
+  ulong last_slot = fd_rocksdb_last_slot( &rocks_db, &rocksdb_err );
+  if( FD_UNLIKELY( rocksdb_err ) ) {
+    FD_LOG_ERR(( "fd_rocksdb_last_slot returned %s", rocksdb_err ));
+  }
+  end_slot = fd_ulong_min( end_slot, last_slot );
+  if( FD_UNLIKELY( end_slot<start_slot ) ) {
+    FD_LOG_ERR(( "rocksdb has no rooted slots in range. last=%lu wanted=%lu", last_slot, start_slot ));
+  }
+
+  /* Create the archive up front so that an existing one is never
+     overwritten nor work wasted */
+
+  int fd = open( archive_path, O_CREAT|O_EXCL|O_WRONLY, (mode_t)0666 );
+  if( FD_UNLIKELY( fd==-1 ) ) {
+    FD_LOG_ERR(( "open(\"%s\",O_CREAT|O_EXCL|O_WRONLY,0%03o) failed (%i-%s)",
+                 archive_path, (uint)0666, errno, fd_io_strerror( errno ) ));
+  }
+
+  fd_valloc_t valloc = fd_libc_alloc_virtual();
+
+  /* Gather the metadata of all rooted slots in range.  This is cheap
+     compared to reading shreds and gives the workers balanced row
+     ranges. */
+
+  ulong row_max = fd_ulong_min( end_slot-start_slot+1UL, FD_SHREDCAP_ARCHIVE_ROW_NULL );
+  fd_shredcap_archive_ingest_t info = {
+    .db             = &rocks_db,
+    .archive_path   = archive_path,
+    .level          = level,
+    .valloc         = valloc,
+    .row_cnt        = 0UL,
+    .slot           = fd_valloc_malloc( valloc, alignof(ulong),     row_max*sizeof(ulong)     ),
+    .parent_slot    = fd_valloc_malloc( valloc, alignof(ulong),     row_max*sizeof(ulong)     ),
+    .first_shred_ts = fd_valloc_malloc( valloc, alignof(long),      row_max*sizeof(long)      ),
+    .last_index     = fd_valloc_malloc( valloc, alignof(ulong),     row_max*sizeof(ulong)     ),
+    .shred_cnt      = fd_valloc_malloc( valloc, alignof(ulong),     row_max*sizeof(ulong)     ),
+    .block_off      = fd_valloc_malloc( valloc, alignof(ulong),     row_max*sizeof(ulong)     ),
+    .block_csz      = fd_valloc_malloc( valloc, alignof(ulong),     row_max*sizeof(ulong)     ),
+    .block_dsz      = fd_valloc_malloc( valloc, alignof(ulong),     row_max*sizeof(ulong)     ),
+    .bank_hash      = fd_valloc_malloc( valloc, alignof(fd_hash_t), row_max*sizeof(fd_hash_t) ),
+  };
+  if( FD_UNLIKELY( !info.slot || !info.parent_slot || !info.first_shred_ts || !info.last_index ||
+                   !info.shred_cnt || !info.block_off || !info.block_csz || !info.block_dsz || !info.bank_hash ) ) {
+    FD_LOG_ERR(( "failed to allocate index for %lu slots", row_max ));
+  }
+
+  fd_rocksdb_root_iter_t iter;
+  fd_rocksdb_root_iter_new( &iter );
+
+  fd_slot_meta_t metadata;
+  fd_memset( &metadata, 0, sizeof(metadata) );
+
+  int ret = fd_rocksdb_root_iter_seek( &iter, &rocks_db, start_slot, &metadata, valloc );
+  if( FD_UNLIKELY( ret ) ) {
+    FD_LOG_ERR(( "fd_rocksdb_root_iter_seek returned %d", ret ));
+  }
+
+  while( !ret && metadata.slot<=end_slot && info.row_cnt<row_max ) {
+    ulong cur_slot = metadata.slot;
+    if( FD_UNLIKELY( metadata.received>FD_SHREDCAP_ARCHIVE_SHRED_MAX ) ) {
+      FD_LOG_ERR(( "slot=%lu has too many shreds (%lu)", cur_slot, metadata.received ));
+    }
+
+    ulong row = info.row_cnt++;
+    info.slot          [ row ] = cur_slot;
+    info.parent_slot   [ row ] = metadata.parent_slot;
+    info.first_shred_ts[ row ] = metadata.first_shred_timestamp;
+    info.last_index    [ row ] = metadata.last_index;
+    info.shred_cnt     [ row ] = metadata.received;
+
+    fd_bincode_destroy_ctx_t ctx = { .valloc = valloc };
+    fd_slot_meta_destroy( &metadata, &ctx );
+
+    /* Handle the case where end_slot is past the last root, as in
+       fd_shredcap_ingest_rocksdb_to_capture */
+    ret = fd_rocksdb_root_iter_next( &iter, &metadata, valloc );
+    if( ret ) ret = fd_rocksdb_get_meta( &rocks_db, cur_slot+1UL, &metadata, valloc );
+  }
+  if( !ret ) {
+    fd_bincode_destroy_ctx_t ctx = { .valloc = valloc };
+    fd_slot_meta_destroy( &metadata, &ctx );
+  }
+  fd_rocksdb_root_iter_destroy( &iter );
+
+  if( FD_UNLIKELY( !info.row_cnt ) ) {
+    FD_LOG_ERR(( "no rooted slots in [%lu,%lu]", start_slot, end_slot ));
+  }
+
+  /* Compress the rows in parallel, one contiguous range per worker */
+
+  ulong worker_cnt = tpool ? fd_tpool_worker_cnt( tpool ) : 1UL;
+  info.part_cnt = fd_ulong_min( worker_cnt, info.row_cnt );
+  info.part_sz  = fd_valloc_malloc( valloc, alignof(ulong), info.part_cnt*sizeof(ulong) );
+  if( FD_UNLIKELY( !info.part_sz ) ) FD_LOG_ERR(( "failed to allocate parts" ));
+
+  FD_LOG_NOTICE(( "ingesting %lu slots in [%lu,%lu] into %lu parts at zstd level %d",
+                  info.row_cnt, info.slot[ 0 ], info.slot[ info.row_cnt-1UL ], info.part_cnt, level ));
+
+  if( info.part_cnt>1UL ) {
+    fd_tpool_exec_all_rrobin( tpool, 0UL, worker_cnt, ingest_task, &info, NULL, NULL, 1UL, 0UL, info.part_cnt );
+  } else {
+    ingest_part( &info, 0UL );
+  }
+
+  /* Concatenate the parts after the header and rebase block offsets */
+
+  fd_shredcap_archive_hdr_t hdr;
+  fd_memset( &hdr, 0, sizeof(hdr) );
+  hdr.magic   = FD_SHREDCAP_ARCHIVE_MAGIC;
+  hdr.version = FD_SHREDCAP_ARCHIVE_VERSION;
+  write_all( fd, &hdr, FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT );
+
+  ulong off = FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT;
+  for( ulong part_idx=0UL; part_idx<info.part_cnt; part_idx++ ) {
+    char path[ PART_PATH_MAX ];
+    set_part_path( path, archive_path, part_idx );
+    ulong sz = append_file( fd, path );
+    if( FD_UNLIKELY( sz!=info.part_sz[ part_idx ] ) ) {
+      FD_LOG_ERR(( "part %lu has %lu bytes, expected %lu", part_idx, sz, info.part_sz[ part_idx ] ));
+    }
+
+    ulong row0 = (part_idx    *info.row_cnt)/info.part_cnt;
+    ulong row1 = ((part_idx+1)*info.row_cnt)/info.part_cnt;
+    for( ulong row=row0; row<row1; row++ ) info.block_off[ row ] += off;
+    off += sz;
+  }
+
+  /* Build the row by slot column and write the index */
+
+  ulong start = info.slot[ 0 ];
+  ulong end   = info.slot[ info.row_cnt-1UL ];
+  uint * row_col = fd_valloc_malloc( valloc, alignof(uint), (end-start+1UL)*sizeof(uint) );
+  if( FD_UNLIKELY( !row_col ) ) FD_LOG_ERR(( "failed to allocate row column" ));
+  for( ulong i=0UL; i<end-start+1UL; i++ ) row_col[ i ] = FD_SHREDCAP_ARCHIVE_ROW_NULL;
+  for( ulong row=0UL; row<info.row_cnt; row++ ) row_col[ info.slot[ row ]-start ] = (uint)row;
+
+  static uchar const zero[ FD_SHREDCAP_ARCHIVE_ALIGN ] = {0};
+  ulong pad = fd_ulong_align_up( off, FD_SHREDCAP_ARCHIVE_ALIGN ) - off;
+  write_all( fd, zero, pad );
+  off += pad;
+
+  ulong n = info.row_cnt;
+  fd_shredcap_archive_ftr_t ftr;
+  fd_memset( &ftr, 0, sizeof(ftr) );
+  ftr.magic              = FD_SHREDCAP_ARCHIVE_MAGIC;
+  ftr.version            = FD_SHREDCAP_ARCHIVE_VERSION;
+  ftr.row_cnt            = n;
+  ftr.start_slot         = start;
+  ftr.end_slot           = end;
+  ftr.slot_off           = write_column( fd, &off, info.slot,           n*sizeof(ulong)           );
+  ftr.parent_slot_off    = write_column( fd, &off, info.parent_slot,    n*sizeof(ulong)           );
+  ftr.first_shred_ts_off = write_column( fd, &off, info.first_shred_ts, n*sizeof(long)            );
+  ftr.last_index_off     = write_column( fd, &off, info.last_index,     n*sizeof(ulong)           );
+  ftr.shred_cnt_off      = write_column( fd, &off, info.shred_cnt,      n*sizeof(ulong)           );
+  ftr.block_off_off      = write_column( fd, &off, info.block_off,      n*sizeof(ulong)           );
+  ftr.block_csz_off      = write_column( fd, &off, info.block_csz,      n*sizeof(ulong)           );
+  ftr.block_dsz_off      = write_column( fd, &off, info.block_dsz,      n*sizeof(ulong)           );
+  ftr.bank_hash_off      = write_column( fd, &off, info.bank_hash,      n*sizeof(fd_hash_t)       );
+  ftr.row_off            = write_column( fd, &off, row_col,             (end-start+1UL)*sizeof(uint) );
+  ftr.magic2             = FD_SHREDCAP_ARCHIVE_MAGIC;
+  write_all( fd, &ftr, FD_SHREDCAP_ARCHIVE_FTR_FOOTPRINT );
+  off += FD_SHREDCAP_ARCHIVE_FTR_FOOTPRINT;
+
+  if( FD_UNLIKELY( close( fd ) ) ) {
+    FD_LOG_ERR(( "unable to close the archive" ));
+  }
+
+  ulong dsz = 0UL;
+  for( ulong row=0UL; row<n; row++ ) dsz += info.block_dsz[ row ];
+  FD_LOG_NOTICE(( "wrote archive=%s with %lu slots in [%lu,%lu] (%lu bytes, %lu bytes of shreds)",
+                  archive_path, n, start, end, off, dsz ));
+
+  fd_valloc_free( valloc, row_col );
+  fd_valloc_free( valloc, info.part_sz );
+  fd_valloc_free( valloc, info.slot );
+  fd_valloc_free( valloc, info.parent_slot );
+  fd_valloc_free( valloc, info.first_shred_ts );
+  fd_valloc_free( valloc, info.last_index );
+  fd_valloc_free( valloc, info.shred_cnt );
+  fd_valloc_free( valloc, info.block_off );
+  fd_valloc_free( valloc, info.block_csz );
+  fd_valloc_free( valloc, info.block_dsz );
+  fd_valloc_free( valloc, info.bank_hash );
+  fd_rocksdb_destroy( &rocks_db );
+}
+
+/**** Read ********************************************************************/
+
+/* map_column returns the sz byte column at file offset off of ar, or
+   NULL if the column is not within the index. */
+
+static void const *
+map_column( fd_shredcap_archive_t const * ar,
+            ulong                         off,
+            ulong                         sz,
+            ulong                         index_end ) {
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( off, FD_SHREDCAP_ARCHIVE_ALIGN ) ||
+                   off<FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT ||
+                   off>index_end || sz>index_end-off ) ) {
+    FD_LOG_WARNING(( "archive column at offset %lu (%lu bytes) out of bounds", off, sz ));
+    return NULL;
+  }
+  return ar->map + off;
+}
+
+fd_shredcap_archive_t *
+fd_shredcap_archive_open( fd_shredcap_archive_t * ar,
+                          char const *            path ) {
+  fd_memset( ar, 0, sizeof(fd_shredcap_archive_t) );
+
+  ar->fd = open( path, O_RDONLY, (mode_t)0 );
+  if( FD_UNLIKELY( ar->fd==-1 ) ) {
+    FD_LOG_WARNING(( "open(\"%s\",O_RDONLY,0) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  struct stat st;
+  if( FD_UNLIKELY( fstat( ar->fd, &st ) ) ) {
+    FD_LOG_WARNING(( "fstat(\"%s\") failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    close( ar->fd );
+    return NULL;
+  }
+  ar->map_sz = (ulong)st.st_size;
+  if( FD_UNLIKELY( ar->map_sz<FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT+FD_SHREDCAP_ARCHIVE_FTR_FOOTPRINT ) ) {
+    FD_LOG_WARNING(( "\"%s\" is too small to be an archive", path ));
+    close( ar->fd );
+    return NULL;
+  }
+
+  void * map = mmap( NULL, ar->map_sz, PROT_READ, MAP_SHARED, ar->fd, 0 );
+  if( FD_UNLIKELY( map==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(\"%s\") failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    close( ar->fd );
+    return NULL;
+  }
+  ar->map = map;
+
+  /* Check the header and footer */
+
+  fd_shredcap_archive_hdr_t const * hdr = (fd_shredcap_archive_hdr_t const *)ar->map;
+  ulong index_end = ar->map_sz - FD_SHREDCAP_ARCHIVE_FTR_FOOTPRINT;
+  fd_shredcap_archive_ftr_t const * ftr = (fd_shredcap_archive_ftr_t const *)( ar->map + index_end );
+  ar->ftr = ftr;
+  if( FD_UNLIKELY( hdr->magic!=FD_SHREDCAP_ARCHIVE_MAGIC || ftr->magic!=FD_SHREDCAP_ARCHIVE_MAGIC ||
+                   ftr->magic2!=FD_SHREDCAP_ARCHIVE_MAGIC ) ) {
+    FD_LOG_WARNING(( "\"%s\" is not an archive or is truncated", path ));
+    goto fail;
+  }
+  if( FD_UNLIKELY( hdr->version!=FD_SHREDCAP_ARCHIVE_VERSION || ftr->version!=FD_SHREDCAP_ARCHIVE_VERSION ) ) {
+    FD_LOG_WARNING(( "archive version=%lu doesn't match expected version=%lu", ftr->version, FD_SHREDCAP_ARCHIVE_VERSION ));
+    goto fail;
+  }
+
+  ulong n = ftr->row_cnt;
+  if( FD_UNLIKELY( !n || n>FD_SHREDCAP_ARCHIVE_ROW_NULL || ftr->end_slot<ftr->start_slot ||
+                   ftr->end_slot-ftr->start_slot>=FD_SHREDCAP_ARCHIVE_ROW_NULL ||
+                   n>ftr->end_slot-ftr->start_slot+1UL ) ) {
+    FD_LOG_WARNING(( "archive has a malformed slot range" ));
+    goto fail;
+  }
+  ar->row_cnt    = n;
+  ar->start_slot = ftr->start_slot;
+  ar->end_slot   = ftr->end_slot;
+
+  ar->slot           = map_column( ar, ftr->slot_off,           n*sizeof(ulong),     index_end );
+  ar->parent_slot    = map_column( ar, ftr->parent_slot_off,    n*sizeof(ulong),     index_end );
+  ar->first_shred_ts = map_column( ar, ftr->first_shred_ts_off, n*sizeof(long),      index_end );
+  ar->last_index     = map_column( ar, ftr->last_index_off,     n*sizeof(ulong),     index_end );
+  ar->shred_cnt      = map_column( ar, ftr->shred_cnt_off,      n*sizeof(ulong),     index_end );
+  ar->block_off      = map_column( ar, ftr->block_off_off,      n*sizeof(ulong),     index_end );
+  ar->block_csz      = map_column( ar, ftr->block_csz_off,      n*sizeof(ulong),     index_end );
+  ar->block_dsz      = map_column( ar, ftr->block_dsz_off,      n*sizeof(ulong),     index_end );
+  ar->bank_hash      = map_column( ar, ftr->bank_hash_off,      n*sizeof(fd_hash_t), index_end );
+  ar->row            = map_column( ar, ftr->row_off, (ar->end_slot-ar->start_slot+1UL)*sizeof(uint), index_end );
+  if( FD_UNLIKELY( !ar->slot || !ar->parent_slot || !ar->first_shred_ts || !ar->last_index || !ar->shred_cnt ||
+                   !ar->block_off || !ar->block_csz || !ar->block_dsz || !ar->bank_hash || !ar->row ) ) {
+    goto fail;
+  }
+
+  /* Check the index once so that lookups need no bounds checks.  This
+     reads a few dozen bytes per slot, which is small next to the
+     blocks. */
+
+  ulong prev_slot = 0UL;
+  for( ulong row=0UL; row<n; row++ ) {
+    ulong slot = ar->slot[ row ];
+    if( FD_UNLIKELY( slot<ar->start_slot || slot>ar->end_slot || ( row && slot<=prev_slot ) ||
+                     ar->row[ slot-ar->start_slot ]!=(uint)row ) ) {
+      FD_LOG_WARNING(( "archive index is corrupt at row %lu (slot=%lu)", row, slot ));
+      goto fail;
+    }
+    prev_slot = slot;
+
+    ulong off = ar->block_off[ row ];
+    ulong csz = ar->block_csz[ row ];
+    ulong dsz = ar->block_dsz[ row ];
+    if( FD_UNLIKELY( off<FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT || off>index_end || csz>index_end-off ||
+                     ar->shred_cnt[ row ]>FD_SHREDCAP_ARCHIVE_SHRED_MAX ||
+                     dsz>FD_SHREDCAP_ARCHIVE_BLOCK_MAX || dsz<ar->shred_cnt[ row ]*sizeof(ushort) ) ) {
+      FD_LOG_WARNING(( "archive block for slot=%lu is out of bounds", slot ));
+      goto fail;
+    }
+    ar->block_dsz_max = fd_ulong_max( ar->block_dsz_max, dsz );
+  }
+
+  ulong slot_cnt = 0UL;
+  for( ulong i=0UL; i<ar->end_slot-ar->start_slot+1UL; i++ ) slot_cnt += (ulong)( ar->row[ i ]!=FD_SHREDCAP_ARCHIVE_ROW_NULL );
+  if( FD_UNLIKELY( slot_cnt!=n ) ) {
+    FD_LOG_WARNING(( "archive row column has %lu slots, expected %lu", slot_cnt, n ));
+    goto fail;
+  }
+
+  return ar;
+
+fail:
+  munmap( (void *)ar->map, ar->map_sz );
+  close( ar->fd );
+  return NULL;
+}
+
+void
+fd_shredcap_archive_close( fd_shredcap_archive_t * ar ) {
+  if( FD_UNLIKELY( munmap( (void *)ar->map, ar->map_sz ) ) ) {
+    FD_LOG_WARNING(( "munmap failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+  if( FD_UNLIKELY( close( ar->fd ) ) ) {
+    FD_LOG_WARNING(( "unable to close the archive (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+  fd_memset( ar, 0, sizeof(fd_shredcap_archive_t) );
+}
+
+int
+fd_shredcap_archive_block_read( fd_shredcap_archive_t const * ar,
+                                ulong                         row,
+                                fd_zstd_dstream_t *           dstream,
+                                uchar *                       buf ) {
+  ulong slot = ar->slot     [ row ];
+  ulong dsz  = ar->block_dsz[ row ];
+  ulong cnt  = ar->shred_cnt[ row ];
+
+  uchar const * in      = fd_shredcap_archive_block( ar, row );
+  uchar const * in_end  = in + ar->block_csz[ row ];
+  uchar *       out     = buf;
+  uchar *       out_end = buf + dsz;
+
+  fd_zstd_dstream_reset( dstream );
+  int rc = 0;
+  while( !rc ) {
+    uchar const * in0  = in;
+    uchar *       out0 = out;
+    rc = fd_zstd_dstream_read( dstream, &in, in_end, &out, out_end, NULL );
+    if( FD_UNLIKELY( !rc && in==in0 && out==out0 ) ) break; /* truncated frame or block larger than dsz */
+  }
+  if( FD_UNLIKELY( rc!=-1 || in!=in_end || out!=out_end ) ) {
+    FD_LOG_WARNING(( "failed to decompress block for slot=%lu", slot ));
+    return -1;
+  }
+
+  /* Check the shreds against the size column */
+
+  ushort const * shred_sz = (ushort const *)buf;
+  ulong          off      = cnt*sizeof(ushort);
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong sz = shred_sz[ i ];
+    fd_shred_t const * shred = sz<=dsz-off ? fd_shred_parse( buf+off, sz ) : NULL;
+    if( FD_UNLIKELY( !shred || shred->slot!=slot || shred->idx!=i ) ) {
+      FD_LOG_WARNING(( "block for slot=%lu has an invalid shred at index=%lu", slot, i ));
+      return -1;
+    }
+    off += sz;
+  }
+  if( FD_UNLIKELY( off!=dsz ) ) {
+    FD_LOG_WARNING(( "block for slot=%lu has %lu trailing bytes", slot, dsz-off ));
+    return -1;
+  }
+  return 0;
+}
+
+/* fd_shredcap_archive_read_t holds the per worker decompression state
+   for verify and populate */
+
+struct fd_shredcap_archive_read {
+  fd_shredcap_archive_t const * ar;
+  fd_blockstore_t *             blockstore;   /* NULL to only verify */
+  fd_zstd_dstream_t **          dstream;      /* Indexed by worker */
+  uchar **                      buf;          /* Indexed by worker */
+};
+typedef struct fd_shredcap_archive_read fd_shredcap_archive_read_t;
+
+static void
+read_row( fd_shredcap_archive_read_t const * info,
+          ulong                              row,
+          ulong                              worker_idx ) {
+  fd_shredcap_archive_t const * ar  = info->ar;
+  uchar *                       buf = info->buf[ worker_idx ];
+  ulong                         slot = ar->slot[ row ];
+
+  if( FD_UNLIKELY( fd_shredcap_archive_block_read( ar, row, info->dstream[ worker_idx ], buf ) ) ) {
+    FD_LOG_ERR(( "archive block for slot=%lu is corrupt", slot ));
+  }
+
+  fd_blockstore_t * blockstore = info->blockstore;
+  if( !blockstore ) return;
+
+  ushort const * shred_sz = (ushort const *)buf;
+  ulong          cnt      = ar->shred_cnt[ row ];
+  ulong          off      = cnt*sizeof(ushort);
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_buf_shred_insert( blockstore, (fd_shred_t const *)( buf+off ) );
+    off += shred_sz[ i ];
+  }
+
+  fd_hash_t const * bank_hash = ar->bank_hash + row;
+  if( fd_hash_check_zero( bank_hash ) ) return;
+  fd_blockstore_start_read( blockstore );
+  fd_block_map_t * block = fd_blockstore_block_map_query( blockstore, slot );
+  fd_blockstore_end_read( blockstore );
+  if( FD_LIKELY( block ) ) {
+    fd_memcpy( block->bank_hash.hash, bank_hash->hash, 32UL );
+  }
+}
+
+static void
+read_task( void * tpool,
+           ulong  t0 FD_PARAM_UNUSED,      ulong t1 FD_PARAM_UNUSED,
+           void * args FD_PARAM_UNUSED,
+           void * reduce FD_PARAM_UNUSED,  ulong stride FD_PARAM_UNUSED,
+           ulong  l0 FD_PARAM_UNUSED,      ulong l1 FD_PARAM_UNUSED,
+           ulong  m0,                      ulong m1 FD_PARAM_UNUSED,
+           ulong  n0,                      ulong n1 FD_PARAM_UNUSED ) {
+  read_row( (fd_shredcap_archive_read_t const *)tpool, m0, n0 );
+}
+
+/* read_rows decompresses (and inserts, see read_row) rows
+   [row0,row1) of ar striped over the workers of tpool */
+
+static void
+read_rows( fd_shredcap_archive_t const * ar,
+           fd_blockstore_t *             blockstore,
+           ulong                         row0,
+           ulong                         row1,
+           fd_valloc_t                   valloc,
+           fd_tpool_t *                  tpool ) {
+  if( row0>=row1 ) return;
+
+  /* Hint the kernel to read ahead the blocks in range */
+
+  ulong map_lo = fd_ulong_align_dn( ar->block_off[ row0 ], FD_SHMEM_NORMAL_PAGE_SZ );
+  ulong map_hi = ar->block_off[ row1-1UL ] + ar->block_csz[ row1-1UL ];
+  if( FD_UNLIKELY( madvise( (void *)( ar->map+map_lo ), map_hi-map_lo, MADV_WILLNEED ) ) ) {
+    FD_LOG_WARNING(( "madvise failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+
+  ulong worker_cnt = tpool ? fd_tpool_worker_cnt( tpool ) : 1UL;
+  ulong buf_sz     = fd_ulong_align_up( fd_ulong_max( ar->block_dsz_max, 1UL ), FD_SHREDCAP_ARCHIVE_ALIGN );
+
+  fd_shredcap_archive_read_t info = {
+    .ar         = ar,
+    .blockstore = blockstore,
+    .dstream    = fd_valloc_malloc( valloc, alignof(fd_zstd_dstream_t *), worker_cnt*sizeof(fd_zstd_dstream_t *) ),
+    .buf        = fd_valloc_malloc( valloc, alignof(uchar *),             worker_cnt*sizeof(uchar *)             ),
+  };
+  if( FD_UNLIKELY( !info.dstream || !info.buf ) ) FD_LOG_ERR(( "failed to allocate readers" ));
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    void * dmem = fd_valloc_malloc( valloc, fd_zstd_dstream_align(), fd_zstd_dstream_footprint( FD_SHREDCAP_ARCHIVE_WINDOW_MAX ) );
+    info.buf[ i ] = fd_valloc_malloc( valloc, FD_SHREDCAP_ARCHIVE_ALIGN, buf_sz );
+    if( FD_UNLIKELY( !dmem || !info.buf[ i ] ) ) FD_LOG_ERR(( "failed to allocate reader %lu", i ));
+    info.dstream[ i ] = fd_zstd_dstream_new( dmem, FD_SHREDCAP_ARCHIVE_WINDOW_MAX );
+    if( FD_UNLIKELY( !info.dstream[ i ] ) ) FD_LOG_ERR(( "failed to create zstd decompressor" ));
+  }
+
+  if( worker_cnt>1UL ) {
+    fd_tpool_exec_all_rrobin( tpool, 0UL, worker_cnt, read_task, &info, NULL, NULL, 1UL, row0, row1 );
+  } else {
+    for( ulong row=row0; row<row1; row++ ) read_row( &info, row, 0UL );
+  }
+
+  for( ulong i=0UL; i<worker_cnt; i++ ) {
+    fd_valloc_free( valloc, fd_zstd_dstream_delete( info.dstream[ i ] ) );
+    fd_valloc_free( valloc, info.buf[ i ] );
+  }
+  fd_valloc_free( valloc, info.dstream );
+  fd_valloc_free( valloc, info.buf );
+}
+
+void
+fd_shredcap_archive_verify( fd_shredcap_archive_t const * ar,
+                            fd_valloc_t                   valloc,
+                            fd_tpool_t *                  tpool ) {
+  read_rows( ar, NULL, 0UL, ar->row_cnt, valloc, tpool );
+
+  ulong csz = 0UL;
+  ulong dsz = 0UL;
+  ulong hash_cnt = 0UL;
+  for( ulong row=0UL; row<ar->row_cnt; row++ ) {
+    csz      += ar->block_csz[ row ];
+    dsz      += ar->block_dsz[ row ];
+    hash_cnt += (ulong)!fd_hash_check_zero( ar->bank_hash+row );
+  }
+  FD_LOG_NOTICE(( "verified %lu slots in [%lu,%lu] (%lu bank hashes, %lu bytes compressed to %lu, ratio %.2f)",
+                  ar->row_cnt, ar->start_slot, ar->end_slot, hash_cnt, dsz, csz, (double)dsz/(double)fd_ulong_max( csz, 1UL ) ));
+}
+
+void
+fd_shredcap_archive_populate_blockstore( fd_shredcap_archive_t const * ar,
+                                         fd_blockstore_t *             blockstore,
+                                         ulong                         start_slot,
+                                         ulong                         end_slot,
+                                         fd_valloc_t                   valloc,
+                                         fd_tpool_t *                  tpool ) {
+  if( FD_UNLIKELY( start_slot>end_slot ) ) {
+    FD_LOG_ERR(( "start_slot=%lu must be less than the end_slot=%lu", start_slot, end_slot ));
+  }
+  if( FD_UNLIKELY( start_slot>ar->end_slot || end_slot<ar->start_slot ) ) {
+    FD_LOG_ERR(( "range [%lu,%lu] is outside of the archive's range [%lu,%lu]",
+                 start_slot, end_slot, ar->start_slot, ar->end_slot ));
+  }
+
+  /* Find the first row at or after start_slot and the first row after
+     end_slot */
+
+  ulong lo = 0UL;
+  ulong hi = ar->row_cnt;
+  while( lo<hi ) {
+    ulong mid = (lo+hi)/2UL;
+    if( ar->slot[ mid ]<start_slot ) lo = mid+1UL; else hi = mid;
+  }
+  ulong row0 = lo;
+
+  hi = ar->row_cnt;
+  while( lo<hi ) {
+    ulong mid = (lo+hi)/2UL;
+    if( ar->slot[ mid ]<=end_slot ) lo = mid+1UL; else hi = mid;
+  }
+  ulong row1 = lo;
+
+  long dt = -fd_log_wallclock();
+  read_rows( ar, blockstore, row0, row1, valloc, tpool );
+  dt += fd_log_wallclock();
+
+  FD_LOG_NOTICE(( "populated blockstore with %lu slots in [%lu,%lu] in %.3f s",
+                  row1-row0, start_slot, end_slot, (double)dt*1e-9 ));
+}
@@ -0,0 +1,251 @@
+#ifndef HEADER_fd_src_flamenco_shredcap_fd_shredcap_archive_h
+#define HEADER_fd_src_flamenco_shredcap_fd_shredcap_archive_h
+
+/* fd_shredcap_archive is a compressed, randomly accessible variant of
+   the fd_shredcap capture.  A whole slot range lives in a single file:
+   each slot is one independent zstd frame and a columnar index at the
+   end of the file locates any slot (and its bank hash) in O(1).  The
+   file is meant to be memory mapped read only, so that populating a
+   blockstore only touches the frames of the requested slots.
+
+   |--fd_shredcap archive------------|
+   |**** Header *********************|
+   | Magic + Version                 |
+   |---------------------------------|
+   |**** Block (one zstd frame) *****|
+   | Shred Sizes (ushort each)       |
+   | Shreds (back to back)           |
+   |---------------------------------|
+   |////// Each Slot In Range ///////|
+   |---------------------------------|
+   |**** Index (one column each) ****|
+   | Slot                            |
+   | Parent Slot                     |
+   | First Shred Timestamp           |
+   | Last Index                      |
+   | Shred Count                     |
+   | Block Offset                    |
+   | Block Compressed Size           |
+   | Block Decompressed Size         |
+   | Bank Hash                       |
+   | Row By Slot - Start Slot        |
+   |---------------------------------|
+   |**** Footer *********************|
+   | Magic + Version + Row Count     |
+   | Start/End Slot                  |
+   | Column Offsets                  |
+   |---------------------------------|
+
+   Rows are sorted by slot.  Slots in [start_slot,end_slot] without a
+   block (skipped slots) map to FD_SHREDCAP_ARCHIVE_ROW_NULL in the row
+   column.  Each frame records its decompressed size in its header.  A
+   bank hash of all zeros means the source had no bank hash for the
+   slot.
+
+   Ingestion splits the slot range into as many contiguous row ranges
+   as there are tpool workers.  Each worker reads and compresses its
+   range into a part file, and the parts are then concatenated (with
+   copy_file_range, so usually without going through user space) ahead
+   of the index. */
+
+#include "fd_shredcap.h"
+#include "../../ballet/zstd/fd_zstd.h"
+#include "../../util/tpool/fd_tpool.h"
+
+#define FD_SHREDCAP_ARCHIVE_MAGIC   (0x3276416370436453UL)
+#define FD_SHREDCAP_ARCHIVE_VERSION (1UL)
+
+/* Columns (and the first block) start at multiples of
+   FD_SHREDCAP_ARCHIVE_ALIGN */
+
+#define FD_SHREDCAP_ARCHIVE_ALIGN (64UL)
+
+#define FD_SHREDCAP_ARCHIVE_ROW_NULL (UINT_MAX)
+
+/* FD_SHREDCAP_ARCHIVE_LEVEL_{MIN,MAX} bound the zstd level used for
+   blocks.  Above level 19 the zstd window outgrows
+   FD_SHREDCAP_ARCHIVE_WINDOW_MAX, the largest window a reader has to
+   support. */
+
+#define FD_SHREDCAP_ARCHIVE_LEVEL_DEFAULT (3)
+#define FD_SHREDCAP_ARCHIVE_LEVEL_MIN     (1)
+#define FD_SHREDCAP_ARCHIVE_LEVEL_MAX     (19)
+#define FD_SHREDCAP_ARCHIVE_WINDOW_MAX    (1UL<<23)
+
+/* FD_SHREDCAP_ARCHIVE_SHRED_MAX is the max number of shreds in a
+   block */
+
+#define FD_SHREDCAP_ARCHIVE_SHRED_MAX (1UL<<15)
+
+/* FD_SHREDCAP_ARCHIVE_BLOCK_MAX is the max decompressed size of a
+   block */
+
+#define FD_SHREDCAP_ARCHIVE_BLOCK_MAX (FD_SHREDCAP_ARCHIVE_SHRED_MAX*(sizeof(ushort)+FD_SHRED_MAX_SZ))
+
+#define FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT (64UL)
+struct __attribute__((packed,aligned(FD_SHREDCAP_ALIGN))) fd_shredcap_archive_hdr {
+  ulong magic;
+  ulong version;
+  uchar pad[ 48 ];
+};
+typedef struct fd_shredcap_archive_hdr fd_shredcap_archive_hdr_t;
+
+#define FD_SHREDCAP_ARCHIVE_FTR_FOOTPRINT (128UL)
+struct __attribute__((packed,aligned(FD_SHREDCAP_ALIGN))) fd_shredcap_archive_ftr {
+  ulong magic;
+  ulong version;
+  ulong row_cnt;
+  ulong start_slot;            /* Slot of the first row */
+  ulong end_slot;              /* Slot of the last row */
+
+  /* File offsets of the index columns */
+  ulong slot_off;              /* ulong    [ row_cnt ] */
+  ulong parent_slot_off;       /* ulong    [ row_cnt ] */
+  ulong first_shred_ts_off;    /* long     [ row_cnt ] */
+  ulong last_index_off;        /* ulong    [ row_cnt ] */
+  ulong shred_cnt_off;         /* ulong    [ row_cnt ] */
+  ulong block_off_off;         /* ulong    [ row_cnt ] */
+  ulong block_csz_off;         /* ulong    [ row_cnt ] */
+  ulong block_dsz_off;         /* ulong    [ row_cnt ] */
+  ulong bank_hash_off;         /* fd_hash_t[ row_cnt ] */
+  ulong row_off;               /* uint     [ end_slot-start_slot+1 ] */
+
+  ulong magic2;                /* == magic, last word of the file */
+};
+typedef struct fd_shredcap_archive_ftr fd_shredcap_archive_ftr_t;
+
+FD_STATIC_ASSERT( sizeof(fd_shredcap_archive_hdr_t)==FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT, shredcap_archive );
+FD_STATIC_ASSERT( sizeof(fd_shredcap_archive_ftr_t)==FD_SHREDCAP_ARCHIVE_FTR_FOOTPRINT, shredcap_archive );
+
+/* fd_shredcap_archive_t is a read only mapping of an archive.  The
+   column pointers point into the mapping. */
+
+struct fd_shredcap_archive {
+  int                               fd;
+  uchar const *                     map;
+  ulong                             map_sz;
+  fd_shredcap_archive_ftr_t const * ftr;
+
+  ulong             row_cnt;
+  ulong             start_slot;
+  ulong             end_slot;
+  ulong             block_dsz_max;   /* Largest decompressed block */
+
+  ulong const *     slot;
+  ulong const *     parent_slot;
+  long  const *     first_shred_ts;
+  ulong const *     last_index;
+  ulong const *     shred_cnt;
+  ulong const *     block_off;
+  ulong const *     block_csz;
+  ulong const *     block_dsz;
+  fd_hash_t const * bank_hash;
+  uint  const *     row;
+};
+typedef struct fd_shredcap_archive fd_shredcap_archive_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_shredcap_archive_ingest_rocksdb writes the rooted slots of the
+   rocksdb at rocksdb_dir in [start_slot,end_slot] to a new archive at
+   archive_path, compressing blocks at the given zstd level.  The range
+   is split across the workers [0,fd_tpool_worker_cnt( tpool )) of
+   tpool (NULL to ingest on the caller only).  Part files are written
+   next to archive_path.  Terminates the process on failure, like the
+   rest of fd_shredcap. */
+
+void
+fd_shredcap_archive_ingest_rocksdb( char const * rocksdb_dir,
+                                    char const * archive_path,
+                                    ulong        start_slot,
+                                    ulong        end_slot,
+                                    int          level,
+                                    fd_tpool_t * tpool );
+
+/* fd_shredcap_archive_open maps the archive at path into ar.  Returns
+   ar on success and NULL (logs details) if the file cannot be mapped
+   or its footer or index is malformed.  Block contents are not checked
+   here, see fd_shredcap_archive_verify. */
+
+fd_shredcap_archive_t *
+fd_shredcap_archive_open( fd_shredcap_archive_t * ar,
+                          char const *            path );
+
+/* fd_shredcap_archive_close unmaps ar. */
+
+void
+fd_shredcap_archive_close( fd_shredcap_archive_t * ar );
+
+/* fd_shredcap_archive_row returns the row of slot, or ULONG_MAX if the
+   archive has no block for slot. */
+
+FD_FN_PURE static inline ulong
+fd_shredcap_archive_row( fd_shredcap_archive_t const * ar,
+                         ulong                         slot ) {
+  if( FD_UNLIKELY( (slot<ar->start_slot) | (slot>ar->end_slot) ) ) return ULONG_MAX;
+  uint row = ar->row[ slot-ar->start_slot ];
+  return row==FD_SHREDCAP_ARCHIVE_ROW_NULL ? ULONG_MAX : (ulong)row;
+}
+
+/* fd_shredcap_archive_bank_hash returns the bank hash of slot, or NULL
+   if the archive has no block or no bank hash for slot. */
+
+FD_FN_PURE static inline fd_hash_t const *
+fd_shredcap_archive_bank_hash( fd_shredcap_archive_t const * ar,
+                               ulong                         slot ) {
+  ulong row = fd_shredcap_archive_row( ar, slot );
+  if( FD_UNLIKELY( row==ULONG_MAX ) ) return NULL;
+  fd_hash_t const * hash = ar->bank_hash + row;
+  return fd_hash_check_zero( hash ) ? NULL : hash;
+}
+
+/* fd_shredcap_archive_block returns the compressed block of row in the
+   mapping.  Its size is ar->block_csz[ row ]. */
+
+FD_FN_PURE static inline uchar const *
+fd_shredcap_archive_block( fd_shredcap_archive_t const * ar,
+                           ulong                         row ) {
+  return ar->map + ar->block_off[ row ];
+}
+
+/* fd_shredcap_archive_block_read decompresses the block of row into
+   buf, which has room for ar->block_dsz[ row ] bytes, using dstream (which
+   supports FD_SHREDCAP_ARCHIVE_WINDOW_MAX windows).  Returns 0 on
+   success and -1 (logs details) if the block is corrupt.  On success,
+   the first ar->shred_cnt[ row ] ushorts of buf are the shred sizes and
+   the shreds follow. */
+
+int
+fd_shredcap_archive_block_read( fd_shredcap_archive_t const * ar,
+                                ulong                         row,
+                                fd_zstd_dstream_t *           dstream,
+                                uchar *                       buf );
+
+/* fd_shredcap_archive_verify decompresses every block of ar with the
+   workers of tpool (NULL for the caller only) and checks it holds the
+   expected number of well formed shreds of its slot.  Terminates the
+   process on the first corrupt block. */
+
+void
+fd_shredcap_archive_verify( fd_shredcap_archive_t const * ar,
+                            fd_valloc_t                   valloc,
+                            fd_tpool_t *                  tpool );
+
+/* fd_shredcap_archive_populate_blockstore inserts the blocks of ar in
+   [start_slot,end_slot] into blockstore along with their bank hashes.
+   Blocks are striped over the workers of tpool (NULL for the caller
+   only), which decompress them straight from the mapping and insert
+   their shreds concurrently.  Terminates the process on a corrupt
+   block. */
+
+void
+fd_shredcap_archive_populate_blockstore( fd_shredcap_archive_t const * ar,
+                                         fd_blockstore_t *             blockstore,
+                                         ulong                         start_slot,
+                                         ulong                         end_slot,
+                                         fd_valloc_t                   valloc,
+                                         fd_tpool_t *                  tpool );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_shredcap_fd_shredcap_archive_h */
@@ -0,0 +1,266 @@
+#include "fd_shredcap_archive.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/* Builds a small archive by hand (ingestion needs a rocksdb), reads it
+   back and checks that truncated files and corrupt footers or index
+   columns are rejected by fd_shredcap_archive_open. */
+
+#define START_SLOT (10UL)
+#define END_SLOT   (14UL)
+#define ROW_CNT    (4UL)   /* slot 12 is skipped */
+#define PAYLOAD_SZ (200UL)
+#define FILE_MAX   (1UL<<20)
+
+static ulong const row_slot     [ ROW_CNT ] = { 10UL, 11UL, 13UL, 14UL };
+static ulong const row_shred_cnt[ ROW_CNT ] = {  3UL,  1UL,  4UL,  2UL };
+
+static uchar file[ FILE_MAX ] __attribute__((aligned(FD_SHREDCAP_ARCHIVE_ALIGN)));
+static uchar copy[ FILE_MAX ] __attribute__((aligned(FD_SHREDCAP_ARCHIVE_ALIGN)));
+static uchar block[ ROW_CNT ][ 4096 ];
+static ulong block_sz[ ROW_CNT ];
+
+static char tmp_path[] = "/tmp/test_shredcap_archive.XXXXXX";
+
+/* make_block formats the block of row as the archive stores it: the
+   shred size column followed by legacy data shreds. */
+
+static void
+make_block( ulong row ) {
+  ulong   cnt = row_shred_cnt[ row ];
+  uchar * buf = block[ row ];
+  ulong   off = cnt*sizeof(ushort);
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong        sz    = FD_SHRED_DATA_HEADER_SZ + PAYLOAD_SZ;
+    fd_shred_t * shred = (fd_shred_t *)( buf+off );
+    fd_memset( shred, 0, sz );
+    shred->variant         = fd_shred_variant( FD_SHRED_TYPE_LEGACY_DATA, 0 );
+    shred->slot            = row_slot[ row ];
+    shred->idx             = (uint)i;
+    shred->data.parent_off = 1;
+    shred->data.size       = (ushort)sz;
+    fd_memset( buf+off+FD_SHRED_DATA_HEADER_SZ, (int)(row*16UL+i), PAYLOAD_SZ );
+    FD_STORE( ushort, buf+i*sizeof(ushort), (ushort)sz );
+    off += sz;
+  }
+  block_sz[ row ] = off;
+}
+
+static ulong
+append_column( ulong * off, void const * col, ulong sz ) {
+  ulong col_off = *off;
+  fd_memcpy( file+col_off, col, sz );
+  *off = fd_ulong_align_up( col_off+sz, FD_SHREDCAP_ARCHIVE_ALIGN );
+  return col_off;
+}
+
+/* make_archive writes the archive to file and returns its size */
+
+static ulong
+make_archive( fd_zstd_cstream_t * cstream ) {
+  fd_memset( file, 0, FILE_MAX );
+
+  fd_shredcap_archive_hdr_t * hdr = (fd_shredcap_archive_hdr_t *)file;
+  hdr->magic   = FD_SHREDCAP_ARCHIVE_MAGIC;
+  hdr->version = FD_SHREDCAP_ARCHIVE_VERSION;
+
+  ulong     parent_slot   [ ROW_CNT ];
+  long      first_shred_ts[ ROW_CNT ];
+  ulong     last_index    [ ROW_CNT ];
+  ulong     block_off     [ ROW_CNT ];
+  ulong     block_csz     [ ROW_CNT ];
+  ulong     block_dsz     [ ROW_CNT ];
+  fd_hash_t bank_hash     [ ROW_CNT ];
+  uint      row_col       [ END_SLOT-START_SLOT+1UL ];
+  for( ulong i=0UL; i<END_SLOT-START_SLOT+1UL; i++ ) row_col[ i ] = FD_SHREDCAP_ARCHIVE_ROW_NULL;
+
+  ulong off = FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT;
+  for( ulong row=0UL; row<ROW_CNT; row++ ) {
+    make_block( row );
+    FD_TEST( !fd_zstd_cstream_reset( cstream, block_sz[ row ] ) );
+    uchar const * in  = block[ row ];
+    uchar *       out = file+off;
+    FD_TEST( fd_zstd_cstream_write( cstream, &in, block[ row ]+block_sz[ row ], &out, file+FILE_MAX, 1, NULL )==-1 );
+
+    parent_slot   [ row ] = row ? row_slot[ row-1UL ] : START_SLOT-1UL;
+    first_shred_ts[ row ] = (long)row_slot[ row ]*1000L;
+    last_index    [ row ] = row_shred_cnt[ row ]-1UL;
+    block_off     [ row ] = off;
+    block_csz     [ row ] = (ulong)(out-(file+off));
+    block_dsz     [ row ] = block_sz[ row ];
+    fd_memset( bank_hash+row, (int)(0x40UL+row), sizeof(fd_hash_t) );
+    row_col[ row_slot[ row ]-START_SLOT ] = (uint)row;
+    off += block_csz[ row ];
+  }
+  fd_hash_set_zero( bank_hash+2UL ); /* no bank hash for slot 13 */
+  off = fd_ulong_align_up( off, FD_SHREDCAP_ARCHIVE_ALIGN );
+
+  fd_shredcap_archive_ftr_t ftr = {
+    .magic              = FD_SHREDCAP_ARCHIVE_MAGIC,
+    .version            = FD_SHREDCAP_ARCHIVE_VERSION,
+    .row_cnt            = ROW_CNT,
+    .start_slot         = START_SLOT,
+    .end_slot           = END_SLOT,
+    .slot_off           = append_column( &off, row_slot,       sizeof(row_slot)       ),
+    .parent_slot_off    = append_column( &off, parent_slot,    sizeof(parent_slot)    ),
+    .first_shred_ts_off = append_column( &off, first_shred_ts, sizeof(first_shred_ts) ),
+    .last_index_off     = append_column( &off, last_index,     sizeof(last_index)     ),
+    .shred_cnt_off      = append_column( &off, row_shred_cnt,  sizeof(row_shred_cnt)  ),
+    .block_off_off      = append_column( &off, block_off,      sizeof(block_off)      ),
+    .block_csz_off      = append_column( &off, block_csz,      sizeof(block_csz)      ),
+    .block_dsz_off      = append_column( &off, block_dsz,      sizeof(block_dsz)      ),
+    .bank_hash_off      = append_column( &off, bank_hash,      sizeof(bank_hash)      ),
+    .row_off            = append_column( &off, row_col,        sizeof(row_col)        ),
+    .magic2             = FD_SHREDCAP_ARCHIVE_MAGIC
+  };
+  fd_memcpy( file+off, &ftr, sizeof(ftr) );
+  return off+sizeof(ftr);
+}
+
+static void
+write_file( uchar const * buf,
+            ulong         sz ) {
+  int fd = open( tmp_path, O_WRONLY|O_TRUNC, (mode_t)0 );
+  if( FD_UNLIKELY( fd==-1 ) ) FD_LOG_ERR(( "open(\"%s\") failed (%i-%s)", tmp_path, errno, fd_io_strerror( errno ) ));
+  ulong wsz;
+  FD_TEST( !fd_io_write( fd, buf, sz, sz, &wsz ) );
+  FD_TEST( !close( fd ) );
+}
+
+/* open_corrupt writes the archive with the ulong at byte offset off
+   replaced by val and returns 1 if fd_shredcap_archive_open rejects
+   it. */
+
+static int
+open_corrupt( ulong file_sz,
+              ulong off,
+              ulong val ) {
+  fd_memcpy( copy, file, file_sz );
+  FD_STORE( ulong, copy+off, val );
+  write_file( copy, file_sz );
+  fd_shredcap_archive_t ar[1];
+  if( fd_shredcap_archive_open( ar, tmp_path ) ) {
+    fd_shredcap_archive_close( ar );
+    return 0;
+  }
+  return 1;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  int tmp_fd = mkstemp( tmp_path );
+  if( FD_UNLIKELY( tmp_fd==-1 ) ) FD_LOG_ERR(( "mkstemp(\"%s\") failed (%i-%s)", tmp_path, errno, fd_io_strerror( errno ) ));
+  FD_TEST( !close( tmp_fd ) );
+
+  ulong   cmem_sz = fd_zstd_cstream_footprint( FD_SHREDCAP_ARCHIVE_LEVEL_DEFAULT );
+  uchar * cmem    = aligned_alloc( fd_zstd_cstream_align(), fd_ulong_align_up( cmem_sz, fd_zstd_cstream_align() ) );
+  FD_TEST( cmem );
+  fd_zstd_cstream_t * cstream = fd_zstd_cstream_new( cmem, FD_SHREDCAP_ARCHIVE_LEVEL_DEFAULT );
+  FD_TEST( cstream );
+
+  ulong   dmem_sz = fd_zstd_dstream_footprint( FD_SHREDCAP_ARCHIVE_WINDOW_MAX );
+  uchar * dmem    = aligned_alloc( fd_zstd_dstream_align(), fd_ulong_align_up( dmem_sz, fd_zstd_dstream_align() ) );
+  FD_TEST( dmem );
+  fd_zstd_dstream_t * dstream = fd_zstd_dstream_new( dmem, FD_SHREDCAP_ARCHIVE_WINDOW_MAX );
+  FD_TEST( dstream );
+
+  ulong file_sz = make_archive( cstream );
+  write_file( file, file_sz );
+
+  /* Read it back */
+
+  fd_shredcap_archive_t ar[1];
+  FD_TEST( fd_shredcap_archive_open( ar, tmp_path )==ar );
+  FD_TEST( ar->row_cnt==ROW_CNT && ar->start_slot==START_SLOT && ar->end_slot==END_SLOT );
+
+  FD_TEST( fd_shredcap_archive_row( ar, START_SLOT-1UL )==ULONG_MAX );
+  FD_TEST( fd_shredcap_archive_row( ar, 12UL           )==ULONG_MAX );
+  FD_TEST( fd_shredcap_archive_row( ar, END_SLOT+1UL   )==ULONG_MAX );
+  FD_TEST( !fd_shredcap_archive_bank_hash( ar, 12UL ) );
+  FD_TEST( !fd_shredcap_archive_bank_hash( ar, 13UL ) );
+
+  uchar buf[ 4096 ];
+  for( ulong row=0UL; row<ROW_CNT; row++ ) {
+    ulong slot = row_slot[ row ];
+    FD_TEST( fd_shredcap_archive_row( ar, slot )==row );
+    FD_TEST( ar->parent_slot[ row ]==( row ? row_slot[ row-1UL ] : START_SLOT-1UL ) );
+    FD_TEST( ar->shred_cnt[ row ]==row_shred_cnt[ row ] );
+
+    fd_hash_t const * hash = fd_shredcap_archive_bank_hash( ar, slot );
+    if( slot!=13UL ) FD_TEST( hash && hash->uc[ 0 ]==(uchar)(0x40UL+row) );
+
+    FD_TEST( ar->block_dsz[ row ]==block_sz[ row ] );
+    FD_TEST( !fd_shredcap_archive_block_read( ar, row, dstream, buf ) );
+    FD_TEST( !memcmp( buf, block[ row ], block_sz[ row ] ) );
+  }
+  fd_shredcap_archive_close( ar );
+
+  /* A corrupt block is only detected when it is read */
+
+  fd_memcpy( copy, file, file_sz );
+  copy[ FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT ] ^= (uchar)0xff; /* zstd frame magic of row 0 */
+  write_file( copy, file_sz );
+  FD_TEST( fd_shredcap_archive_open( ar, tmp_path )==ar );
+  FD_TEST( fd_shredcap_archive_block_read( ar, 0UL, dstream, buf )==-1 );
+  FD_TEST( !fd_shredcap_archive_block_read( ar, 1UL, dstream, buf ) );
+  fd_shredcap_archive_close( ar );
+
+  /* Truncated files */
+
+  write_file( file, file_sz-1UL );
+  FD_TEST( !fd_shredcap_archive_open( ar, tmp_path ) );
+  write_file( file, file_sz/2UL );
+  FD_TEST( !fd_shredcap_archive_open( ar, tmp_path ) );
+  write_file( file, FD_SHREDCAP_ARCHIVE_HDR_FOOTPRINT );
+  FD_TEST( !fd_shredcap_archive_open( ar, tmp_path ) );
+
+  /* Corrupt footer */
+
+  ulong ftr_off = file_sz - FD_SHREDCAP_ARCHIVE_FTR_FOOTPRINT;
+  fd_shredcap_archive_ftr_t const * ftr = (fd_shredcap_archive_ftr_t const *)( file+ftr_off );
+#define FTR_FIELD( f ) (ftr_off + offsetof( fd_shredcap_archive_ftr_t, f ))
+
+  FD_TEST( !open_corrupt( file_sz, FTR_FIELD( magic ),   ftr->magic ) ); /* sanity check of open_corrupt */
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( magic  ),  0UL ) );
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( magic2 ),  0UL ) );
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( version ), FD_SHREDCAP_ARCHIVE_VERSION+1UL ) );
+  FD_TEST(  open_corrupt( file_sz, 8UL,                  FD_SHREDCAP_ARCHIVE_VERSION+1UL ) ); /* header version */
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( row_cnt ), 0UL ) );
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( row_cnt ), ROW_CNT-1UL ) );
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( row_cnt ), END_SLOT-START_SLOT+2UL ) );
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( end_slot ), START_SLOT-1UL ) );
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( end_slot ), ULONG_MAX ) );
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( slot_off ), ftr->slot_off+8UL ) );           /* misaligned */
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( slot_off ), 0UL ) );                         /* in the header */
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( row_off  ), ftr_off ) );                     /* in the footer */
+  FD_TEST(  open_corrupt( file_sz, FTR_FIELD( bank_hash_off ), ULONG_MAX-63UL ) );
+
+  /* Corrupt index columns */
+
+  FD_TEST(  open_corrupt( file_sz, ftr->slot_off+8UL,        row_slot[ 0 ] ) );            /* not sorted */
+  FD_TEST(  open_corrupt( file_sz, ftr->slot_off,            END_SLOT+1UL ) );             /* out of range */
+  FD_TEST(  open_corrupt( file_sz, ftr->block_off_off,       8UL ) );                      /* in the header */
+  FD_TEST(  open_corrupt( file_sz, ftr->block_off_off,       ftr_off+8UL ) );              /* past the index */
+  FD_TEST(  open_corrupt( file_sz, ftr->block_csz_off,       ftr_off ) );
+  FD_TEST(  open_corrupt( file_sz, ftr->block_dsz_off,       FD_SHREDCAP_ARCHIVE_BLOCK_MAX+1UL ) );
+  FD_TEST(  open_corrupt( file_sz, ftr->block_dsz_off,       0UL ) );                      /* smaller than the size column */
+  FD_TEST(  open_corrupt( file_sz, ftr->shred_cnt_off,       FD_SHREDCAP_ARCHIVE_SHRED_MAX+1UL ) );
+  FD_TEST(  open_corrupt( file_sz, ftr->row_off,             1UL ) );                      /* slot 10 maps to row 1 */
+  FD_TEST(  open_corrupt( file_sz, ftr->row_off+8UL,         (2UL<<32)|2UL ) );            /* slot 12 gains a row */
+
+#undef FTR_FIELD
+
+  FD_TEST( !unlink( tmp_path ) );
+  fd_zstd_dstream_delete( dstream );
+  free( dmem );
+  fd_zstd_cstream_delete( cstream );
+  free( cmem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -12,13 +12,225 @@
 #include <unistd.h>
 #include <zstd.h>
 
-static uchar             padding[ FD_SNAPSHOT_ACC_ALIGN ] = {0};
-static fd_account_meta_t default_meta = { .magic = FD_ACCOUNT_META_MAGIC };
+static uchar padding[ FD_SNAPSHOT_ACC_ALIGN ] = {0};
+
+/* fd_snapshot_create_rec_meta returns the account metadata of the
+   account record rec.  Tombstones don't have a value, so a default
+   metadata for them is populated into *tombstone and returned.  May
+   return NULL. */
+
+static inline fd_account_meta_t const *
+fd_snapshot_create_rec_meta( fd_funk_t *           funk,
+                             fd_funk_rec_t const * rec,
+                             fd_account_meta_t *   tombstone ) {
+  if( rec->flags & FD_FUNK_REC_FLAG_ERASE ) {
+    fd_memset( tombstone, 0, sizeof(fd_account_meta_t) );
+    tombstone->magic = FD_ACCOUNT_META_MAGIC;
+    tombstone->slot  = fd_funk_rec_get_erase_data( rec );
+    return tombstone;
+  }
+  return (fd_account_meta_t const *)fd_funk_val( rec, fd_funk_wksp( funk ) );
+}
+
+/* fd_snapshot_create_rec_class determines where an account record with
+   metadata meta is written out to in the snapshot. */
+
+#define FD_SNAPSHOT_CREATE_REC_SKIP (0) /* not included in the snapshot */
+#define FD_SNAPSHOT_CREATE_REC_PREV (1) /* included in an append vec for a slot before the snapshot slot */
+#define FD_SNAPSHOT_CREATE_REC_CURR (2) /* included in the append vec for the snapshot slot */
+
+static inline int
+fd_snapshot_create_rec_class( fd_snapshot_ctx_t const * snapshot_ctx,
+                              fd_funk_rec_t const *     rec,
+                              fd_account_meta_t const * meta ) {
+
+  if( !meta || meta->magic!=FD_ACCOUNT_META_MAGIC ) {
+    return FD_SNAPSHOT_CREATE_REC_SKIP;
+  }
+
+  /* Don't include accounts that were touched before the last full
+     snapshot. */
+
+  if( snapshot_ctx->is_incremental && meta->slot<=snapshot_ctx->last_snap_slot ) {
+    return FD_SNAPSHOT_CREATE_REC_SKIP;
+  }
+
+  /* All accounts that were touched in the snapshot slot should be in
+     a different append vec so that Agave can calculate the snapshot
+     slot's bank hash. */
+
+  if( meta->slot==snapshot_ctx->slot ) {
+    return FD_SNAPSHOT_CREATE_REC_CURR;
+  }
+
+  /* Tombstones are not included in full snapshots. */
+
+  if( !snapshot_ctx->is_incremental && (rec->flags & FD_FUNK_REC_FLAG_ERASE) ) {
+    return FD_SNAPSHOT_CREATE_REC_SKIP;
+  }
+
+  return FD_SNAPSHOT_CREATE_REC_PREV;
+}
+
+/* fd_snapshot_create_acc_hdr populates the append vec header for the
+   account with the given pubkey and metadata. */
+
+static inline void
+fd_snapshot_create_acc_hdr( fd_solana_account_hdr_t * header,
+                            fd_pubkey_t const *       pubkey,
+                            fd_account_meta_t const * metadata ) {
+  fd_memset( header, 0, sizeof(fd_solana_account_hdr_t) );
+  /* Stored meta */
+  header->meta.write_version_obsolete = 0UL;
+  header->meta.data_len               = metadata->dlen;
+  fd_memcpy( header->meta.pubkey, pubkey, sizeof(fd_pubkey_t) );
+  /* Account Meta */
+  header->info.lamports               = metadata->info.lamports;
+  header->info.rent_epoch             = header->info.lamports ? metadata->info.rent_epoch : 0UL;
+  fd_memcpy( header->info.owner, metadata->info.owner, sizeof(fd_pubkey_t) );
+  header->info.executable             = metadata->info.executable;
+  /* Hash */
+  fd_memcpy( &header->hash, metadata->hash, sizeof(fd_hash_t) );
+}
+
+/* fd_snapshot_create_grow doubles the capacity of a dynamically sized
+   array of *bound elements of elem_sz bytes, cnt of which are in use.
+   Returns the new array. */
+
+static void *
+fd_snapshot_create_grow( fd_valloc_t valloc,
+                         void *      arr,
+                         ulong       align,
+                         ulong       elem_sz,
+                         ulong       cnt,
+                         ulong *     bound ) {
+  *bound *= 2UL;
+  void * new_arr = fd_valloc_malloc( valloc, align, elem_sz * *bound );
+  if( FD_UNLIKELY( !new_arr ) ) {
+    FD_LOG_ERR(( "Unable to grow array to %lu elements", *bound ));
+  }
+  fd_memcpy( new_arr, arr, elem_sz * cnt );
+  fd_valloc_free( valloc, arr );
+  return new_arr;
+}
+
+/* fd_snapshot_create_pwrite writes out data_sz bytes of data at file
+   offset off, retrying on short writes. */
+
+static void
+fd_snapshot_create_pwrite( int          fd,
+                           void const * data,
+                           ulong        data_sz,
+                           ulong        off ) {
+  while( data_sz ) {
+    long wsz = pwrite( fd, data, data_sz, (long)off );
+    if( FD_UNLIKELY( wsz<=0L ) ) {
+      if( FD_LIKELY( wsz<0L && errno==EINTR ) ) continue;
+      FD_LOG_ERR(( "Failed to write out account data at offset %lu (%i-%s)", off, errno, fd_io_strerror( errno ) ));
+    }
+    data     = (uchar const *)data + wsz;
+    data_sz -= (ulong)wsz;
+    off     += (ulong)wsz;
+  }
+}
+
+/* fd_snapshot_create_acc_vec_t describes an append vec for a slot
+   before the snapshot slot.  Records are assigned to append vecs in
+   root transaction order, so the append vec holds the rec_cnt records
+   of class FD_SNAPSHOT_CREATE_REC_PREV starting at rec0.  The layout of
+   the tar archive is known once all append vecs are sized, so each
+   append vec can be written out independently at data_off. */
+
+struct fd_snapshot_create_acc_vec {
+  fd_funk_rec_t const * rec0;
+  ulong                 rec_cnt;
+  ulong                 file_sz;
+  ulong                 data_off;
+};
+typedef struct fd_snapshot_create_acc_vec fd_snapshot_create_acc_vec_t;
+
+struct fd_snapshot_create_acc_vec_task_info {
+  fd_snapshot_ctx_t const *            snapshot_ctx;
+  fd_funk_t *                          funk;
+  fd_snapshot_create_acc_vec_t const * acc_vecs;
+  int                                  fd;
+  uchar *                              bufs; /* FD_SNAPSHOT_ACC_VEC_BUF_SZ bytes per worker */
+};
+typedef struct fd_snapshot_create_acc_vec_task_info fd_snapshot_create_acc_vec_task_info_t;
+
+static void
+fd_snapshot_create_write_acc_vec( fd_snapshot_create_acc_vec_task_info_t const * info,
+                                  fd_snapshot_create_acc_vec_t const *           acc_vec,
+                                  uchar *                                        buf ) {
+
+  fd_funk_t * funk    = info->funk;
+  ulong       off     = acc_vec->data_off;
+  ulong       buf_cnt = 0UL;
+  ulong       rem     = acc_vec->rec_cnt;
+
+  for( fd_funk_rec_t const * rec = acc_vec->rec0; rem; rec = fd_funk_txn_next_rec( funk, rec ) ) {
+
+    if( FD_UNLIKELY( !rec ) ) {
+      FD_LOG_ERR(( "Ran out of records while writing out an append vec" ));
+    }
+
+    if( !fd_funk_key_is_acc( rec->pair.key ) ) {
+      continue;
+    }
+
+    fd_account_meta_t         tombstone[1];
+    fd_account_meta_t const * metadata = fd_snapshot_create_rec_meta( funk, rec, tombstone );
+    if( fd_snapshot_create_rec_class( info->snapshot_ctx, rec, metadata )!=FD_SNAPSHOT_CREATE_REC_PREV ) {
+      continue;
+    }
+    rem--;
+
+    /* Stage the header, the data and the padding in the buffer, writing
+       out accounts that don't fit in the buffer directly. */
+
+    ulong align_sz = fd_ulong_align_up( metadata->dlen, FD_SNAPSHOT_ACC_ALIGN ) - metadata->dlen;
+    ulong rec_sz   = sizeof(fd_solana_account_hdr_t) + metadata->dlen + align_sz;
+    if( buf_cnt+rec_sz>FD_SNAPSHOT_ACC_VEC_BUF_SZ ) {
+      fd_snapshot_create_pwrite( info->fd, buf, buf_cnt, off );
+      off     += buf_cnt;
+      buf_cnt  = 0UL;
+    }
+
+    uchar const * acc_data = (uchar const *)metadata + metadata->hlen;
 
-static inline fd_account_meta_t *
-fd_snapshot_create_get_default_meta( ulong slot ) {
-  default_meta.slot = slot;
-  return &default_meta;
+    if( FD_UNLIKELY( rec_sz>FD_SNAPSHOT_ACC_VEC_BUF_SZ ) ) {
+      fd_solana_account_hdr_t header[1];
+      fd_snapshot_create_acc_hdr( header, fd_type_pun_const( rec->pair.key[0].uc ), metadata );
+      fd_snapshot_create_pwrite( info->fd, header,   sizeof(fd_solana_account_hdr_t), off ); off += sizeof(fd_solana_account_hdr_t);
+      fd_snapshot_create_pwrite( info->fd, acc_data, metadata->dlen,                  off ); off += metadata->dlen;
+      fd_snapshot_create_pwrite( info->fd, padding,  align_sz,                        off ); off += align_sz;
+      continue;
+    }
+
+    fd_snapshot_create_acc_hdr( (fd_solana_account_hdr_t *)(buf+buf_cnt), fd_type_pun_const( rec->pair.key[0].uc ), metadata );
+    buf_cnt += sizeof(fd_solana_account_hdr_t);
+    fd_memcpy( buf+buf_cnt, acc_data, metadata->dlen ); buf_cnt += metadata->dlen;
+    fd_memset( buf+buf_cnt, 0,        align_sz       ); buf_cnt += align_sz;
+  }
+
+  fd_snapshot_create_pwrite( info->fd, buf, buf_cnt, off );
+  off += buf_cnt;
+
+  if( FD_UNLIKELY( off!=acc_vec->data_off+acc_vec->file_sz ) ) {
+    FD_LOG_ERR(( "Append vec size mismatch (expected %lu bytes, wrote %lu bytes)", acc_vec->file_sz, off-acc_vec->data_off ));
+  }
+}
+
+static void
+fd_snapshot_create_write_acc_vec_task( void * tpool,
+                                       ulong  t0 FD_PARAM_UNUSED,      ulong t1 FD_PARAM_UNUSED,
+                                       void * args FD_PARAM_UNUSED,
+                                       void * reduce FD_PARAM_UNUSED,  ulong stride FD_PARAM_UNUSED,
+                                       ulong  l0 FD_PARAM_UNUSED,      ulong l1 FD_PARAM_UNUSED,
+                                       ulong  m0,                      ulong m1 FD_PARAM_UNUSED,
+                                       ulong  n0,                      ulong n1 FD_PARAM_UNUSED ) {
+  fd_snapshot_create_acc_vec_task_info_t const * info = (fd_snapshot_create_acc_vec_task_info_t const *)tpool;
+  fd_snapshot_create_write_acc_vec( info, info->acc_vecs + m0, info->bufs + n0*FD_SNAPSHOT_ACC_VEC_BUF_SZ );
 }
 
 static inline void
@@ -53,89 +265,107 @@ fd_snapshot_create_populate_acc_vecs( fd_snapshot_ctx_t                 * snapsh
   /* We will dynamically resize the number of incremental keys because the upper
      bound will be roughly 8 bytes * writable accs in a slot * number of slots
      since the last full snapshot which can quickly grow to be severalgigabytes
-     or more. In the normal case, this won't require dynamic resizing. */
+     or more. In the normal case, this won't require dynamic resizing.  The
+     tombstones and the append vec descriptors are sized the same way. */
   #define FD_INCREMENTAL_KEY_INIT_BOUND (100000UL)
+  #define FD_TOMBSTONE_INIT_BOUND       (100000UL)
+  #define FD_ACC_VEC_INIT_BOUND         (64UL)
   ulong                       incremental_key_bound = FD_INCREMENTAL_KEY_INIT_BOUND;
   ulong                       incremental_key_cnt   = 0UL;
   fd_funk_rec_key_t const * * incremental_keys      = snapshot_ctx->is_incremental ? 
                                                       fd_valloc_malloc( snapshot_ctx->valloc, alignof(fd_funk_rec_key_t*), sizeof(fd_funk_rec_key_t*) * incremental_key_bound ) :
                                                       NULL;
 
+  ulong             tombstones_bound = FD_TOMBSTONE_INIT_BOUND;
+  ulong             tombstones_cnt   = 0UL;
+  fd_funk_rec_t * * tombstones       = snapshot_ctx->is_incremental ? NULL :
+                                       fd_valloc_malloc( snapshot_ctx->valloc, alignof(fd_funk_rec_t*), sizeof(fd_funk_rec_t*) * tombstones_bound );
+
+  ulong                          acc_vec_bound = FD_ACC_VEC_INIT_BOUND;
+  ulong                          acc_vec_cnt   = 0UL;
+  fd_snapshot_create_acc_vec_t * acc_vecs      = fd_valloc_malloc( snapshot_ctx->valloc, alignof(fd_snapshot_create_acc_vec_t), sizeof(fd_snapshot_create_acc_vec_t) * acc_vec_bound );
+
   #undef FD_INCREMENTAL_KEY_INIT_BOUND
+  #undef FD_TOMBSTONE_INIT_BOUND
+  #undef FD_ACC_VEC_INIT_BOUND
 
   /* In order to size out the accounts DB index in the manifest, we must
      iterate through funk and accumulate the size of all of the records
-     from all slots before the snapshot_slot. */
+     from all slots before the snapshot_slot.  These are packed into
+     append vecs in iteration order, each filled up to the protocol
+     defined maximum size.  This only reads the account metadata, the
+     account data is copied out later on by the tpool workers. */
 
-  fd_funk_t * funk           = snapshot_ctx->acc_mgr->funk;
-  ulong       prev_sz        = 0UL;
-  ulong       tombstones_cnt = 0UL;
+  fd_funk_t * funk = snapshot_ctx->acc_mgr->funk;
   for( fd_funk_rec_t const * rec = fd_funk_txn_first_rec( funk, NULL ); NULL != rec; rec = fd_funk_txn_next_rec( funk, rec ) ) {
 
     if( !fd_funk_key_is_acc( rec->pair.key ) ) {
       continue;
     }
 
-    tombstones_cnt++;
-
-    int                 is_tombstone = rec->flags & FD_FUNK_REC_FLAG_ERASE;                     
-    uchar const *       raw          = fd_funk_val( rec, fd_funk_wksp( funk ) );
-    fd_account_meta_t * metadata     = is_tombstone ? fd_snapshot_create_get_default_meta( fd_funk_rec_get_erase_data( rec ) ) : 
-                                                      (fd_account_meta_t*)raw;
-
-    if( !metadata ) {
-      continue;
+    if( !snapshot_ctx->is_incremental && (rec->flags & FD_FUNK_REC_FLAG_ERASE) ) {
+      /* If we are in a full snapshot, we need to gather all of the accounts
+         that we plan on deleting. */
+      if( FD_UNLIKELY( tombstones_cnt==tombstones_bound ) ) {
+        tombstones = fd_snapshot_create_grow( snapshot_ctx->valloc, tombstones, alignof(fd_funk_rec_t*), sizeof(fd_funk_rec_t*),
+                                              tombstones_cnt, &tombstones_bound );
+      }
+      tombstones[ tombstones_cnt++ ] = (fd_funk_rec_t*)rec;
     }
 
-    if( metadata->magic!=FD_ACCOUNT_META_MAGIC ) {
+    fd_account_meta_t         tombstone[1];
+    fd_account_meta_t const * metadata  = fd_snapshot_create_rec_meta( funk, rec, tombstone );
+    int                       rec_class = fd_snapshot_create_rec_class( snapshot_ctx, rec, metadata );
+
+    if( rec_class==FD_SNAPSHOT_CREATE_REC_SKIP ) {
       continue;
     }
 
     if( snapshot_ctx->is_incremental ) {
-      /* We only care about accounts that were modified since the last
-         snapshot slot for incremental snapshots. 
-         
-         We also need to keep track of the capitalization for all of the
+      /* We also need to keep track of the capitalization for all of the
          accounts that are in the incremental as this is verified. */
-      if( metadata->slot<=snapshot_ctx->last_snap_slot ) {
-        continue;
+      if( FD_UNLIKELY( incremental_key_cnt==incremental_key_bound ) ) {
+        incremental_keys = fd_snapshot_create_grow( snapshot_ctx->valloc, incremental_keys, alignof(fd_funk_rec_key_t*), sizeof(fd_funk_rec_key_t*),
+                                                    incremental_key_cnt, &incremental_key_bound );
       }
       incremental_keys[ incremental_key_cnt++ ] = rec->pair.key;
       *out_cap += metadata->info.lamports;
-
-      if( FD_UNLIKELY( incremental_key_cnt==incremental_key_bound ) ) {
-        /* Dynamically resize if needed. */
-        incremental_key_bound *= 2UL;
-        fd_funk_rec_key_t const * * new_incremental_keys = fd_valloc_malloc( snapshot_ctx->valloc, 
-                                                                             alignof(fd_funk_rec_key_t*),
-                                                                             sizeof(fd_funk_rec_key_t*) * incremental_key_bound );
-        fd_memcpy( new_incremental_keys, incremental_keys, sizeof(fd_funk_rec_key_t*) * incremental_key_cnt );
-        fd_valloc_free( snapshot_ctx->valloc, incremental_keys );
-        incremental_keys = new_incremental_keys;
-      }
     }
 
     /* We know that all of the accounts from the snapshot slot can fit into
-       one append vec, so we ignore all accounts from the snapshot slot. */
+       one append vec, so we just record their pubkeys. */
 
-    if( metadata->slot==snapshot_ctx->slot ) {
+    if( rec_class==FD_SNAPSHOT_CREATE_REC_CURR ) {
+      if( FD_UNLIKELY( snapshot_slot_key_cnt==FD_WRITABLE_ACCS_IN_SLOT ) ) {
+        FD_LOG_ERR(( "Too many accounts were modified in the snapshot slot" ));
+      }
+      snapshot_slot_keys[ snapshot_slot_key_cnt++ ] = (fd_pubkey_t*)fd_type_pun_const( rec->pair.key[0].uc );
       continue;
     }
 
-    prev_sz += metadata->dlen + sizeof(fd_solana_account_hdr_t);
+    ulong rec_sz = sizeof(fd_solana_account_hdr_t) + fd_ulong_align_up( metadata->dlen, FD_SNAPSHOT_ACC_ALIGN );
+
+    if( !acc_vec_cnt || acc_vecs[ acc_vec_cnt-1UL ].file_sz + rec_sz>FD_SNAPSHOT_APPEND_VEC_SZ_MAX ) {
+      if( FD_UNLIKELY( acc_vec_cnt==acc_vec_bound ) ) {
+        acc_vecs = fd_snapshot_create_grow( snapshot_ctx->valloc, acc_vecs, alignof(fd_snapshot_create_acc_vec_t), sizeof(fd_snapshot_create_acc_vec_t),
+                                            acc_vec_cnt, &acc_vec_bound );
+      }
+      acc_vecs[ acc_vec_cnt++ ] = (fd_snapshot_create_acc_vec_t){ .rec0 = rec, .rec_cnt = 0UL, .file_sz = 0UL, .data_off = 0UL };
+    }
+
+    acc_vecs[ acc_vec_cnt-1UL ].rec_cnt += 1UL;
+    acc_vecs[ acc_vec_cnt-1UL ].file_sz += rec_sz;
 
   }
 
   /* At this point we have sized out all of the relevant accounts that will 
-     be included in the snapshot. Now we must populate each of the append vecs
-     and update the index as we go.
+     be included in the snapshot. Now we must populate the index.
   
-     When we account for the number of slots we need to consider one append vec
-     for the snapshot slot and try to maximally fill up the others: an append
-     vec has a protocol-defined maximum size in Agave.  */
+     We need one append vec for the snapshot slot and one for each of the
+     append vecs that the other accounts were packed into: an append vec
+     has a protocol-defined maximum size in Agave.  */
 
-  ulong num_slots = 1UL + prev_sz / FD_SNAPSHOT_APPEND_VEC_SZ_MAX + 
-                    (prev_sz % FD_SNAPSHOT_APPEND_VEC_SZ_MAX ? 1UL : 0UL);
+  ulong num_slots = 1UL + acc_vec_cnt;
 
   fd_solana_accounts_db_fields_t * accounts_db = &manifest->accounts_db;
 
@@ -160,7 +390,7 @@ fd_snapshot_create_populate_acc_vecs( fd_snapshot_ctx_t                 * snapsh
     accounts_db->storages[ i ].account_vecs              = fd_valloc_malloc( snapshot_ctx->valloc,
                                                                              FD_SNAPSHOT_ACC_VEC_ALIGN,
                                                                              sizeof(fd_snapshot_acc_vec_t) * accounts_db->storages[ i ].account_vecs_len );
-    accounts_db->storages[ i ].account_vecs[ 0 ].file_sz = 0UL;
+    accounts_db->storages[ i ].account_vecs[ 0 ].file_sz = i ? acc_vecs[ i-1UL ].file_sz : 0UL;
     accounts_db->storages[ i ].account_vecs[ 0 ].id      = i + 1UL;
     accounts_db->storages[ i ].slot                      = snapshot_ctx->slot - i;
   }
@@ -257,144 +487,23 @@ fd_snapshot_create_populate_acc_vecs( fd_snapshot_ctx_t                 * snapsh
   }
 
   /* We have made space for the manifest and are ready to append the append
-     vec files directly into the tar archive. We will iterate through all of
-     the records in the funk root and create/populate an append vec for 
-     previous slots. Just record the pubkeys for the latest slot to populate 
-     the append vec after. If the append vec is full, write into the next one. */
-
-  ulong curr_slot = 1UL;
-  fd_snapshot_acc_vec_t * prev_accs = &accounts_db->storages[ curr_slot ].account_vecs[ 0UL ];
-
-  err = snprintf( buffer, FD_SNAPSHOT_DIR_MAX, "accounts/%lu.%lu", snapshot_ctx->slot - curr_slot, prev_accs->id );
-  if( FD_UNLIKELY( err<0 ) ) {
-    FD_LOG_ERR(( "Unable to format previous accounts name string" ));
-  }
+     vec files into the tar archive.  The append vecs for previous slots
+     are sized, so reserve space for each of them in the archive: their
+     contents are independent of each other and are written out in
+     parallel below. */
 
-  err = fd_tar_writer_new_file( writer, buffer );
-  if( FD_UNLIKELY( err ) ) {
-    FD_LOG_ERR(( "Unable to create previous accounts file" ));
-  }
-
-  fd_funk_rec_t * * tombstones = snapshot_ctx->is_incremental ? NULL : 
-                                 fd_valloc_malloc( snapshot_ctx->valloc, alignof(fd_funk_rec_t*), sizeof(fd_funk_rec_t*) * tombstones_cnt );
-  tombstones_cnt = 0UL;
-
-  for( fd_funk_rec_t const * rec = fd_funk_txn_first_rec( funk, NULL ); NULL != rec; rec = fd_funk_txn_next_rec( funk, rec ) ) {
+  for( ulong i=0UL; i<acc_vec_cnt; i++ ) {
+    fd_snapshot_acc_vec_t * prev_accs = &accounts_db->storages[ i+1UL ].account_vecs[ 0UL ];
 
-    /* Get the account data. */
-
-    if( !fd_funk_key_is_acc( rec->pair.key ) ) {
-      continue;
-    }
-
-    fd_pubkey_t const * pubkey       = fd_type_pun_const( rec->pair.key[0].uc );
-    int                 is_tombstone = rec->flags & FD_FUNK_REC_FLAG_ERASE;                     
-    uchar const *       raw          = fd_funk_val( rec, fd_funk_wksp( funk ) );
-    fd_account_meta_t * metadata     = is_tombstone ? fd_snapshot_create_get_default_meta( fd_funk_rec_get_erase_data( rec ) ) : 
-                                                      (fd_account_meta_t*)raw;
-
-    if( !snapshot_ctx->is_incremental && is_tombstone ) {
-      /* If we are in a full snapshot, we need to gather all of the accounts
-         that we plan on deleting. */
-      tombstones[ tombstones_cnt++ ] = (fd_funk_rec_t*)rec;
-    }
-
-    if( !metadata ) {
-      continue;
+    err = snprintf( buffer, FD_SNAPSHOT_DIR_MAX, "accounts/%lu.%lu", snapshot_ctx->slot - (i+1UL), prev_accs->id );
+    if( FD_UNLIKELY( err<0 ) ) {
+      FD_LOG_ERR(( "Unable to format previous accounts name string" ));
     }
 
-    if( metadata->magic!=FD_ACCOUNT_META_MAGIC ) {
-      continue;
-    } 
-
-    /* Don't iterate through accounts that were touched before the last full
-       snapshot. */
-    if( snapshot_ctx->is_incremental && metadata->slot<=snapshot_ctx->last_snap_slot ) {
-      continue;
-    }
-
-    uchar const * acc_data = raw + metadata->hlen;
-
-    /* All accounts that were touched in the snapshot slot should be in 
-       a different append vec so that Agave can calculate the snapshot slot's
-       bank hash. We don't want to include them in an arbitrary append vec. */
-
-    if( metadata->slot==snapshot_ctx->slot ) {
-      snapshot_slot_keys[ snapshot_slot_key_cnt++ ] = (fd_pubkey_t*)pubkey;
-      continue;
-    }
-
-    /* We don't want to iterate over tombstones if the snapshot is not
-       incremental */
-    if( !snapshot_ctx->is_incremental && is_tombstone ) {
-      continue;
-    }
-
-    ulong new_sz = prev_accs->file_sz + sizeof(fd_solana_account_hdr_t) + fd_ulong_align_up( metadata->dlen, FD_SNAPSHOT_ACC_ALIGN );
-
-    if( new_sz>FD_SNAPSHOT_APPEND_VEC_SZ_MAX ) {
-
-      /* When the current append vec is full, finish writing it, start writing 
-         into the next append vec. */
-
-      err = fd_tar_writer_fini_file( writer );
-      if( FD_UNLIKELY( err ) ) {
-        FD_LOG_ERR(( "Unable to finalize previous accounts file" ));
-      }
-
-      prev_accs = &accounts_db->storages[ ++curr_slot ].account_vecs[ 0UL ];
-
-      err = snprintf( buffer, FD_SNAPSHOT_DIR_MAX, "accounts/%lu.%lu", snapshot_ctx->slot - curr_slot, prev_accs->id );
-      if( FD_UNLIKELY( err<0 ) ) {
-        FD_LOG_ERR(( "Unable to format previous accounts name string" ));
-      }
-
-      err = fd_tar_writer_new_file( writer, buffer );
-      if( FD_UNLIKELY( err ) ) {
-        FD_LOG_ERR(( "Unable to create previous accounts file" ));
-      }
-    }
-
-    prev_accs->file_sz += sizeof(fd_solana_account_hdr_t) + fd_ulong_align_up( metadata->dlen, FD_SNAPSHOT_ACC_ALIGN );
-
-
-    /* Write out the header. */
-
-    fd_solana_account_hdr_t header = {0};
-    /* Stored meta */
-    header.meta.write_version_obsolete = 0UL;
-    header.meta.data_len               = metadata->dlen;
-    fd_memcpy( header.meta.pubkey, pubkey, sizeof(fd_pubkey_t) );
-    /* Account Meta */
-    header.info.lamports               = metadata->info.lamports;
-    header.info.rent_epoch             = header.info.lamports ? metadata->info.rent_epoch : 0UL;
-    fd_memcpy( header.info.owner, metadata->info.owner, sizeof(fd_pubkey_t) );
-    header.info.executable             = metadata->info.executable;
-    /* Hash */
-    fd_memcpy( &header.hash, metadata->hash, sizeof(fd_hash_t) );
-
-    err = fd_tar_writer_write_file_data( writer, &header, sizeof(fd_solana_account_hdr_t) );
+    err = fd_tar_writer_reserve_file( writer, buffer, prev_accs->file_sz, &acc_vecs[ i ].data_off );
     if( FD_UNLIKELY( err ) ) {
-      FD_LOG_ERR(( "Unable to stream out account header to tar archive" ));
+      FD_LOG_ERR(( "Unable to reserve previous accounts file" ));
     }
-
-    /* Write out the file data. */
-
-    err = fd_tar_writer_write_file_data( writer, acc_data, metadata->dlen );
-    if( FD_UNLIKELY( err ) ) {
-      FD_LOG_ERR(( "Unable to stream out account data to tar archive" ));
-    }
-
-    ulong align_sz = fd_ulong_align_up( metadata->dlen, FD_SNAPSHOT_ACC_ALIGN ) - metadata->dlen;
-    err = fd_tar_writer_write_file_data( writer, padding, align_sz );
-    if( FD_UNLIKELY( err ) ) {
-      FD_LOG_ERR( ("Unable to stream out account padding to tar archive" ));
-    }
-  }
-
-  err = fd_tar_writer_fini_file( writer );
-  if( FD_UNLIKELY( err ) ) {
-    FD_LOG_ERR(( "Unable to finalize previous accounts file" ));
   }
 
   /* Now write out the append vec for the snapshot slot. Again, this is needed
@@ -422,10 +531,8 @@ fd_snapshot_create_populate_acc_vecs( fd_snapshot_ctx_t                 * snapsh
       FD_LOG_ERR(( "Previously found record can no longer be found" ));
     }
 
-    int                 is_tombstone = rec->flags & FD_FUNK_REC_FLAG_ERASE;
-    uchar       const * raw          = fd_funk_val( rec, fd_funk_wksp( funk ) );
-    fd_account_meta_t * metadata     = is_tombstone ? fd_snapshot_create_get_default_meta( fd_funk_rec_get_erase_data( rec ) ) : 
-                                                      (fd_account_meta_t*)raw;
+    fd_account_meta_t         tombstone[1];
+    fd_account_meta_t const * metadata = fd_snapshot_create_rec_meta( funk, rec, tombstone );
 
     if( FD_UNLIKELY( !metadata ) ) {
       FD_LOG_ERR(( "Record should have non-NULL metadata" ));
@@ -435,26 +542,15 @@ fd_snapshot_create_populate_acc_vecs( fd_snapshot_ctx_t                 * snapsh
       FD_LOG_ERR(( "Record should have valid magic" ));
     }
 
-    uchar const * acc_data = raw + metadata->hlen;
+    uchar const * acc_data = (uchar const *)metadata + metadata->hlen;
 
     curr_accs->file_sz += sizeof(fd_solana_account_hdr_t) + fd_ulong_align_up( metadata->dlen, FD_SNAPSHOT_ACC_ALIGN );
 
     /* Write out the header. */
-    fd_solana_account_hdr_t header = {0};
-    /* Stored meta */
-    header.meta.write_version_obsolete = 0UL;
-    header.meta.data_len               = metadata->dlen;
-    fd_memcpy( header.meta.pubkey, pubkey, sizeof(fd_pubkey_t) );
-    /* Account Meta */
-    header.info.lamports               = metadata->info.lamports;
-    header.info.rent_epoch             = header.info.lamports ? metadata->info.rent_epoch : 0UL;
-    fd_memcpy( header.info.owner, metadata->info.owner, sizeof(fd_pubkey_t) );
-    header.info.executable             = metadata->info.executable;
-    /* Hash */
-    fd_memcpy( &header.hash, metadata->hash, sizeof(fd_hash_t) );
-
-
-    err = fd_tar_writer_write_file_data( writer, &header, sizeof(fd_solana_account_hdr_t) );
+    fd_solana_account_hdr_t header[1];
+    fd_snapshot_create_acc_hdr( header, pubkey, metadata );
+
+    err = fd_tar_writer_write_file_data( writer, header, sizeof(fd_solana_account_hdr_t) );
     if( FD_UNLIKELY( err ) ) {
       FD_LOG_ERR(( "Unable to stream out account header to tar archive" ));
     }
@@ -474,6 +570,34 @@ fd_snapshot_create_populate_acc_vecs( fd_snapshot_ctx_t                 * snapsh
     FD_LOG_ERR(( "Unable to finish writing out file" ));
   }
 
+  /* Copy the accounts into the reserved append vec files.  Each tpool
+     worker writes out whole append vecs with positioned writes through
+     its own staging buffer. */
+
+  ulong worker_cnt = snapshot_ctx->tpool ? fd_tpool_worker_cnt( snapshot_ctx->tpool ) : 1UL;
+
+  fd_snapshot_create_acc_vec_task_info_t task_info = {
+    .snapshot_ctx = snapshot_ctx,
+    .funk         = funk,
+    .acc_vecs     = acc_vecs,
+    .fd           = snapshot_ctx->tmp_fd,
+    .bufs         = fd_valloc_malloc( snapshot_ctx->valloc, FD_SNAPSHOT_ACC_ALIGN, worker_cnt * FD_SNAPSHOT_ACC_VEC_BUF_SZ )
+  };
+  if( FD_UNLIKELY( !task_info.bufs ) ) {
+    FD_LOG_ERR(( "Unable to allocate append vec write buffers" ));
+  }
+
+  FD_LOG_NOTICE(( "Writing out %lu append vecs with %lu workers", acc_vec_cnt, worker_cnt ));
+
+  if( worker_cnt>1UL ) {
+    fd_tpool_exec_all_rrobin( snapshot_ctx->tpool, 0UL, worker_cnt, fd_snapshot_create_write_acc_vec_task, &task_info,
+                              NULL, NULL, 1UL, 0UL, acc_vec_cnt );
+  } else {
+    for( ulong i=0UL; i<acc_vec_cnt; i++ ) {
+      fd_snapshot_create_write_acc_vec( &task_info, &acc_vecs[ i ], task_info.bufs );
+    }
+  }
+
   /* TODO: At this point we must implement compaction to the snapshot service. 
      Without this, we are actually not cleaning up any tombstones from funk. */
 
@@ -487,6 +611,8 @@ fd_snapshot_create_populate_acc_vecs( fd_snapshot_ctx_t                 * snapsh
     fd_funk_end_write( funk );
   }
 
+  fd_valloc_free( snapshot_ctx->valloc, task_info.bufs );
+  fd_valloc_free( snapshot_ctx->valloc, acc_vecs );
   fd_valloc_free( snapshot_ctx->valloc, snapshot_slot_keys );
   fd_valloc_free( snapshot_ctx->valloc, tombstones );
 
@@ -989,45 +1115,145 @@ fd_snapshot_create_write_manifest_and_acc_vecs( fd_snapshot_ctx_t * snapshot_ctx
 
 }
 
+/* fd_snapshot_create_frame_t holds the state used to compress one frame
+   of the snapshot.  Each frame is an independent zstd frame, so the
+   concatenation of all frames is a valid zstd stream that can also be
+   decompressed in parallel by a reader that splits it at frame
+   boundaries. */
+
+struct fd_snapshot_create_frame {
+  fd_zstd_cstream_t * cstream;
+  uchar *             in_buf;
+  uchar *             out_buf;
+  ulong               out_sz;
+};
+typedef struct fd_snapshot_create_frame fd_snapshot_create_frame_t;
+
+struct fd_snapshot_create_compress_task_info {
+  int                          tmp_fd;
+  ulong                        tar_sz;
+  ulong                        frame0;     /* Index of the first frame in this batch */
+  fd_snapshot_create_frame_t * frames;     /* Indexed by frame index - frame0 */
+  ulong                        in_buf_sz;
+  ulong                        out_buf_sz;
+};
+typedef struct fd_snapshot_create_compress_task_info fd_snapshot_create_compress_task_info_t;
+
+static void
+fd_snapshot_create_compress_frame( fd_snapshot_create_compress_task_info_t const * info,
+                                   ulong                                           frame_idx ) {
+
+  fd_snapshot_create_frame_t * frame = info->frames + (frame_idx - info->frame0);
+
+  ulong in_off = frame_idx * FD_SNAPSHOT_ZSTD_FRAME_SZ;
+  ulong in_end = fd_ulong_min( in_off + FD_SNAPSHOT_ZSTD_FRAME_SZ, info->tar_sz );
+
+  /* Record the frame size in the frame header so that readers can size
+     their buffers up front. */
+
+  if( FD_UNLIKELY( fd_zstd_cstream_reset( frame->cstream, in_end - in_off ) ) ) {
+    FD_LOG_ERR(( "Unable to set the zstd frame size" ));
+  }
+
+  /* The output buffer is sized to the worst case compressed size of a
+     frame, so the frame can always be compressed in one go. */
+
+  uchar *       out     = frame->out_buf;
+  uchar * const out_end = frame->out_buf + info->out_buf_sz;
+
+  while( in_off<in_end ) {
+
+    ulong in_sz = fd_ulong_min( info->in_buf_sz, in_end - in_off );
+    ulong rd_sz = 0UL;
+    while( rd_sz<in_sz ) {
+      long sz = pread( info->tmp_fd, frame->in_buf + rd_sz, in_sz - rd_sz, (long)(in_off + rd_sz) );
+      if( FD_UNLIKELY( sz<=0L ) ) {
+        if( FD_LIKELY( sz<0L && errno==EINTR ) ) continue;
+        FD_LOG_ERR(( "Failed to read in the file at offset %lu (%i-%s)", in_off + rd_sz, errno, fd_io_strerror( errno ) ));
+      }
+      rd_sz += (ulong)sz;
+    }
+    in_off += in_sz;
+
+    int           end    = in_off==in_end;
+    uchar const * in     = frame->in_buf;
+    uchar const * in_lim = frame->in_buf + in_sz;
+    for(;;) {
+      int res = fd_zstd_cstream_write( frame->cstream, &in, in_lim, &out, out_end, end, NULL );
+      if( FD_UNLIKELY( res>0 ) ) {
+        FD_LOG_ERR(( "Compression error (%i)", res ));
+      }
+      if( end ? res==-1 : in==in_lim ) break;
+      if( FD_UNLIKELY( out==out_end ) ) {
+        FD_LOG_ERR(( "Compressed frame exceeds the output buffer" ));
+      }
+    }
+  }
+
+  frame->out_sz = (ulong)( out - frame->out_buf );
+}
+
+static void
+fd_snapshot_create_compress_task( void * tpool,
+                                  ulong  t0 FD_PARAM_UNUSED,      ulong t1 FD_PARAM_UNUSED,
+                                  void * args FD_PARAM_UNUSED,
+                                  void * reduce FD_PARAM_UNUSED,  ulong stride FD_PARAM_UNUSED,
+                                  ulong  l0 FD_PARAM_UNUSED,      ulong l1 FD_PARAM_UNUSED,
+                                  ulong  m0,                      ulong m1 FD_PARAM_UNUSED,
+                                  ulong  n0 FD_PARAM_UNUSED,      ulong n1 FD_PARAM_UNUSED ) {
+  fd_snapshot_create_compress_frame( (fd_snapshot_create_compress_task_info_t const *)tpool, m0 );
+}
+
 static inline void
 fd_snapshot_create_compress( fd_snapshot_ctx_t * snapshot_ctx ) {
 
-  /* Compress the file using zstd. First open the non-compressed file and
-     create a file for the compressed file. The reason why we can't do this
-     as we stream out the snapshot archive is that we write back into the
-     manifest buffer. 
+  /* Compress the file using zstd. The reason why we can't do this as we
+     stream out the snapshot archive is that we write back into the
+     manifest buffer and the append vecs are written out of order.
      
      TODO: A way to eliminate this and to just stream out
      1 compressed file would be to totally precompute the index such that 
      we don't have to write back into funk.
+
+     The tar archive is split into frames of FD_SNAPSHOT_ZSTD_FRAME_SZ
+     bytes which are compressed independently by the tpool workers, one
+     batch of worker_cnt frames at a time, and written out in order.
      
      TODO: Currently, the snapshot service interfaces directly with the zstd 
      library but a generalized cstream defined in fd_zstd should be used 
      instead. */
 
-  ulong in_buf_sz   = ZSTD_CStreamInSize();
-  ulong zstd_buf_sz = ZSTD_CStreamOutSize();
-  ulong out_buf_sz  = ZSTD_CStreamOutSize();
-
-  char * in_buf   = fd_valloc_malloc( snapshot_ctx->valloc, FD_ZSTD_CSTREAM_ALIGN, in_buf_sz );
-  char * zstd_buf = fd_valloc_malloc( snapshot_ctx->valloc, FD_ZSTD_CSTREAM_ALIGN, out_buf_sz );
-  char * out_buf  = fd_valloc_malloc( snapshot_ctx->valloc, FD_ZSTD_CSTREAM_ALIGN, out_buf_sz );
-
-  /* Reopen the tarball and open/overwrite the filename for the compressed,
-     finalized full snapshot. Setup the zstd compression stream. */
-
-  int err = 0;
-
-  ZSTD_CStream * cstream = ZSTD_createCStream();
-  if( FD_UNLIKELY( !cstream ) ) {
-    FD_LOG_ERR(( "Failed to create the zstd compression stream" ));
+  long tar_sz = lseek( snapshot_ctx->tmp_fd, 0, SEEK_END );
+  if( FD_UNLIKELY( tar_sz<0L ) ) {
+    FD_LOG_ERR(( "Failed to get the size of the tar archive" ));
   }
-  ZSTD_initCStream( cstream, ZSTD_CLEVEL_DEFAULT ); 
 
-  fd_io_buffered_ostream_t ostream[1];
+  ulong frame_cnt  = ( (ulong)tar_sz + FD_SNAPSHOT_ZSTD_FRAME_SZ - 1UL ) / FD_SNAPSHOT_ZSTD_FRAME_SZ;
+  ulong worker_cnt = snapshot_ctx->tpool ? fd_tpool_worker_cnt( snapshot_ctx->tpool ) : 1UL;
+  ulong batch_max  = fd_ulong_max( fd_ulong_min( worker_cnt, frame_cnt ), 1UL );
+
+  fd_snapshot_create_compress_task_info_t task_info = {
+    .tmp_fd     = snapshot_ctx->tmp_fd,
+    .tar_sz     = (ulong)tar_sz,
+    .frame0     = 0UL,
+    .frames     = fd_valloc_malloc( snapshot_ctx->valloc, alignof(fd_snapshot_create_frame_t), sizeof(fd_snapshot_create_frame_t) * batch_max ),
+    .in_buf_sz  = ZSTD_CStreamInSize(),
+    .out_buf_sz = ZSTD_compressBound( FD_SNAPSHOT_ZSTD_FRAME_SZ )
+  };
 
-  if( FD_UNLIKELY( !fd_io_buffered_ostream_init( ostream, snapshot_ctx->snapshot_fd, out_buf, out_buf_sz ) ) ) {
-    FD_LOG_ERR(( "Failed to initialize the ostream" ));
+  for( ulong i=0UL; i<batch_max; i++ ) {
+    fd_snapshot_create_frame_t * frame = &task_info.frames[ i ];
+    /* The compression contexts are static and backed by valloc memory
+       so that compression does not make any allocation syscalls from
+       inside the sandbox. */
+    void * cstream_mem = fd_valloc_malloc( snapshot_ctx->valloc, fd_zstd_cstream_align(), fd_zstd_cstream_footprint( ZSTD_CLEVEL_DEFAULT ) );
+    frame->cstream = cstream_mem ? fd_zstd_cstream_new( cstream_mem, ZSTD_CLEVEL_DEFAULT ) : NULL;
+    frame->in_buf  = fd_valloc_malloc( snapshot_ctx->valloc, FD_ZSTD_CSTREAM_ALIGN, task_info.in_buf_sz  );
+    frame->out_buf = fd_valloc_malloc( snapshot_ctx->valloc, FD_ZSTD_CSTREAM_ALIGN, task_info.out_buf_sz );
+    frame->out_sz  = 0UL;
+    if( FD_UNLIKELY( !frame->cstream || !frame->in_buf || !frame->out_buf ) ) {
+      FD_LOG_ERR(( "Failed to create the zstd compression context" ));
+    }
   }
 
   long seek = lseek( snapshot_ctx->snapshot_fd, 0, SEEK_SET );
@@ -1035,69 +1261,39 @@ fd_snapshot_create_compress( fd_snapshot_ctx_t * snapshot_ctx ) {
     FD_LOG_ERR(( "Failed to seek to the start of the file" ));
   }
 
-  /* At this point, the tar archive and the new zstd file is open. The zstd
-     streamer is still open. Now, we are ready to read in bytes and stream
-     compress them. We will keep going until we see an EOF in a tar archive. */
+  FD_LOG_NOTICE(( "Compressing %ld bytes into %lu zstd frames with %lu workers", tar_sz, frame_cnt, worker_cnt ));
 
-  ulong in_sz = in_buf_sz;
+  int err = 0;
 
-  ulong off = (ulong)lseek( snapshot_ctx->tmp_fd, 0, SEEK_SET );
-  if( FD_UNLIKELY( off ) ) {
-    FD_LOG_ERR(( "Failed to seek to the beginning of the file" ));
-  }
+  for( ulong frame0=0UL; frame0<frame_cnt; frame0+=batch_max ) {
 
-  while( in_sz==in_buf_sz ) {
+    ulong frame1 = fd_ulong_min( frame0 + batch_max, frame_cnt );
+    task_info.frame0 = frame0;
 
-    /* Read chunks from the file. There isn't really a need to use a streamed
-       reader here because we will read in the max size buffer for every single
-       file read except for the very last one.
-       
-       in_sz will only not equal in_buf_sz on the last read. */
-    err = fd_io_read( snapshot_ctx->tmp_fd, in_buf, 0UL, in_buf_sz, &in_sz );
-    if( FD_UNLIKELY( err ) ) {
-      FD_LOG_ERR(( "Failed to read in the file" ));
+    if( worker_cnt>1UL ) {
+      fd_tpool_exec_all_rrobin( snapshot_ctx->tpool, 0UL, worker_cnt, fd_snapshot_create_compress_task, &task_info,
+                                NULL, NULL, 1UL, frame0, frame1 );
+    } else {
+      fd_snapshot_create_compress_frame( &task_info, frame0 );
     }
 
-    /* Compress the in memory buffer and add it to the output stream. */
-  
-    ZSTD_inBuffer input = { in_buf, in_sz, 0UL };
-    while( input.pos<input.size ) {
-      ZSTD_outBuffer output = { zstd_buf, zstd_buf_sz, 0UL };
-      ulong          ret    = ZSTD_compressStream( cstream, &output, &input );
-
-      if( FD_UNLIKELY( ZSTD_isError( ret ) ) ) {
-        FD_LOG_ERR(( "Compression error: %s\n", ZSTD_getErrorName( ret ) ));
-      }
+    /* Write out the batch of frames in order. */
 
-      err = fd_io_buffered_ostream_write( ostream, zstd_buf, output.pos );
+    for( ulong i=0UL; i<frame1-frame0; i++ ) {
+      ulong out_sz = 0UL;
+      err = fd_io_write( snapshot_ctx->snapshot_fd, task_info.frames[ i ].out_buf, task_info.frames[ i ].out_sz, task_info.frames[ i ].out_sz, &out_sz );
       if( FD_UNLIKELY( err ) ) {
-        FD_LOG_ERR(( "Failed to write out the compressed file" ));
+        FD_LOG_ERR(( "Failed to write out the compressed file (%i-%s)", err, fd_io_strerror( err ) ));
       }
     }
   }
 
-  /* Now flush any bytes left in the zstd buffer, cleanup open file 
-     descriptors, and deinit any data structures.  */
-
-  ZSTD_outBuffer output    = { zstd_buf, zstd_buf_sz, 0UL };
-  ulong          remaining = ZSTD_endStream(  cstream, &output );
-
-  if( FD_UNLIKELY( ZSTD_isError( remaining ) ) ) {
-    FD_LOG_ERR(( "Unable to end the zstd stream" ));
-  }   
-  if( output.pos>0UL ) {
-    fd_io_buffered_ostream_write( ostream, zstd_buf, output.pos );
-  }
-
-  fd_valloc_free( snapshot_ctx->valloc, in_buf );
-  fd_valloc_free( snapshot_ctx->valloc, zstd_buf );
-  fd_valloc_free( snapshot_ctx->valloc, out_buf );
-
-  ZSTD_freeCStream( cstream ); /* Works even if cstream is null */
-  err = fd_io_buffered_ostream_flush( ostream );
-  if( FD_UNLIKELY( err ) ) {
-    FD_LOG_ERR(( "Failed to flush the ostream" ));
+  for( ulong i=0UL; i<batch_max; i++ ) {
+    fd_valloc_free( snapshot_ctx->valloc, fd_zstd_cstream_delete( task_info.frames[ i ].cstream ) );
+    fd_valloc_free( snapshot_ctx->valloc, task_info.frames[ i ].in_buf  );
+    fd_valloc_free( snapshot_ctx->valloc, task_info.frames[ i ].out_buf );
   }
+  fd_valloc_free( snapshot_ctx->valloc, task_info.frames );
 
   /* Assuming that there was a successful write, make the compressed
      snapshot file readable and servable. */
@@ -31,6 +31,18 @@
    TODO: Figure out exactly what those problems are. */
 #define FD_SNAPSHOT_APPEND_VEC_SZ_MAX     (2UL * 1024UL * 1024UL * 1024UL) /* 2 MiB */
 
+/* The snapshot archive is compressed as a sequence of independent zstd
+   frames of FD_SNAPSHOT_ZSTD_FRAME_SZ uncompressed bytes each (the last
+   one may be smaller).  The frames are compressed in parallel and can
+   be decompressed in parallel too.  Each tpool worker holds the
+   compressed output of one frame in memory, so snapshot creation needs
+   roughly FD_SNAPSHOT_ZSTD_FRAME_SZ bytes of valloc memory per worker. */
+#define FD_SNAPSHOT_ZSTD_FRAME_SZ         (100UL * 1024UL * 1024UL) /* 100 MiB */
+
+/* Size of the buffer used by each tpool worker to stage account data
+   before writing it out into an append vec file. */
+#define FD_SNAPSHOT_ACC_VEC_BUF_SZ        (8UL * 1024UL * 1024UL) /* 8 MiB */
+
 FD_PROTOTYPES_BEGIN
 
 /* fd_snapshot_ctx_t holds various data structures needed for snapshot
@@ -57,7 +69,7 @@ struct fd_snapshot_ctx {
   ulong             last_snap_capitalization;  /* Full snapshot capitalization. */
   fd_hash_t *       last_snap_acc_hash;        /* Full snapshot account hash. */
 
-  fd_tpool_t *      tpool;
+  fd_tpool_t *      tpool;                     /* Used to write out append vecs and compress in parallel, may be NULL. */
 
   /* We need two files to represent the snapshot file because can not directly
      stream out the compressed snapshot with the current implementation of the
@@ -151,6 +163,10 @@ fd_batch_fseq_get_slot( ulong fseq ) {
       are described by the append vec index in the manifest.
 
   The files are written out into a tar archive which is then zstd compressed.
+  The append vecs for slots before the snapshot slot are sized up front so
+  their place in the archive is known, and they are then populated in
+  parallel by the tpool workers.  The archive is compressed in parallel
+  as a sequence of independent zstd frames (see FD_SNAPSHOT_ZSTD_FRAME_SZ).
 
   This can produce either a full snapshot or an incremental snapshot depending
   on the value of is_incremental. An incremental snapshot will contain all of
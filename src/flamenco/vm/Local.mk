@@ -1,9 +1,15 @@
+# The program profiler does not depend on the rest of the VM, so that
+# tiles and tools can create and read it in any build.
+$(call add-objs,fd_vm_prof,fd_flamenco)
+$(call make-unit-test,test_vm_prof,test_vm_prof,fd_flamenco fd_ballet fd_util)
+$(call run-unit-test,test_vm_prof)
+
 ifdef FD_HAS_INT128
 ifdef FD_HAS_HOSTED
 ifdef FD_HAS_SECP256K1
 
 $(call add-hdrs,fd_vm_base.h fd_vm.h fd_vm_private.h) # FIXME: PRIVATE TEMPORARILY HERE DUE TO SOME MESSINESS IN FD_VM_SYSCALL.H
-$(call add-objs,fd_vm fd_vm_interp fd_vm_disasm fd_vm_trace,fd_flamenco)
+$(call add-objs,fd_vm fd_vm_interp fd_vm_predecode fd_vm_disasm fd_vm_trace,fd_flamenco)
 
 $(call add-hdrs,test_vm_util.h)
 $(call add-objs,test_vm_util,fd_flamenco)
@@ -630,6 +630,9 @@ fd_vm_init(
   vm->sha = sha;
   vm->input_mem_regions = mem_regions;
   vm->input_mem_regions_cnt = mem_regions_cnt;
+  vm->input_dirty = NULL;
+  vm->ptext = NULL;
+  vm->prof  = NULL;
   vm->acc_region_metas = acc_region_metas;
   vm->is_deprecated = is_deprecated;
   vm->direct_mapping = direct_mapping;
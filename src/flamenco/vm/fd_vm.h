@@ -43,6 +43,19 @@ struct __attribute((aligned(8UL))) fd_vm_acc_region_meta {
 };
 typedef struct fd_vm_acc_region_meta fd_vm_acc_region_meta_t;
 
+/* When direct mapping is disabled, account data is copied into the
+   input region and the loader has to copy it back out (for writable
+   accounts) or compare it (for everything else) after execution.  To
+   avoid touching account data the program never stored to, the vm can
+   track which FD_VM_INPUT_DIRTY_CHUNK_SZ byte chunks of the input
+   region were the target of a successful store translation.  The
+   tracking is conservative: a chunk is marked even if the bytes stored
+   are identical to what was there before.  A NULL bitmap means that
+   tracking is disabled and every chunk should be treated as dirty. */
+
+#define FD_VM_INPUT_DIRTY_LG_CHUNK_SZ (12)
+#define FD_VM_INPUT_DIRTY_CHUNK_SZ    (1UL<<FD_VM_INPUT_DIRTY_LG_CHUNK_SZ)
+
 /* In Agave, all the regions are 16-byte aligned in host address space. There is then an alignment check
    which is done inside each syscall memory translation, checking if the data is aligned in host address
    space. This is a layering violation, as it leaks the host address layout into the consensus model.
@@ -208,7 +221,23 @@ struct __attribute__((aligned(FD_VM_HOST_REGION_ALIGN))) fd_vm {
      enabled AND we halt on a segfault caused by a store on an invalid vaddr. */
   ulong segv_store_vaddr;
 
+  /* Bitmap of input region chunks that may have been stored to, NULL if
+     not tracked (see FD_VM_INPUT_DIRTY_CHUNK_SZ).  Only used when direct
+     mapping is disabled.  Set by the loader after fd_vm_init. */
+  ulong * input_dirty;
+
   ulong sbpf_version;     /* SBPF version, SIMD-0161 */
+
+  /* Pre-decoded form of text (see fd_vm_predecode), indexed
+     [0,text_cnt), NULL if not available.  When set, non-tracing
+     execution runs from this instead of text.  Set by the loader after
+     fd_vm_init. */
+  fd_vm_pinstr_t const * ptext;
+
+  /* Profiler entry of the executing program (see fd_vm_prof), NULL if
+     not profiling.  When set, the interpreter samples the program
+     counter into it.  Set by the loader after fd_vm_init. */
+  fd_vm_prof_prog_t * prof;
 };
 
 /* FIXME: MOVE ABOVE INTO PRIVATE WHEN CONSTRUCTORS READY */
@@ -223,7 +252,7 @@ FD_PROTOTYPES_BEGIN
    integer power of 2.  FOOTPRINT is a multiple of align. 
    These are provided to facilitate compile time declarations. */
 #define FD_VM_ALIGN     FD_VM_HOST_REGION_ALIGN
-#define FD_VM_FOOTPRINT (527808UL)
+#define FD_VM_FOOTPRINT (527840UL)
 
 /* fd_vm_{align,footprint} give the needed alignment and footprint
    of a memory region suitable to hold an fd_vm_t.
@@ -322,6 +351,45 @@ fd_vm_is_check_align_enabled( fd_vm_t const * vm ) {
    return !vm->is_deprecated;
 }
 
+/* fd_vm_input_dirty_word_cnt returns the number of ulongs needed for a
+   dirty chunk bitmap covering an input region of input_sz bytes. */
+
+FD_FN_CONST static inline ulong
+fd_vm_input_dirty_word_cnt( ulong input_sz ) {
+  return (input_sz + (1UL<<(FD_VM_INPUT_DIRTY_LG_CHUNK_SZ+6)) - 1UL) >> (FD_VM_INPUT_DIRTY_LG_CHUNK_SZ+6);
+}
+
+/* fd_vm_input_dirty_mark marks every chunk overlapping the input region
+   byte range [off,off+sz) as dirty.  Assumes dirty is non-NULL and the
+   range is covered by the bitmap. */
+
+static inline void
+fd_vm_input_dirty_mark( ulong * dirty,
+                        ulong   off,
+                        ulong   sz ) {
+  if( FD_UNLIKELY( !sz ) ) return;
+  ulong c0 =  off         >> FD_VM_INPUT_DIRTY_LG_CHUNK_SZ;
+  ulong c1 = (off+sz-1UL) >> FD_VM_INPUT_DIRTY_LG_CHUNK_SZ;
+  for( ulong c=c0; c<=c1; c++ ) dirty[ c>>6 ] |= 1UL<<(c&63UL);
+}
+
+/* fd_vm_input_dirty_test returns 1 if any chunk overlapping the input
+   region byte range [off,off+sz) may have been stored to and 0 if none
+   of them were.  Returns 1 if dirty is NULL (tracking disabled) and 0
+   if sz is 0. */
+
+FD_FN_PURE static inline int
+fd_vm_input_dirty_test( ulong const * dirty,
+                        ulong         off,
+                        ulong         sz ) {
+  if( FD_UNLIKELY( !dirty ) ) return 1;
+  if( FD_UNLIKELY( !sz    ) ) return 0;
+  ulong c0 =  off         >> FD_VM_INPUT_DIRTY_LG_CHUNK_SZ;
+  ulong c1 = (off+sz-1UL) >> FD_VM_INPUT_DIRTY_LG_CHUNK_SZ;
+  for( ulong c=c0; c<=c1; c++ ) if( dirty[ c>>6 ] & (1UL<<(c&63UL)) ) return 1;
+  return 0;
+}
+
 /* fd_vm_is_check_size_enabled returns 1 if the vm should check size
    when doing memory translation. */
 FD_FN_PURE static inline int
@@ -436,7 +504,11 @@ fd_vm_setup_state_for_execution( fd_vm_t * vm ) ;
 
    fd_vm_exec_trace runs with tracing and requires vm to be attached to
    a trace.  fd_vm_exec_notrace runs without without tracing even if vm
-   is attached to a trace. */
+   is attached to a trace.  fd_vm_exec_predecoded is fd_vm_exec_notrace
+   running from vm->ptext (INVAL if vm has no pre-decoded text).  It
+   is bit-for-bit equivalent to fd_vm_exec_notrace (including pc, ic,
+   cu and the fault reason) provided ptext is the pre-decoded form of
+   text. */
 
 int
 fd_vm_exec_trace( fd_vm_t * vm );
@@ -444,10 +516,14 @@ fd_vm_exec_trace( fd_vm_t * vm );
 int
 fd_vm_exec_notrace( fd_vm_t * vm );
 
+int
+fd_vm_exec_predecoded( fd_vm_t * vm );
+
 static inline int
 fd_vm_exec( fd_vm_t * vm ) {
-  if( FD_UNLIKELY( vm->trace ) ) return fd_vm_exec_trace  ( vm );
-  else                           return fd_vm_exec_notrace( vm );
+  if( FD_UNLIKELY( vm->trace ) ) return fd_vm_exec_trace     ( vm );
+  else if( vm->ptext )           return fd_vm_exec_predecoded( vm );
+  else                           return fd_vm_exec_notrace   ( vm );
 }
 
 FD_PROTOTYPES_END
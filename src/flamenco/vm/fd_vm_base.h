@@ -12,6 +12,7 @@
 
 #include "../fd_flamenco_base.h"
 #include "../../ballet/sbpf/fd_sbpf_loader.h" /* FIXME: functionality needed from here probably should be moved here */
+#include "../../util/hist/fd_histf.h"
 
 /* FD_VM_SUCCESS is zero and returned to indicate that an operation
    completed successfully.  FD_VM_ERR_* are negative integers and
@@ -489,6 +490,83 @@ fd_vm_disasm_program( ulong const *              text,       /* Indexed [0,text_
 
 FD_PROTOTYPES_END
 
+/* fd_vm_predecode API ************************************************/
+
+/* A fd_vm_pinstr_t is a pre-decoded sBPF text word.  fd_vm_predecode
+   translates a program's text once (typically when the program is
+   validated and cached) such that the interpreter does not have to
+   unpack instruction bit fields on every dispatch.  There is exactly
+   one fd_vm_pinstr_t per text word, so program counters, jump targets
+   and compute unit accounting are identical to the raw text.
+
+   op is the interpreter handler to dispatch to.  For most words this is
+   just the opcode.  If a word and the word immediately following it
+   form a common pair (e.g. a MOV64_IMM feeding a register ALU op or a
+   register compare-and-branch), op is a FD_VM_PINSTR_OP_* fused handler
+   that executes both words back to back without going through dispatch
+   for the second.  The second word keeps its own unfused entry, so
+   branches into it behave as normal.  Fused handlers are exactly
+   equivalent to executing the two words separately (the compute units
+   and any faults are accounted at the same pc).
+
+   arg is the sign extended offset or, for LDDW, the full 64-bit
+   immediate assembled from both words. */
+
+struct fd_vm_pinstr {
+  ushort op;
+  uchar  dst;
+  uchar  src;
+  uint   imm;
+  ulong  arg;
+};
+
+typedef struct fd_vm_pinstr fd_vm_pinstr_t;
+
+#define FD_VM_PINSTR_ALIGN (16UL)
+
+/* FD_VM_PINSTR_OP_* give the fused handler indices (opcodes occupy
+   [0,256)).  The names give the first word's opcode and the second
+   word's opcode, e.g. MOVI_ADDR is MOV64_IMM then ADD64_REG. */
+
+#define FD_VM_PINSTR_OP_MOVI_ADDR (256) /* 0xb7 0x0f */
+#define FD_VM_PINSTR_OP_MOVI_SUBR (257) /* 0xb7 0x1f */
+#define FD_VM_PINSTR_OP_MOVI_ORR  (258) /* 0xb7 0x4f */
+#define FD_VM_PINSTR_OP_MOVI_ANDR (259) /* 0xb7 0x5f */
+#define FD_VM_PINSTR_OP_MOVI_JEQR (260) /* 0xb7 0x1d */
+#define FD_VM_PINSTR_OP_MOVI_JGTR (261) /* 0xb7 0x2d */
+#define FD_VM_PINSTR_OP_MOVI_JGER (262) /* 0xb7 0x3d */
+#define FD_VM_PINSTR_OP_MOVI_JNER (263) /* 0xb7 0x5d */
+#define FD_VM_PINSTR_OP_MOVI_JLTR (264) /* 0xb7 0xad */
+#define FD_VM_PINSTR_OP_MOVI_JLER (265) /* 0xb7 0xbd */
+#define FD_VM_PINSTR_OP_ANDI_JEQI (266) /* 0x57 0x15 */
+#define FD_VM_PINSTR_OP_ANDI_JNEI (267) /* 0x57 0x55 */
+#define FD_VM_PINSTR_OP_CNT       (268)
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vm_predecode_footprint returns the number of bytes needed to hold
+   the pre-decoded form of a text_cnt word program.  The region should
+   be aligned to FD_VM_PINSTR_ALIGN. */
+
+FD_FN_CONST static inline ulong
+fd_vm_predecode_footprint( ulong text_cnt ) {
+  return text_cnt*sizeof(fd_vm_pinstr_t);
+}
+
+/* fd_vm_predecode fills ptext[i] for i in [0,text_cnt) with the
+   pre-decoded form of text[i].  The result does not depend on the sBPF
+   version (version specific handler selection still happens when the
+   program is executed), so it can be computed before the program is
+   validated.  Returns ptext on success and NULL (logs details) if ptext
+   or text are NULL or ptext is misaligned. */
+
+fd_vm_pinstr_t *
+fd_vm_predecode( fd_vm_pinstr_t * ptext,      /* Indexed [0,text_cnt) */
+                 ulong const *    text,       /* Indexed [0,text_cnt) */
+                 ulong            text_cnt );
+
+FD_PROTOTYPES_END
+
 /* fd_vm_trace API ****************************************************/
 
 /* FIXME: pretty good case this actually belongs in ballet/sbpf */
@@ -657,6 +735,176 @@ int
 fd_vm_trace_printf( fd_vm_trace_t      const * trace,
                     fd_sbpf_syscalls_t const * syscalls );
 
+/* fd_vm_prof API *****************************************************/
+
+/* A fd_vm_prof_t is an always-on, low overhead sampling profiler for
+   on-chain programs.  It is meant to live in shared memory: the threads
+   executing programs record into it concurrently (all updates are
+   atomic) and monitoring tools (prometheus export, `fddev vmprof`) read
+   it without synchronizing with them.  Counters are monotonic while
+   the entry they belong to is held by the same program.
+
+   There is one fd_vm_prof_prog_t per program id.  Entries are claimed
+   the first time a program executes.  If the table is too crowded
+   around the program id's hash, the entry there that consumed the
+   fewest compute units is evicted (counted in prog_evict_cnt) and
+   reclaimed for the new program, so the table follows the programs
+   that are hot now rather than the first ones seen.  Invocations that
+   lose a race for an entry are only counted in prog_drop_cnt.
+
+   For each invocation, the loader records the compute units consumed
+   and the wallclock ticks spent in cu_hist and ticks_hist (both
+   inclusive of any nested CPI).  While a program executes, the
+   interpreter samples its program counter roughly every sample_period
+   instructions (the interval is jittered to avoid aliasing with loops).
+   Samples are only taken at branches, so a sample attributes the whole
+   preceding straight line segment to the branch that ends it.  This is
+   fine for function level attribution.  Sampled pcs are counted in a
+   small per program table of hot pcs.  When it is crowded, the pc with
+   the fewest samples is evicted and its samples are counted in
+   sample_drop_cnt, so the pc counts and sample_drop_cnt add up to
+   sample_cnt. */
+
+#define FD_VM_PROF_ALIGN  (128UL)
+#define FD_VM_PROF_MAGIC  (0xfdc3f20f0a11c000UL) /* FD VM PROF MAGIC version 0 */
+
+#define FD_VM_PROF_PC_MAX    (256UL) /* Hot pc table size per program, power of 2 */
+
+/* Defaults for a validator's profiler, about 5 MiB */
+
+#define FD_VM_PROF_DEFAULT_PROG_MAX      (1024UL)
+#define FD_VM_PROF_DEFAULT_SAMPLE_PERIOD (4096UL)
+#define FD_VM_PROF_PROBE_MAX (16UL)  /* Max probes in the program and pc tables */
+
+/* Histogram ranges.  Ticks are converted to wallclock by consumers. */
+
+#define FD_VM_PROF_CU_HIST_MIN    (100UL)
+#define FD_VM_PROF_CU_HIST_MAX    (1400000UL)
+#define FD_VM_PROF_TICKS_HIST_MIN (1000UL)
+#define FD_VM_PROF_TICKS_HIST_MAX (10000000000UL)
+
+#define FD_VM_PROF_PROG_STATE_FREE  (0UL)
+#define FD_VM_PROF_PROG_STATE_CLAIM (1UL) /* Being claimed, id not yet valid */
+#define FD_VM_PROF_PROG_STATE_VALID (2UL)
+
+struct fd_vm_prof_pc {
+  ulong pc;  /* Sampled pc plus one, 0 if the slot is free */
+  ulong cnt; /* Number of samples at this pc */
+};
+
+typedef struct fd_vm_prof_pc fd_vm_prof_pc_t;
+
+struct __attribute__((aligned(FD_VM_PROF_ALIGN))) fd_vm_prof_prog {
+  ulong           state;           /* FD_VM_PROF_PROG_STATE_* */
+  ulong           sample_period;   /* Copy of the profiler's sample period (so the interpreter only needs the entry) */
+  fd_pubkey_t     id;              /* Program id, valid if state is VALID */
+  ulong           invoke_cnt;      /* Number of invocations */
+  ulong           sample_cnt;      /* Number of pc samples taken */
+  ulong           sample_drop_cnt; /* Number of pc samples not in pc (evicted or lost to a race) */
+  fd_histf_t      cu_hist   [1];   /* Compute units consumed per invocation */
+  fd_histf_t      ticks_hist[1];   /* Wallclock ticks per invocation */
+  fd_vm_prof_pc_t pc[ FD_VM_PROF_PC_MAX ];
+};
+
+typedef struct fd_vm_prof_prog fd_vm_prof_prog_t;
+
+struct __attribute__((aligned(FD_VM_PROF_ALIGN))) fd_vm_prof {
+  ulong magic;          /* ==FD_VM_PROF_MAGIC */
+  ulong prog_max;       /* Program table size, power of 2 */
+  ulong sample_period;  /* Mean instructions between pc samples, power of 2 */
+  ulong prog_drop_cnt;  /* Invocations of programs that could not get an entry */
+  ulong prog_evict_cnt; /* Entries reclaimed from a cold program for another one */
+  /* This point is aligned FD_VM_PROF_ALIGN
+     prog_max fd_vm_prof_prog_t */
+};
+
+typedef struct fd_vm_prof fd_vm_prof_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* profiler object structors.  prog_max and sample_period must be
+   positive integer powers of 2.  Usual conventions otherwise. */
+
+FD_FN_CONST ulong
+fd_vm_prof_align( void );
+
+FD_FN_CONST ulong
+fd_vm_prof_footprint( ulong prog_max );
+
+void *
+fd_vm_prof_new( void * shmem,
+                ulong  prog_max,
+                ulong  sample_period );
+
+fd_vm_prof_t *
+fd_vm_prof_join( void * _prof );
+
+void *
+fd_vm_prof_leave( fd_vm_prof_t * prof );
+
+void *
+fd_vm_prof_delete( void * _prof );
+
+/* fd_vm_prof_prog returns the location of the program table, indexed
+   [0,prog_max).  Entries whose state is not VALID should be skipped by
+   readers. */
+
+FD_FN_CONST static inline fd_vm_prof_prog_t *
+fd_vm_prof_prog( fd_vm_prof_t * prof ) {
+  return (fd_vm_prof_prog_t *)(prof+1);
+}
+
+FD_FN_CONST static inline fd_vm_prof_prog_t const *
+fd_vm_prof_prog_const( fd_vm_prof_t const * prof ) {
+  return (fd_vm_prof_prog_t const *)(prof+1);
+}
+
+/* fd_vm_prof_prog_acquire returns the entry for program id, claiming
+   one (evicting a cold program if needed) if the program does not have
+   one.  Returns NULL (and counts the invocation in prog_drop_cnt) if it
+   lost a race with another thread evicting the same entry. */
+
+fd_vm_prof_prog_t *
+fd_vm_prof_prog_acquire( fd_vm_prof_t *      prof,
+                         fd_pubkey_t const * id );
+
+/* fd_vm_prof_record records an invocation of the program that consumed
+   cu compute units and took ticks wallclock ticks. */
+
+void
+fd_vm_prof_record( fd_vm_prof_prog_t * prog,
+                   ulong               cu,
+                   ulong               ticks );
+
+/* fd_vm_prof_sample records a pc sample at pc for the program and
+   returns the instruction count at which to take the next sample given
+   the current instruction count ic.  fd_vm_prof_sample_first returns
+   the instruction count at which to take the first sample of an
+   execution starting at ic. */
+
+ulong
+fd_vm_prof_sample( fd_vm_prof_prog_t * prog,
+                   ulong               pc,
+                   ulong               ic );
+
+static inline ulong
+fd_vm_prof_sample_first( fd_vm_prof_prog_t const * prog,
+                         ulong                     ic ) {
+  return ic + 1UL + ((ulong)fd_tickcount() & (2UL*prog->sample_period-1UL));
+}
+
+/* fd_vm_prof_top writes into idx the indices of the (up to) idx_max
+   valid programs with the most compute units consumed, in decreasing
+   order, and returns the number written.  Reads concurrently with
+   writers so counts may be a little stale. */
+
+ulong
+fd_vm_prof_top( fd_vm_prof_t const * prof,
+                ulong *              idx,
+                ulong                idx_max );
+
+FD_PROTOTYPES_END
+
 /* fd_vm_syscall API **************************************************/
 
 /* FIXME: fd_sbpf_syscalls_t and fd_sbpf_syscall_func_t probably should
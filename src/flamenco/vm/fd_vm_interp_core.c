@@ -17,6 +17,10 @@
 # pragma clang diagnostic push
 # pragma clang diagnostic ignored "-Wpedantic"
 # pragma clang diagnostic ignored "-Wgnu-label-as-value"
+# endif
+
+# if defined(FD_VM_INTERP_PREDECODED) && defined(FD_VM_INTERP_EXE_TRACING_ENABLED)
+# error "Tracing runs from the raw text"
 # endif
 
   /* Include the jump table */
@@ -136,8 +140,12 @@
      instruction.  After a normal halt, this will branch to interp_halt.
      Otherwise, it will branch to the appropriate normal termination. */
 
+# ifndef FD_VM_INTERP_PREDECODED
   ulong instr;
   ulong opcode;
+# else
+  fd_vm_pinstr_t const * pi;
+# endif
   ulong dst;
   ulong src;
   ulong offset; /* offset is 16-bit but always sign extended, so we handle cast once */
@@ -172,6 +180,7 @@
 #define FD_RUST_UINT_WRAPPING_SHR( a, b ) (a >> ( b & ( 31 ) ))
 
 
+# ifndef FD_VM_INTERP_PREDECODED
 # define FD_VM_INTERP_INSTR_EXEC                                                                 \
   if( FD_UNLIKELY( pc>=text_cnt ) ) goto sigtext; /* Note: untaken branches don't consume BTB */ \
   instr   = text[ pc ];                  /* Guaranteed in-bounds */                              \
@@ -183,6 +192,18 @@
   reg_dst = reg[ dst ];                  /* Guaranteed in-bounds */                              \
   reg_src = reg[ src ];                  /* Guaranteed in-bounds */                              \
   goto *interp_jump_table[ opcode ]      /* Guaranteed in-bounds */
+# else /* The instruction fields were already unpacked by fd_vm_predecode */
+# define FD_VM_INTERP_INSTR_EXEC                                                                 \
+  if( FD_UNLIKELY( pc>=text_cnt ) ) goto sigtext; /* Note: untaken branches don't consume BTB */ \
+  pi      = ptext + pc;                  /* Guaranteed in-bounds */                              \
+  dst     = pi->dst;                     /* in [0, 16) even if malformed */                      \
+  src     = pi->src;                     /* in [0, 16) even if malformed */                      \
+  offset  = pi->arg;                     /* in [-2^15,2^15) even if malformed */                 \
+  imm     = pi->imm;                     /* in [0,2^32) even if malformed */                     \
+  reg_dst = reg[ dst ];                  /* Guaranteed in-bounds */                              \
+  reg_src = reg[ src ];                  /* Guaranteed in-bounds */                              \
+  goto *interp_jump_table[ pi->op ]      /* Guaranteed in-bounds */
+# endif
 
 /* FD_VM_INTERP_SYSCALL_EXEC
    (macro to handle the logic of 0x85 pre- and post- SIMD-0178: static syscalls)
@@ -301,6 +322,13 @@
   ulong pc0           = pc;
   ulong ic_correction = 0UL;
 
+  /* If profiling, the pc is sampled at the first branch at or after
+     instruction count prof_ic (see fd_vm_prof).  Otherwise, prof_ic is
+     never reached. */
+
+  fd_vm_prof_prog_t * prof    = vm->prof;
+  ulong               prof_ic = prof ? fd_vm_prof_sample_first( prof, ic ) : ULONG_MAX;
+
 # define FD_VM_INTERP_BRANCH_BEGIN(opcode)                                                              \
   interp_##opcode:                                                                                      \
     /* Bill linear text segment and this branch instruction as per the above */                         \
@@ -309,7 +337,8 @@
     if( FD_UNLIKELY( ic_correction>cu ) ) goto sigcost; /* Note: untaken branches don't consume BTB */  \
     cu -= ic_correction;                                                                                \
     /* At this point, cu>=0 */                                                                          \
-    ic_correction = 0UL;
+    ic_correction = 0UL;                                                                                \
+    if( FD_UNLIKELY( ic>=prof_ic ) ) prof_ic = fd_vm_prof_sample( prof, pc, ic );
 
   /* FIXME: debatable if it is better to do pc++ here or have the
      instruction implementations do it in their code path. */
@@ -433,7 +462,11 @@ interp_exec:
     ic_correction++;
     /* No need to check pc because it's already checked during validation.
        if( FD_UNLIKELY( pc>=text_cnt ) ) goto sigsplit; // Note: untaken branches don't consume BTB */
+#   ifndef FD_VM_INTERP_PREDECODED
     reg[ dst ] = (ulong)((ulong)imm | ((ulong)fd_vm_instr_imm( text[ pc ] ) << 32));
+#   else
+    reg[ dst ] = pi->arg;
+#   endif
   FD_VM_INTERP_INSTR_END;
 
   FD_VM_INTERP_INSTR_BEGIN(0x1c) /* FD_SBPF_OP_SUB_REG */
@@ -1132,6 +1165,48 @@ interp_exec:
     reg[ dst ] = (ulong)( (long)reg_dst % (long)reg_src );
   FD_VM_INTERP_INSTR_END;
 
+# ifdef FD_VM_INTERP_PREDECODED
+
+  /* Fused handlers execute the first word of a pair, then unpack the
+     pre-decoded second word and jump straight to its handler.  This is
+     the same as what FD_VM_INTERP_INSTR_END would do, minus the text
+     bounds check (fd_vm_predecode only fuses pairs inside the text) and
+     the indirect dispatch.  The first word of every pair is a
+     non-branching instruction that cannot fault, so pc0 and
+     ic_correction need no adjustment: the second word bills the pair
+     (if it is a branch) or leaves it to the next branch / fault as
+     usual. */
+
+# define FD_VM_INTERP_FUSED(name,first,second) \
+  interp_##name:                               \
+    first;                                     \
+    pc++;                                      \
+    pi++;                                      \
+    dst     = pi->dst;                         \
+    src     = pi->src;                         \
+    offset  = pi->arg;                         \
+    imm     = pi->imm;                         \
+    reg_dst = reg[ dst ];                      \
+    reg_src = reg[ src ];                      \
+    goto interp_##second
+
+  FD_VM_INTERP_FUSED( movi_addr, reg[ dst ] = (ulong)(long)(int)imm,    0x0f );
+  FD_VM_INTERP_FUSED( movi_subr, reg[ dst ] = (ulong)(long)(int)imm,    0x1f );
+  FD_VM_INTERP_FUSED( movi_orr,  reg[ dst ] = (ulong)(long)(int)imm,    0x4f );
+  FD_VM_INTERP_FUSED( movi_andr, reg[ dst ] = (ulong)(long)(int)imm,    0x5f );
+  FD_VM_INTERP_FUSED( movi_jeqr, reg[ dst ] = (ulong)(long)(int)imm,    0x1d );
+  FD_VM_INTERP_FUSED( movi_jgtr, reg[ dst ] = (ulong)(long)(int)imm,    0x2d );
+  FD_VM_INTERP_FUSED( movi_jger, reg[ dst ] = (ulong)(long)(int)imm,    0x3d );
+  FD_VM_INTERP_FUSED( movi_jner, reg[ dst ] = (ulong)(long)(int)imm,    0x5d );
+  FD_VM_INTERP_FUSED( movi_jltr, reg[ dst ] = (ulong)(long)(int)imm,    0xad );
+  FD_VM_INTERP_FUSED( movi_jler, reg[ dst ] = (ulong)(long)(int)imm,    0xbd );
+  FD_VM_INTERP_FUSED( andi_jeqi, reg[ dst ] = reg_dst & (ulong)(long)(int)imm, 0x15 );
+  FD_VM_INTERP_FUSED( andi_jnei, reg[ dst ] = reg_dst & (ulong)(long)(int)imm, 0x55 );
+
+# undef FD_VM_INTERP_FUSED
+
+# endif
+
   /* FIXME: sigbus/sigrdonly are mapped to sigsegv for simplicity
      currently but could be enabled if desired. */
 
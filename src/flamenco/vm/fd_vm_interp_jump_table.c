@@ -2,7 +2,11 @@
      array where each index is an opcode that can be jumped to be
      executed.  Invalid opcodes branch to the sigill label. */
 
+# ifndef FD_VM_INTERP_PREDECODED
   static void const * interp_jump_table[ 256 ] = {
+# else /* Pre-decoded text also dispatches to fused handlers */
+  static void const * interp_jump_table[ FD_VM_PINSTR_OP_CNT ] = {
+# endif
 
 #   define OPCODE(opcode) interp_##opcode
 
@@ -71,6 +75,16 @@
     /* 0xf8 */ &&sigill,       /* 0xf9 */ &&sigill,       /* 0xfa */ &&sigill,       /* 0xfb */ &&sigill,
     /* 0xfc */ &&sigill,       /* 0xfd */ &&sigill,       /* 0xfe */ &&OPCODE(0xfe), /* 0xff */ &&sigill
 
+#   ifdef FD_VM_INTERP_PREDECODED
+    ,
+    /* MOVI_ADDR */ &&interp_movi_addr, /* MOVI_SUBR */ &&interp_movi_subr,
+    /* MOVI_ORR  */ &&interp_movi_orr,  /* MOVI_ANDR */ &&interp_movi_andr,
+    /* MOVI_JEQR */ &&interp_movi_jeqr, /* MOVI_JGTR */ &&interp_movi_jgtr,
+    /* MOVI_JGER */ &&interp_movi_jger, /* MOVI_JNER */ &&interp_movi_jner,
+    /* MOVI_JLTR */ &&interp_movi_jltr, /* MOVI_JLER */ &&interp_movi_jler,
+    /* ANDI_JEQI */ &&interp_andi_jeqi, /* ANDI_JNEI */ &&interp_andi_jnei
+#   endif
+
 #   undef OPCODE
 
   };
@@ -0,0 +1,85 @@
+#include "fd_vm_private.h"
+
+/* fd_vm_predecode_fuse returns the fused handler for the word pair
+   (op0,op1) or op0 if the pair has no fused handler.  Only opcodes
+   whose handler is the same in every sBPF version are fused (the
+   interpreter jumps straight to the second word's handler, bypassing
+   the version patched dispatch table). */
+
+static ulong
+fd_vm_predecode_fuse( ulong op0,
+                      ulong op1 ) {
+  switch( op0 ) {
+  case 0xb7UL: /* FD_SBPF_OP_MOV64_IMM */
+    switch( op1 ) {
+    case 0x0fUL: return FD_VM_PINSTR_OP_MOVI_ADDR; /* FD_SBPF_OP_ADD64_REG */
+    case 0x1fUL: return FD_VM_PINSTR_OP_MOVI_SUBR; /* FD_SBPF_OP_SUB64_REG */
+    case 0x4fUL: return FD_VM_PINSTR_OP_MOVI_ORR;  /* FD_SBPF_OP_OR64_REG */
+    case 0x5fUL: return FD_VM_PINSTR_OP_MOVI_ANDR; /* FD_SBPF_OP_AND64_REG */
+    case 0x1dUL: return FD_VM_PINSTR_OP_MOVI_JEQR; /* FD_SBPF_OP_JEQ_REG */
+    case 0x2dUL: return FD_VM_PINSTR_OP_MOVI_JGTR; /* FD_SBPF_OP_JGT_REG */
+    case 0x3dUL: return FD_VM_PINSTR_OP_MOVI_JGER; /* FD_SBPF_OP_JGE_REG */
+    case 0x5dUL: return FD_VM_PINSTR_OP_MOVI_JNER; /* FD_SBPF_OP_JNE_REG */
+    case 0xadUL: return FD_VM_PINSTR_OP_MOVI_JLTR; /* FD_SBPF_OP_JLT_REG */
+    case 0xbdUL: return FD_VM_PINSTR_OP_MOVI_JLER; /* FD_SBPF_OP_JLE_REG */
+    default: break;
+    }
+    break;
+  case 0x57UL: /* FD_SBPF_OP_AND64_IMM */
+    switch( op1 ) {
+    case 0x15UL: return FD_VM_PINSTR_OP_ANDI_JEQI; /* FD_SBPF_OP_JEQ_IMM */
+    case 0x55UL: return FD_VM_PINSTR_OP_ANDI_JNEI; /* FD_SBPF_OP_JNE_IMM */
+    default: break;
+    }
+    break;
+  default: break;
+  }
+  return op0;
+}
+
+fd_vm_pinstr_t *
+fd_vm_predecode( fd_vm_pinstr_t * ptext,
+                 ulong const *    text,
+                 ulong            text_cnt ) {
+
+  if( FD_UNLIKELY( !ptext ) ) {
+    FD_LOG_WARNING(( "NULL ptext" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)ptext, FD_VM_PINSTR_ALIGN ) ) ) {
+    FD_LOG_WARNING(( "misaligned ptext" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (!text) & (!!text_cnt) ) ) {
+    FD_LOG_WARNING(( "NULL text" ));
+    return NULL;
+  }
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    ulong instr  = text[ pc ];
+    ulong opcode = fd_vm_instr_opcode( instr );
+    ulong next   = pc+1UL<text_cnt ? text[ pc+1UL ] : 0UL;
+
+    fd_vm_pinstr_t * p = ptext + pc;
+    p->op  = (ushort)opcode;
+    p->dst = (uchar)fd_vm_instr_dst( instr );
+    p->src = (uchar)fd_vm_instr_src( instr );
+    p->imm = fd_vm_instr_imm( instr );
+    p->arg = fd_vm_instr_offset( instr );
+
+    /* An LDDW carries the upper half of its immediate in the next word.
+       If this is not actually an LDDW in the program's sBPF version,
+       the interpreter never reads arg for it. */
+
+    if( opcode==0x18UL ) p->arg = (ulong)p->imm | ((ulong)fd_vm_instr_imm( next ) << 32);
+
+    /* The second word of a fused pair must be in the text (so it cannot
+       sigtext). */
+
+    else if( pc+1UL<text_cnt ) p->op = (ushort)fd_vm_predecode_fuse( opcode, fd_vm_instr_opcode( next ) );
+  }
+
+  return ptext;
+}
@@ -346,7 +346,9 @@ fd_vm_get_input_mem_region_idx( fd_vm_t const * vm, ulong offset ) {
    illegal write is performed, the sentinel value is returned. If the offset
    provided is too large, it will choose the upper-most region as the
    region_idx. However, it will get caught for being too large of an access
-   in the multi-region checks. */
+   in the multi-region checks.  A successful write translation marks the
+   range dirty if the vm tracks input region stores (see
+   FD_VM_INPUT_DIRTY_CHUNK_SZ). */
 static inline ulong
 fd_vm_find_input_mem_region( fd_vm_t const * vm, 
                              ulong           offset,
@@ -389,6 +391,10 @@ fd_vm_find_input_mem_region( fd_vm_t const * vm,
     bytes_in_cur_region = vm->input_mem_regions[ region_idx ].region_sz;
   }
 
+  /* Only the copied (single region) input layout is tracked, so offset
+     is also the offset into the dirty bitmap. */
+  if( write && vm->input_dirty ) fd_vm_input_dirty_mark( vm->input_dirty, offset, sz );
+
   ulong adjusted_haddr = vm->input_mem_regions[ start_region_idx ].haddr + offset - vm->input_mem_regions[ start_region_idx ].vaddr_offset;
   return adjusted_haddr; 
 }
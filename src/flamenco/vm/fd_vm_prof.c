@@ -0,0 +1,316 @@
+#include "fd_vm_base.h"
+
+/* Profiler updates come from several concurrently executing threads.
+   Targets without atomics are single threaded. */
+
+#if FD_HAS_ATOMIC
+#define FD_VM_PROF_ADD(p,v)   FD_ATOMIC_FETCH_AND_ADD( (p), (v) )
+#define FD_VM_PROF_CAS(p,c,s) FD_ATOMIC_CAS( (p), (c), (s) )
+#define FD_VM_PROF_XCHG(p,v)  FD_ATOMIC_XCHG( (p), (v) )
+#else
+#define FD_VM_PROF_ADD(p,v)   (*(p) += (v))
+#define FD_VM_PROF_CAS(p,c,s) fd_vm_prof_private_cas( (p), (c), (s) )
+#define FD_VM_PROF_XCHG(p,v)  fd_vm_prof_private_xchg( (p), (v) )
+
+static inline ulong
+fd_vm_prof_private_cas( ulong * p,
+                        ulong   c,
+                        ulong   s ) {
+  ulong o = *p;
+  if( o==c ) *p = s;
+  return o;
+}
+
+static inline ulong
+fd_vm_prof_private_xchg( ulong * p,
+                         ulong   v ) {
+  ulong o = *p;
+  *p = v;
+  return o;
+}
+#endif
+
+ulong
+fd_vm_prof_align( void ) {
+  return FD_VM_PROF_ALIGN;
+}
+
+ulong
+fd_vm_prof_footprint( ulong prog_max ) {
+  if( FD_UNLIKELY( (!prog_max) | (!fd_ulong_is_pow2( prog_max )) | (prog_max>(1UL<<20)) ) ) return 0UL;
+  return sizeof(fd_vm_prof_t) + prog_max*sizeof(fd_vm_prof_prog_t);
+}
+
+void *
+fd_vm_prof_new( void * shmem,
+                ulong  prog_max,
+                ulong  sample_period ) {
+  fd_vm_prof_t * prof = (fd_vm_prof_t *)shmem;
+
+  if( FD_UNLIKELY( !prof ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_vm_prof_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_vm_prof_footprint( prog_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad prog_max" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( (!sample_period) | (!fd_ulong_is_pow2( sample_period )) | (sample_period>(1UL<<40)) ) ) {
+    FD_LOG_WARNING(( "bad sample_period" ));
+    return NULL;
+  }
+
+  memset( prof, 0, footprint );
+
+  prof->prog_max      = prog_max;
+  prof->sample_period = sample_period;
+
+  fd_vm_prof_prog_t * prog = fd_vm_prof_prog( prof );
+  for( ulong i=0UL; i<prog_max; i++ ) {
+    prog[ i ].sample_period = sample_period;
+    fd_histf_new( prog[ i ].cu_hist,    FD_VM_PROF_CU_HIST_MIN,    FD_VM_PROF_CU_HIST_MAX    );
+    fd_histf_new( prog[ i ].ticks_hist, FD_VM_PROF_TICKS_HIST_MIN, FD_VM_PROF_TICKS_HIST_MAX );
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( prof->magic ) = FD_VM_PROF_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return prof;
+}
+
+fd_vm_prof_t *
+fd_vm_prof_join( void * _prof ) {
+  fd_vm_prof_t * prof = (fd_vm_prof_t *)_prof;
+
+  if( FD_UNLIKELY( !prof ) ) {
+    FD_LOG_WARNING(( "NULL _prof" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)_prof, fd_vm_prof_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned _prof" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( prof->magic!=FD_VM_PROF_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return prof;
+}
+
+void *
+fd_vm_prof_leave( fd_vm_prof_t * prof ) {
+
+  if( FD_UNLIKELY( !prof ) ) {
+    FD_LOG_WARNING(( "NULL prof" ));
+    return NULL;
+  }
+
+  return (void *)prof;
+}
+
+void *
+fd_vm_prof_delete( void * _prof ) {
+  fd_vm_prof_t * prof = (fd_vm_prof_t *)_prof;
+
+  if( FD_UNLIKELY( !prof ) ) {
+    FD_LOG_WARNING(( "NULL _prof" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)_prof, fd_vm_prof_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned _prof" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( prof->magic!=FD_VM_PROF_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( prof->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return (void *)prof;
+}
+
+/* fd_vm_prof_prog_reset clears the counters of an entry being
+   reclaimed for another program.  The caller holds the entry in the
+   CLAIM state. */
+
+static void
+fd_vm_prof_prog_reset( fd_vm_prof_prog_t * ele ) {
+  ele->invoke_cnt      = 0UL;
+  ele->sample_cnt      = 0UL;
+  ele->sample_drop_cnt = 0UL;
+  fd_histf_new( ele->cu_hist,    FD_VM_PROF_CU_HIST_MIN,    FD_VM_PROF_CU_HIST_MAX    );
+  fd_histf_new( ele->ticks_hist, FD_VM_PROF_TICKS_HIST_MIN, FD_VM_PROF_TICKS_HIST_MAX );
+  memset( ele->pc, 0, sizeof(ele->pc) );
+}
+
+fd_vm_prof_prog_t *
+fd_vm_prof_prog_acquire( fd_vm_prof_t *      prof,
+                         fd_pubkey_t const * id ) {
+  fd_vm_prof_prog_t * prog = fd_vm_prof_prog( prof );
+  ulong               mask = prof->prog_max-1UL;
+  ulong               hash = fd_ulong_hash( id->ul[0] ^ id->ul[3] );
+
+  fd_vm_prof_prog_t * cold    = NULL;
+  ulong               cold_cu = ULONG_MAX;
+
+  for( ulong probe=0UL; probe<fd_ulong_min( FD_VM_PROF_PROBE_MAX, prof->prog_max ); probe++ ) {
+    fd_vm_prof_prog_t * ele = prog + ((hash+probe) & mask);
+
+    ulong state = FD_VOLATILE_CONST( ele->state );
+    if( state==FD_VM_PROF_PROG_STATE_FREE ) {
+      state = FD_VM_PROF_CAS( &ele->state, FD_VM_PROF_PROG_STATE_FREE, FD_VM_PROF_PROG_STATE_CLAIM );
+      if( FD_LIKELY( state==FD_VM_PROF_PROG_STATE_FREE ) ) {
+        ele->id = *id;
+        FD_COMPILER_MFENCE();
+        FD_VOLATILE( ele->state ) = FD_VM_PROF_PROG_STATE_VALID;
+        return ele;
+      }
+    }
+
+    /* Somebody else is claiming this entry.  This takes a few
+       instructions, so just wait for them to finish. */
+
+    while( FD_UNLIKELY( state==FD_VM_PROF_PROG_STATE_CLAIM ) ) {
+      FD_SPIN_PAUSE();
+      state = FD_VOLATILE_CONST( ele->state );
+    }
+    FD_COMPILER_MFENCE();
+
+    if( FD_LIKELY( !memcmp( ele->id.uc, id->uc, sizeof(fd_pubkey_t) ) ) ) return ele;
+
+    ulong cu = fd_histf_sum( ele->cu_hist );
+    if( cu<cold_cu ) {
+      cold    = ele;
+      cold_cu = cu;
+    }
+  }
+
+  /* No room around the program id's hash.  Evict the entry that
+     consumed the fewest compute units (the one least likely to show up
+     in fd_vm_prof_top).  Threads still executing the evicted program
+     may add a few updates to the new program's counters, which is fine
+     for a sampling profiler.  If another thread is evicting the same
+     entry, give up on this invocation. */
+
+  if( FD_LIKELY( cold ) &&
+      FD_VM_PROF_CAS( &cold->state, FD_VM_PROF_PROG_STATE_VALID, FD_VM_PROF_PROG_STATE_CLAIM )==FD_VM_PROF_PROG_STATE_VALID ) {
+    FD_COMPILER_MFENCE();
+    fd_vm_prof_prog_reset( cold );
+    cold->id = *id;
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( cold->state ) = FD_VM_PROF_PROG_STATE_VALID;
+    FD_VM_PROF_ADD( &prof->prog_evict_cnt, 1UL );
+    return cold;
+  }
+
+  FD_VM_PROF_ADD( &prof->prog_drop_cnt, 1UL );
+  return NULL;
+}
+
+/* fd_vm_prof_hist_sample is fd_histf_sample with atomic updates. */
+
+static void
+fd_vm_prof_hist_sample( fd_histf_t * hist,
+                        ulong        value ) {
+  long  v = (long)(value - (1UL<<63));
+  ulong b = 0UL;
+  while( (b<FD_HISTF_BUCKET_CNT-1UL) && (v>=hist->left_edge[ b+1UL ]) ) b++;
+  FD_VM_PROF_ADD( &hist->counts[ b ], 1UL   );
+  FD_VM_PROF_ADD( &hist->sum,         value );
+}
+
+void
+fd_vm_prof_record( fd_vm_prof_prog_t * prog,
+                   ulong               cu,
+                   ulong               ticks ) {
+  FD_VM_PROF_ADD( &prog->invoke_cnt, 1UL );
+  fd_vm_prof_hist_sample( prog->cu_hist,    cu    );
+  fd_vm_prof_hist_sample( prog->ticks_hist, ticks );
+}
+
+ulong
+fd_vm_prof_sample( fd_vm_prof_prog_t * prog,
+                   ulong               pc,
+                   ulong               ic ) {
+  FD_VM_PROF_ADD( &prog->sample_cnt, 1UL );
+
+  ulong             key       = pc+1UL;
+  ulong             hash      = fd_ulong_hash( pc );
+  fd_vm_prof_pc_t * cold      = NULL;
+  ulong             cold_key  = 0UL;
+  ulong             cold_cnt  = ULONG_MAX;
+  for( ulong probe=0UL; probe<FD_VM_PROF_PROBE_MAX; probe++ ) {
+    fd_vm_prof_pc_t * ele = prog->pc + ((hash+probe) & (FD_VM_PROF_PC_MAX-1UL));
+    ulong found = FD_VOLATILE_CONST( ele->pc );
+    if( !found ) found = FD_VM_PROF_CAS( &ele->pc, 0UL, key );
+    if( !found || found==key ) {
+      FD_VM_PROF_ADD( &ele->cnt, 1UL );
+      return fd_vm_prof_sample_first( prog, ic );
+    }
+    ulong cnt = FD_VOLATILE_CONST( ele->cnt );
+    if( cnt<cold_cnt ) {
+      cold     = ele;
+      cold_key = found;
+      cold_cnt = cnt;
+    }
+  }
+
+  /* No room around the pc's hash.  Evict the pc with the fewest
+     samples, so hot pcs stay in the table while a long tail of cold
+     ones cycles through the remaining slots.  Samples of the evicted
+     pc are counted as dropped, such that the pc counts plus
+     sample_drop_cnt still add up to sample_cnt.  If another thread
+     evicts the same pc first, this sample is dropped. */
+
+  if( FD_VM_PROF_CAS( &cold->pc, cold_key, key )==cold_key ) {
+    FD_VM_PROF_ADD( &prog->sample_drop_cnt, FD_VM_PROF_XCHG( &cold->cnt, 1UL ) );
+  } else {
+    FD_VM_PROF_ADD( &prog->sample_drop_cnt, 1UL );
+  }
+  return fd_vm_prof_sample_first( prog, ic );
+}
+
+ulong
+fd_vm_prof_top( fd_vm_prof_t const * prof,
+                ulong *              idx,
+                ulong                idx_max ) {
+  fd_vm_prof_prog_t const * prog = fd_vm_prof_prog_const( prof );
+
+  /* Insertion into a short sorted list (idx_max is expected to be
+     small relative to prog_max) */
+
+  ulong cnt = 0UL;
+  for( ulong i=0UL; i<prof->prog_max; i++ ) {
+    if( FD_VOLATILE_CONST( prog[ i ].state )!=FD_VM_PROF_PROG_STATE_VALID ) continue;
+    ulong cu = fd_histf_sum( prog[ i ].cu_hist );
+
+    ulong j = cnt;
+    while( j && fd_histf_sum( prog[ idx[ j-1UL ] ].cu_hist )<cu ) {
+      if( j<idx_max ) idx[ j ] = idx[ j-1UL ];
+      j--;
+    }
+    if( j<idx_max ) {
+      idx[ j ] = i;
+      cnt = fd_ulong_min( cnt+1UL, idx_max );
+    }
+  }
+
+  return cnt;
+}
@@ -779,6 +779,14 @@ VM_SYSCALL_CPI_ENTRYPOINT( void *  _vm,
     }
   }
 
+  /* Without direct mapping, the callee account updates below copy from
+     wherever the caller's account infos point, and the caller account
+     updates afterwards may write past the ranges they translate.  The
+     loader's dirty tracking can't attribute those writes to accounts, so
+     stop tracking and let deserialization fall back to copying and
+     comparing all account data. */
+  if( !vm->direct_mapping ) vm->input_dirty = NULL;
+
   /* Update the callee accounts with any changes made by the caller prior to this CPI execution */
   ulong callee_account_keys[256];
   ulong caller_accounts_to_update[256];
@@ -256,11 +256,16 @@ invalid_error:
 
    Specifically it takes as input byte arrays and takes care of scalars
    validation and points decompression.  It then invokes ballet MSM
-   function fd_ed25519_multi_scalar_mul.  To avoid dynamic allocation,
-   the full MSM is done in batches of FD_BALLET_CURVE25519_MSM_BATCH_SZ. */
+   function fd_ed25519_multi_scalar_mul.  The full MSM is done in
+   batches of FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ, i.e. in a
+   single batch for any valid points_len, so that large MSMs use
+   Pippenger.  A is caller provided scratch for a batch of decompressed
+   points (too large for the stack, the syscall allocates it from the
+   transaction spad). */
 
 static fd_ed25519_point_t *
 multi_scalar_mul_edwards( fd_ed25519_point_t * r,
+                          fd_ed25519_point_t * A,
                           uchar const *        scalars,
                           uchar const *        points,
                           ulong                cnt ) {
@@ -271,13 +276,11 @@ multi_scalar_mul_edwards( fd_ed25519_point_t * r,
     }
   }
 
-  /* Static allocation of a batch of decompressed points */
   fd_ed25519_point_t tmp[1];
-  fd_ed25519_point_t A[ FD_BALLET_CURVE25519_MSM_BATCH_SZ ];
 
   fd_ed25519_point_set_zero( r );
-  for( ulong i=0UL; i<cnt; i+=FD_BALLET_CURVE25519_MSM_BATCH_SZ ) {
-    ulong batch_cnt = fd_ulong_min( cnt-i, FD_BALLET_CURVE25519_MSM_BATCH_SZ );
+  for( ulong i=0UL; i<cnt; i+=FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ ) {
+    ulong batch_cnt = fd_ulong_min( cnt-i, FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ );
 
     /* Decompress (and validate) points */
     for( ulong j=0UL; j<batch_cnt; j++ ) {
@@ -301,6 +304,7 @@ multi_scalar_mul_edwards( fd_ed25519_point_t * r,
 
 static fd_ed25519_point_t *
 multi_scalar_mul_ristretto( fd_ristretto255_point_t * r,
+                            fd_ristretto255_point_t * A,
                             uchar const *             scalars,
                             uchar const *             points,
                             ulong                     cnt ) {
@@ -311,13 +315,11 @@ multi_scalar_mul_ristretto( fd_ristretto255_point_t * r,
     }
   }
 
-  /* Static allocation of a batch of decompressed points */
   fd_ristretto255_point_t tmp[1];
-  fd_ristretto255_point_t A[ FD_BALLET_CURVE25519_MSM_BATCH_SZ ];
 
   fd_ristretto255_point_set_zero( r );
-  for( ulong i=0UL; i<cnt; i+=FD_BALLET_CURVE25519_MSM_BATCH_SZ ) {
-    ulong batch_cnt = fd_ulong_min( cnt-i, FD_BALLET_CURVE25519_MSM_BATCH_SZ );
+  for( ulong i=0UL; i<cnt; i+=FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ ) {
+    ulong batch_cnt = fd_ulong_min( cnt-i, FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ );
 
     /* Decompress (and validate) points */
     for( ulong j=0UL; j<batch_cnt; j++ ) {
@@ -336,7 +338,8 @@ multi_scalar_mul_ristretto( fd_ristretto255_point_t * r,
   return r;
 }
 
-#undef BATCH_MAX
+FD_STATIC_ASSERT( FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ*sizeof(fd_ed25519_point_t)+alignof(fd_ed25519_point_t)<=FD_RUNTIME_CURVE25519_MSM_FOOTPRINT, spad );
+FD_STATIC_ASSERT( sizeof(fd_ristretto255_point_t)==sizeof(fd_ed25519_point_t), spad );
 
 int
 fd_vm_syscall_sol_curve_multiscalar_mul( void *  _vm,
@@ -407,12 +410,18 @@ fd_vm_syscall_sol_curve_multiscalar_mul( void *  _vm,
   uchar const * scalars = FD_VM_MEM_HADDR_LD( vm, scalars_addr, FD_VM_ALIGN_RUST_POD_U8_ARRAY, points_len*FD_VM_SYSCALL_SOL_CURVE_CURVE25519_SCALAR_SZ );
   uchar const * points  = FD_VM_MEM_HADDR_LD( vm, points_addr,  FD_VM_ALIGN_RUST_POD_U8_ARRAY, points_len*FD_VM_SYSCALL_SOL_CURVE_CURVE25519_POINT_SZ );
 
+  FD_SPAD_FRAME_BEGIN( vm->instr_ctx->txn_ctx->spad ) {
+
+  /* Decompressed points, see FD_RUNTIME_CURVE25519_MSM_FOOTPRINT */
+  void * A = fd_spad_alloc( vm->instr_ctx->txn_ctx->spad, alignof(fd_ed25519_point_t),
+                            fd_ulong_min( points_len, FD_BALLET_CURVE25519_MSM_PIPPENGER_BATCH_SZ )*sizeof(fd_ed25519_point_t) );
+
   switch( curve_id ) {
 
   case FD_VM_SYSCALL_SOL_CURVE_CURVE25519_EDWARDS: {
     /* https://github.com/anza-xyz/agave/blob/v1.18.8/programs/bpf_loader/src/syscalls/mod.rs#L1180-L1189 */
     fd_ed25519_point_t _r[1];
-    fd_ed25519_point_t * r = multi_scalar_mul_edwards( _r, scalars, points, points_len );
+    fd_ed25519_point_t * r = multi_scalar_mul_edwards( _r, A, scalars, points, points_len );
 
     if( FD_LIKELY( r ) ) {
       uchar * result = FD_VM_MEM_HADDR_ST( vm, result_point_addr, FD_VM_ALIGN_RUST_POD_U8_ARRAY, FD_VM_SYSCALL_SOL_CURVE_CURVE25519_POINT_SZ );
@@ -424,7 +433,7 @@ fd_vm_syscall_sol_curve_multiscalar_mul( void *  _vm,
 
   case FD_VM_SYSCALL_SOL_CURVE_CURVE25519_RISTRETTO: {
     fd_ristretto255_point_t _r[1];
-    fd_ristretto255_point_t * r = multi_scalar_mul_ristretto( _r, scalars, points, points_len );
+    fd_ristretto255_point_t * r = multi_scalar_mul_ristretto( _r, A, scalars, points, points_len );
 
     if( FD_LIKELY( r ) ) {
       uchar * result = FD_VM_MEM_HADDR_ST( vm, result_point_addr, FD_VM_ALIGN_RUST_POD_U8_ARRAY, FD_VM_SYSCALL_SOL_CURVE_CURVE25519_POINT_SZ );
@@ -439,6 +448,8 @@ fd_vm_syscall_sol_curve_multiscalar_mul( void *  _vm,
     return FD_VM_SYSCALL_ERR_INVALID_ATTRIBUTE; /* SyscallError::InvalidAttribute */
   }
 
+  } FD_SPAD_FRAME_END;
+
 soft_error:
   *_ret = ret;
   return FD_VM_SUCCESS;
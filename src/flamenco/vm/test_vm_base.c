@@ -328,6 +328,54 @@ vm_trace_done:
   FD_TEST( !fd_vm_trace_join  ( _trace ) ); /* not a trace */
   FD_TEST( !fd_vm_trace_delete( _trace ) ); /* not a trace */
 
+  FD_LOG_NOTICE(( "Testing input region dirty tracking" ));
+
+  FD_TEST( fd_vm_input_dirty_word_cnt( 0UL                                )==0UL );
+  FD_TEST( fd_vm_input_dirty_word_cnt( 1UL                                )==1UL );
+  FD_TEST( fd_vm_input_dirty_word_cnt( 64UL*FD_VM_INPUT_DIRTY_CHUNK_SZ     )==1UL );
+  FD_TEST( fd_vm_input_dirty_word_cnt( 64UL*FD_VM_INPUT_DIRTY_CHUNK_SZ+1UL )==2UL );
+
+  static uchar input[ 200UL*FD_VM_INPUT_DIRTY_CHUNK_SZ ];
+  ulong        dirty[ 4 ];
+  FD_TEST( fd_vm_input_dirty_word_cnt( sizeof(input) )<=4UL );
+
+  static fd_vm_t dirty_vm[1];
+  fd_vm_input_region_t region[1] = {{ .vaddr_offset = 0UL, .haddr = (ulong)input, .region_sz = (uint)sizeof(input), .is_writable = 1U }};
+  dirty_vm->input_mem_regions     = region;
+  dirty_vm->input_mem_regions_cnt = 1U;
+  dirty_vm->input_dirty           = dirty;
+
+  for( ulong iter=0UL; iter<100000UL; iter++ ) {
+    memset( dirty, 0, sizeof(dirty) );
+    ulong off = fd_rng_ulong_roll( rng, sizeof(input) );
+    ulong sz  = fd_rng_ulong_roll( rng, fd_ulong_min( sizeof(input)-off, 4UL*FD_VM_INPUT_DIRTY_CHUNK_SZ )+1UL );
+    int   wr  = (int)(fd_rng_uint( rng ) & 1U);
+
+    uchar is_multi = 0;
+    ulong haddr = fd_vm_find_input_mem_region( dirty_vm, off, sz, (uchar)wr, 0UL, &is_multi );
+    FD_TEST( haddr==(ulong)input+off );
+
+    /* Only successful write translations dirty the range, and exactly
+       the chunks overlapping it */
+    ulong t_off = fd_rng_ulong_roll( rng, sizeof(input) );
+    ulong t_sz  = fd_rng_ulong_roll( rng, sizeof(input)-t_off+1UL );
+    int   chunk_overlap = wr && sz && t_sz &&
+                          (t_off>>FD_VM_INPUT_DIRTY_LG_CHUNK_SZ)<=((off+sz-1UL)>>FD_VM_INPUT_DIRTY_LG_CHUNK_SZ) &&
+                          (off  >>FD_VM_INPUT_DIRTY_LG_CHUNK_SZ)<=((t_off+t_sz-1UL)>>FD_VM_INPUT_DIRTY_LG_CHUNK_SZ);
+    FD_TEST( fd_vm_input_dirty_test( dirty, t_off, t_sz )==chunk_overlap );
+    if( wr && sz ) FD_TEST( fd_vm_input_dirty_test( dirty, off, sz ) );
+  }
+
+  /* Out of bounds writes fail and don't mark anything */
+  memset( dirty, 0, sizeof(dirty) );
+  uchar is_multi = 0;
+  FD_TEST( !fd_vm_find_input_mem_region( dirty_vm, sizeof(input)-8UL, 16UL, 1, 0UL, &is_multi ) );
+  FD_TEST( !fd_vm_input_dirty_test( dirty, 0UL, sizeof(input) ) );
+
+  /* A NULL bitmap is always dirty */
+  FD_TEST(  fd_vm_input_dirty_test( NULL,  0UL, 1UL ) );
+  FD_TEST( !fd_vm_input_dirty_test( dirty, 0UL, 0UL ) );
+
   fd_rng_delete( fd_rng_leave( rng ) );
 
   FD_LOG_NOTICE(( "pass" ));
@@ -81,6 +81,26 @@ test_program_success( char *                test_case_name,
 //FD_LOG_NOTICE(( "Instr counter: %lu", vm.ic ));
   FD_TEST( vm->reg[0]==expected_result );
   FD_LOG_NOTICE(( "%-20s %11li ns", test_case_name, dt ));
+
+  /* Rerun from the pre-decoded text and check it ends in exactly the
+     same state (skipped for the huge benchmark programs) */
+
+  if( text_cnt<=(1UL<<20) ) {
+    ulong pc = vm->pc; ulong ic = vm->ic; ulong cu = vm->cu; ulong ret = vm->reg[0];
+
+    fd_vm_pinstr_t * ptext = aligned_alloc( FD_VM_PINSTR_ALIGN, fd_ulong_align_up( fd_vm_predecode_footprint( text_cnt ), FD_VM_PINSTR_ALIGN ) );
+    FD_TEST( fd_vm_predecode( ptext, text, text_cnt )==ptext );
+    FD_TEST( !fd_vm_setup_state_for_execution( vm ) );
+    vm->ptext = ptext;
+
+    dt = -fd_log_wallclock();
+    int perr = fd_vm_exec( vm );
+    dt += fd_log_wallclock();
+
+    FD_TEST( perr==err && vm->reg[0]==ret && vm->pc==pc && vm->ic==ic && vm->cu==cu );
+    FD_LOG_NOTICE(( "%-20s %11li ns (predecoded)", test_case_name, dt ));
+    free( ptext );
+  }
 //FD_LOG_NOTICE(( "Time/Instr: %f ns", (double)dt / (double)vm.ic ));
 //FD_LOG_NOTICE(( "Mega Instr/Sec: %f", 1000.0 * ((double)vm.ic / (double) dt)));
 }
@@ -290,6 +310,140 @@ test_0cu_exit( void ) {
   fd_sha256_delete( fd_sha256_leave( sha ) );
 }
 
+/* test_predecode_run runs text from a clean vm state, from the raw
+   text if ptext is NULL and from the pre-decoded text otherwise.  If
+   prof is non-NULL, the run is also sampled into prof. */
+
+static int
+test_predecode_run( fd_vm_t *              vm,
+                    ulong const *          text,
+                    ulong                  text_cnt,
+                    fd_vm_pinstr_t const * ptext,
+                    fd_vm_prof_prog_t *    prof,
+                    ulong                  entry_pc,
+                    ulong                  entry_cu,
+                    ulong                  sbpf_version,
+                    fd_sbpf_syscalls_t *   syscalls,
+                    fd_exec_instr_ctx_t *  instr_ctx,
+                    fd_sha256_t *          sha ) {
+  FD_TEST( fd_vm_init(
+      /* vm               */ vm,
+      /* instr_ctx        */ instr_ctx,
+      /* heap_max         */ FD_VM_HEAP_DEFAULT,
+      /* entry_cu         */ entry_cu,
+      /* rodata           */ (uchar *)text,
+      /* rodata_sz        */ 8UL*text_cnt,
+      /* text             */ text,
+      /* text_cnt         */ text_cnt,
+      /* text_off         */ 0UL,
+      /* text_sz          */ 8UL*text_cnt,
+      /* entry_pc         */ entry_pc,
+      /* calldests        */ NULL,
+      /* sbpf_version     */ sbpf_version,
+      /* syscalls         */ syscalls,
+      /* trace            */ NULL,
+      /* sha              */ sha,
+      /* mem_regions      */ NULL,
+      /* mem_regions_cnt  */ 0UL,
+      /* mem_regions_accs */ NULL,
+      /* is_deprecated    */ 0,
+      /* direct mapping   */ 0 ) );
+  fd_memset( vm->stack, 0, FD_VM_STACK_MAX );
+  fd_memset( vm->heap,  0, FD_VM_HEAP_MAX  );
+  vm->ptext = ptext;
+  vm->prof  = prof;
+  return fd_vm_exec( vm );
+}
+
+/* test_predecode checks fd_vm_exec_predecoded matches
+   fd_vm_exec_notrace on random programs dense in fusable pairs,
+   branches (including out of the text and into the middle of LDDWs),
+   LDDWs, stack accesses, division faults and syscalls, under compute
+   budgets tight enough that many runs end in SIGCOST mid pair.  Half
+   of the pre-decoded runs are profiled (sampling at nearly every
+   branch) to check that profiling does not change execution either. */
+
+static void
+test_predecode( fd_rng_t *            rng,
+                fd_sbpf_syscalls_t *  syscalls,
+                fd_exec_instr_ctx_t * instr_ctx ) {
+
+  static uchar const opcodes[] = {
+    0xb7, 0xb7, 0xb7, 0xb7, 0x57, 0x57,             /* MOV64_IMM, AND64_IMM */
+    0x0f, 0x1f, 0x4f, 0x5f,                         /* ADD64_REG, SUB64_REG, OR64_REG, AND64_REG */
+    0x1d, 0x2d, 0x3d, 0x5d, 0xad, 0xbd, 0x15, 0x55, /* Jcc */
+    0x05, 0x07, 0xbf, 0x3f, 0x9f, 0x18, 0x85, 0x95  /* JA, ADD64_IMM, MOV64_REG, DIV64_REG, MOD64_REG, LDDW, CALL_IMM, EXIT */
+  };
+  ulong const opcode_cnt = sizeof(opcodes);
+
+  fd_sha256_t _sha[1];
+  fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+
+  fd_vm_t * vm = fd_vm_join( fd_vm_new( aligned_alloc( fd_vm_align(), fd_vm_footprint() ) ) );
+  FD_TEST( vm );
+
+  ulong const      text_max = 64UL;
+  ulong            text [ 64 ];
+  fd_vm_pinstr_t * ptext = aligned_alloc( FD_VM_PINSTR_ALIGN, fd_vm_predecode_footprint( text_max ) );
+  ulong            fused_cnt = 0UL;
+
+  fd_vm_prof_t * prof = fd_vm_prof_join( fd_vm_prof_new( aligned_alloc( fd_vm_prof_align(), fd_vm_prof_footprint( 1UL ) ), 1UL, 1UL ) );
+  FD_TEST( prof );
+  fd_pubkey_t prof_id = { .ul = { 1UL, 2UL, 3UL, 4UL } };
+  fd_vm_prof_prog_t * prof_prog = fd_vm_prof_prog_acquire( prof, &prof_id );
+  FD_TEST( prof_prog );
+
+  uint accumulator = fd_murmur3_32( "accumulator", 11UL, 0U );
+
+  for( ulong iter=0UL; iter<100000UL; iter++ ) {
+    ulong text_cnt = 2UL + fd_rng_ulong_roll( rng, text_max-1UL );
+    for( ulong i=0UL; i<text_cnt; i++ ) {
+      ulong opcode = opcodes[ fd_rng_ulong_roll( rng, opcode_cnt ) ];
+      ulong dst    = fd_rng_ulong_roll( rng, 10UL );
+      ulong src    = fd_rng_ulong_roll( rng, 11UL );
+      short off    = (short)( (long)fd_rng_ulong_roll( rng, 2UL*text_cnt+2UL ) - (long)text_cnt - 1L );
+      uint  imm    = fd_rng_uint_roll( rng, 8U );
+      if( fd_rng_uint_roll( rng, 4U )==0U ) imm = fd_rng_uint( rng );
+      if( opcode==0x85UL ) imm = accumulator;
+      if( opcode==0x18UL && i+1UL<text_cnt ) {
+        text[ i     ] = fd_vm_instr( opcode, dst, 0UL, 0, imm );
+        text[ i+1UL ] = fd_vm_instr( 0UL,    0UL, 0UL, 0, fd_rng_uint( rng ) );
+        i++;
+        continue;
+      }
+      if( opcode==0x18UL ) opcode = 0x95UL;
+      text[ i ] = fd_vm_instr( opcode, dst, src, off, imm );
+    }
+
+    FD_TEST( fd_vm_predecode( ptext, text, text_cnt )==ptext );
+    for( ulong i=0UL; i<text_cnt; i++ ) fused_cnt += (ulong)( ptext[ i ].op>=256 );
+
+    ulong entry_pc = fd_rng_uint_roll( rng, 4U )==0U ? fd_rng_ulong_roll( rng, text_cnt ) : 0UL;
+    ulong entry_cu = 1UL + fd_rng_ulong_roll( rng, 4UL*text_cnt );
+
+    ulong sbpf_version = fd_rng_uint_roll( rng, 2U ) ? FD_SBPF_V0 : FD_SBPF_V2;
+
+    int   err0 = test_predecode_run( vm, text, text_cnt, NULL,  NULL,                        entry_pc, entry_cu, sbpf_version, syscalls, instr_ctx, sha );
+    ulong reg0[ FD_VM_REG_CNT ]; fd_memcpy( reg0, vm->reg, sizeof(reg0) );
+    ulong pc0 = vm->pc; ulong ic0 = vm->ic; ulong cu0 = vm->cu; ulong frame_cnt0 = vm->frame_cnt;
+
+    int   err1 = test_predecode_run( vm, text, text_cnt, ptext, iter&1UL ? prof_prog : NULL, entry_pc, entry_cu, sbpf_version, syscalls, instr_ctx, sha );
+
+    if( FD_UNLIKELY( err0!=err1 || memcmp( reg0, vm->reg, sizeof(reg0) ) || pc0!=vm->pc || ic0!=vm->ic || cu0!=vm->cu ||
+                     frame_cnt0!=vm->frame_cnt ) ) {
+      FD_LOG_ERR(( "iter %lu: raw err %i pc %lu ic %lu cu %lu, predecoded err %i pc %lu ic %lu cu %lu",
+                   iter, err0, pc0, ic0, cu0, err1, vm->pc, vm->ic, vm->cu ));
+    }
+  }
+  FD_TEST( fused_cnt );
+  FD_TEST( prof_prog->sample_cnt );
+
+  free( fd_vm_prof_delete( fd_vm_prof_leave( prof ) ) );
+  free( ptext );
+  free( fd_vm_delete( fd_vm_leave( vm ) ) );
+  fd_sha256_delete( fd_sha256_leave( sha ) );
+}
+
 static void
 test_static_syscalls_list( void ) {
   const char *static_syscalls_from_simd[] = {
@@ -1006,6 +1160,7 @@ main( int     argc,
   test_program_success( "alu64_bench_short", 0x0, text, text_cnt, syscalls, instr_ctx );
 
   test_0cu_exit();
+  test_predecode( rng, syscalls, instr_ctx );
 
   free( text );
 
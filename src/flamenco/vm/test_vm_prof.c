@@ -0,0 +1,138 @@
+#include "fd_vm_base.h"
+
+static uchar _prof[ 1UL<<20 ] __attribute__((aligned(FD_VM_PROF_ALIGN)));
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong prog_max = 16UL;
+  FD_TEST( fd_vm_prof_align()==FD_VM_PROF_ALIGN );
+  FD_TEST( !fd_vm_prof_footprint( 0UL  ) );
+  FD_TEST( !fd_vm_prof_footprint( 12UL ) );
+  ulong footprint = fd_vm_prof_footprint( prog_max );
+  FD_TEST( footprint && footprint<=sizeof(_prof) );
+
+  FD_TEST( !fd_vm_prof_new( NULL,        prog_max, 64UL ) );
+  FD_TEST( !fd_vm_prof_new( _prof+1,     prog_max, 64UL ) );
+  FD_TEST( !fd_vm_prof_new( _prof,       3UL,      64UL ) );
+  FD_TEST( !fd_vm_prof_new( _prof,       prog_max, 0UL  ) );
+  FD_TEST( !fd_vm_prof_new( _prof,       prog_max, 48UL ) );
+  FD_TEST( !fd_vm_prof_join( _prof ) ); /* not yet formatted */
+
+  fd_vm_prof_t * prof = fd_vm_prof_join( fd_vm_prof_new( _prof, prog_max, 64UL ) );
+  FD_TEST( prof );
+
+  /* Acquire returns the same entry for the same program id and claims
+     distinct entries for distinct ones */
+
+  fd_pubkey_t id[ 17 ];
+  for( ulong i=0UL; i<17UL; i++ ) {
+    fd_memset( id+i, 0, sizeof(fd_pubkey_t) );
+    id[ i ].ul[ 0 ] = i+1UL;
+  }
+
+  fd_vm_prof_prog_t * prog[ 16 ];
+  for( ulong i=0UL; i<16UL; i++ ) {
+    prog[ i ] = fd_vm_prof_prog_acquire( prof, id+i );
+    FD_TEST( prog[ i ] );
+    FD_TEST( prog[ i ]->state==FD_VM_PROF_PROG_STATE_VALID );
+    FD_TEST( !memcmp( prog[ i ]->id.uc, id[ i ].uc, sizeof(fd_pubkey_t) ) );
+    FD_TEST( prog[ i ]->sample_period==64UL );
+    for( ulong j=0UL; j<i; j++ ) FD_TEST( prog[ i ]!=prog[ j ] );
+  }
+  for( ulong i=0UL; i<16UL; i++ ) FD_TEST( fd_vm_prof_prog_acquire( prof, id+i )==prog[ i ] );
+
+  /* Record invocations and check the histograms */
+
+  fd_vm_prof_record( prog[ 3 ], 5000UL, 20000UL );
+  fd_vm_prof_record( prog[ 3 ], 50UL,   200UL   );
+  fd_vm_prof_record( prog[ 7 ], 9000UL, 1UL     );
+  fd_vm_prof_record( prog[ 1 ], 1000UL, 1UL     );
+
+  FD_TEST( prog[ 3 ]->invoke_cnt==2UL );
+  FD_TEST( fd_histf_sum( prog[ 3 ]->cu_hist    )==5050UL  );
+  FD_TEST( fd_histf_sum( prog[ 3 ]->ticks_hist )==20200UL );
+
+  fd_histf_t ref[1];
+  FD_TEST( fd_histf_new( ref, FD_VM_PROF_CU_HIST_MIN, FD_VM_PROF_CU_HIST_MAX ) );
+  fd_histf_sample( ref, 5000UL );
+  fd_histf_sample( ref, 50UL   );
+  for( ulong b=0UL; b<FD_HISTF_BUCKET_CNT; b++ ) FD_TEST( fd_histf_cnt( prog[ 3 ]->cu_hist, b )==fd_histf_cnt( ref, b ) );
+
+  /* Top programs are ordered by compute units */
+
+  ulong top[ 16 ];
+  FD_TEST( fd_vm_prof_top( prof, top, 16UL )==16UL );
+  FD_TEST( fd_vm_prof_prog( prof )+top[ 0 ]==prog[ 7 ] );
+  FD_TEST( fd_vm_prof_prog( prof )+top[ 1 ]==prog[ 3 ] );
+  FD_TEST( fd_vm_prof_prog( prof )+top[ 2 ]==prog[ 1 ] );
+  FD_TEST( fd_vm_prof_top( prof, top, 2UL )==2UL );
+  FD_TEST( fd_vm_prof_prog( prof )+top[ 0 ]==prog[ 7 ] );
+  FD_TEST( fd_vm_prof_prog( prof )+top[ 1 ]==prog[ 3 ] );
+  FD_TEST( !fd_vm_prof_top( prof, top, 0UL ) );
+
+  /* Once the table is full, a new program evicts the one that consumed
+     the fewest compute units and starts from clean counters */
+
+  for( ulong i=0UL; i<16UL; i++ ) {
+    if( i!=2UL ) fd_vm_prof_record( prog[ i ], 10000UL+i, 1UL );
+  }
+  fd_vm_prof_sample( prog[ 2 ], 42UL, 0UL );
+  FD_TEST( !prof->prog_evict_cnt );
+  FD_TEST( fd_vm_prof_prog_acquire( prof, id+16 )==prog[ 2 ] );
+  FD_TEST( prof->prog_evict_cnt==1UL && !prof->prog_drop_cnt );
+  FD_TEST( !memcmp( prog[ 2 ]->id.uc, id[ 16 ].uc, sizeof(fd_pubkey_t) ) );
+  FD_TEST( prog[ 2 ]->state==FD_VM_PROF_PROG_STATE_VALID );
+  FD_TEST( !prog[ 2 ]->invoke_cnt && !prog[ 2 ]->sample_cnt && !fd_histf_sum( prog[ 2 ]->cu_hist ) );
+  for( ulong i=0UL; i<FD_VM_PROF_PC_MAX; i++ ) FD_TEST( !prog[ 2 ]->pc[ i ].pc );
+  for( ulong i=0UL; i<16UL; i++ ) {
+    if( i!=2UL ) FD_TEST( fd_vm_prof_prog_acquire( prof, id+i )==prog[ i ] );
+  }
+  FD_TEST( fd_vm_prof_prog_acquire( prof, id+16 )==prog[ 2 ] );
+  FD_TEST( prof->prog_evict_cnt==1UL );
+
+  /* Samples are counted per pc and the next sample is scheduled within
+     twice the period */
+
+  for( ulong i=0UL; i<1000UL; i++ ) {
+    ulong ic   = 1000000UL*i;
+    ulong next = fd_vm_prof_sample( prog[ 5 ], i%10UL, ic );
+    FD_TEST( next>ic && next<=ic+2UL*64UL );
+  }
+  FD_TEST( prog[ 5 ]->sample_cnt==1000UL );
+  FD_TEST( !prog[ 5 ]->sample_drop_cnt );
+  ulong pc_cnt = 0UL;
+  for( ulong i=0UL; i<FD_VM_PROF_PC_MAX; i++ ) {
+    if( !prog[ 5 ]->pc[ i ].pc ) continue;
+    FD_TEST( prog[ 5 ]->pc[ i ].pc<=10UL );
+    FD_TEST( prog[ 5 ]->pc[ i ].cnt==100UL );
+    pc_cnt++;
+  }
+  FD_TEST( pc_cnt==10UL );
+
+  /* Once the pc table is full, cold pcs are evicted and their samples
+     counted as dropped, while hot pcs stay */
+
+  for( ulong i=0UL; i<100UL; i++ ) fd_vm_prof_sample( prog[ 6 ], 7UL, 0UL );
+  for( ulong i=0UL; i<4UL*FD_VM_PROF_PC_MAX; i++ ) fd_vm_prof_sample( prog[ 6 ], 1000UL+i, 0UL );
+  FD_TEST( prog[ 6 ]->sample_cnt==100UL+4UL*FD_VM_PROF_PC_MAX );
+  FD_TEST( prog[ 6 ]->sample_drop_cnt>=2UL*FD_VM_PROF_PC_MAX );
+  ulong cnt_sum = 0UL;
+  ulong hot_cnt = 0UL;
+  for( ulong i=0UL; i<FD_VM_PROF_PC_MAX; i++ ) {
+    cnt_sum += prog[ 6 ]->pc[ i ].cnt;
+    if( prog[ 6 ]->pc[ i ].pc==8UL ) hot_cnt = prog[ 6 ]->pc[ i ].cnt;
+  }
+  FD_TEST( hot_cnt==100UL );
+  FD_TEST( cnt_sum+prog[ 6 ]->sample_drop_cnt==prog[ 6 ]->sample_cnt );
+
+  FD_TEST( fd_vm_prof_leave( prof )==_prof );
+  FD_TEST( fd_vm_prof_delete( _prof )==_prof );
+  FD_TEST( !fd_vm_prof_join( _prof ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
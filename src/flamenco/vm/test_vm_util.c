@@ -2,6 +2,7 @@
 #include "../runtime/context/fd_exec_epoch_ctx.h"
 #include "../runtime/context/fd_exec_slot_ctx.h"
 #include "../runtime/context/fd_exec_txn_ctx.h"
+#include "../runtime/fd_runtime.h"
 
 /* Generates a minimal instruction context to supply to fd_vm_t.
    For now, we just need to setup feature flags. */
@@ -24,10 +25,15 @@ test_vm_minimal_exec_instr_ctx(
   fd_exec_epoch_ctx_t * epoch_ctx = fd_valloc_malloc( valloc, fd_exec_epoch_ctx_align(), sizeof(fd_exec_epoch_ctx_t) );
   fd_exec_txn_ctx_t *   txn_ctx   = fd_valloc_malloc( valloc, FD_EXEC_TXN_CTX_ALIGN,     FD_EXEC_TXN_CTX_FOOTPRINT );
 
-  if ( !epoch_ctx || !slot_ctx || !txn_ctx ) {
+  /* Only sized for the syscalls exercised by the vm tests */
+  void *                spad_mem  = fd_valloc_malloc( valloc, fd_spad_align(), fd_spad_footprint( FD_RUNTIME_CURVE25519_MSM_FOOTPRINT ) );
+
+  if ( !epoch_ctx || !slot_ctx || !txn_ctx || !spad_mem ) {
     return NULL;
   }
 
+  txn_ctx->spad = fd_spad_join( fd_spad_new( spad_mem, FD_RUNTIME_CURVE25519_MSM_FOOTPRINT ) );
+
   ctx->epoch_ctx = epoch_ctx; /* technically not necessary, given how FEATURE_ACTIVE macro works */
   ctx->slot_ctx  = slot_ctx;
   ctx->txn_ctx   = txn_ctx;
@@ -54,6 +60,7 @@ test_vm_exec_instr_ctx_delete(
 
   fd_exec_instr_ctx_delete( fd_exec_instr_ctx_leave( ctx ) );
 
+  fd_valloc_free( valloc, fd_spad_delete( fd_spad_leave( txn_ctx->spad ) ) );
   fd_valloc_free( valloc, txn_ctx );
   fd_valloc_free( valloc, epoch_ctx );
   fd_valloc_free( valloc, slot_ctx );
@@ -0,0 +1,192 @@
+#include "fd_tango.h"
+
+#if FD_HAS_HOSTED && FD_HAS_ATOMIC
+
+/* bench_mcache_mp compares two ways of fanning in many sparse producers
+   (e.g. verify tiles) into a single consumer (e.g. a dedup tile):
+
+   - spsc: each producer has its own mcache and fseq, and the consumer
+     polls them round robin.
+
+   - mpsc: all producers share one mcache (see fd_mcache_mp.h) and the
+     consumer returns credits through a single fseq.
+
+   Every producer tile publishes --frag-cnt frags, one every --gap-ns
+   ns, stamping each with the tickcount at publication.  The consumer
+   (tile 0) reports the average and worst publish to consume latency
+   and the aggregate throughput. */
+
+#define DEPTH (1024UL)
+
+static uchar __attribute__((aligned(FD_MCACHE_ALIGN))) mcache_mem[ FD_TILE_MAX ][ FD_MCACHE_FOOTPRINT( DEPTH, 0UL ) ];
+static uchar __attribute__((aligned(FD_FSEQ_ALIGN  ))) fseq_mem  [ FD_TILE_MAX ][ FD_FSEQ_FOOTPRINT                ];
+
+static fd_frag_meta_t * _mcache[ FD_TILE_MAX ];
+static ulong *          _fseq  [ FD_TILE_MAX ];
+static int              _mp;
+static ulong            _frag_cnt;
+static long             _gap;
+static int              _go;
+
+static int
+tx_main( int     argc,
+         char ** argv ) {
+  (void)argc; (void)argv;
+
+  ulong tile_idx = fd_tile_idx();
+  int   mp       = FD_VOLATILE_CONST( _mp       );
+  ulong frag_cnt = FD_VOLATILE_CONST( _frag_cnt );
+  long  gap      = FD_VOLATILE_CONST( _gap      );
+
+  ulong            link    = mp ? 0UL : tile_idx;
+  fd_frag_meta_t * mcache  = FD_VOLATILE_CONST( _mcache[ link ] );
+  ulong *          fseq    = FD_VOLATILE_CONST( _fseq  [ link ] );
+  ulong            depth   = fd_mcache_depth( mcache );
+  ulong *          reserve = fd_mcache_mp_reserve_laddr( mcache );
+  ulong            seq     = fd_mcache_seq0( mcache );
+  ulong            ctl     = fd_frag_meta_ctl( tile_idx, 1, 1, 0 );
+
+  while( !FD_VOLATILE_CONST( _go ) ) FD_SPIN_PAUSE();
+
+  long next = fd_tickcount();
+  for( ulong frag_idx=0UL; frag_idx<frag_cnt; frag_idx++ ) {
+    while( fd_tickcount()<next ) FD_SPIN_PAUSE();
+    next += gap;
+
+    if( mp ) {
+      while( !fd_mcache_mp_cr_query( reserve, fseq, depth ) ) FD_SPIN_PAUSE();
+      seq = fd_mcache_mp_reserve( reserve, 1UL );
+      fd_mcache_mp_wait( fseq, depth, seq );
+    } else {
+      while( fd_seq_diff( seq, fd_fseq_query( fseq ) )>=(long)depth ) FD_SPIN_PAUSE();
+    }
+
+    ulong tspub = fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_mcache_publish( mcache, depth, seq, frag_idx, 0UL, 0UL, ctl, tspub, tspub );
+    seq = fd_seq_inc( seq, 1UL );
+  }
+
+  return 0;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong  frag_cnt = fd_env_strip_cmdline_ulong ( &argc, &argv, "--frag-cnt", NULL, 100000UL );
+  float  gap_ns   = fd_env_strip_cmdline_float ( &argc, &argv, "--gap-ns",   NULL,  1000.f  );
+  int    mode     = fd_env_strip_cmdline_int   ( &argc, &argv, "--mp",       NULL,     -1   );
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) FD_LOG_ERR(( "this benchmark requires at least 2 tiles" ));
+  ulong tx_cnt = tile_cnt-1UL;
+
+  double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+  long   gap         = (long)((double)gap_ns*tick_per_ns);
+
+  /* --mp 0 benches only the spsc fan in, --mp 1 only the mpsc fan in
+     and the default benches both */
+
+  for( int mp=0; mp<2; mp++ ) {
+    if( (mode>=0) && (mp!=!!mode) ) continue;
+
+    FD_LOG_NOTICE(( "Benchmarking %s fan in of %lu producers with --frag-cnt %lu --gap-ns %g",
+                    mp ? "mpsc" : "spsc", tx_cnt, frag_cnt, (double)gap_ns ));
+
+    ulong link_cnt = mp ? 1UL : tile_cnt;
+    for( ulong link=mp ? 0UL : 1UL; link<link_cnt; link++ ) {
+      _mcache[ link ] = fd_mcache_join( fd_mcache_new( mcache_mem[ link ], DEPTH, 0UL, 0UL ) );
+      _fseq  [ link ] = fd_fseq_join  ( fd_fseq_new  ( fseq_mem  [ link ], 0UL             ) );
+      if( FD_UNLIKELY( !_mcache[ link ] || !_fseq[ link ] ) ) FD_LOG_ERR(( "mcache / fseq creation failed" ));
+    }
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( _go       ) = 0;
+    FD_VOLATILE( _mp       ) = mp;
+    FD_VOLATILE( _frag_cnt ) = frag_cnt;
+    FD_VOLATILE( _gap      ) = gap;
+    FD_COMPILER_MFENCE();
+
+    fd_tile_exec_t * exec[ FD_TILE_MAX ];
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) exec[ tile_idx ] = fd_tile_exec_new( tile_idx, tx_main, 0, NULL );
+
+    fd_log_sleep( (long)1e8 );
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( _go ) = 1;
+    FD_COMPILER_MFENCE();
+
+    ulong seq[ FD_TILE_MAX ] = {0};
+    ulong rem_cnt  = tx_cnt*frag_cnt;
+    ulong poll_cnt = 0UL;
+    long  lat_sum  = 0L;
+    long  lat_max  = 0L;
+    ulong link     = mp ? 0UL : 1UL;
+
+    long dt = -fd_log_wallclock();
+
+    while( rem_cnt ) {
+      fd_frag_meta_t * mcache = _mcache[ link ];
+
+      fd_frag_meta_t         meta[1];
+      fd_frag_meta_t const * mline;
+      ulong                  seq_found;
+      long                   seq_diff;
+      ulong                  poll_max = 1UL;
+      FD_MCACHE_WAIT( meta, mline, seq_found, seq_diff, poll_max, mcache, DEPTH, seq[ link ] );
+      (void)mline; (void)seq_found; (void)poll_max;
+      poll_cnt++;
+
+      if( FD_LIKELY( !seq_diff ) ) {
+        long now = fd_tickcount();
+        long lat = now - fd_frag_meta_ts_decomp( meta->tspub, now );
+        lat_sum += lat;
+        lat_max  = fd_long_max( lat_max, lat );
+
+        seq[ link ] = fd_seq_inc( seq[ link ], 1UL );
+        if( FD_UNLIKELY( !(seq[ link ] & 15UL) ) ) fd_fseq_update( _fseq[ link ], seq[ link ] );
+        rem_cnt--;
+        if( mp ) continue;
+      } else if( FD_UNLIKELY( seq_diff>0L ) ) {
+        FD_LOG_ERR(( "FAIL: overrun" ));
+      }
+
+      if( !mp ) link = fd_ulong_if( link+1UL<tile_cnt, link+1UL, 1UL );
+    }
+
+    dt += fd_log_wallclock();
+
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) fd_tile_exec_delete( exec[ tile_idx ], NULL );
+
+    double frag_tot = (double)(tx_cnt*frag_cnt);
+    FD_LOG_NOTICE(( "%s: %.3f Mfrag/s, %.2f polls/frag, latency avg %.1f ns, max %.1f ns",
+                    mp ? "mpsc" : "spsc",
+                    frag_tot / (double)dt * 1e3,
+                    (double)poll_cnt / frag_tot,
+                    (double)lat_sum / frag_tot / tick_per_ns,
+                    (double)lat_max / tick_per_ns ));
+
+    for( ulong l=mp ? 0UL : 1UL; l<link_cnt; l++ ) {
+      fd_fseq_delete  ( fd_fseq_leave  ( _fseq  [ l ] ) );
+      fd_mcache_delete( fd_mcache_leave( _mcache[ l ] ) );
+    }
+  }
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_ATOMIC capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include "fseq/fd_fseq.h"     /* Includes fd_tango_base.h */
 #include "fctl/fd_fctl.h"     /* Includes fd_tango_base.h */
 #include "mcache/fd_mcache.h" /* Includes fd_tango_base.h */
+#include "mcache/fd_mcache_mp.h" /* Includes fd_mcache.h */
 #include "dcache/fd_dcache.h" /* Includes fd_tango_base.h */
 #include "tcache/fd_tcache.h" /* Includes fd_tango_base.h */
 
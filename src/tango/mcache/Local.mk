@@ -1,5 +1,7 @@
-$(call add-hdrs,fd_mcache.h)
+$(call add-hdrs,fd_mcache.h fd_mcache_mp.h)
 $(call add-objs,fd_mcache,fd_tango)
 $(call make-unit-test,test_mcache,test_mcache,fd_tango fd_util)
 $(call run-unit-test,test_mcache,)
+$(call make-unit-test,test_mcache_mp,test_mcache_mp,fd_tango fd_util)
+$(call run-unit-test,test_mcache_mp,)
 
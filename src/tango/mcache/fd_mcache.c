@@ -1,4 +1,5 @@
 #include "fd_mcache_private.h"
+#include "fd_mcache_mp.h"
 
 ulong
 fd_mcache_align( void ) {
@@ -58,6 +59,7 @@ fd_mcache_new( void * shmem,
   hdr->app_off  = sizeof(fd_mcache_private_hdr_t) + fd_ulong_align_up( depth*sizeof(fd_frag_meta_t), FD_MCACHE_ALIGN );
 
   hdr->seq[0] = seq0;
+  hdr->seq[ FD_MCACHE_SEQ_MP_RESERVE ] = seq0; /* see fd_mcache_mp.h */
 
   fd_frag_meta_t * mcache = fd_mcache_private_mcache( hdr );
 
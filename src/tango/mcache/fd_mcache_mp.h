@@ -0,0 +1,126 @@
+#ifndef HEADER_fd_src_tango_mcache_fd_mcache_mp_h
+#define HEADER_fd_src_tango_mcache_fd_mcache_mp_h
+
+/* fd_mcache_mp provides APIs for multiple producers to publish into a
+   single mcache (multi-producer single-consumer fan-in).
+
+   The usual way to fan in N producers into a consumer is to give each
+   producer its own mcache and have the consumer poll all N of them in
+   turn.  When the producers are sparse (e.g. 20+ verify tiles into a
+   dedup tile), most polls find nothing and the time to notice a frag
+   grows with N.  With fd_mcache_mp, the producers instead share one
+   mcache:
+
+   - A producer atomically reserves the next sequence number(s) from a
+     reservation cursor shared by all producers, stored in the mcache's
+     seq[FD_MCACHE_SEQ_MP_RESERVE] (on a different cache line than
+     seq[0]).
+
+   - It then waits (typically not at all) until the consumer has freed
+     the line for that sequence number and publishes the frag metadata
+     into it with the regular fd_mcache_publish{,_sse,_avx}.  As each
+     line is published independently, producers can publish their
+     reservations in any order.
+
+   - The consumer is unchanged: it sees one totally ordered stream,
+     reads it with FD_MCACHE_WAIT & co, and returns credits to all
+     producers through a single fseq.  A reserved but not yet published
+     sequence number blocks the consumer until it is published, so a
+     producer must publish every sequence number it reserves promptly
+     (and must not die holding a reservation).
+
+   Each producer keeps its own dcache (or its own region of a shared
+   dcache) for the frag payloads.  As chunk indices are relative to the
+   workspace, the consumer can resolve chunks from any producer as long
+   as all producer dcaches live in the same workspace.  Because there
+   are at most depth frags in flight across all producers, a dcache
+   sized for the mcache depth per producer is sufficient.
+
+   seq[0] is not maintained by the producers, and sequence numbers are
+   allocated in reservation order, so the seq0 of the mcache is the
+   place for the consumer to start.  The origin of a frag (e.g. the
+   producer index) can be encoded in the ctl or sig fields if the
+   consumer needs it. */
+
+#include "fd_mcache.h"
+#include "../fseq/fd_fseq.h"
+
+/* FD_MCACHE_SEQ_MP_RESERVE is the index in the mcache's seq array of
+   the shared reservation cursor.  fd_mcache_new initializes it to seq0.
+   seq[1,FD_MCACHE_SEQ_MP_RESERVE) are on the same cache line as seq[0]
+   and seq(FD_MCACHE_SEQ_MP_RESERVE,FD_MCACHE_SEQ_CNT) are reserved for
+   future use. */
+
+#define FD_MCACHE_SEQ_MP_RESERVE (8UL)
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_mcache_mp_reserve_laddr returns the location in the caller's local
+   address space of the reservation cursor of mcache.  Assumes mcache
+   is a current local join. */
+
+FD_FN_CONST static inline ulong *
+fd_mcache_mp_reserve_laddr( fd_frag_meta_t * mcache ) {
+  return fd_mcache_seq_laddr( mcache ) + FD_MCACHE_SEQ_MP_RESERVE;
+}
+
+/* fd_mcache_mp_reserve atomically reserves cnt consecutive sequence
+   numbers and returns the first one.  _reserve is the mcache's
+   reservation cursor (from fd_mcache_mp_reserve_laddr).  The caller
+   must publish all of [seq,seq+cnt) cyclic. */
+
+#if FD_HAS_ATOMIC
+
+static inline ulong
+fd_mcache_mp_reserve( ulong * _reserve,
+                      ulong   cnt ) {
+  return FD_ATOMIC_FETCH_AND_ADD( _reserve, cnt );
+}
+
+#endif
+
+/* fd_mcache_mp_cr_query returns an estimate of the number of frags the
+   producers can collectively publish without overrunning the consumer
+   whose fseq is _fseq, in [0,depth].  This is racy by nature (other
+   producers can reserve concurrently) so it is meant for coarse
+   backpressure, e.g. to decide whether to take more work in before
+   reserving.  It is still up to fd_mcache_mp_wait to guarantee no
+   overrun. */
+
+static inline ulong
+fd_mcache_mp_cr_query( ulong const * _reserve,
+                       ulong const * _fseq,
+                       ulong         depth ) {
+  FD_COMPILER_MFENCE();
+  ulong reserve = FD_VOLATILE_CONST( *_reserve );
+  FD_COMPILER_MFENCE();
+  ulong fseq    = fd_fseq_query( _fseq );
+  long  cr      = (long)depth - fd_seq_diff( reserve, fseq );
+  return (ulong)fd_long_max( cr, 0L );
+}
+
+/* fd_mcache_mp_ready returns 1 if the line for reserved sequence number
+   seq can be published without overrunning the consumer whose fseq is
+   _fseq (i.e. the consumer has consumed seq-depth) and 0 otherwise. */
+
+static inline int
+fd_mcache_mp_ready( ulong const * _fseq,
+                    ulong         depth,
+                    ulong         seq ) {
+  return fd_seq_lt( seq, fd_seq_inc( fd_fseq_query( _fseq ), depth ) );
+}
+
+/* fd_mcache_mp_wait spins until fd_mcache_mp_ready( _fseq, depth, seq ).
+   This only spins if more than depth frags are in flight, which
+   fd_mcache_mp_cr_query based backpressure makes rare. */
+
+static inline void
+fd_mcache_mp_wait( ulong const * _fseq,
+                   ulong         depth,
+                   ulong         seq ) {
+  while( FD_UNLIKELY( !fd_mcache_mp_ready( _fseq, depth, seq ) ) ) FD_SPIN_PAUSE();
+}
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_tango_mcache_fd_mcache_mp_h */
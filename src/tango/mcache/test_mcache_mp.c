@@ -0,0 +1,200 @@
+#include "../fd_tango.h"
+
+#if FD_HAS_HOSTED && FD_HAS_ATOMIC
+
+FD_STATIC_ASSERT( FD_MCACHE_SEQ_MP_RESERVE< FD_MCACHE_SEQ_CNT, unit_test );
+FD_STATIC_ASSERT( FD_MCACHE_SEQ_MP_RESERVE>=8UL,               unit_test ); /* Not on seq[0]'s cache line */
+
+#define DEPTH (128UL)
+
+static uchar __attribute__((aligned(FD_MCACHE_ALIGN))) mcache_mem[ FD_MCACHE_FOOTPRINT( DEPTH, 0UL ) ];
+static uchar __attribute__((aligned(FD_FSEQ_ALIGN  ))) fseq_mem  [ FD_FSEQ_FOOTPRINT                ];
+
+static fd_frag_meta_t * _mcache;
+static ulong *          _fseq;
+static ulong            _frag_cnt;
+static int              _go;
+
+/* tx_main is run by each producer tile.  It publishes frag_cnt frags
+   whose sig encodes the producer tile and the frag index so the
+   consumer can check per producer ordering. */
+
+static int
+tx_main( int     argc,
+         char ** argv ) {
+  (void)argc; (void)argv;
+
+  ulong            tile_idx = fd_tile_idx();
+  fd_frag_meta_t * mcache   = FD_VOLATILE_CONST( _mcache   );
+  ulong *          fseq     = FD_VOLATILE_CONST( _fseq     );
+  ulong            frag_cnt = FD_VOLATILE_CONST( _frag_cnt );
+  ulong            depth    = fd_mcache_depth( mcache );
+  ulong *          reserve  = fd_mcache_mp_reserve_laddr( mcache );
+
+  while( !FD_VOLATILE_CONST( _go ) ) FD_SPIN_PAUSE();
+
+  for( ulong frag_idx=0UL; frag_idx<frag_cnt; frag_idx++ ) {
+    while( !fd_mcache_mp_cr_query( reserve, fseq, depth ) ) FD_SPIN_PAUSE();
+    ulong seq = fd_mcache_mp_reserve( reserve, 1UL );
+    fd_mcache_mp_wait( fseq, depth, seq );
+    fd_mcache_publish( mcache, depth, seq, (tile_idx<<32) | frag_idx, 0UL, 0UL, fd_frag_meta_ctl( tile_idx, 1, 1, 0 ), 0UL, 0UL );
+  }
+
+  return 0;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong seq0     = fd_env_strip_cmdline_ulong( &argc, &argv, "--seq0",     NULL, 1234567890UL );
+  ulong frag_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--frag-cnt", NULL,     100000UL );
+
+  ulong depth = DEPTH;
+
+  fd_frag_meta_t * mcache = fd_mcache_join( fd_mcache_new( mcache_mem, depth, 0UL, seq0 ) ); FD_TEST( mcache );
+  ulong *          fseq   = fd_fseq_join  ( fd_fseq_new  ( fseq_mem,   seq0             ) ); FD_TEST( fseq   );
+
+  ulong * reserve = fd_mcache_mp_reserve_laddr( mcache );
+  FD_TEST( reserve==fd_mcache_seq_laddr( mcache ) + FD_MCACHE_SEQ_MP_RESERVE );
+  FD_TEST( *reserve==seq0 );
+
+  /* Reservations hand out consecutive sequence numbers */
+
+  FD_TEST( fd_mcache_mp_cr_query( reserve, fseq, depth )==depth );
+  ulong seq_a = fd_mcache_mp_reserve( reserve, 3UL );
+  ulong seq_b = fd_mcache_mp_reserve( reserve, 1UL );
+  FD_TEST( seq_a==seq0 );
+  FD_TEST( seq_b==seq0+3UL );
+  FD_TEST( fd_mcache_mp_cr_query( reserve, fseq, depth )==depth-4UL );
+
+  /* Out of order publication.  The consumer only sees seq0 once it has
+     been published even if later reservations were published first. */
+
+  for( ulong seq=seq0; seq<seq0+4UL; seq++ ) FD_TEST( fd_seq_lt( fd_mcache_query( mcache, depth, seq ), seq ) );
+
+  fd_mcache_publish( mcache, depth, seq_b,     3UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+  fd_mcache_publish( mcache, depth, seq_a+1UL, 1UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+  FD_TEST( fd_seq_lt( fd_mcache_query( mcache, depth, seq0 ), seq0 ) );
+  FD_TEST( fd_mcache_query( mcache, depth, seq0+1UL )==seq0+1UL );
+  FD_TEST( fd_mcache_query( mcache, depth, seq0+3UL )==seq0+3UL );
+
+  fd_mcache_publish( mcache, depth, seq_a,     0UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+  fd_mcache_publish( mcache, depth, seq_a+2UL, 2UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+
+  for( ulong seq=seq0; seq<seq0+4UL; seq++ ) {
+    fd_frag_meta_t         meta[1];
+    fd_frag_meta_t const * mline;
+    ulong                  seq_found;
+    long                   seq_diff;
+    ulong                  poll_max = 1UL;
+    FD_MCACHE_WAIT( meta, mline, seq_found, seq_diff, poll_max, mcache, depth, seq );
+    FD_TEST( !seq_diff );
+    FD_TEST( seq_found==seq );
+    FD_TEST( mline==mcache+fd_mcache_line_idx( seq, depth ) );
+    FD_TEST( meta->sig==seq-seq0 );
+  }
+
+  /* The line for seq0+depth can't be published until the consumer has
+     moved past seq0 */
+
+  FD_TEST(  fd_mcache_mp_ready( fseq, depth, seq0+depth-1UL ) );
+  FD_TEST( !fd_mcache_mp_ready( fseq, depth, seq0+depth     ) );
+  fd_fseq_update( fseq, seq0+1UL );
+  FD_TEST(  fd_mcache_mp_ready( fseq, depth, seq0+depth     ) );
+  FD_TEST( !fd_mcache_mp_ready( fseq, depth, seq0+depth+1UL ) );
+  fd_fseq_update( fseq, seq0+4UL );
+  FD_TEST( fd_mcache_mp_cr_query( reserve, fseq, depth )==depth );
+
+  /* Over reservation clamps the credits to zero */
+
+  fd_mcache_mp_reserve( reserve, depth+1UL );
+  FD_TEST( !fd_mcache_mp_cr_query( reserve, fseq, depth ) );
+
+  FD_TEST( fd_fseq_delete  ( fd_fseq_leave  ( fseq   ) )==fseq_mem   );
+  FD_TEST( fd_mcache_delete( fd_mcache_leave( mcache ) )==mcache_mem );
+
+  /* Concurrent producers */
+
+  ulong tile_cnt = fd_tile_cnt();
+  if( FD_UNLIKELY( tile_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "skip: concurrent test requires at least 2 tiles" ));
+    FD_LOG_NOTICE(( "pass" ));
+    fd_halt();
+    return 0;
+  }
+
+  ulong tx_cnt = tile_cnt-1UL;
+  FD_LOG_NOTICE(( "Testing %lu concurrent producers (--frag-cnt %lu)", tx_cnt, frag_cnt ));
+
+  mcache = fd_mcache_join( fd_mcache_new( mcache_mem, depth, 0UL, seq0 ) ); FD_TEST( mcache );
+  fseq   = fd_fseq_join  ( fd_fseq_new  ( fseq_mem,   seq0             ) ); FD_TEST( fseq   );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( _mcache   ) = mcache;
+  FD_VOLATILE( _fseq     ) = fseq;
+  FD_VOLATILE( _frag_cnt ) = frag_cnt;
+  FD_VOLATILE( _go       ) = 0;
+  FD_COMPILER_MFENCE();
+
+  fd_tile_exec_t * exec[ FD_TILE_MAX ];
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) exec[ tile_idx ] = fd_tile_exec_new( tile_idx, tx_main, 0, NULL );
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( _go ) = 1;
+  FD_COMPILER_MFENCE();
+
+  ulong next[ FD_TILE_MAX ] = {0};
+  ulong seq     = seq0;
+  ulong rem_cnt = tx_cnt*frag_cnt;
+  while( rem_cnt ) {
+    fd_frag_meta_t         meta[1];
+    fd_frag_meta_t const * mline;
+    ulong                  seq_found;
+    long                   seq_diff;
+    ulong                  poll_max = ULONG_MAX;
+    FD_MCACHE_WAIT( meta, mline, seq_found, seq_diff, poll_max, mcache, depth, seq );
+    if( FD_UNLIKELY( seq_diff ) ) FD_LOG_ERR(( "FAIL: overrun at seq %lu (found %lu)", seq, seq_found ));
+    FD_TEST( mline==mcache+fd_mcache_line_idx( seq, depth ) );
+
+    ulong tx_idx   = meta->sig >> 32;
+    ulong frag_idx = meta->sig & 0xffffffffUL;
+    FD_TEST( (1UL<=tx_idx) & (tx_idx<tile_cnt) );
+    FD_TEST( fd_frag_meta_ctl_orig( (ulong)meta->ctl )==tx_idx );
+    FD_TEST( frag_idx==next[ tx_idx ] );
+    next[ tx_idx ]++;
+
+    seq = fd_seq_inc( seq, 1UL );
+    rem_cnt--;
+    if( FD_UNLIKELY( !(seq & 15UL) ) ) fd_fseq_update( fseq, seq );
+  }
+  fd_fseq_update( fseq, seq );
+
+  for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) {
+    fd_tile_exec_delete( exec[ tile_idx ], NULL );
+    FD_TEST( next[ tile_idx ]==frag_cnt );
+  }
+  FD_TEST( *reserve==seq );
+  FD_TEST( fd_seq_lt( fd_mcache_query( mcache, depth, seq ), seq ) );
+
+  FD_TEST( fd_fseq_delete  ( fd_fseq_leave  ( fseq   ) )==fseq_mem   );
+  FD_TEST( fd_mcache_delete( fd_mcache_leave( mcache ) )==mcache_mem );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED and FD_HAS_ATOMIC capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
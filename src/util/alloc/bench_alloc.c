@@ -0,0 +1,204 @@
+#include "../fd_util.h"
+
+#if FD_HAS_HOSTED
+
+/* bench_alloc measures the throughput of small allocations when many
+   tiles concurrently hammer the same fd_alloc, with and without a per
+   tile fd_alloc_cache.  Each tile repeatedly allocates a batch of
+   --batch-cnt blocks with sizes uniform in [1,--sz-max] and then frees
+   them in a random order.  This is representative of replay threads
+   churning through short lived small objects (e.g. decoded instruction
+   and account metadata). */
+
+static int    _go;
+static void * _shalloc;
+static ulong  _iter_cnt;
+static ulong  _batch_cnt;
+static ulong  _sz_max;
+static ulong  _mag_max;
+static int    _cache;
+static long   _dt[ FD_TILE_MAX ];
+
+#define BATCH_MAX (1024UL)
+
+static int
+bench_main( int     argc,
+            char ** argv ) {
+  (void)argc; (void)argv;
+
+  ulong tile_idx = fd_tile_idx();
+
+  void * shalloc   = FD_VOLATILE_CONST( _shalloc   );
+  ulong  iter_cnt  = FD_VOLATILE_CONST( _iter_cnt  );
+  ulong  batch_cnt = FD_VOLATILE_CONST( _batch_cnt );
+  ulong  sz_max    = FD_VOLATILE_CONST( _sz_max    );
+  ulong  mag_max   = FD_VOLATILE_CONST( _mag_max   );
+  int    use_cache = FD_VOLATILE_CONST( _cache     );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, (uint)tile_idx, 0UL ) );
+
+  fd_alloc_t * alloc = fd_alloc_join( shalloc, tile_idx );
+  if( FD_UNLIKELY( !alloc ) ) FD_LOG_ERR(( "fd_alloc_join failed" ));
+
+  fd_alloc_cache_t * cache = NULL;
+  void *             shcmem = NULL;
+  if( use_cache ) {
+    shcmem = fd_wksp_alloc_laddr( fd_alloc_wksp( alloc ), fd_alloc_cache_align(), fd_alloc_cache_footprint(), fd_alloc_tag( alloc )+1UL );
+    if( FD_UNLIKELY( !shcmem ) ) FD_LOG_ERR(( "Unable to allocate wksp memory for fd_alloc_cache" ));
+    cache = fd_alloc_cache_join( fd_alloc_cache_new( shcmem, alloc, mag_max ), alloc );
+    if( FD_UNLIKELY( !cache ) ) FD_LOG_ERR(( "fd_alloc_cache_join failed" ));
+  }
+
+  void * mem[ BATCH_MAX ];
+  ulong  sz [ BATCH_MAX ];
+  for( ulong idx=0UL; idx<batch_cnt; idx++ ) sz[idx] = fd_rng_ulong_roll( rng, sz_max ) + 1UL;
+
+  while( !FD_VOLATILE_CONST( _go ) ) FD_SPIN_PAUSE();
+
+  long dt = -fd_log_wallclock();
+
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+
+    if( use_cache ) {
+      for( ulong idx=0UL; idx<batch_cnt; idx++ ) mem[idx] = fd_alloc_cache_malloc( cache, alloc, 0UL, sz[idx] );
+    } else {
+      for( ulong idx=0UL; idx<batch_cnt; idx++ ) mem[idx] = fd_alloc_malloc( alloc, 0UL, sz[idx] );
+    }
+
+    /* Free in a shuffled order */
+
+    for( ulong idx=batch_cnt-1UL; idx; idx-- ) {
+      ulong  j   = fd_rng_ulong_roll( rng, idx+1UL );
+      void * tmp = mem[idx]; mem[idx] = mem[j]; mem[j] = tmp;
+    }
+
+    if( use_cache ) {
+      for( ulong idx=0UL; idx<batch_cnt; idx++ ) fd_alloc_cache_free( cache, alloc, mem[idx] );
+    } else {
+      for( ulong idx=0UL; idx<batch_cnt; idx++ ) fd_alloc_free( alloc, mem[idx] );
+    }
+  }
+
+  dt += fd_log_wallclock();
+
+  FD_VOLATILE( _dt[ tile_idx ] ) = dt;
+
+  if( use_cache ) {
+    fd_alloc_cache_flush( cache, alloc );
+    fd_wksp_free_laddr( fd_alloc_cache_delete( fd_alloc_cache_leave( cache ) ) );
+  }
+
+  fd_alloc_leave( alloc );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return 0;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * name      = fd_env_strip_cmdline_cstr ( &argc, &argv, "--wksp",      NULL, NULL            );
+  char const * _page_sz  = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",   NULL, "gigantic"      );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt",  NULL, 1UL             );
+  ulong        near_cpu  = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu",  NULL, fd_log_cpu_id() );
+  ulong        tag       = fd_env_strip_cmdline_ulong( &argc, &argv, "--tag",       NULL, 1234UL          );
+  ulong        iter_cnt  = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt",  NULL, 10000UL         );
+  ulong        batch_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--batch-cnt", NULL, 256UL           );
+  ulong        sz_max    = fd_env_strip_cmdline_ulong( &argc, &argv, "--sz-max",    NULL, 256UL           );
+  ulong        mag_max   = fd_env_strip_cmdline_ulong( &argc, &argv, "--mag-max",   NULL, FD_ALLOC_CACHE_MAG_MAX );
+  int          cache     = fd_env_strip_cmdline_int  ( &argc, &argv, "--cache",     NULL, -1              );
+
+  ulong tile_cnt = fd_tile_cnt();
+
+  if( FD_UNLIKELY( !batch_cnt || batch_cnt>BATCH_MAX ) ) FD_LOG_ERR(( "--batch-cnt should be in [1,%lu]", BATCH_MAX ));
+  if( FD_UNLIKELY( !sz_max                           ) ) FD_LOG_ERR(( "--sz-max should be positive" ));
+
+  fd_wksp_t * wksp;
+  if( name ) {
+    FD_LOG_NOTICE(( "Attaching to --wksp %s", name ));
+    wksp = fd_wksp_attach( name );
+  } else {
+    FD_LOG_NOTICE(( "--wksp not specified, using an anonymous local workspace, --page-sz %s, --page-cnt %lu, --near-cpu %lu",
+                    _page_sz, page_cnt, near_cpu ));
+    wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  }
+
+  if( FD_UNLIKELY( !wksp ) ) FD_LOG_ERR(( "Unable to attach to wksp" ));
+
+  void * shmem = fd_wksp_alloc_laddr( wksp, fd_alloc_align(), fd_alloc_footprint(), tag );
+  if( FD_UNLIKELY( !shmem ) ) FD_LOG_ERR(( "Unable to allocate wksp memory for fd_alloc" ));
+
+  void * shalloc = fd_alloc_new( shmem, tag );
+  if( FD_UNLIKELY( !shalloc ) ) FD_LOG_ERR(( "fd_alloc_new failed" ));
+
+  /* --cache 0 benches only the direct path, --cache 1 only the cached
+     path and the default benches both */
+
+  for( int use_cache=0; use_cache<2; use_cache++ ) {
+    if( (cache>=0) && (use_cache!=!!cache) ) continue;
+
+    FD_LOG_NOTICE(( "Benchmarking %s with --iter-cnt %lu --batch-cnt %lu --sz-max %lu --mag-max %lu on %lu tile(s)",
+                    use_cache ? "fd_alloc_cache" : "fd_alloc", iter_cnt, batch_cnt, sz_max, mag_max, tile_cnt ));
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( _go        ) = 0;
+    FD_VOLATILE( _shalloc   ) = shalloc;
+    FD_VOLATILE( _iter_cnt  ) = iter_cnt;
+    FD_VOLATILE( _batch_cnt ) = batch_cnt;
+    FD_VOLATILE( _sz_max    ) = sz_max;
+    FD_VOLATILE( _mag_max   ) = mag_max;
+    FD_VOLATILE( _cache     ) = use_cache;
+    FD_COMPILER_MFENCE();
+
+    fd_tile_exec_t * exec[ FD_TILE_MAX ];
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) exec[tile_idx] = fd_tile_exec_new( tile_idx, bench_main, 0, NULL );
+
+    fd_log_sleep( (long)1e8 );
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( _go ) = 1;
+    FD_COMPILER_MFENCE();
+
+    bench_main( 0, NULL );
+
+    for( ulong tile_idx=1UL; tile_idx<tile_cnt; tile_idx++ ) fd_tile_exec_delete( exec[tile_idx], NULL );
+
+    /* Each iteration does batch_cnt malloc / free pairs */
+
+    double op_cnt = 2. * (double)iter_cnt * (double)batch_cnt;
+    double dt_max = 0.;
+    for( ulong tile_idx=0UL; tile_idx<tile_cnt; tile_idx++ ) {
+      double dt = (double)FD_VOLATILE_CONST( _dt[ tile_idx ] );
+      FD_LOG_NOTICE(( "tile %2lu: %7.2f ns/op", tile_idx, dt / op_cnt ));
+      dt_max = fd_double_if( dt>dt_max, dt, dt_max );
+    }
+    FD_LOG_NOTICE(( "aggregate: %.3f Mop/s", ((double)tile_cnt*op_cnt) / dt_max * 1e3 ));
+
+    fd_alloc_t * alloc = fd_alloc_join( shalloc, 0UL );
+    if( FD_UNLIKELY( !fd_alloc_is_empty( alloc ) ) ) FD_LOG_ERR(( "FAIL: leaked allocations" ));
+    fd_alloc_compact( alloc );
+    fd_alloc_leave( alloc );
+  }
+
+  fd_wksp_free_laddr( fd_alloc_delete( shalloc ) );
+  if( name ) fd_wksp_detach( wksp );
+  else       fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED capabilities" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
@@ -1090,6 +1090,386 @@ fd_alloc_free( fd_alloc_t * join,
   }
 }
 
+/* fd_alloc_cache ****************************************************/
+
+#define FD_ALLOC_CACHE_MAGIC (0xF17EDA2C37A11CA0UL) /* FIRE DANCER ALLOC CAche version 0 */
+
+struct __attribute__((aligned(FD_ALLOC_CACHE_ALIGN))) fd_alloc_cache {
+  ulong magic;       /* ==FD_ALLOC_CACHE_MAGIC */
+  ulong alloc_gaddr; /* wksp gaddr of the fd_alloc this caches */
+  ulong mag_max;     /* in [1,FD_ALLOC_CACHE_MAG_MAX] */
+
+  /* Padding to 128 byte alignment here */
+
+  /* cnt[ sizeclass ] is the number of blocks in the magazine for
+     sizeclass.  mag[ sizeclass ][ idx ] for idx in [0,cnt) are the
+     gaddrs of the blocks in it.  Each cached block has a valid
+     fd_alloc_hdr_t stored in front of its gaddr such that the block
+     can be returned with fd_alloc_free. */
+
+  uchar cnt[ FD_ALLOC_SIZECLASS_CNT ] __attribute__((aligned(128UL)));
+
+  /* Padding to 128 byte alignment here */
+
+  ulong mag[ FD_ALLOC_SIZECLASS_CNT ][ FD_ALLOC_CACHE_MAG_MAX ] __attribute__((aligned(128UL)));
+};
+
+FD_STATIC_ASSERT( FD_ALLOC_CACHE_ALIGN    ==alignof(fd_alloc_cache_t), layout );
+FD_STATIC_ASSERT( FD_ALLOC_CACHE_FOOTPRINT==sizeof (fd_alloc_cache_t), layout );
+FD_STATIC_ASSERT( FD_ALLOC_CACHE_MAG_MAX<=64UL,                        layout ); /* fd_alloc_block_set_t claims and uchar cnt */
+
+/* fd_alloc_cache_is_cacheable returns 1 if blocks of sizeclass are
+   eligible for caching and 0 otherwise.  sizeclass is assumed to be in
+   [0,FD_ALLOC_SIZECLASS_CNT). */
+
+FD_FN_CONST static inline int
+fd_alloc_cache_is_cacheable( ulong sizeclass ) {
+  return ((ulong)fd_alloc_sizeclass_cfg[ sizeclass ].block_footprint)<=FD_ALLOC_CACHE_FOOTPRINT_MAX;
+}
+
+/* fd_alloc_private_cache_push pushes the allocation at laddr onto the
+   magazine for sizeclass, which the caller promises is not full.  The
+   gaddr is written before the count is bumped such that a thread that
+   dies in between doesn't leave a stale entry behind. */
+
+static inline void
+fd_alloc_private_cache_push( fd_alloc_cache_t * cache,
+                             fd_wksp_t *        wksp,
+                             ulong              sizeclass,
+                             void *             laddr ) {
+  ulong cnt = (ulong)cache->cnt[ sizeclass ];
+  cache->mag[ sizeclass ][ cnt ] = fd_wksp_gaddr_fast( wksp, laddr );
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->cnt[ sizeclass ] ) = (uchar)(cnt+1UL);
+  FD_COMPILER_MFENCE();
+}
+
+/* fd_alloc_private_cache_drain returns blocks from the magazine for
+   sizeclass to the fd_alloc until at most keep blocks remain.  The
+   count is decremented before each block is returned such that a thread
+   that dies in between leaks the block rather than leaving it to be
+   freed twice.  Returns the number of blocks returned. */
+
+static ulong
+fd_alloc_private_cache_drain( fd_alloc_cache_t * cache,
+                              fd_alloc_t *       join,
+                              fd_wksp_t *        wksp,
+                              ulong              sizeclass,
+                              ulong              keep ) {
+  ulong cnt = (ulong)cache->cnt[ sizeclass ];
+  ulong ret = 0UL;
+  while( cnt>keep ) {
+    cnt--;
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( cache->cnt[ sizeclass ] ) = (uchar)cnt;
+    FD_COMPILER_MFENCE();
+    fd_alloc_free( join, fd_wksp_laddr_fast( wksp, cache->mag[ sizeclass ][ cnt ] ) );
+    ret++;
+  }
+  return ret;
+}
+
+/* fd_alloc_private_cache_refill refills the empty magazine for
+   sizeclass in bulk.  It takes exclusive allocation rights to a
+   superblock in circulation for the sizeclass exactly as malloc does,
+   but then claims up to half a magazine of its free blocks with a
+   single atomic operation (rather than one per block), putting the
+   superblock back into circulation if it still has free blocks.
+   Returns the number of blocks now in the magazine.  Returns 0 if there
+   is no superblock in circulation for sizeclass, in which case the
+   caller should fall back on fd_alloc_malloc (which will create one). */
+
+static ulong
+fd_alloc_private_cache_refill( fd_alloc_cache_t * cache,
+                               fd_alloc_t *       join,
+                               fd_alloc_t *       alloc,
+                               fd_wksp_t *        wksp,
+                               ulong              sizeclass ) {
+
+  ulong   cgroup      = fd_alloc_preferred_sizeclass_cgroup( sizeclass, fd_alloc_join_cgroup_hint( join ) );
+  ulong * active_slot = alloc->active_slot + sizeclass + FD_ALLOC_SIZECLASS_CNT*cgroup;
+
+  ulong superblock_gaddr = fd_alloc_private_active_slot_replace( active_slot, 0UL );
+  if( FD_UNLIKELY( !superblock_gaddr ) ) {
+    superblock_gaddr = fd_alloc_private_inactive_stack_pop( alloc->inactive_stack + sizeclass, wksp );
+    if( FD_UNLIKELY( !superblock_gaddr ) ) return 0UL;
+  }
+
+  /* At this point, we have exclusive allocation rights to a superblock
+     with at least one free block.  As in malloc, nobody else can clear
+     bits in free_blocks behind our back so we can pick the blocks to
+     claim non-atomically. */
+
+  fd_alloc_superblock_t * superblock = (fd_alloc_superblock_t *)fd_wksp_laddr_fast( wksp, superblock_gaddr );
+
+  fd_alloc_block_set_t free_blocks;
+  FD_COMPILER_MFENCE();
+  free_blocks = FD_VOLATILE_CONST( superblock->free_blocks );
+  FD_COMPILER_MFENCE();
+
+  ulong                want  = fd_ulong_max( cache->mag_max>>1, 1UL );
+  fd_alloc_block_set_t claim = free_blocks;
+  for( ulong cnt=fd_alloc_block_set_cnt( claim ); cnt>want; cnt-- ) claim = fd_ulong_clear_bit( claim, fd_ulong_find_msb( claim ) );
+
+  free_blocks = fd_alloc_block_set_sub( &superblock->free_blocks, claim );
+
+  /* If the superblock still has free blocks, put it back into
+     circulation exactly as malloc does.  Otherwise, the next free of
+     one of its blocks will. */
+
+  if( FD_LIKELY( free_blocks!=claim ) ) {
+    ulong displaced_superblock_gaddr = fd_alloc_private_active_slot_replace( active_slot, superblock_gaddr );
+    if( FD_UNLIKELY( displaced_superblock_gaddr ) )
+      fd_alloc_private_inactive_stack_push( alloc->inactive_stack + sizeclass, wksp, displaced_superblock_gaddr );
+  }
+
+  /* Push the claimed blocks into the magazine, each with a header as
+     if it had been allocated with minimal alignment. */
+
+  ulong block_footprint = (ulong)fd_alloc_sizeclass_cfg[ sizeclass ].block_footprint;
+  while( claim ) {
+    ulong block_idx   = (ulong)fd_ulong_find_lsb( claim );
+    claim             = fd_ulong_pop_lsb( claim );
+    ulong block_laddr = (ulong)superblock + sizeof(fd_alloc_superblock_t) + block_idx*block_footprint;
+    void * laddr      = fd_alloc_hdr_store( (void *)(block_laddr + sizeof(fd_alloc_hdr_t)), superblock, block_idx, sizeclass );
+    fd_alloc_private_cache_push( cache, wksp, sizeclass, laddr );
+  }
+
+  return (ulong)cache->cnt[ sizeclass ];
+}
+
+ulong
+fd_alloc_cache_align( void ) {
+  return alignof(fd_alloc_cache_t);
+}
+
+ulong
+fd_alloc_cache_footprint( void ) {
+  return sizeof(fd_alloc_cache_t);
+}
+
+void *
+fd_alloc_cache_new( void *       shmem,
+                    fd_alloc_t * join,
+                    ulong        mag_max ) {
+  fd_alloc_cache_t * cache = (fd_alloc_cache_t *)shmem;
+  fd_alloc_t *       alloc = fd_alloc_private_join_alloc( join );
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_alloc_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !alloc ) ) {
+    FD_LOG_WARNING(( "NULL join" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !((1UL<=mag_max) & (mag_max<=FD_ALLOC_CACHE_MAG_MAX)) ) ) {
+    FD_LOG_WARNING(( "bad mag_max" ));
+    return NULL;
+  }
+
+  fd_memset( cache, 0, sizeof(fd_alloc_cache_t) );
+
+  cache->alloc_gaddr = fd_wksp_gaddr_fast( fd_alloc_private_wksp( alloc ), alloc );
+  cache->mag_max     = mag_max;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = FD_ALLOC_CACHE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_alloc_cache_t *
+fd_alloc_cache_join( void *       shcache,
+                     fd_alloc_t * join ) {
+  fd_alloc_cache_t * cache = (fd_alloc_cache_t *)shcache;
+  fd_alloc_t *       alloc = fd_alloc_private_join_alloc( join );
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_alloc_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( cache->magic!=FD_ALLOC_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !alloc ) ) {
+    FD_LOG_WARNING(( "NULL join" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( fd_wksp_gaddr_fast( fd_alloc_private_wksp( alloc ), alloc )!=cache->alloc_gaddr ) ) {
+    FD_LOG_WARNING(( "cache is not for this alloc" ));
+    return NULL;
+  }
+
+  return cache;
+}
+
+void *
+fd_alloc_cache_leave( fd_alloc_cache_t * cache ) {
+
+  if( FD_UNLIKELY( !cache ) ) {
+    FD_LOG_WARNING(( "NULL cache" ));
+    return NULL;
+  }
+
+  return (void *)cache;
+}
+
+void *
+fd_alloc_cache_delete( void * shcache ) {
+  fd_alloc_cache_t * cache = (fd_alloc_cache_t *)shcache;
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_alloc_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( cache->magic!=FD_ALLOC_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  ulong cached = 0UL;
+  for( ulong sizeclass=0UL; sizeclass<FD_ALLOC_SIZECLASS_CNT; sizeclass++ ) cached += (ulong)cache->cnt[ sizeclass ];
+  if( FD_UNLIKELY( cached ) ) FD_LOG_WARNING(( "deleting a cache holding %lu blocks (they will leak)", cached ));
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shcache;
+}
+
+void *
+fd_alloc_cache_malloc_at_least( fd_alloc_cache_t * cache,
+                                fd_alloc_t *       join,
+                                ulong              align,
+                                ulong              sz,
+                                ulong *            max ) {
+
+# if FD_HAS_DEEPASAN
+  /* Cached blocks would need to be poisoned / unpoisoned individually.
+     Keep things simple and bypass the cache. */
+  (void)cache;
+  return fd_alloc_malloc_at_least( join, align, sz, max );
+# else
+
+  fd_alloc_t * alloc = fd_alloc_private_join_alloc( join );
+
+  /* Anything unusual (including errors) is handled by fd_alloc */
+
+  align = fd_ulong_if( !align, FD_ALLOC_MALLOC_ALIGN_DEFAULT, align );
+
+  ulong footprint = sz + sizeof(fd_alloc_hdr_t) + align - 1UL;
+
+  if( FD_UNLIKELY( (!cache) | (!alloc) | (!max) | (!fd_ulong_is_pow2( align )) | (!sz) | (footprint<=sz) |
+                   (footprint>FD_ALLOC_CACHE_FOOTPRINT_MAX) ) )
+    return fd_alloc_malloc_at_least( join, align, sz, max );
+
+  ulong sizeclass = fd_alloc_preferred_sizeclass( footprint );
+  if( FD_UNLIKELY( !fd_alloc_cache_is_cacheable( sizeclass ) ) ) return fd_alloc_malloc_at_least( join, align, sz, max );
+
+  fd_wksp_t * wksp = fd_alloc_private_wksp( alloc );
+
+  ulong cnt = (ulong)cache->cnt[ sizeclass ];
+  if( FD_UNLIKELY( !cnt ) ) {
+    cnt = fd_alloc_private_cache_refill( cache, join, alloc, wksp, sizeclass );
+    if( FD_UNLIKELY( !cnt ) ) return fd_alloc_malloc_at_least( join, align, sz, max );
+  }
+
+  /* Pop the magazine (count first, see fd_alloc_private_cache_drain)
+     and carve the requested allocation out of the block. */
+
+  cnt--;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->cnt[ sizeclass ] ) = (uchar)cnt;
+  FD_COMPILER_MFENCE();
+
+  void *                  laddr      = fd_wksp_laddr_fast( wksp, cache->mag[ sizeclass ][ cnt ] );
+  fd_alloc_hdr_t          hdr        = fd_alloc_hdr_load( laddr );
+  fd_alloc_superblock_t * superblock = fd_alloc_hdr_superblock( hdr, laddr );
+  ulong                   block_idx  = fd_alloc_hdr_block_idx( hdr );
+
+  ulong block_footprint = (ulong)fd_alloc_sizeclass_cfg[ sizeclass ].block_footprint;
+  ulong block_laddr     = (ulong)superblock + sizeof(fd_alloc_superblock_t) + block_idx*block_footprint;
+  ulong alloc_laddr     = fd_ulong_align_up( block_laddr + sizeof(fd_alloc_hdr_t), align );
+
+  *max = block_footprint - (alloc_laddr - block_laddr);
+
+  return fd_alloc_hdr_store( (void *)alloc_laddr, superblock, block_idx, sizeclass );
+# endif
+}
+
+void
+fd_alloc_cache_free( fd_alloc_cache_t * cache,
+                     fd_alloc_t *       join,
+                     void *             laddr ) {
+
+# if FD_HAS_DEEPASAN
+  (void)cache;
+  fd_alloc_free( join, laddr );
+# else
+
+  fd_alloc_t * alloc = fd_alloc_private_join_alloc( join );
+  if( FD_UNLIKELY( (!cache) | (!alloc) | (!laddr) ) ) {
+    fd_alloc_free( join, laddr );
+    return;
+  }
+
+  ulong sizeclass = fd_alloc_hdr_sizeclass( fd_alloc_hdr_load( laddr ) );
+  if( FD_UNLIKELY( (sizeclass==FD_ALLOC_SIZECLASS_LARGE) || !fd_alloc_cache_is_cacheable( sizeclass ) ) ) {
+    fd_alloc_free( join, laddr );
+    return;
+  }
+
+  fd_wksp_t * wksp = fd_alloc_private_wksp( alloc );
+
+  /* If the magazine is full, flush half of it such that alternating
+     malloc / free at the boundary doesn't flush and refill every call. */
+
+  if( FD_UNLIKELY( ((ulong)cache->cnt[ sizeclass ])>=cache->mag_max ) )
+    fd_alloc_private_cache_drain( cache, join, wksp, sizeclass, cache->mag_max>>1 );
+
+  fd_alloc_private_cache_push( cache, wksp, sizeclass, laddr );
+# endif
+}
+
+ulong
+fd_alloc_cache_flush( fd_alloc_cache_t * cache,
+                      fd_alloc_t *       join ) {
+  fd_alloc_t * alloc = fd_alloc_private_join_alloc( join );
+  if( FD_UNLIKELY( (!cache) | (!alloc) ) ) return 0UL;
+
+  fd_wksp_t * wksp = fd_alloc_private_wksp( alloc );
+
+  ulong cnt = 0UL;
+  for( ulong sizeclass=0UL; sizeclass<FD_ALLOC_SIZECLASS_CNT; sizeclass++ )
+    cnt += fd_alloc_private_cache_drain( cache, join, wksp, sizeclass, 0UL );
+  return cnt;
+}
+
 void
 fd_alloc_compact( fd_alloc_t * join ) {
   fd_alloc_t * alloc = fd_alloc_private_join_alloc( join );
@@ -616,6 +616,141 @@ fd_alloc_max_expand( ulong max,
   return fd_ulong_max( fd_ulong_max( t0, t1 ), needed );
 }
 
+/* fd_alloc_cache is an optional per-join magazine cache that sits in
+   front of a fd_alloc.
+
+   Even in the common case, every small fd_alloc_malloc / fd_alloc_free
+   does a few atomic operations on state shared by all joins (the
+   active superblock slot for the sizeclass,cgroup pair and the
+   superblock's free block set).  cgroup_hint spreads this out but, when
+   many threads hammer the same few sizeclasses, these cache lines still
+   bounce between cores.
+
+   A fd_alloc_cache holds, for each small sizeclass, a bounded stack (a
+   "magazine") of up to mag_max free blocks that are owned by the cache.
+   fd_alloc_cache_malloc pops a block from the magazine and
+   fd_alloc_cache_free pushes the block back, neither touching any
+   shared state.  When a magazine is empty, it is refilled in bulk by
+   claiming many free blocks of a superblock with a single atomic
+   operation.  When a magazine is full, half of it is flushed back to
+   the fd_alloc.  Allocations larger than FD_ALLOC_CACHE_FOOTPRINT_MAX
+   bypass the cache.
+
+   A fd_alloc_cache must only be used by one thread at a time (e.g. one
+   cache per replay thread).  Memory obtained from a cache can be freed
+   to the fd_alloc directly (or via another cache) and vice versa.
+
+   Blocks held in a cache are considered allocated by the underlying
+   fd_alloc (e.g. fd_alloc_is_empty will return 0 and fd_alloc_compact
+   will not reclaim them).  Call fd_alloc_cache_flush to return them.
+
+   The cache state should be placed in a wksp allocation (typically the
+   same wksp as the fd_alloc) tagged with a tag reserved for caches.
+   The state is position independent and updated such that a thread
+   that dies at any point leaves it in a consistent state (at worst,
+   the blocks being moved by a single refill or flush are leaked, a
+   block is never owned twice).  Another process can locate the caches of
+   dead threads with fd_wksp_tag_query, join them, and return their
+   blocks to the fd_alloc with fd_alloc_cache_flush.  And, as all cached
+   blocks live in superblocks tagged with the fd_alloc's tag,
+   fd_wksp_tag_free on the fd_alloc's tag reclaims them too. */
+
+/* FD_ALLOC_CACHE_MAG_MAX is the maximum number of blocks a cache can
+   hold per sizeclass. */
+
+#define FD_ALLOC_CACHE_MAG_MAX (64UL)
+
+/* FD_ALLOC_CACHE_FOOTPRINT_MAX is the largest block footprint that will
+   be cached.  Larger allocations are passed through to the fd_alloc.
+   This bounds the memory a cache can hold to roughly
+   FD_ALLOC_CACHE_FOOTPRINT_MAX*mag_max per sizeclass. */
+
+#define FD_ALLOC_CACHE_FOOTPRINT_MAX (4096UL)
+
+/* FD_ALLOC_CACHE_{ALIGN,FOOTPRINT} give the required alignment and
+   footprint of a memory region suitable for use as a fd_alloc_cache. */
+
+#define FD_ALLOC_CACHE_ALIGN     (128UL)
+#define FD_ALLOC_CACHE_FOOTPRINT (64768UL)
+
+struct fd_alloc_cache;
+typedef struct fd_alloc_cache fd_alloc_cache_t;
+
+/* fd_alloc_cache_{align,footprint} return FD_ALLOC_CACHE_{ALIGN,FOOTPRINT}. */
+
+FD_FN_CONST ulong
+fd_alloc_cache_align( void );
+
+FD_FN_CONST ulong
+fd_alloc_cache_footprint( void );
+
+/* fd_alloc_cache_new formats a memory region with the appropriate
+   alignment and footprint as an empty fd_alloc_cache for the fd_alloc
+   with the current local join.  mag_max in [1,FD_ALLOC_CACHE_MAG_MAX]
+   is the maximum number of blocks cached per sizeclass.  Returns shmem
+   on success and NULL on failure (logs details). */
+
+void *
+fd_alloc_cache_new( void *       shmem,
+                    fd_alloc_t * join,
+                    ulong        mag_max );
+
+/* fd_alloc_cache_join joins the caller to a fd_alloc_cache.  join is a
+   current local join to the fd_alloc the cache was created for.
+   Returns a local handle to the cache on success and NULL on failure
+   (logs details).  fd_alloc_cache_leave leaves a join and returns the
+   underlying shcache.  Neither flushes the cache. */
+
+fd_alloc_cache_t *
+fd_alloc_cache_join( void *       shcache,
+                     fd_alloc_t * join );
+
+void *
+fd_alloc_cache_leave( fd_alloc_cache_t * cache );
+
+/* fd_alloc_cache_delete unformats a memory region used as a
+   fd_alloc_cache.  The cache should be empty (i.e. flushed).  Returns
+   shcache on success and NULL on failure (logs details). */
+
+void *
+fd_alloc_cache_delete( void * shcache );
+
+/* fd_alloc_cache_malloc_at_least and fd_alloc_cache_malloc have the
+   same semantics as fd_alloc_malloc_at_least and fd_alloc_malloc.  join
+   is the current local join to the underlying fd_alloc (its cgroup_hint
+   is used when refilling and flushing). */
+
+void *
+fd_alloc_cache_malloc_at_least( fd_alloc_cache_t * cache,
+                                fd_alloc_t *       join,
+                                ulong              align,
+                                ulong              sz,
+                                ulong *            max );
+
+static inline void *
+fd_alloc_cache_malloc( fd_alloc_cache_t * cache,
+                       fd_alloc_t *       join,
+                       ulong              align,
+                       ulong              sz ) {
+  ulong max[1];
+  return fd_alloc_cache_malloc_at_least( cache, join, align, sz, max );
+}
+
+/* fd_alloc_cache_free has the same semantics as fd_alloc_free.  laddr
+   may have been allocated from the underlying fd_alloc by any means. */
+
+void
+fd_alloc_cache_free( fd_alloc_cache_t * cache,
+                     fd_alloc_t *       join,
+                     void *             laddr );
+
+/* fd_alloc_cache_flush returns all blocks held by cache to the
+   underlying fd_alloc.  Returns the number of blocks returned. */
+
+ulong
+fd_alloc_cache_flush( fd_alloc_cache_t * cache,
+                      fd_alloc_t *       join );
+
 /* fd_alloc_vtable is the virtual function table implementing fd_valloc
    for fd_alloc. */
 
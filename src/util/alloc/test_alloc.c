@@ -9,6 +9,8 @@ FD_STATIC_ASSERT( FD_ALLOC_ALIGN               == 4096UL, unit_test );
 FD_STATIC_ASSERT( FD_ALLOC_FOOTPRINT           ==20480UL, unit_test );
 FD_STATIC_ASSERT( FD_ALLOC_MALLOC_ALIGN_DEFAULT==   16UL, unit_test );
 FD_STATIC_ASSERT( FD_ALLOC_JOIN_CGROUP_HINT_MAX==   15UL, unit_test );
+FD_STATIC_ASSERT( FD_ALLOC_CACHE_ALIGN          ==  128UL, unit_test );
+FD_STATIC_ASSERT( FD_ALLOC_CACHE_FOOTPRINT      ==64768UL, unit_test );
 
 /* This is a torture test for same thread allocation */
 /* FIXME: IDEALLY SHOULD ADD TORTURE TEST FOR MALLOC / FREE PAIRS SPLIT
@@ -376,6 +378,80 @@ main( int     argc,
     FD_TEST( fd_alloc_is_empty( alloc ) );
   } while(0);
 
+  FD_LOG_NOTICE(( "Testing cache" ));
+
+  do {
+    FD_TEST( fd_alloc_cache_align()    ==FD_ALLOC_CACHE_ALIGN     );
+    FD_TEST( fd_alloc_cache_footprint()==FD_ALLOC_CACHE_FOOTPRINT );
+
+    void * shcmem = fd_wksp_alloc_laddr( wksp, fd_alloc_cache_align(), fd_alloc_cache_footprint(), tag+1UL );
+    FD_TEST( shcmem );
+
+    FD_TEST( !fd_alloc_cache_new( NULL,        alloc, 16UL                     ) ); /* NULL shmem */
+    FD_TEST( !fd_alloc_cache_new( (void *)1UL, alloc, 16UL                     ) ); /* misaligned shmem */
+    FD_TEST( !fd_alloc_cache_new( shcmem,      NULL,  16UL                     ) ); /* NULL join */
+    FD_TEST( !fd_alloc_cache_new( shcmem,      alloc, 0UL                      ) ); /* zero mag_max */
+    FD_TEST( !fd_alloc_cache_new( shcmem,      alloc, FD_ALLOC_CACHE_MAG_MAX+1UL ) ); /* mag_max too large */
+
+    void * shcache = fd_alloc_cache_new( shcmem, alloc, 16UL ); FD_TEST( shcache==shcmem );
+
+    FD_TEST( !fd_alloc_cache_join( NULL,        alloc ) ); /* NULL shcache */
+    FD_TEST( !fd_alloc_cache_join( (void *)1UL, alloc ) ); /* misaligned shcache */
+    FD_TEST( !fd_alloc_cache_join( dummy_mem,   alloc ) ); /* bad magic */
+    FD_TEST( !fd_alloc_cache_join( shcache,     NULL  ) ); /* NULL join */
+
+    fd_alloc_cache_t * cache = fd_alloc_cache_join( shcache, alloc ); FD_TEST( cache );
+
+    /* Round trip a mix of small (cached) and large (passed through)
+       allocations, freeing half through the cache and half directly. */
+
+    void * mem[256];
+    ulong  sz [256];
+    for( ulong iter=0UL; iter<16UL; iter++ ) {
+      for( ulong idx=0UL; idx<256UL; idx++ ) {
+        ulong r  = fd_rng_ulong( rng );
+        ulong a  = 1UL << (r & 7UL); r >>= 3;
+        ulong s  = (r & 1UL) ? (r>>1) % 8192UL : (r>>1) % 256UL;
+        ulong max;
+        mem[idx] = fd_alloc_cache_malloc_at_least( cache, alloc, a, s, &max );
+        if( !s ) { FD_TEST( !mem[idx] && !max ); sz[idx] = 0UL; continue; }
+        FD_TEST( mem[idx] );
+        FD_TEST( fd_ulong_is_aligned( (ulong)mem[idx], a ) );
+        FD_TEST( max>=s );
+        memset( mem[idx], (int)(idx & 255UL), max );
+        sz[idx] = max;
+      }
+      for( ulong idx=0UL; idx<256UL; idx++ ) {
+        if( !mem[idx] ) continue;
+        uchar const * p = (uchar const *)mem[idx];
+        FD_TEST( p[0]==(uchar)idx && p[sz[idx]-1UL]==(uchar)idx ); /* not clobbered by another allocation */
+        if( idx & 1UL ) fd_alloc_cache_free( cache, alloc, mem[idx] );
+        else            fd_alloc_free      ( alloc,        mem[idx] );
+      }
+    }
+
+    fd_alloc_cache_free( cache, alloc, NULL ); /* no-op */
+    FD_TEST( !fd_alloc_cache_malloc( cache, alloc, 3UL, 1UL ) ); /* bad align */
+
+    /* Blocks held by the cache are still allocated until flushed */
+
+    FD_TEST( !fd_alloc_is_empty( alloc ) );
+    FD_TEST( fd_alloc_cache_flush( cache, alloc ) );
+    FD_TEST( !fd_alloc_cache_flush( cache, alloc ) );
+    FD_TEST( fd_alloc_is_empty( alloc ) );
+
+    FD_TEST( !fd_alloc_cache_leave( NULL ) ); /* NULL cache */
+    FD_TEST( fd_alloc_cache_leave( cache )==shcache );
+
+    FD_TEST( !fd_alloc_cache_delete( NULL        ) ); /* NULL shcache */
+    FD_TEST( !fd_alloc_cache_delete( (void *)1UL ) ); /* misaligned shcache */
+    FD_TEST( !fd_alloc_cache_delete( dummy_mem   ) ); /* bad magic */
+    FD_TEST( fd_alloc_cache_delete( shcache )==shcmem );
+    FD_TEST( !fd_alloc_cache_join( shcache, alloc ) ); /* deleted */
+
+    fd_wksp_free_laddr( shcmem );
+  } while(0);
+
   FD_LOG_NOTICE(( "Testing max_expand" ));
   do {
 
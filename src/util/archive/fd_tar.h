@@ -330,6 +330,22 @@ fd_tar_writer_write_file_data( fd_tar_writer_t * writer,
 int
 fd_tar_writer_fini_file( fd_tar_writer_t * writer );
 
+/* fd_tar_writer_reserve_file appends a file named file_name of exactly
+   data_sz bytes to the tar archive without writing out its data.  The
+   header and trailing padding are written out and the data region is
+   left as a hole in the file.  On success, returns 0 and sets
+   *data_off to the file offset of the first data byte.  The caller
+   can then populate [*data_off,*data_off+data_sz) with positioned
+   writes (e.g. pwrite) at any later point, including concurrently from
+   multiple threads, while continuing to append more files.  Must not be
+   called while a file is being streamed out. */
+
+int
+fd_tar_writer_reserve_file( fd_tar_writer_t * writer,
+                            char const *      file_name,
+                            ulong             data_sz,
+                            ulong *           data_off );
+
 /* fd_tar_writer_make_space and fd_tar_writer_fill_space, allow for writing
    back to a specific place in the tar stream. This can be used by first
    making a call to fd_tar_write_new_file, fd_tar_writer_make_space, and
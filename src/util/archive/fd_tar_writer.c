@@ -265,6 +265,52 @@ fd_tar_writer_fini_file( fd_tar_writer_t * writer ) {
   return 0;
 }
 
+int
+fd_tar_writer_reserve_file( fd_tar_writer_t * writer,
+                            char const *      file_name,
+                            ulong             data_sz,
+                            ulong *           data_off ) {
+
+  if( FD_UNLIKELY( writer->header_pos!=ULONG_MAX ) ) {
+    FD_LOG_WARNING(( "There is an outstanding file being written out" ));
+    return -1;
+  }
+
+  int err = fd_tar_writer_new_file( writer, file_name );
+  if( FD_UNLIKELY( err ) ) {
+    return -1;
+  }
+
+  /* Extend the file past the data region, leaving a hole that will be
+     filled in by the caller, and move the file pointer to its end so
+     that fini_file pads it out and writes back the header. */
+
+  ulong off = writer->header_pos + FD_TAR_BLOCK_SZ;
+
+  err = ftruncate( writer->fd, (long)(off + data_sz) );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "Failed to reserve space in the tarball (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return -1;
+  }
+
+  long seek = lseek( writer->fd, 0L, SEEK_END );
+  if( FD_UNLIKELY( (ulong)seek!=off+data_sz ) ) {
+    FD_LOG_WARNING(( "Failed to seek to the end of the reserved space (%ld)", seek ));
+    return -1;
+  }
+
+  writer->data_sz = data_sz;
+
+  err = fd_tar_writer_fini_file( writer );
+  if( FD_UNLIKELY( err ) ) {
+    return -1;
+  }
+
+  *data_off = off;
+
+  return 0;
+}
+
 int
 fd_tar_writer_make_space( fd_tar_writer_t * writer, ulong data_sz ) {
 
@@ -151,12 +151,19 @@
 
      V3 - This is actually V2 but compressed frames will be enabled.
 
+     V4 - like V3 (compressed frames if the target supports them) but
+          each allocation is stored with a hash of its contents.  The
+          hashes are verified on restore and allow a V4 checkpt to be
+          the base of incremental checkpts (see
+          fd_wksp_checkpt_incr_tpool).
+
      DEFAULT - the style to use when not specified by user.  0 indicates
      to use V3 if the target supports it and V2 if not. */
 
 #define FD_WKSP_CHECKPT_STYLE_V1      (1)
 #define FD_WKSP_CHECKPT_STYLE_V2      (2)
 #define FD_WKSP_CHECKPT_STYLE_V3      (3)
+#define FD_WKSP_CHECKPT_STYLE_V4      (4)
 
 #define FD_WKSP_CHECKPT_STYLE_DEFAULT (0)
 
@@ -986,6 +993,14 @@ fd_wksp_pod_unmap( void * obj );
    string "" ... if the strlen is longer than 16384 bytes, the info will
    be truncated to a strlen of 16383).
 
+   For the V2, V3 and V4 styles, the allocations are compressed and
+   written by the threads in parallel.  Each thread writes to its own
+   region of the file, sized for the worst case compressed size of its
+   allocations, such that a checkpt written by more than one thread is
+   usually a sparse file (the holes do not use any disk space but the
+   checkpt can only be restored from a seekable file, e.g. not from a
+   pipe).
+
    Returns FD_WKSP_SUCCESS (0) on success or a FD_WKSP_ERR_* on failure
    (logs details).  Reasons for failure include INVAL (NULL wksp, NULL
    path, bad mode, unsupported style), CORRUPT (wksp memory corruption
@@ -1030,6 +1045,12 @@ fd_wksp_checkpt( fd_wksp_t *  wksp,
    threads used on restore does _not_ need to match the range used on
    checkpt.
 
+   A checkpt in a regular file is memory mapped and each thread streams
+   through the frames it restores: frames are read ahead before they are
+   decompressed and dropped from the page cache once restored, such that
+   restoring a checkpt far larger than the free memory does not thrash
+   the page cache.
+
    Returns FD_WKSP_SUCCESS (0) on success or a FD_WKSP_ERR_* on failure
    (logs details).  Reasons for failure include INVAL (NULL wksp, NULL
    path), FAIL or CORRUPT (couldn't open checkpt, I/O error, checkpt
@@ -1057,6 +1078,52 @@ fd_wksp_restore( fd_wksp_t *  wksp,
   return fd_wksp_restore_tpool( NULL, 0UL, 1UL, wksp, path, seed );
 }
 
+/* fd_wksp_checkpt_incr_tpool writes an incremental checkpt of wksp to
+   path relative to the FD_WKSP_CHECKPT_STYLE_V4 checkpt at base.  The
+   incremental checkpt has the V4 style.  It holds the metadata of all
+   the wksp's allocations but only holds the contents of the
+   allocations that were added, resized, retagged or modified since
+   base was written (as detected by comparing the allocation content
+   hashes in base with the current ones).  The allocations that did not
+   change are not written, making an incremental checkpt of a large
+   mostly idle wksp far faster to write and far smaller than a full
+   checkpt.  base==NULL writes a full V4 checkpt.  The other arguments
+   and the return value are as for fd_wksp_checkpt_tpool.  Reasons for
+   failure additionally include FAIL if base is not a full V4 checkpt.
+
+   An incremental checkpt can only be restored with
+   fd_wksp_restore_incr_tpool on top of its base.  Incremental checkpts
+   are not chained (the base of an incremental checkpt is always a full
+   checkpt). */
+
+int
+fd_wksp_checkpt_incr_tpool( fd_tpool_t * tpool,
+                            ulong        t0,
+                            ulong        t1,
+                            fd_wksp_t *  wksp,
+                            char const * path,
+                            ulong        mode,
+                            char const * uinfo,
+                            char const * base );
+
+/* fd_wksp_restore_incr_tpool restores the full checkpt at base into
+   wksp (as per fd_wksp_restore_tpool) and then applies the incremental
+   checkpt at path written relative to base.  The allocations that did
+   not change since base are checked against the hashes recorded in the
+   incremental checkpt, such that an incremental checkpt applied to the
+   wrong base is detected.  Tpool threads [t0,t1) are used for both
+   restores.  Returns as fd_wksp_restore_tpool.  On a FAIL, wksp might
+   hold the allocations of base. */
+
+int
+fd_wksp_restore_incr_tpool( fd_tpool_t * tpool,
+                            ulong        t0,
+                            ulong        t1,
+                            fd_wksp_t *  wksp,
+                            char const * path,
+                            char const * base,
+                            uint         seed );
+
 /* fd_wksp_preview previews the wksp checkpt at path.  On success,
    returns FD_WKSP_SUCCESS (0), path seems to contain a supported wksp
    checkpt and, if opt_preview was non-NULL, *opt_preview will contain,
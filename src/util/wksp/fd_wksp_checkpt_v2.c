@@ -1,15 +1,438 @@
+#define _GNU_SOURCE /* MAP_ANONYMOUS */
+
 #include "fd_wksp_private.h"
 
 #include <errno.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 
 /* This is an implementation detail and not strictly part of the v2
    specification. */
 
 #define FD_WKSP_CHECKPT_V2_CGROUP_MAX (1024UL)
 
+/* fd_wksp_checkpt_v2_buf_max returns an upper bound on the number of
+   bytes fd_checkpt_{meta,data} can write for a sz byte buffer in a
+   frame of the given style (exact for raw frames).  See
+   FD_CHECKPT_PRIVATE_CSZ_MAX for the lz4 details. */
+
+FD_FN_CONST static inline ulong
+fd_wksp_checkpt_v2_buf_max( int   frame_style,
+                            ulong sz ) {
+  if( frame_style==FD_CHECKPT_FRAME_STYLE_RAW ) return sz;
+  ulong chunk_cnt = (sz + FD_CHECKPT_PRIVATE_CHUNK_USZ_MAX - 1UL) / FD_CHECKPT_PRIVATE_CHUNK_USZ_MAX;
+  return sz + sz/255UL + 19UL*chunk_cnt;
+}
+
+/* fd_wksp_checkpt_v2_hash_node computes the v4 hash of every allocation
+   in wksp into part_hash (indexed by partition idx) with tpool threads
+   [t0,t1).  Partitions are handed out dynamically in small blocks as
+   allocation sizes can be extremely heterogeneous.  Assumes the caller
+   is thread t0, threads (t0,t1) are available and the wksp is locked. */
+
+#define FD_WKSP_CHECKPT_V2_HASH_BLOCK (16UL)
+
+static void
+fd_wksp_checkpt_v2_hash_node( void * tpool,
+                              ulong  tpool_t0,
+                              ulong  tpool_t1,         /* Assumes t1>t0 */
+                              void * _wksp,
+                              void * _part_hash,
+                              ulong  _part_nxt,
+                              ulong  part_max,
+                              ulong  _unused0,
+                              ulong  _unused1,
+                              ulong  _unused2,
+                              ulong  _unused3,
+                              ulong  _unused4 ) {
+  (void)_unused0; (void)_unused1; (void)_unused2; (void)_unused3; (void)_unused4;
+
+  ulong tpool_cnt = tpool_t1 - tpool_t0;
+  if( tpool_cnt>1UL ) {
+    ulong tpool_ts = tpool_t0 + fd_tpool_private_split( tpool_cnt );
+    fd_tpool_exec( tpool, tpool_ts, fd_wksp_checkpt_v2_hash_node,
+                   tpool, tpool_ts, tpool_t1, _wksp, _part_hash, _part_nxt, part_max, 0UL, 0UL, 0UL, 0UL, 0UL );
+    fd_wksp_checkpt_v2_hash_node(
+                   tpool, tpool_t0, tpool_ts, _wksp, _part_hash, _part_nxt, part_max, 0UL, 0UL, 0UL, 0UL, 0UL );
+    fd_tpool_wait( tpool, tpool_ts );
+    return;
+  }
+
+  fd_wksp_t *                     wksp      = (fd_wksp_t *)_wksp;
+  ulong *                         part_hash = (ulong *)    _part_hash;
+  fd_wksp_private_pinfo_t const * pinfo     = fd_wksp_private_pinfo( wksp );
+
+  for(;;) {
+
+#   if FD_HAS_ATOMIC
+    FD_COMPILER_MFENCE();
+    ulong part_lo = FD_ATOMIC_FETCH_AND_ADD( (ulong *)_part_nxt, FD_WKSP_CHECKPT_V2_HASH_BLOCK );
+    FD_COMPILER_MFENCE();
+#   else /* Note: this assumes platforms without HAS_ATOMIC will not be running this multithreaded */
+    ulong part_lo = *(ulong *)_part_nxt; *(ulong *)_part_nxt = part_lo + FD_WKSP_CHECKPT_V2_HASH_BLOCK;
+#   endif
+
+    if( FD_UNLIKELY( part_lo>=part_max ) ) break;
+    ulong part_hi = fd_ulong_min( part_lo + FD_WKSP_CHECKPT_V2_HASH_BLOCK, part_max );
+
+    for( ulong part_idx=part_lo; part_idx<part_hi; part_idx++ ) {
+      if( !pinfo[ part_idx ].tag ) continue;
+      ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+      ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+      part_hash[ part_idx ] = fd_wksp_checkpt_v4_hash( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+    }
+  }
+}
+
+/* fd_wksp_checkpt_v2_ctx_t describes the cgroup frames to write in
+   parallel.  The cgroups are split into blocks of contiguous cgroups,
+   one block per thread.  Block b writes cgroups
+   [block_cgroup_lo[b],block_cgroup_lo[b+1]) in a separate stream that
+   starts at file offset block_off_lo[b] and must end at or before
+   block_off_lo[b+1] (the blocks' worst case sizes). */
+
+struct fd_wksp_checkpt_v2_ctx {
+  fd_wksp_t *     wksp;
+  char const *    path;
+  int             frame_style;
+  int             style;
+  ulong const *   part_hash;                                               /* NULL to hash while writing */
+  uint const *    cgroup_head_cidx;
+  uchar const *   cgroup_is_ref;
+  ulong           block_cnt;
+  ulong           block_cgroup_lo[ FD_WKSP_CHECKPT_V2_CGROUP_MAX+1UL ];
+  ulong           block_off_lo   [ FD_WKSP_CHECKPT_V2_CGROUP_MAX+1UL ];
+  ulong           block_off_hi   [ FD_WKSP_CHECKPT_V2_CGROUP_MAX     ];    /* Where the block's stream actually ended */
+  int             block_err      [ FD_WKSP_CHECKPT_V2_CGROUP_MAX     ];
+  ulong *         cgroup_frame_off;                                        /* Indexed [0,cgroup_cnt) */
+};
+
+typedef struct fd_wksp_checkpt_v2_ctx fd_wksp_checkpt_v2_ctx_t;
+
+/* fd_wksp_checkpt_v2_block writes the cgroup frames of block.  Returns
+   SUCCESS or FAIL (logs details). */
+
+static int
+fd_wksp_checkpt_v2_block( fd_wksp_checkpt_v2_ctx_t * ctx,
+                          ulong                      block ) {
+
+  fd_wksp_t *                     wksp        = ctx->wksp;
+  char const *                    path        = ctx->path;
+  int                             frame_style = ctx->frame_style;
+  ulong const *                   part_hash   = ctx->part_hash;
+  fd_wksp_private_pinfo_t const * pinfo       = fd_wksp_private_pinfo( wksp );
+
+  ulong cgroup_lo = ctx->block_cgroup_lo[ block       ];
+  ulong cgroup_hi = ctx->block_cgroup_lo[ block+1UL   ];
+  ulong off_lo    = ctx->block_off_lo   [ block       ];
+  ulong off_hi    = ctx->block_off_lo   [ block+1UL   ];
+
+  ctx->block_off_hi[ block ] = 0UL;
+  if( FD_UNLIKELY( cgroup_lo>=cgroup_hi ) ) return FD_WKSP_SUCCESS; /* Nothing to do */
+
+  int            fd      = -1;
+  fd_checkpt_t * checkpt = NULL;
+
+  fd_checkpt_t _checkpt[ 1 ];
+  uchar        wbuf[ FD_CHECKPT_WBUF_MIN ];
+
+  fd = open( path, O_WRONLY, (mode_t)0 );
+  if( FD_UNLIKELY( fd==-1 ) ) {
+    FD_LOG_WARNING(( "open(\"%s\",O_WRONLY,0) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    goto fail;
+  }
+
+  if( FD_UNLIKELY( lseek( fd, (off_t)off_lo, SEEK_SET )!=(off_t)off_lo ) ) {
+    FD_LOG_WARNING(( "lseek(\"%s\",%lu) failed (%i-%s)", path, off_lo, errno, fd_io_strerror( errno ) ));
+    goto fail;
+  }
+
+  checkpt = fd_checkpt_init_stream( _checkpt, fd, wbuf, FD_CHECKPT_WBUF_MIN ); /* logs details */
+  if( FD_UNLIKELY( !checkpt ) ) goto fail;
+
+# define CHECKPT_TRAP( call ) do {                                            \
+    int _err = (call);                                                        \
+    if( FD_UNLIKELY( _err ) ) {                                               \
+      FD_LOG_WARNING(( "%s failed (%i-%s)", #call, _err, fd_checkpt_strerror( _err ) )); \
+      goto fail;                                                              \
+    }                                                                         \
+  } while(0)
+
+  for( ulong cgroup_idx=cgroup_lo; cgroup_idx<cgroup_hi; cgroup_idx++ ) {
+    ulong frame_off;
+    CHECKPT_TRAP( fd_checkpt_open_advanced( checkpt, frame_style, &frame_off ) );
+    ctx->cgroup_frame_off[ cgroup_idx ] = off_lo + frame_off;
+
+    int is_ref = (int)ctx->cgroup_is_ref[ cgroup_idx ];
+
+    /* Write cgroup commands */
+
+    fd_wksp_checkpt_v2_cmd_t cmd[1];
+
+    ulong part_idx = fd_wksp_private_pinfo_idx( ctx->cgroup_head_cidx[ cgroup_idx ] );
+    while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+
+      /* Command: "meta (tag,gaddr_lo,gaddr_hi)" */
+
+      cmd->meta.tag      = pinfo[ part_idx ].tag;      /* Note: non-zero */
+      cmd->meta.gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+      cmd->meta.gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+
+      CHECKPT_TRAP( fd_checkpt_meta( checkpt, cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) ) );
+
+      part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+    }
+
+    /* Command: "corresponding data follows" (or, v4 only, "corresponding
+       data is in the base checkpt") */
+
+    cmd->data.tag        = 0UL;
+    cmd->data.cgroup_cnt = fd_ulong_if( is_ref, ULONG_MAX-1UL, ULONG_MAX );
+    cmd->data.frame_off  = ULONG_MAX;
+
+    CHECKPT_TRAP( fd_checkpt_meta( checkpt, cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) ) );
+
+    /* Write cgroup partition hashes (v4 only) */
+
+    if( ctx->style==FD_WKSP_CHECKPT_STYLE_V4 ) {
+      part_idx = fd_wksp_private_pinfo_idx( ctx->cgroup_head_cidx[ cgroup_idx ] );
+      while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+        ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+        ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+
+        ulong hash = part_hash ? part_hash[ part_idx ]
+                               : fd_wksp_checkpt_v4_hash( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+
+        CHECKPT_TRAP( fd_checkpt_meta( checkpt, &hash, sizeof(ulong) ) );
+
+        part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+      }
+    }
+
+    /* Write cgroup partition data */
+
+    if( !is_ref ) {
+      part_idx = fd_wksp_private_pinfo_idx( ctx->cgroup_head_cidx[ cgroup_idx ] );
+      while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+        ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+        ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+
+        CHECKPT_TRAP( fd_checkpt_data( checkpt, fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo ) );
+
+        part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+      }
+    }
+
+    CHECKPT_TRAP( fd_checkpt_close_advanced( checkpt, &frame_off ) );
+    ctx->block_off_hi[ block ] = off_lo + frame_off;
+  }
+
+# undef CHECKPT_TRAP
+
+  if( FD_UNLIKELY( !fd_checkpt_fini( checkpt ) ) ) { /* logs details */
+    checkpt = NULL;
+    goto fail;
+  }
+  checkpt = NULL;
+
+  if( FD_UNLIKELY( ctx->block_off_hi[ block ]>off_hi ) ) { /* Should never happen */
+    FD_LOG_WARNING(( "cgroups [%lu,%lu) overran their region [%lu,%lu) of \"%s\"",
+                     cgroup_lo, cgroup_hi, off_lo, off_hi, path ));
+    goto fail;
+  }
+
+  if( FD_UNLIKELY( close( fd ) ) ) {
+    FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    return FD_WKSP_ERR_FAIL;
+  }
+
+  return FD_WKSP_SUCCESS;
+
+fail:
+  if( FD_LIKELY( checkpt ) ) {
+    if( FD_UNLIKELY( fd_checkpt_in_frame( checkpt ) ) && FD_UNLIKELY( fd_checkpt_close( checkpt ) ) )
+      FD_LOG_WARNING(( "fd_checkpt_close failed; attempting to continue" ));
+
+    if( FD_UNLIKELY( !fd_checkpt_fini( checkpt ) ) ) /* logs details */
+      FD_LOG_WARNING(( "fd_checkpt_fini failed; attempting to continue" ));
+  }
+
+  if( FD_LIKELY( fd!=-1 ) && FD_UNLIKELY( close( fd ) ) )
+    FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s); attempting to continue", path, errno, fd_io_strerror( errno ) ));
+
+  return FD_WKSP_ERR_FAIL;
+}
+
+/* fd_wksp_checkpt_v2_node dispatches the blocks of ctx to tpool threads
+   [t0,t1) (block b to thread t0+b, the caller is the root thread t0 of
+   the whole dispatch).  Assumes threads (t0,t1) are available.  Errors
+   are returned in ctx->block_err. */
+
+static void
+fd_wksp_checkpt_v2_node( void * tpool,
+                         ulong  tpool_t0,
+                         ulong  tpool_t1,              /* Assumes t1>t0 */
+                         void * _ctx,
+                         void * _unused0,
+                         ulong  root_t0,
+                         ulong  _unused1,
+                         ulong  _unused2,
+                         ulong  _unused3,
+                         ulong  _unused4,
+                         ulong  _unused5,
+                         ulong  _unused6 ) {
+  (void)_unused0; (void)_unused1; (void)_unused2; (void)_unused3; (void)_unused4; (void)_unused5; (void)_unused6;
+
+  ulong tpool_cnt = tpool_t1 - tpool_t0;
+  if( tpool_cnt>1UL ) {
+    ulong tpool_ts = tpool_t0 + fd_tpool_private_split( tpool_cnt );
+    fd_tpool_exec( tpool, tpool_ts, fd_wksp_checkpt_v2_node,
+                   tpool, tpool_ts, tpool_t1, _ctx, NULL, root_t0, 0UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+    fd_wksp_checkpt_v2_node(
+                   tpool, tpool_t0, tpool_ts, _ctx, NULL, root_t0, 0UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+    fd_tpool_wait( tpool, tpool_ts );
+    return;
+  }
+
+  fd_wksp_checkpt_v2_ctx_t * ctx = (fd_wksp_checkpt_v2_ctx_t *)_ctx;
+  ulong block = tpool_t0 - root_t0;
+  ctx->block_err[ block ] = fd_wksp_checkpt_v2_block( ctx, block ); /* logs details */
+}
+
+/* fd_wksp_checkpt_v2_assign assigns the allocations of wksp selected by
+   part_ref (all allocations if part_ref is NULL, else the allocations
+   whose part_ref is ref) to cgroups [cgroup_lo,cgroup_hi) as described
+   below and accumulates a bound on the bytes needed to write each
+   cgroup in cgroup_bound. */
+
+static void
+fd_wksp_checkpt_v2_assign( fd_wksp_t *   wksp,
+                           uchar const * part_ref,
+                           uchar         ref,
+                           int           frame_style,
+                           int           style,
+                           ulong         cgroup_lo,
+                           ulong         cgroup_hi,
+                           uint *        cgroup_head_cidx,
+                           ulong *       cgroup_alloc_cnt,
+                           ulong *       cgroup_bound ) {
+
+  fd_wksp_private_pinfo_t * pinfo = fd_wksp_private_pinfo( wksp );
+
+  ulong cgroup_cnt = cgroup_hi - cgroup_lo;
+  if( FD_UNLIKELY( !cgroup_cnt ) ) return;
+
+  /* Initialize the cgroups to empty */
+
+  ulong cgroup_load[ FD_WKSP_CHECKPT_V2_CGROUP_MAX ];
+
+  ulong meta_bound = fd_wksp_checkpt_v2_buf_max( frame_style, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+  ulong hash_bound = fd_ulong_if( style==FD_WKSP_CHECKPT_STYLE_V4, fd_wksp_checkpt_v2_buf_max( frame_style, sizeof(ulong) ), 0UL );
+
+  uint null_cidx = fd_wksp_private_pinfo_cidx( FD_WKSP_PRIVATE_PINFO_IDX_NULL );
+  for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
+    cgroup_head_cidx[ cgroup_lo+cgroup_idx ] = null_cidx;
+    cgroup_alloc_cnt[ cgroup_lo+cgroup_idx ] = 0UL;
+    cgroup_bound    [ cgroup_lo+cgroup_idx ] = meta_bound; /* The data / ref command */
+    cgroup_load     [           cgroup_idx ] = 0UL;
+  }
+
+  /* Configure cgroup sampling */
+
+  ulong cgroup_cursor = 0UL;
+  ulong cgroup_idx    = 0UL;
+
+  /* For all partitions in reverse order by gaddr_lo */
+
+  ulong part_idx = fd_wksp_private_pinfo_idx( wksp->part_tail_cidx );
+  while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
+
+    /* Load partition metadata */
+
+    ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+    ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+    ulong tag      = pinfo[ part_idx ].tag;
+
+    /* If this partition holds an allocation, deterministically assign
+       it to a cgroup in an approximately load balanced way such that
+       the assignments will be identical for the same set of
+       allocations and cgroup_cnt. */
+
+    if( tag && (!part_ref || part_ref[ part_idx ]==ref) ) { /* ~50/50 */
+
+      /* Sample a handful of cgroups and pick the least loaded to
+         approximate a greedy load balance method.  We consider the
+         most recently assigned cgroup (which was thought to be
+         lightly loaded at the previous assignment), a cyclically
+         sampled cgroup (ala striping) and two pseudo-randomly sampled
+         cgroups based on the common hash of gaddr_lo (ala random
+         assignment).  We don't care if our samples collide; we are
+         just trying to improve on load balance over straight striping
+         and random sampling (both of which are already asymptotically
+         are load balanced as per the above).
+
+         We could use a min-heap here but that would be
+         algorithmically more expensive, more complex to implement and
+         unlikely to improve load balance much futher (it would be
+         the greedy load balance method, which is also asymptotically
+         optimal but not perfect ... perfect load balance is a
+         computationally hard knapsack like problem but pretty good
+         load balance is easy). */
+
+      {
+        ulong h = fd_ulong_hash( gaddr_lo );
+
+        ulong i0 = cgroup_idx;             ulong l0 = cgroup_load[ i0 ];
+        ulong i1 = cgroup_cursor;          ulong l1 = cgroup_load[ i1 ];
+        ulong i2 =  h        % cgroup_cnt; ulong l2 = cgroup_load[ i2 ];
+        ulong i3 = (h >> 32) % cgroup_cnt; ulong l3 = cgroup_load[ i3 ];
+
+        i0 = fd_ulong_if( l0<=l1, i0, i1 ); l0 = fd_ulong_min( l0, l1 );
+        i1 = fd_ulong_if( l2<=l3, i2, i3 ); l1 = fd_ulong_min( l2, l3 );
+        i0 = fd_ulong_if( l0<=l1, i0, i1 ); l0 = fd_ulong_min( l0, l1 );
+
+        cgroup_cursor = fd_ulong_if( cgroup_cursor<cgroup_cnt-1UL, cgroup_cursor+1UL, 0UL );
+        cgroup_idx    = i0;
+      }
+
+      /* Update this cgroup's partition count and load.  The load is
+         currently the total uncompressed bytes of partition metadata
+         and data (TODO: consider adding a fixed base cost here to
+         account for fixed computational overheads too.  This would be
+         an order of magnitude ballpark of the cost of doing 2
+         fd_checkpt_buf relative to the marginal cost of checkpointing
+         an additional byte for some representative target ... note
+         that specific target details should not be incorporated into
+         this because then specific checkpt byte stream would be
+         sensitive to who wrote the checkpt and ideally checkpt should
+         be bit-for-bit identical for identical wksp regardless of the
+         target details).  Allocations in a ref cgroup are not written
+         but their contents are hashed on restore so the load is the
+         same. */
+
+      cgroup_alloc_cnt[ cgroup_lo+cgroup_idx ]++;
+      cgroup_load     [           cgroup_idx ] += 3UL*sizeof(ulong) + (gaddr_hi - gaddr_lo);
+      cgroup_bound    [ cgroup_lo+cgroup_idx ] += meta_bound + hash_bound
+                                                + fd_ulong_if( ref, 0UL, fd_wksp_checkpt_v2_buf_max( frame_style, gaddr_hi - gaddr_lo ) );
+
+      /* Push this partition onto the cgroup's stack.  Since we are
+         iterating over partitions in reverse order by gaddr_lo, the
+         stack for each cgroup can be treated as a linked list in
+         sorted order by gaddr_lo (helps with metdata
+         compressibility). */
+
+      pinfo[ part_idx ].stack_cidx             = cgroup_head_cidx[ cgroup_lo+cgroup_idx ];
+      cgroup_head_cidx[ cgroup_lo+cgroup_idx ] = fd_wksp_private_pinfo_cidx( part_idx );
+    }
+
+    /* Advance to the previous partition */
+
+    part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].prev_cidx );
+  }
+}
+
 int
 fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
                             ulong        t0,
@@ -18,9 +441,9 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
                             char const * path,
                             ulong        mode,
                             char const * uinfo,
-                            int          frame_style_compressed ) {
-
-  (void)tpool; (void)t0; (void)t1; /* Thread parallelization not currently implemented */
+                            int          frame_style_compressed,
+                            int          style,
+                            char const * base ) {
 
   char const * binfo = fd_log_build_info;
 
@@ -29,11 +452,18 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
     return FD_WKSP_ERR_INVAL;
   }
 
+  if( FD_UNLIKELY( base && style!=FD_WKSP_CHECKPT_STYLE_V4 ) ) {
+    FD_LOG_WARNING(( "incremental checkpts require the v4 style" ));
+    return FD_WKSP_ERR_INVAL;
+  }
+
   int err_fail;
 
-  int            locked  =  0;
-  int            fd      = -1;
-  fd_checkpt_t * checkpt = NULL;
+  int            locked   =  0;
+  int            fd       = -1;
+  fd_checkpt_t * checkpt  = NULL;
+  void *         part_mem = NULL;
+  ulong          part_sz  = 0UL;
 
   fd_wksp_private_pinfo_t * pinfo = fd_wksp_private_pinfo( wksp );
 
@@ -156,115 +586,67 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
 #   undef WKSP_TEST
   }
 
+  /* If this is an incremental checkpt, find the allocations that did
+     not change since base.  To do this, we hash all the allocations in
+     parallel and compare them with the allocations and hashes recorded
+     in base.  The unchanged allocations will be assigned to ref cgroups
+     that do not hold any allocation data and the others to regular
+     cgroups.  Each kind gets half the cgroups.  Note that this uses the
+     partition cycle tags so the above validation is done first. */
+
+  ulong * part_hash   = NULL;
+  uchar * part_ref    = NULL;
+  ulong   data_cgroup_cnt = cgroup_cnt;
+
+  if( base ) {
+    ulong part_max = wksp->part_max;
+
+    part_sz  = fd_ulong_align_up( part_max*(sizeof(ulong)+1UL), FD_SHMEM_NORMAL_PAGE_SZ );
+    part_mem = mmap( NULL, part_sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, (off_t)0 );
+    if( FD_UNLIKELY( part_mem==MAP_FAILED ) ) {
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed to map %lu bytes for the partition hashes (%i-%s); "
+                       "attempting to continue", name, path, part_sz, errno, fd_io_strerror( errno ) ));
+      part_mem = NULL;
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
+    }
+    part_hash = (ulong *)part_mem;
+    part_ref  = (uchar *)(part_hash + part_max);
+
+    ulong part_nxt[1];
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( part_nxt[0] ) = 0UL;
+    FD_COMPILER_MFENCE();
+    fd_wksp_checkpt_v2_hash_node( tpool, t0, t1, wksp, part_hash, (ulong)part_nxt, part_max, 0UL, 0UL, 0UL, 0UL, 0UL );
+
+    ulong ref_cnt;
+    if( FD_UNLIKELY( fd_wksp_private_restore_v4_base( wksp, base, part_hash, part_ref, &ref_cnt ) ) ) { /* logs details */
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed as \"%s\" is not a usable base; attempting to continue",
+                       name, path, base ));
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
+    }
+
+    FD_LOG_INFO(( "%lu of %lu allocations unchanged since \"%s\"", ref_cnt, alloc_cnt, base ));
+
+    data_cgroup_cnt = fd_ulong_min( (alloc_cnt-ref_cnt+31UL)/32UL, FD_WKSP_CHECKPT_V2_CGROUP_MAX/2UL );
+    cgroup_cnt      = fd_ulong_min( (ref_cnt          +31UL)/32UL, FD_WKSP_CHECKPT_V2_CGROUP_MAX/2UL ) + data_cgroup_cnt;
+  }
+
   /* Assign allocations to cgroups (note: in principle we could thread
      parallelize this but it also probably isn't worth the extra
      complexity). */
 
   uint  cgroup_head_cidx[ FD_WKSP_CHECKPT_V2_CGROUP_MAX ]; /* Head of a linked list for partitions assigned to each cgroup */
   ulong cgroup_alloc_cnt[ FD_WKSP_CHECKPT_V2_CGROUP_MAX ]; /* Number of partitions in each cgroup */
+  ulong cgroup_bound    [ FD_WKSP_CHECKPT_V2_CGROUP_MAX ]; /* Upper bound of the size of each cgroup frame */
+  uchar cgroup_is_ref   [ FD_WKSP_CHECKPT_V2_CGROUP_MAX ]; /* Is each cgroup a ref cgroup */
 
-  {
-
-    /* Initialize the cgroups to empty */
-
-    ulong cgroup_load[ FD_WKSP_CHECKPT_V2_CGROUP_MAX ];
-
-    uint null_cidx = fd_wksp_private_pinfo_cidx( FD_WKSP_PRIVATE_PINFO_IDX_NULL );
-    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
-      cgroup_head_cidx[ cgroup_idx ] = null_cidx;
-      cgroup_alloc_cnt[ cgroup_idx ] = 0UL;
-      cgroup_load     [ cgroup_idx ] = 0UL;
-    }
-
-    /* Configure cgroup sampling */
-
-    ulong cgroup_cursor = 0UL;
-    ulong cgroup_idx    = 0UL;
-
-    /* For all partitions in reverse order by gaddr_lo */
-
-    ulong part_idx = fd_wksp_private_pinfo_idx( wksp->part_tail_cidx );
-    while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
-
-      /* Load partition metadata */
-
-      ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
-      ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
-      ulong tag      = pinfo[ part_idx ].tag;
-
-      /* If this partition holds an allocation, deterministically assign
-         it to a cgroup in an approximately load balanced way such that
-         the assignments will be identical for the same set of
-         allocations and cgroup_cnt. */
-
-      if( tag ) { /* ~50/50 */
-
-        /* Sample a handful of cgroups and pick the least loaded to
-           approximate a greedy load balance method.  We consider the
-           most recently assigned cgroup (which was thought to be
-           lightly loaded at the previous assignment), a cyclically
-           sampled cgroup (ala striping) and two pseudo-randomly sampled
-           cgroups based on the common hash of gaddr_lo (ala random
-           assignment).  We don't care if our samples collide; we are
-           just trying to improve on load balance over straight striping
-           and random sampling (both of which are already asymptotically
-           are load balanced as per the above).
-
-           We could use a min-heap here but that would be
-           algorithmically more expensive, more complex to implement and
-           unlikely to improve load balance much futher (it would be
-           the greedy load balance method, which is also asymptotically
-           optimal but not perfect ... perfect load balance is a
-           computationally hard knapsack like problem but pretty good
-           load balance is easy). */
-
-        {
-          ulong h = fd_ulong_hash( gaddr_lo );
-
-          ulong i0 = cgroup_idx;             ulong l0 = cgroup_load[ i0 ];
-          ulong i1 = cgroup_cursor;          ulong l1 = cgroup_load[ i1 ];
-          ulong i2 =  h        % cgroup_cnt; ulong l2 = cgroup_load[ i2 ];
-          ulong i3 = (h >> 32) % cgroup_cnt; ulong l3 = cgroup_load[ i3 ];
-
-          i0 = fd_ulong_if( l0<=l1, i0, i1 ); l0 = fd_ulong_min( l0, l1 );
-          i1 = fd_ulong_if( l2<=l3, i2, i3 ); l1 = fd_ulong_min( l2, l3 );
-          i0 = fd_ulong_if( l0<=l1, i0, i1 ); l0 = fd_ulong_min( l0, l1 );
-
-          cgroup_cursor = fd_ulong_if( cgroup_cursor<cgroup_cnt-1UL, cgroup_cursor+1UL, 0UL );
-          cgroup_idx    = i0;
-        }
-
-        /* Update this cgroup's partition count and load.  The load is
-           currently the total uncompressed bytes of partition metadata
-           and data (TODO: consider adding a fixed base cost here to
-           account for fixed computational overheads too.  This would be
-           an order of magnitude ballpark of the cost of doing 2
-           fd_checkpt_buf relative to the marginal cost of checkpointing
-           an additional byte for some representative target ... note
-           that specific target details should not be incorporated into
-           this because then specific checkpt byte stream would be
-           sensitive to who wrote the checkpt and ideally checkpt should
-           be bit-for-bit identical for identical wksp regardless of the
-           target details). */
-
-        cgroup_alloc_cnt[ cgroup_idx ]++;
-        cgroup_load     [ cgroup_idx ] += 3UL*sizeof(ulong) + (gaddr_hi - gaddr_lo);
-
-        /* Push this partition onto the cgroup's stack.  Since we are
-           iterating over partitions in reverse order by gaddr_lo, the
-           stack for each cgroup can be treated as a linked list in
-           sorted order by gaddr_lo (helps with metdata
-           compressibility). */
-
-        pinfo[ part_idx ].stack_cidx   = cgroup_head_cidx[ cgroup_idx ];
-        cgroup_head_cidx[ cgroup_idx ] = fd_wksp_private_pinfo_cidx( part_idx );
-      }
-
-      /* Advance to the previous partition */
-
-      part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].prev_cidx );
-    }
-  }
+  fd_wksp_checkpt_v2_assign( wksp, part_ref, (uchar)0, frame_style_compressed, style, 0UL, data_cgroup_cnt,
+                             cgroup_head_cidx, cgroup_alloc_cnt, cgroup_bound );
+  fd_wksp_checkpt_v2_assign( wksp, part_ref, (uchar)1, frame_style_compressed, style, data_cgroup_cnt, cgroup_cnt,
+                             cgroup_head_cidx, cgroup_alloc_cnt, cgroup_bound );
+  for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) cgroup_is_ref[ cgroup_idx ] = (uchar)(cgroup_idx>=data_cgroup_cnt);
 
   /* At this point, each wksp partitions to checkpt have been assigned
      to a cgroup, the cgroups are approximately load balanced and the
@@ -289,6 +671,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
 
   ulong frame_off[ FD_WKSP_CHECKPT_V2_CGROUP_MAX+6UL ];
   ulong frame_cnt = 0UL;
+  ulong off0      = 0UL; /* File offset where checkpt was initialized */
 
   fd_checkpt_t  _checkpt[ 1 ];
   uchar         wbuf[ FD_CHECKPT_WBUF_MIN ];
@@ -308,6 +691,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
       err_fail = FD_WKSP_ERR_FAIL;                                                                                     \
       goto fail;                                                                                                       \
     }                                                                                                                  \
+    frame_off[ frame_cnt ] += off0;                                                                                    \
   } while(0)
 
 # define CHECKPT_CLOSE() do {                                                                                       \
@@ -319,6 +703,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
       err_fail = FD_WKSP_ERR_FAIL;                                                                                  \
       goto fail;                                                                                                    \
     }                                                                                                               \
+    frame_off[ frame_cnt ] += off0;                                                                                 \
   } while(0)
 
   /* Note: sz must be at most FD_CHECKPT_META_MAX */
@@ -351,7 +736,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
     fd_wksp_checkpt_v2_hdr_t hdr[1];
 
     hdr->magic                  = wksp->magic;
-    hdr->style                  = FD_WKSP_CHECKPT_STYLE_V2;
+    hdr->style                  = style;
     hdr->frame_style_compressed = frame_style_compressed;
     hdr->reserved               = 0U;
     memset( hdr->name, 0,    FD_SHMEM_NAME_MAX ); /* Make sure trailing zeros clear */
@@ -413,58 +798,100 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
   /* Checkpt the volume cgroups.  Note: This implementation just
      checkpoints 1 volume with at most CGROUP_MAX cgroup_cnt groups.
 
-     Note: this loop can be parallelized over multiple threads if
-     willing to leave holes in the file (and then maybe do a second pass
-     to compact the holes or maybe do a planning pass and then a real
-     pass or maybe leave the holes and do a second pass of run length
-     and entropy coding or maybe write to separate files and distribute
-     as a multiple files or maybe use non-POSIX filesystem mojo to
-     stitch together the separate files to appear as one file or ...) */
+     The cgroups are split into up to t1-t0 blocks of contiguous
+     cgroups with approximately the same worst case size, each written
+     by a different thread with its own file descriptor and checkpt
+     stream.  Since we cannot know how well a block compresses until it
+     is written, block b is written at the end of the worst case size
+     of blocks [0,b).  That is, the threads leave holes in the file
+     (unless uncompressed or single threaded) that mmio restores skip
+     over (the appendix has the location of every cgroup frame).  We
+     flush the header and info first so the blocks do not overlap any
+     buffered writes of this thread. */
 
-  for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
-
-    CHECKPT_OPEN( frame_style_compressed );
-
-    /* Write cgroup commands */
-
-    fd_wksp_checkpt_v2_cmd_t cmd[1];
-
-    ulong part_idx = fd_wksp_private_pinfo_idx( cgroup_head_cidx[ cgroup_idx ] );
-    while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
-
-      /* Command: "meta (tag,gaddr_lo,gaddr_hi)" */
-
-      cmd->meta.tag      = pinfo[ part_idx ].tag;      /* Note: non-zero */
-      cmd->meta.gaddr_lo = pinfo[ part_idx ].gaddr_lo;
-      cmd->meta.gaddr_hi = pinfo[ part_idx ].gaddr_hi;
-
-      CHECKPT_META( cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+  if( FD_UNLIKELY( !fd_checkpt_fini( checkpt ) ) ) { /* logs details */
+    FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when flushing; attempting to continue", name, path ));
+    checkpt  = NULL;
+    err_fail = FD_WKSP_ERR_FAIL;
+    goto fail;
+  }
+  checkpt = NULL;
 
-      part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+  {
+    fd_wksp_checkpt_v2_ctx_t ctx[1];
+
+    ulong block_cnt = fd_ulong_max( fd_ulong_min( t1-t0, cgroup_cnt ), 1UL );
+    ulong off_lo    = frame_off[ frame_cnt ]; /* End of the info frame */
+
+    ulong total = 0UL;
+    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) total += cgroup_bound[ cgroup_idx ];
+    ulong block_sz = total/block_cnt + 1UL;
+
+    ctx->wksp             = wksp;
+    ctx->path             = path;
+    ctx->frame_style      = frame_style_compressed;
+    ctx->style            = style;
+    ctx->part_hash        = part_hash;
+    ctx->cgroup_head_cidx = cgroup_head_cidx;
+    ctx->cgroup_is_ref    = cgroup_is_ref;
+    ctx->block_cnt        = block_cnt;
+    ctx->cgroup_frame_off = frame_off + 2UL;
+
+    /* Cgroup c goes to the block holding the start of its worst case
+       frame (monotonic in c so blocks are contiguous, blocks might be
+       empty). */
+
+    ulong block = 0UL;
+    ulong cum   = 0UL;
+    ctx->block_cgroup_lo[ 0 ] = 0UL;
+    ctx->block_off_lo   [ 0 ] = off_lo;
+    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
+      ulong cgroup_block = cum / block_sz;
+      while( block<cgroup_block ) {
+        block++;
+        ctx->block_cgroup_lo[ block ] = cgroup_idx;
+        ctx->block_off_lo   [ block ] = off_lo + cum;
+      }
+      cum += cgroup_bound[ cgroup_idx ];
+    }
+    while( block<block_cnt ) {
+      block++;
+      ctx->block_cgroup_lo[ block ] = cgroup_cnt;
+      ctx->block_off_lo   [ block ] = off_lo + cum;
     }
 
-    /* Command: "corresponding data follows" */
+    fd_wksp_checkpt_v2_node( tpool, t0, t0+block_cnt, ctx, NULL, t0, 0UL, 0UL, 0UL, 0UL, 0UL, 0UL );
 
-    cmd->data.tag        = 0UL;
-    cmd->data.cgroup_cnt = ULONG_MAX;
-    cmd->data.frame_off  = ULONG_MAX;
+    ulong off_resume = off_lo;
+    for( ulong block=0UL; block<block_cnt; block++ ) {
+      if( FD_UNLIKELY( ctx->block_err[ block ] ) ) {
+        FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when writing cgroups [%lu,%lu); attempting to continue",
+                         name, path, ctx->block_cgroup_lo[ block ], ctx->block_cgroup_lo[ block+1UL ] ));
+        err_fail = FD_WKSP_ERR_FAIL;
+        goto fail;
+      }
+      off_resume = fd_ulong_max( off_resume, ctx->block_off_hi[ block ] );
+    }
 
-    CHECKPT_META( cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+    frame_cnt += cgroup_cnt;
+    frame_off[ frame_cnt ] = off_resume;
 
-    /* Write cgroup partition data */
+    /* Resume the checkpt after the last cgroup frame */
 
-    part_idx = fd_wksp_private_pinfo_idx( cgroup_head_cidx[ cgroup_idx ] );
-    while( !fd_wksp_private_pinfo_idx_is_null( part_idx ) ) {
-      ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
-      ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
-
-      CHECKPT_DATA( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
-
-      part_idx = fd_wksp_private_pinfo_idx( pinfo[ part_idx ].stack_cidx );
+    if( FD_UNLIKELY( lseek( fd, (off_t)off_resume, SEEK_SET )!=(off_t)off_resume ) ) {
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when seeking (%i-%s); attempting to continue",
+                       name, path, errno, fd_io_strerror( errno ) ));
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
     }
 
-    CHECKPT_CLOSE();
-
+    off0    = off_resume;
+    checkpt = fd_checkpt_init_stream( _checkpt, fd, wbuf, FD_CHECKPT_WBUF_MIN ); /* logs details */
+    if( FD_UNLIKELY( !checkpt ) ) {
+      FD_LOG_WARNING(( "checkpt wksp \"%s\" to \"%s\" failed when resuming; attempting to continue", name, path ));
+      err_fail = FD_WKSP_ERR_FAIL;
+      goto fail;
+    }
   }
 
   /* Checkpt the volume appendix.  This starts with a command that
@@ -531,7 +958,7 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
     memcpy( ftr->name, name, name_len          );
     ftr->reserved                    = 0U;
     ftr->frame_style_compressed      = frame_style_compressed;
-    ftr->style                       = FD_WKSP_CHECKPT_STYLE_V2;
+    ftr->style                       = style;
     ftr->unmagic                     = ~wksp->magic;
 
     CHECKPT_OPEN( FD_CHECKPT_FRAME_STYLE_RAW );
@@ -567,6 +994,8 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
   fd_wksp_private_unlock( wksp );
   locked = 0;
 
+  if( FD_LIKELY( part_mem ) ) munmap( part_mem, part_sz );
+
   return FD_WKSP_SUCCESS;
 
 fail:
@@ -586,5 +1015,7 @@ fail:
 
   if( FD_LIKELY( locked ) ) fd_wksp_private_unlock( wksp );
 
+  if( FD_LIKELY( part_mem ) ) munmap( part_mem, part_sz );
+
   return err_fail;
 }
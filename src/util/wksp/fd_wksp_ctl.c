@@ -152,7 +152,7 @@ main( int     argc,
 
     } else if( !strcmp( cmd, "supported-styles" ) ) {
 
-      printf( "%s\n", FD_HAS_LZ4 ? "0 1 2 3" : "0 1 2" );
+      printf( "%s\n", FD_HAS_LZ4 ? "0 1 2 3 4" : "0 1 2 4" );
 
       FD_LOG_NOTICE(( "%i: %s: success", cnt, cmd ));
 
@@ -432,6 +432,29 @@ main( int     argc,
       FD_LOG_NOTICE(( "%i: %s %s %s 0%03lo %i ...: success", cnt, cmd, name, path, mode, style ));
       SHIFT(5);
 
+    } else if( !strcmp( cmd, "checkpt-incr" ) ) {
+
+      if( FD_UNLIKELY( argc<5 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * name  =                         argv[0];
+      char const * path  =                         argv[1];
+      ulong        mode  = fd_cstr_to_ulong_octal( argv[2] );
+      char const * base  =                         argv[3];
+      char const * info  =                         argv[4];
+
+      fd_wksp_t * wksp = fd_wksp_attach( name ); /* logs details */
+      if( FD_UNLIKELY( !wksp ) )
+        FD_LOG_ERR(( "%i: %s %s %s 0%03lo %s ...: wksp_attach failed", cnt, cmd, name, path, mode, base ));
+
+      int err = fd_wksp_checkpt_incr_tpool( NULL, 0UL, 1UL, wksp, path, mode, info, base ); /* logs details */
+      if( FD_UNLIKELY( err ) )
+        FD_LOG_ERR(( "%i: %s %s %s 0%03lo %s ...: fd_wksp_checkpt_incr_tpool failed", cnt, cmd, name, path, mode, base ));
+
+      fd_wksp_detach( wksp ); /* logs details */
+
+      FD_LOG_NOTICE(( "%i: %s %s %s 0%03lo %s ...: success", cnt, cmd, name, path, mode, base ));
+      SHIFT(5);
+
     } else if( !strcmp( cmd, "checkpt-query" ) ) {
 
       if( FD_UNLIKELY( argc<2 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
@@ -465,6 +488,29 @@ main( int     argc,
       FD_LOG_NOTICE(( "%i: %s %s %s %u: success", cnt, cmd, name, path, seed ));
       SHIFT(3);
 
+    } else if( !strcmp( cmd, "restore-incr" ) ) {
+
+      if( FD_UNLIKELY( argc<4 ) ) FD_LOG_ERR(( "%i: %s: too few arguments\n\tDo %s help for help", cnt, cmd, bin ));
+
+      char const * name  = argv[0];
+      char const * path  = argv[1];
+      char const * base  = argv[2];
+      char const * _seed = argv[3];
+
+      fd_wksp_t * wksp = fd_wksp_attach( name ); /* logs details */
+      if( FD_UNLIKELY( !wksp ) ) FD_LOG_ERR(( "%i: %s %s %s %s %s: wksp_attach failed", cnt, cmd, name, path, base, _seed ));
+
+      uint seed = strcmp( _seed, "-" ) ? fd_cstr_to_uint( _seed ) : fd_wksp_seed( wksp );
+
+      int err = fd_wksp_restore_incr_tpool( NULL, 0UL, 1UL, wksp, path, base, seed ); /* logs details */
+      if( FD_UNLIKELY( err ) )
+        FD_LOG_ERR(( "%i: %s %s %s %s %u: fd_wksp_restore_incr_tpool failed", cnt, cmd, name, path, base, seed ));
+
+      fd_wksp_detach( wksp ); /* logs details */
+
+      FD_LOG_NOTICE(( "%i: %s %s %s %s %u: success", cnt, cmd, name, path, base, seed ));
+      SHIFT(4);
+
     } else {
 
       FD_LOG_ERR(( "%i: %s: unknown command\n\t"
@@ -60,7 +60,8 @@ fd_wksp_preview( char const *        path,
 
   if( FD_LIKELY( (sizeof(fd_wksp_checkpt_v2_hdr_t)<=buf_sz                         ) &     /* header not truncated */
                  (v2->magic==FD_WKSP_MAGIC                                         ) &     /* with valid magic */
-                 (v2->style==FD_WKSP_CHECKPT_STYLE_V2                              ) &     /* with valid style */
+                 ((v2->style==FD_WKSP_CHECKPT_STYLE_V2) |
+                  (v2->style==FD_WKSP_CHECKPT_STYLE_V4)                            ) &     /* with valid style */
                  (fd_checkpt_frame_style_is_supported( v2->frame_style_compressed )) &     /* with supported compression */
                  (v2->reserved==0U                                                 ) &     /* with expected reserved */
                  (name_len>0UL                                                     ) &     /* with valid name */
@@ -165,9 +166,10 @@ fd_wksp_checkpt_tpool( fd_tpool_t * tpool,
   switch( style ) {
   case FD_WKSP_CHECKPT_STYLE_V1: return fd_wksp_private_checkpt_v1( tpool, t0, t1, wksp, path, mode, uinfo );
   case FD_WKSP_CHECKPT_STYLE_V2: return fd_wksp_private_checkpt_v2( tpool, t0, t1, wksp, path, mode, uinfo,
-                                                                    FD_CHECKPT_FRAME_STYLE_RAW );
+                                                                    FD_CHECKPT_FRAME_STYLE_RAW, FD_WKSP_CHECKPT_STYLE_V2, NULL );
   case FD_WKSP_CHECKPT_STYLE_V3: return fd_wksp_private_checkpt_v2( tpool, t0, t1, wksp, path, mode, uinfo,
-                                                                    FD_CHECKPT_FRAME_STYLE_LZ4 );
+                                                                    FD_CHECKPT_FRAME_STYLE_LZ4, FD_WKSP_CHECKPT_STYLE_V2, NULL );
+  case FD_WKSP_CHECKPT_STYLE_V4: return fd_wksp_checkpt_incr_tpool( tpool, t0, t1, wksp, path, mode, uinfo, NULL );
   break;
   }
 
@@ -175,6 +177,42 @@ fd_wksp_checkpt_tpool( fd_tpool_t * tpool,
   return FD_WKSP_ERR_INVAL;
 }
 
+int
+fd_wksp_checkpt_incr_tpool( fd_tpool_t * tpool,
+                            ulong        t0,
+                            ulong        t1,
+                            fd_wksp_t *  wksp,
+                            char const * path,
+                            ulong        mode,
+                            char const * uinfo,
+                            char const * base ) {
+
+  /* Check input args */
+
+  if( FD_UNLIKELY( !wksp ) ) {
+    FD_LOG_WARNING(( "NULL wksp" ));
+    return FD_WKSP_ERR_INVAL;
+  }
+
+  if( FD_UNLIKELY( !path ) ) {
+    FD_LOG_WARNING(( "NULL path" ));
+    return FD_WKSP_ERR_INVAL;
+  }
+
+  if( FD_UNLIKELY( mode!=(ulong)(mode_t)mode ) ) {
+    FD_LOG_WARNING(( "bad mode" ));
+    return FD_WKSP_ERR_INVAL;
+  }
+
+  if( FD_UNLIKELY( !uinfo ) ) uinfo = "";
+
+  /* base==NULL fine (full checkpt) */
+
+  return fd_wksp_private_checkpt_v2( tpool, t0, t1, wksp, path, mode, uinfo,
+                                     FD_HAS_LZ4 ? FD_CHECKPT_FRAME_STYLE_LZ4 : FD_CHECKPT_FRAME_STYLE_RAW,
+                                     FD_WKSP_CHECKPT_STYLE_V4, base );
+}
+
 int
 fd_wksp_restore_tpool( fd_tpool_t * tpool,
                        ulong        t0,
@@ -210,7 +248,8 @@ fd_wksp_restore_tpool( fd_tpool_t * tpool,
 
   switch( preview->style ) {
   case FD_WKSP_CHECKPT_STYLE_V1: return fd_wksp_private_restore_v1( tpool, t0, t1, wksp, path, new_seed );
-  case FD_WKSP_CHECKPT_STYLE_V2: return fd_wksp_private_restore_v2( tpool, t0, t1, wksp, path, new_seed );
+  case FD_WKSP_CHECKPT_STYLE_V2: return fd_wksp_private_restore_v2( tpool, t0, t1, wksp, path, new_seed, 0 );
+  case FD_WKSP_CHECKPT_STYLE_V4: return fd_wksp_private_restore_v2( tpool, t0, t1, wksp, path, new_seed, 0 );
   /* note: v3 is really v2 with compressed frames */
   default: break; /* never get here (preview already checked) */
   }
@@ -219,6 +258,49 @@ fd_wksp_restore_tpool( fd_tpool_t * tpool,
   return FD_WKSP_ERR_CORRUPT;
 }
 
+int
+fd_wksp_restore_incr_tpool( fd_tpool_t * tpool,
+                            ulong        t0,
+                            ulong        t1,
+                            fd_wksp_t *  wksp,
+                            char const * path,
+                            char const * base,
+                            uint         new_seed ) {
+
+  /* Check input args */
+
+  if( FD_UNLIKELY( !wksp ) ) {
+    FD_LOG_WARNING(( "NULL wksp" ));
+    return FD_WKSP_ERR_INVAL;
+  }
+
+  if( FD_UNLIKELY( (!path) | (!base) ) ) {
+    FD_LOG_WARNING(( "NULL path" ));
+    return FD_WKSP_ERR_INVAL;
+  }
+
+  fd_wksp_preview_t preview[1];
+  int err = fd_wksp_preview( path, preview );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "\"%s\" does not appear to be a supported wksp checkpt", path ));
+    return err;
+  }
+
+  if( FD_UNLIKELY( preview->style!=FD_WKSP_CHECKPT_STYLE_V4 ) ) {
+    FD_LOG_WARNING(( "\"%s\" is not a v4 wksp checkpt", path ));
+    return FD_WKSP_ERR_FAIL;
+  }
+
+  /* Restore the base and then the incremental on top of it.  The
+     incremental checkpt has the metadata of all allocations so the
+     base's allocations that no longer exist will be freed. */
+
+  err = fd_wksp_restore_tpool( tpool, t0, t1, wksp, base, new_seed ); /* logs details */
+  if( FD_UNLIKELY( err ) ) return err;
+
+  return fd_wksp_private_restore_v2( tpool, t0, t1, wksp, path, new_seed, 1 ); /* logs details */
+}
+
 int
 fd_wksp_printf( int          fd,
                 char const * path,
@@ -248,6 +330,7 @@ fd_wksp_printf( int          fd,
   switch( preview->style ) {
   case FD_WKSP_CHECKPT_STYLE_V1: TRAP( fd_wksp_private_printf_v1( fd, path, verbose ) ); break;
   case FD_WKSP_CHECKPT_STYLE_V2: TRAP( fd_wksp_private_printf_v2( fd, path, verbose ) ); break;
+  case FD_WKSP_CHECKPT_STYLE_V4: TRAP( fd_wksp_private_printf_v2( fd, path, verbose ) ); break;
   /* note: v3 is really v2 with compressed frames */
   default: /* never get here (preview already checked) */
     TRAP( dprintf( fd, "unsupported style" ) );
@@ -574,13 +574,26 @@ typedef struct fd_wksp_checkpt_v2_info fd_wksp_checkpt_v2_info_t;
 
    A fd_wksp_checkpt_v2_cmd_t supports writing an arbitrarily large
    checkpt single pass with only small upfront bounded allocation while
-   supporting both streaming and parallel restore of those frames. */
+   supporting both streaming and parallel restore of those frames.
+
+   A v4 checkpt (hdr style FD_WKSP_CHECKPT_STYLE_V4) has the same
+   layout as a v2 checkpt with two additions.  In a cgroup frame, the
+   command that ends the meta commands is followed by the hash of each
+   allocation's contents (a ulong written as metadata per allocation, in
+   the same order as the meta commands, see
+   fd_wksp_checkpt_v4_hash).  And an incremental v4 checkpt can have
+   cgroup frames whose meta commands are ended by a ref command instead
+   of a data command.  The allocations of a ref cgroup frame did not
+   change since the base checkpt and the frame has no data section (the
+   allocations are restored from the base and only their hashes are
+   stored). */
 
 union fd_wksp_checkpt_v2_cmd {
   struct { ulong tag; /* > 0 */ ulong gaddr_lo;                     ulong gaddr_hi;                    } meta;
   struct { ulong tag; /* ==0 */ ulong cgroup_cnt; /* ==ULONG_MAX */ ulong frame_off; /* ==ULONG_MAX */ } data;
   struct { ulong tag; /* ==0 */ ulong cgroup_cnt; /* < ULONG_MAX */ ulong frame_off; /* < ULONG_MAX */ } appendix;
   struct { ulong tag; /* ==0 */ ulong cgroup_cnt; /* ==ULONG_MAX */ ulong frame_off; /* < ULONG_MAX */ } volumes;
+  struct { ulong tag; /* ==0 */ ulong cgroup_cnt; /* ==ULONG_MAX-1 */ ulong frame_off; /* ==ULONG_MAX */ } ref; /* v4 only */
 };
 
 typedef union fd_wksp_checkpt_v2_cmd fd_wksp_checkpt_v2_cmd_t;
@@ -605,6 +618,22 @@ fd_wksp_checkpt_v2_cmd_is_volumes( fd_wksp_checkpt_v2_cmd_t const * cmd ) {
   return (cmd->volumes.tag==0UL) & (cmd->volumes.cgroup_cnt==ULONG_MAX) & (cmd->volumes.frame_off<ULONG_MAX);
 }
 
+FD_FN_PURE static inline int
+fd_wksp_checkpt_v2_cmd_is_ref( fd_wksp_checkpt_v2_cmd_t const * cmd ) {
+  return (cmd->ref.tag==0UL) & (cmd->ref.cgroup_cnt==(ULONG_MAX-1UL)) & (cmd->ref.frame_off==ULONG_MAX);
+}
+
+/* fd_wksp_checkpt_v4_hash returns the hash stored in a v4 checkpt for
+   an allocation with the sz bytes of contents at laddr. */
+
+#define FD_WKSP_CHECKPT_V4_HASH_SEED (0x5d1e7b0c4a93f268UL)
+
+FD_FN_PURE static inline ulong
+fd_wksp_checkpt_v4_hash( void const * laddr,
+                         ulong        sz ) {
+  return fd_hash( FD_WKSP_CHECKPT_V4_HASH_SEED, laddr, sz );
+}
+
 /* A fd_wksp_checkpt_v2_ftr_t gives the byte layout of the final frame
    of a wksp v2 checkpt.  This frame contains this footer uncompressed.
    This is wksp checkpt header backwards plus some additional
@@ -668,7 +697,13 @@ fd_wksp_private_printf_v1( int          fd,
 
 /* Similarly for v2.  Note that style==FD_WKSP_CHECKPT_STYLE_V3 in the
    fd_wksp_checkpt function becomes a FD_WKSP_CHECKPT_STYLE_V2 with a
-   FD_CHECKPT_FRAME_STYLE_LZ4 cgroup frames in the checkpt itself. */
+   FD_CHECKPT_FRAME_STYLE_LZ4 cgroup frames in the checkpt itself.  The
+   v2 implementations also handle v4 checkpts: style is the style to
+   write (FD_WKSP_CHECKPT_STYLE_V2 or FD_WKSP_CHECKPT_STYLE_V4) and, for
+   v4, base is the path of the checkpt to write an incremental checkpt
+   against (NULL for a full checkpt).  incr indicates to restore an
+   incremental checkpt on top of the wksp's current allocations (which
+   should be the ones restored from the incremental checkpt's base). */
 
 int
 fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
@@ -678,7 +713,9 @@ fd_wksp_private_checkpt_v2( fd_tpool_t * tpool,
                             char const * path,
                             ulong        mode,
                             char const * uinfo,
-                            int          frame_style_compresed );
+                            int          frame_style_compresed,
+                            int          style,
+                            char const * base );
 
 int
 fd_wksp_private_restore_v2( fd_tpool_t * tpool,
@@ -686,7 +723,25 @@ fd_wksp_private_restore_v2( fd_tpool_t * tpool,
                             ulong        t1,
                             fd_wksp_t *  wksp,
                             char const * path,
-                            uint         new_seed );
+                            uint         new_seed,
+                            int          incr );
+
+/* fd_wksp_private_restore_v4_base marks the allocations of wksp that
+   are unchanged relative to the full v4 checkpt at path.  Assumes the
+   caller holds the wksp lock and part_hash[ idx ] holds the hash (as
+   per fd_wksp_checkpt_v4_hash) of the contents of every used partition
+   idx.  On success, returns SUCCESS, part_ref[ idx ] will be 1 for used
+   partitions with the same range, tag and hash in the checkpt at path
+   and 0 otherwise, and *_ref_cnt will have the number of such
+   partitions.  Returns FAIL if path is not a full v4 checkpt or could
+   not be read (logs details).  Clobbers the partition cycle tags. */
+
+int
+fd_wksp_private_restore_v4_base( fd_wksp_t *   wksp,
+                                 char const *  path,
+                                 ulong const * part_hash,
+                                 uchar *       part_ref,
+                                 ulong *       _ref_cnt );
 
 int
 fd_wksp_private_printf_v2( int          fd,
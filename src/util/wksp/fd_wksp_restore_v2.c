@@ -1,3 +1,5 @@
+#define _GNU_SOURCE /* madvise */
+
 #include "fd_wksp_private.h"
 
 #include <stdio.h>
@@ -5,6 +7,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 
 /* This is an implementation detail and not strictly part of the v2
    specification. */
@@ -91,7 +94,8 @@ fd_wksp_restore_v2_hdr( fd_restore_t *             restore,
   /* FIXME: CHECK TRAILING 0 OF NAME? */
 
   RESTORE_TEST( hdr->magic==FD_WKSP_MAGIC                                          );
-  RESTORE_TEST( hdr->style==FD_WKSP_CHECKPT_STYLE_V2                               );
+  RESTORE_TEST( (hdr->style==FD_WKSP_CHECKPT_STYLE_V2) |
+                (hdr->style==FD_WKSP_CHECKPT_STYLE_V4)                               );
   RESTORE_TEST( fd_checkpt_frame_style_is_supported( hdr->frame_style_compressed ) );
   RESTORE_TEST( hdr->reserved==0U                                                  );
   RESTORE_TEST( name_len>0UL                                                       );
@@ -280,11 +284,59 @@ fail:
   return FD_WKSP_ERR_FAIL;
 }
 
+/* fd_wksp_private_restore_v4_verify checks that the contents of the
+   allocations in the pinfo partitions [part_lo,part_hi) match the v4
+   hashes stashed in the partitions' cycle tags during the restore
+   (cycle tags are reset when the wksp is rebuilt).  Returns SUCCESS if
+   all match and FAIL if not (logs details). */
+
+static int
+fd_wksp_private_restore_v4_verify( fd_wksp_t * wksp,
+                                   ulong       part_lo,
+                                   ulong       part_hi ) {
+  fd_wksp_private_pinfo_t const * pinfo = fd_wksp_private_pinfo( wksp );
+  for( ulong part_idx=part_lo; part_idx<part_hi; part_idx++ ) {
+    ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+    ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+    ulong hash     = fd_wksp_checkpt_v4_hash( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+    if( FD_UNLIKELY( hash!=pinfo[ part_idx ].cycle_tag ) ) {
+      FD_LOG_WARNING(( "restore failed because the contents of allocation [0x%016lx,0x%016lx) tag %lu do not match the "
+                       "checkpt (hash %016lx, expected %016lx)",
+                       gaddr_lo, gaddr_hi, pinfo[ part_idx ].tag, hash, pinfo[ part_idx ].cycle_tag ));
+      return FD_WKSP_ERR_FAIL;
+    }
+  }
+  return FD_WKSP_SUCCESS;
+}
+
+/* fd_wksp_private_restore_v2_cgroup_end checks the command that ends
+   the cgroup allocation metadata and returns 1 if this is a ref cgroup
+   (v4 incremental only) and 0 if this is a regular cgroup.  Returns -1
+   if cmd is invalid or a ref cgroup is not allowed (logs details). */
+
+static int
+fd_wksp_private_restore_v2_cgroup_end( fd_wksp_checkpt_v2_hdr_t const * hdr,
+                                       fd_wksp_checkpt_v2_cmd_t const * cmd,
+                                       int                              incr ) {
+  if( FD_LIKELY( fd_wksp_checkpt_v2_cmd_is_data( cmd ) ) ) return 0;
+  if( FD_UNLIKELY( !((hdr->style==FD_WKSP_CHECKPT_STYLE_V4) & fd_wksp_checkpt_v2_cmd_is_ref( cmd )) ) ) {
+    FD_LOG_WARNING(( "restore failed because of an unexpected cgroup command" ));
+    return -1;
+  }
+  if( FD_UNLIKELY( !incr ) ) {
+    FD_LOG_WARNING(( "restore failed because this is an incremental checkpt (use fd_wksp_restore_incr_tpool)" ));
+    return -1;
+  }
+  return 1;
+}
+
 /* fd_wksp_private_restore_v2_cgroup restores a cgroup's allocation into
    wksp.  hdr contains the corresponding restore header info, frame_off
    is where the cgroup frame to restore is located and partitions
    [part_lo,part_hi) are the wksp partition indices to use for this
-   frame's allocations.  Assumes all inputs have already been validated.
+   frame's allocations.  incr indicates if ref cgroups are allowed (see
+   fd_wksp_private_restore_v2).  Assumes all inputs have already been
+   validated.
    Returns SUCCESS (0) on success and FAIL (negative) on failure.  On
    return, in both cases, *_dirty will be 1/0 if wksp was/was not
    modified.  On error, the restore state is indeterminant. */
@@ -297,6 +349,7 @@ fd_wksp_private_restore_v2_cgroup( fd_wksp_t *                      wksp,
                                    ulong                            frame_off_hi,
                                    ulong                            part_lo,
                                    ulong                            part_hi,
+                                   int                              incr,
                                    int *                            _dirty ) {
   int dirty = 0;
 
@@ -340,21 +393,30 @@ fd_wksp_private_restore_v2_cgroup( fd_wksp_t *                      wksp,
     pinfo[ part_idx ].tag      = tag;
   }
 
-  /* Restore the data command */
+  /* Restore the data command (or the ref command) */
 
   RESTORE_META( cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) );
-  RESTORE_TEST( fd_wksp_checkpt_v2_cmd_is_data( cmd ) );
+  int is_ref = fd_wksp_private_restore_v2_cgroup_end( hdr, cmd, incr ); /* logs details */
+  RESTORE_TEST( is_ref>=0 );
 
-  /* For all cgroup allocation data */
+  /* Restore the cgroup allocation hashes (v4 only) */
 
-  for( ulong part_idx=part_lo; part_idx<part_hi; part_idx++ ) {
-    ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
-    ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+  int is_v4 = hdr->style==FD_WKSP_CHECKPT_STYLE_V4;
+  if( is_v4 ) for( ulong part_idx=part_lo; part_idx<part_hi; part_idx++ ) RESTORE_META( &pinfo[ part_idx ].cycle_tag, sizeof(ulong) );
 
-    /* Restore the allocation into the wksp data region */
+  /* For all cgroup allocation data (a ref cgroup's allocations are
+     already in the wksp) */
 
-    dirty = 1;
-    RESTORE_DATA( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+  if( !is_ref ) {
+    for( ulong part_idx=part_lo; part_idx<part_hi; part_idx++ ) {
+      ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+      ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+
+      /* Restore the allocation into the wksp data region */
+
+      dirty = 1;
+      RESTORE_DATA( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+    }
   }
 
   /* Close the frame */
@@ -363,6 +425,8 @@ fd_wksp_private_restore_v2_cgroup( fd_wksp_t *                      wksp,
 
   RESTORE_TEST( (frame_off_lo<frame_off) & (frame_off<=frame_off_hi) ); /* == hi if compactly stored */
 
+  if( is_v4 ) RESTORE_TEST( !fd_wksp_private_restore_v4_verify( wksp, part_lo, part_hi ) ); /* logs details */
+
   *_dirty = dirty;
   return FD_WKSP_SUCCESS;
 
@@ -371,6 +435,46 @@ fail:
   return FD_WKSP_ERR_FAIL;
 }
 
+/* fd_wksp_private_restore_v2_cfg_t holds the read only state shared
+   by the threads of a parallel restore. */
+
+struct fd_wksp_private_restore_v2_cfg {
+  fd_wksp_checkpt_v2_hdr_t const * hdr;
+  int                              fd;   /* File descriptor of the restore mmio (page cache hints) */
+  int                              incr; /* Are ref cgroups allowed */
+};
+
+typedef struct fd_wksp_private_restore_v2_cfg fd_wksp_private_restore_v2_cfg_t;
+
+/* fd_wksp_private_restore_v2_advise hints to the kernel how a thread
+   is about to use (will_need non-zero) or has used (will_need zero) the
+   bytes [off_lo,off_hi) of the memory mapped checkpt in mmio.  A thread
+   reads a cgroup frame once sequentially, so we ask for it to be read
+   ahead before we start decompressing it and drop it from the page
+   cache (and this thread's mappings) once the cgroup is restored.  This
+   gets most of the benefit of O_DIRECT reads (restoring a checkpt
+   larger than the free memory does not evict the page cache of the
+   rest of the system or the wksp itself, if backed by normal pages)
+   without its alignment requirements.  Hints are best effort. */
+
+static void
+fd_wksp_private_restore_v2_advise( void const * mmio,
+                                   int          fd,
+                                   ulong        off_lo,
+                                   ulong        off_hi,
+                                   int          will_need ) {
+  ulong page_lo = fd_ulong_align_dn( off_lo, FD_SHMEM_NORMAL_PAGE_SZ );
+  void * addr   = (void *)((ulong)mmio + page_lo);
+  ulong  sz     = off_hi - page_lo;
+  if( will_need ) {
+    (void)madvise( addr, sz, MADV_SEQUENTIAL );
+    (void)madvise( addr, sz, MADV_WILLNEED   );
+  } else {
+    (void)madvise( addr, sz, MADV_DONTNEED );
+    (void)posix_fadvise( fd, (off_t)page_lo, (off_t)sz, POSIX_FADV_DONTNEED );
+  }
+}
+
 /* fd_wksp_private_restore_v2_node dispatches cgroup restore work to
    tpool threads [t0,t1).  If any errors were encountered while
    restoring cgroups, returns the first error encountered on the lowest
@@ -389,7 +493,7 @@ fd_wksp_private_restore_v2_node( void * tpool,
                                  ulong  tpool_t1,          /* Assumes t1>t0 */
                                  void * _wksp,
                                  void * _restore,
-                                 ulong  _hdr,
+                                 ulong  _cfg,
                                  ulong  _cgroup_frame_off,
                                  ulong  _cgroup_pinfo_lo,
                                  ulong  _cgroup_nxt,
@@ -411,10 +515,10 @@ fd_wksp_private_restore_v2_node( void * tpool,
     int err1; int dirty1;
 
     fd_tpool_exec( tpool, tpool_ts, fd_wksp_private_restore_v2_node,
-                   tpool, tpool_ts, tpool_t1, _wksp, _restore, _hdr, _cgroup_frame_off, _cgroup_pinfo_lo, _cgroup_nxt, cgroup_cnt,
+                   tpool, tpool_ts, tpool_t1, _wksp, _restore, _cfg, _cgroup_frame_off, _cgroup_pinfo_lo, _cgroup_nxt, cgroup_cnt,
                    (ulong)&err1, (ulong)&dirty1 );
     fd_wksp_private_restore_v2_node(
-                   tpool, tpool_t0, tpool_ts, _wksp, _restore, _hdr, _cgroup_frame_off, _cgroup_pinfo_lo, _cgroup_nxt, cgroup_cnt,
+                   tpool, tpool_t0, tpool_ts, _wksp, _restore, _cfg, _cgroup_frame_off, _cgroup_pinfo_lo, _cgroup_nxt, cgroup_cnt,
                    (ulong)&err0, (ulong)&dirty0 );
     fd_tpool_wait( tpool, tpool_ts );
 
@@ -428,7 +532,7 @@ fd_wksp_private_restore_v2_node( void * tpool,
 
   fd_wksp_t *                      wksp             = (fd_wksp_t *)               _wksp;
   fd_restore_t *                   restore          = (fd_restore_t *)            _restore; /* FIXME: CLONE RESTORE */
-  fd_wksp_checkpt_v2_hdr_t const * hdr              = (fd_wksp_checkpt_v2_hdr_t *)_hdr;
+  fd_wksp_private_restore_v2_cfg_t const * cfg      = (fd_wksp_private_restore_v2_cfg_t const *)_cfg;
   ulong const *                    cgroup_frame_off = (ulong *)                   _cgroup_frame_off;
   ulong const *                    cgroup_pinfo_lo  = (ulong *)                   _cgroup_pinfo_lo;
 
@@ -476,12 +580,19 @@ fd_wksp_private_restore_v2_node( void * tpool,
 
     /* Restore this cgroup */
 
+    ulong frame_off_lo = cgroup_frame_off[ cgroup_idx     ];
+    ulong frame_off_hi = cgroup_frame_off[ cgroup_idx+1UL ];
+
+    fd_wksp_private_restore_v2_advise( fd_restore_mmio( restore ), cfg->fd, frame_off_lo, frame_off_hi, 1 );
+
     int dirty_cgroup;
-    err = fd_wksp_private_restore_v2_cgroup( wksp, restore_local, hdr,
-                                             cgroup_frame_off[ cgroup_idx ], cgroup_frame_off[ cgroup_idx+1UL ],
-                                             cgroup_pinfo_lo [ cgroup_idx ], cgroup_pinfo_lo [ cgroup_idx+1UL ],
-                                             &dirty_cgroup ); /* logs details */
+    err = fd_wksp_private_restore_v2_cgroup( wksp, restore_local, cfg->hdr, frame_off_lo, frame_off_hi,
+                                             cgroup_pinfo_lo[ cgroup_idx ], cgroup_pinfo_lo[ cgroup_idx+1UL ],
+                                             cfg->incr, &dirty_cgroup ); /* logs details */
     dirty |= dirty_cgroup;
+
+    fd_wksp_private_restore_v2_advise( fd_restore_mmio( restore ), cfg->fd, frame_off_lo, frame_off_hi, 0 );
+
     if( FD_UNLIKELY( err ) ) break; /* abort if we encountered an error */
 
   }
@@ -501,7 +612,9 @@ done:
    error occurred before wksp was not modified and CORRUPT if an error
    occurred after.  On failure, the restore state is indeterminant.
    Uses tpool threads [t0,t1) to do the restore.  Assumes the caller is
-   thread t0 and threads (t0,t1) are available for dispatch. */
+   thread t0 and threads (t0,t1) are available for dispatch.  fd is the
+   file descriptor backing the restore and incr is as described in
+   fd_wksp_private_restore_v2. */
 
 static int
 fd_wksp_private_restore_v2_mmio( fd_tpool_t *   tpool,
@@ -509,7 +622,9 @@ fd_wksp_private_restore_v2_mmio( fd_tpool_t *   tpool,
                                  ulong          t1,
                                  fd_wksp_t *    wksp,
                                  fd_restore_t * restore,
-                                 uint           new_seed ) {
+                                 int            fd,
+                                 uint           new_seed,
+                                 int            incr ) {
 
   ulong frame_off;
 
@@ -661,10 +776,15 @@ fd_wksp_private_restore_v2_mmio( fd_tpool_t *   tpool,
     FD_VOLATILE( cgroup_nxt[0] ) = 0UL;
     FD_COMPILER_MFENCE();
 
+    fd_wksp_private_restore_v2_cfg_t cfg[1];
+    cfg->hdr  = hdr;
+    cfg->fd   = fd;
+    cfg->incr = incr;
+
     int err;
     int dirty_node;
     fd_wksp_private_restore_v2_node( (void *)tpool, t0, t1,
-                                     (void *)wksp, (void *)restore, (ulong)hdr, (ulong)cgroup_frame_off, (ulong)cgroup_pinfo_lo,
+                                     (void *)wksp, (void *)restore, (ulong)cfg, (ulong)cgroup_frame_off, (ulong)cgroup_pinfo_lo,
                                      (ulong)cgroup_nxt, cgroup_cnt, (ulong)&err, (ulong)&dirty_node );
     dirty |= dirty_node;
     if( FD_UNLIKELY( err ) ) goto fail;
@@ -711,6 +831,17 @@ fd_wksp_private_restore_v2_mmio( fd_tpool_t *   tpool,
 
 fail: /* Release resources that might be reserved */
 
+  /* If wksp is not clean, reset it to get it back to a clean state
+     (e.g. an incremental restore that failed its hash check) */
+
+  if( FD_UNLIKELY( dirty ) ) {
+    FD_LOG_WARNING(( "wksp \"%s\" dirty; attempting to reset it and continue", wksp->name ));
+    fd_wksp_private_pinfo_t * pinfo    = fd_wksp_private_pinfo( wksp );
+    ulong                     part_max = wksp->part_max;
+    for( ulong part_idx=0UL; part_idx<part_max; part_idx++ ) pinfo[ part_idx ].tag = 0UL;
+    fd_wksp_rebuild( wksp, new_seed ); /* logs details */
+  }
+
   if( FD_LIKELY( locked ) ) fd_wksp_private_unlock( wksp );
 
   return fd_int_if( dirty, FD_WKSP_ERR_CORRUPT, FD_WKSP_ERR_FAIL );
@@ -727,7 +858,8 @@ fail: /* Release resources that might be reserved */
 static int
 fd_wksp_private_restore_v2_stream( fd_wksp_t *    wksp,
                                    fd_restore_t * restore,
-                                   uint           new_seed ) {
+                                   uint           new_seed,
+                                   int            incr ) {
   ulong frame_off;
 
   int locked = 0; /* is the wksp currently locked */
@@ -825,7 +957,7 @@ fd_wksp_private_restore_v2_stream( fd_wksp_t *    wksp,
       vol_cgroup_frame_off[ vol_cgroup_cnt ] = frame_off;
 
       for(;;) {
-        if( FD_UNLIKELY( fd_wksp_checkpt_v2_cmd_is_data( cmd ) ) ) break;
+        if( FD_UNLIKELY( fd_wksp_checkpt_v2_cmd_is_data( cmd ) | fd_wksp_checkpt_v2_cmd_is_ref( cmd ) ) ) break;
         RESTORE_TEST( fd_wksp_checkpt_v2_cmd_is_meta( cmd ) );
 
         ulong tag      = cmd->meta.tag;      /* non-zero */
@@ -860,20 +992,31 @@ fd_wksp_private_restore_v2_stream( fd_wksp_t *    wksp,
 
       /* At this point, we have restored all cgroup allocation metadata
          into the pinfo array at [part_lo,ftr_alloc_cnt).  Restore the
-         corresponding cgroup allocation data. */
+         corresponding cgroup allocation hashes (v4 only) and data (a ref
+         cgroup's allocations are already in the wksp). */
 
-      for( ulong part_idx=part_lo; part_idx<ftr_alloc_cnt; part_idx++ ) {
-        ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
-        ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+      int is_ref = fd_wksp_private_restore_v2_cgroup_end( hdr, cmd, incr ); /* logs details */
+      RESTORE_TEST( is_ref>=0 );
 
-        dirty = 1;
-        RESTORE_DATA( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+      int is_v4 = hdr->style==FD_WKSP_CHECKPT_STYLE_V4;
+      if( is_v4 ) for( ulong part_idx=part_lo; part_idx<ftr_alloc_cnt; part_idx++ ) RESTORE_META( &pinfo[ part_idx ].cycle_tag, sizeof(ulong) );
+
+      if( !is_ref ) {
+        for( ulong part_idx=part_lo; part_idx<ftr_alloc_cnt; part_idx++ ) {
+          ulong gaddr_lo = pinfo[ part_idx ].gaddr_lo;
+          ulong gaddr_hi = pinfo[ part_idx ].gaddr_hi;
+
+          dirty = 1;
+          RESTORE_DATA( fd_wksp_laddr_fast( wksp, gaddr_lo ), gaddr_hi - gaddr_lo );
+        }
       }
 
       /* Close the cgroup frame */
 
       RESTORE_CLOSE();
 
+      if( is_v4 ) RESTORE_TEST( !fd_wksp_private_restore_v4_verify( wksp, part_lo, ftr_alloc_cnt ) ); /* logs details */
+
       /* Update verification info */
 
       vol_cgroup_alloc_cnt[ vol_cgroup_cnt ] = ftr_alloc_cnt - part_lo;
@@ -924,20 +1067,210 @@ restore_footer:
 
 fail: /* Release resources that might be reserved */
 
+  /* If wksp is not clean, reset it to get it back to a clean state
+     (e.g. an incremental restore that failed its hash check) */
+
+  if( FD_UNLIKELY( dirty ) ) {
+    FD_LOG_WARNING(( "wksp \"%s\" dirty; attempting to reset it and continue", wksp->name ));
+    fd_wksp_private_pinfo_t * pinfo    = fd_wksp_private_pinfo( wksp );
+    ulong                     part_max = wksp->part_max;
+    for( ulong part_idx=0UL; part_idx<part_max; part_idx++ ) pinfo[ part_idx ].tag = 0UL;
+    fd_wksp_rebuild( wksp, new_seed ); /* logs details */
+  }
+
   if( FD_LIKELY( locked ) ) fd_wksp_private_unlock( wksp );
 
   return fd_int_if( dirty, FD_WKSP_ERR_CORRUPT, FD_WKSP_ERR_FAIL );
 }
 
+int
+fd_wksp_private_restore_v4_base( fd_wksp_t *   wksp,
+                                 char const *  path,
+                                 ulong const * part_hash,
+                                 uchar *       part_ref,
+                                 ulong *       _ref_cnt ) {
+
+  int            fd      = -1;
+  void const *   mmio    = NULL;
+  ulong          mmio_sz = 0UL;
+  fd_restore_t * restore = NULL;
+  ulong *        cand    = NULL; /* cand[i] is the partition matching allocation i of the current cgroup (IDX_NULL if none) */
+  ulong          cand_sz = 0UL;
+
+  fd_restore_t _restore[ 1 ];
+
+  fd_wksp_private_pinfo_t * pinfo   = fd_wksp_private_pinfo( wksp );
+  ulong                     ref_cnt = 0UL;
+
+  memset( part_ref, 0, wksp->part_max );
+
+  fd = open( path, O_RDONLY, (mode_t)0 );
+  if( FD_UNLIKELY( fd==-1 ) ) {
+    FD_LOG_WARNING(( "open(\"%s\",O_RDONLY,0) failed (%i-%s)", path, errno, fd_io_strerror( errno ) ));
+    goto fail;
+  }
+
+  int err = fd_io_mmio_init( fd, FD_IO_MMIO_MODE_READ_ONLY, &mmio, &mmio_sz );
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_WARNING(( "base checkpt \"%s\" does not appear to support mmio (%i-%s)", path, err, fd_io_strerror( err ) ));
+    goto fail;
+  }
+
+  restore = fd_restore_init_mmio( _restore, mmio, mmio_sz ); /* logs details */
+  if( FD_UNLIKELY( !restore ) ) goto fail;
+
+  /* Restore and validate the header and footer */
+
+  ulong frame_off;
+  ulong restore_sz    = mmio_sz;
+  ulong frame_off_ftr = restore_sz - sizeof(fd_wksp_checkpt_v2_ftr_t);
+
+  RESTORE_TEST( restore_sz>sizeof(fd_wksp_checkpt_v2_hdr_t)+sizeof(fd_wksp_checkpt_v2_ftr_t) );
+
+  fd_wksp_checkpt_v2_hdr_t hdr[1];
+  fd_wksp_checkpt_v2_ftr_t ftr[1];
+
+  RESTORE_TEST( !fd_wksp_restore_v2_hdr( restore, hdr ) );
+  if( FD_UNLIKELY( hdr->style!=FD_WKSP_CHECKPT_STYLE_V4 ) ) {
+    FD_LOG_WARNING(( "base checkpt \"%s\" does not have the v4 style", path ));
+    goto fail;
+  }
+
+  RESTORE_SEEK( frame_off_ftr );
+  RESTORE_TEST( !fd_wksp_restore_v2_ftr( restore, hdr, ftr, restore_sz ) );
+
+  ulong frame_off_volumes = ftr->frame_off;
+  RESTORE_TEST( (sizeof(fd_wksp_checkpt_v2_hdr_t)<frame_off_volumes) & (frame_off_volumes<frame_off_ftr) );
+
+  fd_wksp_checkpt_v2_cmd_t cmd[1];
+
+  RESTORE_SEEK( frame_off_volumes );
+  RESTORE_OPEN( hdr->frame_style_compressed );
+  RESTORE_META( cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+  RESTORE_CLOSE();
+  RESTORE_TEST( fd_wksp_checkpt_v2_cmd_is_volumes( cmd ) );
+
+  cand_sz = fd_ulong_align_up( fd_ulong_max( ftr->alloc_cnt, 1UL )*sizeof(ulong), FD_SHMEM_NORMAL_PAGE_SZ );
+  cand    = (ulong *)mmap( NULL, cand_sz, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, (off_t)0 );
+  if( FD_UNLIKELY( cand==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(NULL,%lu KiB) failed (%i-%s)", cand_sz>>10, errno, fd_io_strerror( errno ) ));
+    cand = NULL;
+    goto fail;
+  }
+
+  /* For all volumes (newest first), match each cgroup's allocations
+     against the wksp's allocations.  Since the allocation metadata and
+     hashes are at the start of a cgroup frame, we don't need to
+     decompress any allocation data. */
+
+  ulong frame_off_appendix = cmd->volumes.frame_off;
+  ulong frame_off_hi       = frame_off_volumes;
+  while( frame_off_appendix ) {
+    RESTORE_TEST( (sizeof(fd_wksp_checkpt_v2_hdr_t)<frame_off_appendix) & (frame_off_appendix<frame_off_hi) );
+
+    ulong cgroup_frame_off[ FD_WKSP_RESTORE_V2_CGROUP_MAX ];
+    ulong cgroup_alloc_cnt[ FD_WKSP_RESTORE_V2_CGROUP_MAX ];
+
+    RESTORE_SEEK( frame_off_appendix );
+    RESTORE_OPEN( hdr->frame_style_compressed );
+    RESTORE_META( cmd, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+    RESTORE_TEST( fd_wksp_checkpt_v2_cmd_is_appendix( cmd ) );
+    ulong cgroup_cnt = cmd->appendix.cgroup_cnt;
+    RESTORE_TEST( cgroup_cnt<=FD_WKSP_RESTORE_V2_CGROUP_MAX );
+    RESTORE_DATA( cgroup_frame_off, cgroup_cnt*sizeof(ulong) );
+    RESTORE_DATA( cgroup_alloc_cnt, cgroup_cnt*sizeof(ulong) );
+    RESTORE_CLOSE();
+
+    for( ulong cgroup_idx=0UL; cgroup_idx<cgroup_cnt; cgroup_idx++ ) {
+      ulong alloc_cnt = cgroup_alloc_cnt[ cgroup_idx ];
+      RESTORE_TEST( (cgroup_frame_off[ cgroup_idx ]<frame_off_appendix) & (alloc_cnt<=ftr->alloc_cnt) );
+
+      /* Note: we stop reading the frame after the hashes (fine for an
+         mmio restore as the next frame is found by seeking) */
+
+      RESTORE_SEEK( cgroup_frame_off[ cgroup_idx ] );
+      RESTORE_OPEN( hdr->frame_style_compressed );
+
+      fd_wksp_checkpt_v2_cmd_t meta[1];
+      for( ulong alloc_idx=0UL; alloc_idx<alloc_cnt; alloc_idx++ ) {
+        RESTORE_META( meta, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+        RESTORE_TEST( fd_wksp_checkpt_v2_cmd_is_meta( meta ) );
+
+        ulong part_idx = fd_wksp_private_used_treap_query( meta->meta.gaddr_lo, wksp, pinfo );
+        int   match    = (!fd_wksp_private_pinfo_idx_is_null( part_idx ))
+                      && (pinfo[ part_idx ].gaddr_lo==meta->meta.gaddr_lo)
+                      && (pinfo[ part_idx ].gaddr_hi==meta->meta.gaddr_hi)
+                      && (pinfo[ part_idx ].tag     ==meta->meta.tag     );
+        cand[ alloc_idx ] = fd_ulong_if( match, part_idx, FD_WKSP_PRIVATE_PINFO_IDX_NULL );
+      }
+
+      RESTORE_META( meta, sizeof(fd_wksp_checkpt_v2_cmd_t) );
+      if( FD_UNLIKELY( fd_wksp_checkpt_v2_cmd_is_ref( meta ) ) ) {
+        FD_LOG_WARNING(( "base checkpt \"%s\" is an incremental checkpt", path ));
+        goto fail;
+      }
+      RESTORE_TEST( fd_wksp_checkpt_v2_cmd_is_data( meta ) );
+
+      for( ulong alloc_idx=0UL; alloc_idx<alloc_cnt; alloc_idx++ ) {
+        ulong hash;
+        RESTORE_META( &hash, sizeof(ulong) );
+        ulong part_idx = cand[ alloc_idx ];
+        if( !fd_wksp_private_pinfo_idx_is_null( part_idx ) && part_hash[ part_idx ]==hash && !part_ref[ part_idx ] ) {
+          part_ref[ part_idx ] = (uchar)1;
+          ref_cnt++;
+        }
+      }
+
+      RESTORE_CLOSE();
+    }
+
+    frame_off_hi       = frame_off_appendix;
+    frame_off_appendix = cmd->appendix.frame_off;
+  }
+
+  munmap( cand, cand_sz );
+
+  if( FD_UNLIKELY( !fd_restore_fini( restore ) ) ) /* logs details */
+    FD_LOG_WARNING(( "fd_restore_fini failed; attempting to continue" ));
+
+  fd_io_mmio_fini( mmio, mmio_sz );
+
+  if( FD_UNLIKELY( close( fd ) ) )
+    FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s); attempting to continue", path, errno, fd_io_strerror( errno ) ));
+
+  *_ref_cnt = ref_cnt;
+  return FD_WKSP_SUCCESS;
+
+fail:
+
+  if( FD_LIKELY( cand ) ) munmap( cand, cand_sz );
+
+  if( FD_LIKELY( restore ) ) {
+    if( FD_UNLIKELY( fd_restore_in_frame( restore ) ) && FD_UNLIKELY( fd_restore_close( restore ) ) )
+      FD_LOG_WARNING(( "fd_restore_close failed; attempting to continue" ));
+
+    if( FD_UNLIKELY( !fd_restore_fini( restore ) ) ) /* logs details */
+      FD_LOG_WARNING(( "fd_restore_fini failed; attempting to continue" ));
+  }
+
+  if( FD_LIKELY( mmio_sz ) ) fd_io_mmio_fini( mmio, mmio_sz );
+
+  if( FD_LIKELY( fd!=-1 ) && FD_UNLIKELY( close( fd ) ) )
+    FD_LOG_WARNING(( "close(\"%s\") failed (%i-%s); attempting to continue", path, errno, fd_io_strerror( errno ) ));
+
+  return FD_WKSP_ERR_FAIL;
+}
+
 int
 fd_wksp_private_restore_v2( fd_tpool_t * tpool,
                             ulong        t0,
                             ulong        t1,
                             fd_wksp_t *  wksp,
                             char const * path,
-                            uint         new_seed ) {
+                            uint         new_seed,
+                            int          incr ) {
 
-  FD_LOG_INFO(( "Restoring checkpt \"%s\" into wksp \"%s\" (seed %u)", path, wksp->name, new_seed ));
+  FD_LOG_INFO(( "Restoring checkpt \"%s\" into wksp \"%s\" (seed %u%s)", path, wksp->name, new_seed, incr ? ", incremental" : "" ));
 
   int            fd      = -1;
   void const *   mmio    = NULL;
@@ -966,7 +1299,7 @@ fd_wksp_private_restore_v2( fd_tpool_t * tpool,
     restore = fd_restore_init_mmio( _restore, mmio, mmio_sz ); /* logs details */
     if( FD_UNLIKELY( !restore ) ) goto fail;
 
-    err = fd_wksp_private_restore_v2_mmio( tpool, t0, t1, wksp, restore, new_seed ); /* logs details */
+    err = fd_wksp_private_restore_v2_mmio( tpool, t0, t1, wksp, restore, fd, new_seed, incr ); /* logs details */
     if( FD_UNLIKELY( err ) ) goto fail;
 
   } else {
@@ -979,7 +1312,9 @@ fd_wksp_private_restore_v2( fd_tpool_t * tpool,
     restore = fd_restore_init_stream( _restore, fd, rbuf, FD_RESTORE_RBUF_MIN ); /* logs details */
     if( FD_UNLIKELY( !restore ) ) goto fail;
 
-    err = fd_wksp_private_restore_v2_stream( wksp, restore, new_seed ); /* logs details */
+    (void)posix_fadvise( fd, (off_t)0, (off_t)0, POSIX_FADV_SEQUENTIAL ); /* best effort (fails on pipes) */
+
+    err = fd_wksp_private_restore_v2_stream( wksp, restore, new_seed, incr ); /* logs details */
     if( FD_UNLIKELY( err ) ) goto fail;
 
   }
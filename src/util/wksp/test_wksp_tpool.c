@@ -93,6 +93,9 @@ main( int     argc,
   char tmp_path[256];
   if( !path ) path = fd_cstr_printf( tmp_path, 256UL, NULL, "/tmp/test_wksp_tpool.%lu.%li", fd_log_group_id(), fd_log_wallclock() );
 
+  char base_path[256]; FD_TEST( fd_cstr_printf_check( base_path, 256UL, NULL, "%s.base", path ) );
+  char incr_path[256]; FD_TEST( fd_cstr_printf_check( incr_path, 256UL, NULL, "%s.incr", path ) );
+
   ulong mode = fd_cstr_to_ulong_octal( _mode );
 
   FD_LOG_NOTICE(( "Using --path %s --mode 0%03lo --keep %i", path, mode, keep ));
@@ -160,7 +163,8 @@ main( int     argc,
 
     ulong t0    = 0UL;
     ulong t1    = 1UL + fd_rng_ulong_roll( rng, worker_cnt );
-    int   style = (int)fd_rng_uint_roll( rng, FD_HAS_LZ4 ? 4U : 3U );
+    int   style = (int)fd_rng_uint_roll( rng, FD_HAS_LZ4 ? 5U : 4U );
+    if( !FD_HAS_LZ4 && style==FD_WKSP_CHECKPT_STYLE_V3 ) style = FD_WKSP_CHECKPT_STYLE_V4;
 
     FD_TEST( !fd_wksp_checkpt_tpool( tpool, t0, t1, wksp, path, mode, style, "test_wksp_tpool" ) );
 
@@ -181,12 +185,58 @@ main( int     argc,
     FD_FOR_ALL( alloc_test, tpool,0UL,worker_cnt, 0L,alloc_cnt, wksp, info, _rng );
 
     /* TODO: TEST THERE ARE NO OTHER ALLOCATIONS IN THE WKSP TOO! */
+
+    if( FD_UNLIKELY( alloc_cnt<2L ) ) continue;
+
+    /* Zero out a random range of the allocations and take a full v4
+       checkpt of the result to use as a base.  Then restore the test
+       pattern and take an incremental checkpt relative to that base
+       (only the zeroed range should be stored in it). */
+
+    long i0 = (long)fd_rng_ulong_roll( rng, (ulong)(alloc_cnt-1L) );
+    long i1 = i0 + 1L + (long)fd_rng_ulong_roll( rng, fd_ulong_min( (ulong)(alloc_cnt-1L-i0), 64UL ) );
+
+    FD_FOR_ALL( alloc_zero, tpool,0UL,worker_cnt, i0,i1, wksp, info );
+
+    unlink( base_path );
+    unlink( incr_path );
+
+    t1 = 1UL + fd_rng_ulong_roll( rng, worker_cnt );
+    FD_TEST( !fd_wksp_checkpt_tpool( tpool, t0, t1, wksp, base_path, mode, FD_WKSP_CHECKPT_STYLE_V4, "test_wksp_tpool base" ) );
+
+    FD_FOR_ALL( alloc_init, tpool,0UL,worker_cnt, i0,i1, wksp, info );
+
+    t1 = 1UL + fd_rng_ulong_roll( rng, worker_cnt );
+    FD_TEST( !fd_wksp_checkpt_incr_tpool( tpool, t0, t1, wksp, incr_path, mode, "test_wksp_tpool incr", base_path ) );
+
+    /* An incremental checkpt cannot be used as a base or restored on
+       its own */
+
+    unlink( path );
+    FD_TEST( fd_wksp_checkpt_incr_tpool( tpool, t0, t1, wksp, path, mode, NULL, incr_path ) );
+    FD_TEST( fd_wksp_restore_tpool( tpool, t2, t3, wksp, incr_path, seed1 ) );
+
+    /* Restoring relative to the wrong base (a checkpt of the wksp with
+       every allocation zeroed) fails the allocation hash check */
+
+    FD_FOR_ALL( alloc_zero, tpool,0UL,worker_cnt, 0L,alloc_cnt, wksp, info );
+    unlink( path );
+    FD_TEST( !fd_wksp_checkpt_tpool( tpool, t0, t1, wksp, path, mode, FD_WKSP_CHECKPT_STYLE_V4, NULL ) );
+    FD_TEST( fd_wksp_restore_incr_tpool( tpool, t2, t3, wksp, incr_path, path, seed1 ) );
+
+    /* Restoring relative to the right base reproduces the wksp */
+
+    t3 = 1UL + fd_rng_ulong_roll( rng, worker_cnt );
+    FD_TEST( !fd_wksp_restore_incr_tpool( tpool, t2, t3, wksp, incr_path, base_path, fd_rng_uint( rng ) ) );
+
+    FD_FOR_ALL( alloc_test, tpool,0UL,worker_cnt, 0L,alloc_cnt, wksp, info, _rng );
   }
 
   FD_LOG_NOTICE(( "Cleaning up" ));
 
   if( FD_LIKELY( !keep ) && FD_UNLIKELY( unlink( path ) ) )
     FD_LOG_WARNING(( "unlink(%s) failed (%i-%s); attempting to continue", path, errno, fd_io_strerror( errno ) ));
+  if( FD_LIKELY( !keep ) ) { unlink( base_path ); unlink( incr_path ); }
 
   if( _wksp ) fd_wksp_detach( wksp );
   else        fd_wksp_delete_anonymous( wksp );